@@ -17,6 +17,7 @@
 #include "api/array_view.h"
 #include "api/ref_counted_base.h"
 #include "api/scoped_refptr.h"
+#include "api/transport/ecn_marking.h"
 
 namespace webrtc {
 
@@ -41,6 +42,11 @@ struct PacketOptions {
   bool batchable = false;
   // Whether this packet is the last of a batch.
   bool last_packet_in_batch = false;
+  // Whether this packet should be sent on the secondary route of the
+  // transport. Transports with a single route ignore this.
+  bool send_on_secondary_route = false;
+  // The ECN codepoint to send the packet with.
+  EcnMarking ecn = EcnMarking::kNotEct;
 };
 
 class Transport {
@@ -17,6 +17,7 @@
 #include "absl/types/optional.h"
 #include "api/array_view.h"
 #include "api/numerics/samples_stats_counter.h"
+#include "api/transport/ecn_marking.h"
 #include "api/units/data_rate.h"
 #include "api/units/data_size.h"
 #include "api/units/timestamp.h"
@@ -51,6 +52,8 @@ struct EmulatedIpPacket {
   rtc::CopyOnWriteBuffer data;
   uint16_t headers_size;
   Timestamp arrival_time;
+  // The ECN codepoint in the IP header, which the network may change to kCe.
+  EcnMarking ecn = EcnMarking::kNotEct;
 };
 
 // Interface for handling IP packets from an emulated network. This is used with
@@ -253,7 +256,8 @@ class EmulatedEndpoint : public EmulatedNetworkReceiverInterface {
   virtual void SendPacket(const rtc::SocketAddress& from,
                           const rtc::SocketAddress& to,
                           rtc::CopyOnWriteBuffer packet_data,
-                          uint16_t application_overhead = 0) = 0;
+                          uint16_t application_overhead = 0,
+                          EcnMarking ecn = EcnMarking::kNotEct) = 0;
 
   // Binds receiver to this endpoint to send and receive data.
   // `desired_port` is a port that should be used. If it is equal to 0,
@@ -19,6 +19,7 @@
 #include <vector>
 
 #include "absl/types/optional.h"
+#include "api/transport/ecn_marking.h"
 #include "rtc_base/random.h"
 #include "rtc_base/thread_annotations.h"
 
@@ -32,20 +33,27 @@ struct PacketInFlightInfo {
   int64_t send_time_us;
   // Unique identifier for the packet in relation to other packets in flight.
   uint64_t packet_id;
+  // The ECN codepoint the packet was sent with.
+  EcnMarking ecn = EcnMarking::kNotEct;
 };
 
 struct PacketDeliveryInfo {
   static constexpr int kNotReceived = -1;
   PacketDeliveryInfo(PacketInFlightInfo source, int64_t receive_time_us)
-      : receive_time_us(receive_time_us), packet_id(source.packet_id) {}
+      : receive_time_us(receive_time_us),
+        packet_id(source.packet_id),
+        ecn(source.ecn) {}
 
   bool operator==(const PacketDeliveryInfo& other) const {
     return receive_time_us == other.receive_time_us &&
-           packet_id == other.packet_id;
+           packet_id == other.packet_id && ecn == other.ecn;
   }
 
   int64_t receive_time_us;
   uint64_t packet_id;
+  // The ECN codepoint the packet arrived with, which is kCe if the network
+  // marked it.
+  EcnMarking ecn;
 };
 
 // BuiltInNetworkBehaviorConfig is a built-in network behavior configuration
@@ -68,6 +76,10 @@ struct BuiltInNetworkBehaviorConfig {
   int avg_burst_loss_length = -1;
   // Additional bytes to add to packet size.
   int packet_overhead = 0;
+  // If non-negative, ECN capable packets that were queued for longer than this
+  // before getting onto the link are marked Congestion Experienced, like in an
+  // L4S queue with a step threshold.
+  int ecn_marking_threshold_ms = -1;
 };
 
 // Interface that represents a Network behaviour.
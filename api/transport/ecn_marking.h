@@ -0,0 +1,29 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef API_TRANSPORT_ECN_MARKING_H_
+#define API_TRANSPORT_ECN_MARKING_H_
+
+namespace webrtc {
+
+// The ECN codepoint of the IP header of a packet, see
+// https://www.rfc-editor.org/rfc/rfc3168#section-5. The values are the two ECN
+// bits. L4S capable senders use ECT(1), see
+// https://www.rfc-editor.org/rfc/rfc9331.
+enum class EcnMarking {
+  kNotEct = 0,  // Not ECN-Capable Transport.
+  kEct1 = 1,    // ECN-Capable Transport, ECT(1).
+  kEct0 = 2,    // ECN-Capable Transport, ECT(0).
+  kCe = 3,      // Congestion Experienced.
+};
+
+}  // namespace webrtc
+
+#endif  // API_TRANSPORT_ECN_MARKING_H_
@@ -15,6 +15,7 @@
 #include <vector>
 
 #include "absl/types/optional.h"
+#include "api/transport/ecn_marking.h"
 #include "api/units/data_rate.h"
 #include "api/units/data_size.h"
 #include "api/units/time_delta.h"
@@ -162,6 +163,8 @@ struct PacketResult {
 
   SentPacket sent_packet;
   Timestamp receive_time = Timestamp::PlusInfinity();
+  // The ECN codepoint the packet was received with, if reported.
+  EcnMarking ecn = EcnMarking::kNotEct;
 };
 
 struct TransportPacketsFeedback {
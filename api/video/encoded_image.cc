@@ -13,6 +13,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <utility>
+
 namespace webrtc {
 
 EncodedImageBuffer::EncodedImageBuffer(size_t size) : size_(size) {
@@ -38,6 +40,19 @@ rtc::scoped_refptr<EncodedImageBuffer> EncodedImageBuffer::Create(
     size_t size) {
   return rtc::make_ref_counted<EncodedImageBuffer>(data, size);
 }
+// static
+rtc::scoped_refptr<EncodedImageBuffer> EncodedImageBuffer::Create(
+    const EncodedImageBufferInterface& buffer) {
+  rtc::scoped_refptr<EncodedImageBuffer> contiguous = Create(buffer.size());
+  uint8_t* write_at = contiguous->data();
+  for (size_t i = 0; i < buffer.num_fragments(); ++i) {
+    rtc::ArrayView<const uint8_t> fragment = buffer.fragment(i);
+    memcpy(write_at, fragment.data(), fragment.size());
+    write_at += fragment.size();
+  }
+  RTC_DCHECK_EQ(write_at - contiguous->data(), contiguous->size());
+  return contiguous;
+}
 
 const uint8_t* EncodedImageBuffer::data() const {
   return buffer_;
@@ -59,6 +74,43 @@ void EncodedImageBuffer::Realloc(size_t size) {
   size_ = size;
 }
 
+// static
+rtc::scoped_refptr<FragmentedEncodedImageBuffer>
+FragmentedEncodedImageBuffer::Create(
+    std::vector<rtc::CopyOnWriteBuffer> fragments) {
+  return rtc::make_ref_counted<FragmentedEncodedImageBuffer>(
+      std::move(fragments));
+}
+
+FragmentedEncodedImageBuffer::FragmentedEncodedImageBuffer(
+    std::vector<rtc::CopyOnWriteBuffer> fragments)
+    : fragments_(std::move(fragments)), size_(0) {
+  for (const rtc::CopyOnWriteBuffer& fragment : fragments_) {
+    size_ += fragment.size();
+  }
+}
+
+FragmentedEncodedImageBuffer::~FragmentedEncodedImageBuffer() = default;
+
+const uint8_t* FragmentedEncodedImageBuffer::data() const {
+  RTC_DCHECK_LE(fragments_.size(), 1)
+      << "Copy the fragments with EncodedImageBuffer::Create() instead.";
+  return fragments_.size() == 1 ? fragments_[0].cdata() : nullptr;
+}
+
+uint8_t* FragmentedEncodedImageBuffer::data() {
+  RTC_DCHECK_LE(fragments_.size(), 1)
+      << "Copy the fragments with EncodedImageBuffer::Create() instead.";
+  return fragments_.size() == 1 ? fragments_[0].MutableData() : nullptr;
+}
+
+rtc::ArrayView<const uint8_t> FragmentedEncodedImageBuffer::fragment(
+    size_t index) const {
+  RTC_DCHECK_LT(index, fragments_.size());
+  return rtc::ArrayView<const uint8_t>(fragments_[index].cdata(),
+                                       fragments_[index].size());
+}
+
 EncodedImage::EncodedImage() = default;
 
 EncodedImage::EncodedImage(EncodedImage&&) = default;
@@ -15,8 +15,10 @@
 
 #include <map>
 #include <utility>
+#include <vector>
 
 #include "absl/types/optional.h"
+#include "api/array_view.h"
 #include "api/rtp_packet_infos.h"
 #include "api/scoped_refptr.h"
 #include "api/units/timestamp.h"
@@ -27,6 +29,7 @@
 #include "api/video/video_rotation.h"
 #include "api/video/video_timing.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/copy_on_write_buffer.h"
 #include "rtc_base/ref_count.h"
 #include "rtc_base/system/rtc_export.h"
 
@@ -42,6 +45,15 @@ class EncodedImageBufferInterface : public rtc::RefCountInterface {
   // this non-const data method.
   virtual uint8_t* data() = 0;
   virtual size_t size() const = 0;
+
+  // The encoded data as a list of fragments to be read in order, for
+  // consumers that can read it without first copying it into one contiguous
+  // buffer. Buffers that store their data contiguously have one fragment.
+  virtual size_t num_fragments() const { return 1; }
+  virtual rtc::ArrayView<const uint8_t> fragment(size_t index) const {
+    RTC_DCHECK_EQ(index, 0);
+    return rtc::ArrayView<const uint8_t>(data(), size());
+  }
 };
 
 // Basic implementation of EncodedImageBufferInterface.
@@ -51,6 +63,9 @@ class RTC_EXPORT EncodedImageBuffer : public EncodedImageBufferInterface {
   static rtc::scoped_refptr<EncodedImageBuffer> Create(size_t size);
   static rtc::scoped_refptr<EncodedImageBuffer> Create(const uint8_t* data,
                                                        size_t size);
+  // Copies the fragments of `buffer` into one contiguous buffer.
+  static rtc::scoped_refptr<EncodedImageBuffer> Create(
+      const EncodedImageBufferInterface& buffer);
 
   const uint8_t* data() const override;
   uint8_t* data() override;
@@ -66,6 +81,34 @@ class RTC_EXPORT EncodedImageBuffer : public EncodedImageBufferInterface {
   uint8_t* buffer_;
 };
 
+// Implementation of EncodedImageBufferInterface that references the encoded
+// data as a list of fragments, e.g. the payloads of the RTP packets of a
+// received frame, instead of holding a copy of it. data() is only available
+// while there is at most one fragment; consumers that need contiguous data
+// must first copy the fragments with EncodedImageBuffer::Create(). Reading the
+// buffer never changes the fragments, so it may be read from several threads.
+class RTC_EXPORT FragmentedEncodedImageBuffer
+    : public EncodedImageBufferInterface {
+ public:
+  static rtc::scoped_refptr<FragmentedEncodedImageBuffer> Create(
+      std::vector<rtc::CopyOnWriteBuffer> fragments);
+
+  const uint8_t* data() const override;
+  uint8_t* data() override;
+  size_t size() const override { return size_; }
+  size_t num_fragments() const override { return fragments_.size(); }
+  rtc::ArrayView<const uint8_t> fragment(size_t index) const override;
+
+ protected:
+  explicit FragmentedEncodedImageBuffer(
+      std::vector<rtc::CopyOnWriteBuffer> fragments);
+  ~FragmentedEncodedImageBuffer() override;
+
+ private:
+  std::vector<rtc::CopyOnWriteBuffer> fragments_;
+  size_t size_;
+};
+
 // TODO(bug.webrtc.org/9378): This is a legacy api class, which is slowly being
 // cleaned up. Direct use of its members is strongly discouraged.
 class RTC_EXPORT EncodedImage {
@@ -187,8 +230,11 @@ class RTC_EXPORT EncodedImage {
     return encoded_data_;
   }
 
+  // Reads through the const interface of the buffer, so that a buffer which
+  // shares its data with others isn't copied for the read.
   const uint8_t* data() const {
-    return encoded_data_ ? encoded_data_->data() : nullptr;
+    const EncodedImageBufferInterface* encoded_data = encoded_data_.get();
+    return encoded_data ? encoded_data->data() : nullptr;
   }
 
   // Returns whether the encoded image can be considered to be of target
@@ -12,13 +12,26 @@
 
 #include <algorithm>
 
-#include "absl/algorithm/container.h"
 #include "absl/container/inlined_vector.h"
+#include "api/array_view.h"
+#include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/numerics/sequence_number_util.h"
 
 namespace webrtc {
 namespace {
+constexpr size_t kMinRingSize = 64;
+
+// Returns the smallest ring size, a power of two, for `num_frame_ids` frame
+// IDs.
+size_t RingSize(size_t num_frame_ids) {
+  size_t ring_size = kMinRingSize;
+  while (ring_size < num_frame_ids) {
+    ring_size *= 2;
+  }
+  return ring_size;
+}
+
 bool ValidReferences(const EncodedFrame& frame) {
   // All references must point backwards, and duplicates are not allowed.
   for (size_t i = 0; i < frame.num_references; ++i) {
@@ -34,28 +47,21 @@ bool ValidReferences(const EncodedFrame& frame) {
   return true;
 }
 
-// Since FrameBuffer::FrameInfo is private it can't be used in the function
-// signature, hence the FrameIteratorT type.
-template <typename FrameIteratorT>
-rtc::ArrayView<const int64_t> GetReferences(const FrameIteratorT& it) {
-  return {it->second.encoded_frame->references,
-          std::min<size_t>(it->second.encoded_frame->num_references,
+rtc::ArrayView<const int64_t> GetReferences(const EncodedFrame& frame) {
+  return {frame.references,
+          std::min<size_t>(frame.num_references,
                            EncodedFrame::kMaxFrameReferences)};
 }
 
-template <typename FrameIteratorT>
-int64_t GetFrameId(const FrameIteratorT& it) {
-  return it->first;
-}
-
-template <typename FrameIteratorT>
-uint32_t GetTimestamp(const FrameIteratorT& it) {
-  return it->second.encoded_frame->Timestamp();
-}
-
-template <typename FrameIteratorT>
-bool IsLastFrameInTemporalUnit(const FrameIteratorT& it) {
-  return it->second.encoded_frame->is_last_spatial_layer;
+// Returns the bit of `reference` in the reference bitmasks of `frame`.
+uint8_t ReferenceBit(const EncodedFrame& frame, int64_t reference) {
+  rtc::ArrayView<const int64_t> references = GetReferences(frame);
+  for (size_t i = 0; i < references.size(); ++i) {
+    if (references[i] == reference) {
+      return 1 << i;
+    }
+  }
+  return 0;
 }
 }  // namespace
 
@@ -65,6 +71,7 @@ FrameBuffer::FrameBuffer(int max_size,
     : legacy_frame_id_jump_behavior_(
           !field_trials.IsDisabled("WebRTC-LegacyFrameIdJumpBehavior")),
       max_size_(max_size),
+      max_ring_size_(RingSize(std::max(max_size, max_decode_history))),
       decoded_frame_history_(max_decode_history) {}
 
 bool FrameBuffer::InsertFrame(std::unique_ptr<EncodedFrame> frame) {
@@ -88,7 +95,7 @@ bool FrameBuffer::InsertFrame(std::unique_ptr<EncodedFrame> frame) {
     }
   }
 
-  if (frames_.size() == max_size_) {
+  if (num_frames_ == max_size_) {
     if (frame->is_keyframe()) {
       RTC_DLOG(LS_WARNING) << "Keyframe " << frame->Id()
                            << " inserted into full buffer, clearing buffer.";
@@ -100,18 +107,71 @@ bool FrameBuffer::InsertFrame(std::unique_ptr<EncodedFrame> frame) {
   }
 
   const int64_t frame_id = frame->Id();
-  auto insert_res = frames_.emplace(frame_id, FrameInfo{std::move(frame)});
-  if (!insert_res.second) {
+  if (FindInsertedFrame(frame_id)) {
     // Frame has already been inserted.
     return false;
   }
 
-  if (frames_.size() == max_size_) {
+  if (!ReserveFrameSlot(frame_id)) {
+    if (!frame->is_keyframe()) {
+      RTC_DLOG(LS_WARNING) << "Frame " << frame_id
+                           << " is too far from the buffered frames, dropping"
+                              " frame.";
+      return false;
+    }
+    RTC_DLOG(LS_WARNING) << "Keyframe " << frame_id
+                         << " is too far from the buffered frames, clearing"
+                            " buffer.";
+    Clear();
+    RTC_CHECK(ReserveFrameSlot(frame_id));
+  }
+
+  if (decodable_scan_ && frame_id <= decodable_scan_->last_frame_id) {
+    decodable_scan_.reset();
+  }
+
+  // The references are stored with the frame, which does not move when the
+  // ring grows.
+  const rtc::ArrayView<const int64_t> references = GetReferences(*frame);
+  FrameInfo& frame_info = GetOrCreateFrameSlot(frame_id);
+  frame_info.inserted = true;
+  frame_info.encoded_frame = std::move(frame);
+  ++num_frames_;
+
+  const absl::optional<int64_t> last_decoded_frame_id =
+      decoded_frame_history_.GetLastDecodedFrameId();
+  uint8_t missing_references = 0;
+  uint8_t undecoded_references = 0;
+  for (size_t i = 0; i < references.size(); ++i) {
+    const int64_t reference = references[i];
+    if (decoded_frame_history_.WasDecoded(reference)) {
+      continue;
+    }
+    const uint8_t bit = 1 << i;
+    missing_references |= bit;
+    undecoded_references |= bit;
+    // Frames that are older than the last decoded frame are never inserted.
+    if (reference <= last_decoded_frame_id || !ReserveFrameSlot(reference)) {
+      continue;
+    }
+    FrameInfo& reference_info = GetOrCreateFrameSlot(reference);
+    reference_info.dependents.push_back(frame_id);
+    if (reference_info.continuous) {
+      missing_references &= ~bit;
+    }
+  }
+  FrameInfo* inserted_frame = FindFrame(frame_id);
+  inserted_frame->missing_references = missing_references;
+  inserted_frame->undecoded_references = undecoded_references;
+
+  if (num_frames_ == max_size_) {
     RTC_DLOG(LS_WARNING) << "Frame " << frame_id
                          << " inserted, buffer is now full.";
   }
 
-  PropagateContinuity(insert_res.first);
+  if (missing_references == 0) {
+    PropagateContinuity(frame_id);
+  }
   FindNextAndLastDecodableTemporalUnit();
   return true;
 }
@@ -123,11 +183,16 @@ FrameBuffer::ExtractNextDecodableTemporalUnit() {
     return res;
   }
 
-  auto end_it = std::next(next_decodable_temporal_unit_->last_frame);
-  for (auto it = next_decodable_temporal_unit_->first_frame; it != end_it;
-       ++it) {
-    decoded_frame_history_.InsertDecoded(GetFrameId(it), GetTimestamp(it));
-    res.push_back(std::move(it->second.encoded_frame));
+  for (int64_t frame_id = next_decodable_temporal_unit_->first_frame_id;
+       frame_id <= next_decodable_temporal_unit_->last_frame_id; ++frame_id) {
+    FrameInfo* frame = FindFrame(frame_id);
+    if (!frame || !frame->inserted) {
+      continue;
+    }
+    decoded_frame_history_.InsertDecoded(frame_id,
+                                         frame->encoded_frame->Timestamp());
+    OnFrameDecoded(frame_id);
+    res.push_back(std::move(frame->encoded_frame));
   }
 
   DropNextDecodableTemporalUnit();
@@ -139,12 +204,8 @@ void FrameBuffer::DropNextDecodableTemporalUnit() {
     return;
   }
 
-  auto end_it = std::next(next_decodable_temporal_unit_->last_frame);
-  num_dropped_frames_ += std::count_if(
-      frames_.begin(), end_it,
-      [](const auto& f) { return f.second.encoded_frame != nullptr; });
-
-  frames_.erase(frames_.begin(), end_it);
+  ReleaseFramesUpTo(next_decodable_temporal_unit_->last_frame_id);
+  decodable_scan_.reset();
   FindNextAndLastDecodableTemporalUnit();
 }
 
@@ -169,107 +230,255 @@ int FrameBuffer::GetTotalNumberOfDroppedFrames() const {
 }
 
 size_t FrameBuffer::CurrentSize() const {
-  return frames_.size();
+  return num_frames_;
 }
 
-bool FrameBuffer::IsContinuous(const FrameIterator& it) const {
-  for (int64_t reference : GetReferences(it)) {
-    if (decoded_frame_history_.WasDecoded(reference)) {
-      continue;
-    }
+FrameBuffer::FrameInfo* FrameBuffer::FindFrame(int64_t frame_id) {
+  if (frame_id < first_frame_id_ || frame_id > last_frame_id_) {
+    return nullptr;
+  }
+  FrameInfo& frame = frames_[frame_id & (frames_.size() - 1)];
+  return frame.frame_id == frame_id ? &frame : nullptr;
+}
 
-    auto reference_frame_it = frames_.find(reference);
-    if (reference_frame_it != frames_.end() &&
-        reference_frame_it->second.continuous) {
-      continue;
-    }
+const FrameBuffer::FrameInfo* FrameBuffer::FindFrame(int64_t frame_id) const {
+  return const_cast<FrameBuffer*>(this)->FindFrame(frame_id);
+}
 
+const FrameBuffer::FrameInfo* FrameBuffer::FindInsertedFrame(
+    int64_t frame_id) const {
+  const FrameInfo* frame = FindFrame(frame_id);
+  return frame && frame->inserted ? frame : nullptr;
+}
+
+bool FrameBuffer::ReserveFrameSlot(int64_t frame_id) {
+  int64_t first_frame_id = frame_id;
+  int64_t last_frame_id = frame_id;
+  if (first_frame_id_ <= last_frame_id_) {
+    first_frame_id = std::min(first_frame_id, first_frame_id_);
+    last_frame_id = std::max(last_frame_id, last_frame_id_);
+  }
+  const uint64_t num_frame_ids = last_frame_id - first_frame_id + 1;
+  if (num_frame_ids <= frames_.size()) {
+    return true;
+  }
+  if (num_frame_ids > max_ring_size_) {
     return false;
   }
 
+  std::vector<FrameInfo> frames(RingSize(num_frame_ids));
+  for (int64_t id = first_frame_id_; id <= last_frame_id_; ++id) {
+    FrameInfo& frame = frames_[id & (frames_.size() - 1)];
+    if (frame.frame_id == id) {
+      frames[id & (frames.size() - 1)] = std::move(frame);
+    }
+  }
+  frames_ = std::move(frames);
   return true;
 }
 
-void FrameBuffer::PropagateContinuity(const FrameIterator& frame_it) {
-  for (auto it = frame_it; it != frames_.end(); ++it) {
-    if (!it->second.continuous) {
-      if (IsContinuous(it)) {
-        it->second.continuous = true;
-        if (last_continuous_frame_id_ < GetFrameId(it)) {
-          last_continuous_frame_id_ = GetFrameId(it);
-        }
-        if (IsLastFrameInTemporalUnit(it)) {
-          num_continuous_temporal_units_++;
-          if (last_continuous_temporal_unit_frame_id_ < GetFrameId(it)) {
-            last_continuous_temporal_unit_frame_id_ = GetFrameId(it);
+FrameBuffer::FrameInfo& FrameBuffer::GetOrCreateFrameSlot(int64_t frame_id) {
+  FrameInfo& frame = frames_[frame_id & (frames_.size() - 1)];
+  if (frame.frame_id == frame_id) {
+    return frame;
+  }
+  RTC_DCHECK_EQ(frame.frame_id, -1);
+  frame.frame_id = frame_id;
+  if (first_frame_id_ > last_frame_id_) {
+    first_frame_id_ = frame_id;
+    last_frame_id_ = frame_id;
+  } else {
+    first_frame_id_ = std::min(first_frame_id_, frame_id);
+    last_frame_id_ = std::max(last_frame_id_, frame_id);
+  }
+  return frame;
+}
+
+void FrameBuffer::ReleaseFramesUpTo(int64_t frame_id) {
+  const absl::optional<int64_t> last_decoded_frame_id =
+      decoded_frame_history_.GetLastDecodedFrameId();
+  const int64_t end_frame_id = std::min(frame_id, last_frame_id_);
+  for (int64_t id = first_frame_id_; id <= end_frame_id; ++id) {
+    FrameInfo* frame = FindFrame(id);
+    if (!frame) {
+      continue;
+    }
+    if (frame->inserted) {
+      --num_frames_;
+      if (frame->encoded_frame) {
+        ++num_dropped_frames_;
+        // The frame was dropped without being decoded, so it is missing again
+        // for the frames that are not continuous yet.
+        for (int64_t dependent_id : frame->dependents) {
+          FrameInfo* dependent = FindFrame(dependent_id);
+          if (dependent && dependent->encoded_frame &&
+              !dependent->continuous) {
+            dependent->missing_references |=
+                ReferenceBit(*dependent->encoded_frame, id);
           }
         }
+        if (id > last_decoded_frame_id) {
+          // The frame may be inserted again.
+          frame->inserted = false;
+          frame->encoded_frame = nullptr;
+          frame->continuous = false;
+          continue;
+        }
       }
+    } else if (id > last_decoded_frame_id) {
+      // The frame may still be inserted, keep track of its dependents.
+      continue;
     }
+    *frame = FrameInfo();
+  }
+
+  while (first_frame_id_ <= last_frame_id_ && !FindFrame(first_frame_id_)) {
+    ++first_frame_id_;
   }
 }
 
-void FrameBuffer::FindNextAndLastDecodableTemporalUnit() {
-  next_decodable_temporal_unit_.reset();
-  decodable_temporal_units_info_.reset();
+void FrameBuffer::PropagateContinuity(int64_t frame_id) {
+  absl::InlinedVector<int64_t, 4> continuous_frame_ids = {frame_id};
+  while (!continuous_frame_ids.empty()) {
+    const int64_t id = continuous_frame_ids.back();
+    continuous_frame_ids.pop_back();
+    FrameInfo* frame = FindFrame(id);
+    if (frame->continuous) {
+      continue;
+    }
+    frame->continuous = true;
+    if (last_continuous_frame_id_ < id) {
+      last_continuous_frame_id_ = id;
+    }
+    if (frame->encoded_frame->is_last_spatial_layer) {
+      num_continuous_temporal_units_++;
+      if (last_continuous_temporal_unit_frame_id_ < id) {
+        last_continuous_temporal_unit_frame_id_ = id;
+      }
+    }
+
+    for (int64_t dependent_id : frame->dependents) {
+      FrameInfo* dependent = FindFrame(dependent_id);
+      if (!dependent || !dependent->inserted || dependent->continuous) {
+        continue;
+      }
+      dependent->missing_references &=
+          ~ReferenceBit(*dependent->encoded_frame, id);
+      if (dependent->missing_references == 0) {
+        continuous_frame_ids.push_back(dependent_id);
+      }
+    }
+  }
+}
+
+void FrameBuffer::OnFrameDecoded(int64_t frame_id) {
+  for (int64_t dependent_id : FindFrame(frame_id)->dependents) {
+    FrameInfo* dependent = FindFrame(dependent_id);
+    // Frames of the same temporal unit may already have been extracted.
+    if (!dependent || !dependent->encoded_frame) {
+      continue;
+    }
+    dependent->undecoded_references &=
+        ~ReferenceBit(*dependent->encoded_frame, frame_id);
+  }
+}
+
+bool FrameBuffer::IsTemporalUnitDecodable(int64_t first_frame_id,
+                                          int64_t last_frame_id) const {
+  for (int64_t frame_id = first_frame_id; frame_id <= last_frame_id;
+       ++frame_id) {
+    const FrameInfo* frame = FindInsertedFrame(frame_id);
+    if (!frame || frame->undecoded_references == 0) {
+      continue;
+    }
+    rtc::ArrayView<const int64_t> references =
+        GetReferences(*frame->encoded_frame);
+    for (size_t i = 0; i < references.size(); ++i) {
+      if ((frame->undecoded_references & (1 << i)) != 0 &&
+          (references[i] < first_frame_id ||
+           !FindInsertedFrame(references[i]))) {
+        // A frame in the temporal unit has a non-decoded reference outside
+        // the temporal unit, so it's not yet ready to be decoded.
+        return false;
+      }
+    }
+  }
+  return true;
+}
 
+void FrameBuffer::FindNextAndLastDecodableTemporalUnit() {
   if (!last_continuous_temporal_unit_frame_id_) {
+    next_decodable_temporal_unit_.reset();
+    decodable_temporal_units_info_.reset();
+    decodable_scan_.reset();
     return;
   }
 
-  FrameIterator first_frame_it = frames_.begin();
-  FrameIterator last_frame_it = frames_.begin();
-  absl::InlinedVector<int64_t, 4> frames_in_temporal_unit;
-  uint32_t last_decodable_temporal_unit_timestamp;
-  for (auto frame_it = frames_.begin(); frame_it != frames_.end();) {
-    if (GetFrameId(frame_it) > *last_continuous_temporal_unit_frame_id_) {
-      break;
+  // Continue where the last scan stopped if the frames it looked at are
+  // unchanged.
+  int64_t frame_id = first_frame_id_;
+  absl::optional<int64_t> temporal_unit_first_frame_id;
+  uint32_t last_decodable_temporal_unit_timestamp = 0;
+  if (decodable_scan_) {
+    frame_id = decodable_scan_->last_frame_id + 1;
+    temporal_unit_first_frame_id =
+        decodable_scan_->temporal_unit_first_frame_id;
+    if (decodable_temporal_units_info_) {
+      last_decodable_temporal_unit_timestamp =
+          decodable_temporal_units_info_->last_rtp_timestamp;
     }
+  } else {
+    next_decodable_temporal_unit_.reset();
+  }
 
-    if (GetTimestamp(frame_it) != GetTimestamp(first_frame_it)) {
-      frames_in_temporal_unit.clear();
-      first_frame_it = frame_it;
+  for (; frame_id <= *last_continuous_temporal_unit_frame_id_; ++frame_id) {
+    const FrameInfo* frame = FindInsertedFrame(frame_id);
+    if (!frame) {
+      continue;
+    }
+    const uint32_t timestamp = frame->encoded_frame->Timestamp();
+    if (!temporal_unit_first_frame_id ||
+        timestamp != FindFrame(*temporal_unit_first_frame_id)
+                         ->encoded_frame->Timestamp()) {
+      temporal_unit_first_frame_id = frame_id;
     }
 
-    frames_in_temporal_unit.push_back(GetFrameId(frame_it));
-
-    last_frame_it = frame_it++;
-
-    if (IsLastFrameInTemporalUnit(last_frame_it)) {
-      bool temporal_unit_decodable = true;
-      for (auto it = first_frame_it; it != frame_it && temporal_unit_decodable;
-           ++it) {
-        for (int64_t reference : GetReferences(it)) {
-          if (!decoded_frame_history_.WasDecoded(reference) &&
-              !absl::c_linear_search(frames_in_temporal_unit, reference)) {
-            // A frame in the temporal unit has a non-decoded reference outside
-            // the temporal unit, so it's not yet ready to be decoded.
-            temporal_unit_decodable = false;
-            break;
-          }
-        }
+    if (frame->encoded_frame->is_last_spatial_layer &&
+        IsTemporalUnitDecodable(*temporal_unit_first_frame_id, frame_id)) {
+      if (!next_decodable_temporal_unit_) {
+        next_decodable_temporal_unit_ = {
+            .first_frame_id = *temporal_unit_first_frame_id,
+            .last_frame_id = frame_id};
       }
 
-      if (temporal_unit_decodable) {
-        if (!next_decodable_temporal_unit_) {
-          next_decodable_temporal_unit_ = {first_frame_it, last_frame_it};
-        }
-
-        last_decodable_temporal_unit_timestamp = GetTimestamp(first_frame_it);
-      }
+      last_decodable_temporal_unit_timestamp = timestamp;
     }
   }
 
+  if (temporal_unit_first_frame_id) {
+    decodable_scan_ = {
+        .last_frame_id = *last_continuous_temporal_unit_frame_id_,
+        .temporal_unit_first_frame_id = *temporal_unit_first_frame_id};
+  }
+
+  decodable_temporal_units_info_.reset();
   if (next_decodable_temporal_unit_) {
     decodable_temporal_units_info_ = {
         .next_rtp_timestamp =
-            GetTimestamp(next_decodable_temporal_unit_->first_frame),
+            FindFrame(next_decodable_temporal_unit_->first_frame_id)
+                ->encoded_frame->Timestamp(),
         .last_rtp_timestamp = last_decodable_temporal_unit_timestamp};
   }
 }
 
 void FrameBuffer::Clear() {
-  frames_.clear();
+  for (FrameInfo& frame : frames_) {
+    frame = FrameInfo();
+  }
+  first_frame_id_ = 0;
+  last_frame_id_ = -1;
+  num_frames_ = 0;
+  decodable_scan_.reset();
   next_decodable_temporal_unit_.reset();
   decodable_temporal_units_info_.reset();
   last_continuous_frame_id_.reset();
@@ -11,9 +11,11 @@
 #ifndef API_VIDEO_FRAME_BUFFER_H_
 #define API_VIDEO_FRAME_BUFFER_H_
 
-#include <map>
+#include <stdint.h>
+
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "absl/container/inlined_vector.h"
 #include "absl/types/optional.h"
@@ -27,6 +29,9 @@ namespace webrtc {
 // into temporal units by timestamp. A temporal unit is decodable after all
 // referenced frames outside the unit has been decoded, and a temporal unit is
 // continuous if all referenced frames are directly or indirectly decodable.
+// Frames are stored in a ring indexed by frame ID, and each frame keeps track
+// of the frames that reference it, so that inserting and decoding a frame only
+// updates the frames that depend on it.
 // The FrameBuffer is thread-unsafe.
 class FrameBuffer {
  public:
@@ -48,8 +53,9 @@ class FrameBuffer {
 
   // Inserted frames may only reference backwards, and must have no duplicate
   // references. Frame insertion will fail if `frame` is a duplicate, has
-  // already been decoded, invalid, or if the buffer is full and the frame is
-  // not a keyframe. Returns true if the frame was successfully inserted.
+  // already been decoded, invalid, or if the buffer is full or the frame ID is
+  // too far from the IDs of the buffered frames, and the frame is not a
+  // keyframe. Returns true if the frame was successfully inserted.
   bool InsertFrame(std::unique_ptr<EncodedFrame> frame);
 
   // Mark all frames belonging to the next decodable temporal unit as decoded
@@ -69,28 +75,63 @@ class FrameBuffer {
   size_t CurrentSize() const;
 
  private:
+  // A slot of the frame ring. A slot is used by an inserted frame, or by a
+  // frame that has not been inserted yet but is referenced by inserted frames.
   struct FrameInfo {
+    int64_t frame_id = -1;
+    bool inserted = false;
     std::unique_ptr<EncodedFrame> encoded_frame;
     bool continuous = false;
+    // Bit i is set while the i-th reference of the frame is neither decoded
+    // nor continuous.
+    uint8_t missing_references = 0;
+    // Bit i is set while the i-th reference of the frame is not decoded.
+    uint8_t undecoded_references = 0;
+    // The inserted frames that reference this frame and that were inserted
+    // before it was decoded. May contain frames that have since been removed.
+    absl::InlinedVector<int64_t, 4> dependents;
   };
 
-  using FrameMap = std::map<int64_t, FrameInfo>;
-  using FrameIterator = FrameMap::iterator;
-
   struct TemporalUnit {
     // Both first and last are inclusive.
-    FrameIterator first_frame;
-    FrameIterator last_frame;
+    int64_t first_frame_id;
+    int64_t last_frame_id;
+  };
+
+  // How far FindNextAndLastDecodableTemporalUnit has looked for decodable
+  // temporal units. Inserting frames after `last_frame_id` does not change
+  // the temporal units found up to it.
+  struct DecodableScan {
+    int64_t last_frame_id;
+    int64_t temporal_unit_first_frame_id;
   };
 
-  bool IsContinuous(const FrameIterator& it) const;
-  void PropagateContinuity(const FrameIterator& frame_it);
+  FrameInfo* FindFrame(int64_t frame_id);
+  const FrameInfo* FindFrame(int64_t frame_id) const;
+  const FrameInfo* FindInsertedFrame(int64_t frame_id) const;
+  // Makes room in the ring for a slot for `frame_id`. Returns false if the
+  // ring would exceed its maximum size.
+  bool ReserveFrameSlot(int64_t frame_id);
+  FrameInfo& GetOrCreateFrameSlot(int64_t frame_id);
+  // Removes the frames up to and including `frame_id`.
+  void ReleaseFramesUpTo(int64_t frame_id);
+  void PropagateContinuity(int64_t frame_id);
+  void OnFrameDecoded(int64_t frame_id);
+  bool IsTemporalUnitDecodable(int64_t first_frame_id,
+                               int64_t last_frame_id) const;
   void FindNextAndLastDecodableTemporalUnit();
   void Clear();
 
   const bool legacy_frame_id_jump_behavior_;
   const size_t max_size_;
-  FrameMap frames_;
+  const size_t max_ring_size_;
+  // The frames indexed by frame ID, modulo the ring size which is a power of
+  // two. All used slots are between `first_frame_id_` and `last_frame_id_`.
+  std::vector<FrameInfo> frames_;
+  int64_t first_frame_id_ = 0;
+  int64_t last_frame_id_ = -1;
+  size_t num_frames_ = 0;
+  absl::optional<DecodableScan> decodable_scan_;
   absl::optional<TemporalUnit> next_decodable_temporal_unit_;
   absl::optional<DecodabilityInfo> decodable_temporal_units_info_;
   absl::optional<int64_t> last_continuous_frame_id_;
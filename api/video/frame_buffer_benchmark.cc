@@ -0,0 +1,147 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "api/video/encoded_frame.h"
+#include "api/video/frame_buffer.h"
+#include "benchmark/benchmark.h"
+#include "common_video/generic_frame_descriptor/generic_frame_info.h"
+#include "modules/video_coding/frame_dependencies_calculator.h"
+#include "modules/video_coding/svc/create_scalability_structure.h"
+#include "modules/video_coding/svc/scalable_video_controller.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/system/unused.h"
+#include "test/fake_encoded_frame.h"
+#include "test/scoped_key_value_config.h"
+
+namespace webrtc {
+namespace {
+
+// Same as VideoStreamBufferController.
+constexpr int kMaxFramesBuffered = 800;
+constexpr int kMaxFramesHistory = 1 << 13;
+constexpr uint32_t kRtpTimestampDelta = 90'000 / 30;
+// The number of temporal units after which L3T3_KEY repeats its references.
+constexpr int kPatternLength = 4;
+
+struct FrameTemplate {
+  int spatial_id;
+  std::vector<int64_t> frame_diffs;
+};
+
+std::vector<std::vector<FrameTemplate>> GenerateL3T3KeyTemporalUnits(
+    int num_temporal_units) {
+  std::unique_ptr<ScalableVideoController> structure =
+      CreateScalabilityStructure(ScalabilityMode::kL3T3_KEY);
+  RTC_CHECK(structure);
+  FrameDependenciesCalculator dependencies_calculator;
+  int64_t frame_id = 0;
+  std::vector<std::vector<FrameTemplate>> temporal_units(num_temporal_units);
+  for (std::vector<FrameTemplate>& frames : temporal_units) {
+    for (const ScalableVideoController::LayerFrameConfig& layer_frame :
+         structure->NextFrameConfig(/*restart=*/false)) {
+      ++frame_id;
+      GenericFrameInfo frame_info = structure->OnEncodeDone(layer_frame);
+      FrameTemplate& frame = frames.emplace_back();
+      frame.spatial_id = frame_info.spatial_id;
+      for (int64_t reference : dependencies_calculator.FromBuffersUsage(
+               frame_id, frame_info.encoder_buffers)) {
+        frame.frame_diffs.push_back(frame_id - reference);
+      }
+    }
+  }
+  return temporal_units;
+}
+
+// Inserts an L3T3_KEY stream into the FrameBuffer and extracts the decodable
+// temporal units while more than `state.range(0)` temporal units are
+// buffered. The temporal units arrive in blocks of `state.range(1)`, and the
+// frames of blocks of more than one temporal unit arrive in reverse order.
+void BM_FrameBufferL3T3Key(benchmark::State& state) {
+  const int max_buffered_temporal_units = state.range(0);
+  const int temporal_units_per_block = state.range(1);
+  const std::vector<std::vector<FrameTemplate>> temporal_units =
+      GenerateL3T3KeyTemporalUnits(1 + 2 * kPatternLength);
+  test::ScopedKeyValueConfig field_trials;
+  FrameBuffer buffer(kMaxFramesBuffered, kMaxFramesHistory, field_trials);
+
+  int64_t frame_id = 0;
+  uint32_t rtp_timestamp = 0;
+  int64_t num_temporal_units = 0;
+  int buffered_temporal_units = 0;
+  int64_t num_frames = 0;
+  std::vector<std::unique_ptr<EncodedFrame>> block;
+  auto add_temporal_unit = [&](const std::vector<FrameTemplate>& frames) {
+    rtp_timestamp += kRtpTimestampDelta;
+    for (size_t i = 0; i < frames.size(); ++i) {
+      ++frame_id;
+      std::vector<int64_t> references;
+      for (int64_t frame_diff : frames[i].frame_diffs) {
+        references.push_back(frame_id - frame_diff);
+      }
+      test::FakeFrameBuilder builder;
+      builder.Time(rtp_timestamp)
+          .Id(frame_id)
+          .SpatialLayer(frames[i].spatial_id)
+          .Refs(references);
+      if (i + 1 == frames.size()) {
+        builder.AsLast();
+      }
+      block.push_back(builder.Build());
+    }
+    ++buffered_temporal_units;
+  };
+
+  // The keyframe.
+  add_temporal_unit(temporal_units[0]);
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    for (int i = 0; i < temporal_units_per_block; ++i) {
+      // The references of the second period are the steady state ones.
+      add_temporal_unit(
+          temporal_units[1 + kPatternLength +
+                         num_temporal_units++ % kPatternLength]);
+    }
+    num_frames += block.size();
+    if (temporal_units_per_block > 1) {
+      std::reverse(block.begin(), block.end());
+    }
+    for (std::unique_ptr<EncodedFrame>& frame : block) {
+      buffer.InsertFrame(std::move(frame));
+    }
+    block.clear();
+
+    while (buffered_temporal_units > max_buffered_temporal_units &&
+           buffer.DecodableTemporalUnitsInfo()) {
+      benchmark::DoNotOptimize(buffer.ExtractNextDecodableTemporalUnit());
+      --buffered_temporal_units;
+    }
+  }
+  RTC_CHECK_EQ(buffer.GetTotalNumberOfDroppedFrames(), 0);
+
+  state.SetItemsProcessed(num_frames);
+  state.counters["time_per_frame"] = benchmark::Counter(
+      num_frames, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+BENCHMARK(BM_FrameBufferL3T3Key)
+    ->ArgNames({"buffered", "reorder"})
+    ->Args({0, 1})
+    ->Args({30, 1})
+    ->Args({30, 4});
+
+}  // namespace
+}  // namespace webrtc
@@ -389,5 +389,50 @@ TEST(FrameBuffer3Test, TotalNumberOfDroppedFrames) {
   EXPECT_THAT(buffer.GetTotalNumberOfDroppedFrames(), Eq(2));
 }
 
+TEST(FrameBuffer3Test, ContinuityPropagatesThroughReorderedFrames) {
+  test::ScopedKeyValueConfig field_trials;
+  FrameBuffer buffer(/*max_frame_slots=*/20, /*max_decode_history=*/100,
+                     field_trials);
+  for (int64_t id = 10; id > 1; --id) {
+    EXPECT_TRUE(buffer.InsertFrame(test::FakeFrameBuilder()
+                                       .Time(id * 10)
+                                       .Id(id)
+                                       .Refs({id - 1})
+                                       .AsLast()
+                                       .Build()));
+  }
+  EXPECT_THAT(buffer.LastContinuousFrameId(), Eq(absl::nullopt));
+
+  EXPECT_TRUE(buffer.InsertFrame(
+      test::FakeFrameBuilder().Time(10).Id(1).AsLast().Build()));
+  EXPECT_THAT(buffer.LastContinuousFrameId(), Eq(10));
+  EXPECT_THAT(buffer.GetTotalNumberOfContinuousTemporalUnits(), Eq(10));
+  for (int64_t id = 1; id <= 10; ++id) {
+    EXPECT_THAT(buffer.ExtractNextDecodableTemporalUnit(),
+                ElementsAre(FrameWithId(id)));
+  }
+}
+
+TEST(FrameBuffer3Test, FramesTooFarFromBufferedFrames) {
+  test::ScopedKeyValueConfig field_trials;
+  // Frame IDs are stored for up to 128 frames, the maximum history rounded up
+  // to a power of two.
+  FrameBuffer buffer(/*max_frame_slots=*/10, /*max_decode_history=*/100,
+                     field_trials);
+  EXPECT_TRUE(buffer.InsertFrame(
+      test::FakeFrameBuilder().Time(10).Id(1).AsLast().Build()));
+  EXPECT_TRUE(buffer.InsertFrame(
+      test::FakeFrameBuilder().Time(20).Id(128).Refs({1}).AsLast().Build()));
+  EXPECT_FALSE(buffer.InsertFrame(
+      test::FakeFrameBuilder().Time(30).Id(129).Refs({128}).AsLast().Build()));
+
+  // A keyframe clears the buffer instead.
+  EXPECT_TRUE(buffer.InsertFrame(
+      test::FakeFrameBuilder().Time(30).Id(1000).AsLast().Build()));
+  EXPECT_THAT(buffer.CurrentSize(), Eq(1u));
+  EXPECT_THAT(buffer.ExtractNextDecodableTemporalUnit(),
+              ElementsAre(FrameWithId(1000)));
+}
+
 }  // namespace
 }  // namespace webrtc
@@ -0,0 +1,128 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "api/array_view.h"
+#include "api/scoped_refptr.h"
+#include "api/video/encoded_image.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/copy_on_write_buffer.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+using ::testing::ElementsAre;
+
+std::vector<uint8_t> Fragment(const EncodedImageBufferInterface& buffer,
+                              size_t index) {
+  rtc::ArrayView<const uint8_t> fragment = buffer.fragment(index);
+  return std::vector<uint8_t>(fragment.begin(), fragment.end());
+}
+
+TEST(FragmentedEncodedImageBufferTest, ReferencesFragmentsWithoutCopy) {
+  const uint8_t kPayload1[] = {1, 2, 3};
+  const uint8_t kPayload2[] = {4, 5};
+  rtc::CopyOnWriteBuffer payload1(kPayload1);
+  rtc::CopyOnWriteBuffer payload2(kPayload2);
+
+  rtc::scoped_refptr<FragmentedEncodedImageBuffer> buffer =
+      FragmentedEncodedImageBuffer::Create({payload1, payload2});
+  EXPECT_EQ(buffer->size(), 5u);
+  ASSERT_EQ(buffer->num_fragments(), 2u);
+  EXPECT_EQ(buffer->fragment(0).data(), payload1.cdata());
+  EXPECT_EQ(buffer->fragment(1).data(), payload2.cdata());
+  EXPECT_THAT(Fragment(*buffer, 1), ElementsAre(4, 5));
+}
+
+TEST(FragmentedEncodedImageBufferTest, DataOfOneFragmentIsNotCopied) {
+  const uint8_t kPayload[] = {1, 2, 3};
+  rtc::CopyOnWriteBuffer payload(kPayload);
+
+  rtc::scoped_refptr<const FragmentedEncodedImageBuffer> buffer =
+      FragmentedEncodedImageBuffer::Create({payload});
+  EXPECT_EQ(buffer->data(), payload.cdata());
+  EXPECT_EQ(buffer->size(), 3u);
+}
+
+TEST(FragmentedEncodedImageBufferTest, FragmentsStayValidAfterData) {
+  const uint8_t kPayload[] = {1, 2, 3};
+  rtc::CopyOnWriteBuffer payload(kPayload);
+
+  rtc::scoped_refptr<const FragmentedEncodedImageBuffer> buffer =
+      FragmentedEncodedImageBuffer::Create({payload});
+  rtc::ArrayView<const uint8_t> fragment = buffer->fragment(0);
+  EXPECT_EQ(buffer->data(), fragment.data());
+  EXPECT_EQ(buffer->fragment(0).data(), fragment.data());
+  EXPECT_THAT(fragment, ElementsAre(1, 2, 3));
+}
+
+TEST(FragmentedEncodedImageBufferTest, CopiesFragmentsIntoContiguousBuffer) {
+  const uint8_t kPayload1[] = {1, 2, 3};
+  const uint8_t kPayload2[] = {4, 5};
+  rtc::CopyOnWriteBuffer payload1(kPayload1);
+  rtc::CopyOnWriteBuffer payload2(kPayload2);
+
+  rtc::scoped_refptr<const FragmentedEncodedImageBuffer> buffer =
+      FragmentedEncodedImageBuffer::Create({payload1, payload2});
+  rtc::ArrayView<const uint8_t> fragment0 = buffer->fragment(0);
+  rtc::ArrayView<const uint8_t> fragment1 = buffer->fragment(1);
+
+  rtc::scoped_refptr<EncodedImageBuffer> contiguous =
+      EncodedImageBuffer::Create(*buffer);
+  EXPECT_THAT(std::vector<uint8_t>(contiguous->data(),
+                                   contiguous->data() + contiguous->size()),
+              ElementsAre(1, 2, 3, 4, 5));
+
+  // The fragments are left as they were.
+  ASSERT_EQ(buffer->num_fragments(), 2u);
+  EXPECT_EQ(buffer->fragment(0).data(), fragment0.data());
+  EXPECT_EQ(buffer->fragment(1).data(), fragment1.data());
+  EXPECT_THAT(fragment0, ElementsAre(1, 2, 3));
+  EXPECT_THAT(fragment1, ElementsAre(4, 5));
+}
+
+#if RTC_DCHECK_IS_ON && GTEST_HAS_DEATH_TEST && !defined(WEBRTC_ANDROID)
+TEST(FragmentedEncodedImageBufferDeathTest, DataOfSeveralFragments) {
+  const uint8_t kPayload1[] = {1, 2, 3};
+  const uint8_t kPayload2[] = {4, 5};
+  rtc::scoped_refptr<const FragmentedEncodedImageBuffer> buffer =
+      FragmentedEncodedImageBuffer::Create({rtc::CopyOnWriteBuffer(kPayload1),
+                                            rtc::CopyOnWriteBuffer(kPayload2)});
+  EXPECT_DEATH(buffer->data(), "");
+}
+#endif  // RTC_DCHECK_IS_ON && GTEST_HAS_DEATH_TEST && !defined(WEBRTC_ANDROID)
+
+TEST(FragmentedEncodedImageBufferTest, WritesDoNotChangeTheFragments) {
+  const uint8_t kPayload[] = {1, 2, 3};
+  rtc::CopyOnWriteBuffer payload(kPayload);
+
+  rtc::scoped_refptr<FragmentedEncodedImageBuffer> buffer =
+      FragmentedEncodedImageBuffer::Create({payload});
+  buffer->data()[0] = 7;
+  EXPECT_THAT(Fragment(*buffer, 0), ElementsAre(7, 2, 3));
+  EXPECT_EQ(payload.cdata()[0], 1);
+}
+
+TEST(FragmentedEncodedImageBufferTest, EncodedImageBufferHasOneFragment) {
+  const uint8_t kData[] = {1, 2, 3};
+  rtc::scoped_refptr<EncodedImageBuffer> buffer =
+      EncodedImageBuffer::Create(kData, sizeof(kData));
+  ASSERT_EQ(buffer->num_fragments(), 1u);
+  EXPECT_EQ(buffer->fragment(0).data(), buffer->data());
+  EXPECT_EQ(buffer->fragment(0).size(), 3u);
+}
+
+}  // namespace
+}  // namespace webrtc
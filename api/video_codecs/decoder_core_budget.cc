@@ -0,0 +1,40 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "api/video_codecs/decoder_core_budget.h"
+
+#include <algorithm>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+DecoderCoreBudget::DecoderCoreBudget(int num_cores)
+    : available_threads_(num_cores - 1) {
+  RTC_DCHECK_GT(num_cores, 0);
+}
+
+int DecoderCoreBudget::ReserveThreads(int num_threads) {
+  RTC_DCHECK_GT(num_threads, 0);
+  int available = available_threads_.load();
+  int extra_threads;
+  do {
+    extra_threads = std::min(num_threads - 1, available);
+  } while (extra_threads > 0 && !available_threads_.compare_exchange_weak(
+                                    available, available - extra_threads));
+  return 1 + std::max(extra_threads, 0);
+}
+
+void DecoderCoreBudget::ReturnThreads(int num_threads) {
+  RTC_DCHECK_GT(num_threads, 0);
+  available_threads_.fetch_add(num_threads - 1);
+}
+
+}  // namespace webrtc
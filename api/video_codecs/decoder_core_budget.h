@@ -0,0 +1,55 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef API_VIDEO_CODECS_DECODER_CORE_BUDGET_H_
+#define API_VIDEO_CODECS_DECODER_CORE_BUDGET_H_
+
+#include <atomic>
+
+#include "api/ref_counted_base.h"
+#include "rtc_base/system/rtc_export.h"
+
+namespace webrtc {
+
+// DecoderCoreBudget caps the number of threads that all software decoders
+// sharing it may use together, e.g. one budget per process that is set in
+// the `VideoDecoder::Settings` of every decoder.
+//
+// A decoder always gets one thread to decode on. The threads that it uses in
+// addition to that are reserved from the budget when it is configured and
+// returned when it is released, so that a few high resolution streams can
+// decode with many threads while many streams decode with one thread each.
+//
+// DecoderCoreBudget is thread safe.
+class RTC_EXPORT DecoderCoreBudget
+    : public rtc::RefCountedNonVirtual<DecoderCoreBudget> {
+ public:
+  // `num_cores` is the total number of threads, and must be positive.
+  explicit DecoderCoreBudget(int num_cores);
+  DecoderCoreBudget(const DecoderCoreBudget&) = delete;
+  DecoderCoreBudget& operator=(const DecoderCoreBudget&) = delete;
+
+  // Reserves up to `num_threads` threads for a decoder. Returns the number of
+  // threads reserved, which is at least one.
+  int ReserveThreads(int num_threads);
+  // Returns `num_threads` threads reserved by `ReserveThreads()` to the
+  // budget.
+  void ReturnThreads(int num_threads);
+
+  // Number of threads beyond their first that decoders may still reserve.
+  int available_threads() const { return available_threads_.load(); }
+
+ private:
+  std::atomic<int> available_threads_;
+};
+
+}  // namespace webrtc
+
+#endif  // API_VIDEO_CODECS_DECODER_CORE_BUDGET_H_
@@ -0,0 +1,44 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "api/video_codecs/decoder_core_budget.h"
+
+#include "test/gtest.h"
+
+namespace webrtc {
+
+TEST(DecoderCoreBudgetTest, ReservesRequestedThreadsWithinBudget) {
+  DecoderCoreBudget budget(/*num_cores=*/8);
+  EXPECT_EQ(budget.available_threads(), 7);
+  EXPECT_EQ(budget.ReserveThreads(4), 4);
+  EXPECT_EQ(budget.available_threads(), 4);
+  EXPECT_EQ(budget.ReserveThreads(1), 1);
+  EXPECT_EQ(budget.available_threads(), 4);
+}
+
+TEST(DecoderCoreBudgetTest, ReservesOneThreadWhenBudgetIsSpent) {
+  DecoderCoreBudget budget(/*num_cores=*/4);
+  EXPECT_EQ(budget.ReserveThreads(8), 4);
+  EXPECT_EQ(budget.available_threads(), 0);
+  EXPECT_EQ(budget.ReserveThreads(8), 1);
+  EXPECT_EQ(budget.ReserveThreads(2), 1);
+  EXPECT_EQ(budget.available_threads(), 0);
+}
+
+TEST(DecoderCoreBudgetTest, ReturnedThreadsCanBeReservedAgain) {
+  DecoderCoreBudget budget(/*num_cores=*/4);
+  int reserved = budget.ReserveThreads(3);
+  EXPECT_EQ(budget.ReserveThreads(3), 2);
+  budget.ReturnThreads(reserved);
+  EXPECT_EQ(budget.available_threads(), 2);
+  EXPECT_EQ(budget.ReserveThreads(3), 3);
+}
+
+}  // namespace webrtc
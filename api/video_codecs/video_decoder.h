@@ -13,13 +13,16 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/types/optional.h"
+#include "api/scoped_refptr.h"
 #include "api/video/encoded_image.h"
 #include "api/video/render_resolution.h"
 #include "api/video/video_codec_type.h"
 #include "api/video/video_frame.h"
+#include "api/video_codecs/decoder_core_budget.h"
 #include "rtc_base/system/rtc_export.h"
 
 namespace webrtc {
@@ -56,6 +59,20 @@ class RTC_EXPORT VideoDecoder {
     bool operator!=(const DecoderInfo& rhs) const { return !(*this == rhs); }
   };
 
+  // How a software decoder spreads the decoding of a stream over threads.
+  enum class ThreadingMode {
+    // The decoder picks the number of threads from the resolution.
+    kDefault,
+    // Up to `Settings::number_of_cores()` threads decode tiles or rows of one
+    // frame at a time. Adds no latency.
+    kTileParallel,
+    // Up to `Settings::number_of_cores()` threads decode several frames at a
+    // time, which scales better than tiles but delays the output of a frame
+    // by up to one frame per extra thread. Decoders that can't decode frames
+    // in parallel fall back to `kTileParallel`.
+    kFrameParallel,
+  };
+
   class Settings {
    public:
     Settings() = default;
@@ -85,11 +102,25 @@ class RTC_EXPORT VideoDecoder {
     VideoCodecType codec_type() const { return codec_type_; }
     void set_codec_type(VideoCodecType value) { codec_type_ = value; }
 
+    ThreadingMode threading_mode() const { return threading_mode_; }
+    void set_threading_mode(ThreadingMode value) { threading_mode_ = value; }
+
+    // When set, the threads the decoder uses beyond its first are reserved
+    // from `core_budget`, which may be shared with other decoders.
+    const rtc::scoped_refptr<DecoderCoreBudget>& core_budget() const {
+      return core_budget_;
+    }
+    void set_core_budget(rtc::scoped_refptr<DecoderCoreBudget> value) {
+      core_budget_ = std::move(value);
+    }
+
    private:
     absl::optional<int> buffer_pool_size_;
     RenderResolution max_resolution_;
     int number_of_cores_ = 1;
     VideoCodecType codec_type_ = kVideoCodecGeneric;
+    ThreadingMode threading_mode_ = ThreadingMode::kDefault;
+    rtc::scoped_refptr<DecoderCoreBudget> core_budget_;
   };
 
   virtual ~VideoDecoder() = default;
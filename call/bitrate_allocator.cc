@@ -13,8 +13,11 @@
 
 #include <algorithm>
 #include <cmath>
+#include <iterator>
 #include <memory>
+#include <numeric>
 #include <utility>
+#include <vector>
 
 #include "absl/algorithm/container.h"
 #include "api/units/data_rate.h"
@@ -29,6 +32,10 @@ namespace webrtc {
 
 namespace {
 using bitrate_allocator_impl::AllocatableTrack;
+using bitrate_allocator_impl::AllocationOrders;
+
+// Bitrate per track, indexed like the tracks.
+using Allocation = std::vector<int>;
 
 // Allow packets to be transmitted in up to 2 times max video bitrate if the
 // bandwidth estimate allows it.
@@ -75,37 +82,39 @@ bool EnoughBitrateForAllObservers(
 // observer max bitrate.
 void DistributeBitrateEvenly(
     const std::vector<AllocatableTrack>& allocatable_tracks,
+    const AllocationOrders& orders,
     uint32_t bitrate,
     bool include_zero_allocations,
     int max_multiplier,
-    std::map<BitrateAllocatorObserver*, int>* allocation) {
+    Allocation* allocation) {
   RTC_DCHECK_EQ(allocation->size(), allocatable_tracks.size());
-
-  std::multimap<uint32_t, const AllocatableTrack*> list_max_bitrates;
-  for (const auto& observer_config : allocatable_tracks) {
-    if (include_zero_allocations ||
-        allocation->at(observer_config.observer) != 0) {
-      list_max_bitrates.insert(
-          {observer_config.config.max_bitrate_bps, &observer_config});
-    }
+  RTC_DCHECK_EQ(orders.by_max_bitrate.size(), allocatable_tracks.size());
+
+  // Observers with a zero allocation stay at zero, so they can be skipped on
+  // the way without changing the number of observers left to share with.
+  uint32_t num_observers = 0;
+  for (size_t track : orders.by_max_bitrate) {
+    if (include_zero_allocations || (*allocation)[track] != 0)
+      ++num_observers;
   }
-  auto it = list_max_bitrates.begin();
-  while (it != list_max_bitrates.end()) {
+  for (size_t track : orders.by_max_bitrate) {
+    if (!include_zero_allocations && (*allocation)[track] == 0)
+      continue;
     RTC_DCHECK_GT(bitrate, 0);
-    uint32_t extra_allocation =
-        bitrate / static_cast<uint32_t>(list_max_bitrates.size());
-    uint32_t total_allocation =
-        extra_allocation + allocation->at(it->second->observer);
+    const uint32_t max_bitrate_bps =
+        allocatable_tracks[track].config.max_bitrate_bps;
+    uint32_t extra_allocation = bitrate / num_observers;
+    uint32_t total_allocation = extra_allocation + (*allocation)[track];
     bitrate -= extra_allocation;
-    if (total_allocation > max_multiplier * it->first) {
+    if (total_allocation > max_multiplier * max_bitrate_bps) {
       // There is more than we can fit for this observer, carry over to the
       // remaining observers.
-      bitrate += total_allocation - max_multiplier * it->first;
-      total_allocation = max_multiplier * it->first;
+      bitrate += total_allocation - max_multiplier * max_bitrate_bps;
+      total_allocation = max_multiplier * max_bitrate_bps;
     }
     // Finally, update the allocation for this observer.
-    allocation->at(it->second->observer) = total_allocation;
-    it = list_max_bitrates.erase(it);
+    (*allocation)[track] = total_allocation;
+    --num_observers;
   }
 }
 
@@ -118,26 +127,23 @@ void DistributeBitrateEvenly(
 void DistributeBitrateRelatively(
     const std::vector<AllocatableTrack>& allocatable_tracks,
     uint32_t remaining_bitrate,
-    const std::map<BitrateAllocatorObserver*, int>& observers_capacities,
-    std::map<BitrateAllocatorObserver*, int>* allocation) {
+    const Allocation& observers_capacities,
+    AllocationOrders& orders,
+    Allocation* allocation) {
   RTC_DCHECK_EQ(allocation->size(), allocatable_tracks.size());
   RTC_DCHECK_EQ(observers_capacities.size(), allocatable_tracks.size());
-
-  struct PriorityRateObserverConfig {
-    BitrateAllocatorObserver* allocation_key;
-    // The amount of bitrate bps that can be allocated to this observer.
-    int capacity_bps;
-    double bitrate_priority;
-  };
+  RTC_DCHECK_EQ(orders.without_priority_bitrate.size() +
+                    orders.with_priority_bitrate.size(),
+                allocatable_tracks.size());
 
   double bitrate_priority_sum = 0;
-  std::vector<PriorityRateObserverConfig> priority_rate_observers;
-  for (const auto& observer_config : allocatable_tracks) {
-    priority_rate_observers.push_back(PriorityRateObserverConfig{
-        observer_config.observer,
-        observers_capacities.at(observer_config.observer),
-        observer_config.config.bitrate_priority});
-    bitrate_priority_sum += observer_config.config.bitrate_priority;
+  std::vector<double> relative_capacities(allocatable_tracks.size());
+  for (size_t track = 0; track < allocatable_tracks.size(); ++track) {
+    const double bitrate_priority =
+        allocatable_tracks[track].config.bitrate_priority;
+    relative_capacities[track] =
+        observers_capacities[track] / bitrate_priority;
+    bitrate_priority_sum += bitrate_priority;
   }
 
   // Iterate in the order observers can be allocated their full capacity.
@@ -148,69 +154,85 @@ void DistributeBitrateRelatively(
   // filled. This is because the amount allocated is based upon bitrate
   // priority. We allocate twice as much bitrate to an observer with twice the
   // bitrate priority of another.
-  absl::c_sort(priority_rate_observers, [](const auto& a, const auto& b) {
-    return a.capacity_bps / a.bitrate_priority <
-           b.capacity_bps / b.bitrate_priority;
-  });
+  //
+  // Only the capacities of observers with a priority bitrate depend on the
+  // estimate, so only they are sorted here.
+  auto by_relative_capacity = [&](size_t a, size_t b) {
+    return relative_capacities[a] < relative_capacities[b];
+  };
+  if (!absl::c_is_sorted(orders.with_priority_bitrate, by_relative_capacity))
+    absl::c_sort(orders.with_priority_bitrate, by_relative_capacity);
+  std::vector<size_t>& order = orders.by_relative_capacity;
+  order.clear();
+  std::merge(orders.without_priority_bitrate.begin(),
+             orders.without_priority_bitrate.end(),
+             orders.with_priority_bitrate.begin(),
+             orders.with_priority_bitrate.end(), std::back_inserter(order),
+             by_relative_capacity);
+  RTC_DCHECK(absl::c_is_sorted(order, by_relative_capacity));
+
   size_t i;
-  for (i = 0; i < priority_rate_observers.size(); ++i) {
-    const auto& priority_rate_observer = priority_rate_observers[i];
+  for (i = 0; i < order.size(); ++i) {
+    const size_t track = order[i];
+    const double bitrate_priority =
+        allocatable_tracks[track].config.bitrate_priority;
     // We allocate the full capacity to an observer only if its relative
     // portion from the remaining bitrate is sufficient to allocate its full
     // capacity. This means we aren't greedily allocating the full capacity, but
     // that it is only done when there is also enough bitrate to allocate the
     // proportional amounts to all other observers.
-    double observer_share =
-        priority_rate_observer.bitrate_priority / bitrate_priority_sum;
+    double observer_share = bitrate_priority / bitrate_priority_sum;
     double allocation_bps = observer_share * remaining_bitrate;
-    bool enough_bitrate = allocation_bps >= priority_rate_observer.capacity_bps;
+    bool enough_bitrate = allocation_bps >= observers_capacities[track];
     if (!enough_bitrate)
       break;
-    allocation->at(priority_rate_observer.allocation_key) +=
-        priority_rate_observer.capacity_bps;
-    remaining_bitrate -= priority_rate_observer.capacity_bps;
-    bitrate_priority_sum -= priority_rate_observer.bitrate_priority;
+    (*allocation)[track] += observers_capacities[track];
+    remaining_bitrate -= observers_capacities[track];
+    bitrate_priority_sum -= bitrate_priority;
   }
 
   // From the remaining bitrate, allocate the proportional amounts to the
   // observers that aren't allocated their max capacity.
-  for (; i < priority_rate_observers.size(); ++i) {
-    const auto& priority_rate_observer = priority_rate_observers[i];
+  for (; i < order.size(); ++i) {
+    const size_t track = order[i];
     double fraction_allocated =
-        priority_rate_observer.bitrate_priority / bitrate_priority_sum;
-    allocation->at(priority_rate_observer.allocation_key) +=
-        fraction_allocated * remaining_bitrate;
+        allocatable_tracks[track].config.bitrate_priority /
+        bitrate_priority_sum;
+    (*allocation)[track] += fraction_allocated * remaining_bitrate;
   }
 }
 
 // Allocates bitrate to observers when there isn't enough to allocate the
 // minimum to all observers.
-std::map<BitrateAllocatorObserver*, int> LowRateAllocation(
+Allocation LowRateAllocation(
     const std::vector<AllocatableTrack>& allocatable_tracks,
+    const AllocationOrders& orders,
     uint32_t bitrate) {
-  std::map<BitrateAllocatorObserver*, int> allocation;
+  Allocation allocation(allocatable_tracks.size());
   // Start by allocating bitrate to observers enforcing a min bitrate, hence
   // remaining_bitrate might turn negative.
   int64_t remaining_bitrate = bitrate;
-  for (const auto& observer_config : allocatable_tracks) {
+  for (size_t track = 0; track < allocatable_tracks.size(); ++track) {
+    const AllocatableTrack& observer_config = allocatable_tracks[track];
     int32_t allocated_bitrate = 0;
     if (observer_config.config.enforce_min_bitrate)
       allocated_bitrate = observer_config.config.min_bitrate_bps;
 
-    allocation[observer_config.observer] = allocated_bitrate;
+    allocation[track] = allocated_bitrate;
     remaining_bitrate -= allocated_bitrate;
   }
 
   // Allocate bitrate to all previously active streams.
   if (remaining_bitrate > 0) {
-    for (const auto& observer_config : allocatable_tracks) {
+    for (size_t track = 0; track < allocatable_tracks.size(); ++track) {
+      const AllocatableTrack& observer_config = allocatable_tracks[track];
       if (observer_config.config.enforce_min_bitrate ||
           observer_config.LastAllocatedBitrate() == 0)
         continue;
 
       uint32_t required_bitrate = observer_config.MinBitrateWithHysteresis();
       if (remaining_bitrate >= required_bitrate) {
-        allocation[observer_config.observer] = required_bitrate;
+        allocation[track] = required_bitrate;
         remaining_bitrate -= required_bitrate;
       }
     }
@@ -218,14 +240,15 @@ std::map<BitrateAllocatorObserver*, int> LowRateAllocation(
 
   // Allocate bitrate to previously paused streams.
   if (remaining_bitrate > 0) {
-    for (const auto& observer_config : allocatable_tracks) {
+    for (size_t track = 0; track < allocatable_tracks.size(); ++track) {
+      const AllocatableTrack& observer_config = allocatable_tracks[track];
       if (observer_config.LastAllocatedBitrate() != 0)
         continue;
 
       // Add a hysteresis to avoid toggling.
       uint32_t required_bitrate = observer_config.MinBitrateWithHysteresis();
       if (remaining_bitrate >= required_bitrate) {
-        allocation[observer_config.observer] = required_bitrate;
+        allocation[track] = required_bitrate;
         remaining_bitrate -= required_bitrate;
       }
     }
@@ -233,10 +256,9 @@ std::map<BitrateAllocatorObserver*, int> LowRateAllocation(
 
   // Split a possible remainder evenly on all streams with an allocation.
   if (remaining_bitrate > 0)
-    DistributeBitrateEvenly(allocatable_tracks, remaining_bitrate, false, 1,
-                            &allocation);
+    DistributeBitrateEvenly(allocatable_tracks, orders, remaining_bitrate,
+                            false, 1, &allocation);
 
-  RTC_DCHECK_EQ(allocation.size(), allocatable_tracks.size());
   return allocation;
 }
 
@@ -251,32 +273,32 @@ std::map<BitrateAllocatorObserver*, int> LowRateAllocation(
 // bitrate_priority = 2.0, the expected behavior is that observer 2 will be
 // allocated twice the bitrate as observer 1 above the each observer's
 // min_bitrate_bps values, until one of the observers hits its max_bitrate_bps.
-std::map<BitrateAllocatorObserver*, int> NormalRateAllocation(
+Allocation NormalRateAllocation(
     const std::vector<AllocatableTrack>& allocatable_tracks,
+    AllocationOrders& orders,
     uint32_t bitrate,
     uint32_t sum_min_bitrates) {
-  std::map<BitrateAllocatorObserver*, int> allocation;
-  std::map<BitrateAllocatorObserver*, int> observers_capacities;
-  for (const auto& observer_config : allocatable_tracks) {
-    allocation[observer_config.observer] =
-        observer_config.config.min_bitrate_bps;
-    observers_capacities[observer_config.observer] =
-        observer_config.config.max_bitrate_bps -
-        observer_config.config.min_bitrate_bps;
+  Allocation allocation(allocatable_tracks.size());
+  Allocation observers_capacities(allocatable_tracks.size());
+  for (size_t track = 0; track < allocatable_tracks.size(); ++track) {
+    const AllocatableTrack& observer_config = allocatable_tracks[track];
+    allocation[track] = observer_config.config.min_bitrate_bps;
+    observers_capacities[track] = observer_config.config.max_bitrate_bps -
+                                  observer_config.config.min_bitrate_bps;
   }
 
   bitrate -= sum_min_bitrates;
 
   // TODO(srte): Implement fair sharing between prioritized streams, currently
   // they are treated on a first come first serve basis.
-  for (const auto& observer_config : allocatable_tracks) {
-    int64_t priority_margin = observer_config.config.priority_bitrate_bps -
-                              allocation[observer_config.observer];
+  for (size_t track = 0; track < allocatable_tracks.size(); ++track) {
+    int64_t priority_margin =
+        allocatable_tracks[track].config.priority_bitrate_bps -
+        allocation[track];
     if (priority_margin > 0 && bitrate > 0) {
       int64_t extra_bitrate = std::min<int64_t>(priority_margin, bitrate);
-      allocation[observer_config.observer] +=
-          rtc::dchecked_cast<int>(extra_bitrate);
-      observers_capacities[observer_config.observer] -= extra_bitrate;
+      allocation[track] += rtc::dchecked_cast<int>(extra_bitrate);
+      observers_capacities[track] -= extra_bitrate;
       bitrate -= extra_bitrate;
     }
   }
@@ -285,46 +307,40 @@ std::map<BitrateAllocatorObserver*, int> NormalRateAllocation(
   // above the min bitrate already allocated.
   if (bitrate > 0)
     DistributeBitrateRelatively(allocatable_tracks, bitrate,
-                                observers_capacities, &allocation);
+                                observers_capacities, orders, &allocation);
 
   return allocation;
 }
 
 // Allocates bitrate to observers when there is enough available bandwidth
 // for all observers to be allocated their max bitrate.
-std::map<BitrateAllocatorObserver*, int> MaxRateAllocation(
+Allocation MaxRateAllocation(
     const std::vector<AllocatableTrack>& allocatable_tracks,
+    const AllocationOrders& orders,
     uint32_t bitrate,
     uint32_t sum_max_bitrates) {
-  std::map<BitrateAllocatorObserver*, int> allocation;
+  Allocation allocation(allocatable_tracks.size());
 
-  for (const auto& observer_config : allocatable_tracks) {
-    allocation[observer_config.observer] =
-        observer_config.config.max_bitrate_bps;
-    bitrate -= observer_config.config.max_bitrate_bps;
+  for (size_t track = 0; track < allocatable_tracks.size(); ++track) {
+    allocation[track] = allocatable_tracks[track].config.max_bitrate_bps;
+    bitrate -= allocatable_tracks[track].config.max_bitrate_bps;
   }
-  DistributeBitrateEvenly(allocatable_tracks, bitrate, true,
+  DistributeBitrateEvenly(allocatable_tracks, orders, bitrate, true,
                           kTransmissionMaxBitrateMultiplier, &allocation);
   return allocation;
 }
 
-// Allocates zero bitrate to all observers.
-std::map<BitrateAllocatorObserver*, int> ZeroRateAllocation(
-    const std::vector<AllocatableTrack>& allocatable_tracks) {
-  std::map<BitrateAllocatorObserver*, int> allocation;
-  for (const auto& observer_config : allocatable_tracks)
-    allocation[observer_config.observer] = 0;
-  return allocation;
-}
-
-std::map<BitrateAllocatorObserver*, int> AllocateBitrates(
+// Returns the bitrate of each of `allocatable_tracks`, in the same order.
+Allocation AllocateBitrates(
     const std::vector<AllocatableTrack>& allocatable_tracks,
+    AllocationOrders& orders,
     uint32_t bitrate) {
   if (allocatable_tracks.empty())
-    return std::map<BitrateAllocatorObserver*, int>();
+    return Allocation();
 
+  // Allocates zero bitrate to all observers.
   if (bitrate == 0)
-    return ZeroRateAllocation(allocatable_tracks);
+    return Allocation(allocatable_tracks.size(), 0);
 
   uint32_t sum_min_bitrates = 0;
   uint32_t sum_max_bitrates = 0;
@@ -338,15 +354,17 @@ std::map<BitrateAllocatorObserver*, int> AllocateBitrates(
   // streams.
   if (!EnoughBitrateForAllObservers(allocatable_tracks, bitrate,
                                     sum_min_bitrates))
-    return LowRateAllocation(allocatable_tracks, bitrate);
+    return LowRateAllocation(allocatable_tracks, orders, bitrate);
 
   // All observers will get their min bitrate plus a share of the rest. This
   // share is allocated to each observer based on its bitrate_priority.
   if (bitrate <= sum_max_bitrates)
-    return NormalRateAllocation(allocatable_tracks, bitrate, sum_min_bitrates);
+    return NormalRateAllocation(allocatable_tracks, orders, bitrate,
+                                sum_min_bitrates);
 
   // All observers will get up to transmission_max_bitrate_multiplier_ x max.
-  return MaxRateAllocation(allocatable_tracks, bitrate, sum_max_bitrates);
+  return MaxRateAllocation(allocatable_tracks, orders, bitrate,
+                           sum_max_bitrates);
 }
 
 }  // namespace
@@ -394,14 +412,18 @@ void BitrateAllocator::OnNetworkEstimateChanged(TargetTransferRate msg) {
     last_bwe_log_time_ = now;
   }
 
-  auto allocation = AllocateBitrates(allocatable_tracks_, last_target_bps_);
-  auto stable_bitrate_allocation =
-      AllocateBitrates(allocatable_tracks_, last_stable_target_bps_);
-
-  for (auto& config : allocatable_tracks_) {
-    uint32_t allocated_bitrate = allocation[config.observer];
-    uint32_t allocated_stable_target_rate =
-        stable_bitrate_allocation[config.observer];
+  Allocation allocation = AllocateBitrates(
+      allocatable_tracks_, allocation_orders_, last_target_bps_);
+  Allocation stable_bitrate_allocation =
+      last_stable_target_bps_ == last_target_bps_
+          ? allocation
+          : AllocateBitrates(allocatable_tracks_, allocation_orders_,
+                             last_stable_target_bps_);
+
+  for (size_t track = 0; track < allocatable_tracks_.size(); ++track) {
+    AllocatableTrack& config = allocatable_tracks_[track];
+    uint32_t allocated_bitrate = allocation[track];
+    uint32_t allocated_stable_target_rate = stable_bitrate_allocation[track];
     BitrateAllocationUpdate update;
     update.target_bitrate = DataRate::BitsPerSec(allocated_bitrate);
     update.stable_target_bitrate =
@@ -457,17 +479,22 @@ void BitrateAllocator::AddObserver(BitrateAllocatorObserver* observer,
   } else {
     allocatable_tracks_.push_back(AllocatableTrack(observer, config));
   }
+  UpdateAllocationOrders();
 
   if (last_target_bps_ > 0) {
     // Calculate a new allocation and update all observers.
 
-    auto allocation = AllocateBitrates(allocatable_tracks_, last_target_bps_);
-    auto stable_bitrate_allocation =
-        AllocateBitrates(allocatable_tracks_, last_stable_target_bps_);
-    for (auto& config : allocatable_tracks_) {
-      uint32_t allocated_bitrate = allocation[config.observer];
-      uint32_t allocated_stable_bitrate =
-          stable_bitrate_allocation[config.observer];
+    Allocation allocation = AllocateBitrates(
+        allocatable_tracks_, allocation_orders_, last_target_bps_);
+    Allocation stable_bitrate_allocation =
+        last_stable_target_bps_ == last_target_bps_
+            ? allocation
+            : AllocateBitrates(allocatable_tracks_, allocation_orders_,
+                               last_stable_target_bps_);
+    for (size_t track = 0; track < allocatable_tracks_.size(); ++track) {
+      AllocatableTrack& config = allocatable_tracks_[track];
+      uint32_t allocated_bitrate = allocation[track];
+      uint32_t allocated_stable_bitrate = stable_bitrate_allocation[track];
       BitrateAllocationUpdate update;
       update.target_bitrate = DataRate::BitsPerSec(allocated_bitrate);
       update.stable_target_bitrate =
@@ -496,6 +523,42 @@ void BitrateAllocator::AddObserver(BitrateAllocatorObserver* observer,
   UpdateAllocationLimits();
 }
 
+void BitrateAllocator::UpdateAllocationOrders() {
+  const size_t num_tracks = allocatable_tracks_.size();
+  // Observers with the same max bitrate stay in the order they were added.
+  std::vector<size_t>& by_max_bitrate = allocation_orders_.by_max_bitrate;
+  by_max_bitrate.resize(num_tracks);
+  std::iota(by_max_bitrate.begin(), by_max_bitrate.end(), 0);
+  absl::c_stable_sort(by_max_bitrate, [&](size_t a, size_t b) {
+    return allocatable_tracks_[a].config.max_bitrate_bps <
+           allocatable_tracks_[b].config.max_bitrate_bps;
+  });
+  // Without a priority bitrate above the min bitrate, the capacity is the
+  // same in every allocation, see NormalRateAllocation().
+  std::vector<size_t>& without_priority_bitrate =
+      allocation_orders_.without_priority_bitrate;
+  std::vector<size_t>& with_priority_bitrate =
+      allocation_orders_.with_priority_bitrate;
+  without_priority_bitrate.clear();
+  with_priority_bitrate.clear();
+  std::vector<double> relative_capacities(num_tracks);
+  for (size_t track = 0; track < num_tracks; ++track) {
+    const MediaStreamAllocationConfig& config =
+        allocatable_tracks_[track].config;
+    if (config.priority_bitrate_bps > config.min_bitrate_bps) {
+      with_priority_bitrate.push_back(track);
+      continue;
+    }
+    const int capacity = config.max_bitrate_bps - config.min_bitrate_bps;
+    relative_capacities[track] = capacity / config.bitrate_priority;
+    without_priority_bitrate.push_back(track);
+  }
+  absl::c_sort(without_priority_bitrate, [&](size_t a, size_t b) {
+    return relative_capacities[a] < relative_capacities[b];
+  });
+  allocation_orders_.by_relative_capacity.reserve(num_tracks);
+}
+
 void BitrateAllocator::UpdateAllocationLimits() {
   BitrateAllocationLimits limits;
   for (const auto& config : allocatable_tracks_) {
@@ -538,6 +601,7 @@ void BitrateAllocator::RemoveObserver(BitrateAllocatorObserver* observer) {
       break;
     }
   }
+  UpdateAllocationOrders();
 
   UpdateAllocationLimits();
 }
@@ -93,6 +93,23 @@ struct AllocatableTrack {
   // enable-hysteresis if the observer is in a paused state.
   uint32_t MinBitrateWithHysteresis() const;
 };
+
+// Orders in which the allocation visits the tracks, as indices into the
+// tracks. They are kept between allocations so that they don't have to be
+// sorted again for every estimate.
+struct AllocationOrders {
+  // By max bitrate, then by the order the tracks were added.
+  std::vector<size_t> by_max_bitrate;
+  // The tracks by the bitrate that can be allocated above the min and
+  // priority bitrates, relative to the bitrate priority, in two tiers. The
+  // capacity of tracks without a priority bitrate above their min bitrate
+  // doesn't depend on the estimate, so they are only sorted when the tracks
+  // change. The other tracks are sorted on use, and merged with the first
+  // ones into `by_relative_capacity`.
+  std::vector<size_t> without_priority_bitrate;
+  std::vector<size_t> with_priority_bitrate;
+  std::vector<size_t> by_relative_capacity;
+};
 }  // namespace bitrate_allocator_impl
 
 // Usage: this class will register multiple RtcpBitrateObserver's one at each
@@ -143,6 +160,10 @@ class BitrateAllocator : public BitrateAllocatorInterface {
   // calls LimitObserver::OnAllocationLimitsChanged.
   void UpdateAllocationLimits() RTC_RUN_ON(&sequenced_checker_);
 
+  // Sorts `allocation_orders_` after tracks have been added, removed or
+  // reconfigured.
+  void UpdateAllocationOrders() RTC_RUN_ON(&sequenced_checker_);
+
   // Allow packets to be transmitted in up to 2 times max video bitrate if the
   // bandwidth estimate allows it.
   // TODO(bugs.webrtc.org/8541): May be worth to refactor to keep this logic in
@@ -154,6 +175,8 @@ class BitrateAllocator : public BitrateAllocatorInterface {
   // Stored in a list to keep track of the insertion order.
   std::vector<AllocatableTrack> allocatable_tracks_
       RTC_GUARDED_BY(&sequenced_checker_);
+  bitrate_allocator_impl::AllocationOrders allocation_orders_
+      RTC_GUARDED_BY(&sequenced_checker_);
   uint32_t last_target_bps_ RTC_GUARDED_BY(&sequenced_checker_);
   uint32_t last_stable_target_bps_ RTC_GUARDED_BY(&sequenced_checker_);
   uint32_t last_non_zero_bitrate_bps_ RTC_GUARDED_BY(&sequenced_checker_);
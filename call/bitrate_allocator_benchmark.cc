@@ -0,0 +1,120 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "api/call/bitrate_allocation.h"
+#include "api/transport/network_types.h"
+#include "api/units/data_rate.h"
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "benchmark/benchmark.h"
+#include "call/bitrate_allocator.h"
+#include "rtc_base/system/unused.h"
+
+namespace webrtc {
+namespace {
+
+// Many streams of a process sharing one estimate, updated 20 times per second.
+// The streams are a mix of audio and simulcast layers, some of them with
+// priority bitrates, and the estimates sweep from below the sum of the min
+// bitrates to above the sum of the max bitrates.
+constexpr int kNumObservers = 2000;
+constexpr int kUpdatesPerSecond = 20;
+constexpr TimeDelta kUpdateInterval = TimeDelta::Seconds(1) / kUpdatesPerSecond;
+
+class NullLimitObserver : public BitrateAllocator::LimitObserver {
+ public:
+  void OnAllocationLimitsChanged(BitrateAllocationLimits limits) override {}
+};
+
+class NullBitrateObserver : public BitrateAllocatorObserver {
+ public:
+  uint32_t OnBitrateUpdated(BitrateAllocationUpdate update) override {
+    return 0;
+  }
+};
+
+MediaStreamAllocationConfig CreateConfig(int observer) {
+  MediaStreamAllocationConfig config;
+  switch (observer % 4) {
+    case 0:  // Audio.
+      config.min_bitrate_bps = 16000;
+      config.max_bitrate_bps = 64000;
+      config.enforce_min_bitrate = true;
+      config.bitrate_priority = 1.0;
+      break;
+    case 1:  // Low simulcast layer.
+      config.min_bitrate_bps = 30000;
+      config.max_bitrate_bps = 150000;
+      config.enforce_min_bitrate = false;
+      config.bitrate_priority = 1.0;
+      break;
+    case 2:  // Middle simulcast layer.
+      config.min_bitrate_bps = 150000;
+      config.max_bitrate_bps = 500000;
+      config.enforce_min_bitrate = false;
+      config.bitrate_priority = 2.0;
+      break;
+    default:  // Screen share with a priority bitrate.
+      config.min_bitrate_bps = 50000;
+      config.max_bitrate_bps = 2500000;
+      config.enforce_min_bitrate = false;
+      config.bitrate_priority = 4.0;
+      break;
+  }
+  config.pad_up_bitrate_bps = 0;
+  config.priority_bitrate_bps =
+      observer % 4 == 3 ? config.min_bitrate_bps * 4 : 0;
+  return config;
+}
+
+// One second of estimates, where the stable estimate trails the target.
+std::vector<TargetTransferRate> CreateEstimates() {
+  constexpr DataRate kLowestRate = DataRate::KilobitsPerSec(100000);
+  constexpr DataRate kRateStep = DataRate::KilobitsPerSec(160000);
+  std::vector<TargetTransferRate> estimates(kUpdatesPerSecond);
+  for (int i = 0; i < kUpdatesPerSecond; ++i) {
+    const int step = i < kUpdatesPerSecond / 2 ? i : kUpdatesPerSecond - i;
+    estimates[i].target_rate = kLowestRate + kRateStep * step;
+    estimates[i].stable_target_rate =
+        kLowestRate + kRateStep * (step > 0 ? step - 1 : 0);
+    estimates[i].network_estimate.round_trip_time = TimeDelta::Millis(50);
+    estimates[i].network_estimate.bwe_period = TimeDelta::Seconds(3);
+  }
+  return estimates;
+}
+
+void BM_BitrateAllocatorEstimateChanged(benchmark::State& state) {
+  NullLimitObserver limit_observer;
+  BitrateAllocator allocator(&limit_observer);
+  std::vector<NullBitrateObserver> observers(kNumObservers);
+  for (int i = 0; i < kNumObservers; ++i) {
+    allocator.AddObserver(&observers[i], CreateConfig(i));
+  }
+  std::vector<TargetTransferRate> estimates = CreateEstimates();
+  Timestamp now = Timestamp::Seconds(1);
+  int64_t update = 0;
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    TargetTransferRate& estimate = estimates[update++ % kUpdatesPerSecond];
+    now += kUpdateInterval;
+    estimate.at_time = now;
+    allocator.OnNetworkEstimateChanged(estimate);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_BitrateAllocatorEstimateChanged);
+
+}  // namespace
+}  // namespace webrtc
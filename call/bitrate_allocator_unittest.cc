@@ -216,6 +216,22 @@ TEST_F(BitrateAllocatorTest, UpdatingBitrateObserver) {
   EXPECT_EQ(1500000u, bitrate_observer.last_bitrate_bps_);
 }
 
+TEST_F(BitrateAllocatorTest, DistributesExtraBitrateByUpdatedMaxBitrates) {
+  TestBitrateObserver stream_a;
+  TestBitrateObserver stream_b;
+  AddObserver(&stream_a, 0, 100000, 0, true, kDefaultBitratePriority);
+  AddObserver(&stream_b, 0, 1000000, 0, true, kDefaultBitratePriority);
+  // Swap the max bitrates, so that `stream_b` now reaches twice its max
+  // bitrate first and its excess carries over to `stream_a`.
+  AddObserver(&stream_a, 0, 1000000, 0, true, kDefaultBitratePriority);
+  AddObserver(&stream_b, 0, 100000, 0, true, kDefaultBitratePriority);
+
+  allocator_->OnNetworkEstimateChanged(
+      CreateTargetRateMessage(1500000, 0, 0, kDefaultProbingIntervalMs));
+  EXPECT_EQ(200000u, stream_b.last_bitrate_bps_);
+  EXPECT_EQ(1300000u, stream_a.last_bitrate_bps_);
+}
+
 TEST_F(BitrateAllocatorTest, TwoBitrateObserversOneRtcpObserver) {
   TestBitrateObserver bitrate_observer_1;
   TestBitrateObserver bitrate_observer_2;
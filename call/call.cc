@@ -67,6 +67,8 @@
 #include "system_wrappers/include/cpu_info.h"
 #include "system_wrappers/include/metrics.h"
 #include "video/call_stats2.h"
+#include "video/decode_synchronizer.h"
+#include "video/decode_worker_pool.h"
 #include "video/send_delay_stats.h"
 #include "video/stats_counter.h"
 #include "video/video_receive_stream2.h"
@@ -133,6 +135,26 @@ TaskQueueBase* GetCurrentTaskQueueOrThread() {
   return current;
 }
 
+std::unique_ptr<DecodeSynchronizer> CreateDecodeSynchronizer(
+    Clock* clock,
+    Metronome* metronome,
+    TaskQueueBase* worker_thread,
+    TaskQueueFactory* task_queue_factory,
+    const FieldTrialsView& trials) {
+  if (!metronome) {
+    return nullptr;
+  }
+  // The synchronized receive streams decode on one shared worker per core,
+  // instead of on a task queue per stream.
+  std::unique_ptr<DecodeWorkerPool> decode_worker_pool;
+  if (trials.IsEnabled("WebRTC-DecodeWorkerPool")) {
+    decode_worker_pool = std::make_unique<DecodeWorkerPool>(
+        task_queue_factory, CpuInfo::DetectNumberOfCores());
+  }
+  return std::make_unique<DecodeSynchronizer>(
+      clock, metronome, worker_thread, std::move(decode_worker_pool));
+}
+
 }  // namespace
 
 namespace internal {
@@ -668,11 +690,11 @@ Call::Call(Clock* clock,
       // must be made on `worker_thread_` (i.e. they're one and the same).
       network_thread_(config.network_task_queue_ ? config.network_task_queue_
                                                  : worker_thread_),
-      decode_sync_(config.metronome
-                       ? std::make_unique<DecodeSynchronizer>(clock_,
-                                                              config.metronome,
-                                                              worker_thread_)
-                       : nullptr),
+      decode_sync_(CreateDecodeSynchronizer(clock_,
+                                            config.metronome,
+                                            worker_thread_,
+                                            task_queue_factory_,
+                                            *config.trials)),
       num_cpu_cores_(CpuInfo::DetectNumberOfCores()),
       call_stats_(new CallStats(clock_, worker_thread_)),
       bitrate_allocator_(new BitrateAllocator(this)),
@@ -709,6 +731,9 @@ Call::Call(Clock* clock,
   // WebRTC source timestamp string needs to be in the final binary.
   LoadWebRTCVersionInRegister();
 
+  if (trials_.IsEnabled("WebRTC-RFC8888CongestionControlFeedback")) {
+    receive_side_cc_.EnableSendCongestionControlFeedbackAccordingToRfc8888();
+  }
   call_stats_->RegisterStatsObserver(&receive_side_cc_);
 
   ReceiveSideCongestionController* receive_side_cc = &receive_side_cc_;
@@ -1014,7 +1039,7 @@ webrtc::VideoReceiveStreamInterface* Call::CreateVideoReceiveStream(
   // TODO(crbug.com/1381982): Re-enable decode synchronizer once the Chromium
   // API has adapted to the new Metronome interface.
   VideoReceiveStream2* receive_stream = new VideoReceiveStream2(
-      task_queue_factory_, this, num_cpu_cores_,
+      task_queue_factory_, this, num_cpu_cores_, config_.decoder_core_budget,
       transport_send_->packet_router(), std::move(configuration),
       call_stats_.get(), clock_, std::make_unique<VCMTiming>(clock_, trials()),
       &nack_periodic_processor_, decode_sync_.get(), event_log_);
@@ -19,6 +19,7 @@
 #include "api/task_queue/task_queue_factory.h"
 #include "api/transport/bitrate_settings.h"
 #include "api/transport/network_control.h"
+#include "api/video_codecs/decoder_core_budget.h"
 #include "call/audio_state.h"
 #include "call/rtp_transport_config.h"
 #include "call/rtp_transport_controller_send_factory_interface.h"
@@ -27,6 +28,7 @@ namespace webrtc {
 
 class AudioProcessing;
 class RtcEventLog;
+class SharedPacer;
 
 struct CallConfig {
   // If `network_task_queue` is set to nullptr, Call will assume that network
@@ -82,8 +84,16 @@ struct CallConfig {
   // The burst interval of the pacer, see TaskQueuePacedSender constructor.
   absl::optional<TimeDelta> pacer_burst_interval;
 
+  // Schedules the pacer along with the pacers of other calls that run on the
+  // same task queue, see SharedPacer.
+  SharedPacer* shared_pacer = nullptr;
+
   // Enables send packet batching from the egress RTP sender.
   bool enable_send_packet_batching = false;
+
+  // Caps the threads that the video decoders of all receive streams use
+  // together. May be shared with other calls, see DecoderCoreBudget.
+  rtc::scoped_refptr<DecoderCoreBudget> decoder_core_budget;
 };
 
 }  // namespace webrtc
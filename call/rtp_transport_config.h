@@ -22,6 +22,8 @@
 
 namespace webrtc {
 
+class SharedPacer;
+
 struct RtpTransportConfig {
   // Bitrate config used until valid bitrate estimates are calculated. Also
   // used to cap total bitrate used. This comes from the remote connection.
@@ -47,6 +49,10 @@ struct RtpTransportConfig {
 
   // The burst interval of the pacer, see TaskQueuePacedSender constructor.
   absl::optional<TimeDelta> pacer_burst_interval;
+
+  // If set, the pacer is scheduled along with the pacers of other transports
+  // that run on the same task queue, see SharedPacer.
+  SharedPacer* shared_pacer = nullptr;
 };
 }  // namespace webrtc
 
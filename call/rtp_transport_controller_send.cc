@@ -9,6 +9,7 @@
  */
 #include "call/rtp_transport_controller_send.h"
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -26,6 +27,7 @@
 #include "call/rtp_video_sender.h"
 #include "logging/rtc_event_log/events/rtc_event_remote_estimate.h"
 #include "logging/rtc_event_log/events/rtc_event_route_change.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/congestion_control_feedback.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
@@ -85,7 +87,8 @@ RtpTransportControllerSend::RtpTransportControllerSend(
              *config.trials,
              TimeDelta::Millis(5),
              3,
-             config.pacer_burst_interval),
+             config.pacer_burst_interval,
+             config.shared_pacer),
       observer_(nullptr),
       controller_factory_override_(config.network_controller_factory),
       controller_factory_fallback_(
@@ -99,23 +102,32 @@ RtpTransportControllerSend::RtpTransportControllerSend(
           IsEnabled(*config.trials,
                     "WebRTC-AddPacingToCongestionWindowPushback")),
       relay_bandwidth_cap_("relay_cap", DataRate::PlusInfinity()),
+      secondary_route_share_("share", 0.2),
       transport_overhead_bytes_per_packet_(0),
       network_available_(false),
       congestion_window_size_(DataSize::PlusInfinity()),
+      pacing_rate_(
+          DataRate::BitsPerSec(config.bitrate_config.start_bitrate_bps)),
+      padding_rate_(DataRate::Zero()),
+      secondary_route_connected_(false),
       is_congested_(false),
       retransmission_rate_limiter_(clock, kRetransmitWindowSizeMs),
       field_trials_(*config.trials) {
   ParseFieldTrial({&relay_bandwidth_cap_},
                   config.trials->Lookup("WebRTC-Bwe-NetworkRouteConstraints"));
+  ParseFieldTrial({&secondary_route_share_},
+                  config.trials->Lookup("WebRTC-Pacer-SecondaryRoute"));
   initial_config_.constraints =
       ConvertConstraints(config.bitrate_config, clock_);
   initial_config_.event_log = config.event_log;
   initial_config_.key_value_config = config.trials;
   RTC_DCHECK(config.bitrate_config.start_bitrate_bps > 0);
+  if (IsEnabled(*config.trials, "WebRTC-RFC8888CongestionControlFeedback")) {
+    transport_feedback_adapter_
+        .EnableCongestionControlFeedbackAccordingToRfc8888();
+  }
 
-  pacer_.SetPacingRates(
-      DataRate::BitsPerSec(config.bitrate_config.start_bitrate_bps),
-      DataRate::Zero());
+  pacer_.SetPacingRates(pacing_rate_, padding_rate_);
 }
 
 RtpTransportControllerSend::~RtpTransportControllerSend() {
@@ -283,6 +295,7 @@ void RtpTransportControllerSend::OnNetworkRouteChanged(
       RTC_LOG(LS_INFO) << "old_route = " << kv->second.DebugString();
     }
   }
+  UpdateSecondaryRoute(network_route);
 
   if (inserted) {
     if (relay_constraint_update.has_value()) {
@@ -327,6 +340,39 @@ void RtpTransportControllerSend::OnNetworkRouteChanged(
     pacer_.SetCongested(false);
   }
 }
+void RtpTransportControllerSend::UpdateSecondaryRoute(
+    const rtc::NetworkRoute& network_route) {
+  if (network_route.secondary_connected) {
+    // Packets sent on the secondary route are in flight on that route, not on
+    // the one that the network controller estimates.
+    rtc::NetworkRoute secondary_route;
+    secondary_route.connected = true;
+    secondary_route.local = network_route.secondary_local;
+    secondary_route.remote = network_route.secondary_remote;
+    transport_feedback_adapter_.SetSecondaryNetworkRoute(secondary_route);
+  }
+  if (network_route.secondary_connected == secondary_route_connected_) {
+    return;
+  }
+  RTC_LOG(LS_INFO) << "Secondary route "
+                   << (network_route.secondary_connected ? "connected"
+                                                         : "disconnected");
+  secondary_route_connected_ = network_route.secondary_connected;
+  UpdatePacingRates();
+}
+
+void RtpTransportControllerSend::UpdatePacingRates() {
+  // The secondary route gets a share of the pacing rate, rather than a rate
+  // on top of the estimate, so that the total rate stays within the estimate.
+  DataRate secondary_rate = DataRate::Zero();
+  if (secondary_route_connected_) {
+    secondary_rate =
+        pacing_rate_ * std::clamp(secondary_route_share_.Get(), 0.0, 1.0);
+  }
+  pacer_.SetPacingRates(pacing_rate_ - secondary_rate, padding_rate_);
+  pacer_.SetSecondaryRoutePacingRate(secondary_rate);
+}
+
 void RtpTransportControllerSend::OnNetworkAvailability(bool network_available) {
   RTC_DCHECK_RUN_ON(&sequence_checker_);
   RTC_LOG(LS_VERBOSE) << "SignalNetworkState "
@@ -555,6 +601,22 @@ void RtpTransportControllerSend::OnTransportFeedback(
   }
 }
 
+void RtpTransportControllerSend::OnCongestionControlFeedback(
+    Timestamp receive_time,
+    const rtcp::CongestionControlFeedback& feedback) {
+  RTC_DCHECK_RUN_ON(&sequence_checker_);
+  absl::optional<TransportPacketsFeedback> feedback_msg =
+      transport_feedback_adapter_.ProcessCongestionControlFeedback(
+          feedback, receive_time);
+  if (feedback_msg) {
+    if (controller_)
+      PostUpdates(controller_->OnTransportPacketsFeedback(*feedback_msg));
+
+    // Only update outstanding data if any packet is first time acked.
+    UpdateCongestedState();
+  }
+}
+
 void RtpTransportControllerSend::OnRemoteNetworkEstimate(
     NetworkStateEstimate estimate) {
   RTC_DCHECK_RUN_ON(&sequence_checker_);
@@ -645,8 +707,9 @@ void RtpTransportControllerSend::PostUpdates(NetworkControlUpdate update) {
     UpdateCongestedState();
   }
   if (update.pacer_config) {
-    pacer_.SetPacingRates(update.pacer_config->data_rate(),
-                          update.pacer_config->pad_rate());
+    pacing_rate_ = update.pacer_config->data_rate();
+    padding_rate_ = update.pacer_config->pad_rate();
+    UpdatePacingRates();
   }
   if (!update.probe_cluster_configs.empty()) {
     pacer_.CreateProbeClusters(std::move(update.probe_cluster_configs));
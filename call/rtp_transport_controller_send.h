@@ -116,6 +116,9 @@ class RtpTransportControllerSend final
   void OnRttUpdate(Timestamp receive_time, TimeDelta rtt) override;
   void OnTransportFeedback(Timestamp receive_time,
                            const rtcp::TransportFeedback& feedback) override;
+  void OnCongestionControlFeedback(
+      Timestamp receive_time,
+      const rtcp::CongestionControlFeedback& feedback) override;
 
   // Implements TransportFeedbackObserver interface
   void OnAddPacket(const RtpPacketSendInfo& packet_info) override;
@@ -135,6 +138,9 @@ class RtpTransportControllerSend final
   bool IsRelevantRouteChange(const rtc::NetworkRoute& old_route,
                              const rtc::NetworkRoute& new_route) const;
   void UpdateBitrateConstraints(const BitrateConstraints& updated);
+  void UpdateSecondaryRoute(const rtc::NetworkRoute& network_route)
+      RTC_RUN_ON(sequence_checker_);
+  void UpdatePacingRates() RTC_RUN_ON(sequence_checker_);
   void UpdateStreamsConfig() RTC_RUN_ON(sequence_checker_);
   void PostUpdates(NetworkControlUpdate update) RTC_RUN_ON(sequence_checker_);
   void UpdateControlState() RTC_RUN_ON(sequence_checker_);
@@ -193,6 +199,9 @@ class RtpTransportControllerSend final
   const bool reset_feedback_on_route_change_;
   const bool add_pacing_to_cwin_;
   FieldTrialParameter<DataRate> relay_bandwidth_cap_;
+  // Share of the pacing rate that is used for the secondary route of the
+  // transport while it has one.
+  FieldTrialParameter<double> secondary_route_share_;
 
   size_t transport_overhead_bytes_per_packet_ RTC_GUARDED_BY(sequence_checker_);
   bool network_available_ RTC_GUARDED_BY(sequence_checker_);
@@ -201,6 +210,11 @@ class RtpTransportControllerSend final
   RepeatingTaskHandle controller_task_ RTC_GUARDED_BY(sequence_checker_);
 
   DataSize congestion_window_size_ RTC_GUARDED_BY(sequence_checker_);
+  // Latest pacing rates of the network controller, which the primary and
+  // secondary routes share.
+  DataRate pacing_rate_ RTC_GUARDED_BY(sequence_checker_);
+  DataRate padding_rate_ RTC_GUARDED_BY(sequence_checker_);
+  bool secondary_route_connected_ RTC_GUARDED_BY(sequence_checker_);
   bool is_congested_ RTC_GUARDED_BY(sequence_checker_);
 
   // Protected by internal locks.
@@ -26,6 +26,7 @@
 #include "call/rtp_transport_controller_send_interface.h"
 #include "modules/pacing/packet_router.h"
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "modules/rtp_rtcp/source/packetized_video_frame.h"
 #include "modules/rtp_rtcp/source/rtp_rtcp_impl2.h"
 #include "modules/rtp_rtcp/source/rtp_sender.h"
 #include "modules/video_coding/include/video_codec_interface.h"
@@ -563,6 +564,22 @@ bool RtpVideoSender::IsActiveLocked() {
 EncodedImageCallback::Result RtpVideoSender::OnEncodedImage(
     const EncodedImage& encoded_image,
     const CodecSpecificInfo* codec_specific_info) {
+  return SendEncodedImage(encoded_image, codec_specific_info,
+                          /*packetized_frame=*/nullptr);
+}
+
+EncodedImageCallback::Result RtpVideoSender::OnEncodedImage(
+    const EncodedImage& encoded_image,
+    const CodecSpecificInfo* codec_specific_info,
+    PacketizedVideoFrame& packetized_frame) {
+  return SendEncodedImage(encoded_image, codec_specific_info,
+                          &packetized_frame);
+}
+
+EncodedImageCallback::Result RtpVideoSender::SendEncodedImage(
+    const EncodedImage& encoded_image,
+    const CodecSpecificInfo* codec_specific_info,
+    PacketizedVideoFrame* packetized_frame) {
   fec_controller_->UpdateWithEncodedData(encoded_image.size(),
                                          encoded_image._frameType);
   MutexLock lock(&mutex_);
@@ -617,12 +634,19 @@ EncodedImageCallback::Result RtpVideoSender::OnEncodedImage(
     }
   }
 
+  RTPSenderVideo& sender_video = *rtp_streams_[simulcast_index].sender_video;
+  RTPVideoHeader video_header = params_[simulcast_index].GetRtpVideoHeader(
+      encoded_image, codec_specific_info, shared_frame_id_);
   bool send_result =
-      rtp_streams_[simulcast_index].sender_video->SendEncodedImage(
-          rtp_config_.payload_type, codec_type_, rtp_timestamp, encoded_image,
-          params_[simulcast_index].GetRtpVideoHeader(
-              encoded_image, codec_specific_info, shared_frame_id_),
-          expected_retransmission_time);
+      packetized_frame != nullptr
+          ? sender_video.SendEncodedImage(
+                rtp_config_.payload_type, codec_type_, rtp_timestamp,
+                encoded_image, std::move(video_header),
+                expected_retransmission_time, *packetized_frame)
+          : sender_video.SendEncodedImage(
+                rtp_config_.payload_type, codec_type_, rtp_timestamp,
+                encoded_image, std::move(video_header),
+                expected_retransmission_time);
   if (frame_count_observer_) {
     FrameCounts& counts = frame_counts_[simulcast_index];
     if (encoded_image._frameType == VideoFrameType::kVideoFrameKey) {
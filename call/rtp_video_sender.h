@@ -44,6 +44,7 @@
 namespace webrtc {
 
 class FrameEncryptorInterface;
+class PacketizedVideoFrame;
 class RtpTransportControllerSendInterface;
 
 namespace webrtc_internal_rtp_video_sender {
@@ -134,6 +135,13 @@ class RtpVideoSender : public RtpVideoSenderInterface,
       const EncodedImage& encoded_image,
       const CodecSpecificInfo* codec_specific_info)
       RTC_LOCKS_EXCLUDED(mutex_) override;
+  // Same as above, for a frame that other RtpVideoSenders send too. They
+  // share the packetization of the frame through `packetized_frame`, see
+  // RtpVideoSenderFanOut.
+  EncodedImageCallback::Result OnEncodedImage(
+      const EncodedImage& encoded_image,
+      const CodecSpecificInfo* codec_specific_info,
+      PacketizedVideoFrame& packetized_frame) RTC_LOCKS_EXCLUDED(mutex_);
 
   void OnBitrateAllocationUpdated(const VideoBitrateAllocation& bitrate)
       RTC_LOCKS_EXCLUDED(mutex_) override;
@@ -159,6 +167,12 @@ class RtpVideoSender : public RtpVideoSenderInterface,
       RTC_LOCKS_EXCLUDED(mutex_) override;
 
  private:
+  // Implements OnEncodedImage. Shares the packetization of the frame through
+  // `packetized_frame` when it is not null.
+  EncodedImageCallback::Result SendEncodedImage(
+      const EncodedImage& encoded_image,
+      const CodecSpecificInfo* codec_specific_info,
+      PacketizedVideoFrame* packetized_frame) RTC_LOCKS_EXCLUDED(mutex_);
   bool IsActiveLocked() RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
   void SetActiveModulesLocked(const std::vector<bool>& active_modules)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
@@ -0,0 +1,59 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "call/rtp_video_sender_fan_out.h"
+
+#include "absl/algorithm/container.h"
+#include "modules/rtp_rtcp/source/packetized_video_frame.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+RtpVideoSenderFanOut::RtpVideoSenderFanOut() = default;
+
+RtpVideoSenderFanOut::~RtpVideoSenderFanOut() = default;
+
+void RtpVideoSenderFanOut::AddSender(RtpVideoSender* sender) {
+  RTC_DCHECK(sender);
+  MutexLock lock(&mutex_);
+  RTC_DCHECK(!absl::c_linear_search(senders_, sender));
+  senders_.push_back(sender);
+}
+
+void RtpVideoSenderFanOut::RemoveSender(RtpVideoSender* sender) {
+  MutexLock lock(&mutex_);
+  auto it = absl::c_find(senders_, sender);
+  RTC_DCHECK(it != senders_.end());
+  if (it != senders_.end()) {
+    senders_.erase(it);
+  }
+}
+
+EncodedImageCallback::Result RtpVideoSenderFanOut::OnEncodedImage(
+    const EncodedImage& encoded_image,
+    const CodecSpecificInfo* codec_specific_info) {
+  MutexLock lock(&mutex_);
+  if (senders_.size() == 1) {
+    // Nothing to share, and keeping the payloads would only cost a copy.
+    return senders_[0]->OnEncodedImage(encoded_image, codec_specific_info);
+  }
+  Result result(Result::ERROR_SEND_FAILED);
+  PacketizedVideoFrame packetized_frame;
+  for (RtpVideoSender* sender : senders_) {
+    Result sender_result = sender->OnEncodedImage(
+        encoded_image, codec_specific_info, packetized_frame);
+    if (result.error != Result::OK) {
+      result = sender_result;
+    }
+  }
+  return result;
+}
+
+}  // namespace webrtc
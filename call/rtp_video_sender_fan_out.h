@@ -0,0 +1,52 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef CALL_RTP_VIDEO_SENDER_FAN_OUT_H_
+#define CALL_RTP_VIDEO_SENDER_FAN_OUT_H_
+
+#include <vector>
+
+#include "api/video/encoded_image.h"
+#include "api/video_codecs/video_encoder.h"
+#include "call/rtp_video_sender.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// Sends each encoded frame on all the added RtpVideoSenders, e.g. the senders
+// of the receivers that an SFU forwards a stream to. The frame is packetized
+// once, and the other senders reuse those payloads, see PacketizedVideoFrame.
+// A single sender packetizes the frame as usual.
+class RtpVideoSenderFanOut : public EncodedImageCallback {
+ public:
+  RtpVideoSenderFanOut();
+  RtpVideoSenderFanOut(const RtpVideoSenderFanOut&) = delete;
+  RtpVideoSenderFanOut& operator=(const RtpVideoSenderFanOut&) = delete;
+  ~RtpVideoSenderFanOut() override;
+
+  // `sender` must outlive this object, or be removed before it is destroyed.
+  void AddSender(RtpVideoSender* sender) RTC_LOCKS_EXCLUDED(mutex_);
+  void RemoveSender(RtpVideoSender* sender) RTC_LOCKS_EXCLUDED(mutex_);
+
+  // Implements EncodedImageCallback. Succeeds if any of the senders sent the
+  // frame, and then returns the RTP timestamp of the first one that did.
+  Result OnEncodedImage(const EncodedImage& encoded_image,
+                        const CodecSpecificInfo* codec_specific_info)
+      RTC_LOCKS_EXCLUDED(mutex_) override;
+
+ private:
+  Mutex mutex_;
+  std::vector<RtpVideoSender*> senders_ RTC_GUARDED_BY(mutex_);
+};
+
+}  // namespace webrtc
+
+#endif  // CALL_RTP_VIDEO_SENDER_FAN_OUT_H_
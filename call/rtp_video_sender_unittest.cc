@@ -17,11 +17,13 @@
 
 #include "absl/functional/any_invocable.h"
 #include "call/rtp_transport_controller_send.h"
+#include "call/rtp_video_sender_fan_out.h"
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "modules/rtp_rtcp/source/byte_io.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/nack.h"
 #include "modules/rtp_rtcp/source/rtp_dependency_descriptor_extension.h"
 #include "modules/rtp_rtcp/source/rtp_packet.h"
+#include "modules/rtp_rtcp/source/video_rtp_depacketizer_vp8.h"
 #include "modules/video_coding/fec_controller_default.h"
 #include "modules/video_coding/include/video_codec_interface.h"
 #include "rtc_base/rate_limiter.h"
@@ -38,6 +40,7 @@ namespace webrtc {
 namespace {
 
 using ::testing::_;
+using ::testing::Gt;
 using ::testing::NiceMock;
 using ::testing::SaveArg;
 using ::testing::SizeIs;
@@ -183,6 +186,33 @@ class RtpVideoSenderTestFixture {
   ~RtpVideoSenderTestFixture() { Stop(); }
 
   RtpVideoSender* router() { return router_.get(); }
+  // Creates another sender, of `ssrcs` on `transport`, that shares the
+  // transport controller of this one.
+  std::unique_ptr<RtpVideoSender> CreateRouter(
+      const std::vector<uint32_t>& ssrcs,
+      const std::vector<uint32_t>& rtx_ssrcs,
+      Transport* transport) {
+    return CreateRouter(CreateVideoSendStreamConfig(transport, ssrcs, rtx_ssrcs,
+                                                    config_.rtp.payload_type)
+                            .rtp,
+                        transport, /*suspended_payload_states=*/{});
+  }
+  // Same as above, with the RTP config `rtp_config`.
+  std::unique_ptr<RtpVideoSender> CreateRouter(
+      const RtpConfig& rtp_config,
+      Transport* transport,
+      const std::map<uint32_t, RtpPayloadState>& suspended_payload_states) {
+    return std::make_unique<RtpVideoSender>(
+        time_controller_.GetClock(), /*suspended_ssrcs=*/
+        std::map<uint32_t, RtpState>(), suspended_payload_states, rtp_config,
+        config_.rtcp_report_interval_ms, transport,
+        CreateObservers(&encoder_feedback_, nullptr, nullptr, nullptr,
+                        nullptr, nullptr),
+        &transport_controller_, &event_log_, &retransmission_rate_limiter_,
+        std::make_unique<FecControllerDefault>(time_controller_.GetClock()),
+        nullptr, CryptoOptions{}, /*frame_transformer=*/nullptr,
+        field_trials_, time_controller_.GetTaskQueueFactory());
+  }
   MockTransport& transport() { return transport_; }
   void AdvanceTime(TimeDelta delta) { time_controller_.AdvanceTime(delta); }
 
@@ -1229,4 +1259,164 @@ TEST(RtpVideoSenderTest, RetransmitsBaseLayerOnly) {
   EXPECT_EQ(retransmitted_rtp_sequence_numbers, base_rtp_sequence_numbers);
 }
 
+TEST(RtpVideoSenderTest, FanOutSendsSamePayloadsOnAllSenders) {
+  RtpVideoSenderTestFixture test({kSsrc1}, {kRtxSsrc1}, kPayloadType, {});
+  NiceMock<MockTransport> other_transport;
+  std::unique_ptr<RtpVideoSender> other_router =
+      test.CreateRouter({kSsrc2}, {kRtxSsrc2}, &other_transport);
+  test.SetActiveModules({true});
+  other_router->SetActiveModules({true});
+  RtpVideoSenderFanOut fan_out;
+  fan_out.AddSender(test.router());
+  fan_out.AddSender(other_router.get());
+
+  // A frame that needs several packets.
+  const std::vector<uint8_t> kPayload(3000, 'a');
+  EncodedImage encoded_image;
+  encoded_image.SetTimestamp(1);
+  encoded_image.capture_time_ms_ = 2;
+  encoded_image._frameType = VideoFrameType::kVideoFrameKey;
+  encoded_image.SetEncodedData(
+      EncodedImageBuffer::Create(kPayload.data(), kPayload.size()));
+
+  std::vector<std::vector<uint8_t>> payloads;
+  std::vector<std::vector<uint8_t>> other_payloads;
+  auto save_payload = [](uint32_t ssrc,
+                         std::vector<std::vector<uint8_t>>& payloads) {
+    return [ssrc, &payloads](rtc::ArrayView<const uint8_t> packet,
+                             const PacketOptions& options) {
+      RtpPacket rtp_packet;
+      EXPECT_TRUE(rtp_packet.Parse(packet));
+      if (rtp_packet.Ssrc() == ssrc) {
+        payloads.emplace_back(rtp_packet.payload().begin(),
+                              rtp_packet.payload().end());
+      }
+      return true;
+    };
+  };
+  ON_CALL(test.transport(), SendRtp)
+      .WillByDefault(save_payload(kSsrc1, payloads));
+  ON_CALL(other_transport, SendRtp)
+      .WillByDefault(save_payload(kSsrc2, other_payloads));
+
+  EXPECT_EQ(EncodedImageCallback::Result::OK,
+            fan_out.OnEncodedImage(encoded_image, nullptr).error);
+  test.AdvanceTime(TimeDelta::Seconds(1));
+  EXPECT_THAT(payloads, SizeIs(Gt(1)));
+  EXPECT_EQ(payloads, other_payloads);
+
+  // A single sender sends the frame on its own.
+  fan_out.RemoveSender(other_router.get());
+  payloads.clear();
+  encoded_image.SetTimestamp(2);
+  encoded_image.capture_time_ms_ = 3;
+  EXPECT_EQ(EncodedImageCallback::Result::OK,
+            fan_out.OnEncodedImage(encoded_image, nullptr).error);
+  test.AdvanceTime(TimeDelta::Seconds(1));
+  EXPECT_THAT(payloads, SizeIs(Gt(1)));
+
+  fan_out.RemoveSender(test.router());
+  other_router->Stop();
+}
+
+TEST(RtpVideoSenderTest, FanOutSendsPictureIdsOfEachSender) {
+  RtpVideoSenderTestFixture test({kSsrc1}, {kRtxSsrc1}, kPayloadType, {});
+  // Without a generic frame descriptor, the VP8 payload descriptor carries
+  // the picture id and TL0PICIDX of each sender.
+  auto create_router = [&test](uint32_t ssrc, uint32_t rtx_ssrc,
+                               int16_t picture_id, int16_t tl0_pic_idx,
+                               Transport* transport) {
+    RtpConfig rtp_config =
+        CreateVideoSendStreamConfig(transport, {ssrc}, {rtx_ssrc}, kPayloadType)
+            .rtp;
+    rtp_config.payload_name = "VP8";
+    // Drops the dependency descriptor extension.
+    rtp_config.extensions.pop_back();
+    RtpPayloadState state;
+    state.picture_id = picture_id;
+    state.tl0_pic_idx = tl0_pic_idx;
+    std::unique_ptr<RtpVideoSender> router =
+        test.CreateRouter(rtp_config, transport, {{ssrc, state}});
+    router->SetActiveModules({true});
+    return router;
+  };
+  NiceMock<MockTransport> transport;
+  NiceMock<MockTransport> other_transport;
+  std::unique_ptr<RtpVideoSender> router = create_router(
+      kSsrc1, kRtxSsrc1, kInitialPictureId1, kInitialTl0PicIdx1, &transport);
+  std::unique_ptr<RtpVideoSender> other_router =
+      create_router(kSsrc2, kRtxSsrc2, kInitialPictureId2, kInitialTl0PicIdx2,
+                    &other_transport);
+  RtpVideoSenderFanOut fan_out;
+  fan_out.AddSender(router.get());
+  fan_out.AddSender(other_router.get());
+
+  const std::vector<uint8_t> kPayload(3000, 'a');
+  EncodedImage encoded_image;
+  encoded_image.SetTimestamp(1);
+  encoded_image.capture_time_ms_ = 2;
+  encoded_image._frameType = VideoFrameType::kVideoFrameKey;
+  encoded_image.SetEncodedData(
+      EncodedImageBuffer::Create(kPayload.data(), kPayload.size()));
+  CodecSpecificInfo codec_specific;
+  codec_specific.codecType = kVideoCodecVP8;
+  codec_specific.codecSpecific.VP8.temporalIdx = 0;
+
+  std::vector<RTPVideoHeaderVP8> vp8_headers;
+  std::vector<RTPVideoHeaderVP8> other_vp8_headers;
+  auto save_vp8_header = [](uint32_t ssrc,
+                            std::vector<RTPVideoHeaderVP8>& vp8_headers) {
+    return [ssrc, &vp8_headers](rtc::ArrayView<const uint8_t> packet,
+                                const PacketOptions& options) {
+      RtpPacket rtp_packet;
+      EXPECT_TRUE(rtp_packet.Parse(packet));
+      RTPVideoHeader video_header;
+      if (rtp_packet.Ssrc() == ssrc &&
+          VideoRtpDepacketizerVp8::ParseRtpPayload(rtp_packet.payload(),
+                                                   &video_header) > 0) {
+        vp8_headers.push_back(
+            absl::get<RTPVideoHeaderVP8>(video_header.video_type_header));
+      }
+      return true;
+    };
+  };
+  ON_CALL(transport, SendRtp)
+      .WillByDefault(save_vp8_header(kSsrc1, vp8_headers));
+  ON_CALL(other_transport, SendRtp)
+      .WillByDefault(save_vp8_header(kSsrc2, other_vp8_headers));
+
+  EXPECT_EQ(EncodedImageCallback::Result::OK,
+            fan_out.OnEncodedImage(encoded_image, &codec_specific).error);
+  test.AdvanceTime(TimeDelta::Seconds(1));
+  ASSERT_THAT(vp8_headers, SizeIs(Gt(1)));
+  ASSERT_THAT(other_vp8_headers, SizeIs(vp8_headers.size()));
+  for (const RTPVideoHeaderVP8& vp8 : vp8_headers) {
+    EXPECT_EQ(vp8.pictureId, kInitialPictureId1 + 1);
+    EXPECT_EQ(vp8.tl0PicIdx, kInitialTl0PicIdx1 + 1);
+  }
+  for (const RTPVideoHeaderVP8& vp8 : other_vp8_headers) {
+    EXPECT_EQ(vp8.pictureId, kInitialPictureId2 + 1);
+    EXPECT_EQ(vp8.tl0PicIdx, kInitialTl0PicIdx2 + 1);
+  }
+
+  // Each sender keeps counting from its own picture id once it sends on its
+  // own.
+  fan_out.RemoveSender(router.get());
+  other_vp8_headers.clear();
+  encoded_image.SetTimestamp(2);
+  encoded_image.capture_time_ms_ = 3;
+  EXPECT_EQ(EncodedImageCallback::Result::OK,
+            fan_out.OnEncodedImage(encoded_image, &codec_specific).error);
+  test.AdvanceTime(TimeDelta::Seconds(1));
+  ASSERT_THAT(other_vp8_headers, SizeIs(Gt(1)));
+  for (const RTPVideoHeaderVP8& vp8 : other_vp8_headers) {
+    EXPECT_EQ(vp8.pictureId, kInitialPictureId2 + 2);
+    EXPECT_EQ(vp8.tl0PicIdx, kInitialTl0PicIdx2 + 2);
+  }
+
+  fan_out.RemoveSender(other_router.get());
+  router->Stop();
+  other_router->Stop();
+}
+
 }  // namespace webrtc
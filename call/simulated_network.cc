@@ -178,6 +178,20 @@ void SimulatedNetwork::UpdateCapacityQueue(ConfigState state,
       packet.arrival_time_us = state.pause_transmission_until_us;
     }
 
+    if (state.config.ecn_marking_threshold_ms >= 0 &&
+        packet.packet.ecn != EcnMarking::kNotEct) {
+      // The time the packet spent waiting for the link, i.e. its time in the
+      // network except for the time it takes to send it.
+      const int64_t queue_delay_us =
+          packet.arrival_time_us -
+          CalculateArrivalTimeUs(packet.packet.send_time_us,
+                                 packet.packet.size * 8,
+                                 state.config.link_capacity_kbps);
+      if (queue_delay_us > state.config.ecn_marking_threshold_ms * 1000) {
+        packet.packet.ecn = EcnMarking::kCe;
+      }
+    }
+
     // Store the original arrival time, before applying packet loss or extra
     // delay. This is needed to know when it is the first available time the
     // next packet in the `capacity_link_` queue can start transmitting.
@@ -36,6 +36,7 @@ namespace webrtc {
 // - Extra delay with or without packets reorder
 // - Packet overhead
 // - Queue max capacity
+// - ECN marking of packets that were queued for long
 class SimulatedNetwork : public SimulatedNetworkInterface {
  public:
   using Config = BuiltInNetworkBehaviorConfig;
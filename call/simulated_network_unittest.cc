@@ -17,6 +17,7 @@
 
 #include "absl/algorithm/container.h"
 #include "api/test/simulated_network.h"
+#include "api/transport/ecn_marking.h"
 #include "api/units/data_rate.h"
 #include "api/units/time_delta.h"
 #include "test/gmock.h"
@@ -450,6 +451,48 @@ TEST(SimulatedNetworkTest, PauseTransmissionUntil) {
   EXPECT_EQ(delivered_packets.size(), 2ul);
 }
 
+TEST(SimulatedNetworkTest, MarksEcnCapablePacketsQueuedLongerThanThreshold) {
+  // Packets of 125 bytes on a 1 kbps network take 1 second each to send, so
+  // the n:th packet sent at time 0 is queued for n - 1 seconds.
+  SimulatedNetwork network = SimulatedNetwork(
+      {.link_capacity_kbps = 1, .ecn_marking_threshold_ms = 1500});
+  for (uint64_t id = 0; id < 3; ++id) {
+    PacketInFlightInfo packet(/*size=*/125, /*send_time_us=*/0, id);
+    packet.ecn = EcnMarking::kEct1;
+    ASSERT_TRUE(network.EnqueuePacket(packet));
+  }
+  PacketInFlightInfo not_ect(/*size=*/125, /*send_time_us=*/0,
+                             /*packet_id=*/3);
+  ASSERT_TRUE(network.EnqueuePacket(not_ect));
+
+  std::vector<PacketDeliveryInfo> delivered_packets =
+      network.DequeueDeliverablePackets(
+          /*receive_time_us=*/TimeDelta::Seconds(4).us());
+  ASSERT_EQ(delivered_packets.size(), 4ul);
+  EXPECT_EQ(delivered_packets[0].ecn, EcnMarking::kEct1);
+  EXPECT_EQ(delivered_packets[1].ecn, EcnMarking::kEct1);
+  EXPECT_EQ(delivered_packets[2].ecn, EcnMarking::kCe);
+  // Packets that are not ECN capable are never marked.
+  EXPECT_EQ(delivered_packets[3].ecn, EcnMarking::kNotEct);
+}
+
+TEST(SimulatedNetworkTest, DoesNotMarkEcnWithoutThreshold) {
+  SimulatedNetwork network = SimulatedNetwork({.link_capacity_kbps = 1});
+  for (uint64_t id = 0; id < 3; ++id) {
+    PacketInFlightInfo packet(/*size=*/125, /*send_time_us=*/0, id);
+    packet.ecn = EcnMarking::kEct1;
+    ASSERT_TRUE(network.EnqueuePacket(packet));
+  }
+
+  std::vector<PacketDeliveryInfo> delivered_packets =
+      network.DequeueDeliverablePackets(
+          /*receive_time_us=*/TimeDelta::Seconds(3).us());
+  ASSERT_EQ(delivered_packets.size(), 3ul);
+  for (const PacketDeliveryInfo& packet : delivered_packets) {
+    EXPECT_EQ(packet.ecn, EcnMarking::kEct1);
+  }
+}
+
 TEST(SimulatedNetworkTest, CongestedNetworkRespectsLinkCapacity) {
   SimulatedNetwork network = SimulatedNetwork({.link_capacity_kbps = 1});
   for (size_t i = 0; i < 1'000; ++i) {
@@ -29,6 +29,7 @@
 #include "api/video/video_sink_interface.h"
 #include "api/video/video_timing.h"
 #include "api/video_codecs/sdp_video_format.h"
+#include "api/video_codecs/video_decoder.h"
 #include "call/receive_stream.h"
 #include "call/rtp_config.h"
 #include "common_video/frame_counts.h"
@@ -248,6 +249,11 @@ class VideoReceiveStreamInterface : public MediaReceiveStreamInterface {
     // available.
     bool enable_prerenderer_smoothing = true;
 
+    // How the software decoders of the stream use threads. With kDefault,
+    // the "WebRTC-DecoderThreading" field trial may select another mode.
+    VideoDecoder::ThreadingMode decoder_threading_mode =
+        VideoDecoder::ThreadingMode::kDefault;
+
     // Identifier for an A/V synchronization group. Empty string to disable.
     // TODO(pbos): Synchronize streams in a sync group, not just video streams
     // to one of the audio streams.
@@ -12,17 +12,92 @@
 
 #include <cstdint>
 
+#include "absl/numeric/bits.h"
+#include "rtc_base/system/arch.h"
+
+// This needs to be after rtc_base/system/arch.h which defines
+// architecture macros.
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#elif defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+
 namespace webrtc {
 namespace H264 {
 
 const uint8_t kNaluTypeMask = 0x1F;
 
-std::vector<NaluIndex> FindNaluIndices(const uint8_t* buffer,
-                                       size_t buffer_size) {
+namespace {
+
+// Returns the offset of the first start sequence {0 0 1} that begins in
+// `buffer[offset, end)`, or `end` if there is none. `buffer` must hold at least
+// `end + kNaluShortStartSequenceSize` bytes.
+size_t FindStartSequence(const uint8_t* buffer, size_t offset, size_t end) {
+  // Compare 16 candidate positions at a time. Start sequences are rare in
+  // coded slice data, so almost all blocks are rejected after a few
+  // instructions.
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  const __m128i zeros = _mm_setzero_si128();
+  const __m128i ones = _mm_set1_epi8(1);
+  for (; offset + 16 <= end; offset += 16) {
+    const uint8_t* block = buffer + offset;
+    __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+    __m128i second =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 1));
+    __m128i third =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 2));
+    __m128i matches = _mm_and_si128(
+        _mm_and_si128(_mm_cmpeq_epi8(first, zeros),
+                      _mm_cmpeq_epi8(second, zeros)),
+        _mm_cmpeq_epi8(third, ones));
+    uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(matches));
+    if (mask != 0) {
+      return offset + absl::countr_zero(mask);
+    }
+  }
+#elif defined(WEBRTC_HAS_NEON)
+  const uint8x16_t zeros = vdupq_n_u8(0);
+  const uint8x16_t ones = vdupq_n_u8(1);
+  for (; offset + 16 <= end; offset += 16) {
+    const uint8_t* block = buffer + offset;
+    uint8x16_t matches =
+        vandq_u8(vandq_u8(vceqq_u8(vld1q_u8(block), zeros),
+                          vceqq_u8(vld1q_u8(block + 1), zeros)),
+                 vceqq_u8(vld1q_u8(block + 2), ones));
+    // Narrow the byte mask to 4 bits per position.
+    uint64_t mask = vget_lane_u64(
+        vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)),
+        0);
+    if (mask != 0) {
+      return offset + absl::countr_zero(mask) / 4;
+    }
+  }
+#endif
+
   // This is sorta like Boyer-Moore, but with only the first optimization step:
   // given a 3-byte sequence we're looking at, if the 3rd byte isn't 1 or 0,
   // skip ahead to the next 3-byte sequence. 0s and 1s are relatively rare, so
   // this will skip the majority of reads/checks.
+  while (offset < end) {
+    if (buffer[offset + 2] > 1) {
+      offset += 3;
+    } else if (buffer[offset + 2] == 1) {
+      if (buffer[offset + 1] == 0 && buffer[offset] == 0) {
+        return offset;
+      }
+      offset += 3;
+    } else {
+      ++offset;
+    }
+  }
+  return end;
+}
+
+}  // namespace
+
+std::vector<NaluIndex> FindNaluIndices(const uint8_t* buffer,
+                                       size_t buffer_size) {
   std::vector<NaluIndex> sequences;
   if (buffer_size < kNaluShortStartSequenceSize)
     return sequences;
@@ -30,28 +105,19 @@ std::vector<NaluIndex> FindNaluIndices(const uint8_t* buffer,
   static_assert(kNaluShortStartSequenceSize >= 2,
                 "kNaluShortStartSequenceSize must be larger or equals to 2");
   const size_t end = buffer_size - kNaluShortStartSequenceSize;
-  for (size_t i = 0; i < end;) {
-    if (buffer[i + 2] > 1) {
-      i += 3;
-    } else if (buffer[i + 2] == 1) {
-      if (buffer[i + 1] == 0 && buffer[i] == 0) {
-        // We found a start sequence, now check if it was a 3 of 4 byte one.
-        NaluIndex index = {i, i + 3, 0};
-        if (index.start_offset > 0 && buffer[index.start_offset - 1] == 0)
-          --index.start_offset;
-
-        // Update length of previous entry.
-        auto it = sequences.rbegin();
-        if (it != sequences.rend())
-          it->payload_size = index.start_offset - it->payload_start_offset;
-
-        sequences.push_back(index);
-      }
-
-      i += 3;
-    } else {
-      ++i;
-    }
+  for (size_t i = FindStartSequence(buffer, 0, end); i < end;
+       i = FindStartSequence(buffer, i + kNaluShortStartSequenceSize, end)) {
+    // We found a start sequence, now check if it was a 3 of 4 byte one.
+    NaluIndex index = {i, i + kNaluShortStartSequenceSize, 0};
+    if (index.start_offset > 0 && buffer[index.start_offset - 1] == 0)
+      --index.start_offset;
+
+    // Update length of previous entry.
+    auto it = sequences.rbegin();
+    if (it != sequences.rend())
+      it->payload_size = index.start_offset - it->payload_start_offset;
+
+    sequences.push_back(index);
   }
 
   // Update length of last entry, if any.
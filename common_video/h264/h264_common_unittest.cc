@@ -0,0 +1,112 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_video/h264/h264_common.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "rtc_base/random.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace H264 {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::FieldsAre;
+using ::testing::IsEmpty;
+
+// Straightforward byte by byte search, used as a reference for
+// `FindNaluIndices`.
+std::vector<NaluIndex> FindNaluIndicesReference(
+    const std::vector<uint8_t>& buffer) {
+  std::vector<NaluIndex> sequences;
+  for (size_t i = 0; i + kNaluShortStartSequenceSize < buffer.size(); ++i) {
+    if (buffer[i] != 0 || buffer[i + 1] != 0 || buffer[i + 2] != 1) {
+      continue;
+    }
+    size_t start_offset = (i > 0 && buffer[i - 1] == 0) ? i - 1 : i;
+    if (!sequences.empty()) {
+      sequences.back().payload_size =
+          start_offset - sequences.back().payload_start_offset;
+    }
+    sequences.push_back({start_offset, i + kNaluShortStartSequenceSize, 0});
+  }
+  if (!sequences.empty()) {
+    sequences.back().payload_size =
+        buffer.size() - sequences.back().payload_start_offset;
+  }
+  return sequences;
+}
+
+void ExpectSameIndices(const std::vector<uint8_t>& buffer) {
+  std::vector<NaluIndex> expected = FindNaluIndicesReference(buffer);
+  std::vector<NaluIndex> actual = FindNaluIndices(buffer.data(), buffer.size());
+  ASSERT_EQ(actual.size(), expected.size());
+  for (size_t i = 0; i < actual.size(); ++i) {
+    EXPECT_EQ(actual[i].start_offset, expected[i].start_offset);
+    EXPECT_EQ(actual[i].payload_start_offset,
+              expected[i].payload_start_offset);
+    EXPECT_EQ(actual[i].payload_size, expected[i].payload_size);
+  }
+}
+
+TEST(H264CommonTest, FindNaluIndicesInShortBuffers) {
+  const uint8_t kStartSequenceOnly[] = {0, 0, 1};
+  EXPECT_THAT(FindNaluIndices(kStartSequenceOnly, 0), IsEmpty());
+  EXPECT_THAT(FindNaluIndices(kStartSequenceOnly, 3), IsEmpty());
+
+  const uint8_t kSingleByteNalu[] = {0, 0, 1, 0xaa};
+  EXPECT_THAT(FindNaluIndices(kSingleByteNalu, sizeof(kSingleByteNalu)),
+              ElementsAre(FieldsAre(0, 3, 1)));
+}
+
+TEST(H264CommonTest, FindNaluIndicesWithShortAndLongStartSequences) {
+  const uint8_t kBuffer[] = {0, 0, 0, 1, 0xaa, 0xbb, 0, 0, 1, 0xcc, 0xdd, 0xee};
+  EXPECT_THAT(FindNaluIndices(kBuffer, sizeof(kBuffer)),
+              ElementsAre(FieldsAre(0, 4, 2), FieldsAre(6, 9, 3)));
+}
+
+TEST(H264CommonTest, FindNaluIndicesFindsStartSequenceAtAnyOffset) {
+  // Covers start sequences at every position relative to the blocks that are
+  // scanned at once, including ones that straddle two blocks.
+  for (size_t offset = 0; offset < 40; ++offset) {
+    std::vector<uint8_t> buffer(offset + 20, 0xff);
+    buffer[offset] = 0;
+    buffer[offset + 1] = 0;
+    buffer[offset + 2] = 1;
+    std::vector<NaluIndex> indices =
+        FindNaluIndices(buffer.data(), buffer.size());
+    ASSERT_EQ(indices.size(), 1u) << "offset " << offset;
+    EXPECT_EQ(indices[0].start_offset, offset);
+    EXPECT_EQ(indices[0].payload_start_offset, offset + 3);
+    EXPECT_EQ(indices[0].payload_size, 17u);
+  }
+}
+
+TEST(H264CommonTest, FindNaluIndicesMatchesReferenceOnRandomData) {
+  Random random(0x1234);
+  for (int i = 0; i < 2000; ++i) {
+    std::vector<uint8_t> buffer(random.Rand(0, 100));
+    // Mostly zeros and ones, so that both start sequences and near misses
+    // are frequent.
+    for (uint8_t& byte : buffer) {
+      byte = random.Rand(0, 3) == 0 ? random.Rand<uint8_t>()
+                                    : random.Rand(0, 1);
+    }
+    ExpectSameIndices(buffer);
+  }
+}
+
+}  // namespace
+}  // namespace H264
+}  // namespace webrtc
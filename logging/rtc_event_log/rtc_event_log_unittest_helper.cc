@@ -1301,19 +1301,15 @@ void EventVerifier::VerifyLoggedTransportFeedback(
     const rtcp::TransportFeedback& original_transport_feedback,
     const LoggedRtcpPacketTransportFeedback& logged_transport_feedback) {
   EXPECT_EQ(log_time_ms, logged_transport_feedback.log_time_ms());
-  ASSERT_EQ(
-      original_transport_feedback.GetReceivedPackets().size(),
-      logged_transport_feedback.transport_feedback.GetReceivedPackets().size());
-  for (size_t i = 0;
-       i < original_transport_feedback.GetReceivedPackets().size(); i++) {
-    EXPECT_EQ(
-        original_transport_feedback.GetReceivedPackets()[i].sequence_number(),
-        logged_transport_feedback.transport_feedback.GetReceivedPackets()[i]
-            .sequence_number());
-    EXPECT_EQ(
-        original_transport_feedback.GetReceivedPackets()[i].delta(),
-        logged_transport_feedback.transport_feedback.GetReceivedPackets()[i]
-            .delta());
+  const std::vector<rtcp::TransportFeedback::ReceivedPacket> original_packets =
+      original_transport_feedback.GetReceivedPackets();
+  const std::vector<rtcp::TransportFeedback::ReceivedPacket> logged_packets =
+      logged_transport_feedback.transport_feedback.GetReceivedPackets();
+  ASSERT_EQ(original_packets.size(), logged_packets.size());
+  for (size_t i = 0; i < original_packets.size(); i++) {
+    EXPECT_EQ(original_packets[i].sequence_number(),
+              logged_packets[i].sequence_number());
+    EXPECT_EQ(original_packets[i].delta(), logged_packets[i].delta());
   }
 }
 
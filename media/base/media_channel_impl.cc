@@ -227,6 +227,8 @@ bool MediaChannelUtil::TransportForMediaChannels::SendRtp(
        included_in_allocation = options.included_in_allocation,
        batchable = options.batchable,
        last_packet_in_batch = options.last_packet_in_batch,
+       send_on_secondary_route = options.send_on_secondary_route,
+       ecn = options.ecn,
        packet = rtc::CopyOnWriteBuffer(packet, kMaxRtpPacketLen)]() mutable {
         rtc::PacketOptions rtc_options;
         rtc_options.packet_id = packet_id;
@@ -239,6 +241,8 @@ bool MediaChannelUtil::TransportForMediaChannels::SendRtp(
             included_in_allocation;
         rtc_options.batchable = batchable;
         rtc_options.last_packet_in_batch = last_packet_in_batch;
+        rtc_options.send_on_secondary_route = send_on_secondary_route;
+        rtc_options.ecn = ecn;
         DoSendPacket(&packet, false, rtc_options);
       };
 
@@ -637,7 +637,7 @@ void DcSctpTransport::OnTransportReadPacket(
     const int64_t& /* packet_time_us */,
     int flags) {
   RTC_DCHECK_RUN_ON(network_thread_);
-  if (flags) {
+  if (flags & ~rtc::kPacketFlagsEcnMask) {
     // We are only interested in SCTP packets.
     return;
   }
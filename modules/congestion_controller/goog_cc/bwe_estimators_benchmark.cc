@@ -0,0 +1,155 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "api/transport/network_types.h"
+#include "api/units/data_rate.h"
+#include "api/units/data_size.h"
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "benchmark/benchmark.h"
+#include "modules/congestion_controller/goog_cc/loss_based_bwe_v2.h"
+#include "modules/congestion_controller/goog_cc/trendline_estimator.h"
+#include "rtc_base/random.h"
+#include "rtc_base/system/unused.h"
+#include "test/explicit_key_value_config.h"
+
+namespace webrtc {
+namespace {
+
+// Each iteration delivers one feedback report to each of `kNumControllers`
+// estimators, at 50 reports per second of about 5 Mbit/s of packets with 2%
+// loss.
+constexpr int kNumControllers = 1000;
+constexpr TimeDelta kReportInterval = TimeDelta::Millis(20);
+constexpr int kPacketsPerReport = 10;
+constexpr DataSize kPacketSize = DataSize::Bytes(1200);
+constexpr int kLossInterval = 50;
+constexpr TimeDelta kPropagationDelay = TimeDelta::Millis(30);
+// Number of precomputed jitter values, which are reused in turn.
+constexpr int kNumJitterValues = 997;
+
+std::vector<TimeDelta> CreateJitter() {
+  Random random(/*seed=*/1234);
+  std::vector<TimeDelta> jitter;
+  for (int i = 0; i < kNumJitterValues; ++i) {
+    jitter.push_back(TimeDelta::Micros(random.Rand(0, 4000)));
+  }
+  return jitter;
+}
+
+// Fills in `packets` with the report of packets `report * kPacketsPerReport`
+// and onwards.
+void CreateReport(int64_t report,
+                  const std::vector<TimeDelta>& jitter,
+                  std::vector<PacketResult>& packets) {
+  packets.resize(kPacketsPerReport);
+  for (int i = 0; i < kPacketsPerReport; ++i) {
+    const int64_t packet = report * kPacketsPerReport + i;
+    PacketResult& result = packets[i];
+    result.sent_packet.size = kPacketSize;
+    result.sent_packet.send_time =
+        Timestamp::Zero() + kReportInterval * packet / kPacketsPerReport;
+    result.receive_time =
+        packet % kLossInterval == 0
+            ? Timestamp::PlusInfinity()
+            : result.sent_packet.send_time + kPropagationDelay +
+                  jitter[packet % kNumJitterValues];
+  }
+}
+
+void BM_TrendlineEstimator(benchmark::State& state) {
+  test::ExplicitKeyValueConfig field_trials("");
+  std::vector<std::unique_ptr<TrendlineEstimator>> estimators;
+  for (int i = 0; i < kNumControllers; ++i) {
+    estimators.push_back(std::make_unique<TrendlineEstimator>(
+        &field_trials, /*network_state_predictor=*/nullptr));
+  }
+  const std::vector<TimeDelta> jitter = CreateJitter();
+  std::vector<PacketResult> packets;
+  Timestamp previous_send_time = Timestamp::Zero();
+  Timestamp previous_receive_time = Timestamp::Zero() + kPropagationDelay;
+  int64_t report = 0;
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    CreateReport(report++, jitter, packets);
+    for (const PacketResult& packet : packets) {
+      if (!packet.IsReceived()) {
+        continue;
+      }
+      const double send_delta_ms =
+          (packet.sent_packet.send_time - previous_send_time).ms<double>();
+      const double receive_delta_ms =
+          (packet.receive_time - previous_receive_time).ms<double>();
+      for (auto& estimator : estimators) {
+        estimator->Update(receive_delta_ms, send_delta_ms,
+                          packet.sent_packet.send_time.ms(),
+                          packet.receive_time.ms(), kPacketSize.bytes(),
+                          /*calculated_deltas=*/true);
+      }
+      previous_send_time = packet.sent_packet.send_time;
+      previous_receive_time = packet.receive_time;
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumControllers);
+}
+
+void RunLossBasedBweV2(benchmark::State& state,
+                       const test::ExplicitKeyValueConfig& field_trials) {
+  const DataRate kDelayBasedEstimate = DataRate::KilobitsPerSec(6000);
+  std::vector<std::unique_ptr<LossBasedBweV2>> estimators;
+  for (int i = 0; i < kNumControllers; ++i) {
+    estimators.push_back(std::make_unique<LossBasedBweV2>(&field_trials));
+    estimators.back()->SetMinMaxBitrate(DataRate::KilobitsPerSec(30),
+                                        DataRate::KilobitsPerSec(10000));
+    estimators.back()->SetBandwidthEstimate(DataRate::KilobitsPerSec(5000));
+  }
+  const std::vector<TimeDelta> jitter = CreateJitter();
+  std::vector<PacketResult> packets;
+  int64_t report = 0;
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    CreateReport(report++, jitter, packets);
+    for (auto& estimator : estimators) {
+      estimator->SetAcknowledgedBitrate(DataRate::KilobitsPerSec(4800));
+      estimator->UpdateBandwidthEstimate(
+          packets, kDelayBasedEstimate, BandwidthUsage::kBwNormal,
+          /*probe_bitrate=*/absl::nullopt,
+          /*upper_link_capacity=*/DataRate::PlusInfinity(), /*in_alr=*/false);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumControllers);
+}
+
+void BM_LossBasedBweV2(benchmark::State& state) {
+  RunLossBasedBweV2(state, test::ExplicitKeyValueConfig(
+                               "WebRTC-Bwe-LossBasedBweV2/Enabled:true/"));
+}
+
+// Completes an observation with every report, so that every report evaluates
+// the objective of all candidates.
+void BM_LossBasedBweV2ObservationPerReport(benchmark::State& state) {
+  RunLossBasedBweV2(
+      state, test::ExplicitKeyValueConfig(
+                 "WebRTC-Bwe-LossBasedBweV2/"
+                 "Enabled:true,ObservationDurationLowerBound:20ms/"));
+}
+
+BENCHMARK(BM_TrendlineEstimator);
+BENCHMARK(BM_LossBasedBweV2);
+BENCHMARK(BM_LossBasedBweV2ObservationPerReport);
+
+}  // namespace
+}  // namespace webrtc
@@ -0,0 +1,118 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/congestion_controller/goog_cc/ecn_based_bwe.h"
+
+#include <algorithm>
+#include <memory>
+
+#include "api/transport/ecn_marking.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+namespace {
+EcnBasedBweConfig GetConfigFromTrials(const FieldTrialsView* key_value_config) {
+  EcnBasedBweConfig config;
+  config.Parser()->Parse(
+      key_value_config->Lookup("WebRTC-Bwe-EcnScalableResponse"));
+  return config;
+}
+}  // namespace
+
+std::unique_ptr<StructParametersParser> EcnBasedBweConfig::Parser() {
+  return StructParametersParser::Create(       //
+      "Enabled", &enabled,                     //
+      "alpha_gain", &alpha_gain,               //
+      "initial_alpha", &initial_alpha,         //
+      "additive_increase", &additive_increase,  //
+      "min_increase_rtt", &min_increase_rtt);
+}
+
+EcnBasedBwe::EcnBasedBwe(const FieldTrialsView* key_value_config)
+    : EcnBasedBwe(GetConfigFromTrials(key_value_config)) {}
+
+EcnBasedBwe::EcnBasedBwe(EcnBasedBweConfig config)
+    : config_(config), alpha_(config.initial_alpha) {
+  RTC_DCHECK_GT(config_.alpha_gain, 0.0);
+  RTC_DCHECK_LE(config_.alpha_gain, 1.0);
+}
+
+EcnBasedBwe::~EcnBasedBwe() = default;
+
+bool EcnBasedBwe::OnTransportPacketsFeedback(
+    const TransportPacketsFeedback& report,
+    absl::optional<DataRate> acknowledged_rate,
+    TimeDelta rtt) {
+  RTC_DCHECK(config_.enabled);
+  int ect_packets = 0;
+  int ce_packets = 0;
+  for (const PacketResult& packet : report.packet_feedbacks) {
+    if (!packet.IsReceived() || packet.ecn == EcnMarking::kNotEct) {
+      continue;
+    }
+    ++ect_packets;
+    if (packet.ecn == EcnMarking::kCe) {
+      ++ce_packets;
+    }
+  }
+  const Timestamp now = report.feedback_time;
+  const Timestamp last_feedback_time = last_feedback_time_;
+  last_feedback_time_ = now;
+  if (ect_packets == 0) {
+    // Without ECN capable packets, there is nothing to say about the
+    // congestion of the path.
+    return false;
+  }
+
+  if (window_start_.IsInfinite()) {
+    window_start_ = now;
+  }
+  ect_packets_in_window_ += ect_packets;
+  ce_packets_in_window_ += ce_packets;
+  if (now - window_start_ >= rtt) {
+    const double marked_fraction =
+        static_cast<double>(ce_packets_in_window_) / ect_packets_in_window_;
+    alpha_ = (1 - config_.alpha_gain) * alpha_ +
+             config_.alpha_gain * marked_fraction;
+    window_start_ = now;
+    ect_packets_in_window_ = 0;
+    ce_packets_in_window_ = 0;
+  }
+
+  if (ce_packets > 0) {
+    // Only the first mark of a round trip reduces the limit, the marks that
+    // follow it are likely caused by packets that were sent before the
+    // reduction.
+    if (now - last_reduction_time_ < rtt) {
+      return false;
+    }
+    DataRate rate = limit_;
+    if (acknowledged_rate) {
+      rate = std::min(rate, *acknowledged_rate);
+    }
+    if (rate.IsInfinite()) {
+      return false;
+    }
+    limit_ = rate * (1 - alpha_ / 2);
+    last_reduction_time_ = now;
+    return true;
+  }
+
+  if (limit_.IsInfinite() || last_feedback_time.IsInfinite()) {
+    return false;
+  }
+  const TimeDelta increase_rtt = std::max(rtt, config_.min_increase_rtt);
+  limit_ += config_.additive_increase / increase_rtt *
+            ((now - last_feedback_time) / increase_rtt);
+  return true;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,85 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_CONGESTION_CONTROLLER_GOOG_CC_ECN_BASED_BWE_H_
+#define MODULES_CONGESTION_CONTROLLER_GOOG_CC_ECN_BASED_BWE_H_
+
+#include <memory>
+
+#include "absl/types/optional.h"
+#include "api/field_trials_view.h"
+#include "api/transport/network_types.h"
+#include "api/units/data_rate.h"
+#include "api/units/data_size.h"
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "rtc_base/experiments/struct_parameters_parser.h"
+
+namespace webrtc {
+
+struct EcnBasedBweConfig {
+  bool enabled = false;
+  // Gain of the moving average of the fraction of CE marked packets.
+  double alpha_gain = 1.0 / 16;
+  // Like DCTCP, start with the largest reduction until there are some marks.
+  double initial_alpha = 1.0;
+  // The limit grows by this much data per round trip while there are no CE
+  // marks.
+  DataSize additive_increase = DataSize::Bytes(1200);
+  // The round trip time is at least this long when growing the limit, which
+  // makes the growth independent of the round trip time on short paths.
+  TimeDelta min_increase_rtt = TimeDelta::Millis(25);
+  std::unique_ptr<StructParametersParser> Parser();
+};
+
+// Scalable congestion response to the CE marks of L4S queues, see
+// https://www.rfc-editor.org/rfc/rfc9331. Like DCTCP (RFC 8257), the limit is
+// reduced in proportion to the fraction of marked packets, at most once per
+// round trip, which makes for small and frequent reductions instead of the
+// large and rare ones of the delay and loss based estimators. The limit grows
+// additively while there are no marks.
+// Note: This class is not thread-safe.
+class EcnBasedBwe {
+ public:
+  explicit EcnBasedBwe(const FieldTrialsView* key_value_config);
+  explicit EcnBasedBwe(EcnBasedBweConfig config);
+  ~EcnBasedBwe();
+
+  bool enabled() const { return config_.enabled; }
+
+  // Reduces the limit on the first CE mark of a round trip and grows it when
+  // there are no marks. Returns true if the limit changed.
+  bool OnTransportPacketsFeedback(const TransportPacketsFeedback& report,
+                                  absl::optional<DataRate> acknowledged_rate,
+                                  TimeDelta rtt);
+
+  // Plus infinity until the first CE mark.
+  DataRate limit() const { return limit_; }
+  // The moving average of the fraction of ECN capable packets that were CE
+  // marked.
+  double alpha() const { return alpha_; }
+
+ private:
+  const EcnBasedBweConfig config_;
+
+  DataRate limit_ = DataRate::PlusInfinity();
+  double alpha_;
+  Timestamp last_reduction_time_ = Timestamp::MinusInfinity();
+
+  // The observation window, about one round trip long.
+  Timestamp window_start_ = Timestamp::MinusInfinity();
+  int ect_packets_in_window_ = 0;
+  int ce_packets_in_window_ = 0;
+  Timestamp last_feedback_time_ = Timestamp::MinusInfinity();
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_CONGESTION_CONTROLLER_GOOG_CC_ECN_BASED_BWE_H_
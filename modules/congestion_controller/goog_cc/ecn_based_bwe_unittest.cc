@@ -0,0 +1,218 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/congestion_controller/goog_cc/ecn_based_bwe.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "api/test/simulated_network.h"
+#include "api/transport/ecn_marking.h"
+#include "api/transport/network_types.h"
+#include "api/units/data_rate.h"
+#include "api/units/data_size.h"
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "call/simulated_network.h"
+#include "test/explicit_key_value_config.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr TimeDelta kRtt = TimeDelta::Millis(50);
+constexpr DataSize kPacketSize = DataSize::Bytes(1200);
+
+EcnBasedBweConfig EnabledConfig() {
+  EcnBasedBweConfig config;
+  config.enabled = true;
+  return config;
+}
+
+// Feedback about `num_packets` packets with the given marking, of which the
+// first `num_ce` are CE marked.
+TransportPacketsFeedback CreateFeedback(Timestamp feedback_time,
+                                        int num_packets,
+                                        int num_ce,
+                                        EcnMarking marking) {
+  TransportPacketsFeedback feedback;
+  feedback.feedback_time = feedback_time;
+  for (int i = 0; i < num_packets; ++i) {
+    PacketResult packet;
+    packet.sent_packet.send_time = feedback_time - kRtt;
+    packet.sent_packet.size = kPacketSize;
+    packet.receive_time = feedback_time - kRtt / 2;
+    packet.ecn = i < num_ce ? EcnMarking::kCe : marking;
+    feedback.packet_feedbacks.push_back(packet);
+  }
+  return feedback;
+}
+
+TEST(EcnBasedBweTest, ParsesFieldTrial) {
+  test::ExplicitKeyValueConfig field_trials(
+      "WebRTC-Bwe-EcnScalableResponse/Enabled:true,alpha_gain:0.25/");
+  EcnBasedBwe ecn_based_bwe(&field_trials);
+  EXPECT_TRUE(ecn_based_bwe.enabled());
+
+  test::ExplicitKeyValueConfig no_field_trials("");
+  EXPECT_FALSE(EcnBasedBwe(&no_field_trials).enabled());
+}
+
+TEST(EcnBasedBweTest, NoLimitWithoutMarks) {
+  EcnBasedBwe ecn_based_bwe(EnabledConfig());
+  Timestamp now = Timestamp::Seconds(1);
+  for (int i = 0; i < 10; ++i) {
+    now += kRtt;
+    EXPECT_FALSE(ecn_based_bwe.OnTransportPacketsFeedback(
+        CreateFeedback(now, 10, 0, EcnMarking::kEct1),
+        DataRate::KilobitsPerSec(1000), kRtt));
+  }
+  EXPECT_TRUE(ecn_based_bwe.limit().IsPlusInfinity());
+}
+
+TEST(EcnBasedBweTest, IgnoresMarksOfPacketsThatAreNotEcnCapable) {
+  EcnBasedBwe ecn_based_bwe(EnabledConfig());
+  TransportPacketsFeedback feedback = CreateFeedback(
+      Timestamp::Seconds(1), 10, 0, EcnMarking::kNotEct);
+  EXPECT_FALSE(ecn_based_bwe.OnTransportPacketsFeedback(
+      feedback, DataRate::KilobitsPerSec(1000), kRtt));
+  EXPECT_TRUE(ecn_based_bwe.limit().IsPlusInfinity());
+}
+
+TEST(EcnBasedBweTest, ReducesLimitOncePerRoundTrip) {
+  EcnBasedBweConfig config = EnabledConfig();
+  config.initial_alpha = 0.5;
+  EcnBasedBwe ecn_based_bwe(config);
+  const DataRate kAcknowledgedRate = DataRate::KilobitsPerSec(1000);
+  Timestamp now = Timestamp::Seconds(1);
+
+  EXPECT_TRUE(ecn_based_bwe.OnTransportPacketsFeedback(
+      CreateFeedback(now, 10, 1, EcnMarking::kEct1), kAcknowledgedRate, kRtt));
+  // The reduction is half of alpha.
+  EXPECT_EQ(ecn_based_bwe.limit(), kAcknowledgedRate * 0.75);
+
+  // Marks within the same round trip are from packets sent before the
+  // reduction.
+  now += kRtt / 2;
+  EXPECT_FALSE(ecn_based_bwe.OnTransportPacketsFeedback(
+      CreateFeedback(now, 10, 1, EcnMarking::kEct1), kAcknowledgedRate, kRtt));
+  EXPECT_EQ(ecn_based_bwe.limit(), kAcknowledgedRate * 0.75);
+
+  now += kRtt / 2;
+  EXPECT_TRUE(ecn_based_bwe.OnTransportPacketsFeedback(
+      CreateFeedback(now, 10, 1, EcnMarking::kEct1), kAcknowledgedRate, kRtt));
+  EXPECT_LT(ecn_based_bwe.limit(), kAcknowledgedRate * 0.75);
+}
+
+TEST(EcnBasedBweTest, AlphaFollowsFractionOfMarkedPackets) {
+  EcnBasedBwe ecn_based_bwe(EnabledConfig());
+  Timestamp now = Timestamp::Seconds(1);
+  for (int i = 0; i < 200; ++i) {
+    now += kRtt;
+    ecn_based_bwe.OnTransportPacketsFeedback(
+        CreateFeedback(now, 10, 1, EcnMarking::kEct1),
+        DataRate::KilobitsPerSec(1000), kRtt);
+  }
+  EXPECT_NEAR(ecn_based_bwe.alpha(), 0.1, 0.01);
+}
+
+TEST(EcnBasedBweTest, GrowsLimitAdditivelyWithoutMarks) {
+  EcnBasedBwe ecn_based_bwe(EnabledConfig());
+  Timestamp now = Timestamp::Seconds(1);
+  ecn_based_bwe.OnTransportPacketsFeedback(
+      CreateFeedback(now, 10, 10, EcnMarking::kEct1),
+      DataRate::KilobitsPerSec(1000), kRtt);
+  const DataRate limit = ecn_based_bwe.limit();
+  ASSERT_TRUE(limit.IsFinite());
+
+  // One round trip without marks grows the limit by one packet per round
+  // trip.
+  now += kRtt;
+  EXPECT_TRUE(ecn_based_bwe.OnTransportPacketsFeedback(
+      CreateFeedback(now, 10, 0, EcnMarking::kEct1),
+      DataRate::KilobitsPerSec(1000), kRtt));
+  EXPECT_EQ(ecn_based_bwe.limit(), limit + kPacketSize / kRtt);
+}
+
+// Sends ECN capable packets at the limit over a link that marks packets that
+// are queued for more than 5 ms, with feedback once per round trip.
+TEST(EcnBasedBweTest, KeepsQueueShortOnMarkingLink) {
+  constexpr DataRate kLinkCapacity = DataRate::KilobitsPerSec(1000);
+  constexpr TimeDelta kStep = TimeDelta::Millis(5);
+  SimulatedNetwork network({.queue_delay_ms = 0,
+                            .link_capacity_kbps = kLinkCapacity.kbps<int>(),
+                            .ecn_marking_threshold_ms = 5});
+  EcnBasedBwe ecn_based_bwe(EnabledConfig());
+
+  // The sender starts at twice the link capacity.
+  DataRate send_rate = 2 * kLinkCapacity;
+  DataSize send_budget = DataSize::Zero();
+  std::map<uint64_t, Timestamp> send_times;
+  uint64_t next_packet_id = 0;
+  TransportPacketsFeedback feedback;
+  DataSize acknowledged_size = DataSize::Zero();
+  Timestamp last_feedback_time = Timestamp::Zero();
+  TimeDelta max_queue_delay = TimeDelta::Zero();
+  DataSize received_size = DataSize::Zero();
+  const Timestamp kMeasurementStart = Timestamp::Seconds(5);
+  const Timestamp kEnd = Timestamp::Seconds(20);
+
+  for (Timestamp now = Timestamp::Zero(); now < kEnd; now += kStep) {
+    send_budget += send_rate * kStep;
+    for (; send_budget >= kPacketSize; send_budget -= kPacketSize) {
+      PacketInFlightInfo packet(kPacketSize.bytes(), now.us(),
+                                next_packet_id);
+      packet.ecn = EcnMarking::kEct1;
+      ASSERT_TRUE(network.EnqueuePacket(packet));
+      send_times.emplace(next_packet_id++, now);
+    }
+
+    for (const PacketDeliveryInfo& delivered :
+         network.DequeueDeliverablePackets(now.us())) {
+      auto sent = send_times.find(delivered.packet_id);
+      ASSERT_NE(sent, send_times.end());
+      PacketResult packet;
+      packet.sent_packet.send_time = sent->second;
+      packet.sent_packet.size = kPacketSize;
+      packet.receive_time = Timestamp::Micros(delivered.receive_time_us);
+      packet.ecn = delivered.ecn;
+      feedback.packet_feedbacks.push_back(packet);
+      acknowledged_size += kPacketSize;
+      send_times.erase(sent);
+      if (now >= kMeasurementStart) {
+        max_queue_delay =
+            std::max(max_queue_delay,
+                     packet.receive_time - packet.sent_packet.send_time);
+        received_size += kPacketSize;
+      }
+    }
+
+    if (now - last_feedback_time >= kRtt) {
+      feedback.feedback_time = now;
+      const DataRate acknowledged_rate =
+          acknowledged_size / (now - last_feedback_time);
+      ecn_based_bwe.OnTransportPacketsFeedback(feedback, acknowledged_rate,
+                                               kRtt);
+      feedback.packet_feedbacks.clear();
+      acknowledged_size = DataSize::Zero();
+      last_feedback_time = now;
+      send_rate = std::min(2 * kLinkCapacity, ecn_based_bwe.limit());
+    }
+  }
+
+  EXPECT_LT(max_queue_delay, TimeDelta::Millis(50));
+  EXPECT_GT(received_size / (kEnd - kMeasurementStart), 0.8 * kLinkCapacity);
+}
+
+}  // namespace
+}  // namespace webrtc
@@ -35,6 +35,7 @@
 #include "modules/congestion_controller/goog_cc/alr_detector.h"
 #include "modules/congestion_controller/goog_cc/congestion_window_pushback_controller.h"
 #include "modules/congestion_controller/goog_cc/delay_based_bwe.h"
+#include "modules/congestion_controller/goog_cc/ecn_based_bwe.h"
 #include "modules/congestion_controller/goog_cc/loss_based_bwe_v2.h"
 #include "modules/congestion_controller/goog_cc/probe_bitrate_estimator.h"
 #include "modules/congestion_controller/goog_cc/probe_controller.h"
@@ -138,6 +139,7 @@ GoogCcNetworkController::GoogCcNetworkController(NetworkControllerConfig config,
       delay_based_bwe_(new DelayBasedBwe(key_value_config_,
                                          event_log_,
                                          network_state_predictor_.get())),
+      ecn_based_bwe_(std::make_unique<EcnBasedBwe>(key_value_config_)),
       acknowledged_bitrate_estimator_(
           AcknowledgedBitrateEstimatorInterface::Create(key_value_config_)),
       initial_config_(config),
@@ -196,6 +198,7 @@ NetworkControlUpdate GoogCcNetworkController::OnNetworkRouteChange(
     network_estimator_->OnRouteChange(msg);
   delay_based_bwe_.reset(new DelayBasedBwe(key_value_config_, event_log_,
                                            network_state_predictor_.get()));
+  ecn_based_bwe_ = std::make_unique<EcnBasedBwe>(key_value_config_);
   bandwidth_estimation_->OnRouteChange();
   probe_controller_->Reset(msg.at_time);
   NetworkControlUpdate update;
@@ -563,22 +566,38 @@ NetworkControlUpdate GoogCcNetworkController::OnTransportPacketsFeedback(
   result = delay_based_bwe_->IncomingPacketFeedbackVector(
       report, acknowledged_bitrate, probe_bitrate, estimate_,
       alr_start_time.has_value());
-
-  if (result.updated) {
-    if (result.probe) {
+  // The ECN based limit reacts to the marks of L4S queues before the delay
+  // based estimate sees the queue grow, and caps it.
+  const bool ecn_limit_updated =
+      ecn_based_bwe_->enabled() &&
+      ecn_based_bwe_->OnTransportPacketsFeedback(
+          report, acknowledged_bitrate,
+          bandwidth_estimation_->round_trip_time());
+
+  if (result.updated || ecn_limit_updated) {
+    if (result.updated && result.probe) {
       bandwidth_estimation_->SetSendBitrate(result.target_bitrate,
                                             report.feedback_time);
     }
+    DataRate delay_based_limit = result.updated
+                                     ? result.target_bitrate
+                                     : delay_based_bwe_->last_estimate();
+    if (ecn_based_bwe_->enabled()) {
+      if (delay_based_limit.IsZero()) {
+        delay_based_limit = DataRate::PlusInfinity();
+      }
+      delay_based_limit = std::min(delay_based_limit, ecn_based_bwe_->limit());
+    }
     // Since SetSendBitrate now resets the delay-based estimate, we have to
     // call UpdateDelayBasedEstimate after SetSendBitrate.
     bandwidth_estimation_->UpdateDelayBasedEstimate(report.feedback_time,
-                                                    result.target_bitrate);
+                                                    delay_based_limit);
   }
   bandwidth_estimation_->UpdateLossBasedEstimator(
       report, result.delay_detector_state, probe_bitrate,
       estimate_ ? estimate_->link_capacity_upper : DataRate::PlusInfinity(),
       alr_start_time.has_value());
-  if (result.updated) {
+  if (result.updated || ecn_limit_updated) {
     // Update the estimate in the ProbeController, in case we want to probe.
     MaybeTriggerOnNetworkChanged(&update, report.feedback_time);
   }
@@ -21,6 +21,7 @@
 #include "absl/types/optional.h"
 #include "api/test/network_emulation/create_cross_traffic.h"
 #include "api/test/network_emulation/cross_traffic.h"
+#include "api/transport/ecn_marking.h"
 #include "api/transport/goog_cc_factory.h"
 #include "api/transport/network_control.h"
 #include "api/transport/network_types.h"
@@ -421,6 +422,32 @@ TEST(GoogCcNetworkControllerTest, UpdatesDelayBasedEstimate) {
   EXPECT_LT(*target_bitrate_after_delay, *target_bitrate_before_delay);
 }
 
+TEST(GoogCcNetworkControllerTest, ReducesTargetRateOnEcnMarksInTrial) {
+  ScopedFieldTrials trial("WebRTC-Bwe-EcnScalableResponse/Enabled:true/");
+  NetworkControllerTestFixture fixture;
+  std::unique_ptr<NetworkControllerInterface> controller =
+      fixture.CreateController();
+  Timestamp current_time = Timestamp::Millis(123);
+  absl::optional<DataRate> target_bitrate_before_marks =
+      PacketTransmissionAndFeedbackBlock(controller.get(), /*runtime_ms=*/6000,
+                                         /*delay=*/0, current_time);
+  ASSERT_TRUE(target_bitrate_before_marks.has_value());
+
+  // A CE marked packet, without any delay build up.
+  PacketResult packet = CreatePacketResult(current_time, current_time,
+                                           /*payload_size=*/1000,
+                                           PacedPacketInfo());
+  packet.ecn = EcnMarking::kCe;
+  controller->OnSentPacket(packet.sent_packet);
+  TransportPacketsFeedback feedback;
+  feedback.feedback_time = packet.receive_time;
+  feedback.packet_feedbacks.push_back(packet);
+  NetworkControlUpdate update =
+      controller->OnTransportPacketsFeedback(feedback);
+  ASSERT_TRUE(update.target_rate);
+  EXPECT_LT(update.target_rate->target_rate, *target_bitrate_before_marks);
+}
+
 TEST(GoogCcNetworkControllerTest, PaceAtMaxOfLowerLinkCapacityAndBwe) {
   ScopedFieldTrials trial(
       "WebRTC-Bwe-PaceAtMaxOfBweAndLowerLinkCapacity/Enabled/");
@@ -950,6 +977,30 @@ TEST(GoogCcScenario, IsFairToTCP) {
   EXPECT_LT(client->send_bandwidth().kbps(), 750);
 }
 
+TEST(GoogCcScenario, LimitsTargetRateToEcnMarkingLinkCapacity) {
+  // The receiver reports the ECN marks in RFC 8888 feedback, and the sender
+  // sends as ECT(1) and responds to the marks with the EcnBasedBwe.
+  ScopedFieldTrials trial(
+      "WebRTC-RFC8888CongestionControlFeedback/Enabled/"
+      "WebRTC-Bwe-EcnScalableResponse/Enabled:true/");
+  const DataRate kLinkCapacity = DataRate::KilobitsPerSec(1000);
+  Scenario s("googcc_unit/ecn_marking_link", false);
+  auto* send_net = s.CreateSimulationNode([&](NetworkSimulationConfig* c) {
+    c->bandwidth = kLinkCapacity;
+    c->delay = TimeDelta::Millis(25);
+    c->ecn_marking_threshold = TimeDelta::Millis(5);
+  });
+  auto* ret_net = s.CreateSimulationNode(
+      [](NetworkSimulationConfig* c) { c->delay = TimeDelta::Millis(25); });
+  CallClientConfig config;
+  config.transport.rates.start_rate = 2 * kLinkCapacity;
+  auto* client = CreateVideoSendingClient(&s, config, {send_net}, {ret_net});
+
+  s.RunFor(TimeDelta::Seconds(20));
+  EXPECT_LT(client->target_rate(), kLinkCapacity);
+  EXPECT_GT(client->target_rate(), kLinkCapacity / 2);
+}
+
 TEST(GoogCcScenario, FastRampupOnRembCapLifted) {
   DataRate final_estimate =
       RunRembDipScenario("googcc_unit/default_fast_rampup_on_remb_cap_lifted");
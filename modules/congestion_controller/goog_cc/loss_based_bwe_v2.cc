@@ -77,29 +77,37 @@ PacketResultsSummary GetPacketResultsSummary(
   return packet_results_summary;
 }
 
-double GetLossProbability(double inherent_loss,
-                          DataRate loss_limited_bandwidth,
-                          DataRate sending_rate) {
+double GetValidInherentLoss(double inherent_loss) {
   if (inherent_loss < 0.0 || inherent_loss > 1.0) {
     RTC_LOG(LS_WARNING) << "The inherent loss must be in [0,1]: "
                         << inherent_loss;
     inherent_loss = std::min(std::max(inherent_loss, 0.0), 1.0);
   }
-  if (!sending_rate.IsFinite()) {
-    RTC_LOG(LS_WARNING) << "The sending rate must be finite: "
-                        << ToString(sending_rate);
-  }
+  return inherent_loss;
+}
+
+// Returns infinity for an invalid bandwidth, which is never exceeded.
+double GetLossLimitedBandwidthBps(DataRate loss_limited_bandwidth) {
   if (!loss_limited_bandwidth.IsFinite()) {
     RTC_LOG(LS_WARNING) << "The loss limited bandwidth must be finite: "
                         << ToString(loss_limited_bandwidth);
+    return std::numeric_limits<double>::infinity();
   }
+  return loss_limited_bandwidth.bps<double>();
+}
 
-  double loss_probability = inherent_loss;
-  if (IsValid(sending_rate) && IsValid(loss_limited_bandwidth) &&
-      (sending_rate > loss_limited_bandwidth)) {
-    loss_probability += (1 - inherent_loss) *
-                        (sending_rate - loss_limited_bandwidth) / sending_rate;
-  }
+// Written without branches so that the loops calling it can be vectorized. A
+// sending rate of zero, used for invalid sending rates, never exceeds the
+// bandwidth.
+double GetLossProbability(double inherent_loss,
+                          double loss_limited_bandwidth_bps,
+                          double sending_rate_bps) {
+  const double loss_probability =
+      inherent_loss + (1 - inherent_loss) *
+                          std::max(sending_rate_bps -
+                                       loss_limited_bandwidth_bps,
+                                   0.0) /
+                          std::max(sending_rate_bps, 1.0);
   return std::min(std::max(loss_probability, 1.0e-6), 1.0 - 1.0e-6);
 }
 
@@ -121,6 +129,12 @@ LossBasedBweV2::LossBasedBweV2(const FieldTrialsView* key_value_config)
 
   current_estimate_.inherent_loss = config_->initial_inherent_loss_estimate;
   observations_.resize(config_->observation_window_size);
+  observation_arrays_.weighted_num_lost_packets.reserve(
+      config_->observation_window_size);
+  observation_arrays_.weighted_num_received_packets.reserve(
+      config_->observation_window_size);
+  observation_arrays_.sending_rates_bps.reserve(
+      config_->observation_window_size);
   temporal_weights_.resize(config_->observation_window_size);
   instant_upper_bound_temporal_weights_.resize(
       config_->observation_window_size);
@@ -712,6 +726,10 @@ bool LossBasedBweV2::IsConfigValid() const {
 }
 
 double LossBasedBweV2::GetAverageReportedLossRatio() const {
+  return average_reported_loss_ratio_;
+}
+
+double LossBasedBweV2::CalculateAverageReportedLossRatio() const {
   if (num_observations_ <= 0) {
     return 0.0;
   }
@@ -820,28 +838,27 @@ std::vector<LossBasedBweV2::ChannelParameters> LossBasedBweV2::GetCandidates(
 LossBasedBweV2::Derivatives LossBasedBweV2::GetDerivatives(
     const ChannelParameters& channel_parameters) const {
   Derivatives derivatives;
-
-  for (const Observation& observation : observations_) {
-    if (!observation.IsInitialized()) {
-      continue;
-    }
-
-    double loss_probability = GetLossProbability(
-        channel_parameters.inherent_loss,
-        channel_parameters.loss_limited_bandwidth, observation.sending_rate);
-
-    double temporal_weight =
-        temporal_weights_[(num_observations_ - 1) - observation.id];
+  const double inherent_loss =
+      GetValidInherentLoss(channel_parameters.inherent_loss);
+  const double loss_limited_bandwidth_bps =
+      GetLossLimitedBandwidthBps(channel_parameters.loss_limited_bandwidth);
+  const ObservationArrays& observations = observation_arrays_;
+  for (size_t i = 0; i < observations.sending_rates_bps.size(); ++i) {
+    const double loss_probability =
+        GetLossProbability(inherent_loss, loss_limited_bandwidth_bps,
+                           observations.sending_rates_bps[i]);
+    const double weighted_num_lost_packets =
+        observations.weighted_num_lost_packets[i];
+    const double weighted_num_received_packets =
+        observations.weighted_num_received_packets[i];
 
     derivatives.first +=
-        temporal_weight *
-        ((observation.num_lost_packets / loss_probability) -
-         (observation.num_received_packets / (1.0 - loss_probability)));
+        (weighted_num_lost_packets / loss_probability) -
+        (weighted_num_received_packets / (1.0 - loss_probability));
     derivatives.second -=
-        temporal_weight *
-        ((observation.num_lost_packets / std::pow(loss_probability, 2)) +
-         (observation.num_received_packets /
-          std::pow(1.0 - loss_probability, 2)));
+        (weighted_num_lost_packets / (loss_probability * loss_probability)) +
+        (weighted_num_received_packets /
+         ((1.0 - loss_probability) * (1.0 - loss_probability)));
   }
 
   if (derivatives.second >= 0.0) {
@@ -898,31 +915,41 @@ double LossBasedBweV2::GetHighBandwidthBias(DataRate bandwidth) const {
 double LossBasedBweV2::GetObjective(
     const ChannelParameters& channel_parameters) const {
   double objective = 0.0;
-
-  const double high_bandwidth_bias =
-      GetHighBandwidthBias(channel_parameters.loss_limited_bandwidth);
-
-  for (const Observation& observation : observations_) {
-    if (!observation.IsInitialized()) {
+  const double inherent_loss =
+      GetValidInherentLoss(channel_parameters.inherent_loss);
+  const double loss_limited_bandwidth_bps =
+      GetLossLimitedBandwidthBps(channel_parameters.loss_limited_bandwidth);
+  // The loss probability of all observations sent below the bandwidth is the
+  // same, so their logarithms only need to be computed once.
+  double weighted_num_lost_packets_below_bandwidth = 0.0;
+  double weighted_num_received_packets_below_bandwidth = 0.0;
+  const ObservationArrays& observations = observation_arrays_;
+  for (size_t i = 0; i < observations.sending_rates_bps.size(); ++i) {
+    if (observations.sending_rates_bps[i] <= loss_limited_bandwidth_bps) {
+      weighted_num_lost_packets_below_bandwidth +=
+          observations.weighted_num_lost_packets[i];
+      weighted_num_received_packets_below_bandwidth +=
+          observations.weighted_num_received_packets[i];
       continue;
     }
+    const double loss_probability =
+        GetLossProbability(inherent_loss, loss_limited_bandwidth_bps,
+                           observations.sending_rates_bps[i]);
+    objective += (observations.weighted_num_lost_packets[i] *
+                  std::log(loss_probability)) +
+                 (observations.weighted_num_received_packets[i] *
+                  std::log(1.0 - loss_probability));
+  }
+  const double loss_probability_below_bandwidth = GetLossProbability(
+      inherent_loss, loss_limited_bandwidth_bps, /*sending_rate_bps=*/0.0);
+  objective += (weighted_num_lost_packets_below_bandwidth *
+                std::log(loss_probability_below_bandwidth)) +
+               (weighted_num_received_packets_below_bandwidth *
+                std::log(1.0 - loss_probability_below_bandwidth));
 
-    double loss_probability = GetLossProbability(
-        channel_parameters.inherent_loss,
-        channel_parameters.loss_limited_bandwidth, observation.sending_rate);
-
-    double temporal_weight =
-        temporal_weights_[(num_observations_ - 1) - observation.id];
-
-    objective +=
-        temporal_weight *
-        ((observation.num_lost_packets * std::log(loss_probability)) +
-         (observation.num_received_packets * std::log(1.0 - loss_probability)));
-    objective +=
-        temporal_weight * high_bandwidth_bias * observation.num_packets;
-  }
-
-  return objective;
+  const double high_bandwidth_bias =
+      GetHighBandwidthBias(channel_parameters.loss_limited_bandwidth);
+  return objective + high_bandwidth_bias * observations.weighted_num_packets;
 }
 
 DataRate LossBasedBweV2::GetSendingRate(
@@ -982,6 +1009,34 @@ void LossBasedBweV2::CalculateTemporalWeights() {
   }
 }
 
+void LossBasedBweV2::UpdateObservationArrays() {
+  ObservationArrays& arrays = observation_arrays_;
+  arrays.weighted_num_lost_packets.clear();
+  arrays.weighted_num_received_packets.clear();
+  arrays.sending_rates_bps.clear();
+  arrays.weighted_num_packets = 0.0;
+  for (const Observation& observation : observations_) {
+    if (!observation.IsInitialized()) {
+      continue;
+    }
+    const double temporal_weight =
+        temporal_weights_[(num_observations_ - 1) - observation.id];
+    arrays.weighted_num_lost_packets.push_back(temporal_weight *
+                                               observation.num_lost_packets);
+    arrays.weighted_num_received_packets.push_back(
+        temporal_weight * observation.num_received_packets);
+    arrays.weighted_num_packets += temporal_weight * observation.num_packets;
+    if (IsValid(observation.sending_rate)) {
+      arrays.sending_rates_bps.push_back(
+          observation.sending_rate.bps<double>());
+    } else {
+      RTC_LOG(LS_WARNING) << "The sending rate must be finite: "
+                          << ToString(observation.sending_rate);
+      arrays.sending_rates_bps.push_back(0.0);
+    }
+  }
+}
+
 void LossBasedBweV2::NewtonsMethodUpdate(
     ChannelParameters& channel_parameters) const {
   if (num_observations_ <= 0) {
@@ -1082,6 +1137,8 @@ bool LossBasedBweV2::PushBackObservation(
 
   partial_observation_ = PartialObservation();
 
+  UpdateObservationArrays();
+  average_reported_loss_ratio_ = CalculateAverageReportedLossRatio();
   CalculateInstantUpperBound();
   return true;
 }
@@ -139,12 +139,25 @@ class LossBasedBweV2 {
     DataSize size = DataSize::Zero();
   };
 
+  // The initialized observations, laid out as one array per field for the
+  // loops over all observations in GetObjective() and GetDerivatives(), which
+  // run several times per candidate. The packet counts are multiplied by the
+  // temporal weight of the observation.
+  struct ObservationArrays {
+    std::vector<double> weighted_num_lost_packets;
+    std::vector<double> weighted_num_received_packets;
+    // Zero for observations with an invalid sending rate.
+    std::vector<double> sending_rates_bps;
+    double weighted_num_packets = 0.0;
+  };
+
   static absl::optional<Config> CreateConfig(
       const FieldTrialsView* key_value_config);
   bool IsConfigValid() const;
 
   // Returns `0.0` if not enough loss statistics have been received.
   double GetAverageReportedLossRatio() const;
+  double CalculateAverageReportedLossRatio() const;
   std::vector<ChannelParameters> GetCandidates(bool in_alr) const;
   DataRate GetCandidateBandwidthUpperBound() const;
   Derivatives GetDerivatives(const ChannelParameters& channel_parameters) const;
@@ -159,6 +172,7 @@ class LossBasedBweV2 {
   void CalculateInstantUpperBound();
 
   void CalculateTemporalWeights();
+  void UpdateObservationArrays();
   void NewtonsMethodUpdate(ChannelParameters& channel_parameters) const;
 
   // Returns false if there exists a kBwOverusing or kBwUnderusing in the
@@ -186,6 +200,8 @@ class LossBasedBweV2 {
   ChannelParameters current_estimate_;
   int num_observations_ = 0;
   std::vector<Observation> observations_;
+  ObservationArrays observation_arrays_;
+  double average_reported_loss_ratio_ = 0.0;
   PartialObservation partial_observation_;
   Timestamp last_send_time_most_recent_observation_ = Timestamp::PlusInfinity();
   Timestamp last_time_estimate_reduced_ = Timestamp::MinusInfinity();
@@ -57,32 +57,6 @@ size_t ReadTrendlineFilterWindowSize(const FieldTrialsView* key_value_config) {
   return TrendlineEstimatorSettings::kDefaultTrendlineWindowSize;
 }
 
-absl::optional<double> LinearFitSlope(
-    const std::deque<TrendlineEstimator::PacketTiming>& packets) {
-  RTC_DCHECK(packets.size() >= 2);
-  // Compute the "center of mass".
-  double sum_x = 0;
-  double sum_y = 0;
-  for (const auto& packet : packets) {
-    sum_x += packet.arrival_time_ms;
-    sum_y += packet.smoothed_delay_ms;
-  }
-  double x_avg = sum_x / packets.size();
-  double y_avg = sum_y / packets.size();
-  // Compute the slope k = \sum (x_i-x_avg)(y_i-y_avg) / \sum (x_i-x_avg)^2
-  double numerator = 0;
-  double denominator = 0;
-  for (const auto& packet : packets) {
-    double x = packet.arrival_time_ms;
-    double y = packet.smoothed_delay_ms;
-    numerator += (x - x_avg) * (y - y_avg);
-    denominator += (x - x_avg) * (x - x_avg);
-  }
-  if (denominator == 0)
-    return absl::nullopt;
-  return numerator / denominator;
-}
-
 absl::optional<double> ComputeSlopeCap(
     const std::deque<TrendlineEstimator::PacketTiming>& packets,
     const TrendlineEstimatorSettings& settings) {
@@ -176,6 +150,9 @@ TrendlineEstimator::TrendlineEstimator(
       accumulated_delay_(0),
       smoothed_delay_(0),
       delay_hist_(),
+      regression_origin_(0.0, 0.0, 0.0),
+      regression_sums_(),
+      updates_since_regression_reset_(0),
       k_up_(0.0087),
       k_down_(0.039),
       overusing_time_threshold_(kOverUsingTimeThreshold),
@@ -221,6 +198,7 @@ void TrendlineEstimator::UpdateTrendline(double recv_delta_ms,
   delay_hist_.emplace_back(
       static_cast<double>(arrival_time_ms - first_arrival_time_ms_),
       smoothed_delay_, accumulated_delay_);
+  AddToRegression(delay_hist_.back());
   if (settings_.enable_sort) {
     for (size_t i = delay_hist_.size() - 1;
          i > 0 &&
@@ -229,8 +207,13 @@ void TrendlineEstimator::UpdateTrendline(double recv_delta_ms,
       std::swap(delay_hist_[i], delay_hist_[i - 1]);
     }
   }
-  if (delay_hist_.size() > settings_.window_size)
+  if (delay_hist_.size() > settings_.window_size) {
+    RemoveFromRegression(delay_hist_.front());
     delay_hist_.pop_front();
+  }
+  if (++updates_since_regression_reset_ >= settings_.window_size) {
+    ResetRegression();
+  }
 
   // Simple linear regression.
   double trend = prev_trend_;
@@ -240,7 +223,7 @@ void TrendlineEstimator::UpdateTrendline(double recv_delta_ms,
     // 0 < trend < 1   ->  the delay increases, queues are filling up
     //   trend == 0    ->  the delay does not change
     //   trend < 0     ->  the delay decreases, queues are being emptied
-    trend = LinearFitSlope(delay_hist_).value_or(trend);
+    trend = LinearFitSlope().value_or(trend);
     if (settings_.enable_cap) {
       absl::optional<double> cap = ComputeSlopeCap(delay_hist_, settings_);
       // We only use the cap to filter out overuse detections, not
@@ -255,6 +238,53 @@ void TrendlineEstimator::UpdateTrendline(double recv_delta_ms,
   Detect(trend, send_delta_ms, arrival_time_ms);
 }
 
+void TrendlineEstimator::AddToRegression(const PacketTiming& packet) {
+  const double x = packet.arrival_time_ms - regression_origin_.arrival_time_ms;
+  const double y =
+      packet.smoothed_delay_ms - regression_origin_.smoothed_delay_ms;
+  regression_sums_.x += x;
+  regression_sums_.y += y;
+  regression_sums_.xx += x * x;
+  regression_sums_.xy += x * y;
+}
+
+void TrendlineEstimator::RemoveFromRegression(const PacketTiming& packet) {
+  const double x = packet.arrival_time_ms - regression_origin_.arrival_time_ms;
+  const double y =
+      packet.smoothed_delay_ms - regression_origin_.smoothed_delay_ms;
+  regression_sums_.x -= x;
+  regression_sums_.y -= y;
+  regression_sums_.xx -= x * x;
+  regression_sums_.xy -= x * y;
+}
+
+void TrendlineEstimator::ResetRegression() {
+  updates_since_regression_reset_ = 0;
+  regression_sums_ = RegressionSums();
+  if (delay_hist_.empty()) {
+    return;
+  }
+  regression_origin_ = delay_hist_.front();
+  for (const PacketTiming& packet : delay_hist_) {
+    AddToRegression(packet);
+  }
+}
+
+absl::optional<double> TrendlineEstimator::LinearFitSlope() const {
+  RTC_DCHECK(delay_hist_.size() >= 2);
+  // The slope k = \sum (x_i-x_avg)(y_i-y_avg) / \sum (x_i-x_avg)^2, with both
+  // sums scaled by the number of packets n. The arrival times are whole
+  // milliseconds, so the x sums, and thereby the denominator, are exact.
+  const double n = delay_hist_.size();
+  const double numerator =
+      n * regression_sums_.xy - regression_sums_.x * regression_sums_.y;
+  const double denominator =
+      n * regression_sums_.xx - regression_sums_.x * regression_sums_.x;
+  if (denominator == 0)
+    return absl::nullopt;
+  return numerator / denominator;
+}
+
 void TrendlineEstimator::Update(double recv_delta_ms,
                                 double send_delta_ms,
                                 int64_t send_time_ms,
@@ -16,6 +16,7 @@
 #include <deque>
 #include <memory>
 
+#include "absl/types/optional.h"
 #include "api/field_trials_view.h"
 #include "api/network_state_predictor.h"
 #include "modules/congestion_controller/goog_cc/delay_increase_detector_interface.h"
@@ -88,6 +89,23 @@ class TrendlineEstimator : public DelayIncreaseDetectorInterface {
 
  private:
   friend class GoogCcStatePrinter;
+
+  // Sums over `delay_hist_` for the linear regression, of the arrival times
+  // (x) and smoothed delays (y) relative to `regression_origin_`.
+  struct RegressionSums {
+    double x = 0.0;
+    double y = 0.0;
+    double xx = 0.0;
+    double xy = 0.0;
+  };
+
+  void AddToRegression(const PacketTiming& packet);
+  void RemoveFromRegression(const PacketTiming& packet);
+  // Recomputes the regression sums relative to the oldest packet, which keeps
+  // the sums small and drops the rounding errors of the running y sums.
+  void ResetRegression();
+  absl::optional<double> LinearFitSlope() const;
+
   void Detect(double trend, double ts_delta, int64_t now_ms);
 
   void UpdateThreshold(double modified_offset, int64_t now_ms);
@@ -105,6 +123,9 @@ class TrendlineEstimator : public DelayIncreaseDetectorInterface {
   double smoothed_delay_;
   // Linear least squares regression.
   std::deque<PacketTiming> delay_hist_;
+  PacketTiming regression_origin_;
+  RegressionSums regression_sums_;
+  size_t updates_since_regression_reset_;
 
   const double k_up_;
   const double k_down_;
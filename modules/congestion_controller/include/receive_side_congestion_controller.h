@@ -19,6 +19,7 @@
 #include "api/units/time_delta.h"
 #include "modules/congestion_controller/remb_throttler.h"
 #include "modules/pacing/packet_router.h"
+#include "modules/remote_bitrate_estimator/congestion_control_feedback_generator.h"
 #include "modules/remote_bitrate_estimator/remote_estimator_proxy.h"
 #include "modules/rtp_rtcp/source/rtp_packet_received.h"
 #include "rtc_base/synchronization/mutex.h"
@@ -42,6 +43,11 @@ class ReceiveSideCongestionController : public CallStatsObserver {
 
   ~ReceiveSideCongestionController() override {}
 
+  // Reports all received packets in RTCP congestion control feedback according
+  // to RFC 8888 instead of in transport feedback or REMB. Must be called before
+  // any packet is received.
+  void EnableSendCongestionControlFeedbackAccordingToRfc8888();
+
   void OnReceivedPacket(const RtpPacketReceived& packet, MediaType media_type);
 
   // Implements CallStatsObserver.
@@ -75,6 +81,8 @@ class ReceiveSideCongestionController : public CallStatsObserver {
   Clock& clock_;
   RembThrottler remb_throttler_;
   RemoteEstimatorProxy remote_estimator_proxy_;
+  CongestionControlFeedbackGenerator congestion_control_feedback_generator_;
+  bool send_rfc8888_congestion_feedback_ = false;
 
   mutable Mutex mutex_;
   std::unique_ptr<RemoteBitrateEstimator> rbe_ RTC_GUARDED_BY(mutex_);
@@ -75,15 +75,27 @@ ReceiveSideCongestionController::ReceiveSideCongestionController(
     NetworkStateEstimator* network_state_estimator)
     : clock_(*clock),
       remb_throttler_(std::move(remb_sender), clock),
-      remote_estimator_proxy_(std::move(feedback_sender),
-                              network_state_estimator),
+      remote_estimator_proxy_(feedback_sender, network_state_estimator),
+      congestion_control_feedback_generator_(clock,
+                                             std::move(feedback_sender)),
       rbe_(new RemoteBitrateEstimatorSingleStream(&remb_throttler_, clock)),
       using_absolute_send_time_(false),
       packets_since_absolute_send_time_(0) {}
 
+void ReceiveSideCongestionController::
+    EnableSendCongestionControlFeedbackAccordingToRfc8888() {
+  RTC_LOG(LS_INFO)
+      << "Sending congestion control feedback according to RFC 8888.";
+  send_rfc8888_congestion_feedback_ = true;
+}
+
 void ReceiveSideCongestionController::OnReceivedPacket(
     const RtpPacketReceived& packet,
     MediaType media_type) {
+  if (send_rfc8888_congestion_feedback_) {
+    congestion_control_feedback_generator_.OnReceivedPacket(packet);
+    return;
+  }
   bool has_transport_sequence_number =
       packet.HasExtension<TransportSequenceNumber>() ||
       packet.HasExtension<TransportSequenceNumberV2>();
@@ -109,6 +121,10 @@ void ReceiveSideCongestionController::OnBitrateChanged(int bitrate_bps) {
 
 TimeDelta ReceiveSideCongestionController::MaybeProcess() {
   Timestamp now = clock_.CurrentTime();
+  if (send_rfc8888_congestion_feedback_) {
+    return std::max(congestion_control_feedback_generator_.Process(now),
+                    TimeDelta::Zero());
+  }
   mutex_.Lock();
   TimeDelta time_until_rbe = rbe_->Process();
   mutex_.Unlock();
@@ -18,8 +18,11 @@
 #include "api/units/timestamp.h"
 #include "modules/pacing/packet_router.h"
 #include "modules/rtp_rtcp/include/rtp_header_extension_map.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/common_header.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/congestion_control_feedback.h"
 #include "modules/rtp_rtcp/source/rtp_header_extensions.h"
 #include "modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "rtc_base/buffer.h"
 #include "system_wrappers/include/clock.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
@@ -33,6 +36,7 @@ using ::testing::_;
 using ::testing::AtLeast;
 using ::testing::ElementsAre;
 using ::testing::MockFunction;
+using ::testing::SizeIs;
 
 constexpr DataRate kInitialBitrate = DataRate::BitsPerSec(60'000);
 
@@ -80,6 +84,39 @@ TEST(ReceiveSideCongestionControllerTest,
   controller.SetMaxDesiredReceiveBitrate(DataRate::BitsPerSec(123));
 }
 
+TEST(ReceiveSideCongestionControllerTest,
+     SendsRfc8888FeedbackInsteadOfTransportFeedbackWhenEnabled) {
+  MockFunction<void(std::vector<std::unique_ptr<rtcp::RtcpPacket>>)>
+      feedback_sender;
+  MockFunction<void(uint64_t, std::vector<uint32_t>)> remb_sender;
+  SimulatedClock clock_(123456);
+
+  ReceiveSideCongestionController controller(
+      &clock_, feedback_sender.AsStdFunction(), remb_sender.AsStdFunction(),
+      nullptr);
+  controller.EnableSendCongestionControlFeedbackAccordingToRfc8888();
+
+  RtpHeaderExtensionMap extensions;
+  extensions.Register<TransportSequenceNumber>(1);
+  RtpPacketReceived packet(&extensions, clock_.CurrentTime());
+  packet.SetSsrc(0x11eb21c);
+  packet.SetSequenceNumber(1);
+  packet.SetExtension<TransportSequenceNumber>(1);
+  controller.OnReceivedPacket(packet, MediaType::VIDEO);
+
+  EXPECT_CALL(feedback_sender, Call(SizeIs(1)))
+      .WillOnce([](std::vector<std::unique_ptr<rtcp::RtcpPacket>> packets) {
+        rtc::Buffer buffer = packets[0]->Build();
+        rtcp::CommonHeader header;
+        ASSERT_TRUE(header.Parse(buffer.data(), buffer.size()));
+        EXPECT_EQ(header.type(), rtcp::Rtpfb::kPacketType);
+        EXPECT_EQ(header.fmt(),
+                  rtcp::CongestionControlFeedback::kFeedbackMessageType);
+      });
+  EXPECT_CALL(remb_sender, Call).Times(0);
+  controller.MaybeProcess();
+}
+
 TEST(ReceiveSideCongestionControllerTest, ConvergesToCapacity) {
   Scenario s("receive_cc_unit/converge");
   NetworkSimulationConfig net_conf;
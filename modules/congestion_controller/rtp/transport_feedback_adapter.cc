@@ -25,43 +25,129 @@
 
 namespace webrtc {
 
+namespace {
+
 constexpr TimeDelta kSendTimeHistoryWindow = TimeDelta::Seconds(60);
+// Sequence numbers in feedback are unwrapped against the last sent one, so
+// packets that are further behind than this are never found again.
+constexpr int64_t kMaxHistorySize = 1 << 15;
+constexpr size_t kMinHistoryCapacity = 1 << 7;
+
+void LogLookupFailures(size_t failed_lookups, size_t ignored) {
+  if (failed_lookups > 0) {
+    RTC_LOG(LS_WARNING) << "Failed to lookup send time for " << failed_lookups
+                        << " packet" << (failed_lookups > 1 ? "s" : "")
+                        << ". Send time history too small?";
+  }
+  if (ignored > 0) {
+    RTC_LOG(LS_INFO) << "Ignoring " << ignored
+                     << " packets because they were sent on a different route.";
+  }
+}
+
+// Converts the difference of two compact NTP timestamps, in 1/2^16 seconds.
+TimeDelta CompactNtpIntervalToTimeDelta(int32_t compact_ntp_interval) {
+  return TimeDelta::Micros(int64_t{compact_ntp_interval} * 1'000'000 /
+                           (1 << 16));
+}
+
+}  // namespace
+
+int InFlightBytesTracker::AcquireNetworkRoute(
+    const rtc::NetworkRoute& network_route) {
+  const NetworkRouteComparator less;
+  int group = next_network_route_id_;
+  for (NetworkRouteData& route : network_routes_) {
+    if (route.network_route == network_route) {
+      ++route.num_users;
+      return route.id;
+    }
+    if (!less(network_route, route.network_route) &&
+        !less(route.network_route, network_route)) {
+      group = route.group;
+    }
+  }
+  NetworkRouteData route;
+  route.id = next_network_route_id_++;
+  route.network_route = network_route;
+  route.group = group;
+  route.num_users = 1;
+  network_routes_.push_back(route);
+  return route.id;
+}
+
+void InFlightBytesTracker::ReleaseNetworkRoute(int network_route_id) {
+  NetworkRouteData* route = FindNetworkRoute(network_route_id);
+  RTC_DCHECK(route);
+  RTC_DCHECK_GT(route->num_users, 0);
+  --route->num_users;
+  RemoveIfUnused(*route);
+}
 
 void InFlightBytesTracker::AddInFlightPacketBytes(
     const PacketFeedback& packet) {
   RTC_DCHECK(packet.sent.send_time.IsFinite());
-  auto it = in_flight_data_.find(packet.network_route);
-  if (it != in_flight_data_.end()) {
-    it->second += packet.sent.size;
-  } else {
-    in_flight_data_.insert({packet.network_route, packet.sent.size});
+  NetworkRouteData* route = FindNetworkRoute(packet.network_route_id);
+  if (route == nullptr) {
+    // The route was removed after the packet was added, before it was sent.
+    // The packet is not counted, and not removed either.
+    return;
   }
+  route->in_flight += packet.sent.size;
 }
 
 void InFlightBytesTracker::RemoveInFlightPacketBytes(
     const PacketFeedback& packet) {
   if (packet.sent.send_time.IsInfinite())
     return;
-  auto it = in_flight_data_.find(packet.network_route);
-  if (it != in_flight_data_.end()) {
-    RTC_DCHECK_GE(it->second, packet.sent.size);
-    it->second -= packet.sent.size;
-    if (it->second.IsZero())
-      in_flight_data_.erase(it);
+  NetworkRouteData* route = FindNetworkRoute(packet.network_route_id);
+  if (route == nullptr) {
+    return;
   }
+  RTC_DCHECK_GE(route->in_flight, packet.sent.size);
+  route->in_flight -= packet.sent.size;
+  RemoveIfUnused(*route);
 }
 
-DataSize InFlightBytesTracker::GetOutstandingData(
-    const rtc::NetworkRoute& network_route) const {
-  auto it = in_flight_data_.find(network_route);
-  if (it != in_flight_data_.end()) {
-    return it->second;
-  } else {
-    return DataSize::Zero();
+DataSize InFlightBytesTracker::GetOutstandingData(int network_route_id) const {
+  int group = -1;
+  for (const NetworkRouteData& route : network_routes_) {
+    if (route.id == network_route_id) {
+      group = route.group;
+      break;
+    }
+  }
+  RTC_DCHECK_GE(group, 0);
+  DataSize in_flight = DataSize::Zero();
+  for (const NetworkRouteData& route : network_routes_) {
+    if (route.group == group) {
+      in_flight += route.in_flight;
+    }
+  }
+  return in_flight;
+}
+
+InFlightBytesTracker::NetworkRouteData* InFlightBytesTracker::FindNetworkRoute(
+    int network_route_id) {
+  for (NetworkRouteData& route : network_routes_) {
+    if (route.id == network_route_id) {
+      return &route;
+    }
+  }
+  return nullptr;
+}
+
+void InFlightBytesTracker::RemoveIfUnused(const NetworkRouteData& route) {
+  if (route.num_users > 0 || !route.in_flight.IsZero()) {
+    return;
   }
+  const int id = route.id;
+  network_routes_.erase(absl::c_find_if(
+      network_routes_,
+      [id](const NetworkRouteData& other) { return other.id == id; }));
 }
 
-// Comparator for consistent map with NetworkRoute as key.
+// Comparator for routes that share their data in flight.
 bool InFlightBytesTracker::NetworkRouteComparator::operator()(
     const rtc::NetworkRoute& a,
     const rtc::NetworkRoute& b) const {
@@ -83,7 +169,10 @@ bool InFlightBytesTracker::NetworkRouteComparator::operator()(
   return a.connected < b.connected;
 }
 
-TransportFeedbackAdapter::TransportFeedbackAdapter() = default;
+TransportFeedbackAdapter::TransportFeedbackAdapter()
+    : network_route_id_(in_flight_.AcquireNetworkRoute(rtc::NetworkRoute())),
+      secondary_network_route_id_(
+          in_flight_.AcquireNetworkRoute(rtc::NetworkRoute())) {}
 
 void TransportFeedbackAdapter::AddPacket(const RtpPacketSendInfo& packet_info,
                                          size_t overhead_bytes,
@@ -94,18 +183,49 @@ void TransportFeedbackAdapter::AddPacket(const RtpPacketSendInfo& packet_info,
       seq_num_unwrapper_.Unwrap(packet_info.transport_sequence_number);
   packet.sent.size = DataSize::Bytes(packet_info.length + overhead_bytes);
   packet.sent.audio = packet_info.packet_type == RtpPacketMediaType::kAudio;
-  packet.network_route = network_route_;
+  packet.network_route_id = packet_info.on_secondary_route
+                                ? secondary_network_route_id_
+                                : network_route_id_;
   packet.sent.pacing_info = packet_info.pacing_info;
-
-  while (!history_.empty() &&
-         creation_time - history_.begin()->second.creation_time >
-             kSendTimeHistoryWindow) {
+  packet.ssrc = packet_info.transport_ssrc;
+  packet.rtp_sequence_number = packet_info.transport_rtp_sequence_number;
+
+  // Drops old packets, and acknowledged ones ahead of them.
+  while (history_begin_ < history_end_) {
+    const absl::optional<PacketFeedback>& oldest =
+        history_[history_begin_ & (history_.size() - 1)];
+    if (oldest.has_value() &&
+        creation_time - oldest->creation_time <= kSendTimeHistoryWindow) {
+      break;
+    }
     // TODO(sprang): Warn if erasing (too many) old items?
-    if (history_.begin()->second.sent.sequence_number > last_ack_seq_num_)
-      in_flight_.RemoveInFlightPacketBytes(history_.begin()->second);
-    history_.erase(history_.begin());
+    PopHistory();
   }
-  history_.insert(std::make_pair(packet.sent.sequence_number, packet));
+
+  const int64_t seq_num = packet.sent.sequence_number;
+  if (seq_num < history_begin_) {
+    RTC_LOG(LS_WARNING) << "Packet " << seq_num
+                        << " is older than the send time history.";
+    return;
+  }
+  if (seq_num >= history_end_) {
+    ExtendHistory(seq_num);
+  }
+  absl::optional<PacketFeedback>& entry =
+      history_[seq_num & (history_.size() - 1)];
+  if (!entry.has_value()) {
+    entry = packet;
+    if (rfc8888_feedback_enabled_) {
+      rtp_to_transport_seq_num_[{packet.ssrc, packet.rtp_sequence_number}] =
+          seq_num;
+    }
+  }
+}
+
+void TransportFeedbackAdapter::
+    EnableCongestionControlFeedbackAccordingToRfc8888() {
+  RTC_DCHECK_EQ(history_begin_, history_end_);
+  rfc8888_feedback_enabled_ = true;
 }
 
 absl::optional<SentPacket> TransportFeedbackAdapter::ProcessSentPacket(
@@ -115,10 +235,10 @@ absl::optional<SentPacket> TransportFeedbackAdapter::ProcessSentPacket(
   if (sent_packet.info.included_in_feedback || sent_packet.packet_id != -1) {
     int64_t unwrapped_seq_num =
         seq_num_unwrapper_.Unwrap(sent_packet.packet_id);
-    auto it = history_.find(unwrapped_seq_num);
-    if (it != history_.end()) {
-      bool packet_retransmit = it->second.sent.send_time.IsFinite();
-      it->second.sent.send_time = send_time;
+    PacketFeedback* packet = FindInHistory(unwrapped_seq_num);
+    if (packet != nullptr) {
+      bool packet_retransmit = packet->sent.send_time.IsFinite();
+      packet->sent.send_time = send_time;
       last_send_time_ = std::max(last_send_time_, send_time);
       // TODO(srte): Don't do this on retransmit.
       if (!pending_untracked_size_.IsZero()) {
@@ -126,14 +246,14 @@ absl::optional<SentPacket> TransportFeedbackAdapter::ProcessSentPacket(
           RTC_LOG(LS_WARNING)
               << "appending acknowledged data for out of order packet. (Diff: "
               << ToString(last_untracked_send_time_ - send_time) << " ms.)";
-        it->second.sent.prior_unacked_data += pending_untracked_size_;
+        packet->sent.prior_unacked_data += pending_untracked_size_;
         pending_untracked_size_ = DataSize::Zero();
       }
       if (!packet_retransmit) {
-        if (it->second.sent.sequence_number > last_ack_seq_num_)
-          in_flight_.AddInFlightPacketBytes(it->second);
-        it->second.sent.data_in_flight = GetOutstandingData();
-        return it->second.sent;
+        if (packet->sent.sequence_number > last_ack_seq_num_)
+          in_flight_.AddInFlightPacketBytes(*packet);
+        packet->sent.data_in_flight = GetOutstandingData();
+        return packet->sent;
       }
     }
   } else if (sent_packet.info.included_in_allocation) {
@@ -159,28 +279,106 @@ TransportFeedbackAdapter::ProcessTransportFeedback(
   TransportPacketsFeedback msg;
   msg.feedback_time = feedback_receive_time;
 
-  msg.prior_in_flight = in_flight_.GetOutstandingData(network_route_);
+  msg.prior_in_flight = in_flight_.GetOutstandingData(network_route_id_);
   msg.packet_feedbacks =
       ProcessTransportFeedbackInner(feedback, feedback_receive_time);
   if (msg.packet_feedbacks.empty())
     return absl::nullopt;
 
-  auto it = history_.find(last_ack_seq_num_);
-  if (it != history_.end()) {
-    msg.first_unacked_send_time = it->second.sent.send_time;
+  if (const PacketFeedback* packet = FindInHistory(last_ack_seq_num_)) {
+    msg.first_unacked_send_time = packet->sent.send_time;
   }
-  msg.data_in_flight = in_flight_.GetOutstandingData(network_route_);
+  msg.data_in_flight = in_flight_.GetOutstandingData(network_route_id_);
 
   return msg;
 }
 
 void TransportFeedbackAdapter::SetNetworkRoute(
     const rtc::NetworkRoute& network_route) {
-  network_route_ = network_route;
+  // Acquired before the old route is released, so that the route is kept
+  // when it doesn't change.
+  const int network_route_id = in_flight_.AcquireNetworkRoute(network_route);
+  in_flight_.ReleaseNetworkRoute(network_route_id_);
+  network_route_id_ = network_route_id;
+}
+
+void TransportFeedbackAdapter::SetSecondaryNetworkRoute(
+    const rtc::NetworkRoute& network_route) {
+  const int network_route_id = in_flight_.AcquireNetworkRoute(network_route);
+  in_flight_.ReleaseNetworkRoute(secondary_network_route_id_);
+  secondary_network_route_id_ = network_route_id;
 }
 
 DataSize TransportFeedbackAdapter::GetOutstandingData() const {
-  return in_flight_.GetOutstandingData(network_route_);
+  return in_flight_.GetOutstandingData(network_route_id_);
+}
+
+PacketFeedback* TransportFeedbackAdapter::FindInHistory(int64_t seq_num) {
+  if (seq_num < history_begin_ || seq_num >= history_end_) {
+    return nullptr;
+  }
+  absl::optional<PacketFeedback>& entry =
+      history_[seq_num & (history_.size() - 1)];
+  return entry.has_value() ? &*entry : nullptr;
+}
+
+void TransportFeedbackAdapter::ExtendHistory(int64_t seq_num) {
+  RTC_DCHECK_GE(seq_num, history_end_);
+  while (history_begin_ < history_end_ &&
+         seq_num - history_begin_ >= kMaxHistorySize) {
+    PopHistory();
+  }
+  if (history_begin_ == history_end_) {
+    // Nothing to keep, start over at `seq_num`.
+    history_begin_ = seq_num;
+    history_end_ = seq_num;
+  }
+
+  const size_t size = seq_num + 1 - history_begin_;
+  if (size > history_.size()) {
+    size_t capacity = std::max(kMinHistoryCapacity, history_.size());
+    while (capacity < size) {
+      capacity *= 2;
+    }
+    std::vector<absl::optional<PacketFeedback>> history(capacity);
+    for (int64_t i = history_begin_; i < history_end_; ++i) {
+      history[i & (capacity - 1)] =
+          std::move(history_[i & (history_.size() - 1)]);
+    }
+    history_ = std::move(history);
+  }
+  // Sequence numbers that were skipped are not in the history.
+  for (int64_t i = history_end_; i <= seq_num; ++i) {
+    history_[i & (history_.size() - 1)] = absl::nullopt;
+  }
+  history_end_ = seq_num + 1;
+}
+
+void TransportFeedbackAdapter::PopHistory() {
+  RTC_DCHECK_LT(history_begin_, history_end_);
+  absl::optional<PacketFeedback>& oldest =
+      history_[history_begin_ & (history_.size() - 1)];
+  if (oldest.has_value()) {
+    if (oldest->sent.sequence_number > last_ack_seq_num_)
+      in_flight_.RemoveInFlightPacketBytes(*oldest);
+    RemoveFromHistory(history_begin_);
+  }
+  ++history_begin_;
+}
+
+void TransportFeedbackAdapter::RemoveFromHistory(int64_t seq_num) {
+  absl::optional<PacketFeedback>& entry =
+      history_[seq_num & (history_.size() - 1)];
+  RTC_DCHECK(entry.has_value());
+  if (rfc8888_feedback_enabled_) {
+    auto it = rtp_to_transport_seq_num_.find(
+        {entry->ssrc, entry->rtp_sequence_number});
+    // A later packet may have reused the RTP sequence number.
+    if (it != rtp_to_transport_seq_num_.end() && it->second == seq_num) {
+      rtp_to_transport_seq_num_.erase(it);
+    }
+  }
+  entry = absl::nullopt;
 }
 
 std::vector<PacketResult>
@@ -215,61 +413,152 @@ TransportFeedbackAdapter::ProcessTransportFeedbackInner(
   feedback.ForAllPackets(
       [&](uint16_t sequence_number, TimeDelta delta_since_base) {
         int64_t seq_num = seq_num_unwrapper_.Unwrap(sequence_number);
-
-        if (seq_num > last_ack_seq_num_) {
-          // Starts at history_.begin() if last_ack_seq_num_ < 0, since any
-          // valid sequence number is >= 0.
-          for (auto it = history_.upper_bound(last_ack_seq_num_);
-               it != history_.upper_bound(seq_num); ++it) {
-            in_flight_.RemoveInFlightPacketBytes(it->second);
-          }
-          last_ack_seq_num_ = seq_num;
-        }
-
-        auto it = history_.find(seq_num);
-        if (it == history_.end()) {
-          ++failed_lookups;
-          return;
-        }
-
-        if (it->second.sent.send_time.IsInfinite()) {
-          // TODO(srte): Fix the tests that makes this happen and make this a
-          // DCHECK.
-          RTC_DLOG(LS_ERROR)
-              << "Received feedback before packet was indicated as sent";
-          return;
-        }
-
-        PacketFeedback packet_feedback = it->second;
+        Timestamp receive_time = Timestamp::PlusInfinity();
         if (delta_since_base.IsFinite()) {
-          packet_feedback.receive_time =
-              current_offset_ +
-              delta_since_base.RoundDownTo(TimeDelta::Millis(1));
-          // Note: Lost packets are not removed from history because they might
-          // be reported as received by a later feedback.
-          history_.erase(it);
+          receive_time = current_offset_ +
+                         delta_since_base.RoundDownTo(TimeDelta::Millis(1));
         }
-        if (packet_feedback.network_route == network_route_) {
-          PacketResult result;
-          result.sent_packet = packet_feedback.sent;
-          result.receive_time = packet_feedback.receive_time;
-          packet_result_vector.push_back(result);
-        } else {
-          ++ignored;
+        absl::optional<PacketResult> result = ProcessPacketFeedback(
+            seq_num, receive_time, failed_lookups, ignored);
+        if (result.has_value()) {
+          packet_result_vector.push_back(*result);
         }
       });
+  LogLookupFailures(failed_lookups, ignored);
 
-  if (failed_lookups > 0) {
-    RTC_LOG(LS_WARNING) << "Failed to lookup send time for " << failed_lookups
-                        << " packet" << (failed_lookups > 1 ? "s" : "")
-                        << ". Send time history too small?";
+  return packet_result_vector;
+}
+
+absl::optional<PacketResult> TransportFeedbackAdapter::ProcessPacketFeedback(
+    int64_t seq_num,
+    Timestamp receive_time,
+    size_t& failed_lookups,
+    size_t& ignored) {
+  if (seq_num > last_ack_seq_num_) {
+    // Starts at `history_begin_` if last_ack_seq_num_ < 0, since any valid
+    // sequence number is >= 0.
+    const int64_t end = std::min(seq_num + 1, history_end_);
+    for (int64_t i = std::max(last_ack_seq_num_ + 1, history_begin_); i < end;
+         ++i) {
+      const absl::optional<PacketFeedback>& packet =
+          history_[i & (history_.size() - 1)];
+      if (packet.has_value()) {
+        in_flight_.RemoveInFlightPacketBytes(*packet);
+      }
+    }
+    last_ack_seq_num_ = seq_num;
   }
-  if (ignored > 0) {
-    RTC_LOG(LS_INFO) << "Ignoring " << ignored
-                     << " packets because they were sent on a different route.";
+
+  PacketFeedback* packet = FindInHistory(seq_num);
+  if (packet == nullptr) {
+    ++failed_lookups;
+    return absl::nullopt;
   }
 
-  return packet_result_vector;
+  if (packet->sent.send_time.IsInfinite()) {
+    // TODO(srte): Fix the tests that makes this happen and make this a
+    // DCHECK.
+    RTC_DLOG(LS_ERROR)
+        << "Received feedback before packet was indicated as sent";
+    return absl::nullopt;
+  }
+
+  absl::optional<PacketResult> result;
+  if (packet->network_route_id == network_route_id_) {
+    result.emplace();
+    result->sent_packet = packet->sent;
+    result->receive_time = receive_time;
+  } else {
+    ++ignored;
+  }
+  if (receive_time.IsFinite()) {
+    // Note: Lost packets are not removed from history because they might be
+    // reported as received by a later feedback.
+    RemoveFromHistory(seq_num);
+  }
+  return result;
+}
+
+absl::optional<TransportPacketsFeedback>
+TransportFeedbackAdapter::ProcessCongestionControlFeedback(
+    const rtcp::CongestionControlFeedback& feedback,
+    Timestamp feedback_receive_time) {
+  if (!rfc8888_feedback_enabled_) {
+    RTC_LOG(LS_WARNING) << "Congestion control feedback received, but it is "
+                           "not enabled.";
+    return absl::nullopt;
+  }
+  if (feedback.packets().empty()) {
+    RTC_LOG(LS_INFO) << "Empty congestion control feedback packet received.";
+    return absl::nullopt;
+  }
+  // Like for transport feedback, the receive times are put on a local time
+  // base that starts at the receive time of the first feedback.
+  if (!last_report_timestamp_compact_ntp_.has_value()) {
+    ccfb_current_offset_ = feedback_receive_time;
+  } else {
+    TimeDelta delta = CompactNtpIntervalToTimeDelta(
+        feedback.report_timestamp_compact_ntp() -
+        *last_report_timestamp_compact_ntp_);
+    if (delta < Timestamp::Zero() - ccfb_current_offset_) {
+      RTC_LOG(LS_WARNING) << "Unexpected feedback timestamp received.";
+      ccfb_current_offset_ = feedback_receive_time;
+    } else {
+      ccfb_current_offset_ += delta;
+    }
+  }
+  last_report_timestamp_compact_ntp_ = feedback.report_timestamp_compact_ntp();
+
+  // The packets are acknowledged in the order they were sent, like for
+  // transport feedback, although the feedback reports them per RTP stream.
+  using PacketInfo = rtcp::CongestionControlFeedback::PacketInfo;
+  std::vector<std::pair<int64_t, const PacketInfo*>> reports;
+  reports.reserve(feedback.packets().size());
+  size_t failed_lookups = 0;
+  size_t ignored = 0;
+  for (const PacketInfo& packet_info : feedback.packets()) {
+    auto it = rtp_to_transport_seq_num_.find(
+        {packet_info.ssrc, packet_info.sequence_number});
+    if (it == rtp_to_transport_seq_num_.end()) {
+      // Lost packets that were already reported as received are not found
+      // either.
+      if (packet_info.received()) {
+        ++failed_lookups;
+      }
+      continue;
+    }
+    reports.emplace_back(it->second, &packet_info);
+  }
+  absl::c_sort(reports, [](const auto& a, const auto& b) {
+    return a.first < b.first;
+  });
+
+  TransportPacketsFeedback msg;
+  msg.feedback_time = feedback_receive_time;
+  msg.prior_in_flight = in_flight_.GetOutstandingData(network_route_id_);
+  msg.packet_feedbacks.reserve(reports.size());
+  for (const auto& [seq_num, packet_info] : reports) {
+    Timestamp receive_time = Timestamp::PlusInfinity();
+    if (packet_info->received() &&
+        packet_info->arrival_time_offset.IsFinite()) {
+      receive_time = ccfb_current_offset_ - packet_info->arrival_time_offset;
+    }
+    absl::optional<PacketResult> result = ProcessPacketFeedback(
+        seq_num, receive_time, failed_lookups, ignored);
+    if (result.has_value()) {
+      result->ecn = packet_info->ecn;
+      msg.packet_feedbacks.push_back(*result);
+    }
+  }
+  LogLookupFailures(failed_lookups, ignored);
+  if (msg.packet_feedbacks.empty())
+    return absl::nullopt;
+
+  if (const PacketFeedback* packet = FindInHistory(last_ack_seq_num_)) {
+    msg.first_unacked_send_time = packet->sent.send_time;
+  }
+  msg.data_in_flight = in_flight_.GetOutstandingData(network_route_id_);
+  return msg;
 }
 
 }  // namespace webrtc
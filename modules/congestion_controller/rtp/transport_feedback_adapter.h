@@ -11,15 +11,19 @@
 #ifndef MODULES_CONGESTION_CONTROLLER_RTP_TRANSPORT_FEEDBACK_ADAPTER_H_
 #define MODULES_CONGESTION_CONTROLLER_RTP_TRANSPORT_FEEDBACK_ADAPTER_H_
 
-#include <deque>
+#include <stddef.h>
+#include <stdint.h>
+
 #include <map>
 #include <utility>
 #include <vector>
 
+#include "absl/types/optional.h"
 #include "api/sequence_checker.h"
 #include "api/transport/network_types.h"
 #include "api/units/timestamp.h"
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/congestion_control_feedback.h"
 #include "rtc_base/network/sent_packet.h"
 #include "rtc_base/network_route.h"
 #include "rtc_base/numerics/sequence_number_unwrapper.h"
@@ -37,22 +41,54 @@ struct PacketFeedback {
   // used.
   Timestamp receive_time = Timestamp::PlusInfinity();
 
-  // The network route that this packet is associated with.
-  rtc::NetworkRoute network_route;
+  // Id of the network route that this packet is associated with, see
+  // InFlightBytesTracker::AcquireNetworkRoute().
+  int network_route_id = 0;
+
+  // The RTP stream and sequence number that RFC 8888 feedback reports the
+  // packet by.
+  uint32_t ssrc = 0;
+  uint16_t rtp_sequence_number = 0;
 };
 
+// Tracks the data in flight per network route. Routes are referred to by
+// small ids, so that packets are accounted for without a route lookup.
 class InFlightBytesTracker {
  public:
+  // Returns the id of `network_route`, which is the same for equal routes
+  // while the route is known. A route is known until it has been released as
+  // many times as it was acquired and has no data in flight. Ids of routes
+  // that are no longer known are not reused.
+  int AcquireNetworkRoute(const rtc::NetworkRoute& network_route);
+  void ReleaseNetworkRoute(int network_route_id);
+
   void AddInFlightPacketBytes(const PacketFeedback& packet);
   void RemoveInFlightPacketBytes(const PacketFeedback& packet);
-  DataSize GetOutstandingData(const rtc::NetworkRoute& network_route) const;
+  DataSize GetOutstandingData(int network_route_id) const;
 
  private:
   struct NetworkRouteComparator {
     bool operator()(const rtc::NetworkRoute& a,
                     const rtc::NetworkRoute& b) const;
   };
-  std::map<rtc::NetworkRoute, DataSize, NetworkRouteComparator> in_flight_data_;
+  struct NetworkRouteData {
+    int id;
+    rtc::NetworkRoute network_route;
+    // Routes that only differ in properties ignored by
+    // `NetworkRouteComparator`, such as their overhead, share their data in
+    // flight. They have the same group, which is the id of one of them.
+    int group;
+    int num_users = 0;
+    DataSize in_flight = DataSize::Zero();
+  };
+
+  NetworkRouteData* FindNetworkRoute(int network_route_id);
+  void RemoveIfUnused(const NetworkRouteData& route);
+
+  // The known routes. Routes change rarely and unused routes are removed, so
+  // there are few and they are found by a linear search.
+  std::vector<NetworkRouteData> network_routes_;
+  int next_network_route_id_ = 0;
 };
 
 class TransportFeedbackAdapter {
@@ -68,8 +104,22 @@ class TransportFeedbackAdapter {
   absl::optional<TransportPacketsFeedback> ProcessTransportFeedback(
       const rtcp::TransportFeedback& feedback,
       Timestamp feedback_receive_time);
+  // Makes the adapter keep track of the packets by SSRC and RTP sequence
+  // number, which is needed to process RFC 8888 feedback. Must be called
+  // before the first packet is added.
+  void EnableCongestionControlFeedbackAccordingToRfc8888();
+  // Same as ProcessTransportFeedback(), for congestion control feedback
+  // according to RFC 8888, which also reports the ECN marks of the packets.
+  // Returns nullopt unless it has been enabled.
+  absl::optional<TransportPacketsFeedback> ProcessCongestionControlFeedback(
+      const rtcp::CongestionControlFeedback& feedback,
+      Timestamp feedback_receive_time);
 
   void SetNetworkRoute(const rtc::NetworkRoute& network_route);
+  // Sets the route of the packets sent on the secondary route of the
+  // transport, see RtpPacketSendInfo::on_secondary_route. Their data in flight
+  // is tracked separately, and their feedback is not reported.
+  void SetSecondaryNetworkRoute(const rtc::NetworkRoute& network_route);
 
   DataSize GetOutstandingData() const;
 
@@ -80,11 +130,37 @@ class TransportFeedbackAdapter {
       const rtcp::TransportFeedback& feedback,
       Timestamp feedback_receive_time);
 
+  // Acknowledges the packets in flight up to `seq_num`, and returns the result
+  // for `seq_num`, which was received at `receive_time`, or not received if
+  // it is infinite. Returns nullopt, and counts the packet in
+  // `failed_lookups` or `ignored`, if it is not in the history or it was sent
+  // on another route than the current one.
+  absl::optional<PacketResult> ProcessPacketFeedback(int64_t seq_num,
+                                                     Timestamp receive_time,
+                                                     size_t& failed_lookups,
+                                                     size_t& ignored);
+  // Removes the received packet `seq_num` from the history.
+  void RemoveFromHistory(int64_t seq_num);
+
+  // Returns the packet with `seq_num` if it is in the history, or nullptr.
+  PacketFeedback* FindInHistory(int64_t seq_num);
+  // Makes room for `seq_num` at the end of the history.
+  void ExtendHistory(int64_t seq_num);
+  // Drops the oldest sequence number from the history.
+  void PopHistory();
+
   DataSize pending_untracked_size_ = DataSize::Zero();
   Timestamp last_send_time_ = Timestamp::MinusInfinity();
   Timestamp last_untracked_send_time_ = Timestamp::MinusInfinity();
   RtpSequenceNumberUnwrapper seq_num_unwrapper_;
-  std::map<int64_t, PacketFeedback> history_;
+
+  // Packets in the history, indexed by their unwrapped transport sequence
+  // number modulo the size of `history_`, which is a power of two. Holds the
+  // sequence numbers in [`history_begin_`, `history_end_`), some of which
+  // may have been acknowledged or never added.
+  std::vector<absl::optional<PacketFeedback>> history_;
+  int64_t history_begin_ = 0;
+  int64_t history_end_ = 0;
 
   // Sequence numbers are never negative, using -1 as it always < a real
   // sequence number.
@@ -94,7 +170,18 @@ class TransportFeedbackAdapter {
   Timestamp current_offset_ = Timestamp::MinusInfinity();
   Timestamp last_timestamp_ = Timestamp::MinusInfinity();
 
-  rtc::NetworkRoute network_route_;
+  bool rfc8888_feedback_enabled_ = false;
+  // The unwrapped transport sequence numbers of the packets in the history,
+  // by SSRC and RTP sequence number, for RFC 8888 feedback. Only filled if
+  // `rfc8888_feedback_enabled_`.
+  std::map<std::pair<uint32_t, uint16_t>, int64_t> rtp_to_transport_seq_num_;
+  // The local time base of RFC 8888 feedback, which moves with the report
+  // timestamps of the feedback like `current_offset_` does.
+  Timestamp ccfb_current_offset_ = Timestamp::MinusInfinity();
+  absl::optional<uint32_t> last_report_timestamp_compact_ntp_;
+
+  int network_route_id_;
+  int secondary_network_route_id_;
 };
 
 }  // namespace webrtc
@@ -0,0 +1,95 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "benchmark/benchmark.h"
+#include "modules/congestion_controller/rtp/transport_feedback_adapter.h"
+#include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/network/sent_packet.h"
+#include "rtc_base/system/unused.h"
+
+namespace webrtc {
+namespace {
+
+// About 20k packets per second with feedback every 50 ms. A whole number of
+// feedback intervals fit in the range of transport sequence numbers, so the
+// feedback messages can be reused once the sequence numbers wrap.
+constexpr int kPacketsPerFeedback = 1024;
+constexpr int kNumFeedbacks = (1 << 16) / kPacketsPerFeedback;
+constexpr TimeDelta kFeedbackInterval = TimeDelta::Millis(50);
+constexpr int kPacketSize = 1200;
+// Every `kLossInterval`th packet is lost.
+constexpr int kLossInterval = 100;
+
+Timestamp SendTime(int64_t packet_index) {
+  return Timestamp::Zero() +
+         kFeedbackInterval * packet_index / kPacketsPerFeedback;
+}
+
+std::vector<rtcp::TransportFeedback> CreateFeedbacks() {
+  std::vector<rtcp::TransportFeedback> feedbacks(kNumFeedbacks);
+  for (int i = 0; i < kNumFeedbacks; ++i) {
+    const uint16_t base_seq_num = i * kPacketsPerFeedback;
+    // Received 20 ms after being sent.
+    const TimeDelta kDelay = TimeDelta::Millis(20);
+    feedbacks[i].SetBase(base_seq_num, SendTime(base_seq_num) + kDelay);
+    for (int j = 0; j < kPacketsPerFeedback; ++j) {
+      if (j % kLossInterval == kLossInterval - 1) {
+        continue;
+      }
+      const uint16_t seq_num = base_seq_num + j;
+      RTC_CHECK(
+          feedbacks[i].AddReceivedPacket(seq_num, SendTime(seq_num) + kDelay));
+    }
+    feedbacks[i].Build();
+  }
+  return feedbacks;
+}
+
+// Adds, sends and acknowledges `kPacketsPerFeedback` packets per iteration.
+void BM_ProcessTransportFeedback(benchmark::State& state) {
+  const std::vector<rtcp::TransportFeedback> feedbacks = CreateFeedbacks();
+  TransportFeedbackAdapter adapter;
+  RtpPacketSendInfo packet_info;
+  packet_info.length = kPacketSize;
+  packet_info.packet_type = RtpPacketMediaType::kVideo;
+  int64_t packet_index = 0;
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    for (int i = 0; i < kPacketsPerFeedback; ++i, ++packet_index) {
+      const Timestamp send_time = SendTime(packet_index);
+      packet_info.transport_sequence_number =
+          static_cast<uint16_t>(packet_index);
+      adapter.AddPacket(packet_info, /*overhead_bytes=*/0, send_time);
+      adapter.ProcessSentPacket(
+          rtc::SentPacket(packet_info.transport_sequence_number,
+                          send_time.ms(), rtc::PacketInfo()));
+    }
+    const rtcp::TransportFeedback& feedback =
+        feedbacks[(packet_index / kPacketsPerFeedback - 1) % kNumFeedbacks];
+    absl::optional<TransportPacketsFeedback> result =
+        adapter.ProcessTransportFeedback(
+            feedback, SendTime(packet_index) + kFeedbackInterval);
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetItemsProcessed(state.iterations() * kPacketsPerFeedback);
+}
+
+BENCHMARK(BM_ProcessTransportFeedback);
+
+}  // namespace
+}  // namespace webrtc
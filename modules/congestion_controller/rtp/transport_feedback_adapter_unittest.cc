@@ -14,9 +14,12 @@
 #include <memory>
 #include <vector>
 
+#include "api/transport/ecn_marking.h"
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/congestion_control_feedback.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/network_route.h"
 #include "rtc_base/numerics/safe_conversions.h"
 #include "system_wrappers/include/clock.h"
 #include "test/field_trial.h"
@@ -98,15 +101,20 @@ class TransportFeedbackAdapterTest : public ::testing::Test {
   virtual void TearDown() { adapter_.reset(); }
 
  protected:
-  void OnSentPacket(const PacketResult& packet_feedback) {
+  void OnSentPacket(const PacketResult& packet_feedback,
+                    bool on_secondary_route = false) {
     RtpPacketSendInfo packet_info;
     packet_info.media_ssrc = kSsrc;
     packet_info.transport_sequence_number =
         packet_feedback.sent_packet.sequence_number;
     packet_info.rtp_sequence_number = 0;
+    packet_info.transport_ssrc = kSsrc;
+    packet_info.transport_rtp_sequence_number =
+        packet_feedback.sent_packet.sequence_number;
     packet_info.length = packet_feedback.sent_packet.size.bytes();
     packet_info.pacing_info = packet_feedback.sent_packet.pacing_info;
     packet_info.packet_type = RtpPacketMediaType::kVideo;
+    packet_info.on_secondary_route = on_secondary_route;
     adapter_->AddPacket(RtpPacketSendInfo(packet_info), 0u,
                         clock_.CurrentTime());
     adapter_->ProcessSentPacket(rtc::SentPacket(
@@ -398,4 +406,247 @@ TEST_F(TransportFeedbackAdapterTest, IgnoreDuplicatePacketSentCalls) {
   EXPECT_FALSE(duplicate_packet.has_value());
 }
 
+TEST_F(TransportFeedbackAdapterTest, TracksDataInFlightPerNetworkRoute) {
+  rtc::NetworkRoute route_a;
+  route_a.connected = true;
+  route_a.local = rtc::RouteEndpoint::CreateWithNetworkId(1);
+  route_a.remote = rtc::RouteEndpoint::CreateWithNetworkId(2);
+  rtc::NetworkRoute route_b = route_a;
+  route_b.local = rtc::RouteEndpoint::CreateWithNetworkId(3);
+
+  adapter_->SetNetworkRoute(route_a);
+  OnSentPacket(CreatePacket(100, 200, 0, 1000, kPacingInfo0));
+  OnSentPacket(CreatePacket(110, 210, 1, 1000, kPacingInfo0));
+  EXPECT_EQ(adapter_->GetOutstandingData(), DataSize::Bytes(2000));
+
+  adapter_->SetNetworkRoute(route_b);
+  EXPECT_EQ(adapter_->GetOutstandingData(), DataSize::Zero());
+  OnSentPacket(CreatePacket(120, 220, 2, 500, kPacingInfo0));
+  EXPECT_EQ(adapter_->GetOutstandingData(), DataSize::Bytes(500));
+
+  // A route with another overhead shares the data in flight of route A.
+  route_a.packet_overhead = 40;
+  adapter_->SetNetworkRoute(route_a);
+  EXPECT_EQ(adapter_->GetOutstandingData(), DataSize::Bytes(2000));
+
+  // Packets sent on other routes are acknowledged but not reported.
+  rtcp::TransportFeedback feedback;
+  feedback.SetBase(0, Timestamp::Millis(100));
+  EXPECT_TRUE(feedback.AddReceivedPacket(0, Timestamp::Millis(100)));
+  EXPECT_TRUE(feedback.AddReceivedPacket(2, Timestamp::Millis(120)));
+  feedback.Build();
+  EXPECT_FALSE(
+      adapter_->ProcessTransportFeedback(feedback, clock_.CurrentTime()));
+  EXPECT_EQ(adapter_->GetOutstandingData(), DataSize::Zero());
+}
+
+TEST_F(TransportFeedbackAdapterTest, TracksRouteAgainAfterItWasRemoved) {
+  rtc::NetworkRoute route_a;
+  route_a.connected = true;
+  route_a.local = rtc::RouteEndpoint::CreateWithNetworkId(1);
+  route_a.remote = rtc::RouteEndpoint::CreateWithNetworkId(2);
+  rtc::NetworkRoute route_b = route_a;
+  route_b.local = rtc::RouteEndpoint::CreateWithNetworkId(3);
+
+  adapter_->SetNetworkRoute(route_a);
+  OnSentPacket(CreatePacket(100, 200, 0, 1000, kPacingInfo0));
+  adapter_->SetNetworkRoute(route_b);
+
+  // Route A is removed once its last packet is acknowledged.
+  rtcp::TransportFeedback feedback;
+  feedback.SetBase(0, Timestamp::Millis(100));
+  EXPECT_TRUE(feedback.AddReceivedPacket(0, Timestamp::Millis(100)));
+  feedback.Build();
+  EXPECT_FALSE(
+      adapter_->ProcessTransportFeedback(feedback, clock_.CurrentTime()));
+
+  adapter_->SetNetworkRoute(route_a);
+  EXPECT_EQ(adapter_->GetOutstandingData(), DataSize::Zero());
+  OnSentPacket(CreatePacket(110, 210, 1, 500, kPacingInfo0));
+  EXPECT_EQ(adapter_->GetOutstandingData(), DataSize::Bytes(500));
+
+  rtcp::TransportFeedback feedback2;
+  feedback2.SetBase(1, Timestamp::Millis(110));
+  EXPECT_TRUE(feedback2.AddReceivedPacket(1, Timestamp::Millis(110)));
+  feedback2.Build();
+  absl::optional<TransportPacketsFeedback> result =
+      adapter_->ProcessTransportFeedback(feedback2, clock_.CurrentTime());
+  ASSERT_TRUE(result.has_value());
+  ASSERT_EQ(result->packet_feedbacks.size(), 1u);
+  EXPECT_EQ(result->packet_feedbacks[0].sent_packet.sequence_number, 1);
+  EXPECT_EQ(adapter_->GetOutstandingData(), DataSize::Zero());
+}
+
+TEST_F(TransportFeedbackAdapterTest, TracksSecondaryRouteSeparately) {
+  rtc::NetworkRoute route;
+  route.connected = true;
+  route.local = rtc::RouteEndpoint::CreateWithNetworkId(1);
+  route.remote = rtc::RouteEndpoint::CreateWithNetworkId(2);
+  rtc::NetworkRoute secondary_route = route;
+  secondary_route.local = rtc::RouteEndpoint::CreateWithNetworkId(3);
+  adapter_->SetNetworkRoute(route);
+  adapter_->SetSecondaryNetworkRoute(secondary_route);
+
+  OnSentPacket(CreatePacket(100, 200, 0, 1000, kPacingInfo0));
+  OnSentPacket(CreatePacket(110, 210, 1, 500, kPacingInfo0),
+               /*on_secondary_route=*/true);
+  OnSentPacket(CreatePacket(120, 220, 2, 1000, kPacingInfo0));
+  EXPECT_EQ(adapter_->GetOutstandingData(), DataSize::Bytes(2000));
+
+  // Only the feedback of the packets sent on the primary route is reported.
+  rtcp::TransportFeedback feedback;
+  feedback.SetBase(0, Timestamp::Millis(100));
+  EXPECT_TRUE(feedback.AddReceivedPacket(0, Timestamp::Millis(100)));
+  EXPECT_TRUE(feedback.AddReceivedPacket(1, Timestamp::Millis(110)));
+  EXPECT_TRUE(feedback.AddReceivedPacket(2, Timestamp::Millis(120)));
+  feedback.Build();
+  absl::optional<TransportPacketsFeedback> result =
+      adapter_->ProcessTransportFeedback(feedback, clock_.CurrentTime());
+  ASSERT_TRUE(result.has_value());
+  ASSERT_EQ(result->packet_feedbacks.size(), 2u);
+  EXPECT_EQ(result->packet_feedbacks[0].sent_packet.sequence_number, 0);
+  EXPECT_EQ(result->packet_feedbacks[1].sent_packet.sequence_number, 2);
+  EXPECT_EQ(adapter_->GetOutstandingData(), DataSize::Zero());
+}
+
+TEST_F(TransportFeedbackAdapterTest, ReportsPacketsOfLargeHistory) {
+  constexpr int kNumPackets = 20000;
+  std::vector<PacketResult> packets;
+  for (int i = 0; i < kNumPackets; ++i) {
+    packets.push_back(CreatePacket(100 + i / 20, 200 + i / 20, i, 1000,
+                                   kPacingInfo0));
+    OnSentPacket(packets.back());
+  }
+  EXPECT_EQ(adapter_->GetOutstandingData(),
+            DataSize::Bytes(kNumPackets * 1000));
+
+  // Acknowledges the oldest half of the packets, in feedback messages of at
+  // most 1000 packets, as sent over the wire.
+  for (int first = 0; first < kNumPackets / 2; first += 1000) {
+    rtcp::TransportFeedback feedback;
+    feedback.SetBase(first, packets[first].receive_time);
+    for (int i = first; i < first + 1000; ++i) {
+      EXPECT_TRUE(feedback.AddReceivedPacket(
+          packets[i].sent_packet.sequence_number, packets[i].receive_time));
+    }
+    feedback.Build();
+    auto res =
+        adapter_->ProcessTransportFeedback(feedback, clock_.CurrentTime());
+    ASSERT_TRUE(res.has_value());
+    ComparePacketFeedbackVectors(
+        std::vector<PacketResult>(packets.begin() + first,
+                                  packets.begin() + first + 1000),
+        res->packet_feedbacks);
+  }
+  EXPECT_EQ(adapter_->GetOutstandingData(),
+            DataSize::Bytes(kNumPackets / 2 * 1000));
+}
+
+TEST_F(TransportFeedbackAdapterTest,
+       AdaptsCongestionControlFeedbackAndPopulatesEcn) {
+  adapter_->EnableCongestionControlFeedbackAccordingToRfc8888();
+  std::vector<PacketResult> packets;
+  packets.push_back(CreatePacket(100, 200, 0, 1500, kPacingInfo0));
+  packets.push_back(CreatePacket(110, 210, 1, 1500, kPacingInfo0));
+  packets.push_back(CreatePacket(120, 220, 2, 1500, kPacingInfo0));
+  for (const auto& packet : packets)
+    OnSentPacket(packet);
+
+  // Packet 1 is lost, and the report is created 10 ms after packet 2 arrived.
+  clock_.AdvanceTime(TimeDelta::Seconds(1));
+  rtcp::CongestionControlFeedback feedback(
+      {{.ssrc = kSsrc,
+        .sequence_number = 0,
+        .arrival_time_offset = TimeDelta::Millis(30),
+        .ecn = EcnMarking::kEct1},
+       {.ssrc = kSsrc, .sequence_number = 1},
+       {.ssrc = kSsrc,
+        .sequence_number = 2,
+        .arrival_time_offset = TimeDelta::Millis(10),
+        .ecn = EcnMarking::kCe}},
+      /*report_timestamp_compact_ntp=*/0x10000);
+  absl::optional<TransportPacketsFeedback> result =
+      adapter_->ProcessCongestionControlFeedback(feedback,
+                                                 clock_.CurrentTime());
+  ASSERT_TRUE(result.has_value());
+  ComparePacketFeedbackVectors(packets, result->packet_feedbacks);
+  EXPECT_TRUE(result->packet_feedbacks[0].IsReceived());
+  EXPECT_EQ(result->packet_feedbacks[0].ecn, EcnMarking::kEct1);
+  EXPECT_FALSE(result->packet_feedbacks[1].IsReceived());
+  EXPECT_TRUE(result->packet_feedbacks[2].IsReceived());
+  EXPECT_EQ(result->packet_feedbacks[2].ecn, EcnMarking::kCe);
+  EXPECT_EQ(result->packet_feedbacks[2].receive_time -
+                result->packet_feedbacks[0].receive_time,
+            TimeDelta::Millis(20));
+  EXPECT_EQ(adapter_->GetOutstandingData(), DataSize::Zero());
+}
+
+TEST_F(TransportFeedbackAdapterTest,
+       CongestionControlFeedbackReceiveTimesFollowReportTimestamps) {
+  adapter_->EnableCongestionControlFeedbackAccordingToRfc8888();
+  std::vector<PacketResult> packets;
+  packets.push_back(CreatePacket(100, 200, 0, 1500, kPacingInfo0));
+  packets.push_back(CreatePacket(1100, 1200, 1, 1500, kPacingInfo0));
+  for (const auto& packet : packets)
+    OnSentPacket(packet);
+
+  // Both reports are created when the packet arrives, one second apart.
+  rtcp::CongestionControlFeedback first_feedback(
+      {{.ssrc = kSsrc,
+        .sequence_number = 0,
+        .arrival_time_offset = TimeDelta::Zero()}},
+      /*report_timestamp_compact_ntp=*/0xFFFF8000);
+  absl::optional<TransportPacketsFeedback> first_result =
+      adapter_->ProcessCongestionControlFeedback(first_feedback,
+                                                 clock_.CurrentTime());
+  rtcp::CongestionControlFeedback second_feedback(
+      {{.ssrc = kSsrc,
+        .sequence_number = 1,
+        .arrival_time_offset = TimeDelta::Zero()}},
+      /*report_timestamp_compact_ntp=*/0x00008000);
+  absl::optional<TransportPacketsFeedback> second_result =
+      adapter_->ProcessCongestionControlFeedback(second_feedback,
+                                                 clock_.CurrentTime());
+  ASSERT_TRUE(first_result.has_value());
+  ASSERT_TRUE(second_result.has_value());
+  ASSERT_EQ(first_result->packet_feedbacks.size(), 1u);
+  ASSERT_EQ(second_result->packet_feedbacks.size(), 1u);
+  EXPECT_EQ(second_result->packet_feedbacks[0].receive_time -
+                first_result->packet_feedbacks[0].receive_time,
+            TimeDelta::Seconds(1));
+}
+
+TEST_F(TransportFeedbackAdapterTest,
+       IgnoresCongestionControlFeedbackAboutUnknownPackets) {
+  adapter_->EnableCongestionControlFeedbackAccordingToRfc8888();
+  OnSentPacket(CreatePacket(100, 200, 0, 1500, kPacingInfo0));
+
+  rtcp::CongestionControlFeedback feedback(
+      {{.ssrc = kSsrc + 1,
+        .sequence_number = 0,
+        .arrival_time_offset = TimeDelta::Zero()}},
+      /*report_timestamp_compact_ntp=*/0);
+  EXPECT_FALSE(adapter_
+                   ->ProcessCongestionControlFeedback(feedback,
+                                                      clock_.CurrentTime())
+                   .has_value());
+  EXPECT_EQ(adapter_->GetOutstandingData(), DataSize::Bytes(1500));
+}
+
+TEST_F(TransportFeedbackAdapterTest,
+       IgnoresCongestionControlFeedbackUnlessEnabled) {
+  OnSentPacket(CreatePacket(100, 200, 0, 1500, kPacingInfo0));
+
+  rtcp::CongestionControlFeedback feedback(
+      {{.ssrc = kSsrc,
+        .sequence_number = 0,
+        .arrival_time_offset = TimeDelta::Zero()}},
+      /*report_timestamp_compact_ntp=*/0);
+  EXPECT_FALSE(adapter_
+                   ->ProcessCongestionControlFeedback(feedback,
+                                                      clock_.CurrentTime())
+                   .has_value());
+  EXPECT_EQ(adapter_->GetOutstandingData(), DataSize::Bytes(1500));
+}
+
 }  // namespace webrtc
@@ -11,6 +11,7 @@
 #include "modules/pacing/bitrate_prober.h"
 
 #include <algorithm>
+#include <vector>
 
 #include "api/units/data_size.h"
 #include "rtc_base/checks.h"
@@ -28,8 +29,10 @@ BitrateProberConfig::BitrateProberConfig(
     const FieldTrialsView* key_value_config)
     : min_probe_delta("min_probe_delta", TimeDelta::Millis(2)),
       max_probe_delay("max_probe_delay", TimeDelta::Millis(10)),
-      min_packet_size("min_packet_size", DataSize::Bytes(200)) {
-  ParseFieldTrial({&min_probe_delta, &max_probe_delay, &min_packet_size},
+      min_packet_size("min_packet_size", DataSize::Bytes(200)),
+      precomputed_schedule("precomputed_schedule", false) {
+  ParseFieldTrial({&min_probe_delta, &max_probe_delay, &min_packet_size,
+                   &precomputed_schedule},
                   key_value_config->Lookup("WebRTC-Bwe-ProbingBehavior"));
 }
 
@@ -99,6 +102,9 @@ void BitrateProber::CreateProbeCluster(
   RTC_DCHECK_GE(cluster.pace_info.probe_cluster_min_bytes, 0);
   cluster.pace_info.send_bitrate_bps = cluster_config.target_data_rate.bps();
   cluster.pace_info.probe_cluster_id = cluster_config.id;
+  if (config_.precomputed_schedule) {
+    cluster.schedule = CreateSchedule(cluster);
+  }
   clusters_.push(cluster);
 
   if (ReadyToSetActiveState(/*packet_size=*/DataSize::Zero())) {
@@ -158,6 +164,41 @@ DataSize BitrateProber::RecommendedMinProbeSize() const {
   return send_rate * config_.min_probe_delta;
 }
 
+DataSize BitrateProber::RecommendedProbeSize(Timestamp now) const {
+  if (clusters_.empty() || clusters_.front().schedule.empty()) {
+    return RecommendedMinProbeSize();
+  }
+  const ProbeCluster& cluster = clusters_.front();
+  const std::vector<ScheduledProbe>& schedule = cluster.schedule;
+  size_t next = cluster.sent_probes;
+  if (next >= schedule.size()) {
+    return RecommendedMinProbeSize();
+  }
+  if (cluster.started_at.IsFinite()) {
+    // Catch up with all probes that are due, e.g. if the pacer was woken up
+    // late.
+    const TimeDelta elapsed = now - cluster.started_at;
+    while (next + 1 < schedule.size() && schedule[next + 1].offset <= elapsed) {
+      ++next;
+    }
+  }
+  return schedule[next].cumulative_size - DataSize::Bytes(cluster.sent_bytes);
+}
+
+DataSize BitrateProber::RemainingClusterSize() const {
+  if (clusters_.empty()) {
+    return DataSize::Zero();
+  }
+  const ProbeCluster& cluster = clusters_.front();
+  const DataSize cluster_size =
+      cluster.schedule.empty()
+          ? DataSize::Bytes(cluster.pace_info.probe_cluster_min_bytes)
+          : cluster.schedule.back().cumulative_size;
+  const DataSize sent_size = DataSize::Bytes(cluster.sent_bytes);
+  return cluster_size > sent_size ? cluster_size - sent_size
+                                  : DataSize::Zero();
+}
+
 void BitrateProber::ProbeSent(Timestamp now, DataSize size) {
   RTC_DCHECK(probing_state_ == ProbingState::kActive);
   RTC_DCHECK(!size.IsZero());
@@ -169,7 +210,14 @@ void BitrateProber::ProbeSent(Timestamp now, DataSize size) {
       cluster->started_at = now;
     }
     cluster->sent_bytes += size.bytes<int>();
-    cluster->sent_probes += 1;
+    int sent_probes = cluster->sent_probes + 1;
+    // A burst may cover several scheduled probes.
+    while (sent_probes < static_cast<int>(cluster->schedule.size()) &&
+           cluster->schedule[sent_probes].cumulative_size.bytes() <=
+               cluster->sent_bytes) {
+      ++sent_probes;
+    }
+    cluster->sent_probes = sent_probes;
     next_probe_time_ = CalculateNextProbeTime(*cluster);
     if (cluster->sent_bytes >= cluster->pace_info.probe_cluster_min_bytes &&
         cluster->sent_probes >= cluster->pace_info.probe_cluster_min_probes) {
@@ -186,6 +234,10 @@ Timestamp BitrateProber::CalculateNextProbeTime(
   RTC_CHECK_GT(cluster.pace_info.send_bitrate_bps, 0);
   RTC_CHECK(cluster.started_at.IsFinite());
 
+  if (cluster.sent_probes < static_cast<int>(cluster.schedule.size())) {
+    return cluster.started_at + cluster.schedule[cluster.sent_probes].offset;
+  }
+
   // Compute the time delta from the cluster start to ensure probe bitrate stays
   // close to the target bitrate. Result is in milliseconds.
   DataSize sent_bytes = DataSize::Bytes(cluster.sent_bytes);
@@ -196,4 +248,27 @@ Timestamp BitrateProber::CalculateNextProbeTime(
   return cluster.started_at + delta;
 }
 
+std::vector<BitrateProber::ScheduledProbe> BitrateProber::CreateSchedule(
+    const ProbeCluster& cluster) const {
+  RTC_CHECK_GT(cluster.pace_info.send_bitrate_bps, 0);
+  const DataRate send_bitrate =
+      DataRate::BitsPerSec(cluster.pace_info.send_bitrate_bps);
+  const DataSize probe_size =
+      std::max(send_bitrate * config_.min_probe_delta, DataSize::Bytes(1));
+  const int num_probes = std::max<int>(
+      cluster.pace_info.probe_cluster_min_probes,
+      (cluster.pace_info.probe_cluster_min_bytes + probe_size.bytes() - 1) /
+          probe_size.bytes());
+
+  std::vector<ScheduledProbe> schedule;
+  schedule.reserve(num_probes);
+  for (int i = 0; i < num_probes; ++i) {
+    // Like CalculateNextProbeTime(), each probe is due when the probes before
+    // it have been sent at the target bitrate.
+    schedule.push_back({.offset = (i * probe_size) / send_bitrate,
+                        .cumulative_size = (i + 1) * probe_size});
+  }
+  return schedule;
+}
+
 }  // namespace webrtc
@@ -15,6 +15,7 @@
 #include <stdint.h>
 
 #include <queue>
+#include <vector>
 
 #include "api/transport/field_trial_based_config.h"
 #include "api/transport/network_types.h"
@@ -38,6 +39,9 @@ struct BitrateProberConfig {
   // This defines the max min packet size, meaning that on high bitrates
   // a packet of at least this size is needed to trigger sending a probe.
   FieldTrialParameter<DataSize> min_packet_size;
+  // If set, the send schedule of a cluster is computed once when it is
+  // created and all probes that are due are sent as one burst.
+  FieldTrialParameter<bool> precomputed_schedule;
 };
 
 // Note that this class isn't thread-safe by itself and therefore relies
@@ -75,6 +79,20 @@ class BitrateProber {
   // packets that are sent back to back.
   DataSize RecommendedMinProbeSize() const;
 
+  // Returns the number of bytes to send now to keep up with the schedule of
+  // the current cluster, or zero if not probing. With a precomputed schedule
+  // this covers all probes that are due at `now`, otherwise it is the same as
+  // RecommendedMinProbeSize().
+  DataSize RecommendedProbeSize(Timestamp now) const;
+
+  // Returns the number of bytes still to send in the current cluster, or zero
+  // if not probing.
+  DataSize RemainingClusterSize() const;
+
+  bool has_precomputed_schedule() const {
+    return config_.precomputed_schedule.Get();
+  }
+
   // Called to report to the prober that a probe has been sent. In case of
   // multiple packets per probe, this call would be made at the end of sending
   // the last packet in probe. `size` is the total size of all packets in probe.
@@ -92,10 +110,19 @@ class BitrateProber {
     kActive,
   };
 
+  struct ScheduledProbe {
+    // Send time relative to the start of the cluster.
+    TimeDelta offset;
+    // Bytes sent in the cluster when this probe has been sent.
+    DataSize cumulative_size;
+  };
+
   // A probe cluster consists of a set of probes. Each probe in turn can be
   // divided into a number of packets to accommodate the MTU on the network.
   struct ProbeCluster {
     PacedPacketInfo pace_info;
+    // Only used with a precomputed schedule.
+    std::vector<ScheduledProbe> schedule;
 
     int sent_probes = 0;
     int sent_bytes = 0;
@@ -106,6 +133,8 @@ class BitrateProber {
 
   Timestamp CalculateNextProbeTime(const ProbeCluster& cluster) const;
   bool ReadyToSetActiveState(DataSize packet_size) const;
+  std::vector<ScheduledProbe> CreateSchedule(
+      const ProbeCluster& cluster) const;
 
   ProbingState probing_state_;
 
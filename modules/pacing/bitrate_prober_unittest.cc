@@ -408,4 +408,60 @@ TEST(BitrateProberTest, CanProbeImmediatelyAgainAfterProbeIfConfigured) {
   EXPECT_TRUE(prober.is_probing());
 }
 
+TEST(BitrateProberTest, FollowsPrecomputedSchedule) {
+  const test::ExplicitKeyValueConfig trials(
+      "WebRTC-Bwe-ProbingBehavior/precomputed_schedule:true/");
+  BitrateProber prober(trials);
+  ASSERT_TRUE(prober.has_precomputed_schedule());
+  const DataRate kBitrate = DataRate::KilobitsPerSec(900);
+  // 2 ms worth of data at the target bitrate.
+  const DataSize kProbeSize = kBitrate * TimeDelta::Millis(2);
+
+  Timestamp now = Timestamp::Zero();
+  prober.CreateProbeCluster({.at_time = now,
+                             .target_data_rate = kBitrate,
+                             .target_duration = TimeDelta::Millis(15),
+                             .target_probe_count = 5,
+                             .id = 0});
+  prober.OnIncomingPacket(DataSize::Bytes(1000));
+  ASSERT_TRUE(prober.is_probing());
+  // The cluster is 8 probes long to reach the target duration.
+  EXPECT_EQ(prober.RemainingClusterSize(), 8 * kProbeSize);
+  EXPECT_EQ(prober.RecommendedProbeSize(now), kProbeSize);
+
+  const Timestamp start_time = now;
+  for (int i = 0; i < 8; ++i) {
+    now = std::max(now, prober.NextProbeTime(now));
+    EXPECT_EQ(now - start_time, i * TimeDelta::Millis(2));
+    prober.ProbeSent(now, prober.RecommendedProbeSize(now));
+  }
+  EXPECT_FALSE(prober.is_probing());
+  EXPECT_EQ(prober.RemainingClusterSize(), DataSize::Zero());
+}
+
+TEST(BitrateProberTest, SendsDueProbesInOneBurstWithPrecomputedSchedule) {
+  const test::ExplicitKeyValueConfig trials(
+      "WebRTC-Bwe-ProbingBehavior/precomputed_schedule:true/");
+  BitrateProber prober(trials);
+  const DataRate kBitrate = DataRate::KilobitsPerSec(900);
+  const DataSize kProbeSize = kBitrate * TimeDelta::Millis(2);
+
+  Timestamp now = Timestamp::Zero();
+  prober.CreateProbeCluster({.at_time = now,
+                             .target_data_rate = kBitrate,
+                             .target_duration = TimeDelta::Millis(15),
+                             .target_probe_count = 5,
+                             .id = 0});
+  prober.OnIncomingPacket(DataSize::Bytes(1000));
+  prober.ProbeSent(now, kProbeSize);
+
+  // Woken up 5 ms late, the probes due at 2, 4 and 6 ms are sent together.
+  now += TimeDelta::Millis(7);
+  EXPECT_EQ(prober.RecommendedProbeSize(now), 3 * kProbeSize);
+  prober.ProbeSent(now, 3 * kProbeSize);
+  // The burst counts as three probes, the next one is due at 8 ms.
+  EXPECT_EQ(prober.NextProbeTime(now), Timestamp::Millis(8));
+  EXPECT_EQ(prober.RemainingClusterSize(), 4 * kProbeSize);
+}
+
 }  // namespace webrtc
@@ -79,12 +79,15 @@ PacingController::PacingController(Clock* clock,
       pacing_rate_(DataRate::Zero()),
       adjusted_media_rate_(DataRate::Zero()),
       padding_rate_(DataRate::Zero()),
+      secondary_route_debt_(DataSize::Zero()),
+      secondary_route_rate_(DataRate::Zero()),
       prober_(field_trials_),
       probing_send_failure_(false),
       last_process_time_(clock->CurrentTime()),
       last_send_time_(last_process_time_),
       seen_first_packet_(false),
       packet_queue_(/*creation_time=*/last_process_time_),
+      secondary_packet_queue_(/*creation_time=*/last_process_time_),
       congested_(false),
       queue_time_limit_(kMaxExpectedQueueLength),
       account_for_audio_(false),
@@ -109,14 +112,18 @@ void PacingController::Pause() {
   if (!paused_)
     RTC_LOG(LS_INFO) << "PacedSender paused.";
   paused_ = true;
-  packet_queue_.SetPauseState(true, CurrentTime());
+  const Timestamp now = CurrentTime();
+  packet_queue_.SetPauseState(true, now);
+  secondary_packet_queue_.SetPauseState(true, now);
 }
 
 void PacingController::Resume() {
   if (paused_)
     RTC_LOG(LS_INFO) << "PacedSender resumed.";
   paused_ = false;
-  packet_queue_.SetPauseState(false, CurrentTime());
+  const Timestamp now = CurrentTime();
+  packet_queue_.SetPauseState(false, now);
+  secondary_packet_queue_.SetPauseState(false, now);
 }
 
 bool PacingController::IsPaused() const {
@@ -136,6 +143,13 @@ void PacingController::SetCircuitBreakerThreshold(int num_iterations) {
 
 void PacingController::RemovePacketsForSsrc(uint32_t ssrc) {
   packet_queue_.RemovePacketsForSsrc(ssrc);
+  secondary_packet_queue_.RemovePacketsForSsrc(ssrc);
+  probe_padding_.erase(
+      std::remove_if(probe_padding_.begin(), probe_padding_.end(),
+                     [ssrc](const std::unique_ptr<RtpPacketToSend>& packet) {
+                       return packet->Ssrc() == ssrc;
+                     }),
+      probe_padding_.end());
 }
 
 bool PacingController::IsProbing() const {
@@ -186,6 +200,19 @@ void PacingController::SetPacingRates(DataRate pacing_rate,
                       << " padding_budget_kbps=" << padding_rate.kbps();
 }
 
+void PacingController::SetSecondaryRoutePacingRate(DataRate secondary_rate) {
+  RTC_CHECK_GE(secondary_rate, DataRate::Zero());
+  secondary_route_rate_ = secondary_rate;
+  if (secondary_route_rate_.IsZero()) {
+    secondary_route_debt_ = DataSize::Zero();
+    // Nothing more will be sent on the secondary route, hand the packets
+    // waiting for it over to the primary route. They keep their enqueue times,
+    // so they are neither sent later nor reported with shorter queue times
+    // than if they had been queued for the primary route to begin with.
+    packet_queue_.TakePacketsFrom(secondary_packet_queue_, CurrentTime());
+  }
+}
+
 void PacingController::EnqueuePacket(std::unique_ptr<RtpPacketToSend> packet) {
   RTC_DCHECK(pacing_rate_ > DataRate::Zero())
       << "SetPacingRate must be called before InsertPacket.";
@@ -198,18 +225,18 @@ void PacingController::EnqueuePacket(std::unique_ptr<RtpPacketToSend> packet) {
     // First packet of a keyframe (and no keyframe packets currently in the
     // queue). Flush any pending packets currently in the queue for that stream
     // in order to get the new keyframe out as quickly as possible.
-    packet_queue_.RemovePacketsForSsrc(packet->Ssrc());
+    RemovePacketsForSsrc(packet->Ssrc());
     absl::optional<uint32_t> rtx_ssrc =
         packet_sender_->GetRtxSsrcForMedia(packet->Ssrc());
     if (rtx_ssrc) {
-      packet_queue_.RemovePacketsForSsrc(*rtx_ssrc);
+      RemovePacketsForSsrc(*rtx_ssrc);
     }
   }
 
   prober_.OnIncomingPacket(DataSize::Bytes(packet->payload_size()));
 
   const Timestamp now = CurrentTime();
-  if (packet_queue_.Empty()) {
+  if (PacketQueuesEmpty()) {
     // If queue is empty, we need to "fast-forward" the last process time,
     // so that we don't use passed time as budget for sending the first new
     // packet.
@@ -222,7 +249,11 @@ void PacingController::EnqueuePacket(std::unique_ptr<RtpPacketToSend> packet) {
     }
     UpdateBudgetWithElapsedTime(UpdateTimeAndGetElapsed(target_process_time));
   }
-  packet_queue_.Push(now, std::move(packet));
+  if (UsesSecondaryRoute(*packet->packet_type())) {
+    secondary_packet_queue_.Push(now, std::move(packet));
+  } else {
+    packet_queue_.Push(now, std::move(packet));
+  }
   seen_first_packet_ = true;
 
   // Queue length has increased, check if we need to change the pacing rate.
@@ -249,27 +280,58 @@ void PacingController::SetSendBurstInterval(TimeDelta burst_interval) {
 
 TimeDelta PacingController::ExpectedQueueTime() const {
   RTC_DCHECK_GT(adjusted_media_rate_, DataRate::Zero());
-  return QueueSizeData() / adjusted_media_rate_;
+  TimeDelta queue_time = QueueSizeData(packet_queue_) / adjusted_media_rate_;
+  if (!secondary_packet_queue_.Empty() &&
+      secondary_route_rate_ > DataRate::Zero()) {
+    // The routes drain in parallel.
+    queue_time =
+        std::max(queue_time, QueueSizeData(secondary_packet_queue_) /
+                                 secondary_route_rate_);
+  }
+  return queue_time;
 }
 
 size_t PacingController::QueueSizePackets() const {
-  return rtc::checked_cast<size_t>(packet_queue_.SizeInPackets());
+  return rtc::checked_cast<size_t>(packet_queue_.SizeInPackets() +
+                                   secondary_packet_queue_.SizeInPackets());
 }
 
-const std::array<int, kNumMediaTypes>&
+std::array<int, kNumMediaTypes>
 PacingController::SizeInPacketsPerRtpPacketMediaType() const {
-  return packet_queue_.SizeInPacketsPerRtpPacketMediaType();
+  std::array<int, kNumMediaTypes> size_packets =
+      packet_queue_.SizeInPacketsPerRtpPacketMediaType();
+  for (size_t i = 0; i < size_packets.size(); ++i) {
+    size_packets[i] +=
+        secondary_packet_queue_.SizeInPacketsPerRtpPacketMediaType()[i];
+  }
+  return size_packets;
 }
 
 DataSize PacingController::QueueSizeData() const {
-  DataSize size = packet_queue_.SizeInPayloadBytes();
+  return QueueSizeData(packet_queue_) + QueueSizeData(secondary_packet_queue_);
+}
+
+DataSize PacingController::QueueSizeData(
+    const PrioritizedPacketQueue& queue) const {
+  DataSize size = queue.SizeInPayloadBytes();
   if (include_overhead_) {
-    size += static_cast<int64_t>(packet_queue_.SizeInPackets()) *
+    size += static_cast<int64_t>(queue.SizeInPackets()) *
             transport_overhead_per_packet_;
   }
   return size;
 }
 
+bool PacingController::UsesSecondaryRoute(
+    RtpPacketMediaType packet_type) const {
+  return secondary_route_rate_ > DataRate::Zero() &&
+         (packet_type == RtpPacketMediaType::kRetransmission ||
+          packet_type == RtpPacketMediaType::kForwardErrorCorrection);
+}
+
+bool PacingController::PacketQueuesEmpty() const {
+  return packet_queue_.Empty() && secondary_packet_queue_.Empty();
+}
+
 DataSize PacingController::CurrentBufferLevel() const {
   return std::max(media_debt_, padding_debt_);
 }
@@ -279,7 +341,14 @@ absl::optional<Timestamp> PacingController::FirstSentPacketTime() const {
 }
 
 Timestamp PacingController::OldestPacketEnqueueTime() const {
-  return packet_queue_.OldestEnqueueTime();
+  if (secondary_packet_queue_.Empty()) {
+    return packet_queue_.OldestEnqueueTime();
+  }
+  if (packet_queue_.Empty()) {
+    return secondary_packet_queue_.OldestEnqueueTime();
+  }
+  return std::min(packet_queue_.OldestEnqueueTime(),
+                  secondary_packet_queue_.OldestEnqueueTime());
 }
 
 TimeDelta PacingController::UpdateTimeAndGetElapsed(Timestamp now) {
@@ -328,7 +397,11 @@ Timestamp PacingController::NextSendTime() const {
 
   // If queue contains a packet which should not be paced, its target send time
   // is the time at which it was enqueued.
-  Timestamp unpaced_send_time = NextUnpacedSendTime();
+  Timestamp unpaced_send_time = NextUnpacedSendTime(packet_queue_);
+  if (unpaced_send_time.IsFinite()) {
+    return unpaced_send_time;
+  }
+  unpaced_send_time = NextUnpacedSendTime(secondary_packet_queue_);
   if (unpaced_send_time.IsFinite()) {
     return unpaced_send_time;
   }
@@ -339,13 +412,7 @@ Timestamp PacingController::NextSendTime() const {
   }
 
   if (adjusted_media_rate_ > DataRate::Zero() && !packet_queue_.Empty()) {
-    // If packets are allowed to be sent in a burst, the
-    // debt is allowed to grow up to one packet more than what can be sent
-    // during 'send_burst_period_'.
-    TimeDelta drain_time = media_debt_ / adjusted_media_rate_;
-    next_send_time =
-        last_process_time_ +
-        ((send_burst_interval_ > drain_time) ? TimeDelta::Zero() : drain_time);
+    next_send_time = NextSendTimeOnRoute(media_debt_, adjusted_media_rate_);
   } else if (padding_rate_ > DataRate::Zero() && packet_queue_.Empty()) {
     // If we _don't_ have pending packets, check how long until we have
     // bandwidth for padding packets. Both media and padding debts must
@@ -366,6 +433,14 @@ Timestamp PacingController::NextSendTime() const {
     next_send_time = last_process_time_ + kPausedProcessInterval;
   }
 
+  if (!secondary_packet_queue_.Empty()) {
+    // The secondary route is paced independently of the primary one.
+    RTC_DCHECK_GT(secondary_route_rate_, DataRate::Zero());
+    next_send_time = std::min(
+        next_send_time,
+        NextSendTimeOnRoute(secondary_route_debt_, secondary_route_rate_));
+  }
+
   if (send_padding_if_silent_) {
     next_send_time =
         std::min(next_send_time, last_send_time_ + kPausedProcessInterval);
@@ -374,6 +449,16 @@ Timestamp PacingController::NextSendTime() const {
   return next_send_time;
 }
 
+Timestamp PacingController::NextSendTimeOnRoute(DataSize debt,
+                                                DataRate rate) const {
+  // If packets are allowed to be sent in a burst, the
+  // debt is allowed to grow up to one packet more than what can be sent
+  // during 'send_burst_period_'.
+  TimeDelta drain_time = debt / rate;
+  return last_process_time_ +
+         ((send_burst_interval_ > drain_time) ? TimeDelta::Zero() : drain_time);
+}
+
 void PacingController::ProcessPackets() {
   absl::Cleanup cleanup = [packet_sender = packet_sender_] {
     packet_sender->OnBatchComplete();
@@ -397,7 +482,8 @@ void PacingController::ProcessPackets() {
         }
       }
     }
-    OnPacketSent(RtpPacketMediaType::kPadding, keepalive_data_sent, now);
+    OnPacketSent(RtpPacketMediaType::kPadding, keepalive_data_sent, now,
+                 /*on_secondary_route=*/false);
   }
 
   if (paused_) {
@@ -429,7 +515,7 @@ void PacingController::ProcessPackets() {
     // use actual send time rather than target.
     pacing_info = prober_.CurrentCluster(now).value_or(PacedPacketInfo());
     if (pacing_info.probe_cluster_id != PacedPacketInfo::kNotAProbe) {
-      recommended_probe_size = prober_.RecommendedMinProbeSize();
+      recommended_probe_size = prober_.RecommendedProbeSize(now);
       RTC_DCHECK_GT(recommended_probe_size, DataSize::Zero());
     } else {
       // No valid probe cluster returned, probe might have timed out.
@@ -458,12 +544,25 @@ void PacingController::ProcessPackets() {
 
       DataSize padding_to_add = PaddingToAdd(recommended_probe_size, data_sent);
       if (padding_to_add > DataSize::Zero()) {
+        // With a precomputed probe schedule, the padding for the rest of the
+        // cluster is fetched at once instead of once per probe. Padding that
+        // is left when the cluster ends is dropped.
+        const bool batch_probe_padding =
+            is_probing && prober_.has_precomputed_schedule();
+        if (batch_probe_padding) {
+          padding_to_add = std::max(
+              padding_to_add, prober_.RemainingClusterSize() - data_sent);
+        }
         std::vector<std::unique_ptr<RtpPacketToSend>> padding_packets =
             packet_sender_->GeneratePadding(padding_to_add);
         if (!padding_packets.empty()) {
           padding_packets_generated += padding_packets.size();
           for (auto& packet : padding_packets) {
-            EnqueuePacket(std::move(packet));
+            if (batch_probe_padding) {
+              probe_padding_.push_back(std::move(packet));
+            } else {
+              EnqueuePacket(std::move(packet));
+            }
           }
           // Continue loop to send the padding that was just added.
           continue;
@@ -479,6 +578,7 @@ void PacingController::ProcessPackets() {
       RTC_DCHECK(rtp_packet);
       RTC_DCHECK(rtp_packet->packet_type().has_value());
       const RtpPacketMediaType packet_type = *rtp_packet->packet_type();
+      const bool on_secondary_route = rtp_packet->send_on_secondary_route();
       DataSize packet_size = DataSize::Bytes(rtp_packet->payload_size() +
                                              rtp_packet->padding_size());
 
@@ -495,7 +595,7 @@ void PacingController::ProcessPackets() {
       ++packets_sent;
 
       // Send done, update send time.
-      OnPacketSent(packet_type, packet_size, now);
+      OnPacketSent(packet_type, packet_size, now, on_secondary_route);
 
       if (is_probing) {
         pacing_info.probe_cluster_bytes_sent += packet_size.bytes();
@@ -555,6 +655,9 @@ void PacingController::ProcessPackets() {
       prober_.ProbeSent(CurrentTime(), data_sent);
     }
   }
+  if (!prober_.is_probing()) {
+    probe_padding_.clear();
+  }
 
   // Queue length has probably decreased, check if pacing rate needs to updated.
   // Poll the time again, since we might have enqueued new fec/padding packets
@@ -607,18 +710,41 @@ std::unique_ptr<RtpPacketToSend> PacingController::GetPendingPacket(
     }
   }
 
+  // Probes are only sent on the primary route.
+  if (!is_probe) {
+    std::unique_ptr<RtpPacketToSend> packet =
+        GetPendingPacketForSecondaryRoute(now);
+    if (packet != nullptr) {
+      return packet;
+    }
+  }
+
   if (packet_queue_.Empty()) {
+    // Media preempts the padding fetched for the probe cluster.
+    if (is_probe && !probe_padding_.empty()) {
+      std::unique_ptr<RtpPacketToSend> padding =
+          std::move(probe_padding_.front());
+      probe_padding_.pop_front();
+      return padding;
+    }
     return nullptr;
   }
 
   // First, check if there is any reason _not_ to send the next queued packet.
   // Unpaced packets and probes are exempted from send checks.
-  if (NextUnpacedSendTime().IsInfinite() && !is_probe) {
+  if (NextUnpacedSendTime(packet_queue_).IsInfinite() && !is_probe) {
     if (congested_) {
       // Don't send anything if congested.
       return nullptr;
     }
 
+    if (!secondary_packet_queue_.Empty() &&
+        NextSendTimeOnRoute(media_debt_, adjusted_media_rate_) > now) {
+      // The target send time was set by the secondary route, the primary
+      // route has no budget yet.
+      return nullptr;
+    }
+
     if (now <= target_send_time && send_burst_interval_.IsZero()) {
       // We allow sending slightly early if we think that we would actually
       // had been able to, had we been right on time - i.e. the current debt
@@ -635,16 +761,38 @@ std::unique_ptr<RtpPacketToSend> PacingController::GetPendingPacket(
   return packet_queue_.Pop();
 }
 
+std::unique_ptr<RtpPacketToSend>
+PacingController::GetPendingPacketForSecondaryRoute(Timestamp now) {
+  if (secondary_packet_queue_.Empty()) {
+    return nullptr;
+  }
+  if (NextUnpacedSendTime(secondary_packet_queue_).IsInfinite()) {
+    if (congested_ ||
+        NextSendTimeOnRoute(secondary_route_debt_, secondary_route_rate_) >
+            now) {
+      return nullptr;
+    }
+  }
+  std::unique_ptr<RtpPacketToSend> packet = secondary_packet_queue_.Pop();
+  packet->set_send_on_secondary_route(true);
+  return packet;
+}
+
 void PacingController::OnPacketSent(RtpPacketMediaType packet_type,
                                     DataSize packet_size,
-                                    Timestamp send_time) {
+                                    Timestamp send_time,
+                                    bool on_secondary_route) {
   if (!first_sent_packet_time_ && packet_type != RtpPacketMediaType::kPadding) {
     first_sent_packet_time_ = send_time;
   }
 
   bool audio_packet = packet_type == RtpPacketMediaType::kAudio;
   if ((!audio_packet || account_for_audio_) && packet_size > DataSize::Zero()) {
-    UpdateBudgetWithSentData(packet_size);
+    if (on_secondary_route) {
+      UpdateSecondaryRouteBudgetWithSentData(packet_size);
+    } else {
+      UpdateBudgetWithSentData(packet_size);
+    }
   }
 
   last_send_time_ = send_time;
@@ -653,6 +801,8 @@ void PacingController::OnPacketSent(RtpPacketMediaType packet_type,
 void PacingController::UpdateBudgetWithElapsedTime(TimeDelta delta) {
   media_debt_ -= std::min(media_debt_, adjusted_media_rate_ * delta);
   padding_debt_ -= std::min(padding_debt_, padding_rate_ * delta);
+  secondary_route_debt_ -=
+      std::min(secondary_route_debt_, secondary_route_rate_ * delta);
 }
 
 void PacingController::UpdateBudgetWithSentData(DataSize size) {
@@ -666,6 +816,12 @@ void PacingController::UpdatePaddingBudgetWithSentData(DataSize size) {
   padding_debt_ = std::min(padding_debt_, padding_rate_ * kMaxDebtInTime);
 }
 
+void PacingController::UpdateSecondaryRouteBudgetWithSentData(DataSize size) {
+  secondary_route_debt_ += size;
+  secondary_route_debt_ =
+      std::min(secondary_route_debt_, secondary_route_rate_ * kMaxDebtInTime);
+}
+
 void PacingController::SetQueueTimeLimit(TimeDelta limit) {
   queue_time_limit_ = limit;
 }
@@ -676,7 +832,7 @@ void PacingController::MaybeUpdateMediaRateDueToLongQueue(Timestamp now) {
     return;
   }
 
-  DataSize queue_size_data = QueueSizeData();
+  DataSize queue_size_data = QueueSizeData(packet_queue_);
   if (queue_size_data > DataSize::Zero()) {
     // Assuming equal size packets and input/output rate, the average packet
     // has avg_time_left_ms left to get queue_size_bytes out of the queue, if
@@ -694,18 +850,18 @@ void PacingController::MaybeUpdateMediaRateDueToLongQueue(Timestamp now) {
   }
 }
 
-Timestamp PacingController::NextUnpacedSendTime() const {
+Timestamp PacingController::NextUnpacedSendTime(
+    const PrioritizedPacketQueue& queue) const {
   if (!pace_audio_) {
     Timestamp leading_audio_send_time =
-        packet_queue_.LeadingPacketEnqueueTime(RtpPacketMediaType::kAudio);
+        queue.LeadingPacketEnqueueTime(RtpPacketMediaType::kAudio);
     if (leading_audio_send_time.IsFinite()) {
       return leading_audio_send_time;
     }
   }
   if (fast_retransmissions_) {
     Timestamp leading_retransmission_send_time =
-        packet_queue_.LeadingPacketEnqueueTime(
-            RtpPacketMediaType::kRetransmission);
+        queue.LeadingPacketEnqueueTime(RtpPacketMediaType::kRetransmission);
     if (leading_retransmission_send_time.IsFinite()) {
       return leading_retransmission_send_time;
     }
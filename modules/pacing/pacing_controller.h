@@ -16,6 +16,7 @@
 
 #include <array>
 #include <atomic>
+#include <deque>
 #include <memory>
 #include <vector>
 
@@ -110,6 +111,17 @@ class PacingController {
   void SetPacingRates(DataRate pacing_rate, DataRate padding_rate);
   DataRate pacing_rate() const { return adjusted_media_rate_; }
 
+  // Enables pacing over two routes, each with a budget of its own. While
+  // `secondary_rate` is non-zero, retransmissions and FEC packets are queued
+  // separately and paced at `secondary_rate`, and are sent with
+  // RtpPacketToSend::send_on_secondary_route() set. They then neither use the
+  // media budget of the primary route nor wait behind its media packets.
+  // Probes and padding are always sent on the primary route. Setting a zero
+  // rate moves the packets queued for the secondary route back to the primary
+  // one, where they keep their enqueue times.
+  void SetSecondaryRoutePacingRate(DataRate secondary_rate);
+  DataRate secondary_route_pacing_rate() const { return secondary_route_rate_; }
+
   // Currently audio traffic is not accounted by pacer and passed through.
   // With the introduction of audio BWE audio traffic will be accounted for
   // the pacer budget calculation. The audio traffic still will be injected
@@ -130,8 +142,7 @@ class PacingController {
   size_t QueueSizePackets() const;
   // Number of packets in the pacer queue per media type (RtpPacketMediaType
   // values are used as lookup index).
-  const std::array<int, kNumMediaTypes>& SizeInPacketsPerRtpPacketMediaType()
-      const;
+  std::array<int, kNumMediaTypes> SizeInPacketsPerRtpPacketMediaType() const;
   // Totals size of packets in the pacer queue.
   DataSize QueueSizeData() const;
 
@@ -177,6 +188,14 @@ class PacingController {
   void UpdateBudgetWithElapsedTime(TimeDelta delta);
   void UpdateBudgetWithSentData(DataSize size);
   void UpdatePaddingBudgetWithSentData(DataSize size);
+  void UpdateSecondaryRouteBudgetWithSentData(DataSize size);
+
+  bool UsesSecondaryRoute(RtpPacketMediaType packet_type) const;
+  bool PacketQueuesEmpty() const;
+  DataSize QueueSizeData(const PrioritizedPacketQueue& queue) const;
+  // Returns the time when the debt of a route with the given debt and rate is
+  // low enough for sending the next packet.
+  Timestamp NextSendTimeOnRoute(DataSize debt, DataRate rate) const;
 
   DataSize PaddingToAdd(DataSize recommended_probe_size,
                         DataSize data_sent) const;
@@ -185,18 +204,20 @@ class PacingController {
       const PacedPacketInfo& pacing_info,
       Timestamp target_send_time,
       Timestamp now);
+  std::unique_ptr<RtpPacketToSend> GetPendingPacketForSecondaryRoute(
+      Timestamp now);
   void OnPacketSent(RtpPacketMediaType packet_type,
                     DataSize packet_size,
-                    Timestamp send_time);
+                    Timestamp send_time,
+                    bool on_secondary_route);
   void MaybeUpdateMediaRateDueToLongQueue(Timestamp now);
 
   Timestamp CurrentTime() const;
 
   // Helper methods for packet that may not be paced. Returns a finite Timestamp
-  // if a packet type is configured to not be paced and the packet queue has at
-  // least one packet of that type. Otherwise returns
-  // Timestamp::MinusInfinity().
-  Timestamp NextUnpacedSendTime() const;
+  // if a packet type is configured to not be paced and `queue` has at least
+  // one packet of that type. Otherwise returns Timestamp::MinusInfinity().
+  Timestamp NextUnpacedSendTime(const PrioritizedPacketQueue& queue) const;
 
   Clock* const clock_;
   PacketSender* const packet_sender_;
@@ -230,8 +251,16 @@ class PacingController {
   // is not already used by media.
   DataRate padding_rate_;
 
+  // Amount of outstanding data and the pacing rate of the secondary route. The
+  // secondary route is only used while its rate is non-zero.
+  DataSize secondary_route_debt_;
+  DataRate secondary_route_rate_;
+
   BitrateProber prober_;
   bool probing_send_failure_;
+  // Padding fetched in one batch for the rest of the current probe cluster,
+  // when the prober precomputes the cluster schedule.
+  std::deque<std::unique_ptr<RtpPacketToSend>> probe_padding_;
 
   Timestamp last_process_time_;
   Timestamp last_send_time_;
@@ -239,6 +268,8 @@ class PacingController {
   bool seen_first_packet_;
 
   PrioritizedPacketQueue packet_queue_;
+  // Retransmissions and FEC packets waiting for the secondary route.
+  PrioritizedPacketQueue secondary_packet_queue_;
 
   bool congested_;
 
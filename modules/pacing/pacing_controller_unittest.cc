@@ -230,6 +230,7 @@ class PacingControllerProbing : public PacingController::PacketSender {
       ++packets_sent_;
     } else {
       ++padding_packets_sent_;
+      padding_bytes_sent_ += packet->padding_size();
     }
     last_pacing_info_ = pacing_info;
   }
@@ -243,6 +244,7 @@ class PacingControllerProbing : public PacingController::PacketSender {
     if (!can_generate_padding_) {
       return {};
     }
+    ++padding_requests_;
     // From RTPSender:
     // Max in the RFC 3550 is 255 bytes, we limit it to be modulus 32 for SRTP.
     const DataSize kMaxPadding = DataSize::Bytes(224);
@@ -269,6 +271,8 @@ class PacingControllerProbing : public PacingController::PacketSender {
   int packets_sent() const { return packets_sent_; }
   int padding_packets_sent() const { return padding_packets_sent_; }
   int padding_sent() const { return padding_sent_; }
+  int padding_bytes_sent() const { return padding_bytes_sent_; }
+  int padding_requests() const { return padding_requests_; }
   int total_packets_sent() const { return packets_sent_ + padding_sent_; }
   PacedPacketInfo last_pacing_info() const { return last_pacing_info_; }
 
@@ -277,6 +281,8 @@ class PacingControllerProbing : public PacingController::PacketSender {
   int packets_sent_ = 0;
   int padding_packets_sent_ = 0;
   int padding_sent_ = 0;
+  int padding_bytes_sent_ = 0;
+  int padding_requests_ = 0;
   PacedPacketInfo last_pacing_info_;
 };
 
@@ -1426,6 +1432,50 @@ TEST_F(PacingControllerTest, CanNotProbeWithPaddingIfGeneratePaddingFails) {
   EXPECT_EQ(packet_sender.padding_packets_sent(), 0);
 }
 
+TEST_F(PacingControllerTest, FetchesProbePaddingOncePerClusterIfScheduled) {
+  const int kInitialBitrateBps = 300000;
+
+  PacingControllerProbing packet_sender;
+  const test::ExplicitKeyValueConfig trials(
+      "WebRTC-Bwe-ProbingBehavior/"
+      "min_packet_size:0,precomputed_schedule:true/");
+  auto pacer =
+      std::make_unique<PacingController>(&clock_, &packet_sender, trials);
+  std::vector<ProbeClusterConfig> probe_clusters = {
+      {.at_time = clock_.CurrentTime(),
+       .target_data_rate = kFirstClusterRate,
+       .target_duration = TimeDelta::Millis(15),
+       .target_probe_count = 5,
+       .id = 0}};
+  pacer->CreateProbeClusters(probe_clusters);
+
+  pacer->SetPacingRates(
+      DataRate::BitsPerSec(kInitialBitrateBps * kPaceMultiplier),
+      DataRate::Zero());
+
+  Timestamp start = clock_.CurrentTime();
+  Timestamp last_probe_time = start;
+  while (pacer->IsProbing() &&
+         clock_.CurrentTime() < start + TimeDelta::Millis(100)) {
+    AdvanceTimeUntil(pacer->NextSendTime());
+    last_probe_time = clock_.CurrentTime();
+    pacer->ProcessPackets();
+  }
+
+  EXPECT_FALSE(pacer->IsProbing());
+  // The small padding packet that starts the probe and one batch for the rest
+  // of the cluster.
+  EXPECT_EQ(packet_sender.padding_requests(), 2);
+  EXPECT_GT(packet_sender.padding_packets_sent(), 5);
+  // The last probe is sent at the end of the measured interval.
+  const DataSize last_probe_size = kFirstClusterRate * TimeDelta::Millis(2);
+  EXPECT_NEAR(
+      ((DataSize::Bytes(packet_sender.padding_bytes_sent()) - last_probe_size) /
+       (last_probe_time - start))
+          .bps(),
+      kFirstClusterRate.bps(), kProbingErrorMargin.bps());
+}
+
 TEST_F(PacingControllerTest, PaddingOveruse) {
   uint32_t ssrc = 12346;
   uint16_t sequence_number = 1234;
@@ -2306,5 +2356,85 @@ TEST_F(PacingControllerTest, FlushesPacketsOnKeyFrames) {
   pacer->ProcessPackets();
 }
 
+TEST_F(PacingControllerTest, PacesSecondaryRouteWithItsOwnBudget) {
+  // Both routes can send ten packets per second.
+  const DataRate kRouteRate = DataRate::KilobitsPerSec(80);
+  const size_t kPacketSize = 1000;
+  const int kNumPackets = 10;
+  ::testing::NiceMock<MockPacketSender> callback;
+  PacingController pacer(&clock_, &callback, trials_);
+  pacer.SetPacingRates(kRouteRate, DataRate::Zero());
+  pacer.SetSecondaryRoutePacingRate(kRouteRate);
+
+  MediaStream video(clock_, RtpPacketMediaType::kVideo, kVideoSsrc,
+                    kPacketSize);
+  MediaStream retransmissions(clock_, RtpPacketMediaType::kRetransmission,
+                              kVideoSsrc + 1, kPacketSize);
+  MediaStream fec(clock_, RtpPacketMediaType::kForwardErrorCorrection,
+                  kVideoSsrc + 2, kPacketSize);
+  for (int i = 0; i < kNumPackets; ++i) {
+    pacer.EnqueuePacket(video.BuildNextPacket());
+  }
+  for (int i = 0; i < kNumPackets / 2; ++i) {
+    pacer.EnqueuePacket(retransmissions.BuildNextPacket());
+    pacer.EnqueuePacket(fec.BuildNextPacket());
+  }
+  EXPECT_EQ(pacer.QueueSizePackets(), 2u * kNumPackets);
+
+  int primary_route_packets = 0;
+  int secondary_route_packets = 0;
+  EXPECT_CALL(callback, SendPacket)
+      .WillRepeatedly([&](std::unique_ptr<RtpPacketToSend> packet,
+                          const PacedPacketInfo& cluster_info) {
+        if (packet->packet_type() == RtpPacketMediaType::kVideo) {
+          EXPECT_FALSE(packet->send_on_secondary_route());
+          ++primary_route_packets;
+        } else {
+          EXPECT_TRUE(packet->send_on_secondary_route());
+          ++secondary_route_packets;
+        }
+      });
+
+  // The routes are drained in parallel, each at its own rate.
+  const Timestamp start_time = clock_.CurrentTime();
+  while (pacer.QueueSizePackets() > 0) {
+    AdvanceTimeUntil(pacer.NextSendTime());
+    pacer.ProcessPackets();
+  }
+  EXPECT_EQ(primary_route_packets, kNumPackets);
+  EXPECT_EQ(secondary_route_packets, kNumPackets);
+  EXPECT_LT(clock_.CurrentTime() - start_time,
+            kNumPackets * DataSize::Bytes(kPacketSize) / kRouteRate);
+}
+
+TEST_F(PacingControllerTest, SecondaryRouteIsDisabledByDefault) {
+  PacingController pacer(&clock_, &callback_, trials_);
+  EXPECT_EQ(pacer.secondary_route_pacing_rate(), DataRate::Zero());
+}
+
+TEST_F(PacingControllerTest, DisablingSecondaryRouteMovesPacketsToPrimary) {
+  ::testing::NiceMock<MockPacketSender> callback;
+  PacingController pacer(&clock_, &callback, trials_);
+  pacer.SetPacingRates(kTargetRate, DataRate::Zero());
+  pacer.SetSecondaryRoutePacingRate(kTargetRate);
+  const Timestamp enqueue_time = clock_.CurrentTime();
+  pacer.EnqueuePacket(BuildPacket(RtpPacketMediaType::kRetransmission,
+                                  kVideoSsrc, /*sequence_number=*/1,
+                                  /*capture_time_ms=*/1, /*size=*/1000));
+  clock_.AdvanceTime(TimeDelta::Millis(50));
+  pacer.SetSecondaryRoutePacingRate(DataRate::Zero());
+  EXPECT_EQ(pacer.QueueSizePackets(), 1u);
+  // The packet keeps its place in the queue and its enqueue time.
+  EXPECT_EQ(pacer.OldestPacketEnqueueTime(), enqueue_time);
+
+  EXPECT_CALL(callback,
+              SendPacket(Pointee(Property(
+                             &RtpPacketToSend::send_on_secondary_route, false)),
+                         _));
+  AdvanceTimeUntil(pacer.NextSendTime());
+  pacer.ProcessPackets();
+  EXPECT_EQ(pacer.QueueSizePackets(), 0u);
+}
+
 }  // namespace
 }  // namespace webrtc
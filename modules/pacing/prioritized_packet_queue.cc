@@ -10,6 +10,7 @@
 
 #include "modules/pacing/prioritized_packet_queue.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
@@ -49,66 +50,15 @@ DataSize PrioritizedPacketQueue::QueuedPacket::PacketSize() const {
   return DataSize::Bytes(packet->payload_size() + packet->padding_size());
 }
 
-PrioritizedPacketQueue::StreamQueue::StreamQueue(Timestamp creation_time)
-    : last_enqueue_time_(creation_time), num_keyframe_packets_(0) {}
-
-bool PrioritizedPacketQueue::StreamQueue::EnqueuePacket(QueuedPacket packet,
-                                                        int priority_level) {
-  if (packet.packet->is_key_frame()) {
-    ++num_keyframe_packets_;
-  }
-  bool first_packet_at_level = packets_[priority_level].empty();
-  packets_[priority_level].push_back(std::move(packet));
-  return first_packet_at_level;
-}
-
-PrioritizedPacketQueue::QueuedPacket
-PrioritizedPacketQueue::StreamQueue::DequeuePacket(int priority_level) {
-  RTC_DCHECK(!packets_[priority_level].empty());
-  QueuedPacket packet = std::move(packets_[priority_level].front());
-  packets_[priority_level].pop_front();
-  if (packet.packet->is_key_frame()) {
-    RTC_DCHECK_GT(num_keyframe_packets_, 0);
-    --num_keyframe_packets_;
-  }
-  return packet;
-}
-
-bool PrioritizedPacketQueue::StreamQueue::HasPacketsAtPrio(
-    int priority_level) const {
-  return !packets_[priority_level].empty();
-}
-
 bool PrioritizedPacketQueue::StreamQueue::IsEmpty() const {
-  for (const std::deque<QueuedPacket>& queue : packets_) {
-    if (!queue.empty()) {
+  for (const PriorityLevel& level : levels) {
+    if (level.first_packet != kNone) {
       return false;
     }
   }
   return true;
 }
 
-Timestamp PrioritizedPacketQueue::StreamQueue::LeadingPacketEnqueueTime(
-    int priority_level) const {
-  RTC_DCHECK(!packets_[priority_level].empty());
-  return packets_[priority_level].begin()->enqueue_time;
-}
-
-Timestamp PrioritizedPacketQueue::StreamQueue::LastEnqueueTime() const {
-  return last_enqueue_time_;
-}
-
-std::array<std::deque<PrioritizedPacketQueue::QueuedPacket>,
-           PrioritizedPacketQueue::kNumPriorityLevels>
-PrioritizedPacketQueue::StreamQueue::DequeueAll() {
-  std::array<std::deque<QueuedPacket>, kNumPriorityLevels> packets_by_prio;
-  for (int i = 0; i < kNumPriorityLevels; ++i) {
-    packets_by_prio[i].swap(packets_[i]);
-  }
-  num_keyframe_packets_ = 0;
-  return packets_by_prio;
-}
-
 PrioritizedPacketQueue::PrioritizedPacketQueue(Timestamp creation_time)
     : queue_time_sum_(TimeDelta::Zero()),
       pause_time_sum_(TimeDelta::Zero()),
@@ -118,59 +68,125 @@ PrioritizedPacketQueue::PrioritizedPacketQueue(Timestamp creation_time)
       last_update_time_(creation_time),
       paused_(false),
       last_culling_time_(creation_time),
-      top_active_prio_level_(-1) {}
+      first_free_packet_(kNone),
+      top_active_prio_level_(-1),
+      oldest_packet_(kNone),
+      newest_packet_(kNone) {
+  next_stream_by_prio_.fill(kNone);
+}
 
 void PrioritizedPacketQueue::Push(Timestamp enqueue_time,
                                   std::unique_ptr<RtpPacketToSend> packet) {
-  StreamQueue* stream_queue;
-  auto [it, inserted] = streams_.emplace(packet->Ssrc(), nullptr);
-  if (inserted) {
-    it->second = std::make_unique<StreamQueue>(enqueue_time);
+  UpdateAverageQueueTime(enqueue_time);
+  PushInternal(enqueue_time, TimeDelta::Zero(), std::move(packet));
+
+  static constexpr TimeDelta kTimeout = TimeDelta::Millis(500);
+  if (enqueue_time - last_culling_time_ > kTimeout) {
+    for (auto it = stream_slots_.begin(); it != stream_slots_.end();) {
+      const StreamQueue& culled = streams_[it->second];
+      if (culled.IsEmpty() &&
+          culled.last_enqueue_time + kTimeout < enqueue_time) {
+        free_streams_.push_back(it->second);
+        it = stream_slots_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    last_culling_time_ = enqueue_time;
+  }
+}
+
+void PrioritizedPacketQueue::TakePacketsFrom(PrioritizedPacketQueue& other,
+                                             Timestamp now) {
+  RTC_DCHECK_NE(&other, this);
+  UpdateAverageQueueTime(now);
+  other.UpdateAverageQueueTime(now);
+  // Take the packets in the order they were pushed to `other`, which makes
+  // each of them the first packet of its stream at its priority level.
+  while (other.oldest_packet_ != kNone) {
+    const QueuedPacket& oldest = other.packets_[other.oldest_packet_];
+    const Timestamp push_time = oldest.push_time;
+    const TimeDelta queue_time =
+        other.last_update_time_ - oldest.enqueue_time - other.pause_time_sum_;
+    const int stream = other.stream_slots_.find(oldest.packet->Ssrc())->second;
+    const int priority_level =
+        GetPriorityForType(oldest.packet->packet_type().value());
+    RTC_DCHECK_EQ(other.streams_[stream].levels[priority_level].first_packet,
+                  other.oldest_packet_);
+    PushInternal(push_time, queue_time,
+                 other.PopFirstPacket(stream, priority_level));
   }
-  stream_queue = it->second.get();
+}
 
-  auto enqueue_time_iterator =
-      enqueue_times_.insert(enqueue_times_.end(), enqueue_time);
+void PrioritizedPacketQueue::PushInternal(
+    Timestamp push_time,
+    TimeDelta queue_time,
+    std::unique_ptr<RtpPacketToSend> packet) {
+  const int stream = GetOrAddStream(packet->Ssrc(), push_time);
   RTC_DCHECK(packet->packet_type().has_value());
   RtpPacketMediaType packet_type = packet->packet_type().value();
   int prio_level = GetPriorityForType(packet_type);
   RTC_DCHECK_GE(prio_level, 0);
   RTC_DCHECK_LT(prio_level, kNumPriorityLevels);
-  QueuedPacket queued_packed = {.packet = std::move(packet),
-                                .enqueue_time = enqueue_time,
-                                .enqueue_time_iterator = enqueue_time_iterator};
+
+  const int index = AllocatePacket();
+  QueuedPacket& queued_packet = packets_[index];
+  queued_packet.packet = std::move(packet);
+  queued_packet.push_time = push_time;
   // In order to figure out how much time a packet has spent in the queue
   // while not in a paused state, we subtract the total amount of time the
   // queue has been paused so far, and when the packet is popped we subtract
   // the total amount of time the queue has been paused at that moment. This
   // way we subtract the total amount of time the packet has spent in the
   // queue while in a paused state.
-  UpdateAverageQueueTime(enqueue_time);
-  queued_packed.enqueue_time -= pause_time_sum_;
+  queued_packet.enqueue_time = last_update_time_ - queue_time - pause_time_sum_;
+  queue_time_sum_ += queue_time;
   ++size_packets_;
   ++size_packets_per_media_type_[static_cast<size_t>(packet_type)];
-  size_payload_ += queued_packed.PacketSize();
+  size_payload_ += queued_packet.PacketSize();
+
+  // Link into the list of packets in enqueue order, after the newest packet
+  // that was not pushed later than this one.
+  int prev_in_time = newest_packet_;
+  while (prev_in_time != kNone &&
+         packets_[prev_in_time].push_time > push_time) {
+    prev_in_time = packets_[prev_in_time].prev_in_time;
+  }
+  queued_packet.prev_in_time = prev_in_time;
+  if (prev_in_time == kNone) {
+    queued_packet.next_in_time = oldest_packet_;
+    oldest_packet_ = index;
+  } else {
+    queued_packet.next_in_time = packets_[prev_in_time].next_in_time;
+    packets_[prev_in_time].next_in_time = index;
+  }
+  if (queued_packet.next_in_time == kNone) {
+    newest_packet_ = index;
+  } else {
+    packets_[queued_packet.next_in_time].prev_in_time = index;
+  }
 
-  if (stream_queue->EnqueuePacket(std::move(queued_packed), prio_level)) {
+  // Append to the fifo of the stream.
+  StreamQueue& stream_queue = streams_[stream];
+  stream_queue.last_enqueue_time =
+      std::max(stream_queue.last_enqueue_time, push_time);
+  if (queued_packet.packet->is_key_frame()) {
+    ++stream_queue.num_keyframe_packets;
+  }
+  StreamQueue::PriorityLevel& level = stream_queue.levels[prio_level];
+  queued_packet.next_in_stream = kNone;
+  if (level.last_packet == kNone) {
     // Number packets at `prio_level` for this steam is now non-zero.
-    streams_by_prio_[prio_level].push_back(stream_queue);
+    level.first_packet = index;
+    AddToRing(stream, prio_level);
+  } else {
+    packets_[level.last_packet].next_in_stream = index;
   }
+  level.last_packet = index;
+
   if (top_active_prio_level_ < 0 || prio_level < top_active_prio_level_) {
     top_active_prio_level_ = prio_level;
   }
-
-  static constexpr TimeDelta kTimeout = TimeDelta::Millis(500);
-  if (enqueue_time - last_culling_time_ > kTimeout) {
-    for (auto it = streams_.begin(); it != streams_.end();) {
-      if (it->second->IsEmpty() &&
-          it->second->LastEnqueueTime() + kTimeout < enqueue_time) {
-        streams_.erase(it++);
-      } else {
-        ++it;
-      }
-    }
-    last_culling_time_ = enqueue_time;
-  }
 }
 
 std::unique_ptr<RtpPacketToSend> PrioritizedPacketQueue::Pop() {
@@ -179,20 +195,38 @@ std::unique_ptr<RtpPacketToSend> PrioritizedPacketQueue::Pop() {
   }
 
   RTC_DCHECK_GE(top_active_prio_level_, 0);
-  StreamQueue& stream_queue = *streams_by_prio_[top_active_prio_level_].front();
-  QueuedPacket packet = stream_queue.DequeuePacket(top_active_prio_level_);
+  const int priority_level = top_active_prio_level_;
+  const int stream = next_stream_by_prio_[priority_level];
+  RTC_DCHECK_NE(stream, kNone);
+  // Move on to the next stream in the ring for this prio level, leaving this
+  // stream at the end of the ring if it still has packets.
+  next_stream_by_prio_[priority_level] =
+      streams_[stream].levels[priority_level].next_stream;
+  return PopFirstPacket(stream, priority_level);
+}
+
+std::unique_ptr<RtpPacketToSend> PrioritizedPacketQueue::PopFirstPacket(
+    int stream,
+    int priority_level) {
+  StreamQueue& stream_queue = streams_[stream];
+  StreamQueue::PriorityLevel& level = stream_queue.levels[priority_level];
+  const int index = level.first_packet;
+  QueuedPacket& packet = packets_[index];
+  level.first_packet = packet.next_in_stream;
+  if (packet.packet->is_key_frame()) {
+    RTC_DCHECK_GT(stream_queue.num_keyframe_packets, 0);
+    --stream_queue.num_keyframe_packets;
+  }
   DequeuePacketInternal(packet);
+  std::unique_ptr<RtpPacketToSend> rtp_packet = std::move(packet.packet);
+  FreePacket(index);
 
-  // Remove StreamQueue from head of fifo-queue for this prio level, and
-  // and add it to the end if it still has packets.
-  streams_by_prio_[top_active_prio_level_].pop_front();
-  if (stream_queue.HasPacketsAtPrio(top_active_prio_level_)) {
-    streams_by_prio_[top_active_prio_level_].push_back(&stream_queue);
-  } else {
+  if (level.first_packet == kNone) {
+    level.last_packet = kNone;
+    RemoveFromRing(stream, priority_level);
     MaybeUpdateTopPrioLevel();
   }
-
-  return std::move(packet.packet);
+  return rtp_packet;
 }
 
 int PrioritizedPacketQueue::SizeInPackets() const {
@@ -215,16 +249,17 @@ PrioritizedPacketQueue::SizeInPacketsPerRtpPacketMediaType() const {
 Timestamp PrioritizedPacketQueue::LeadingPacketEnqueueTime(
     RtpPacketMediaType type) const {
   const int priority_level = GetPriorityForType(type);
-  if (streams_by_prio_[priority_level].empty()) {
+  const int stream = next_stream_by_prio_[priority_level];
+  if (stream == kNone) {
     return Timestamp::MinusInfinity();
   }
-  return streams_by_prio_[priority_level].front()->LeadingPacketEnqueueTime(
-      priority_level);
+  return packets_[streams_[stream].levels[priority_level].first_packet]
+      .enqueue_time;
 }
 
 Timestamp PrioritizedPacketQueue::OldestEnqueueTime() const {
-  return enqueue_times_.empty() ? Timestamp::MinusInfinity()
-                                : enqueue_times_.front();
+  return oldest_packet_ == kNone ? Timestamp::MinusInfinity()
+                                 : packets_[oldest_packet_].push_time;
 }
 
 TimeDelta PrioritizedPacketQueue::AverageQueueTime() const {
@@ -257,57 +292,119 @@ void PrioritizedPacketQueue::SetPauseState(bool paused, Timestamp now) {
 }
 
 void PrioritizedPacketQueue::RemovePacketsForSsrc(uint32_t ssrc) {
-  auto kv = streams_.find(ssrc);
-  if (kv != streams_.end()) {
-    // Dequeue all packets from the queue for this SSRC.
-    StreamQueue& queue = *kv->second;
-    std::array<std::deque<QueuedPacket>, kNumPriorityLevels> packets_by_prio =
-        queue.DequeueAll();
-    for (int i = 0; i < kNumPriorityLevels; ++i) {
-      std::deque<QueuedPacket>& packet_queue = packets_by_prio[i];
-      if (packet_queue.empty()) {
-        continue;
-      }
-
-      // First erase all packets at this prio level.
-      while (!packet_queue.empty()) {
-        QueuedPacket packet = std::move(packet_queue.front());
-        packet_queue.pop_front();
-        DequeuePacketInternal(packet);
-      }
+  auto kv = stream_slots_.find(ssrc);
+  if (kv == stream_slots_.end()) {
+    return;
+  }
+  const int stream = kv->second;
+  StreamQueue& stream_queue = streams_[stream];
+  for (int i = 0; i < kNumPriorityLevels; ++i) {
+    StreamQueue::PriorityLevel& level = stream_queue.levels[i];
+    if (level.first_packet == kNone) {
+      continue;
+    }
 
-      // Next, deregister this `StreamQueue` from the round-robin tables.
-      RTC_DCHECK(!streams_by_prio_[i].empty());
-      if (streams_by_prio_[i].size() == 1) {
-        // This is the last and only queue that had packets for this prio level.
-        // Update the global top prio level if neccessary.
-        RTC_DCHECK(streams_by_prio_[i].front() == &queue);
-        streams_by_prio_[i].pop_front();
-        if (i == top_active_prio_level_) {
-          MaybeUpdateTopPrioLevel();
-        }
-      } else {
-        // More than stream had packets at this prio level, filter this one out.
-        std::deque<StreamQueue*> filtered_queue;
-        for (StreamQueue* queue_ptr : streams_by_prio_[i]) {
-          if (queue_ptr != &queue) {
-            filtered_queue.push_back(queue_ptr);
-          }
-        }
-        streams_by_prio_[i].swap(filtered_queue);
-      }
+    // First erase all packets at this prio level.
+    while (level.first_packet != kNone) {
+      const int index = level.first_packet;
+      level.first_packet = packets_[index].next_in_stream;
+      DequeuePacketInternal(packets_[index]);
+      packets_[index].packet = nullptr;
+      FreePacket(index);
     }
+    level.last_packet = kNone;
+
+    // Next, deregister this stream from the round-robin ring.
+    RemoveFromRing(stream, i);
   }
+  stream_queue.num_keyframe_packets = 0;
+  MaybeUpdateTopPrioLevel();
 }
 
 bool PrioritizedPacketQueue::HasKeyframePackets(uint32_t ssrc) const {
-  auto it = streams_.find(ssrc);
-  if (it != streams_.end()) {
-    return it->second->has_keyframe_packets();
+  auto it = stream_slots_.find(ssrc);
+  if (it != stream_slots_.end()) {
+    return streams_[it->second].num_keyframe_packets > 0;
   }
   return false;
 }
 
+int PrioritizedPacketQueue::GetOrAddStream(uint32_t ssrc, Timestamp now) {
+  auto it = stream_slots_.find(ssrc);
+  if (it != stream_slots_.end()) {
+    return it->second;
+  }
+  int stream;
+  if (free_streams_.empty()) {
+    stream = streams_.size();
+    streams_.emplace_back();
+  } else {
+    stream = free_streams_.back();
+    free_streams_.pop_back();
+    RTC_DCHECK(streams_[stream].IsEmpty());
+    streams_[stream] = StreamQueue();
+  }
+  streams_[stream].ssrc = ssrc;
+  streams_[stream].last_enqueue_time = now;
+  stream_slots_.emplace(ssrc, stream);
+  return stream;
+}
+
+int PrioritizedPacketQueue::AllocatePacket() {
+  if (first_free_packet_ == kNone) {
+    packets_.emplace_back();
+    return packets_.size() - 1;
+  }
+  const int index = first_free_packet_;
+  first_free_packet_ = packets_[index].next_in_stream;
+  return index;
+}
+
+void PrioritizedPacketQueue::FreePacket(int index) {
+  RTC_DCHECK(!packets_[index].packet);
+  packets_[index].next_in_stream = first_free_packet_;
+  first_free_packet_ = index;
+}
+
+void PrioritizedPacketQueue::AddToRing(int stream, int priority_level) {
+  StreamQueue::PriorityLevel& level = streams_[stream].levels[priority_level];
+  int& next_stream = next_stream_by_prio_[priority_level];
+  if (next_stream == kNone) {
+    level.next_stream = stream;
+    level.prev_stream = stream;
+    next_stream = stream;
+    return;
+  }
+  // The stream before the next one is the last in the ring.
+  StreamQueue::PriorityLevel& next =
+      streams_[next_stream].levels[priority_level];
+  const int last_stream = next.prev_stream;
+  level.next_stream = next_stream;
+  level.prev_stream = last_stream;
+  streams_[last_stream].levels[priority_level].next_stream = stream;
+  next.prev_stream = stream;
+}
+
+void PrioritizedPacketQueue::RemoveFromRing(int stream, int priority_level) {
+  StreamQueue::PriorityLevel& level = streams_[stream].levels[priority_level];
+  int& next_stream = next_stream_by_prio_[priority_level];
+  if (level.next_stream == stream) {
+    // This is the last and only stream in the ring.
+    RTC_DCHECK_EQ(next_stream, stream);
+    next_stream = kNone;
+  } else {
+    streams_[level.prev_stream].levels[priority_level].next_stream =
+        level.next_stream;
+    streams_[level.next_stream].levels[priority_level].prev_stream =
+        level.prev_stream;
+    if (next_stream == stream) {
+      next_stream = level.next_stream;
+    }
+  }
+  level.next_stream = kNone;
+  level.prev_stream = kNone;
+}
+
 void PrioritizedPacketQueue::DequeuePacketInternal(QueuedPacket& packet) {
   --size_packets_;
   RTC_DCHECK(packet.packet->packet_type().has_value());
@@ -335,23 +432,31 @@ void PrioritizedPacketQueue::DequeuePacketInternal(QueuedPacket& packet) {
 
   RTC_DCHECK(size_packets_ > 0 || queue_time_sum_ == TimeDelta::Zero());
 
-  RTC_CHECK(packet.enqueue_time_iterator != enqueue_times_.end());
-  enqueue_times_.erase(packet.enqueue_time_iterator);
+  // Unlink from the list of packets in enqueue order.
+  if (packet.prev_in_time == kNone) {
+    oldest_packet_ = packet.next_in_time;
+  } else {
+    packets_[packet.prev_in_time].next_in_time = packet.next_in_time;
+  }
+  if (packet.next_in_time == kNone) {
+    newest_packet_ = packet.prev_in_time;
+  } else {
+    packets_[packet.next_in_time].prev_in_time = packet.prev_in_time;
+  }
 }
 
 void PrioritizedPacketQueue::MaybeUpdateTopPrioLevel() {
-  if (streams_by_prio_[top_active_prio_level_].empty()) {
-    // No stream queues have packets at this prio level, find top priority
-    // that is not empty.
-    if (size_packets_ == 0) {
-      top_active_prio_level_ = -1;
-    } else {
-      for (int i = 0; i < kNumPriorityLevels; ++i) {
-        if (!streams_by_prio_[i].empty()) {
-          top_active_prio_level_ = i;
-          break;
-        }
-      }
+  if (top_active_prio_level_ >= 0 &&
+      next_stream_by_prio_[top_active_prio_level_] != kNone) {
+    return;
+  }
+  // No stream queues have packets at this prio level, find top priority
+  // that is not empty.
+  top_active_prio_level_ = -1;
+  for (int i = 0; i < kNumPriorityLevels; ++i) {
+    if (next_stream_by_prio_[i] != kNone) {
+      top_active_prio_level_ = i;
+      break;
     }
   }
 }
@@ -14,19 +14,21 @@
 #include <stddef.h>
 
 #include <array>
-#include <deque>
-#include <list>
 #include <memory>
-#include <unordered_map>
 #include <vector>
 
 #include "api/units/data_size.h"
 #include "api/units/time_delta.h"
 #include "api/units/timestamp.h"
 #include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "rtc_base/containers/flat_map.h"
 
 namespace webrtc {
 
+// Queue of packets waiting to be sent by the pacer. The packets are linked
+// into intrusive lists of a pooled node array, and the streams are kept in a
+// dense slot array, so that once the queue has reached its largest size
+// pushing and popping packets does not allocate memory.
 class PrioritizedPacketQueue {
  public:
   explicit PrioritizedPacketQueue(Timestamp creation_time);
@@ -37,6 +39,11 @@ class PrioritizedPacketQueue {
   // and to report the leading packet enqueue time per packet type.
   void Push(Timestamp enqueue_time, std::unique_ptr<RtpPacketToSend> packet);
 
+  // Moves all packets of `other` to this queue at time `now`. The packets keep
+  // their enqueue times and the time they have spent in `other`, as if they
+  // had been pushed to this queue rather than to `other`.
+  void TakePacketsFrom(PrioritizedPacketQueue& other, Timestamp now);
+
   // Remove the next packet from the queue. Packets a prioritized first
   // according to packet type, in the following order:
   // - audio, retransmissions, video / fec, padding
@@ -91,47 +98,67 @@ class PrioritizedPacketQueue {
 
  private:
   static constexpr int kNumPriorityLevels = 4;
+  // End of an intrusive list, or a node that is not linked into one.
+  static constexpr int kNone = -1;
 
-  class QueuedPacket {
-   public:
+  // A node of `packets_`. Queued packets are linked into the fifo of their
+  // stream and priority level, and into the list of all queued packets in
+  // enqueue order. Free nodes are linked through `next_in_stream`.
+  struct QueuedPacket {
     DataSize PacketSize() const;
 
     std::unique_ptr<RtpPacketToSend> packet;
-    Timestamp enqueue_time;
-    std::list<Timestamp>::iterator enqueue_time_iterator;
+    // Time of the Push() call, and that time minus the time the queue had
+    // been paused so far, see Push().
+    Timestamp push_time = Timestamp::MinusInfinity();
+    Timestamp enqueue_time = Timestamp::MinusInfinity();
+    int next_in_stream = kNone;
+    int prev_in_time = kNone;
+    int next_in_time = kNone;
   };
 
-  // Class containing packets for an RTP stream.
-  // For each priority level, packets are simply stored in a fifo queue.
-  class StreamQueue {
-   public:
-    explicit StreamQueue(Timestamp creation_time);
-    StreamQueue(StreamQueue&&) = default;
-    StreamQueue& operator=(StreamQueue&&) = default;
-
-    StreamQueue(const StreamQueue&) = delete;
-    StreamQueue& operator=(const StreamQueue&) = delete;
-
-    // Enqueue packet at the given priority level. Returns true if the packet
-    // count for that priority level went from zero to non-zero.
-    bool EnqueuePacket(QueuedPacket packet, int priority_level);
-
-    QueuedPacket DequeuePacket(int priority_level);
+  // Packets for an RTP stream, stored in a slot of `streams_`.
+  // For each priority level, packets are stored in a fifo queue, and while
+  // that queue is not empty the stream is linked into the round-robin ring of
+  // the priority level.
+  struct StreamQueue {
+    struct PriorityLevel {
+      int first_packet = kNone;
+      int last_packet = kNone;
+      int next_stream = kNone;
+      int prev_stream = kNone;
+    };
 
-    bool HasPacketsAtPrio(int priority_level) const;
     bool IsEmpty() const;
-    Timestamp LeadingPacketEnqueueTime(int priority_level) const;
-    Timestamp LastEnqueueTime() const;
-    bool has_keyframe_packets() const { return num_keyframe_packets_ > 0; }
 
-    std::array<std::deque<QueuedPacket>, kNumPriorityLevels> DequeueAll();
-
-   private:
-    std::deque<QueuedPacket> packets_[kNumPriorityLevels];
-    Timestamp last_enqueue_time_;
-    int num_keyframe_packets_;
+    uint32_t ssrc = 0;
+    Timestamp last_enqueue_time = Timestamp::MinusInfinity();
+    int num_keyframe_packets = 0;
+    std::array<PriorityLevel, kNumPriorityLevels> levels;
   };
 
+  // Returns the slot in `streams_` of the stream with `ssrc`, adding the
+  // stream if it is not in the queue.
+  int GetOrAddStream(uint32_t ssrc, Timestamp now);
+  // Adds `packet`, pushed at `push_time` and queued for `queue_time` so far,
+  // to the queue. Requires the queue time to be updated to now.
+  void PushInternal(Timestamp push_time,
+                    TimeDelta queue_time,
+                    std::unique_ptr<RtpPacketToSend> packet);
+  // Removes and returns the first packet of the stream in slot `stream` at
+  // `priority_level`, leaving the ring of the priority level as it is unless
+  // the stream has no more packets at that level.
+  std::unique_ptr<RtpPacketToSend> PopFirstPacket(int stream,
+                                                  int priority_level);
+  // Returns a free node of `packets_`, growing the pool if there is none.
+  int AllocatePacket();
+  void FreePacket(int index);
+
+  // Link and unlink the stream in slot `stream` to/from the round-robin ring
+  // of `priority_level`. Streams are added last in the ring.
+  void AddToRing(int stream, int priority_level);
+  void RemoveFromRing(int stream, int priority_level);
+
   // Remove the packet from the internal state, e.g. queue time / size etc.
   void DequeuePacketInternal(QueuedPacket& packet);
 
@@ -156,20 +183,30 @@ class PrioritizedPacketQueue {
   // Last time `streams_` was culled for inactive streams.
   Timestamp last_culling_time_;
 
-  // Map from SSRC to packet queues for the associated RTP stream.
-  std::unordered_map<uint32_t, std::unique_ptr<StreamQueue>> streams_;
+  // Pool of packet nodes. It grows to the largest number of packets queued at
+  // once and is then reused, so that Push() and Pop() do not allocate.
+  std::vector<QueuedPacket> packets_;
+  int first_free_packet_;
+
+  // Dense array of stream slots, and the slots of culled streams, for reuse.
+  std::vector<StreamQueue> streams_;
+  std::vector<int> free_streams_;
+  // Map from SSRC to slot in `streams_` for the associated RTP stream.
+  flat_map<uint32_t, int> stream_slots_;
 
-  // For each priority level, a queue of StreamQueues which have at least one
-  // packet pending for that prio level.
-  std::deque<StreamQueue*> streams_by_prio_[kNumPriorityLevels];
+  // For each priority level, the slot of the stream which is next in the
+  // round-robin ring of streams having at least one packet pending for that
+  // prio level, or kNone if there are none.
+  std::array<int, kNumPriorityLevels> next_stream_by_prio_;
 
-  // The first index into `stream_by_prio_` that is non-empty.
+  // The first index into `next_stream_by_prio_` that is not kNone.
   int top_active_prio_level_;
 
-  // Ordered list of enqueue times. Additions are always increasing and added to
-  // the end. QueuedPacket instances have a iterators into this list for fast
-  // removal.
-  std::list<Timestamp> enqueue_times_;
+  // First and last node of the list of queued packets in enqueue order.
+  // Packets are added to the end, except for packets taken from another
+  // queue, which are inserted by their enqueue time.
+  int oldest_packet_;
+  int newest_packet_;
 };
 
 }  // namespace webrtc
@@ -0,0 +1,98 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "api/units/data_rate.h"
+#include "api/units/data_size.h"
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "benchmark/benchmark.h"
+#include "modules/pacing/prioritized_packet_queue.h"
+#include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "rtc_base/system/unused.h"
+
+namespace webrtc {
+namespace {
+
+// 50 simulcast streams at 30 fps, two packets per frame, adding up to about
+// 30 Mbit/s. The frames of the streams are spread over the frame interval.
+constexpr int kNumStreams = 50;
+constexpr int kPacketsPerFrame = 2;
+constexpr TimeDelta kProcessInterval = TimeDelta::Millis(1);
+constexpr int kProcessIntervalsPerFrame = 33;
+constexpr DataSize kPacketSize = DataSize::Bytes(1250);
+// Every `kRetransmissionInterval`th packet is a retransmission.
+constexpr int kRetransmissionInterval = 50;
+
+// Pushes the frames of the streams as they are produced and pops packets at
+// the pacing rate, one process interval per iteration. The packets are
+// recycled, so only the queue itself is measured.
+void BM_PacePacketsOfSimulcastStreams(benchmark::State& state) {
+  Timestamp now = Timestamp::Zero();
+  PrioritizedPacketQueue queue(now);
+  std::vector<std::unique_ptr<RtpPacketToSend>> free_packets;
+  // A quarter above the media rate, so that the queue is drained between
+  // bursts of frames.
+  const DataRate pacing_rate = kNumStreams * kPacketsPerFrame * kPacketSize /
+                               (kProcessIntervalsPerFrame * kProcessInterval) *
+                               1.25;
+  int64_t tick = 0;
+  int64_t num_packets = 0;
+  int64_t num_popped = 0;
+  DataSize budget = DataSize::Zero();
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    for (int stream = 0; stream < kNumStreams; ++stream) {
+      if (tick % kProcessIntervalsPerFrame !=
+          stream * kProcessIntervalsPerFrame / kNumStreams) {
+        continue;
+      }
+      for (int i = 0; i < kPacketsPerFrame; ++i, ++num_packets) {
+        std::unique_ptr<RtpPacketToSend> packet;
+        if (free_packets.empty()) {
+          packet = std::make_unique<RtpPacketToSend>(/*extensions=*/nullptr);
+          packet->SetPayloadSize(kPacketSize.bytes());
+        } else {
+          packet = std::move(free_packets.back());
+          free_packets.pop_back();
+        }
+        packet->SetSsrc(1000 + stream);
+        packet->set_packet_type(num_packets % kRetransmissionInterval == 0
+                                    ? RtpPacketMediaType::kRetransmission
+                                    : RtpPacketMediaType::kVideo);
+        queue.Push(now, std::move(packet));
+      }
+    }
+
+    budget = std::min(budget + pacing_rate * kProcessInterval,
+                      pacing_rate * kProcessInterval);
+    while (budget > DataSize::Zero() && !queue.Empty()) {
+      std::unique_ptr<RtpPacketToSend> packet = queue.Pop();
+      budget -= kPacketSize;
+      ++num_popped;
+      free_packets.push_back(std::move(packet));
+    }
+    now += kProcessInterval;
+    ++tick;
+  }
+  state.SetItemsProcessed(num_popped);
+}
+
+BENCHMARK(BM_PacePacketsOfSimulcastStreams);
+
+}  // namespace
+}  // namespace webrtc
@@ -216,6 +216,51 @@ TEST(PrioritizedPacketQueue, SubtractsPusedTimeFromAverageQueueTime) {
   EXPECT_EQ(queue.AverageQueueTime(), TimeDelta::Millis(750));
 }
 
+TEST(PrioritizedPacketQueue, TakePacketsFromKeepsEnqueueTimes) {
+  PrioritizedPacketQueue queue(/*creation_time=*/Timestamp::Zero());
+  PrioritizedPacketQueue other(/*creation_time=*/Timestamp::Zero());
+
+  queue.Push(Timestamp::Millis(20),
+             CreatePacket(RtpPacketMediaType::kVideo, /*seq=*/2));
+  other.Push(Timestamp::Millis(10),
+             CreatePacket(RtpPacketMediaType::kRetransmission, /*seq=*/1));
+  other.Push(Timestamp::Millis(30),
+             CreatePacket(RtpPacketMediaType::kVideo, /*seq=*/3));
+  queue.TakePacketsFrom(other, Timestamp::Millis(40));
+
+  EXPECT_TRUE(other.Empty());
+  EXPECT_EQ(queue.SizeInPackets(), 3);
+  EXPECT_EQ(queue.OldestEnqueueTime(), Timestamp::Millis(10));
+  // Packets have waited 30, 20, 10 ms -> average = 20ms.
+  EXPECT_EQ(queue.AverageQueueTime(), TimeDelta::Millis(20));
+
+  // The packets of a stream are still sent in the order they were pushed.
+  EXPECT_EQ(queue.Pop()->SequenceNumber(), 1);
+  EXPECT_EQ(queue.OldestEnqueueTime(), Timestamp::Millis(20));
+  EXPECT_EQ(queue.Pop()->SequenceNumber(), 2);
+  EXPECT_EQ(queue.OldestEnqueueTime(), Timestamp::Millis(30));
+  EXPECT_EQ(queue.Pop()->SequenceNumber(), 3);
+  EXPECT_TRUE(queue.Empty());
+}
+
+TEST(PrioritizedPacketQueue, TakePacketsFromSubtractsPausedTime) {
+  PrioritizedPacketQueue queue(/*creation_time=*/Timestamp::Zero());
+  PrioritizedPacketQueue other(/*creation_time=*/Timestamp::Zero());
+
+  // The packet waits 100ms in `other`, of which 50ms paused, and then 100ms
+  // in `queue`.
+  other.Push(Timestamp::Millis(100),
+             CreatePacket(RtpPacketMediaType::kVideo, /*seq=*/1));
+  other.SetPauseState(true, Timestamp::Millis(150));
+  other.SetPauseState(false, Timestamp::Millis(200));
+  queue.TakePacketsFrom(other, Timestamp::Millis(200));
+  EXPECT_EQ(queue.AverageQueueTime(), TimeDelta::Millis(50));
+
+  queue.UpdateAverageQueueTime(Timestamp::Millis(300));
+  EXPECT_EQ(queue.AverageQueueTime(), TimeDelta::Millis(150));
+  EXPECT_EQ(queue.OldestEnqueueTime(), Timestamp::Millis(100));
+}
+
 TEST(PrioritizedPacketQueue, ReportsLeadingPacketEnqueueTime) {
   PrioritizedPacketQueue queue(/*creation_time=*/Timestamp::Zero());
   EXPECT_EQ(queue.LeadingPacketEnqueueTime(RtpPacketMediaType::kAudio),
@@ -362,6 +407,54 @@ TEST(PrioritizedPacketQueue, ClearPacketsAffectsOnlySpecifiedSsrc) {
   EXPECT_TRUE(queue.Empty());
 }
 
+TEST(PrioritizedPacketQueue, ClearPacketsKeepsRoundRobinOrderOfOtherSsrcs) {
+  Timestamp now = Timestamp::Zero();
+  PrioritizedPacketQueue queue(now);
+
+  // Two video packets each for three streams.
+  for (uint32_t ssrc = 100; ssrc < 103; ++ssrc) {
+    queue.Push(now, CreatePacket(RtpPacketMediaType::kVideo,
+                                 /*seq=*/ssrc * 10 + 1, ssrc));
+    queue.Push(now, CreatePacket(RtpPacketMediaType::kVideo,
+                                 /*seq=*/ssrc * 10 + 2, ssrc));
+  }
+  EXPECT_EQ(queue.Pop()->SequenceNumber(), 1001);
+
+  // Remove the stream that is next in turn.
+  queue.RemovePacketsForSsrc(101);
+  EXPECT_EQ(queue.Pop()->SequenceNumber(), 1021);
+  EXPECT_EQ(queue.Pop()->SequenceNumber(), 1002);
+  EXPECT_EQ(queue.Pop()->SequenceNumber(), 1022);
+  EXPECT_TRUE(queue.Empty());
+}
+
+TEST(PrioritizedPacketQueue, ReusesStateOfInactiveSsrcs) {
+  Timestamp now = Timestamp::Zero();
+  PrioritizedPacketQueue queue(now);
+
+  queue.Push(now, CreatePacket(RtpPacketMediaType::kVideo, /*seq=*/1,
+                               /*ssrc=*/1, /*is_key_frame=*/true));
+  queue.Push(now, CreatePacket(RtpPacketMediaType::kVideo, /*seq=*/2,
+                               /*ssrc=*/2, /*is_key_frame=*/true));
+  EXPECT_EQ(queue.Pop()->SequenceNumber(), 1);
+  EXPECT_EQ(queue.Pop()->SequenceNumber(), 2);
+
+  // Streams which have been empty for a while are dropped, and new streams
+  // take their place.
+  for (int i = 0; i < 10; ++i) {
+    now += TimeDelta::Seconds(1);
+    queue.Push(now, CreatePacket(RtpPacketMediaType::kVideo, /*seq=*/10 + i,
+                                 /*ssrc=*/10 + i));
+    queue.Push(now, CreatePacket(RtpPacketMediaType::kAudio, /*seq=*/20 + i,
+                                 /*ssrc=*/20 + i));
+    EXPECT_EQ(queue.Pop()->SequenceNumber(), 20 + i);
+    EXPECT_EQ(queue.Pop()->SequenceNumber(), 10 + i);
+    EXPECT_TRUE(queue.Empty());
+    EXPECT_FALSE(queue.HasKeyframePackets(1));
+    EXPECT_FALSE(queue.HasKeyframePackets(2));
+  }
+}
+
 TEST(PrioritizedPacketQueue, ReportsKeyframePackets) {
   Timestamp now = Timestamp::Zero();
   PrioritizedPacketQueue queue(now);
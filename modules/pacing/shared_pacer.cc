@@ -0,0 +1,222 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/pacing/shared_pacer.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "absl/numeric/bits.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/trace_event.h"
+
+namespace webrtc {
+
+constexpr TimeDelta SharedPacer::kResolution;
+constexpr TimeDelta SharedPacer::kMaxDelay;
+
+SharedPacer::SharedPacer(Clock* clock)
+    : clock_(clock),
+      task_queue_(TaskQueueBase::Current()),
+      processed_tick_(clock_->CurrentTime().us() / kResolution.us()) {
+  RTC_DCHECK(task_queue_);
+}
+
+SharedPacer::~SharedPacer() {
+  RTC_DCHECK_RUN_ON(task_queue_);
+  RTC_DCHECK_EQ(free_ids_.size(), pacers_.size())
+      << "All pacers must be unregistered.";
+}
+
+int SharedPacer::Register(ProcessCallback process) {
+  RTC_DCHECK_RUN_ON(task_queue_);
+  RTC_DCHECK(process);
+  // Growing `pacers_` would move the callback being run.
+  RTC_DCHECK(!processing_);
+  int id;
+  if (free_ids_.empty()) {
+    id = pacers_.size();
+    pacers_.emplace_back();
+  } else {
+    id = free_ids_.back();
+    free_ids_.pop_back();
+  }
+  pacers_[id].process = std::move(process);
+  return id;
+}
+
+void SharedPacer::Unregister(int id) {
+  RTC_DCHECK_RUN_ON(task_queue_);
+  RTC_DCHECK(!processing_);
+  Pacer& pacer = pacers_[id];
+  RTC_DCHECK(pacer.process);
+  if (pacer.scheduled_time.IsFinite()) {
+    RemoveEntry(id);
+  }
+  pacer.process = nullptr;
+  free_ids_.push_back(id);
+}
+
+void SharedPacer::Schedule(int id, Timestamp time, TimeDelta max_delay) {
+  RTC_DCHECK_RUN_ON(task_queue_);
+  RTC_DCHECK(time.IsFinite());
+  RTC_DCHECK_GE(max_delay, TimeDelta::Zero());
+  Pacer& pacer = pacers_[id];
+  RTC_DCHECK(pacer.process);
+  if (pacer.scheduled_time.IsFinite()) {
+    RemoveEntry(id);
+  }
+  if (num_entries_ == 0) {
+    // Nothing is left to process up to now, so the wheel can skip ahead.
+    processed_tick_ = std::max(processed_tick_,
+                               clock_->CurrentTime().us() / kResolution.us());
+  }
+
+  const int64_t due_tick = std::max(TickAtOrAfter(time), processed_tick_ + 1);
+  const int64_t tick =
+      due_tick + std::min(max_delay, kMaxDelay).us() / kResolution.us();
+  std::vector<int>& slot = slots_[SlotIndex(tick)];
+  pacer.scheduled_time = time;
+  pacer.due_tick = due_tick;
+  pacer.tick = tick;
+  pacer.position_in_slot = slot.size();
+  slot.push_back(id);
+  occupied_slots_[SlotIndex(tick) / kSlotsPerWord] |=
+      uint64_t{1} << (SlotIndex(tick) % kSlotsPerWord);
+  ++num_entries_;
+
+  if (!processing_) {
+    MaybeScheduleWakeup();
+  }
+}
+
+int64_t SharedPacer::wakeups() const {
+  RTC_DCHECK_RUN_ON(task_queue_);
+  return wakeups_;
+}
+
+int64_t SharedPacer::TickAtOrAfter(Timestamp time) {
+  return (time.us() + kResolution.us() - 1) / kResolution.us();
+}
+
+// RTC_RUN_ON(task_queue_)
+void SharedPacer::RemoveEntry(int id) {
+  Pacer& pacer = pacers_[id];
+  const int slot_index = SlotIndex(pacer.tick);
+  std::vector<int>& slot = slots_[slot_index];
+  const int last_id = slot.back();
+  slot[pacer.position_in_slot] = last_id;
+  pacers_[last_id].position_in_slot = pacer.position_in_slot;
+  slot.pop_back();
+  if (slot.empty()) {
+    occupied_slots_[slot_index / kSlotsPerWord] &=
+        ~(uint64_t{1} << (slot_index % kSlotsPerWord));
+  }
+  pacer.scheduled_time = Timestamp::PlusInfinity();
+  --num_entries_;
+}
+
+// RTC_RUN_ON(task_queue_)
+int64_t SharedPacer::NextOccupiedTick() const {
+  RTC_DCHECK_GT(num_entries_, 0);
+  // Scans the slots in tick order, starting with the one after
+  // `processed_tick_`, a word of the bit mask at a time.
+  const int64_t first_tick = processed_tick_ + 1;
+  int offset = 0;
+  while (offset < kNumSlots) {
+    const int slot_index = SlotIndex(first_tick + offset);
+    const int bit = slot_index % kSlotsPerWord;
+    const uint64_t word = occupied_slots_[slot_index / kSlotsPerWord] >> bit;
+    if (word != 0) {
+      return first_tick + offset + absl::countr_zero(word);
+    }
+    offset += kSlotsPerWord - bit;
+  }
+  RTC_DCHECK_NOTREACHED();
+  return first_tick;
+}
+
+// RTC_RUN_ON(task_queue_)
+void SharedPacer::MaybeScheduleWakeup() {
+  if (num_entries_ == 0) {
+    return;
+  }
+  // The entries of the next occupied slot may belong to a later turn of the
+  // wheel, in which case the wakeup finds nothing to do and moves on.
+  const int64_t tick = NextOccupiedTick();
+  if (wakeup_tick_.has_value() && *wakeup_tick_ <= tick) {
+    return;
+  }
+  wakeup_tick_ = tick;
+  const TimeDelta delay = std::max(
+      TimeDelta::Zero(),
+      Timestamp::Zero() + tick * kResolution - clock_->CurrentTime());
+  task_queue_->PostDelayedHighPrecisionTask(
+      SafeTask(safety_.flag(), [this, tick] { OnWakeup(tick); }),
+      delay.RoundUpTo(TimeDelta::Millis(1)));
+}
+
+void SharedPacer::OnWakeup(int64_t scheduled_tick) {
+  RTC_DCHECK_RUN_ON(task_queue_);
+  // Ignore retired wakeups.
+  if (wakeup_tick_ != scheduled_tick) {
+    return;
+  }
+  wakeup_tick_ = absl::nullopt;
+  ++wakeups_;
+  TRACE_EVENT0(TRACE_DISABLED_BY_DEFAULT("webrtc"), "SharedPacer::OnWakeup");
+
+  processing_ = true;
+  const int64_t now_tick = clock_->CurrentTime().us() / kResolution.us();
+  // Every slot is visited at most once, even if the task queue was late by
+  // more than a turn of the wheel.
+  processed_tick_ = std::max(processed_tick_, now_tick - kNumSlots);
+  while (processed_tick_ < now_tick) {
+    // Pacers scheduled by the process calls below go after this tick.
+    ++processed_tick_;
+    ProcessSlot(processed_tick_, now_tick);
+  }
+  // Pacers that may still wait are due now as well, and share this wakeup
+  // rather than needing one of their own.
+  for (int64_t tick = now_tick + 1; tick <= now_tick + kMaxDelayTicks;
+       ++tick) {
+    ProcessSlot(tick, now_tick);
+  }
+  processing_ = false;
+
+  MaybeScheduleWakeup();
+}
+
+// RTC_RUN_ON(task_queue_)
+void SharedPacer::ProcessSlot(int64_t tick, int64_t now_tick) {
+  const int slot_index = SlotIndex(tick);
+  if ((occupied_slots_[slot_index / kSlotsPerWord] &
+       (uint64_t{1} << (slot_index % kSlotsPerWord))) == 0) {
+    return;
+  }
+  due_ids_.clear();
+  for (int id : slots_[slot_index]) {
+    if (pacers_[id].due_tick <= now_tick) {
+      due_ids_.push_back(id);
+    }
+  }
+  for (int id : due_ids_) {
+    Pacer& pacer = pacers_[id];
+    // An earlier process call may have rescheduled this pacer.
+    if (pacer.scheduled_time.IsInfinite() || pacer.due_tick > now_tick) {
+      continue;
+    }
+    const Timestamp scheduled_time = pacer.scheduled_time;
+    RemoveEntry(id);
+    pacer.process(scheduled_time);
+  }
+}
+
+}  // namespace webrtc
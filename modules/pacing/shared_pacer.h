@@ -0,0 +1,132 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_PACING_SHARED_PACER_H_
+#define MODULES_PACING_SHARED_PACER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <vector>
+
+#include "absl/functional/any_invocable.h"
+#include "absl/types/optional.h"
+#include "api/task_queue/pending_task_safety_flag.h"
+#include "api/task_queue/task_queue_base.h"
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "rtc_base/thread_annotations.h"
+#include "system_wrappers/include/clock.h"
+
+namespace webrtc {
+
+// Schedules the process calls of many pacers, typically the
+// TaskQueuePacedSender of every transport of a server, from a single delayed
+// task instead of one delayed task per pacer. Process calls are kept in a
+// timing wheel of `kResolution` wide slots, in the slot of the latest time
+// they may be delayed to. The task queue wakes up at the earliest of those
+// times, and processes every pacer that is due by then, so pacers that can
+// wait for each other share one wakeup.
+//
+// Must be created, used and destroyed on the task queue of the pacers it
+// schedules, and outlive them.
+class SharedPacer {
+ public:
+  // Process times are rounded up to a multiple of `kResolution`, like the
+  // delayed tasks the pacers post on their own.
+  static constexpr TimeDelta kResolution = TimeDelta::Millis(1);
+  // Process calls are delayed at most this much to share a wakeup.
+  static constexpr TimeDelta kMaxDelay = TimeDelta::Millis(10);
+
+  using ProcessCallback = absl::AnyInvocable<void(Timestamp scheduled_time)>;
+
+  explicit SharedPacer(Clock* clock);
+  SharedPacer(const SharedPacer&) = delete;
+  SharedPacer& operator=(const SharedPacer&) = delete;
+  ~SharedPacer();
+
+  // Adds a pacer and returns its id. `process` is called with the time that
+  // was passed to Schedule() once that time is reached.
+  int Register(ProcessCallback process);
+  // Removes the pacer with `id`, including its scheduled process call.
+  void Unregister(int id);
+
+  // Schedules a process call of pacer `id` at `time`, replacing any process
+  // call scheduled earlier. The call may be delayed by up to `max_delay`,
+  // capped to `kMaxDelay`, to share a wakeup with other pacers. It is never
+  // made before `time`.
+  void Schedule(int id, Timestamp time, TimeDelta max_delay);
+  void Schedule(int id, Timestamp time) {
+    Schedule(id, time, TimeDelta::Zero());
+  }
+
+  // Number of times the task queue has woken up to process pacers.
+  int64_t wakeups() const;
+
+ private:
+  static constexpr int kNumSlots = 256;
+  static constexpr int kSlotsPerWord = 64;
+  static constexpr int kMaxDelayTicks = kMaxDelay / kResolution;
+  static_assert(kMaxDelayTicks < kNumSlots, "");
+
+  struct Pacer {
+    ProcessCallback process;
+    Timestamp scheduled_time = Timestamp::PlusInfinity();
+    // The first tick the process call is due at, and the last tick it may be
+    // delayed to, where it is kept in the wheel. Valid when `scheduled_time`
+    // is finite.
+    int64_t due_tick = 0;
+    int64_t tick = 0;
+    size_t position_in_slot = 0;
+  };
+
+  static int SlotIndex(int64_t tick) { return tick & (kNumSlots - 1); }
+
+  static int64_t TickAtOrAfter(Timestamp time);
+
+  void RemoveEntry(int id) RTC_RUN_ON(task_queue_);
+  void MaybeScheduleWakeup() RTC_RUN_ON(task_queue_);
+  void OnWakeup(int64_t scheduled_tick);
+  // Processes the pacers in the slot of `tick` that are due at `now_tick`.
+  void ProcessSlot(int64_t tick, int64_t now_tick) RTC_RUN_ON(task_queue_);
+  // Returns the earliest tick any scheduled process call may be due at.
+  int64_t NextOccupiedTick() const RTC_RUN_ON(task_queue_);
+
+  Clock* const clock_;
+  TaskQueueBase* const task_queue_;
+
+  std::vector<Pacer> pacers_ RTC_GUARDED_BY(task_queue_);
+  std::vector<int> free_ids_ RTC_GUARDED_BY(task_queue_);
+
+  // Slot `SlotIndex(tick)` holds the ids of the pacers that must be processed
+  // by `tick`, and by later ticks that map to the same slot. All ticks are
+  // later than `processed_tick_`.
+  std::array<std::vector<int>, kNumSlots> slots_
+      RTC_GUARDED_BY(task_queue_);
+  // Bit `i` is set if slot `i` is not empty.
+  std::array<uint64_t, kNumSlots / kSlotsPerWord> occupied_slots_
+      RTC_GUARDED_BY(task_queue_) = {};
+  size_t num_entries_ RTC_GUARDED_BY(task_queue_) = 0;
+  int64_t processed_tick_ RTC_GUARDED_BY(task_queue_);
+  bool processing_ RTC_GUARDED_BY(task_queue_) = false;
+  std::vector<int> due_ids_ RTC_GUARDED_BY(task_queue_);
+
+  // Tick of the pending wakeup task, if any. As for the pacers, an earlier
+  // wakeup retires the pending one rather than cancelling it.
+  absl::optional<int64_t> wakeup_tick_ RTC_GUARDED_BY(task_queue_);
+  int64_t wakeups_ RTC_GUARDED_BY(task_queue_) = 0;
+
+  ScopedTaskSafety safety_;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_PACING_SHARED_PACER_H_
@@ -0,0 +1,181 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#if defined(WEBRTC_POSIX)
+#include <sys/resource.h>
+#endif
+
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "api/transport/network_types.h"
+#include "api/units/data_rate.h"
+#include "api/units/data_size.h"
+#include "api/units/time_delta.h"
+#include "benchmark/benchmark.h"
+#include "modules/pacing/pacing_controller.h"
+#include "modules/pacing/shared_pacer.h"
+#include "modules/pacing/task_queue_paced_sender.h"
+#include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "rtc_base/system/unused.h"
+#include "rtc_base/task_queue_for_test.h"
+#include "system_wrappers/include/clock.h"
+#include "system_wrappers/include/sleep.h"
+#include "test/explicit_key_value_config.h"
+
+namespace webrtc {
+namespace {
+
+constexpr DataRate kPacingRate = DataRate::KilobitsPerSec(1000);
+constexpr DataRate kPaddingRate = DataRate::KilobitsPerSec(100);
+constexpr DataSize kPaddingPacketSize = DataSize::Bytes(224);
+constexpr TimeDelta kDuration = TimeDelta::Seconds(1);
+
+// Counts the times the process was woken up after having blocked, e.g. on a
+// timer.
+int64_t VoluntaryContextSwitches() {
+#if defined(WEBRTC_POSIX)
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_nvcsw;
+#else
+  return 0;
+#endif
+}
+
+// Drops the packets, and makes up padding packets like RTPSender does.
+class DiscardingPacketSender : public PacingController::PacketSender {
+ public:
+  explicit DiscardingPacketSender(std::atomic<int64_t>& packets_sent)
+      : packets_sent_(packets_sent) {}
+
+  void SendPacket(std::unique_ptr<RtpPacketToSend> packet,
+                  const PacedPacketInfo& cluster_info) override {
+    packets_sent_.fetch_add(1, std::memory_order_relaxed);
+  }
+  std::vector<std::unique_ptr<RtpPacketToSend>> FetchFec() override {
+    return {};
+  }
+  std::vector<std::unique_ptr<RtpPacketToSend>> GeneratePadding(
+      DataSize size) override {
+    std::vector<std::unique_ptr<RtpPacketToSend>> packets;
+    for (DataSize generated = DataSize::Zero(); generated < size;
+         generated += kPaddingPacketSize) {
+      auto packet = std::make_unique<RtpPacketToSend>(/*extensions=*/nullptr);
+      packet->set_packet_type(RtpPacketMediaType::kPadding);
+      packet->SetPadding(kPaddingPacketSize.bytes());
+      packets.push_back(std::move(packet));
+    }
+    return packets;
+  }
+
+ private:
+  std::atomic<int64_t>& packets_sent_;
+};
+
+// The pacer of one connection, sending padding on top of its media, as when
+// the bandwidth estimate is ramping up.
+class Connection {
+ public:
+  Connection(const FieldTrialsView& field_trials,
+             SharedPacer* shared_pacer,
+             std::atomic<int64_t>& packets_sent)
+      : packet_sender_(packets_sent),
+        // Same hold back as RtpTransportControllerSend.
+        pacer_(Clock::GetRealTimeClock(),
+               &packet_sender_,
+               field_trials,
+               TimeDelta::Millis(5),
+               3,
+               /*burst_interval=*/absl::nullopt,
+               shared_pacer) {
+    pacer_.SetPacingRates(kPacingRate, kPaddingRate);
+    pacer_.EnsureStarted();
+  }
+
+  void SendFirstPacket() {
+    // Padding is only sent after media.
+    auto packet = std::make_unique<RtpPacketToSend>(/*extensions=*/nullptr);
+    packet->set_packet_type(RtpPacketMediaType::kVideo);
+    packet->SetPayloadSize(1000);
+    std::vector<std::unique_ptr<RtpPacketToSend>> packets;
+    packets.push_back(std::move(packet));
+    pacer_.EnqueuePackets(std::move(packets));
+  }
+
+ private:
+  DiscardingPacketSender packet_sender_;
+  TaskQueuePacedSender pacer_;
+};
+
+// Paces `state.range(0)` connections from one task queue for `kDuration`,
+// scheduled by a SharedPacer when `state.range(1)` is set and by a delayed
+// task per connection otherwise. Reports the wakeups of the process and the
+// packets sent per second.
+void BM_PaceConnections(benchmark::State& state) {
+  const int num_connections = state.range(0);
+  const bool shared = state.range(1) != 0;
+  test::ExplicitKeyValueConfig field_trials("");
+  TaskQueueForTest task_queue("pacer");
+  std::atomic<int64_t> packets_sent(0);
+  std::unique_ptr<SharedPacer> shared_pacer;
+  std::vector<std::unique_ptr<Connection>> connections;
+  task_queue.SendTask([&] {
+    if (shared) {
+      shared_pacer = std::make_unique<SharedPacer>(Clock::GetRealTimeClock());
+    }
+    for (int i = 0; i < num_connections; ++i) {
+      connections.push_back(std::make_unique<Connection>(
+          field_trials, shared_pacer.get(), packets_sent));
+      // Spreads the connections over the padding interval, rather than
+      // having all of them send at once.
+      task_queue.Get()->PostDelayedHighPrecisionTask(
+          [connection = connections.back().get()] {
+            connection->SendFirstPacket();
+          },
+          kPaddingPacketSize / kPaddingRate * i / num_connections);
+    }
+  });
+  // Lets the pacers reach their steady state.
+  SleepMs(200);
+
+  int64_t wakeups = 0;
+  int64_t packets = 0;
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    const int64_t wakeups_before = VoluntaryContextSwitches();
+    const int64_t packets_before = packets_sent.load();
+    SleepMs(kDuration.ms());
+    wakeups += VoluntaryContextSwitches() - wakeups_before;
+    packets += packets_sent.load() - packets_before;
+  }
+
+  task_queue.SendTask([&] {
+    connections.clear();
+    shared_pacer = nullptr;
+  });
+  state.counters["wakeups"] =
+      benchmark::Counter(wakeups, benchmark::Counter::kIsRate);
+  state.counters["packets"] =
+      benchmark::Counter(packets, benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_PaceConnections)
+    ->ArgNames({"connections", "shared"})
+    ->ArgsProduct({{1, 10, 100, 1000}, {0, 1}})
+    ->Iterations(1)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace webrtc
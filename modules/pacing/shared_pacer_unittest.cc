@@ -0,0 +1,217 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/pacing/shared_pacer.h"
+
+#include <vector>
+
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+#include "test/time_controller/simulated_time_controller.h"
+
+namespace webrtc {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+constexpr Timestamp kStartTime = Timestamp::Millis(1234);
+
+class SharedPacerTest : public ::testing::Test {
+ protected:
+  SharedPacerTest()
+      : time_controller_(kStartTime),
+        shared_pacer_(time_controller_.GetClock()) {}
+
+  Timestamp Now() { return time_controller_.GetClock()->CurrentTime(); }
+
+  // Registers a pacer that records when it is processed.
+  int RegisterPacer(std::vector<Timestamp>& process_times) {
+    return shared_pacer_.Register([this, &process_times](Timestamp scheduled) {
+      EXPECT_GE(Now(), scheduled);
+      process_times.push_back(Now());
+    });
+  }
+
+  GlobalSimulatedTimeController time_controller_;
+  SharedPacer shared_pacer_;
+};
+
+TEST_F(SharedPacerTest, ProcessesPacerAtScheduledTime) {
+  std::vector<Timestamp> process_times;
+  int id = RegisterPacer(process_times);
+
+  shared_pacer_.Schedule(id, kStartTime + TimeDelta::Millis(5));
+  time_controller_.AdvanceTime(TimeDelta::Millis(4));
+  EXPECT_THAT(process_times, IsEmpty());
+  time_controller_.AdvanceTime(TimeDelta::Millis(1));
+  EXPECT_THAT(process_times, ElementsAre(kStartTime + TimeDelta::Millis(5)));
+
+  // Not processed again until scheduled again.
+  time_controller_.AdvanceTime(TimeDelta::Seconds(1));
+  EXPECT_THAT(process_times, ElementsAre(kStartTime + TimeDelta::Millis(5)));
+  shared_pacer_.Unregister(id);
+}
+
+TEST_F(SharedPacerTest, RoundsProcessTimeUpToResolution) {
+  std::vector<Timestamp> process_times;
+  int id = RegisterPacer(process_times);
+
+  shared_pacer_.Schedule(id, kStartTime + TimeDelta::Micros(2100));
+  time_controller_.AdvanceTime(TimeDelta::Millis(10));
+  EXPECT_THAT(process_times, ElementsAre(kStartTime + TimeDelta::Millis(3)));
+  shared_pacer_.Unregister(id);
+}
+
+TEST_F(SharedPacerTest, PacersDueInSameSlotShareWakeup) {
+  std::vector<Timestamp> process_times;
+  std::vector<int> ids;
+  for (int i = 0; i < 100; ++i) {
+    ids.push_back(RegisterPacer(process_times));
+    shared_pacer_.Schedule(ids.back(),
+                           kStartTime + TimeDelta::Micros(9001 + i * 9));
+  }
+  time_controller_.AdvanceTime(TimeDelta::Millis(20));
+  EXPECT_EQ(process_times.size(), 100u);
+  EXPECT_EQ(shared_pacer_.wakeups(), 1);
+  for (int id : ids) {
+    shared_pacer_.Unregister(id);
+  }
+}
+
+TEST_F(SharedPacerTest, PacersThatMayWaitShareWakeup) {
+  std::vector<Timestamp> process_times;
+  std::vector<int> ids;
+  // Each pacer may wait 5 ms, which is enough for all of them to be processed
+  // together once the first one can't wait any longer.
+  for (int i = 0; i < 5; ++i) {
+    ids.push_back(RegisterPacer(process_times));
+    shared_pacer_.Schedule(ids.back(), kStartTime + TimeDelta::Millis(5 + i),
+                           /*max_delay=*/TimeDelta::Millis(5));
+  }
+  time_controller_.AdvanceTime(TimeDelta::Millis(20));
+  EXPECT_THAT(process_times, ElementsAre(kStartTime + TimeDelta::Millis(10),
+                                         kStartTime + TimeDelta::Millis(10),
+                                         kStartTime + TimeDelta::Millis(10),
+                                         kStartTime + TimeDelta::Millis(10),
+                                         kStartTime + TimeDelta::Millis(10)));
+  EXPECT_EQ(shared_pacer_.wakeups(), 1);
+  for (int id : ids) {
+    shared_pacer_.Unregister(id);
+  }
+}
+
+TEST_F(SharedPacerTest, DoesNotProcessPacerBeforeScheduledTime) {
+  std::vector<Timestamp> process_times_1;
+  std::vector<Timestamp> process_times_2;
+  int id_1 = RegisterPacer(process_times_1);
+  int id_2 = RegisterPacer(process_times_2);
+
+  shared_pacer_.Schedule(id_1, kStartTime + TimeDelta::Millis(5));
+  shared_pacer_.Schedule(id_2, kStartTime + TimeDelta::Millis(8),
+                         /*max_delay=*/TimeDelta::Millis(5));
+  time_controller_.AdvanceTime(TimeDelta::Millis(20));
+  EXPECT_THAT(process_times_1, ElementsAre(kStartTime + TimeDelta::Millis(5)));
+  // Not due at the first wakeup, so processed as late as allowed.
+  EXPECT_THAT(process_times_2, ElementsAre(kStartTime + TimeDelta::Millis(13)));
+  EXPECT_EQ(shared_pacer_.wakeups(), 2);
+  shared_pacer_.Unregister(id_1);
+  shared_pacer_.Unregister(id_2);
+}
+
+TEST_F(SharedPacerTest, CapsDelay) {
+  std::vector<Timestamp> process_times;
+  int id = RegisterPacer(process_times);
+
+  shared_pacer_.Schedule(id, kStartTime + TimeDelta::Millis(5),
+                         /*max_delay=*/TimeDelta::Seconds(1));
+  time_controller_.AdvanceTime(TimeDelta::Seconds(2));
+  EXPECT_THAT(process_times, ElementsAre(kStartTime + TimeDelta::Millis(5) +
+                                         SharedPacer::kMaxDelay));
+  shared_pacer_.Unregister(id);
+}
+
+TEST_F(SharedPacerTest, ProcessesPacersInTimeOrder) {
+  std::vector<int> processed;
+  std::vector<int> ids;
+  for (int i = 0; i < 3; ++i) {
+    ids.push_back(shared_pacer_.Register(
+        [&processed, i](Timestamp /*scheduled*/) { processed.push_back(i); }));
+  }
+  shared_pacer_.Schedule(ids[0], kStartTime + TimeDelta::Millis(30));
+  shared_pacer_.Schedule(ids[1], kStartTime + TimeDelta::Millis(10));
+  shared_pacer_.Schedule(ids[2], kStartTime + TimeDelta::Millis(20));
+  time_controller_.AdvanceTime(TimeDelta::Millis(50));
+  EXPECT_THAT(processed, ElementsAre(1, 2, 0));
+  EXPECT_EQ(shared_pacer_.wakeups(), 3);
+  for (int id : ids) {
+    shared_pacer_.Unregister(id);
+  }
+}
+
+TEST_F(SharedPacerTest, ScheduleReplacesEarlierProcessCall) {
+  std::vector<Timestamp> process_times;
+  int id = RegisterPacer(process_times);
+
+  shared_pacer_.Schedule(id, kStartTime + TimeDelta::Millis(20));
+  shared_pacer_.Schedule(id, kStartTime + TimeDelta::Millis(5));
+  shared_pacer_.Schedule(id, kStartTime + TimeDelta::Millis(10));
+  time_controller_.AdvanceTime(TimeDelta::Millis(50));
+  EXPECT_THAT(process_times, ElementsAre(kStartTime + TimeDelta::Millis(10)));
+  shared_pacer_.Unregister(id);
+}
+
+TEST_F(SharedPacerTest, ProcessCallCanScheduleAgain) {
+  std::vector<Timestamp> process_times;
+  int id = shared_pacer_.Register([&](Timestamp scheduled) {
+    process_times.push_back(Now());
+    shared_pacer_.Schedule(id, scheduled + TimeDelta::Millis(5));
+  });
+  shared_pacer_.Schedule(id, kStartTime + TimeDelta::Millis(5));
+  time_controller_.AdvanceTime(TimeDelta::Millis(16));
+  EXPECT_THAT(process_times, ElementsAre(kStartTime + TimeDelta::Millis(5),
+                                         kStartTime + TimeDelta::Millis(10),
+                                         kStartTime + TimeDelta::Millis(15)));
+  shared_pacer_.Unregister(id);
+}
+
+TEST_F(SharedPacerTest, ProcessesPacerScheduledSeveralTurnsAhead) {
+  std::vector<Timestamp> process_times;
+  int id = RegisterPacer(process_times);
+
+  // Further ahead than the wheel has slots.
+  shared_pacer_.Schedule(id, kStartTime + TimeDelta::Millis(1000));
+  time_controller_.AdvanceTime(TimeDelta::Millis(999));
+  EXPECT_THAT(process_times, IsEmpty());
+  time_controller_.AdvanceTime(TimeDelta::Millis(1));
+  EXPECT_THAT(process_times,
+              ElementsAre(kStartTime + TimeDelta::Millis(1000)));
+  shared_pacer_.Unregister(id);
+}
+
+TEST_F(SharedPacerTest, UnregisterCancelsProcessCall) {
+  std::vector<Timestamp> process_times_1;
+  std::vector<Timestamp> process_times_2;
+  int id_1 = RegisterPacer(process_times_1);
+  int id_2 = RegisterPacer(process_times_2);
+
+  shared_pacer_.Schedule(id_1, kStartTime + TimeDelta::Millis(5));
+  shared_pacer_.Schedule(id_2, kStartTime + TimeDelta::Millis(5));
+  shared_pacer_.Unregister(id_1);
+  time_controller_.AdvanceTime(TimeDelta::Millis(10));
+  EXPECT_THAT(process_times_1, IsEmpty());
+  EXPECT_THAT(process_times_2, ElementsAre(kStartTime + TimeDelta::Millis(5)));
+  shared_pacer_.Unregister(id_2);
+}
+
+}  // namespace
+}  // namespace webrtc
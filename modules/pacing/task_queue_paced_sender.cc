@@ -43,7 +43,8 @@ TaskQueuePacedSender::TaskQueuePacedSender(
     const FieldTrialsView& field_trials,
     TimeDelta max_hold_back_window,
     int max_hold_back_window_in_packets,
-    absl::optional<TimeDelta> burst_interval)
+    absl::optional<TimeDelta> burst_interval,
+    SharedPacer* shared_pacer)
     : clock_(clock),
       bursty_pacer_flags_(field_trials),
       max_hold_back_window_(max_hold_back_window),
@@ -54,6 +55,7 @@ TaskQueuePacedSender::TaskQueuePacedSender(
       is_shutdown_(false),
       packet_size_(/*alpha=*/0.95),
       include_overhead_(false),
+      shared_pacer_(shared_pacer),
       task_queue_(TaskQueueBase::Current()) {
   RTC_DCHECK_GE(max_hold_back_window_, PacingController::kMinSleepTime);
   // There are multiple field trials that can affect burst. If multiple bursts
@@ -67,11 +69,20 @@ TaskQueuePacedSender::TaskQueuePacedSender(
   if (burst.has_value()) {
     pacing_controller_.SetSendBurstInterval(burst.value());
   }
+  if (shared_pacer_) {
+    shared_pacer_id_ =
+        shared_pacer_->Register([this](Timestamp scheduled_process_time) {
+          MaybeProcessPackets(scheduled_process_time);
+        });
+  }
 }
 
 TaskQueuePacedSender::~TaskQueuePacedSender() {
   RTC_DCHECK_RUN_ON(task_queue_);
   is_shutdown_ = true;
+  if (shared_pacer_) {
+    shared_pacer_->Unregister(shared_pacer_id_);
+  }
 }
 
 void TaskQueuePacedSender::EnsureStarted() {
@@ -111,6 +122,13 @@ void TaskQueuePacedSender::SetPacingRates(DataRate pacing_rate,
   MaybeScheduleProcessPackets();
 }
 
+void TaskQueuePacedSender::SetSecondaryRoutePacingRate(
+    DataRate secondary_rate) {
+  RTC_DCHECK_RUN_ON(task_queue_);
+  pacing_controller_.SetSecondaryRoutePacingRate(secondary_rate);
+  MaybeScheduleProcessPackets();
+}
+
 void TaskQueuePacedSender::EnqueuePackets(
     std::vector<std::unique_ptr<RtpPacketToSend>> packets) {
   task_queue_->PostTask(
@@ -281,12 +299,21 @@ void TaskQueuePacedSender::MaybeProcessPackets(
   // schedule a new one. Previous in flight task will be retired.
   if (next_process_time_.IsMinusInfinity() ||
       next_process_time_ > next_send_time) {
-    // Prefer low precision if allowed and not probing.
-    task_queue_->PostDelayedHighPrecisionTask(
-        SafeTask(
-            safety_.flag(),
-            [this, next_send_time]() { MaybeProcessPackets(next_send_time); }),
-        time_to_next_process.RoundUpTo(TimeDelta::Millis(1)));
+    if (shared_pacer_) {
+      // Replaces the process call scheduled earlier, if any. Like the hold
+      // back, which spaces process calls outside of probing, a delay of up to
+      // `hold_back_window` lets other pacers be processed in the same wakeup.
+      shared_pacer_->Schedule(shared_pacer_id_, next_send_time,
+                              hold_back_window);
+    } else {
+      // Prefer low precision if allowed and not probing.
+      task_queue_->PostDelayedHighPrecisionTask(
+          SafeTask(safety_.flag(),
+                   [this, next_send_time]() {
+                     MaybeProcessPackets(next_send_time);
+                   }),
+          time_to_next_process.RoundUpTo(TimeDelta::Millis(1)));
+    }
     next_process_time_ = next_send_time;
   }
 }
@@ -26,6 +26,7 @@
 #include "api/units/timestamp.h"
 #include "modules/pacing/pacing_controller.h"
 #include "modules/pacing/rtp_packet_pacer.h"
+#include "modules/pacing/shared_pacer.h"
 #include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
 #include "rtc_base/experiments/field_trial_parser.h"
 #include "rtc_base/numerics/exp_filter.h"
@@ -50,6 +51,9 @@ class TaskQueuePacedSender : public RtpPacketPacer, public RtpPacketSender {
   // specified interval. This greatly reduced wake ups by not pacing packets
   // within the allowed burst budget.
   //
+  // If `shared_pacer` is set, the pacer is processed from the delayed task of
+  // `shared_pacer` rather than from delayed tasks of its own.
+  //
   // The taskqueue used when constructing a TaskQueuePacedSender will also be
   // used for pacing.
   TaskQueuePacedSender(
@@ -58,7 +62,8 @@ class TaskQueuePacedSender : public RtpPacketPacer, public RtpPacketSender {
       const FieldTrialsView& field_trials,
       TimeDelta max_hold_back_window,
       int max_hold_back_window_in_packets,
-      absl::optional<TimeDelta> burst_interval = absl::nullopt);
+      absl::optional<TimeDelta> burst_interval = absl::nullopt,
+      SharedPacer* shared_pacer = nullptr);
 
   ~TaskQueuePacedSender() override;
 
@@ -90,6 +95,10 @@ class TaskQueuePacedSender : public RtpPacketPacer, public RtpPacketSender {
   // Sets the pacing rates. Must be called once before packets can be sent.
   void SetPacingRates(DataRate pacing_rate, DataRate padding_rate) override;
 
+  // Sets the pacing rate of the secondary route of the transport, or zero if
+  // there is none. See PacingController::SetSecondaryRoutePacingRate().
+  void SetSecondaryRoutePacingRate(DataRate secondary_rate);
+
   // Currently audio traffic is not accounted for by pacer and passed through.
   // With the introduction of audio BWE, audio traffic will be accounted for
   // in the pacer budget calculation. The audio traffic will still be injected
@@ -186,6 +195,10 @@ class TaskQueuePacedSender : public RtpPacketPacer, public RtpPacketSender {
   // Protects against ProcessPackets reentry from packet sent receipts.
   bool processing_packets_ RTC_GUARDED_BY(task_queue_) = false;
 
+  SharedPacer* const shared_pacer_;
+  // Id of this pacer in `shared_pacer_`, if set.
+  int shared_pacer_id_ = -1;
+
   ScopedTaskSafety safety_;
   TaskQueueBase* task_queue_;
 };
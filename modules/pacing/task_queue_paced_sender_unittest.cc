@@ -25,6 +25,7 @@
 #include "api/units/data_size.h"
 #include "api/units/time_delta.h"
 #include "modules/pacing/packet_router.h"
+#include "modules/pacing/shared_pacer.h"
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
@@ -206,6 +207,56 @@ TEST(TaskQueuePacedSenderTest, PacesPacketsWithBurst) {
   EXPECT_NEAR((end_time - start_time).ms<double>(), 500.0, 50.0);
 }
 
+TEST(TaskQueuePacedSenderTest, PacesPacketsWithSharedPacer) {
+  GlobalSimulatedTimeController time_controller(Timestamp::Millis(1234));
+  ScopedKeyValueConfig trials;
+  SharedPacer shared_pacer(time_controller.GetClock());
+  MockPacketRouter packet_routers[2];
+  std::vector<std::unique_ptr<TaskQueuePacedSender>> pacers;
+  for (MockPacketRouter& packet_router : packet_routers) {
+    pacers.push_back(std::make_unique<TaskQueuePacedSender>(
+        time_controller.GetClock(), &packet_router, trials,
+        PacingController::kMinSleepTime,
+        TaskQueuePacedSender::kNoPacketHoldback,
+        /*burst_interval=*/absl::nullopt, &shared_pacer));
+  }
+
+  // Insert a number of packets into each pacer, covering one second.
+  static constexpr size_t kPacketsToSend = 42;
+  for (auto& pacer : pacers) {
+    pacer->SetPacingRates(
+        DataRate::BitsPerSec(kDefaultPacketSize * 8 * kPacketsToSend),
+        DataRate::Zero());
+    pacer->EnsureStarted();
+    pacer->EnqueuePackets(
+        GeneratePackets(RtpPacketMediaType::kVideo, kPacketsToSend));
+  }
+
+  // Expect each of the pacers to send all of its packets.
+  size_t packets_sent[2] = {0, 0};
+  Timestamp end_time[2] = {Timestamp::PlusInfinity(),
+                           Timestamp::PlusInfinity()};
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_CALL(packet_routers[i], SendPacket)
+        .WillRepeatedly([&, i](std::unique_ptr<RtpPacketToSend> packet,
+                               const PacedPacketInfo& cluster_info) {
+          if (++packets_sent[i] == kPacketsToSend) {
+            end_time[i] = time_controller.GetClock()->CurrentTime();
+          }
+        });
+  }
+
+  const Timestamp start_time = time_controller.GetClock()->CurrentTime();
+  time_controller.AdvanceTime(TimeDelta::Seconds(1));
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_EQ(packets_sent[i], kPacketsToSend);
+    ASSERT_TRUE(end_time[i].IsFinite());
+    EXPECT_NEAR((end_time[i] - start_time).ms<double>(), 1000.0, 50.0);
+  }
+  // The pacers send at the same times, so they share wakeups.
+  EXPECT_LT(shared_pacer.wakeups(), 2 * static_cast<int>(kPacketsToSend));
+}
+
 TEST(TaskQueuePacedSenderTest, ReschedulesProcessOnRateChange) {
   GlobalSimulatedTimeController time_controller(Timestamp::Millis(1234));
   MockPacketRouter packet_router;
@@ -0,0 +1,113 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/remote_bitrate_estimator/congestion_control_feedback_generator.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "modules/rtp_rtcp/source/rtcp_packet/congestion_control_feedback.h"
+#include "modules/rtp_rtcp/source/time_util.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+
+namespace webrtc {
+namespace {
+
+constexpr TimeDelta kFeedbackInterval = TimeDelta::Millis(25);
+// Keeps the feedback packet, at 2 bytes per report, well within the MTU.
+constexpr int64_t kMaxReportsPerFeedback = 500;
+
+}  // namespace
+
+CongestionControlFeedbackGenerator::CongestionControlFeedbackGenerator(
+    Clock* clock,
+    RemoteEstimatorProxy::TransportFeedbackSender feedback_sender)
+    : clock_(clock), feedback_sender_(std::move(feedback_sender)) {}
+
+CongestionControlFeedbackGenerator::~CongestionControlFeedbackGenerator() =
+    default;
+
+void CongestionControlFeedbackGenerator::OnReceivedPacket(
+    const RtpPacketReceived& packet) {
+  if (packet.arrival_time().IsInfinite()) {
+    RTC_LOG(LS_WARNING) << "Arrival time not set.";
+    return;
+  }
+  MutexLock lock(&lock_);
+  StreamState& stream = streams_[packet.Ssrc()];
+  int64_t sequence_number =
+      stream.unwrapper.Unwrap(packet.SequenceNumber());
+  if (stream.next_to_report.has_value() &&
+      sequence_number < *stream.next_to_report) {
+    // Already reported, as received or as lost.
+    return;
+  }
+  stream.packets.emplace(
+      sequence_number, PacketArrival{packet.arrival_time(), packet.ecn()});
+}
+
+TimeDelta CongestionControlFeedbackGenerator::Process(Timestamp now) {
+  MutexLock lock(&lock_);
+  if (now >= next_feedback_time_) {
+    next_feedback_time_ = now + kFeedbackInterval;
+    SendFeedback(now);
+  }
+  return next_feedback_time_ - now;
+}
+
+void CongestionControlFeedbackGenerator::SendFeedback(Timestamp now) {
+  std::vector<rtcp::CongestionControlFeedback::PacketInfo> packets;
+  int64_t reports_left = kMaxReportsPerFeedback;
+  for (auto& [ssrc, stream] : streams_) {
+    if (stream.packets.empty() || reports_left == 0) {
+      continue;
+    }
+    int64_t begin =
+        stream.next_to_report.value_or(stream.packets.begin()->first);
+    // Packets missing between two reports are reported as lost, so the
+    // feedback covers every sequence number in [begin, end).
+    int64_t end = std::min(stream.packets.rbegin()->first + 1,
+                           begin + reports_left);
+    if (stream.packets.begin()->first != begin) {
+      packets.push_back({.ssrc = ssrc,
+                         .sequence_number = static_cast<uint16_t>(begin)});
+    }
+    auto it = stream.packets.begin();
+    for (; it != stream.packets.end() && it->first < end; ++it) {
+      packets.push_back(
+          {.ssrc = ssrc,
+           .sequence_number = static_cast<uint16_t>(it->first),
+           .arrival_time_offset =
+               std::max(now - it->second.arrival_time, TimeDelta::Zero()),
+           .ecn = it->second.ecn});
+    }
+    if (packets.back().sequence_number != static_cast<uint16_t>(end - 1)) {
+      // The packets at the end of a capped report were not received either.
+      packets.push_back({.ssrc = ssrc,
+                         .sequence_number = static_cast<uint16_t>(end - 1)});
+    }
+    stream.packets.erase(stream.packets.begin(), it);
+    stream.next_to_report = end;
+    reports_left -= end - begin;
+  }
+  if (packets.empty()) {
+    return;
+  }
+  std::vector<std::unique_ptr<rtcp::RtcpPacket>> rtcp_packets;
+  rtcp_packets.push_back(std::make_unique<rtcp::CongestionControlFeedback>(
+      std::move(packets),
+      CompactNtp(clock_->ConvertTimestampToNtpTime(now))));
+  feedback_sender_(std::move(rtcp_packets));
+}
+
+}  // namespace webrtc
@@ -0,0 +1,75 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_REMOTE_BITRATE_ESTIMATOR_CONGESTION_CONTROL_FEEDBACK_GENERATOR_H_
+#define MODULES_REMOTE_BITRATE_ESTIMATOR_CONGESTION_CONTROL_FEEDBACK_GENERATOR_H_
+
+#include <stdint.h>
+
+#include <map>
+
+#include "absl/types/optional.h"
+#include "api/transport/ecn_marking.h"
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "modules/remote_bitrate_estimator/remote_estimator_proxy.h"
+#include "modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "rtc_base/numerics/sequence_number_unwrapper.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_base/thread_annotations.h"
+#include "system_wrappers/include/clock.h"
+
+namespace webrtc {
+
+// Used instead of RemoteEstimatorProxy when the send side expects congestion
+// control feedback according to RFC 8888: Records the arrival time and the
+// ECN codepoint of every received RTP packet and periodically reports them,
+// per SSRC and RTP sequence number, in rtcp::CongestionControlFeedback.
+class CongestionControlFeedbackGenerator {
+ public:
+  CongestionControlFeedbackGenerator(
+      Clock* clock,
+      RemoteEstimatorProxy::TransportFeedbackSender feedback_sender);
+  ~CongestionControlFeedbackGenerator();
+
+  void OnReceivedPacket(const RtpPacketReceived& packet);
+
+  // Sends feedback if it is time to send it.
+  // Returns time until next call to Process should be made.
+  TimeDelta Process(Timestamp now);
+
+ private:
+  struct PacketArrival {
+    Timestamp arrival_time;
+    EcnMarking ecn;
+  };
+  struct StreamState {
+    SeqNumUnwrapper<uint16_t> unwrapper;
+    // The first sequence number that has not been reported yet.
+    absl::optional<int64_t> next_to_report;
+    // Received packets that have not been reported, by unwrapped sequence
+    // number.
+    std::map<int64_t, PacketArrival> packets;
+  };
+
+  void SendFeedback(Timestamp now) RTC_EXCLUSIVE_LOCKS_REQUIRED(&lock_);
+
+  Clock* const clock_;
+  const RemoteEstimatorProxy::TransportFeedbackSender feedback_sender_;
+
+  Mutex lock_;
+  std::map<uint32_t, StreamState> streams_ RTC_GUARDED_BY(&lock_);
+  Timestamp next_feedback_time_ RTC_GUARDED_BY(&lock_) =
+      Timestamp::MinusInfinity();
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_REMOTE_BITRATE_ESTIMATOR_CONGESTION_CONTROL_FEEDBACK_GENERATOR_H_
@@ -0,0 +1,182 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/remote_bitrate_estimator/congestion_control_feedback_generator.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "api/transport/ecn_marking.h"
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/common_header.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/congestion_control_feedback.h"
+#include "modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "rtc_base/buffer.h"
+#include "system_wrappers/include/clock.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::MockFunction;
+using ::testing::Property;
+using ::testing::SizeIs;
+
+using PacketInfo = rtcp::CongestionControlFeedback::PacketInfo;
+
+constexpr uint32_t kSsrc = 456;
+constexpr uint32_t kOtherSsrc = 789;
+// A multiple of the 1/1024 second resolution of the arrival time offsets.
+constexpr TimeDelta kOffsetStep = TimeDelta::Micros(15625);
+
+// Returns the reports of the feedback in `packets` as received by the sender.
+std::vector<PacketInfo> ParsedReports(
+    const std::vector<std::unique_ptr<rtcp::RtcpPacket>>& packets) {
+  EXPECT_THAT(packets, SizeIs(1));
+  rtc::Buffer buffer = packets[0]->Build();
+  rtcp::CommonHeader header;
+  EXPECT_TRUE(header.Parse(buffer.data(), buffer.size()));
+  rtcp::CongestionControlFeedback feedback;
+  EXPECT_TRUE(feedback.Parse(header));
+  return std::vector<PacketInfo>(feedback.packets().begin(),
+                                 feedback.packets().end());
+}
+
+class CongestionControlFeedbackGeneratorTest : public ::testing::Test {
+ public:
+  CongestionControlFeedbackGeneratorTest()
+      : clock_(Timestamp::Seconds(10)),
+        generator_(&clock_, feedback_sender_.AsStdFunction()) {}
+
+ protected:
+  void OnReceivedPacket(uint32_t ssrc,
+                        uint16_t sequence_number,
+                        EcnMarking ecn = EcnMarking::kNotEct) {
+    RtpPacketReceived packet(nullptr, clock_.CurrentTime());
+    packet.SetSsrc(ssrc);
+    packet.SetSequenceNumber(sequence_number);
+    packet.set_ecn(ecn);
+    generator_.OnReceivedPacket(packet);
+  }
+
+  std::vector<PacketInfo> ProcessAndGetReports() {
+    std::vector<PacketInfo> reports;
+    EXPECT_CALL(feedback_sender_, Call)
+        .WillOnce([&](std::vector<std::unique_ptr<rtcp::RtcpPacket>> packets) {
+          reports = ParsedReports(packets);
+        });
+    generator_.Process(clock_.CurrentTime());
+    return reports;
+  }
+
+  SimulatedClock clock_;
+  MockFunction<void(std::vector<std::unique_ptr<rtcp::RtcpPacket>>)>
+      feedback_sender_;
+  CongestionControlFeedbackGenerator generator_;
+};
+
+TEST_F(CongestionControlFeedbackGeneratorTest, SendsNoFeedbackWithoutPackets) {
+  EXPECT_CALL(feedback_sender_, Call).Times(0);
+  EXPECT_EQ(generator_.Process(clock_.CurrentTime()), TimeDelta::Millis(25));
+}
+
+TEST_F(CongestionControlFeedbackGeneratorTest,
+       ReportsArrivalTimeAndEcnOfReceivedPackets) {
+  OnReceivedPacket(kSsrc, 10, EcnMarking::kEct1);
+  clock_.AdvanceTime(2 * kOffsetStep);
+  OnReceivedPacket(kSsrc, 11, EcnMarking::kCe);
+  clock_.AdvanceTime(kOffsetStep);
+
+  std::vector<PacketInfo> reports = ProcessAndGetReports();
+  ASSERT_THAT(reports, SizeIs(2));
+  EXPECT_EQ(reports[0].ssrc, kSsrc);
+  EXPECT_EQ(reports[0].sequence_number, 10);
+  EXPECT_EQ(reports[0].arrival_time_offset, 3 * kOffsetStep);
+  EXPECT_EQ(reports[0].ecn, EcnMarking::kEct1);
+  EXPECT_EQ(reports[1].sequence_number, 11);
+  EXPECT_EQ(reports[1].arrival_time_offset, kOffsetStep);
+  EXPECT_EQ(reports[1].ecn, EcnMarking::kCe);
+}
+
+TEST_F(CongestionControlFeedbackGeneratorTest, ReportsLostPackets) {
+  OnReceivedPacket(kSsrc, 10);
+  ProcessAndGetReports();
+
+  // 11 and 13 are lost.
+  OnReceivedPacket(kSsrc, 12);
+  OnReceivedPacket(kSsrc, 14);
+  clock_.AdvanceTime(TimeDelta::Millis(25));
+  EXPECT_THAT(ProcessAndGetReports(),
+              ElementsAre(Property(&PacketInfo::received, false),
+                          Property(&PacketInfo::received, true),
+                          Property(&PacketInfo::received, false),
+                          Property(&PacketInfo::received, true)));
+}
+
+TEST_F(CongestionControlFeedbackGeneratorTest,
+       DoesNotReportPacketsAgainOrReportLatePackets) {
+  OnReceivedPacket(kSsrc, 10);
+  OnReceivedPacket(kSsrc, 12);
+  ProcessAndGetReports();
+
+  // 11 was reported as lost already.
+  OnReceivedPacket(kSsrc, 11);
+  clock_.AdvanceTime(TimeDelta::Millis(25));
+  EXPECT_CALL(feedback_sender_, Call).Times(0);
+  generator_.Process(clock_.CurrentTime());
+}
+
+TEST_F(CongestionControlFeedbackGeneratorTest, ReportsEachSsrc) {
+  OnReceivedPacket(kSsrc, 10);
+  OnReceivedPacket(kOtherSsrc, 20);
+
+  std::vector<PacketInfo> reports = ProcessAndGetReports();
+  ASSERT_THAT(reports, SizeIs(2));
+  EXPECT_EQ(reports[0].ssrc, kSsrc);
+  EXPECT_EQ(reports[0].sequence_number, 10);
+  EXPECT_EQ(reports[1].ssrc, kOtherSsrc);
+  EXPECT_EQ(reports[1].sequence_number, 20);
+}
+
+TEST_F(CongestionControlFeedbackGeneratorTest,
+       SendsFeedbackAtMostEveryInterval) {
+  OnReceivedPacket(kSsrc, 10);
+  ProcessAndGetReports();
+
+  clock_.AdvanceTime(TimeDelta::Millis(10));
+  OnReceivedPacket(kSsrc, 11);
+  EXPECT_CALL(feedback_sender_, Call).Times(0);
+  EXPECT_EQ(generator_.Process(clock_.CurrentTime()), TimeDelta::Millis(15));
+  ::testing::Mock::VerifyAndClearExpectations(&feedback_sender_);
+
+  clock_.AdvanceTime(TimeDelta::Millis(15));
+  EXPECT_THAT(ProcessAndGetReports(), SizeIs(1));
+}
+
+TEST_F(CongestionControlFeedbackGeneratorTest, LimitsReportsPerFeedback) {
+  for (int i = 0; i < 600; ++i) {
+    OnReceivedPacket(kSsrc, i);
+  }
+  std::vector<PacketInfo> reports = ProcessAndGetReports();
+  ASSERT_THAT(reports, SizeIs(500));
+  EXPECT_EQ(reports.back().sequence_number, 499);
+
+  clock_.AdvanceTime(TimeDelta::Millis(25));
+  reports = ProcessAndGetReports();
+  ASSERT_THAT(reports, SizeIs(100));
+  EXPECT_EQ(reports.front().sequence_number, 500);
+}
+
+}  // namespace
+}  // namespace webrtc
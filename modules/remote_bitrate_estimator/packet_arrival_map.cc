@@ -11,7 +11,11 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <limits>
+#include <memory>
+#include <utility>
 
+#include "absl/numeric/bits.h"
 #include "api/units/timestamp.h"
 #include "rtc_base/checks.h"
 
@@ -25,14 +29,23 @@ void PacketArrivalTimeMap::AddPacket(int64_t sequence_number,
     Reallocate(kMinCapacity);
     begin_sequence_number_ = sequence_number;
     end_sequence_number_ = sequence_number + 1;
-    arrival_times_[Index(sequence_number)] = arrival_time;
+    base_arrival_time_us_ = arrival_time.us();
+    SetReceived(sequence_number, arrival_time);
+    return;
+  }
+
+  if (sequence_number == end_sequence_number_ &&
+      end_sequence_number_ - begin_sequence_number_ < capacity()) {
+    // The next packet in order, which fits in the buffer as is.
+    end_sequence_number_ = sequence_number + 1;
+    SetReceived(sequence_number, arrival_time);
     return;
   }
 
   if (sequence_number >= begin_sequence_number() &&
       sequence_number < end_sequence_number()) {
     // The packet is within the buffer - no need to expand it.
-    arrival_times_[Index(sequence_number)] = arrival_time;
+    SetReceived(sequence_number, arrival_time);
     return;
   }
 
@@ -47,9 +60,9 @@ void PacketArrivalTimeMap::AddPacket(int64_t sequence_number,
     }
     AdjustToSize(new_size);
 
-    arrival_times_[Index(sequence_number)] = arrival_time;
     SetNotReceived(sequence_number + 1, begin_sequence_number_);
     begin_sequence_number_ = sequence_number;
+    SetReceived(sequence_number, arrival_time);
     return;
   }
 
@@ -61,7 +74,7 @@ void PacketArrivalTimeMap::AddPacket(int64_t sequence_number,
     // All old packets have to be removed.
     begin_sequence_number_ = sequence_number;
     end_sequence_number_ = new_end_sequence_number;
-    arrival_times_[Index(sequence_number)] = arrival_time;
+    SetReceived(sequence_number, arrival_time);
     return;
   }
 
@@ -77,38 +90,128 @@ void PacketArrivalTimeMap::AddPacket(int64_t sequence_number,
   // packet, add enough placeholders to fill the gap.
   SetNotReceived(end_sequence_number_, sequence_number);
   end_sequence_number_ = new_end_sequence_number;
-  arrival_times_[Index(sequence_number)] = arrival_time;
+  SetReceived(sequence_number, arrival_time);
+}
+
+int64_t PacketArrivalTimeMap::NextReceived(
+    int64_t sequence_number,
+    int64_t end_sequence_number_exclusive) const {
+  // Words of the bit mask never wrap around the buffer, so scanning to the end
+  // of a word and continuing at the start of the next one follows the sequence
+  // numbers. Bits past the end of the map may be stale, which is handled by
+  // clamping the result.
+  while (sequence_number < end_sequence_number_exclusive) {
+    int index = Index(sequence_number);
+    int bit = BitIndex(index);
+    uint64_t word = received_[WordIndex(index)] >> bit;
+    if (word != 0) {
+      return std::min(sequence_number + absl::countr_zero(word),
+                      end_sequence_number_exclusive);
+    }
+    sequence_number += kBitsPerWord - bit;
+  }
+  return end_sequence_number_exclusive;
+}
+
+PacketArrivalTimeMap::PacketArrivalTime PacketArrivalTimeMap::FindNextReceived(
+    int64_t sequence_number) const {
+  sequence_number = NextReceived(sequence_number, end_sequence_number_);
+  RTC_DCHECK_LT(sequence_number, end_sequence_number_);
+  return {.arrival_time = ArrivalTime(Index(sequence_number)),
+          .sequence_number = sequence_number};
+}
+
+void PacketArrivalTimeMap::SetReceived(int64_t sequence_number,
+                                       Timestamp arrival_time) {
+  int64_t offset_us = arrival_time.us() - base_arrival_time_us_;
+  if (offset_us <= kNotReceived ||
+      offset_us > std::numeric_limits<int32_t>::max()) {
+    Rebase(arrival_time.us());
+    offset_us = 0;
+  }
+  int index = Index(sequence_number);
+  arrival_time_offsets_us_[index] = static_cast<int32_t>(offset_us);
+  received_[WordIndex(index)] |= uint64_t{1} << BitIndex(index);
 }
 
 void PacketArrivalTimeMap::SetNotReceived(
     int64_t begin_sequence_number_inclusive,
     int64_t end_sequence_number_exclusive) {
-  static constexpr Timestamp value = Timestamp::MinusInfinity();
-
-  int begin_index = Index(begin_sequence_number_inclusive);
-  int end_index = Index(end_sequence_number_exclusive);
-
-  if (begin_index <= end_index) {
-    // Entries to clear are in single block:
-    // [......{-----}....]
-    std::fill(arrival_times_.get() + begin_index,
-              arrival_times_.get() + end_index, value);
-  } else {
-    // Entries to clear span across arrival_times_ border:
-    // [--}..........{---]
-    std::fill(arrival_times_.get() + begin_index,
-              arrival_times_.get() + capacity(), value);
-    std::fill(arrival_times_.get(), arrival_times_.get() + end_index, value);
+  RTC_DCHECK_LE(end_sequence_number_exclusive - begin_sequence_number_inclusive,
+                capacity());
+  int64_t sequence_number = begin_sequence_number_inclusive;
+  while (sequence_number < end_sequence_number_exclusive) {
+    int index = Index(sequence_number);
+    int bit = BitIndex(index);
+    int count = std::min<int64_t>(
+        kBitsPerWord - bit, end_sequence_number_exclusive - sequence_number);
+    uint64_t mask = count == kBitsPerWord ? ~uint64_t{0}
+                                          : ((uint64_t{1} << count) - 1) << bit;
+    received_[WordIndex(index)] &= ~mask;
+    std::fill_n(&arrival_time_offsets_us_[index], count, kNotReceived);
+    sequence_number += count;
   }
 }
 
+void PacketArrivalTimeMap::Rebase(int64_t base_arrival_time_us) {
+  for (int64_t sequence_number = NextReceived(begin_sequence_number_,
+                                              end_sequence_number_);
+       sequence_number < end_sequence_number_;
+       sequence_number =
+           NextReceived(sequence_number + 1, end_sequence_number_)) {
+    int index = Index(sequence_number);
+    int64_t offset_us = ArrivalTime(index).us() - base_arrival_time_us;
+    if (offset_us <= kNotReceived ||
+        offset_us > std::numeric_limits<int32_t>::max()) {
+      // More than half an hour from the new base.
+      SetNotReceived(sequence_number, sequence_number + 1);
+      continue;
+    }
+    arrival_time_offsets_us_[index] = static_cast<int32_t>(offset_us);
+  }
+  base_arrival_time_us_ = base_arrival_time_us;
+}
+
 void PacketArrivalTimeMap::RemoveOldPackets(int64_t sequence_number,
                                             Timestamp arrival_time_limit) {
   int64_t check_to = std::min(sequence_number, end_sequence_number_);
-  while (begin_sequence_number_ < check_to &&
-         arrival_times_[Index(begin_sequence_number_)] <= arrival_time_limit) {
-    ++begin_sequence_number_;
+  int64_t begin = begin_sequence_number_;
+  // Offsets never exceed 32 bits, so an infinite limit is before or after all
+  // of them.
+  const int64_t limit_offset_us =
+      arrival_time_limit.IsFinite()
+          ? arrival_time_limit.us() - base_arrival_time_us_
+      : arrival_time_limit.IsPlusInfinity()
+          ? std::numeric_limits<int64_t>::max()
+          : std::numeric_limits<int64_t>::min();
+  while (begin < check_to) {
+    int index = Index(begin);
+    int bit = BitIndex(index);
+    int count = std::min<int64_t>(kBitsPerWord - bit, check_to - begin);
+    uint64_t mask = count == kBitsPerWord ? ~uint64_t{0}
+                                          : ((uint64_t{1} << count) - 1) << bit;
+    if ((received_[WordIndex(index)] & mask) == mask) {
+      // Without losses, all packets to the end of the word are received, and
+      // only their arrival times need to be compared.
+      const int32_t* offsets = &arrival_time_offsets_us_[index];
+      const int32_t* newer =
+          std::find_if(offsets, offsets + count, [&](int32_t offset_us) {
+            return offset_us > limit_offset_us;
+          });
+      begin += newer - offsets;
+      if (newer != offsets + count) {
+        break;
+      }
+    } else if (!IsReceived(index)) {
+      // Packets that are not received are removed as well.
+      begin = NextReceived(begin, check_to);
+    } else if (ArrivalTime(index) <= arrival_time_limit) {
+      ++begin;
+    } else {
+      break;
+    }
   }
+  begin_sequence_number_ = begin;
   AdjustToSize(end_sequence_number_ - begin_sequence_number_);
 }
 
@@ -147,17 +250,24 @@ void PacketArrivalTimeMap::Reallocate(int new_capacity) {
   int new_capacity_minus_1 = new_capacity - 1;
   // Check capacity is a power of 2.
   RTC_DCHECK_EQ(new_capacity & new_capacity_minus_1, 0);
-  // Create uninitialized memory.
-  // All valid entries should be set by `AddPacket` before use.
-  void* raw = operator new[](new_capacity * sizeof(Timestamp));
-  Timestamp* new_buffer = static_cast<Timestamp*>(raw);
+  // Both buffers start out with no packets received.
+  std::unique_ptr<int32_t[]> new_offsets(new int32_t[new_capacity]);
+  std::fill_n(new_offsets.get(), new_capacity, kNotReceived);
+  std::unique_ptr<uint64_t[]> new_received(
+      new uint64_t[new_capacity / kBitsPerWord]());
 
-  for (int64_t sequence_number = begin_sequence_number_;
-       sequence_number < end_sequence_number_; ++sequence_number) {
-    new_buffer[sequence_number & new_capacity_minus_1] =
-        arrival_times_[sequence_number & capacity_minus_1_];
+  for (int64_t sequence_number = NextReceived(begin_sequence_number_,
+                                              end_sequence_number_);
+       sequence_number < end_sequence_number_;
+       sequence_number =
+           NextReceived(sequence_number + 1, end_sequence_number_)) {
+    int new_index = sequence_number & new_capacity_minus_1;
+    new_offsets[new_index] =
+        arrival_time_offsets_us_[sequence_number & capacity_minus_1_];
+    new_received[WordIndex(new_index)] |= uint64_t{1} << BitIndex(new_index);
   }
-  arrival_times_.reset(new_buffer);
+  arrival_time_offsets_us_ = std::move(new_offsets);
+  received_ = std::move(new_received);
   capacity_minus_1_ = new_capacity_minus_1;
 }
 
@@ -13,6 +13,7 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <memory>
 
 #include "api/units/timestamp.h"
@@ -25,10 +26,16 @@ namespace webrtc {
 // needed, and remove old packets, and will expand to allow earlier packets to
 // be added (out-of-order).
 //
-// Not yet received packets have the arrival time zero. The queue will not span
-// larger than necessary and the last packet should always be received. The
-// first packet in the queue doesn't have to be received in case of receiving
-// packets out-of-order.
+// Not yet received packets have the arrival time minus infinity. The queue will
+// not span larger than necessary and the last packet should always be
+// received. The first packet in the queue doesn't have to be received in case
+// of receiving packets out-of-order.
+//
+// The arrival times are stored as 32 bit microsecond offsets from a common base
+// time, with a reserved offset for packets that are not received, so that a
+// run of received packets is read like a plain array. A bit mask of which
+// packets have been received is kept next to it, so that runs of lost packets
+// can be skipped a word at a time.
 class PacketArrivalTimeMap {
  public:
   struct PacketArrivalTime {
@@ -48,7 +55,7 @@ class PacketArrivalTimeMap {
   bool has_received(int64_t sequence_number) const {
     return sequence_number >= begin_sequence_number() &&
            sequence_number < end_sequence_number() &&
-           arrival_times_[Index(sequence_number)] >= Timestamp::Zero();
+           IsReceived(Index(sequence_number));
   }
 
   // Returns the sequence number of the first entry in the map, i.e. the
@@ -64,7 +71,8 @@ class PacketArrivalTimeMap {
   Timestamp get(int64_t sequence_number) {
     RTC_DCHECK_GE(sequence_number, begin_sequence_number());
     RTC_DCHECK_LT(sequence_number, end_sequence_number());
-    return arrival_times_[Index(sequence_number)];
+    int index = Index(sequence_number);
+    return IsReceived(index) ? ArrivalTime(index) : Timestamp::MinusInfinity();
   }
 
   // Returns timestamp and sequence number of the received packet with sequence
@@ -73,13 +81,12 @@ class PacketArrivalTimeMap {
   PacketArrivalTime FindNextAtOrAfter(int64_t sequence_number) const {
     RTC_DCHECK_GE(sequence_number, begin_sequence_number());
     RTC_DCHECK_LT(sequence_number, end_sequence_number());
-    while (true) {
-      Timestamp t = arrival_times_[Index(sequence_number)];
-      if (t >= Timestamp::Zero()) {
-        return {.arrival_time = t, .sequence_number = sequence_number};
-      }
-      ++sequence_number;
+    int index = Index(sequence_number);
+    if (IsReceived(index)) {
+      return {.arrival_time = ArrivalTime(index),
+              .sequence_number = sequence_number};
     }
+    return FindNextReceived(sequence_number);
   }
 
   // Clamps `sequence_number` between [begin_sequence_number,
@@ -102,8 +109,15 @@ class PacketArrivalTimeMap {
 
  private:
   static constexpr int kMinCapacity = 128;
-
-  // Returns index in the `arrival_times_` for value for `sequence_number`.
+  static constexpr int kBitsPerWord = 64;
+  // Offset of packets that are not received. Arrival times are rebased before
+  // they would need it.
+  static constexpr int32_t kNotReceived = std::numeric_limits<int32_t>::min();
+  static_assert(kMinCapacity % kBitsPerWord == 0,
+                "Words of the bit mask must not wrap around the buffer.");
+
+  // Returns index in the `arrival_time_offsets_us_` and `received_` for value
+  // for `sequence_number`.
   int Index(int64_t sequence_number) const {
     // Note that sequence_number might be negative, thus taking '%' requires
     // extra handling and can be slow. Because capacity is a power of two, it
@@ -111,29 +125,67 @@ class PacketArrivalTimeMap {
     return sequence_number & capacity_minus_1_;
   }
 
+  // Position of the bit of buffer `index` in `received_`. The index is never
+  // negative, which lets the division be a shift.
+  static int WordIndex(int index) {
+    return static_cast<unsigned>(index) / kBitsPerWord;
+  }
+  static int BitIndex(int index) {
+    return static_cast<unsigned>(index) % kBitsPerWord;
+  }
+
+  bool IsReceived(int index) const {
+    return arrival_time_offsets_us_[index] != kNotReceived;
+  }
+
+  // Returns the arrival time of a received packet.
+  Timestamp ArrivalTime(int index) const {
+    return Timestamp::Micros(base_arrival_time_us_ +
+                             arrival_time_offsets_us_[index]);
+  }
+
+  // Returns the first received sequence number in range
+  // [`sequence_number`, `end_sequence_number_exclusive`), or
+  // `end_sequence_number_exclusive` if there is none.
+  int64_t NextReceived(int64_t sequence_number,
+                       int64_t end_sequence_number_exclusive) const;
+
+  // Slow path of `FindNextAtOrAfter`, when `sequence_number` is not received.
+  PacketArrivalTime FindNextReceived(int64_t sequence_number) const;
+
+  void SetReceived(int64_t sequence_number, Timestamp arrival_time);
   void SetNotReceived(int64_t begin_sequence_number_inclusive,
                       int64_t end_sequence_number_exclusive);
 
+  // Moves the base of the arrival time offsets to `base_arrival_time_us`.
+  // Received packets with arrival times that can't be represented relative to
+  // the new base are forgotten.
+  void Rebase(int64_t base_arrival_time_us);
+
   // Adjust capacity to match new_size, may reduce capacity.
   // On return guarantees capacity >= new_size.
   void AdjustToSize(int new_size);
   void Reallocate(int new_capacity);
 
   int capacity() const { return capacity_minus_1_ + 1; }
-  bool has_seen_packet() const { return arrival_times_ != nullptr; }
+  bool has_seen_packet() const { return received_ != nullptr; }
 
-  // Circular buffer. Packet with sequence number `sequence_number`
-  // is stored in the slot `sequence_number % capacity_`
-  std::unique_ptr<Timestamp[]> arrival_times_ = nullptr;
+  // Circular buffers. Packet with sequence number `sequence_number`
+  // is stored in the slot `sequence_number % capacity_`, as a bit in
+  // `received_` and as the offset of its arrival time from
+  // `base_arrival_time_us_`, or `kNotReceived`, in `arrival_time_offsets_us_`.
+  std::unique_ptr<uint64_t[]> received_ = nullptr;
+  std::unique_ptr<int32_t[]> arrival_time_offsets_us_ = nullptr;
+  int64_t base_arrival_time_us_ = 0;
 
-  // Allocated size of the `arrival_times_`
+  // Allocated size of the buffers, in packets.
   // capacity_ is a power of 2 in range [kMinCapacity, kMaxNumberOfPackets]
   // `capacity - 1` is used much more often than `capacity`, thus that value is
   // stored.
   int capacity_minus_1_ = -1;
 
   // The unwrapped sequence number for valid range of sequence numbers.
-  // arrival_times_ entries only valid for sequence numbers in range
+  // Buffer entries only valid for sequence numbers in range
   // `begin_sequence_number_ <= sequence_number < end_sequence_number_`
   int64_t begin_sequence_number_ = 0;
   int64_t end_sequence_number_ = 0;
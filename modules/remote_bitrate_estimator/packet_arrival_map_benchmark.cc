@@ -0,0 +1,136 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdint.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "benchmark/benchmark.h"
+#include "modules/remote_bitrate_estimator/packet_arrival_map.h"
+#include "modules/remote_bitrate_estimator/remote_estimator_proxy.h"
+#include "modules/rtp_rtcp/include/rtp_header_extension_map.h"
+#include "modules/rtp_rtcp/source/rtcp_packet.h"
+#include "modules/rtp_rtcp/source/rtp_header_extensions.h"
+#include "modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "rtc_base/system/unused.h"
+
+namespace webrtc {
+namespace {
+
+// A stream of 10k packets per second, with feedback about every 100 ms. A
+// whole number of feedback intervals fit in the range of transport sequence
+// numbers, so that the packets can be reused once they wrap. Every 20th packet
+// is reordered, arriving after the `kReorderDistance` packets that follow it.
+constexpr TimeDelta kPacketInterval = TimeDelta::Micros(100);
+constexpr int kPacketsPerFeedback = 1024;
+constexpr int kReorderInterval = 20;
+constexpr int kReorderDistance = 3;
+constexpr TimeDelta kBackWindow = TimeDelta::Millis(500);
+// Bursts of `state.range(0)` lost packets start every `kLossBurstInterval`
+// packets.
+constexpr int kLossBurstInterval = 200;
+
+// Returns the sequence numbers in the order they are received, for one
+// feedback interval.
+std::vector<int> ArrivalOrder() {
+  std::vector<int> order;
+  for (int i = 0; i < kPacketsPerFeedback; ++i) {
+    order.push_back(i);
+  }
+  for (int i = 0; i + kReorderDistance < kPacketsPerFeedback;
+       i += kReorderInterval) {
+    for (int j = 0; j < kReorderDistance; ++j) {
+      std::swap(order[i + j], order[i + j + 1]);
+    }
+  }
+  return order;
+}
+
+// Adds the packets of a feedback interval, walks the received ones like
+// building a feedback packet does and then drops the packets that are too
+// old to be reported again.
+void BM_PacketArrivalTimeMap(benchmark::State& state) {
+  const int loss_burst_length = state.range(0);
+  std::vector<int> order;
+  for (int seq : ArrivalOrder()) {
+    if (seq % kLossBurstInterval >= loss_burst_length) {
+      order.push_back(seq);
+    }
+  }
+  PacketArrivalTimeMap map;
+  int64_t feedback_start = 0;
+  Timestamp now = Timestamp::Seconds(1);
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    for (int seq : order) {
+      now += kPacketInterval;
+      map.AddPacket(feedback_start + seq, now);
+    }
+    int64_t received_packets = 0;
+    for (int64_t seq = map.clamp(feedback_start);
+         seq < map.end_sequence_number(); ++seq) {
+      PacketArrivalTimeMap::PacketArrivalTime packet =
+          map.FindNextAtOrAfter(seq);
+      seq = packet.sequence_number;
+      ++received_packets;
+    }
+    benchmark::DoNotOptimize(received_packets);
+    feedback_start += kPacketsPerFeedback;
+    map.RemoveOldPackets(feedback_start, now - kBackWindow);
+  }
+  state.SetItemsProcessed(state.iterations() * kPacketsPerFeedback);
+}
+
+// The same stream through RemoteEstimatorProxy, including parsing the
+// transport sequence numbers and building the feedback packets.
+void BM_RemoteEstimatorProxy(benchmark::State& state) {
+  const std::vector<int> order = ArrivalOrder();
+  RtpHeaderExtensionMap extensions;
+  extensions.Register<TransportSequenceNumber>(1);
+  std::vector<RtpPacketReceived> packets;
+  for (int i = 0; i < (1 << 16); ++i) {
+    RtpPacketReceived& packet = packets.emplace_back(&extensions);
+    packet.SetSsrc(1234);
+    packet.SetExtension<TransportSequenceNumber>(
+        (i / kPacketsPerFeedback) * kPacketsPerFeedback +
+        order[i % kPacketsPerFeedback]);
+  }
+  int64_t feedback_packets = 0;
+  RemoteEstimatorProxy proxy(
+      [&](std::vector<std::unique_ptr<rtcp::RtcpPacket>> feedback) {
+        feedback_packets += feedback.size();
+      },
+      /*network_state_estimator=*/nullptr);
+  size_t next_packet = 0;
+  Timestamp now = Timestamp::Seconds(1);
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    for (int i = 0; i < kPacketsPerFeedback; ++i) {
+      now += kPacketInterval;
+      RtpPacketReceived& packet = packets[next_packet];
+      next_packet = (next_packet + 1) % packets.size();
+      packet.set_arrival_time(now);
+      proxy.IncomingPacket(packet);
+    }
+    proxy.Process(now);
+  }
+  benchmark::DoNotOptimize(feedback_packets);
+  state.SetItemsProcessed(state.iterations() * kPacketsPerFeedback);
+}
+
+BENCHMARK(BM_PacketArrivalTimeMap)->Arg(0)->Arg(10);
+BENCHMARK(BM_RemoteEstimatorProxy);
+
+}  // namespace
+}  // namespace webrtc
@@ -268,5 +268,57 @@ TEST(PacketArrivalMapTest, EraseToMissingSequenceNumber) {
   EXPECT_TRUE(map.has_received(42));
 }
 
+TEST(PacketArrivalMapTest, FindsNextReceivedAcrossLongGapsAndWrapAround) {
+  PacketArrivalTimeMap map;
+
+  // 300 packets span the buffer several 64 packet words and wrap around it.
+  map.AddPacket(100, Timestamp::Millis(10));
+  map.AddPacket(300, Timestamp::Millis(20));
+  map.AddPacket(399, Timestamp::Millis(30));
+
+  PacketArrivalTimeMap::PacketArrivalTime packet = map.FindNextAtOrAfter(101);
+  EXPECT_EQ(packet.sequence_number, 300);
+  EXPECT_EQ(packet.arrival_time, Timestamp::Millis(20));
+  packet = map.FindNextAtOrAfter(301);
+  EXPECT_EQ(packet.sequence_number, 399);
+  EXPECT_EQ(packet.arrival_time, Timestamp::Millis(30));
+}
+
+TEST(PacketArrivalMapTest, KeepsArrivalTimesFarFromTheFirst) {
+  PacketArrivalTimeMap map;
+
+  map.AddPacket(42, Timestamp::Seconds(1));
+  map.AddPacket(43, Timestamp::Seconds(1000));
+  map.AddPacket(44, Timestamp::Seconds(3000));
+  map.AddPacket(41, Timestamp::Seconds(2000));
+
+  EXPECT_EQ(map.get(41), Timestamp::Seconds(2000));
+  EXPECT_EQ(map.get(43), Timestamp::Seconds(1000));
+  EXPECT_EQ(map.get(44), Timestamp::Seconds(3000));
+  // Packets more than half an hour older than a newly received one are
+  // forgotten.
+  EXPECT_FALSE(map.has_received(42));
+}
+
+TEST(PacketArrivalMapTest, RemovesOldPacketsWithinRunOfReceivedPackets) {
+  PacketArrivalTimeMap map;
+
+  // 200 packets without loss, where packet 130 arrives after packet 131.
+  for (int64_t seq = 0; seq < 200; ++seq) {
+    map.AddPacket(seq, Timestamp::Millis(seq == 130 ? 132 : seq));
+  }
+
+  map.RemoveOldPackets(/*sequence_number=*/150,
+                       /*arrival_time_limit=*/Timestamp::Millis(131));
+  EXPECT_EQ(map.begin_sequence_number(), 130);
+  EXPECT_EQ(map.get(130), Timestamp::Millis(132));
+  EXPECT_EQ(map.get(131), Timestamp::Millis(131));
+
+  map.RemoveOldPackets(/*sequence_number=*/150,
+                       /*arrival_time_limit=*/Timestamp::PlusInfinity());
+  EXPECT_EQ(map.begin_sequence_number(), 150);
+  EXPECT_EQ(map.end_sequence_number(), 200);
+}
+
 }  // namespace
 }  // namespace webrtc
@@ -56,7 +56,9 @@ class ReceiveStatistics : public ReceiveStatisticsProvider,
  public:
   ~ReceiveStatistics() override = default;
 
-  // Returns a thread-safe instance of ReceiveStatistics.
+  // Returns a thread-safe instance of ReceiveStatistics. Packets may be
+  // delivered to `OnRtpPacket` from any thread, and never wait for threads
+  // reading stats or creating report blocks.
   // https://chromium.googlesource.com/chromium/src/+/lkgr/docs/threading_and_tasks.md#threading-lexicon
   static std::unique_ptr<ReceiveStatistics> Create(Clock* clock);
   // Returns a thread-compatible instance of ReceiveStatistics.
@@ -38,6 +38,7 @@ namespace webrtc {
 class RtpPacket;
 class RtpPacketToSend;
 namespace rtcp {
+class CongestionControlFeedback;
 class TransportFeedback;
 }
 
@@ -163,6 +164,11 @@ class NetworkLinkRtcpObserver {
 
   virtual void OnTransportFeedback(Timestamp receive_time,
                                    const rtcp::TransportFeedback& feedback) {}
+  // Called on RFC 8888 feedback about the packets of the media sources of
+  // this module, or of other modules on the same transport.
+  virtual void OnCongestionControlFeedback(
+      Timestamp receive_time,
+      const rtcp::CongestionControlFeedback& feedback) {}
   virtual void OnReceiverEstimatedMaxBitrate(Timestamp receive_time,
                                              DataRate bitrate) {}
 
@@ -186,12 +192,18 @@ enum class RtpPacketMediaType : size_t {
 
 struct RtpPacketSendInfo {
   uint16_t transport_sequence_number = 0;
+  // The SSRC and RTP sequence number the packet is sent with, which RFC 8888
+  // congestion control feedback refers to the packet by.
+  uint32_t transport_ssrc = 0;
+  uint16_t transport_rtp_sequence_number = 0;
   absl::optional<uint32_t> media_ssrc;
   uint16_t rtp_sequence_number = 0;  // Only valid if `media_ssrc` is set.
   uint32_t rtp_timestamp = 0;
   size_t length = 0;
   absl::optional<RtpPacketMediaType> packet_type;
   PacedPacketInfo pacing_info;
+  // Whether the packet is sent on the secondary route of the transport.
+  bool on_secondary_route = false;
 };
 
 class NetworkStateEstimateObserver {
@@ -0,0 +1,123 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdint.h>
+
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "modules/include/module_fec_types.h"
+#include "modules/rtp_rtcp/include/flexfec_receiver.h"
+#include "modules/rtp_rtcp/include/recovered_packet_receiver.h"
+#include "modules/rtp_rtcp/source/fec_test_helper.h"
+#include "modules/rtp_rtcp/source/forward_error_correction.h"
+#include "modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/random.h"
+#include "rtc_base/system/unused.h"
+#include "system_wrappers/include/clock.h"
+
+namespace webrtc {
+namespace {
+
+using test::fec::AugmentedPacket;
+using test::fec::FlexfecPacketGenerator;
+
+constexpr uint32_t kFlexfecSsrc = 42984;
+constexpr uint32_t kMediaSsrc = 8353;
+constexpr size_t kPayloadLength = 1000;
+constexpr int kNumFrames = 64;
+constexpr double kLossProbability = 0.3;
+
+class CountingRecoveredPacketReceiver : public RecoveredPacketReceiver {
+ public:
+  void OnRecoveredPacket(const RtpPacketReceived& packet) override {
+    ++num_recovered_packets;
+  }
+
+  int64_t num_recovered_packets = 0;
+};
+
+RtpPacketReceived ParsePacket(const ForwardErrorCorrection::Packet& packet) {
+  RtpPacketReceived parsed_packet;
+  RTC_CHECK(parsed_packet.Parse(packet.data));
+  return parsed_packet;
+}
+
+// Returns the media and FlexFEC packets that arrive, in order, for frames of
+// `num_media_packets` packets protected by half as many FEC packets, when
+// both media and FEC packets are lost at random with `kLossProbability`.
+std::vector<RtpPacketReceived> CreateReceivedPackets(int num_media_packets) {
+  const int num_fec_packets = num_media_packets / 2;
+  std::unique_ptr<ForwardErrorCorrection> fec =
+      ForwardErrorCorrection::CreateFlexfec(kFlexfecSsrc, kMediaSsrc);
+  FlexfecPacketGenerator packet_generator(kMediaSsrc, kFlexfecSsrc);
+  Random random(0x5a7e);
+  std::vector<RtpPacketReceived> received_packets;
+  for (int frame = 0; frame < kNumFrames; ++frame) {
+    ForwardErrorCorrection::PacketList media_packets;
+    packet_generator.NewFrame(num_media_packets);
+    for (int i = 0; i < num_media_packets; ++i) {
+      media_packets.push_back(packet_generator.NextPacket(i, kPayloadLength));
+    }
+    std::list<ForwardErrorCorrection::Packet*> fec_packets;
+    RTC_CHECK_EQ(fec->EncodeFec(media_packets,
+                                num_fec_packets * 255 / num_media_packets,
+                                /*num_important_packets=*/0,
+                                /*use_unequal_protection=*/false,
+                                kFecMaskRandom, &fec_packets),
+                 0);
+    for (const auto& media_packet : media_packets) {
+      if (random.Rand<double>() >= kLossProbability) {
+        received_packets.push_back(ParsePacket(*media_packet));
+      }
+    }
+    for (const ForwardErrorCorrection::Packet* fec_packet : fec_packets) {
+      std::unique_ptr<AugmentedPacket> fec_packet_with_rtp_header =
+          packet_generator.BuildFlexfecPacket(*fec_packet);
+      if (random.Rand<double>() >= kLossProbability) {
+        received_packets.push_back(ParsePacket(*fec_packet_with_rtp_header));
+      }
+    }
+  }
+  return received_packets;
+}
+
+// Receives frames of `state.range(0)` media packets with 50% FlexFEC overhead
+// and 30% random loss, which keeps many FEC packets with several missing media
+// packets each stored in the decoder.
+void BM_FlexfecReceiver30PercentLoss(benchmark::State& state) {
+  const std::vector<RtpPacketReceived> received_packets =
+      CreateReceivedPackets(state.range(0));
+  CountingRecoveredPacketReceiver recovered_packet_receiver;
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    FlexfecReceiver receiver(Clock::GetRealTimeClock(), kFlexfecSsrc,
+                             kMediaSsrc, &recovered_packet_receiver);
+    for (const RtpPacketReceived& packet : received_packets) {
+      receiver.OnRtpPacket(packet);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * received_packets.size());
+  state.counters["recovered_per_frame"] =
+      static_cast<double>(recovered_packet_receiver.num_recovered_packets) /
+      (state.iterations() * kNumFrames);
+}
+
+BENCHMARK(BM_FlexfecReceiver30PercentLoss)
+    ->ArgName("media_packets")
+    ->Arg(12)
+    ->Arg(24)
+    ->Arg(48);
+
+}  // namespace
+}  // namespace webrtc
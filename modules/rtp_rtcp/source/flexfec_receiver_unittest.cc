@@ -11,12 +11,14 @@
 #include "modules/rtp_rtcp/include/flexfec_receiver.h"
 
 #include <algorithm>
+#include <map>
 #include <memory>
 
 #include "modules/rtp_rtcp/mocks/mock_recovered_packet_receiver.h"
 #include "modules/rtp_rtcp/source/fec_test_helper.h"
 #include "modules/rtp_rtcp/source/forward_error_correction.h"
 #include "modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "rtc_base/random.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
 
@@ -367,6 +369,71 @@ TEST_F(FlexfecReceiverTest, RecoversFrom50PercentLoss) {
   }
 }
 
+// Large FEC groups under heavy random loss keep many FEC packets with several
+// missing media packets each stored in the decoder, and every arriving packet
+// may unlock a chain of recoveries.
+TEST_F(FlexfecReceiverTest, RecoversFrom30PercentRandomLoss) {
+  class RecordingRecoveredPacketReceiver : public RecoveredPacketReceiver {
+   public:
+    void OnRecoveredPacket(const RtpPacketReceived& packet) override {
+      EXPECT_TRUE(packet.recovered());
+      EXPECT_TRUE(
+          recovered_.emplace(packet.SequenceNumber(), packet.Buffer()).second)
+          << "Packet " << packet.SequenceNumber() << " recovered twice.";
+    }
+
+    std::map<uint16_t, rtc::CopyOnWriteBuffer> recovered_;
+  } recording_recovered_packet_receiver;
+
+  FlexfecReceiver receiver(Clock::GetRealTimeClock(), kFlexfecSsrc, kMediaSsrc,
+                           &recording_recovered_packet_receiver);
+
+  const size_t kNumFrames = 200;
+  const size_t kNumMediaPacketsPerFrame = 24;
+  const size_t kNumFecPacketsPerFrame = 12;
+  const double kLossProbability = 0.3;
+
+  Random random(0x5a7e);
+  std::map<uint16_t, rtc::CopyOnWriteBuffer> lost_media_packets;
+  for (size_t frame = 0; frame < kNumFrames; ++frame) {
+    PacketList media_packets;
+    PacketizeFrame(kNumMediaPacketsPerFrame, 0, &media_packets);
+    std::list<Packet*> fec_packets =
+        EncodeFec(media_packets, kNumFecPacketsPerFrame);
+
+    for (const auto& media_packet : media_packets) {
+      RtpPacketReceived parsed_packet = ParsePacket(*media_packet);
+      if (random.Rand<double>() < kLossProbability) {
+        lost_media_packets.emplace(parsed_packet.SequenceNumber(),
+                                   media_packet->data);
+      } else {
+        receiver.OnRtpPacket(parsed_packet);
+      }
+    }
+    for (const auto* fec_packet : fec_packets) {
+      std::unique_ptr<Packet> fec_packet_with_rtp_header =
+          packet_generator_.BuildFlexfecPacket(*fec_packet);
+      if (random.Rand<double>() >= kLossProbability) {
+        receiver.OnRtpPacket(ParsePacket(*fec_packet_with_rtp_header));
+      }
+    }
+  }
+
+  // Every recovered packet must be a bit exact copy of a lost media packet.
+  for (const auto& [seq_num, buffer] :
+       recording_recovered_packet_receiver.recovered_) {
+    auto lost_it = lost_media_packets.find(seq_num);
+    ASSERT_NE(lost_it, lost_media_packets.end());
+    EXPECT_EQ(lost_it->second, buffer);
+  }
+  // With 50% FEC overhead most of the lost packets can be recovered.
+  EXPECT_GT(recording_recovered_packet_receiver.recovered_.size(),
+            lost_media_packets.size() / 2);
+  FecPacketCounter packet_counter = receiver.GetPacketCounter();
+  EXPECT_EQ(recording_recovered_packet_receiver.recovered_.size(),
+            packet_counter.num_recovered_packets);
+}
+
 TEST_F(FlexfecReceiverTest, DelayedFecPacketDoesHelp) {
   // These values need to be updated if the underlying erasure code
   // implementation changes.
@@ -343,6 +343,8 @@ void ForwardErrorCorrection::ResetState(
   // Free the memory for any existing recovered packets, if the caller hasn't.
   recovered_packets->clear();
   received_fec_packets_.clear();
+  covering_fec_packets_.clear();
+  recoverable_fec_packets_.clear();
 }
 
 void ForwardErrorCorrection::InsertMediaPacket(
@@ -350,13 +352,21 @@ void ForwardErrorCorrection::InsertMediaPacket(
     const ReceivedPacket& received_packet) {
   RTC_DCHECK_EQ(received_packet.ssrc, protected_media_ssrc_);
 
-  // Search for duplicate packets.
-  for (const auto& recovered_packet : *recovered_packets) {
-    RTC_DCHECK_EQ(recovered_packet->ssrc, received_packet.ssrc);
-    if (recovered_packet->seq_num == received_packet.seq_num) {
+  // Search for the insertion position, and for duplicate packets, starting
+  // from the back since media packets mostly arrive in order.
+  auto insert_it = recovered_packets->end();
+  SortablePacket::LessThan less_than;
+  while (insert_it != recovered_packets->begin()) {
+    const auto& prev_packet = *std::prev(insert_it);
+    RTC_DCHECK_EQ(prev_packet->ssrc, received_packet.ssrc);
+    if (prev_packet->seq_num == received_packet.seq_num) {
       // Duplicate packet, no need to add to list.
       return;
     }
+    if (less_than(prev_packet, &received_packet)) {
+      break;
+    }
+    --insert_it;
   }
 
   std::unique_ptr<RecoveredPacket> recovered_packet(new RecoveredPacket());
@@ -367,25 +377,27 @@ void ForwardErrorCorrection::InsertMediaPacket(
   recovered_packet->ssrc = received_packet.ssrc;
   recovered_packet->seq_num = received_packet.seq_num;
   recovered_packet->pkt = received_packet.pkt;
-  // TODO(holmer): Consider replacing this with a binary search for the right
-  // position, and then just insert the new packet. Would get rid of the sort.
   RecoveredPacket* recovered_packet_ptr = recovered_packet.get();
-  recovered_packets->push_back(std::move(recovered_packet));
-  recovered_packets->sort(SortablePacket::LessThan());
+  recovered_packets->insert(insert_it, std::move(recovered_packet));
   UpdateCoveringFecPackets(*recovered_packet_ptr);
 }
 
 void ForwardErrorCorrection::UpdateCoveringFecPackets(
     const RecoveredPacket& packet) {
-  for (auto& fec_packet : received_fec_packets_) {
-    // Is this FEC packet protecting the media packet `packet`?
-    auto protected_it = absl::c_lower_bound(
-        fec_packet->protected_packets, &packet, SortablePacket::LessThan());
-    if (protected_it != fec_packet->protected_packets.end() &&
-        (*protected_it)->seq_num == packet.seq_num) {
-      // Found an FEC packet which is protecting `packet`.
-      (*protected_it)->pkt = packet.pkt;
+  auto covering_it = covering_fec_packets_.find(packet.seq_num);
+  if (covering_it == covering_fec_packets_.end()) {
+    return;
+  }
+  for (const CoveringFecPacket& covering : covering_it->second) {
+    // Found an FEC packet which is protecting `packet`.
+    if (covering.protected_packet->pkt == nullptr) {
+      ReceivedFecPacket& fec_packet = **covering.fec_packet;
+      RTC_DCHECK_GT(fec_packet.num_packets_missing, 0);
+      if (--fec_packet.num_packets_missing <= 1) {
+        recoverable_fec_packets_.push_back(covering.fec_packet);
+      }
     }
+    covering.protected_packet->pkt = packet.pkt;
   }
 }
 
@@ -394,13 +406,21 @@ void ForwardErrorCorrection::InsertFecPacket(
     const ReceivedPacket& received_packet) {
   RTC_DCHECK_EQ(received_packet.ssrc, ssrc_);
 
-  // Check for duplicate.
-  for (const auto& existing_fec_packet : received_fec_packets_) {
-    RTC_DCHECK_EQ(existing_fec_packet->ssrc, received_packet.ssrc);
-    if (existing_fec_packet->seq_num == received_packet.seq_num) {
+  // Search for the insertion position, and for duplicates, starting from the
+  // back since FEC packets mostly arrive in order.
+  auto insert_it = received_fec_packets_.end();
+  SortablePacket::LessThan less_than;
+  while (insert_it != received_fec_packets_.begin()) {
+    const auto& prev_fec_packet = *std::prev(insert_it);
+    RTC_DCHECK_EQ(prev_fec_packet->ssrc, received_packet.ssrc);
+    if (prev_fec_packet->seq_num == received_packet.seq_num) {
       // Drop duplicate FEC packet data.
       return;
     }
+    if (less_than(prev_fec_packet, &received_packet)) {
+      break;
+    }
+    --insert_it;
   }
 
   std::unique_ptr<ReceivedFecPacket> fec_packet(new ReceivedFecPacket());
@@ -456,18 +476,53 @@ void ForwardErrorCorrection::InsertFecPacket(
     RTC_LOG(LS_WARNING) << "Received FEC packet has an all-zero packet mask.";
   } else {
     AssignRecoveredPackets(recovered_packets, fec_packet.get());
-    // TODO(holmer): Consider replacing this with a binary search for the right
-    // position, and then just insert the new packet. Would get rid of the sort.
-    received_fec_packets_.push_back(std::move(fec_packet));
-    received_fec_packets_.sort(SortablePacket::LessThan());
+    auto fec_packet_it =
+        received_fec_packets_.insert(insert_it, std::move(fec_packet));
+    ReceivedFecPacket& inserted_fec_packet = **fec_packet_it;
+    for (const auto& protected_packet : inserted_fec_packet.protected_packets) {
+      if (protected_packet->pkt == nullptr) {
+        ++inserted_fec_packet.num_packets_missing;
+      }
+      covering_fec_packets_[protected_packet->seq_num].push_back(
+          {.fec_packet = fec_packet_it,
+           .protected_packet = protected_packet.get()});
+    }
+    if (inserted_fec_packet.num_packets_missing <= 1) {
+      recoverable_fec_packets_.push_back(fec_packet_it);
+    }
     const size_t max_fec_packets = fec_header_reader_->MaxFecPackets();
     if (received_fec_packets_.size() > max_fec_packets) {
-      received_fec_packets_.pop_front();
+      EraseFecPacket(received_fec_packets_.begin());
     }
     RTC_DCHECK_LE(received_fec_packets_.size(), max_fec_packets);
   }
 }
 
+ForwardErrorCorrection::ReceivedFecPacketList::iterator
+ForwardErrorCorrection::EraseFecPacket(
+    ReceivedFecPacketList::iterator fec_packet_it) {
+  for (const auto& protected_packet : (*fec_packet_it)->protected_packets) {
+    auto covering_it = covering_fec_packets_.find(protected_packet->seq_num);
+    RTC_DCHECK(covering_it != covering_fec_packets_.end());
+    auto& covering_fec_packets = covering_it->second;
+    auto it = absl::c_find_if(covering_fec_packets,
+                              [&](const CoveringFecPacket& covering) {
+                                return covering.fec_packet == fec_packet_it;
+                              });
+    RTC_DCHECK(it != covering_fec_packets.end());
+    covering_fec_packets.erase(it);
+    if (covering_fec_packets.empty()) {
+      covering_fec_packets_.erase(covering_it);
+    }
+  }
+  // A FEC packet may have been queued more than once.
+  recoverable_fec_packets_.erase(
+      std::remove(recoverable_fec_packets_.begin(),
+                  recoverable_fec_packets_.end(), fec_packet_it),
+      recoverable_fec_packets_.end());
+  return received_fec_packets_.erase(fec_packet_it);
+}
+
 void ForwardErrorCorrection::AssignRecoveredPackets(
     const RecoveredPacketList& recovered_packets,
     ReceivedFecPacket* fec_packet) {
@@ -514,7 +569,7 @@ void ForwardErrorCorrection::InsertPacket(
     while (it != received_fec_packets_.end()) {
       uint16_t seq_num_diff = MinDiff(received_packet.seq_num, (*it)->seq_num);
       if (seq_num_diff > kOldSequenceThreshold) {
-        it = received_fec_packets_.erase(it);
+        it = EraseFecPacket(it);
       } else {
         // No need to keep iterating, since `received_fec_packets_` is sorted.
         break;
@@ -669,65 +724,51 @@ size_t ForwardErrorCorrection::AttemptRecovery(
     RecoveredPacketList* recovered_packets) {
   size_t num_recovered_packets = 0;
 
-  auto fec_packet_it = received_fec_packets_.begin();
-  while (fec_packet_it != received_fec_packets_.end()) {
-    // Search for each FEC packet's protected media packets.
-    int packets_missing = NumCoveredPacketsMissing(**fec_packet_it);
+  // Recovering a packet updates the FEC packets covering it, which may queue
+  // more FEC packets that can recover a packet.
+  while (!recoverable_fec_packets_.empty()) {
+    auto fec_packet_it = recoverable_fec_packets_.back();
+    recoverable_fec_packets_.pop_back();
 
     // We can only recover one packet with an FEC packet.
-    if (packets_missing == 1) {
+    if ((*fec_packet_it)->num_packets_missing == 1) {
       // Recovery possible.
       std::unique_ptr<RecoveredPacket> recovered_packet(new RecoveredPacket());
       recovered_packet->pkt = nullptr;
       if (!RecoverPacket(**fec_packet_it, recovered_packet.get())) {
         // Can't recover using this packet, drop it.
-        fec_packet_it = received_fec_packets_.erase(fec_packet_it);
+        EraseFecPacket(fec_packet_it);
         continue;
       }
 
       ++num_recovered_packets;
 
-      auto* recovered_packet_ptr = recovered_packet.get();
       // Add recovered packet to the list of recovered packets and update any
       // FEC packets covering this packet with a pointer to the data.
-      // TODO(holmer): Consider replacing this with a binary search for the
-      // right position, and then just insert the new packet. Would get rid of
-      // the sort.
-      recovered_packets->push_back(std::move(recovered_packet));
-      recovered_packets->sort(SortablePacket::LessThan());
+      auto insert_it = recovered_packets->end();
+      SortablePacket::LessThan less_than;
+      while (insert_it != recovered_packets->begin() &&
+             less_than(recovered_packet, *std::prev(insert_it))) {
+        --insert_it;
+      }
+      auto* recovered_packet_ptr = recovered_packet.get();
+      recovered_packets->insert(insert_it, std::move(recovered_packet));
       UpdateCoveringFecPackets(*recovered_packet_ptr);
       DiscardOldRecoveredPackets(recovered_packets);
-      fec_packet_it = received_fec_packets_.erase(fec_packet_it);
-
-      // A packet has been recovered. We need to check the FEC list again, as
-      // this may allow additional packets to be recovered.
-      // Restart for first FEC packet.
-      fec_packet_it = received_fec_packets_.begin();
-    } else if (packets_missing == 0 ||
-               IsOldFecPacket(**fec_packet_it, recovered_packets)) {
-      // Either all protected packets arrived or have been recovered, or the FEC
-      // packet is old. We can discard this FEC packet.
-      fec_packet_it = received_fec_packets_.erase(fec_packet_it);
-    } else {
-      fec_packet_it++;
     }
+    // All protected packets arrived or have been recovered. We can discard
+    // this FEC packet.
+    EraseFecPacket(fec_packet_it);
   }
 
-  return num_recovered_packets;
-}
-
-int ForwardErrorCorrection::NumCoveredPacketsMissing(
-    const ReceivedFecPacket& fec_packet) {
-  int packets_missing = 0;
-  for (const auto& protected_packet : fec_packet.protected_packets) {
-    if (protected_packet->pkt == nullptr) {
-      ++packets_missing;
-      if (packets_missing > 1) {
-        break;  // We can't recover more than one packet.
-      }
-    }
+  // Discard FEC packets that are old, and no longer relevant. FEC packets are
+  // sorted, so the old ones are at the front.
+  while (!received_fec_packets_.empty() &&
+         IsOldFecPacket(*received_fec_packets_.front(), recovered_packets)) {
+    EraseFecPacket(received_fec_packets_.begin());
   }
-  return packets_missing;
+
+  return num_recovered_packets;
 }
 
 void ForwardErrorCorrection::DiscardOldRecoveredPackets(
@@ -15,6 +15,7 @@
 #include <stdint.h>
 
 #include <list>
+#include <map>
 #include <memory>
 #include <vector>
 
@@ -148,6 +149,9 @@ class ForwardErrorCorrection {
     absl::InlinedVector<ProtectedStream, kInlinedSsrcsVectorSize>
         protected_streams;
     size_t protection_length;
+    // Number of entries in `protected_packets` which have not yet been
+    // received or recovered.
+    size_t num_packets_missing = 0;
     // Raw data.
     rtc::scoped_refptr<ForwardErrorCorrection::Packet> pkt;
   };
@@ -285,28 +289,35 @@ class ForwardErrorCorrection {
   void InsertPacket(const ReceivedPacket& received_packet,
                     RecoveredPacketList* recovered_packets);
 
-  // Inserts the `received_packet` into `recovered_packets`. Deletes duplicates.
+  // Inserts the `received_packet` into `recovered_packets`, at its sorted
+  // position. Deletes duplicates.
   void InsertMediaPacket(RecoveredPacketList* recovered_packets,
                          const ReceivedPacket& received_packet);
 
   // Assigns pointers to the recovered packet from all FEC packets which cover
-  // it.
-  // Note: This reduces the complexity when we want to try to recover a packet
-  // since we don't have to find the intersection between recovered packets and
-  // packets covered by the FEC packet.
+  // it, and updates their missing packet counts. The covering FEC packets are
+  // looked up through `covering_fec_packets_`, so the cost is proportional to
+  // the number of FEC packets protecting `packet`. FEC packets left with at
+  // most one missing packet are queued in `recoverable_fec_packets_`.
   void UpdateCoveringFecPackets(const RecoveredPacket& packet);
 
   // Insert `received_packet` into internal FEC list. Deletes duplicates.
   void InsertFecPacket(const RecoveredPacketList& recovered_packets,
                        const ReceivedPacket& received_packet);
 
+  // Removes the FEC packet at `fec_packet_it` from `received_fec_packets_`,
+  // `covering_fec_packets_` and `recoverable_fec_packets_`. Returns an
+  // iterator to the next FEC packet.
+  ReceivedFecPacketList::iterator EraseFecPacket(
+      ReceivedFecPacketList::iterator fec_packet_it);
+
   // Assigns pointers to already recovered packets covered by `fec_packet`.
   static void AssignRecoveredPackets(
       const RecoveredPacketList& recovered_packets,
       ReceivedFecPacket* fec_packet);
 
-  // Attempt to recover missing packets, using the internally stored
-  // received FEC packets.
+  // Attempt to recover missing packets, using the FEC packets queued in
+  // `recoverable_fec_packets_`.
   size_t AttemptRecovery(RecoveredPacketList* recovered_packets);
 
   // Initializes headers and payload before the XOR operation
@@ -336,12 +347,6 @@ class ForwardErrorCorrection {
   static bool RecoverPacket(const ReceivedFecPacket& fec_packet,
                             RecoveredPacket* recovered_packet);
 
-  // Get the number of missing media packets which are covered by `fec_packet`.
-  // An FEC packet can recover at most one packet, and if zero packets are
-  // missing the FEC packet can be discarded. This function returns 2 when two
-  // or more packets are missing.
-  static int NumCoveredPacketsMissing(const ReceivedFecPacket& fec_packet);
-
   // Discards old packets in `recovered_packets`, which are no longer relevant
   // for recovering lost packets.
   void DiscardOldRecoveredPackets(RecoveredPacketList* recovered_packets);
@@ -361,6 +366,20 @@ class ForwardErrorCorrection {
   std::vector<Packet> generated_fec_packets_;
   ReceivedFecPacketList received_fec_packets_;
 
+  // Protected packet entries of all FEC packets in `received_fec_packets_`,
+  // keyed by the media sequence number they protect. All protected packets
+  // belong to `protected_media_ssrc_`.
+  struct CoveringFecPacket {
+    ReceivedFecPacketList::iterator fec_packet;
+    ProtectedPacket* protected_packet;
+  };
+  std::map<uint16_t, absl::InlinedVector<CoveringFecPacket, 4>>
+      covering_fec_packets_;
+  // FEC packets in `received_fec_packets_` with at most one missing protected
+  // packet, which either recover it or are no longer needed. Only these are
+  // visited by `AttemptRecovery`.
+  std::vector<ReceivedFecPacketList::iterator> recoverable_fec_packets_;
+
   // Arrays used to avoid dynamically allocating memory when generating
   // the packet masks.
   // (There are never more than `kUlpfecMaxMediaPackets` FEC packets generated.)
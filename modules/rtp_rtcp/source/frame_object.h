@@ -37,7 +37,7 @@ class RtpFrameObject : public EncodedFrame {
                  const RTPVideoHeader& video_header,
                  const absl::optional<webrtc::ColorSpace>& color_space,
                  RtpPacketInfos packet_infos,
-                 rtc::scoped_refptr<EncodedImageBuffer> image_buffer);
+                 rtc::scoped_refptr<EncodedImageBufferInterface> image_buffer);
 
   ~RtpFrameObject() override;
   uint16_t first_seq_num() const;
@@ -62,7 +62,7 @@ class RtpFrameObject : public EncodedFrame {
 
  private:
   // Reference for mutable access.
-  rtc::scoped_refptr<EncodedImageBuffer> image_buffer_;
+  rtc::scoped_refptr<EncodedImageBufferInterface> image_buffer_;
   RTPVideoHeader rtp_video_header_;
   VideoCodecType codec_type_;
   uint16_t first_seq_num_;
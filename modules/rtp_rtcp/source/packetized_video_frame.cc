@@ -0,0 +1,172 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/rtp_rtcp/source/packetized_video_frame.h"
+
+#include <string.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "absl/types/variant.h"
+#include "api/video/video_codec_type.h"
+#include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "modules/rtp_rtcp/source/rtp_video_header.h"
+#include "rtc_base/buffer.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace {
+
+// Payload capacity of packet `index` out of `num_packets` of a frame.
+int PayloadCapacity(const RtpPacketizer::PayloadSizeLimits& limits,
+                    size_t index,
+                    size_t num_packets) {
+  if (num_packets == 1) {
+    return limits.max_payload_len - limits.single_packet_reduction_len;
+  }
+  if (index == 0) {
+    return limits.max_payload_len - limits.first_packet_reduction_len;
+  }
+  if (index == num_packets - 1) {
+    return limits.max_payload_len - limits.last_packet_reduction_len;
+  }
+  return limits.max_payload_len;
+}
+
+bool SameCodecHeader(const RTPVideoTypeHeader& a,
+                     const RTPVideoTypeHeader& b) {
+  if (a.index() != b.index()) {
+    return false;
+  }
+  if (const auto* vp8 = absl::get_if<RTPVideoHeaderVP8>(&a)) {
+    return *vp8 == absl::get<RTPVideoHeaderVP8>(b);
+  }
+  if (const auto* vp9 = absl::get_if<RTPVideoHeaderVP9>(&a)) {
+    return *vp9 == absl::get<RTPVideoHeaderVP9>(b);
+  }
+  if (const auto* h264 = absl::get_if<RTPVideoHeaderH264>(&a)) {
+    return *h264 == absl::get<RTPVideoHeaderH264>(b);
+  }
+  if (const auto* generic = absl::get_if<RTPVideoHeaderLegacyGeneric>(&a)) {
+    return generic->picture_id ==
+           absl::get<RTPVideoHeaderLegacyGeneric>(b).picture_id;
+  }
+  return true;
+}
+
+}  // namespace
+
+class PacketizedVideoFrame::RecordingPacketizer : public RtpPacketizer {
+ public:
+  RecordingPacketizer(std::unique_ptr<RtpPacketizer> packetizer,
+                      absl::optional<VideoCodecType> codec_type,
+                      const RTPVideoTypeHeader& codec_header,
+                      PacketizedVideoFrame& frame)
+      : packetizer_(std::move(packetizer)),
+        codec_type_(codec_type),
+        codec_header_(codec_header),
+        frame_(frame) {
+    packets_.reserve(packetizer_->NumPackets());
+  }
+
+  size_t NumPackets() const override { return packetizer_->NumPackets(); }
+
+  bool NextPacket(RtpPacketToSend* rtp_packet) override {
+    if (!packetizer_->NextPacket(rtp_packet)) {
+      return false;
+    }
+    // Copies the payload rather than sharing the buffer of `rtp_packet`, which
+    // would make the sender copy the whole packet when it writes to it later.
+    // Packetizers balance the payload sizes, so the first one is a good guess
+    // for the others.
+    if (payloads_.empty()) {
+      payloads_.EnsureCapacity(rtp_packet->payload_size() *
+                               (packetizer_->NumPackets() + 1));
+    }
+    payloads_.AppendData(rtp_packet->payload());
+    packets_.push_back({rtp_packet->payload_size(), rtp_packet->Marker()});
+    if (packetizer_->NumPackets() == 0) {
+      // Only complete frames are shared.
+      frame_.codec_type_ = codec_type_;
+      frame_.codec_header_ = codec_header_;
+      frame_.payloads_ = std::move(payloads_);
+      frame_.packets_ = std::move(packets_);
+    }
+    return true;
+  }
+
+ private:
+  const std::unique_ptr<RtpPacketizer> packetizer_;
+  const absl::optional<VideoCodecType> codec_type_;
+  const RTPVideoTypeHeader codec_header_;
+  PacketizedVideoFrame& frame_;
+  rtc::Buffer payloads_;
+  std::vector<Packet> packets_;
+};
+
+class PacketizedVideoFrame::ReplayingPacketizer : public RtpPacketizer {
+ public:
+  explicit ReplayingPacketizer(const PacketizedVideoFrame& frame)
+      : frame_(frame) {}
+
+  size_t NumPackets() const override {
+    return frame_.packets_.size() - next_packet_;
+  }
+
+  bool NextPacket(RtpPacketToSend* rtp_packet) override {
+    if (next_packet_ == frame_.packets_.size()) {
+      return false;
+    }
+    const Packet& packet = frame_.packets_[next_packet_++];
+    uint8_t* payload = rtp_packet->AllocatePayload(packet.payload_size);
+    RTC_CHECK(payload);
+    memcpy(payload, frame_.payloads_.data() + payload_offset_,
+           packet.payload_size);
+    payload_offset_ += packet.payload_size;
+    rtp_packet->SetMarker(packet.marker);
+    return true;
+  }
+
+ private:
+  const PacketizedVideoFrame& frame_;
+  size_t next_packet_ = 0;
+  size_t payload_offset_ = 0;
+};
+
+std::unique_ptr<RtpPacketizer> PacketizedVideoFrame::Record(
+    std::unique_ptr<RtpPacketizer> packetizer,
+    absl::optional<VideoCodecType> codec_type,
+    const RTPVideoTypeHeader& codec_header) {
+  RTC_DCHECK(empty());
+  return std::make_unique<RecordingPacketizer>(std::move(packetizer),
+                                               codec_type, codec_header, *this);
+}
+
+std::unique_ptr<RtpPacketizer> PacketizedVideoFrame::Replay(
+    const RtpPacketizer::PayloadSizeLimits& limits,
+    absl::optional<VideoCodecType> codec_type,
+    const RTPVideoTypeHeader& codec_header) const {
+  if (packets_.empty() || codec_type != codec_type_ ||
+      !SameCodecHeader(codec_header, codec_header_)) {
+    return nullptr;
+  }
+  for (size_t i = 0; i < packets_.size(); ++i) {
+    if (packets_[i].payload_size >
+        static_cast<size_t>(PayloadCapacity(limits, i, packets_.size()))) {
+      return nullptr;
+    }
+  }
+  return std::make_unique<ReplayingPacketizer>(*this);
+}
+
+}  // namespace webrtc
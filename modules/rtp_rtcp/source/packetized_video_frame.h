@@ -0,0 +1,84 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_RTP_RTCP_SOURCE_PACKETIZED_VIDEO_FRAME_H_
+#define MODULES_RTP_RTCP_SOURCE_PACKETIZED_VIDEO_FRAME_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "api/video/video_codec_type.h"
+#include "modules/rtp_rtcp/source/rtp_format.h"
+#include "modules/rtp_rtcp/source/rtp_video_header.h"
+#include "rtc_base/buffer.h"
+
+namespace webrtc {
+
+// RTP payloads of one video frame, packetized once and shared by all the
+// RTPSenderVideo instances that send that frame, e.g. when an SFU forwards a
+// stream to many receivers. The first sender copies its payloads into one
+// buffer as it packetizes the frame, so the other senders only build their
+// own RTP headers and copy the payloads into their packets. There is nothing
+// to share with a single sender, which should not use an instance at all.
+//
+// Not thread safe: the senders sharing an instance must use it sequentially.
+class PacketizedVideoFrame {
+ public:
+  PacketizedVideoFrame() = default;
+  PacketizedVideoFrame(const PacketizedVideoFrame&) = delete;
+  PacketizedVideoFrame& operator=(const PacketizedVideoFrame&) = delete;
+  ~PacketizedVideoFrame() = default;
+
+  bool empty() const { return packets_.empty(); }
+  size_t num_packets() const { return packets_.size(); }
+
+  // Returns a packetizer that forwards to `packetizer` and keeps the payloads
+  // it writes, once all of them have been written. `codec_type` is the
+  // packetization format, and `codec_header` the codec specific header the
+  // payload descriptors were written from. Must only be called while
+  // `empty()`.
+  std::unique_ptr<RtpPacketizer> Record(
+      std::unique_ptr<RtpPacketizer> packetizer,
+      absl::optional<VideoCodecType> codec_type,
+      const RTPVideoTypeHeader& codec_header);
+
+  // Returns a packetizer that writes the kept payloads if they fit into
+  // packets with `limits` and were made with the same packetization format and
+  // codec specific header, or nullptr if the caller has to packetize the frame
+  // itself. The codec specific header holds per sender state, such as the VP8
+  // and VP9 picture id and TL0PICIDX, so those frames are only shared between
+  // senders that agree on it, e.g. when the descriptor is minimized because a
+  // generic frame descriptor is sent along with it.
+  std::unique_ptr<RtpPacketizer> Replay(
+      const RtpPacketizer::PayloadSizeLimits& limits,
+      absl::optional<VideoCodecType> codec_type,
+      const RTPVideoTypeHeader& codec_header) const;
+
+ private:
+  struct Packet {
+    size_t payload_size;
+    bool marker;
+  };
+  class RecordingPacketizer;
+  class ReplayingPacketizer;
+
+  absl::optional<VideoCodecType> codec_type_;
+  RTPVideoTypeHeader codec_header_;
+  // The payloads of `packets_`, one after the other.
+  rtc::Buffer payloads_;
+  std::vector<Packet> packets_;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_RTP_RTCP_SOURCE_PACKETIZED_VIDEO_FRAME_H_
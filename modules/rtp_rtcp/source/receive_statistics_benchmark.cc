@@ -0,0 +1,94 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "modules/rtp_rtcp/include/receive_statistics.h"
+#include "modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/system/unused.h"
+#include "system_wrappers/include/clock.h"
+
+namespace webrtc {
+namespace {
+
+std::vector<RtpPacketReceived> CreatePackets(int num_streams) {
+  std::vector<RtpPacketReceived> packets(num_streams);
+  for (int i = 0; i < num_streams; ++i) {
+    packets[i].SetSsrc(1000 + i);
+    packets[i].SetSequenceNumber(0);
+    packets[i].SetPayloadSize(1000);
+    packets[i].set_payload_type_frequency(90'000);
+  }
+  return packets;
+}
+
+// Receives packets round robin on `state.range(0)` streams. When
+// `state.range(1)` is set, another thread polls stats and creates report
+// blocks for all the streams in a loop meanwhile.
+void BM_ReceiveStatisticsOnRtpPacket(benchmark::State& state) {
+  const int num_streams = state.range(0);
+  const bool poll_stats = state.range(1) != 0;
+  Clock* clock = Clock::GetRealTimeClock();
+  std::unique_ptr<ReceiveStatistics> statistics =
+      ReceiveStatistics::Create(clock);
+  std::vector<RtpPacketReceived> packets = CreatePackets(num_streams);
+  std::vector<uint32_t> ssrcs;
+  for (RtpPacketReceived& packet : packets) {
+    statistics->OnRtpPacket(packet);
+    ssrcs.push_back(packet.Ssrc());
+  }
+
+  std::atomic<bool> done(false);
+  std::atomic<int> num_polls(0);
+  rtc::PlatformThread poller;
+  if (poll_stats) {
+    poller = rtc::PlatformThread::SpawnJoinable(
+        [&] {
+          while (!done.load(std::memory_order_relaxed)) {
+            std::vector<rtcp::ReportBlock> blocks =
+                statistics->RtcpReportBlocks(num_streams);
+            benchmark::DoNotOptimize(blocks.data());
+            for (uint32_t ssrc : ssrcs) {
+              RtpReceiveStats stats =
+                  statistics->GetStatistician(ssrc)->GetStats();
+              benchmark::DoNotOptimize(stats);
+            }
+            num_polls.fetch_add(1, std::memory_order_relaxed);
+          }
+        },
+        "stats_poller");
+  }
+
+  size_t stream = 0;
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    RtpPacketReceived& packet = packets[stream];
+    packet.SetSequenceNumber(packet.SequenceNumber() + 1);
+    packet.SetTimestamp(packet.Timestamp() + 3000);
+    statistics->OnRtpPacket(packet);
+    if (++stream == packets.size()) {
+      stream = 0;
+    }
+  }
+  done = true;
+  poller.Finalize();
+  state.counters["polls"] = num_polls.load();
+}
+
+BENCHMARK(BM_ReceiveStatisticsOnRtpPacket)
+    ->ArgNames({"streams", "poll"})
+    ->ArgsProduct({{1, 4, 16}, {0, 1}});
+
+}  // namespace
+}  // namespace webrtc
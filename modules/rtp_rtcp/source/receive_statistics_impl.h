@@ -12,6 +12,7 @@
 #define MODULES_RTP_RTCP_SOURCE_RECEIVE_STATISTICS_IMPL_H_
 
 #include <algorithm>
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <utility>
@@ -25,7 +26,9 @@
 #include "rtc_base/bitrate_tracker.h"
 #include "rtc_base/containers/flat_map.h"
 #include "rtc_base/numerics/sequence_number_unwrapper.h"
+#include "rtc_base/race_checker.h"
 #include "rtc_base/synchronization/mutex.h"
+#include "rtc_base/synchronization/seq_lock.h"
 #include "rtc_base/thread_annotations.h"
 
 namespace webrtc {
@@ -44,6 +47,42 @@ class StreamStatisticianImplInterface : public StreamStatistician {
 // Thread-compatible implementation of StreamStatisticianImplInterface.
 class StreamStatisticianImpl : public StreamStatisticianImplInterface {
  public:
+  // State updated for every received packet. Trivially copyable, so that it can
+  // be published to other threads by StreamStatisticianConcurrent.
+  struct ReceiveState {
+    // Stats on received RTP packets.
+    uint32_t jitter_q4 = 0;
+    // Cumulative loss according to RFC 3550, which may be negative (and often
+    // is, if packets are reordered and there are non-RTX retransmissions).
+    int32_t cumulative_loss = 0;
+    absl::optional<Timestamp> last_receive_time;
+    uint32_t last_received_timestamp = 0;
+    int64_t received_seq_first = -1;
+    int64_t received_seq_max = -1;
+    // Number of times `received_seq_max` was set without counting loss, i.e.
+    // on the first packet and on stream restarts, and the value it was set to
+    // the last time. The next report block counts expected packets from there.
+    int num_seq_max_resets = 0;
+    int64_t reset_seq_max = -1;
+    // Current counter values.
+    StreamDataCounters receive_counters;
+    // The sample frequency of the last received packet.
+    int last_payload_type_frequency = 0;
+  };
+
+  // State updated when creating report blocks.
+  struct ReportState {
+    bool cumulative_loss_is_capped = false;
+    // Offset added to outgoing rtcp reports, to make ensure that the reported
+    // cumulative loss is non-negative. Reports with negative values confuse
+    // some senders, in particular, our own loss-based bandwidth estimator.
+    int32_t cumulative_loss_rtcp_offset = 0;
+    // Counter values when we sent the last report.
+    int32_t last_report_cumulative_loss = 0;
+    int64_t last_report_seq_max = -1;
+    int num_seq_max_resets = 0;
+  };
+
   StreamStatisticianImpl(uint32_t ssrc,
                          Clock* clock,
                          int max_reordering_threshold);
@@ -63,6 +102,26 @@ class StreamStatisticianImpl : public StreamStatisticianImplInterface {
   // Updates StreamStatistician for incoming packets.
   void UpdateCounters(const RtpPacketReceived& packet) override;
 
+  const ReceiveState& receive_state() const { return receive_state_; }
+  uint32_t BitrateReceived(Timestamp now) const;
+  TimeDelta delta_internal_unix_epoch() const {
+    return delta_internal_unix_epoch_;
+  }
+
+  // Computes the stats from `receive_state`, and appends a report block unless
+  // the stream is inactive, updating `report_state`. Shared with
+  // StreamStatisticianConcurrent, which reads published receive states.
+  static RtpReceiveStats GetStats(const ReceiveState& receive_state,
+                                  TimeDelta delta_internal_unix_epoch);
+  static absl::optional<int> GetFractionLostInPercent(
+      const ReceiveState& receive_state);
+  static void MaybeAppendReportBlock(
+      uint32_t ssrc,
+      const ReceiveState& receive_state,
+      Timestamp now,
+      ReportState& report_state,
+      std::vector<rtcp::ReportBlock>& report_blocks);
+
  private:
   bool IsRetransmitOfOldPacket(const RtpPacketReceived& packet,
                                Timestamp now) const;
@@ -74,7 +133,9 @@ class StreamStatisticianImpl : public StreamStatisticianImplInterface {
                         int64_t sequence_number,
                         Timestamp now);
   // Checks if this StreamStatistician received any rtp packets.
-  bool ReceivedRtpPacket() const { return last_receive_time_.has_value(); }
+  bool ReceivedRtpPacket() const {
+    return receive_state_.last_receive_time.has_value();
+  }
 
   const uint32_t ssrc_;
   Clock* const clock_;
@@ -84,84 +145,64 @@ class StreamStatisticianImpl : public StreamStatisticianImplInterface {
   // In number of packets or sequence numbers.
   int max_reordering_threshold_;
   bool enable_retransmit_detection_;
-  bool cumulative_loss_is_capped_;
-
-  // Stats on received RTP packets.
-  uint32_t jitter_q4_;
-  // Cumulative loss according to RFC 3550, which may be negative (and often is,
-  // if packets are reordered and there are non-RTX retransmissions).
-  int32_t cumulative_loss_;
-  // Offset added to outgoing rtcp reports, to make ensure that the reported
-  // cumulative loss is non-negative. Reports with negative values confuse some
-  // senders, in particular, our own loss-based bandwidth estimator.
-  int32_t cumulative_loss_rtcp_offset_;
-
-  absl::optional<Timestamp> last_receive_time_;
-  uint32_t last_received_timestamp_;
+
+  ReceiveState receive_state_;
+  ReportState report_state_;
   RtpSequenceNumberUnwrapper seq_unwrapper_;
-  int64_t received_seq_first_;
-  int64_t received_seq_max_;
   // Assume that the other side restarted when there are two sequential packets
-  // with large jump from received_seq_max_.
+  // with large jump from received_seq_max.
   absl::optional<uint16_t> received_seq_out_of_order_;
-
-  // Current counter values.
-  StreamDataCounters receive_counters_;
-
-  // Counter values when we sent the last report.
-  int32_t last_report_cumulative_loss_;
-  int64_t last_report_seq_max_;
-
-  // The sample frequency of the last received packet.
-  int last_payload_type_frequency_;
 };
 
-// Thread-safe implementation of StreamStatisticianImplInterface.
-class StreamStatisticianLocked : public StreamStatisticianImplInterface {
+// Thread-safe implementation of StreamStatisticianImplInterface. Calls to
+// `UpdateCounters` must be serialized, which ReceiveStatisticsConcurrent does,
+// but may come from any thread. `UpdateCounters` publishes the receive state
+// after every packet, so that stats and report blocks are read from any thread
+// without ever blocking packet processing.
+class StreamStatisticianConcurrent : public StreamStatisticianImplInterface {
  public:
-  StreamStatisticianLocked(uint32_t ssrc,
-                           Clock* clock,
-                           int max_reordering_threshold)
-      : impl_(ssrc, clock, max_reordering_threshold) {}
-  ~StreamStatisticianLocked() override = default;
-
-  RtpReceiveStats GetStats() const override {
-    MutexLock lock(&stream_lock_);
-    return impl_.GetStats();
-  }
-  absl::optional<int> GetFractionLostInPercent() const override {
-    MutexLock lock(&stream_lock_);
-    return impl_.GetFractionLostInPercent();
-  }
-  StreamDataCounters GetReceiveStreamDataCounters() const override {
-    MutexLock lock(&stream_lock_);
-    return impl_.GetReceiveStreamDataCounters();
-  }
-  uint32_t BitrateReceived() const override {
-    MutexLock lock(&stream_lock_);
-    return impl_.BitrateReceived();
-  }
+  StreamStatisticianConcurrent(uint32_t ssrc,
+                               Clock* clock,
+                               int max_reordering_threshold);
+  ~StreamStatisticianConcurrent() override;
+
+  RtpReceiveStats GetStats() const override;
+  absl::optional<int> GetFractionLostInPercent() const override;
+  StreamDataCounters GetReceiveStreamDataCounters() const override;
+  uint32_t BitrateReceived() const override;
   void MaybeAppendReportBlockAndReset(
-      std::vector<rtcp::ReportBlock>& report_blocks) override {
-    MutexLock lock(&stream_lock_);
-    impl_.MaybeAppendReportBlockAndReset(report_blocks);
-  }
-  void SetMaxReorderingThreshold(int max_reordering_threshold) override {
-    MutexLock lock(&stream_lock_);
-    return impl_.SetMaxReorderingThreshold(max_reordering_threshold);
-  }
-  void EnableRetransmitDetection(bool enable) override {
-    MutexLock lock(&stream_lock_);
-    return impl_.EnableRetransmitDetection(enable);
-  }
-  void UpdateCounters(const RtpPacketReceived& packet) override {
-    MutexLock lock(&stream_lock_);
-    return impl_.UpdateCounters(packet);
-  }
+      std::vector<rtcp::ReportBlock>& report_blocks) override;
+  void SetMaxReorderingThreshold(int max_reordering_threshold) override;
+  void EnableRetransmitDetection(bool enable) override;
+  void UpdateCounters(const RtpPacketReceived& packet) override;
 
  private:
-  mutable Mutex stream_lock_;
-  StreamStatisticianImpl impl_ RTC_GUARDED_BY(&stream_lock_);
+  struct Snapshot {
+    StreamStatisticianImpl::ReceiveState receive_state;
+    // Bitrate, refreshed at most every `kBitratePublishInterval` as packets
+    // are received.
+    uint32_t bitrate_bps = 0;
+  };
+
+  const uint32_t ssrc_;
+  Clock* const clock_;
+  const TimeDelta delta_internal_unix_epoch_;
+  // Configuration, applied to `impl_` when the next packet is received.
+  std::atomic<int> max_reordering_threshold_;
+  std::atomic<bool> enable_retransmit_detection_;
+
+  rtc::RaceChecker packet_race_checker_;
+  StreamStatisticianImpl impl_ RTC_GUARDED_BY(packet_race_checker_);
+  uint32_t bitrate_bps_ RTC_GUARDED_BY(packet_race_checker_) = 0;
+  Timestamp next_bitrate_update_ RTC_GUARDED_BY(packet_race_checker_) =
+      Timestamp::MinusInfinity();
+  // Single writer, since `UpdateCounters` calls are serialized.
+  SeqLock<Snapshot> snapshot_;
+
+  // Only held while creating report blocks, never while receiving packets.
+  Mutex report_lock_;
+  StreamStatisticianImpl::ReportState report_state_
+      RTC_GUARDED_BY(report_lock_);
 };
 
 // Thread-compatible implementation.
@@ -175,6 +216,12 @@ class ReceiveStatisticsImpl : public ReceiveStatistics {
           int max_reordering_threshold)> stream_statistician_factory);
   ~ReceiveStatisticsImpl() override = default;
 
+  StreamStatisticianImplInterface* GetOrCreateStatistician(uint32_t ssrc);
+  // Takes over a statistician for an ssrc that has none.
+  void AddStatistician(
+      uint32_t ssrc,
+      std::unique_ptr<StreamStatisticianImplInterface> statistician);
+
   // Implements ReceiveStatisticsProvider.
   std::vector<rtcp::ReportBlock> RtcpReportBlocks(size_t max_blocks) override;
 
@@ -189,8 +236,6 @@ class ReceiveStatisticsImpl : public ReceiveStatistics {
   void EnableRetransmitDetection(uint32_t ssrc, bool enable) override;
 
  private:
-  StreamStatisticianImplInterface* GetOrCreateStatistician(uint32_t ssrc);
-
   Clock* const clock_;
   std::function<std::unique_ptr<StreamStatisticianImplInterface>(
       uint32_t ssrc,
@@ -205,46 +250,45 @@ class ReceiveStatisticsImpl : public ReceiveStatistics {
       statisticians_;
 };
 
-// Thread-safe implementation wrapping access to ReceiveStatisticsImpl with a
-// mutex.
-class ReceiveStatisticsLocked : public ReceiveStatistics {
+// Thread-safe implementation. Packets may be delivered from any thread, and
+// are serialized by `packet_lock_`, which is the only lock taken on the packet
+// path. A statistician for a new ssrc is created there and handed over to
+// `impl_` when `receive_statistics_lock_` is next taken. Combined with
+// StreamStatisticianConcurrent, reading stats and creating report blocks
+// never blocks packet processing.
+class ReceiveStatisticsConcurrent : public ReceiveStatistics {
  public:
-  explicit ReceiveStatisticsLocked(
-      Clock* clock,
-      std::function<std::unique_ptr<StreamStatisticianImplInterface>(
-          uint32_t ssrc,
-          Clock* clock,
-          int max_reordering_threshold)> stream_statitician_factory)
-      : impl_(clock, std::move(stream_statitician_factory)) {}
-  ~ReceiveStatisticsLocked() override = default;
-  std::vector<rtcp::ReportBlock> RtcpReportBlocks(size_t max_blocks) override {
-    MutexLock lock(&receive_statistics_lock_);
-    return impl_.RtcpReportBlocks(max_blocks);
-  }
-  void OnRtpPacket(const RtpPacketReceived& packet) override {
-    MutexLock lock(&receive_statistics_lock_);
-    return impl_.OnRtpPacket(packet);
-  }
-  StreamStatistician* GetStatistician(uint32_t ssrc) const override {
-    MutexLock lock(&receive_statistics_lock_);
-    return impl_.GetStatistician(ssrc);
-  }
-  void SetMaxReorderingThreshold(int max_reordering_threshold) override {
-    MutexLock lock(&receive_statistics_lock_);
-    return impl_.SetMaxReorderingThreshold(max_reordering_threshold);
-  }
+  explicit ReceiveStatisticsConcurrent(Clock* clock);
+  ~ReceiveStatisticsConcurrent() override;
+
+  std::vector<rtcp::ReportBlock> RtcpReportBlocks(size_t max_blocks) override;
+  void OnRtpPacket(const RtpPacketReceived& packet) override;
+  StreamStatistician* GetStatistician(uint32_t ssrc) const override;
+  void SetMaxReorderingThreshold(int max_reordering_threshold) override;
   void SetMaxReorderingThreshold(uint32_t ssrc,
-                                 int max_reordering_threshold) override {
-    MutexLock lock(&receive_statistics_lock_);
-    return impl_.SetMaxReorderingThreshold(ssrc, max_reordering_threshold);
-  }
-  void EnableRetransmitDetection(uint32_t ssrc, bool enable) override {
-    MutexLock lock(&receive_statistics_lock_);
-    return impl_.EnableRetransmitDetection(ssrc, enable);
-  }
+                                 int max_reordering_threshold) override;
+  void EnableRetransmitDetection(uint32_t ssrc, bool enable) override;
 
  private:
-  mutable Mutex receive_statistics_lock_;
+  // Hands the statisticians created by OnRtpPacket() over to `impl_`.
+  void AddNewStatisticians()
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(receive_statistics_lock_, packet_lock_);
+  StreamStatisticianImplInterface* GetOrCreateStatistician(uint32_t ssrc)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(receive_statistics_lock_);
+
+  Clock* const clock_;
+
+  // Acquired after `receive_statistics_lock_` when both are held.
+  mutable Mutex packet_lock_;
+  // All statisticians, owned by `impl_` or `new_statisticians_`.
+  flat_map<uint32_t /*ssrc*/, StreamStatisticianImplInterface*>
+      packet_statisticians_ RTC_GUARDED_BY(packet_lock_);
+  std::vector<
+      std::pair<uint32_t, std::unique_ptr<StreamStatisticianImplInterface>>>
+      new_statisticians_ RTC_GUARDED_BY(packet_lock_);
+  int max_reordering_threshold_ RTC_GUARDED_BY(packet_lock_);
+
+  Mutex receive_statistics_lock_;
   ReceiveStatisticsImpl impl_ RTC_GUARDED_BY(&receive_statistics_lock_);
 };
 
@@ -10,12 +10,14 @@
 
 #include "modules/rtp_rtcp/include/receive_statistics.h"
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <vector>
 
 #include "api/units/time_delta.h"
 #include "modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "rtc_base/platform_thread.h"
 #include "rtc_base/random.h"
 #include "system_wrappers/include/clock.h"
 #include "test/gmock.h"
@@ -631,6 +633,93 @@ TEST_P(ReceiveStatisticsTest, SimpleJitterComputation) {
             statistician->GetStats().interarrival_jitter);
 }
 
+TEST(ReceiveStatisticsConcurrencyTest, ReadsStatsWhilePacketsAreReceived) {
+  constexpr int kNumPackets = 10'000;
+  SimulatedClock clock(0);
+  std::unique_ptr<ReceiveStatistics> statistics =
+      ReceiveStatistics::Create(&clock);
+  RtpPacketReceived packet1 = CreateRtpPacket(kSsrc1, kPacketSize1);
+  RtpPacketReceived packet2 = CreateRtpPacket(kSsrc2, kPacketSize2);
+  statistics->OnRtpPacket(packet1);
+  statistics->OnRtpPacket(packet2);
+
+  std::atomic<bool> done(false);
+  rtc::PlatformThread reader = rtc::PlatformThread::SpawnJoinable(
+      [&] {
+        size_t last_packets = 0;
+        while (!done.load()) {
+          for (const rtcp::ReportBlock& block :
+               statistics->RtcpReportBlocks(/*max_blocks=*/2)) {
+            EXPECT_EQ(block.fraction_lost(), 0);
+            EXPECT_EQ(block.cumulative_lost(), 0u);
+          }
+          RtpReceiveStats stats =
+              statistics->GetStatistician(kSsrc1)->GetStats();
+          // Counters are published in a consistent state, and never go back.
+          EXPECT_EQ(stats.packet_counter.payload_bytes,
+                    stats.packet_counter.packets * (kPacketSize1 - 12));
+          EXPECT_GE(stats.packet_counter.packets, last_packets);
+          last_packets = stats.packet_counter.packets;
+        }
+      },
+      "reader");
+
+  for (int i = 1; i < kNumPackets; ++i) {
+    clock.AdvanceTimeMicroseconds(100);
+    IncrementSequenceNumber(&packet1);
+    IncrementSequenceNumber(&packet2);
+    statistics->OnRtpPacket(packet1);
+    statistics->OnRtpPacket(packet2);
+  }
+  done = true;
+  reader.Finalize();
+
+  EXPECT_EQ(statistics->GetStatistician(kSsrc1)
+                ->GetReceiveStreamDataCounters()
+                .transmitted.packets,
+            static_cast<size_t>(kNumPackets));
+  EXPECT_EQ(statistics->GetStatistician(kSsrc2)->GetStats().packets_lost, 0);
+}
+
+TEST(ReceiveStatisticsConcurrencyTest, ReceivesPacketsFromMultipleThreads) {
+  constexpr int kNumPackets = 10'000;
+  SimulatedClock clock(0);
+  std::unique_ptr<ReceiveStatistics> statistics =
+      ReceiveStatistics::Create(&clock);
+
+  auto receive_packets = [&](uint32_t ssrc, size_t packet_size) {
+    RtpPacketReceived packet = CreateRtpPacket(ssrc, packet_size);
+    for (int i = 0; i < kNumPackets; ++i) {
+      statistics->OnRtpPacket(packet);
+      IncrementSequenceNumber(&packet);
+    }
+  };
+  // Both threads deliver packets of the same two ssrcs, so that they race on
+  // creating the statisticians as well as on updating them.
+  rtc::PlatformThread thread1 = rtc::PlatformThread::SpawnJoinable(
+      [&] {
+        receive_packets(kSsrc1, kPacketSize1);
+        receive_packets(kSsrc2, kPacketSize2);
+      },
+      "thread1");
+  rtc::PlatformThread thread2 = rtc::PlatformThread::SpawnJoinable(
+      [&] {
+        receive_packets(kSsrc2, kPacketSize2);
+        receive_packets(kSsrc1, kPacketSize1);
+      },
+      "thread2");
+  thread1.Finalize();
+  thread2.Finalize();
+
+  // Every packet is received twice, from either thread.
+  for (uint32_t ssrc : {kSsrc1, kSsrc2}) {
+    StreamDataCounters counters =
+        statistics->GetStatistician(ssrc)->GetReceiveStreamDataCounters();
+    EXPECT_EQ(counters.transmitted.packets,
+              static_cast<size_t>(2 * kNumPackets));
+  }
+}
+
 TEST(ReviseJitterTest, AllPacketsHaveSamePayloadTypeFrequency) {
   SimulatedClock clock(0);
   std::unique_ptr<ReceiveStatistics> statistics =
@@ -0,0 +1,230 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/rtp_rtcp/source/rtcp_packet/congestion_control_feedback.h"
+
+#include <string.h>
+
+#include <utility>
+
+#include "modules/rtp_rtcp/source/byte_io.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/common_header.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+
+namespace webrtc {
+namespace rtcp {
+constexpr uint8_t CongestionControlFeedback::kFeedbackMessageType;
+// RFC 8888: RTP Control Protocol (RTCP) Feedback for Congestion Control.
+//
+//   0                   1                   2                   3
+//   0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+//  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//  |V=2|P| FMT=11  |   PT = 205    |          length               |
+//  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//  |                 SSRC of RTCP packet sender                    |
+//  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//  |                   SSRC of 1st RTP Stream                      |
+//  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//  |          begin_seq            |          num_reports          |
+//  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//  |R|ECN|  Arrival time offset    | ...                           .
+//  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//  .                                                               .
+//  .                                                               .
+//  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//  |                   SSRC of nth RTP Stream                      |
+//  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//  |          begin_seq            |          num_reports          |
+//  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//  |R|ECN|  Arrival time offset    | ...                           |
+//  .                                                               .
+//  .                                                               .
+//  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//  |                 Report Timestamp (32 bits)                    |
+//  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//
+// The reports of each SSRC are padded with a zero report to a multiple of 4
+// bytes. The arrival time offset is in units of 1/1024 seconds.
+namespace {
+
+constexpr size_t kSenderSsrcLength = 4;
+constexpr size_t kReportTimestampLength = 4;
+constexpr size_t kBlockHeaderLength = 8;
+constexpr size_t kReportLength = 2;
+// RFC 8888, Section 3.1: a report block covers at most 16384 packets.
+constexpr int kMaxReportsPerBlock = 16384;
+constexpr uint16_t kMaxArrivalTimeOffset = 0x1FFE;
+constexpr uint16_t kUnavailableArrivalTimeOffset = 0x1FFF;
+
+size_t BlockSize(int num_reports) {
+  // Padded to 32 bits.
+  return kBlockHeaderLength + kReportLength * ((num_reports + 1) & ~1);
+}
+
+int NumReports(const CongestionControlFeedback::PacketInfo& first,
+               const CongestionControlFeedback::PacketInfo& last) {
+  return static_cast<uint16_t>(last.sequence_number - first.sequence_number) +
+         1;
+}
+
+uint16_t ToReport(const CongestionControlFeedback::PacketInfo& packet) {
+  if (!packet.received()) {
+    return 0;
+  }
+  uint16_t arrival_time_offset = kUnavailableArrivalTimeOffset;
+  if (packet.arrival_time_offset.IsFinite()) {
+    RTC_DCHECK_GE(packet.arrival_time_offset, TimeDelta::Zero());
+    const int64_t units =
+        (packet.arrival_time_offset.us() * 1024 + 500'000) / 1'000'000;
+    arrival_time_offset =
+        units < kMaxArrivalTimeOffset ? units : kMaxArrivalTimeOffset;
+  }
+  return 0x8000 | (static_cast<uint16_t>(packet.ecn) << 13) |
+         arrival_time_offset;
+}
+
+CongestionControlFeedback::PacketInfo FromReport(uint32_t ssrc,
+                                                 uint16_t sequence_number,
+                                                 uint16_t report) {
+  CongestionControlFeedback::PacketInfo packet;
+  packet.ssrc = ssrc;
+  packet.sequence_number = sequence_number;
+  if ((report & 0x8000) == 0) {
+    return packet;
+  }
+  packet.ecn = static_cast<EcnMarking>((report >> 13) & 0x03);
+  const uint16_t arrival_time_offset = report & 0x1FFF;
+  packet.arrival_time_offset =
+      arrival_time_offset == kUnavailableArrivalTimeOffset
+          ? TimeDelta::PlusInfinity()
+          : TimeDelta::Micros(int64_t{arrival_time_offset} * 1'000'000 / 1024);
+  return packet;
+}
+
+}  // namespace
+
+CongestionControlFeedback::CongestionControlFeedback() = default;
+
+CongestionControlFeedback::CongestionControlFeedback(
+    std::vector<PacketInfo> packets,
+    uint32_t report_timestamp_compact_ntp)
+    : packets_(std::move(packets)),
+      report_timestamp_compact_ntp_(report_timestamp_compact_ntp) {}
+
+CongestionControlFeedback::~CongestionControlFeedback() = default;
+
+bool CongestionControlFeedback::Parse(const CommonHeader& packet) {
+  RTC_DCHECK_EQ(packet.type(), kPacketType);
+  RTC_DCHECK_EQ(packet.fmt(), kFeedbackMessageType);
+
+  const size_t payload_size = packet.payload_size_bytes();
+  if (payload_size < kSenderSsrcLength + kReportTimestampLength) {
+    RTC_LOG(LS_WARNING) << "Payload length " << payload_size
+                        << " is too small for a congestion control feedback.";
+    return false;
+  }
+  const uint8_t* const payload = packet.payload();
+  SetSenderSsrc(ByteReader<uint32_t>::ReadBigEndian(payload));
+  const size_t blocks_end = payload_size - kReportTimestampLength;
+  report_timestamp_compact_ntp_ =
+      ByteReader<uint32_t>::ReadBigEndian(payload + blocks_end);
+
+  packets_.clear();
+  size_t index = kSenderSsrcLength;
+  while (index < blocks_end) {
+    if (index + kBlockHeaderLength > blocks_end) {
+      RTC_LOG(LS_WARNING) << "Truncated congestion control feedback block.";
+      return false;
+    }
+    const uint32_t ssrc = ByteReader<uint32_t>::ReadBigEndian(payload + index);
+    const uint16_t begin_seq =
+        ByteReader<uint16_t>::ReadBigEndian(payload + index + 4);
+    const int num_reports =
+        ByteReader<uint16_t>::ReadBigEndian(payload + index + 6);
+    if (num_reports > kMaxReportsPerBlock ||
+        index + BlockSize(num_reports) > blocks_end) {
+      RTC_LOG(LS_WARNING) << "Invalid number of reports " << num_reports
+                          << " in congestion control feedback.";
+      return false;
+    }
+    const uint8_t* reports = payload + index + kBlockHeaderLength;
+    for (int i = 0; i < num_reports; ++i) {
+      packets_.push_back(FromReport(
+          ssrc, static_cast<uint16_t>(begin_seq + i),
+          ByteReader<uint16_t>::ReadBigEndian(reports + i * kReportLength)));
+    }
+    index += BlockSize(num_reports);
+  }
+  return true;
+}
+
+size_t CongestionControlFeedback::BlockLength() const {
+  size_t length = kHeaderLength + kSenderSsrcLength + kReportTimestampLength;
+  size_t block_start = 0;
+  for (size_t i = 1; i <= packets_.size(); ++i) {
+    if (i == packets_.size() || packets_[i].ssrc != packets_[i - 1].ssrc) {
+      length += BlockSize(NumReports(packets_[block_start], packets_[i - 1]));
+      block_start = i;
+    }
+  }
+  return length;
+}
+
+bool CongestionControlFeedback::Create(uint8_t* packet,
+                                       size_t* index,
+                                       size_t max_length,
+                                       PacketReadyCallback callback) const {
+  while (*index + BlockLength() > max_length) {
+    if (!OnBufferFull(packet, index, callback))
+      return false;
+  }
+  const size_t index_end = *index + BlockLength();
+
+  CreateHeader(kFeedbackMessageType, kPacketType, HeaderLength(), packet,
+               index);
+  ByteWriter<uint32_t>::WriteBigEndian(packet + *index, sender_ssrc());
+  *index += kSenderSsrcLength;
+
+  size_t block_start = 0;
+  for (size_t i = 1; i <= packets_.size(); ++i) {
+    if (i < packets_.size() && packets_[i].ssrc == packets_[i - 1].ssrc) {
+      continue;
+    }
+    const PacketInfo& first = packets_[block_start];
+    const int num_reports = NumReports(first, packets_[i - 1]);
+    RTC_DCHECK_LE(num_reports, kMaxReportsPerBlock);
+    ByteWriter<uint32_t>::WriteBigEndian(packet + *index, first.ssrc);
+    ByteWriter<uint16_t>::WriteBigEndian(packet + *index + 4,
+                                         first.sequence_number);
+    ByteWriter<uint16_t>::WriteBigEndian(packet + *index + 6, num_reports);
+    uint8_t* reports = packet + *index + kBlockHeaderLength;
+    // Packets that are not in `packets_` are reported as not received.
+    memset(reports, 0, BlockSize(num_reports) - kBlockHeaderLength);
+    for (size_t j = block_start; j < i; ++j) {
+      const uint16_t offset =
+          packets_[j].sequence_number - first.sequence_number;
+      RTC_DCHECK_LT(offset, num_reports);
+      ByteWriter<uint16_t>::WriteBigEndian(reports + offset * kReportLength,
+                                           ToReport(packets_[j]));
+    }
+    *index += BlockSize(num_reports);
+    block_start = i;
+  }
+
+  ByteWriter<uint32_t>::WriteBigEndian(packet + *index,
+                                       report_timestamp_compact_ntp_);
+  *index += kReportTimestampLength;
+  RTC_CHECK_EQ(index_end, *index);
+  return true;
+}
+
+}  // namespace rtcp
+}  // namespace webrtc
@@ -0,0 +1,81 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_RTP_RTCP_SOURCE_RTCP_PACKET_CONGESTION_CONTROL_FEEDBACK_H_
+#define MODULES_RTP_RTCP_SOURCE_RTCP_PACKET_CONGESTION_CONTROL_FEEDBACK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "api/array_view.h"
+#include "api/transport/ecn_marking.h"
+#include "api/units/time_delta.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/rtpfb.h"
+
+namespace webrtc {
+namespace rtcp {
+class CommonHeader;
+
+// RTP Control Protocol (RTCP) Feedback for Congestion Control.
+// RFC 8888, Section 3.1.
+class CongestionControlFeedback : public Rtpfb {
+ public:
+  struct PacketInfo {
+    uint32_t ssrc = 0;
+    uint16_t sequence_number = 0;
+    // Time from the arrival of the packet to the report timestamp. Minus
+    // infinity if the packet was not received and plus infinity if it was
+    // received at an unknown time.
+    TimeDelta arrival_time_offset = TimeDelta::MinusInfinity();
+    EcnMarking ecn = EcnMarking::kNotEct;
+
+    bool received() const { return !arrival_time_offset.IsMinusInfinity(); }
+  };
+
+  static constexpr uint8_t kFeedbackMessageType = 11;
+
+  CongestionControlFeedback();
+  // The packets of each SSRC must be consecutive in `packets` and in sequence
+  // number order. Packets missing between two reported packets of an SSRC are
+  // reported as not received. `report_timestamp_compact_ntp` is the middle 32
+  // bits of the NTP time the report was created at.
+  CongestionControlFeedback(std::vector<PacketInfo> packets,
+                            uint32_t report_timestamp_compact_ntp);
+  ~CongestionControlFeedback() override;
+
+  // Parse assumes header is already parsed and validated.
+  bool Parse(const CommonHeader& packet);
+
+  // The reports of all packets, including the ones that were not received.
+  rtc::ArrayView<const PacketInfo> packets() const { return packets_; }
+  uint32_t report_timestamp_compact_ntp() const {
+    return report_timestamp_compact_ntp_;
+  }
+
+  size_t BlockLength() const override;
+
+  bool Create(uint8_t* packet,
+              size_t* index,
+              size_t max_length,
+              PacketReadyCallback callback) const override;
+
+ private:
+  // Media ssrc is unused, shadow base class setter.
+  void SetMediaSsrc(uint32_t ssrc);
+
+  std::vector<PacketInfo> packets_;
+  uint32_t report_timestamp_compact_ntp_ = 0;
+};
+
+}  // namespace rtcp
+}  // namespace webrtc
+#endif  // MODULES_RTP_RTCP_SOURCE_RTCP_PACKET_CONGESTION_CONTROL_FEEDBACK_H_
@@ -0,0 +1,126 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/rtp_rtcp/source/rtcp_packet/congestion_control_feedback.h"
+
+#include <vector>
+
+#include "api/transport/ecn_marking.h"
+#include "api/units/time_delta.h"
+#include "rtc_base/buffer.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+#include "test/rtcp_packet_parser.h"
+
+using ::testing::ElementsAreArray;
+using ::testing::make_tuple;
+using webrtc::rtcp::CongestionControlFeedback;
+
+namespace webrtc {
+namespace {
+const uint32_t kSenderSsrc = 0x12345678;
+const uint32_t kMediaSsrc = 0x23456789;
+const uint32_t kReportTimestamp = 0x01020304;
+// Packets 0x0100 and 0x0102 received, 0x0101 lost. The first arrived
+// 1/1024 s before the report with ECT(1), the second 2/1024 s before with CE.
+const uint8_t kPacket[] = {0x8b, 205,  0x00, 0x06, 0x12, 0x34, 0x56, 0x78,
+                           0x23, 0x45, 0x67, 0x89, 0x01, 0x00, 0x00, 0x03,
+                           0xa0, 0x01, 0x00, 0x00, 0xe0, 0x02, 0x00, 0x00,
+                           0x01, 0x02, 0x03, 0x04};
+
+CongestionControlFeedback::PacketInfo Received(uint32_t ssrc,
+                                               uint16_t sequence_number,
+                                               TimeDelta arrival_time_offset,
+                                               EcnMarking ecn) {
+  CongestionControlFeedback::PacketInfo packet;
+  packet.ssrc = ssrc;
+  packet.sequence_number = sequence_number;
+  packet.arrival_time_offset = arrival_time_offset;
+  packet.ecn = ecn;
+  return packet;
+}
+
+// One tick of the arrival time offset, 1/1024 s.
+constexpr TimeDelta kTick = TimeDelta::Micros(976);
+
+}  // namespace
+
+TEST(RtcpPacketCongestionControlFeedbackTest, Create) {
+  CongestionControlFeedback feedback(
+      {Received(kMediaSsrc, 0x0100, kTick, EcnMarking::kEct1),
+       Received(kMediaSsrc, 0x0102, 2 * kTick, EcnMarking::kCe)},
+      kReportTimestamp);
+  feedback.SetSenderSsrc(kSenderSsrc);
+
+  rtc::Buffer packet = feedback.Build();
+
+  EXPECT_THAT(make_tuple(packet.data(), packet.size()),
+              ElementsAreArray(kPacket));
+}
+
+TEST(RtcpPacketCongestionControlFeedbackTest, Parse) {
+  CongestionControlFeedback feedback;
+  EXPECT_TRUE(test::ParseSinglePacket(kPacket, &feedback));
+
+  EXPECT_EQ(feedback.sender_ssrc(), kSenderSsrc);
+  EXPECT_EQ(feedback.report_timestamp_compact_ntp(), kReportTimestamp);
+  ASSERT_EQ(feedback.packets().size(), 3u);
+  EXPECT_EQ(feedback.packets()[0].ssrc, kMediaSsrc);
+  EXPECT_EQ(feedback.packets()[0].sequence_number, 0x0100);
+  EXPECT_TRUE(feedback.packets()[0].received());
+  EXPECT_EQ(feedback.packets()[0].ecn, EcnMarking::kEct1);
+  EXPECT_EQ(feedback.packets()[0].arrival_time_offset, kTick);
+  EXPECT_EQ(feedback.packets()[1].sequence_number, 0x0101);
+  EXPECT_FALSE(feedback.packets()[1].received());
+  EXPECT_EQ(feedback.packets()[2].sequence_number, 0x0102);
+  EXPECT_EQ(feedback.packets()[2].ecn, EcnMarking::kCe);
+  EXPECT_EQ(feedback.packets()[2].arrival_time_offset, TimeDelta::Micros(1953));
+}
+
+TEST(RtcpPacketCongestionControlFeedbackTest,
+     CreateAndParseWithSeveralSsrcsAndSequenceNumberWrap) {
+  CongestionControlFeedback feedback(
+      {Received(kMediaSsrc, 0xffff, kTick, EcnMarking::kEct0),
+       Received(kMediaSsrc, 0x0000, kTick, EcnMarking::kEct0),
+       Received(kMediaSsrc + 1, 7, TimeDelta::Seconds(10), EcnMarking::kNotEct),
+       Received(kMediaSsrc + 1, 8, TimeDelta::PlusInfinity(),
+                EcnMarking::kNotEct)},
+      kReportTimestamp);
+  feedback.SetSenderSsrc(kSenderSsrc);
+
+  rtc::Buffer packet = feedback.Build();
+  EXPECT_EQ(packet.size(), feedback.BlockLength());
+
+  CongestionControlFeedback parsed;
+  ASSERT_TRUE(test::ParseSinglePacket(packet, &parsed));
+  ASSERT_EQ(parsed.packets().size(), 4u);
+  EXPECT_EQ(parsed.packets()[1].ssrc, kMediaSsrc);
+  EXPECT_EQ(parsed.packets()[1].sequence_number, 0x0000);
+  EXPECT_EQ(parsed.packets()[1].ecn, EcnMarking::kEct0);
+  EXPECT_EQ(parsed.packets()[2].ssrc, kMediaSsrc + 1);
+  // Offsets that do not fit are reported as the largest one.
+  EXPECT_EQ(parsed.packets()[2].arrival_time_offset,
+            TimeDelta::Micros(int64_t{0x1ffe} * 1'000'000 / 1024));
+  EXPECT_TRUE(parsed.packets()[3].received());
+  EXPECT_TRUE(parsed.packets()[3].arrival_time_offset.IsPlusInfinity());
+}
+
+TEST(RtcpPacketCongestionControlFeedbackTest, ParseFailsOnTruncatedBlock) {
+  // The block claims 5 reports, but only has room for 4.
+  const uint8_t kTruncated[] = {0x8b, 205,  0x00, 0x06, 0x12, 0x34, 0x56,
+                                0x78, 0x23, 0x45, 0x67, 0x89, 0x01, 0x00,
+                                0x00, 0x05, 0xa0, 0x01, 0x00, 0x00, 0xe0,
+                                0x02, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04};
+
+  CongestionControlFeedback feedback;
+  EXPECT_FALSE(test::ParseSinglePacket(kTruncated, &feedback));
+}
+
+}  // namespace webrtc
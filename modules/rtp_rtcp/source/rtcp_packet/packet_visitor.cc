@@ -0,0 +1,262 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/rtp_rtcp/source/rtcp_packet/packet_visitor.h"
+
+#include <cstdint>
+
+#include "modules/rtp_rtcp/source/byte_io.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/common_header.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/nack.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/pli.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/psfb.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/receiver_report.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/report_block.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/rtpfb.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/sender_report.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+
+namespace webrtc {
+namespace rtcp {
+namespace {
+// Both Rtpfb and Psfb messages start with the sender and media source ssrcs.
+constexpr size_t kCommonFeedbackLength = 8;
+constexpr size_t kNackItemLength = 4;
+// Sender ssrc of a Receiver Report.
+constexpr size_t kRrBaseLength = 4;
+// Sender ssrc and sender info of a Sender Report.
+constexpr size_t kSrBaseLength = 24;
+// Common feedback, 'REMB' identifier, ssrc count and bitrate.
+constexpr size_t kRembBaseLength = 16;
+constexpr uint32_t kRembIdentifier = 0x52454D42;  // 'R' 'E' 'M' 'B'.
+// Common feedback and the fixed fields of a transport-wide feedback.
+constexpr size_t kTransportFeedbackBaseLength = 16;
+// `TransportFeedback::Parse` rejects messages without any packet status chunk.
+constexpr size_t kPacketStatusChunkLength = 2;
+
+void VisitReportBlocks(const CommonHeader& block,
+                       size_t base_length,
+                       uint32_t sender_ssrc,
+                       PacketVisitor& visitor) {
+  const uint8_t* next_block = block.payload() + base_length;
+  for (size_t i = 0; i < block.count(); ++i) {
+    ReportBlock report_block;
+    bool block_parsed = report_block.Parse(next_block, ReportBlock::kLength);
+    RTC_DCHECK(block_parsed);
+    visitor.OnReportBlock(sender_ssrc, report_block);
+    next_block += ReportBlock::kLength;
+  }
+}
+
+bool VisitSenderReport(const CommonHeader& block, PacketVisitor& visitor) {
+  if (block.payload_size_bytes() <
+      kSrBaseLength + block.count() * ReportBlock::kLength) {
+    RTC_LOG(LS_WARNING) << "Packet is too small to contain all the data.";
+    return false;
+  }
+  const uint8_t* const payload = block.payload();
+  SenderInfo sender_info;
+  sender_info.sender_ssrc = ByteReader<uint32_t>::ReadBigEndian(&payload[0]);
+  sender_info.ntp.Set(ByteReader<uint32_t>::ReadBigEndian(&payload[4]),
+                      ByteReader<uint32_t>::ReadBigEndian(&payload[8]));
+  sender_info.rtp_timestamp = ByteReader<uint32_t>::ReadBigEndian(&payload[12]);
+  sender_info.sender_packet_count =
+      ByteReader<uint32_t>::ReadBigEndian(&payload[16]);
+  sender_info.sender_octet_count =
+      ByteReader<uint32_t>::ReadBigEndian(&payload[20]);
+  visitor.OnSenderReport(sender_info);
+  VisitReportBlocks(block, kSrBaseLength, sender_info.sender_ssrc, visitor);
+  return true;
+}
+
+bool VisitReceiverReport(const CommonHeader& block, PacketVisitor& visitor) {
+  if (block.payload_size_bytes() <
+      kRrBaseLength + block.count() * ReportBlock::kLength) {
+    RTC_LOG(LS_WARNING) << "Packet is too small to contain all the data.";
+    return false;
+  }
+  uint32_t sender_ssrc = ByteReader<uint32_t>::ReadBigEndian(block.payload());
+  visitor.OnReceiverReport(sender_ssrc);
+  VisitReportBlocks(block, kRrBaseLength, sender_ssrc, visitor);
+  return true;
+}
+
+bool VisitNack(const CommonHeader& block, PacketVisitor& visitor) {
+  if (block.payload_size_bytes() < kCommonFeedbackLength + kNackItemLength) {
+    RTC_LOG(LS_WARNING) << "Payload length " << block.payload_size_bytes()
+                        << " is too small for a Nack.";
+    return false;
+  }
+  const uint8_t* const payload = block.payload();
+  size_t nack_items =
+      (block.payload_size_bytes() - kCommonFeedbackLength) / kNackItemLength;
+  visitor.OnNack(ByteReader<uint32_t>::ReadBigEndian(&payload[0]),
+                 ByteReader<uint32_t>::ReadBigEndian(&payload[4]),
+                 NackPacketIds(rtc::MakeArrayView(
+                     payload + kCommonFeedbackLength,
+                     nack_items * kNackItemLength)));
+  return true;
+}
+
+bool VisitTransportFeedback(const CommonHeader& block,
+                            PacketVisitor& visitor) {
+  if (block.payload_size_bytes() <
+      kTransportFeedbackBaseLength + kPacketStatusChunkLength) {
+    RTC_LOG(LS_WARNING) << "Buffer too small (" << block.payload_size_bytes()
+                        << " bytes) to fit a transport feedback.";
+    return false;
+  }
+  const uint8_t* const payload = block.payload();
+  TransportFeedbackHeader header;
+  header.sender_ssrc = ByteReader<uint32_t>::ReadBigEndian(&payload[0]);
+  header.media_ssrc = ByteReader<uint32_t>::ReadBigEndian(&payload[4]);
+  header.base_sequence_number =
+      ByteReader<uint16_t>::ReadBigEndian(&payload[8]);
+  header.packet_status_count =
+      ByteReader<uint16_t>::ReadBigEndian(&payload[10]);
+  header.reference_time = ByteReader<uint32_t, 3>::ReadBigEndian(&payload[12]);
+  header.feedback_packet_count = payload[15];
+  visitor.OnTransportFeedback(header, block);
+  return true;
+}
+
+bool VisitPli(const CommonHeader& block, PacketVisitor& visitor) {
+  if (block.payload_size_bytes() < kCommonFeedbackLength) {
+    RTC_LOG(LS_WARNING) << "Packet is too small to be a valid PLI packet";
+    return false;
+  }
+  visitor.OnPli(ByteReader<uint32_t>::ReadBigEndian(&block.payload()[0]),
+                ByteReader<uint32_t>::ReadBigEndian(&block.payload()[4]));
+  return true;
+}
+
+// Application layer feedback doesn't have a standard format, so messages that
+// aren't valid REMB are passed on as other blocks rather than rejected.
+bool VisitPsfbApp(const CommonHeader& block, PacketVisitor& visitor) {
+  const uint8_t* const payload = block.payload();
+  if (block.payload_size_bytes() < kRembBaseLength ||
+      ByteReader<uint32_t>::ReadBigEndian(&payload[8]) != kRembIdentifier) {
+    visitor.OnOtherBlock(block);
+    return true;
+  }
+  uint8_t number_of_ssrcs = payload[12];
+  if (block.payload_size_bytes() != kRembBaseLength + number_of_ssrcs * 4) {
+    RTC_LOG(LS_WARNING) << "Payload size " << block.payload_size_bytes()
+                        << " does not match " << number_of_ssrcs << " ssrcs.";
+    visitor.OnOtherBlock(block);
+    return true;
+  }
+  uint8_t exponent = payload[13] >> 2;
+  uint64_t mantissa = (static_cast<uint32_t>(payload[13] & 0x03) << 16) |
+                      ByteReader<uint16_t>::ReadBigEndian(&payload[14]);
+  int64_t bitrate_bps = (mantissa << exponent);
+  bool shift_overflow =
+      (static_cast<uint64_t>(bitrate_bps) >> exponent) != mantissa;
+  if (bitrate_bps < 0 || shift_overflow) {
+    RTC_LOG(LS_ERROR) << "Invalid remb bitrate value : " << mantissa << "*2^"
+                      << static_cast<int>(exponent);
+    visitor.OnOtherBlock(block);
+    return true;
+  }
+  visitor.OnRemb(ByteReader<uint32_t>::ReadBigEndian(&payload[0]),
+                 bitrate_bps,
+                 SsrcList(rtc::MakeArrayView(payload + kRembBaseLength,
+                                             number_of_ssrcs * 4)));
+  return true;
+}
+
+}  // namespace
+
+NackPacketIds::Iterator::Iterator(const uint8_t* item, const uint8_t* end)
+    : item_(item), end_(end) {
+  LoadItem();
+}
+
+NackPacketIds::Iterator& NackPacketIds::Iterator::operator++() {
+  RTC_DCHECK(item_ != end_);
+  while (bitmask_ != 0) {
+    ++packet_id_;
+    bool requested = (bitmask_ & 1) != 0;
+    bitmask_ >>= 1;
+    if (requested) {
+      return *this;
+    }
+  }
+  item_ += kNackItemLength;
+  LoadItem();
+  return *this;
+}
+
+void NackPacketIds::Iterator::LoadItem() {
+  if (item_ == end_) {
+    packet_id_ = 0;
+    bitmask_ = 0;
+    return;
+  }
+  packet_id_ = ByteReader<uint16_t>::ReadBigEndian(item_);
+  bitmask_ = ByteReader<uint16_t>::ReadBigEndian(item_ + 2);
+}
+
+NackPacketIds::Iterator NackPacketIds::begin() const {
+  return Iterator(fci_.begin(), fci_.end());
+}
+
+NackPacketIds::Iterator NackPacketIds::end() const {
+  return Iterator(fci_.end(), fci_.end());
+}
+
+uint32_t SsrcList::Iterator::operator*() const {
+  return ByteReader<uint32_t>::ReadBigEndian(position_);
+}
+
+bool VisitBlock(const CommonHeader& block, PacketVisitor& visitor) {
+  switch (block.type()) {
+    case SenderReport::kPacketType:
+      return VisitSenderReport(block, visitor);
+    case ReceiverReport::kPacketType:
+      return VisitReceiverReport(block, visitor);
+    case Rtpfb::kPacketType:
+      switch (block.fmt()) {
+        case Nack::kFeedbackMessageType:
+          return VisitNack(block, visitor);
+        case TransportFeedback::kFeedbackMessageType:
+          return VisitTransportFeedback(block, visitor);
+      }
+      break;
+    case Psfb::kPacketType:
+      switch (block.fmt()) {
+        case Pli::kFeedbackMessageType:
+          return VisitPli(block, visitor);
+        case Psfb::kAfbMessageType:
+          return VisitPsfbApp(block, visitor);
+      }
+      break;
+  }
+  visitor.OnOtherBlock(block);
+  return true;
+}
+
+bool VisitCompoundPacket(rtc::ArrayView<const uint8_t> packet,
+                         PacketVisitor& visitor) {
+  while (!packet.empty()) {
+    CommonHeader block;
+    if (!block.Parse(packet.data(), packet.size()) ||
+        !VisitBlock(block, visitor)) {
+      return false;
+    }
+    packet = packet.subview(block.packet_size());
+  }
+  return true;
+}
+
+}  // namespace rtcp
+}  // namespace webrtc
@@ -0,0 +1,183 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#ifndef MODULES_RTP_RTCP_SOURCE_RTCP_PACKET_PACKET_VISITOR_H_
+#define MODULES_RTP_RTCP_SOURCE_RTCP_PACKET_PACKET_VISITOR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <iterator>
+
+#include "api/array_view.h"
+#include "system_wrappers/include/ntp_time.h"
+
+namespace webrtc {
+namespace rtcp {
+class CommonHeader;
+class ReportBlock;
+
+// Sequence numbers requested by a Generic NACK (RFC 4585). Refers to the FCI
+// of the parsed block and expands PID/BLP items while iterating, i.e. the
+// view is only valid as long as the buffer holding the RTCP packet.
+class NackPacketIds {
+ public:
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = uint16_t;
+    using difference_type = ptrdiff_t;
+    using pointer = const uint16_t*;
+    using reference = uint16_t;
+
+    Iterator() = default;
+    Iterator(const uint8_t* item, const uint8_t* end);
+
+    uint16_t operator*() const { return packet_id_; }
+    Iterator& operator++();
+    Iterator operator++(int) {
+      Iterator copy = *this;
+      ++*this;
+      return copy;
+    }
+    bool operator==(const Iterator& other) const {
+      return item_ == other.item_ && bitmask_ == other.bitmask_ &&
+             packet_id_ == other.packet_id_;
+    }
+    bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+   private:
+    void LoadItem();
+
+    const uint8_t* item_ = nullptr;
+    const uint8_t* end_ = nullptr;
+    uint16_t packet_id_ = 0;
+    // Remaining bits of the current BLP, shifted so that bit 0 corresponds
+    // to `packet_id_ + 1`.
+    uint16_t bitmask_ = 0;
+  };
+
+  explicit NackPacketIds(rtc::ArrayView<const uint8_t> fci) : fci_(fci) {}
+
+  Iterator begin() const;
+  Iterator end() const;
+  // Every NACK item requests at least one packet, so the list is empty only
+  // when there are no items.
+  bool empty() const { return fci_.size() < 4; }
+
+ private:
+  rtc::ArrayView<const uint8_t> fci_;
+};
+
+// List of 32 bit big endian ssrcs, e.g. the feedback ssrcs of a REMB message.
+class SsrcList {
+ public:
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = uint32_t;
+    using difference_type = ptrdiff_t;
+    using pointer = const uint32_t*;
+    using reference = uint32_t;
+
+    explicit Iterator(const uint8_t* position) : position_(position) {}
+    uint32_t operator*() const;
+    Iterator& operator++() {
+      position_ += 4;
+      return *this;
+    }
+    bool operator==(const Iterator& other) const {
+      return position_ == other.position_;
+    }
+    bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+   private:
+    const uint8_t* position_;
+  };
+
+  explicit SsrcList(rtc::ArrayView<const uint8_t> ssrcs) : ssrcs_(ssrcs) {}
+
+  Iterator begin() const { return Iterator(ssrcs_.begin()); }
+  Iterator end() const { return Iterator(ssrcs_.end()); }
+  size_t size() const { return ssrcs_.size() / 4; }
+  bool empty() const { return ssrcs_.empty(); }
+
+ private:
+  rtc::ArrayView<const uint8_t> ssrcs_;
+};
+
+// Sender information of a Sender Report (RFC 3550 section 6.4.1).
+struct SenderInfo {
+  uint32_t sender_ssrc = 0;
+  NtpTime ntp;
+  uint32_t rtp_timestamp = 0;
+  uint32_t sender_packet_count = 0;
+  uint32_t sender_octet_count = 0;
+};
+
+// Fixed part of a transport-wide feedback message
+// (draft-holmer-rmcat-transport-wide-cc-extensions-01). Packet statuses and
+// receive deltas are left to `TransportFeedback::Parse`, so that receivers
+// only pay for decoding feedback that is addressed to them.
+struct TransportFeedbackHeader {
+  uint32_t sender_ssrc = 0;
+  uint32_t media_ssrc = 0;
+  uint16_t base_sequence_number = 0;
+  uint16_t packet_status_count = 0;
+  // 24 bit reference time, in multiples of 64ms.
+  uint32_t reference_time = 0;
+  uint8_t feedback_packet_count = 0;
+};
+
+// Receives the content of RTCP blocks decoded in place by `VisitBlock`.
+// Arguments refer to the buffer holding the RTCP packet and must not be stored
+// beyond the callback. All callbacks do nothing by default.
+class PacketVisitor {
+ public:
+  virtual ~PacketVisitor() = default;
+
+  // Called for a Sender Report, before `OnReportBlock` for each of its report
+  // blocks.
+  virtual void OnSenderReport(const SenderInfo& sender_info) {}
+  // Called for a Receiver Report, before `OnReportBlock` for each of its
+  // report blocks.
+  virtual void OnReceiverReport(uint32_t sender_ssrc) {}
+  virtual void OnReportBlock(uint32_t sender_ssrc,
+                             const ReportBlock& report_block) {}
+
+  virtual void OnNack(uint32_t sender_ssrc,
+                      uint32_t media_ssrc,
+                      const NackPacketIds& packet_ids) {}
+  virtual void OnPli(uint32_t sender_ssrc, uint32_t media_ssrc) {}
+  virtual void OnRemb(uint32_t sender_ssrc,
+                      int64_t bitrate_bps,
+                      const SsrcList& ssrcs) {}
+  // `block` is passed along so that the full feedback can be parsed with
+  // `TransportFeedback::Parse` when needed.
+  virtual void OnTransportFeedback(const TransportFeedbackHeader& header,
+                                   const CommonHeader& block) {}
+
+  // Called for blocks of any other type, and for application layer feedback
+  // that isn't a REMB message.
+  virtual void OnOtherBlock(const CommonHeader& block) {}
+};
+
+// Decodes `block` without allocating and reports its content to `visitor`.
+// Returns false, without calling `visitor`, if `block` is of one of the types
+// decoded here but is malformed.
+bool VisitBlock(const CommonHeader& block, PacketVisitor& visitor);
+
+// Calls `VisitBlock` for every block of the compound `packet`. Stops and
+// returns false at the first block that fails to parse.
+bool VisitCompoundPacket(rtc::ArrayView<const uint8_t> packet,
+                         PacketVisitor& visitor);
+
+}  // namespace rtcp
+}  // namespace webrtc
+#endif  // MODULES_RTP_RTCP_SOURCE_RTCP_PACKET_PACKET_VISITOR_H_
@@ -0,0 +1,247 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/common_header.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/compound_packet.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/nack.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/packet_visitor.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/pli.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/receiver_report.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/remb.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/report_block.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/sdes.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/sender_report.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
+#include "rtc_base/buffer.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/system/unused.h"
+
+namespace webrtc {
+namespace {
+
+constexpr uint32_t kSenderSsrc = 0x12345678;
+constexpr uint32_t kMediaSsrc = 0x23456789;
+
+rtcp::ReportBlock CreateReportBlock(uint32_t source_ssrc) {
+  rtcp::ReportBlock block;
+  block.SetMediaSsrc(source_ssrc);
+  block.SetExtHighestSeqNum(0x10000);
+  block.SetLastSr(0x11223344);
+  block.SetDelayLastSr(0x5566);
+  return block;
+}
+
+// SR with a couple of report blocks and an SDES, as sent every reporting
+// interval by an endpoint that both sends and receives media.
+rtc::Buffer SenderReportPacket() {
+  rtcp::CompoundPacket compound;
+  auto sr = std::make_unique<rtcp::SenderReport>();
+  sr->SetSenderSsrc(kSenderSsrc);
+  sr->AddReportBlock(CreateReportBlock(kMediaSsrc));
+  sr->AddReportBlock(CreateReportBlock(kMediaSsrc + 1));
+  compound.Append(std::move(sr));
+  auto sdes = std::make_unique<rtcp::Sdes>();
+  sdes->AddCName(kSenderSsrc, "benchmark@webrtc");
+  compound.Append(std::move(sdes));
+  return compound.Build();
+}
+
+// RR followed by the feedback a video receiver sends on loss.
+rtc::Buffer ReceiverFeedbackPacket() {
+  rtcp::CompoundPacket compound;
+  auto rr = std::make_unique<rtcp::ReceiverReport>();
+  rr->SetSenderSsrc(kSenderSsrc);
+  rr->AddReportBlock(CreateReportBlock(kMediaSsrc));
+  compound.Append(std::move(rr));
+  auto nack = std::make_unique<rtcp::Nack>();
+  nack->SetSenderSsrc(kSenderSsrc);
+  nack->SetMediaSsrc(kMediaSsrc);
+  std::vector<uint16_t> packet_ids;
+  for (uint16_t seq = 1000; seq < 1100; seq += 3) {
+    packet_ids.push_back(seq);
+  }
+  nack->SetPacketIds(std::move(packet_ids));
+  compound.Append(std::move(nack));
+  auto pli = std::make_unique<rtcp::Pli>();
+  pli->SetSenderSsrc(kSenderSsrc);
+  pli->SetMediaSsrc(kMediaSsrc);
+  compound.Append(std::move(pli));
+  auto remb = std::make_unique<rtcp::Remb>();
+  remb->SetSenderSsrc(kSenderSsrc);
+  remb->SetBitrateBps(2'500'000);
+  remb->SetSsrcs({kMediaSsrc});
+  compound.Append(std::move(remb));
+  return compound.Build();
+}
+
+// Transport-wide feedback covering 100 packets, half of them lost.
+rtc::Buffer TransportFeedbackPacket() {
+  rtcp::TransportFeedback feedback;
+  feedback.SetSenderSsrc(kSenderSsrc);
+  feedback.SetMediaSsrc(kMediaSsrc);
+  feedback.SetBase(1000, Timestamp::Millis(1000));
+  for (uint16_t i = 0; i < 100; i += 2) {
+    RTC_CHECK(feedback.AddReceivedPacket(1000 + i,
+                                         Timestamp::Millis(1000 + 2 * i)));
+  }
+  return feedback.Build();
+}
+
+class CountingVisitor : public rtcp::PacketVisitor {
+ public:
+  void OnSenderReport(const rtcp::SenderInfo& sender_info) override {
+    sum_ += sender_info.rtp_timestamp;
+  }
+  void OnReportBlock(uint32_t sender_ssrc,
+                     const rtcp::ReportBlock& report_block) override {
+    sum_ += report_block.extended_high_seq_num();
+  }
+  void OnNack(uint32_t sender_ssrc,
+              uint32_t media_ssrc,
+              const rtcp::NackPacketIds& packet_ids) override {
+    for (uint16_t packet_id : packet_ids) {
+      sum_ += packet_id;
+    }
+  }
+  void OnPli(uint32_t sender_ssrc, uint32_t media_ssrc) override {
+    sum_ += media_ssrc;
+  }
+  void OnRemb(uint32_t sender_ssrc,
+              int64_t bitrate_bps,
+              const rtcp::SsrcList& ssrcs) override {
+    sum_ += bitrate_bps;
+  }
+  void OnTransportFeedback(const rtcp::TransportFeedbackHeader& header,
+                           const rtcp::CommonHeader& block) override {
+    rtcp::TransportFeedback feedback;
+    RTC_CHECK(feedback.Parse(block));
+    sum_ += feedback.GetReceivedPackets().size();
+  }
+  void OnOtherBlock(const rtcp::CommonHeader& block) override {
+    sum_ += block.type();
+  }
+
+  int64_t sum() const { return sum_; }
+
+ private:
+  int64_t sum_ = 0;
+};
+
+// Parses the same blocks as `CountingVisitor` by building the rtcp::RtcpPacket
+// objects, i.e. the way received packets were handled before `VisitBlock`.
+int64_t ParseWithPacketObjects(rtc::ArrayView<const uint8_t> packet) {
+  int64_t sum = 0;
+  while (!packet.empty()) {
+    rtcp::CommonHeader block;
+    RTC_CHECK(block.Parse(packet.data(), packet.size()));
+    switch (block.type()) {
+      case rtcp::SenderReport::kPacketType: {
+        rtcp::SenderReport sr;
+        RTC_CHECK(sr.Parse(block));
+        sum += sr.rtp_timestamp();
+        for (const rtcp::ReportBlock& report_block : sr.report_blocks()) {
+          sum += report_block.extended_high_seq_num();
+        }
+        break;
+      }
+      case rtcp::ReceiverReport::kPacketType: {
+        rtcp::ReceiverReport rr;
+        RTC_CHECK(rr.Parse(block));
+        for (const rtcp::ReportBlock& report_block : rr.report_blocks()) {
+          sum += report_block.extended_high_seq_num();
+        }
+        break;
+      }
+      case rtcp::Rtpfb::kPacketType:
+        if (block.fmt() == rtcp::Nack::kFeedbackMessageType) {
+          rtcp::Nack nack;
+          RTC_CHECK(nack.Parse(block));
+          for (uint16_t packet_id : nack.packet_ids()) {
+            sum += packet_id;
+          }
+        } else {
+          auto feedback = std::make_unique<rtcp::TransportFeedback>();
+          RTC_CHECK(feedback->Parse(block));
+          sum += feedback->GetReceivedPackets().size();
+        }
+        break;
+      case rtcp::Psfb::kPacketType:
+        if (block.fmt() == rtcp::Pli::kFeedbackMessageType) {
+          rtcp::Pli pli;
+          RTC_CHECK(pli.Parse(block));
+          sum += pli.media_ssrc();
+        } else {
+          rtcp::Remb remb;
+          RTC_CHECK(remb.Parse(block));
+          sum += remb.bitrate_bps();
+        }
+        break;
+      default:
+        sum += block.type();
+        break;
+    }
+    packet = packet.subview(block.packet_size());
+  }
+  return sum;
+}
+
+void RunVisitor(benchmark::State& state, const rtc::Buffer& packet) {
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    CountingVisitor visitor;
+    bool valid = rtcp::VisitCompoundPacket(packet, visitor);
+    benchmark::DoNotOptimize(valid);
+    benchmark::DoNotOptimize(visitor.sum());
+  }
+  state.SetBytesProcessed(state.iterations() * packet.size());
+}
+
+void RunPacketObjects(benchmark::State& state, const rtc::Buffer& packet) {
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    int64_t sum = ParseWithPacketObjects(packet);
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetBytesProcessed(state.iterations() * packet.size());
+}
+
+void BM_VisitSenderReport(benchmark::State& state) {
+  RunVisitor(state, SenderReportPacket());
+}
+void BM_ParseSenderReport(benchmark::State& state) {
+  RunPacketObjects(state, SenderReportPacket());
+}
+void BM_VisitReceiverFeedback(benchmark::State& state) {
+  RunVisitor(state, ReceiverFeedbackPacket());
+}
+void BM_ParseReceiverFeedback(benchmark::State& state) {
+  RunPacketObjects(state, ReceiverFeedbackPacket());
+}
+void BM_VisitTransportFeedback(benchmark::State& state) {
+  RunVisitor(state, TransportFeedbackPacket());
+}
+void BM_ParseTransportFeedback(benchmark::State& state) {
+  RunPacketObjects(state, TransportFeedbackPacket());
+}
+
+BENCHMARK(BM_VisitSenderReport);
+BENCHMARK(BM_ParseSenderReport);
+BENCHMARK(BM_VisitReceiverFeedback);
+BENCHMARK(BM_ParseReceiverFeedback);
+BENCHMARK(BM_VisitTransportFeedback);
+BENCHMARK(BM_ParseTransportFeedback);
+
+}  // namespace
+}  // namespace webrtc
@@ -0,0 +1,303 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/rtp_rtcp/source/rtcp_packet/packet_visitor.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "modules/rtp_rtcp/source/rtcp_packet/bye.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/common_header.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/compound_packet.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/loss_notification.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/nack.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/pli.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/receiver_report.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/remb.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/report_block.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/sender_report.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
+#include "rtc_base/buffer.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+using ::testing::_;
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+using ::testing::InSequence;
+using ::testing::Invoke;
+using ::testing::Property;
+
+constexpr uint32_t kSenderSsrc = 0x12345678;
+constexpr uint32_t kMediaSsrc = 0x23456789;
+
+class MockPacketVisitor : public rtcp::PacketVisitor {
+ public:
+  MOCK_METHOD(void, OnSenderReport, (const rtcp::SenderInfo&), (override));
+  MOCK_METHOD(void, OnReceiverReport, (uint32_t), (override));
+  MOCK_METHOD(void,
+              OnReportBlock,
+              (uint32_t, const rtcp::ReportBlock&),
+              (override));
+  MOCK_METHOD(void,
+              OnNack,
+              (uint32_t, uint32_t, const rtcp::NackPacketIds&),
+              (override));
+  MOCK_METHOD(void, OnPli, (uint32_t, uint32_t), (override));
+  MOCK_METHOD(void,
+              OnRemb,
+              (uint32_t, int64_t, const rtcp::SsrcList&),
+              (override));
+  MOCK_METHOD(void,
+              OnTransportFeedback,
+              (const rtcp::TransportFeedbackHeader&,
+               const rtcp::CommonHeader&),
+              (override));
+  MOCK_METHOD(void, OnOtherBlock, (const rtcp::CommonHeader&), (override));
+};
+
+rtcp::ReportBlock CreateReportBlock(uint32_t source_ssrc) {
+  rtcp::ReportBlock block;
+  block.SetMediaSsrc(source_ssrc);
+  block.SetFractionLost(12);
+  block.SetCumulativeLost(345);
+  block.SetExtHighestSeqNum(0x10000 + source_ssrc % 100);
+  block.SetJitter(67);
+  block.SetLastSr(0x11223344);
+  block.SetDelayLastSr(0x5566);
+  return block;
+}
+
+bool VisitSingleBlock(rtc::ArrayView<const uint8_t> packet,
+                      rtcp::PacketVisitor& visitor) {
+  rtcp::CommonHeader header;
+  RTC_CHECK(header.Parse(packet.data(), packet.size()));
+  RTC_CHECK_EQ(header.packet_size(), packet.size());
+  return rtcp::VisitBlock(header, visitor);
+}
+
+TEST(RtcpPacketVisitorTest, VisitsSenderReportAndItsReportBlocks) {
+  rtcp::SenderReport sr;
+  sr.SetSenderSsrc(kSenderSsrc);
+  sr.SetNtp(NtpTime(0x11111111, 0x22222222));
+  sr.SetRtpTimestamp(0x33333333);
+  sr.SetPacketCount(0x44444444);
+  sr.SetOctetCount(0x55555555);
+  sr.AddReportBlock(CreateReportBlock(1));
+  sr.AddReportBlock(CreateReportBlock(2));
+  rtc::Buffer packet = sr.Build();
+
+  MockPacketVisitor visitor;
+  InSequence s;
+  EXPECT_CALL(visitor, OnSenderReport)
+      .WillOnce(Invoke([](const rtcp::SenderInfo& info) {
+        EXPECT_EQ(info.sender_ssrc, kSenderSsrc);
+        EXPECT_EQ(info.ntp, NtpTime(0x11111111, 0x22222222));
+        EXPECT_EQ(info.rtp_timestamp, 0x33333333u);
+        EXPECT_EQ(info.sender_packet_count, 0x44444444u);
+        EXPECT_EQ(info.sender_octet_count, 0x55555555u);
+      }));
+  EXPECT_CALL(visitor, OnReportBlock(kSenderSsrc, _))
+      .WillOnce(Invoke([](uint32_t, const rtcp::ReportBlock& block) {
+        EXPECT_EQ(block.source_ssrc(), 1u);
+        EXPECT_EQ(block.fraction_lost(), 12);
+        EXPECT_EQ(block.cumulative_lost(), 345);
+        EXPECT_EQ(block.jitter(), 67u);
+        EXPECT_EQ(block.last_sr(), 0x11223344u);
+        EXPECT_EQ(block.delay_since_last_sr(), 0x5566u);
+      }));
+  EXPECT_CALL(visitor, OnReportBlock(
+                           kSenderSsrc,
+                           Property(&rtcp::ReportBlock::source_ssrc, 2u)));
+
+  EXPECT_TRUE(VisitSingleBlock(packet, visitor));
+}
+
+TEST(RtcpPacketVisitorTest, VisitsReceiverReportAndItsReportBlocks) {
+  rtcp::ReceiverReport rr;
+  rr.SetSenderSsrc(kSenderSsrc);
+  rr.AddReportBlock(CreateReportBlock(kMediaSsrc));
+  rtc::Buffer packet = rr.Build();
+
+  MockPacketVisitor visitor;
+  InSequence s;
+  EXPECT_CALL(visitor, OnReceiverReport(kSenderSsrc));
+  EXPECT_CALL(visitor,
+              OnReportBlock(kSenderSsrc,
+                            Property(&rtcp::ReportBlock::source_ssrc,
+                                     kMediaSsrc)));
+
+  EXPECT_TRUE(VisitSingleBlock(packet, visitor));
+}
+
+TEST(RtcpPacketVisitorTest, RejectsReceiverReportWithMissingReportBlock) {
+  rtcp::ReceiverReport rr;
+  rr.SetSenderSsrc(kSenderSsrc);
+  rr.AddReportBlock(CreateReportBlock(kMediaSsrc));
+  rtc::Buffer packet = rr.Build();
+  // Claim two report blocks while there is space for one only.
+  packet[0] = (packet[0] & 0xe0) | 2;
+
+  MockPacketVisitor visitor;
+  EXPECT_CALL(visitor, OnReceiverReport).Times(0);
+  EXPECT_CALL(visitor, OnReportBlock).Times(0);
+
+  EXPECT_FALSE(VisitSingleBlock(packet, visitor));
+}
+
+TEST(RtcpPacketVisitorTest, ExpandsNackItemsLikeNackParser) {
+  const std::vector<uint16_t> kPacketIds = {1,     2,     3,     5,     17,
+                                            18,    40,    0xfffe, 0xffff,
+                                            0,     3,     100};
+  rtcp::Nack nack;
+  nack.SetSenderSsrc(kSenderSsrc);
+  nack.SetMediaSsrc(kMediaSsrc);
+  nack.SetPacketIds(kPacketIds);
+  rtc::Buffer packet = nack.Build();
+
+  MockPacketVisitor visitor;
+  EXPECT_CALL(visitor, OnNack(kSenderSsrc, kMediaSsrc, _))
+      .WillOnce(Invoke([&](uint32_t, uint32_t,
+                           const rtcp::NackPacketIds& packet_ids) {
+        EXPECT_FALSE(packet_ids.empty());
+        std::vector<uint16_t> unpacked(packet_ids.begin(), packet_ids.end());
+        EXPECT_THAT(unpacked, ElementsAreArray(kPacketIds));
+      }));
+
+  EXPECT_TRUE(VisitSingleBlock(packet, visitor));
+}
+
+TEST(RtcpPacketVisitorTest, RejectsNackWithoutItems) {
+  // Generic NACK with common feedback only.
+  const uint8_t kPacket[] = {0x81, 205,  0x00, 0x02, 0x12, 0x34,
+                             0x56, 0x78, 0x23, 0x45, 0x67, 0x89};
+  MockPacketVisitor visitor;
+  EXPECT_CALL(visitor, OnNack).Times(0);
+
+  EXPECT_FALSE(VisitSingleBlock(kPacket, visitor));
+}
+
+TEST(RtcpPacketVisitorTest, VisitsPli) {
+  rtcp::Pli pli;
+  pli.SetSenderSsrc(kSenderSsrc);
+  pli.SetMediaSsrc(kMediaSsrc);
+
+  MockPacketVisitor visitor;
+  EXPECT_CALL(visitor, OnPli(kSenderSsrc, kMediaSsrc));
+
+  EXPECT_TRUE(VisitSingleBlock(pli.Build(), visitor));
+}
+
+TEST(RtcpPacketVisitorTest, VisitsRemb) {
+  rtcp::Remb remb;
+  remb.SetSenderSsrc(kSenderSsrc);
+  remb.SetBitrateBps(int64_t{0x3fb93} << 30);
+  remb.SetSsrcs({kMediaSsrc, kMediaSsrc + 1});
+
+  MockPacketVisitor visitor;
+  EXPECT_CALL(visitor, OnRemb(kSenderSsrc, int64_t{0x3fb93} << 30, _))
+      .WillOnce(Invoke([](uint32_t, int64_t, const rtcp::SsrcList& ssrcs) {
+        EXPECT_EQ(ssrcs.size(), 2u);
+        std::vector<uint32_t> unpacked(ssrcs.begin(), ssrcs.end());
+        EXPECT_THAT(unpacked, ElementsAre(kMediaSsrc, kMediaSsrc + 1));
+      }));
+
+  EXPECT_TRUE(VisitSingleBlock(remb.Build(), visitor));
+}
+
+TEST(RtcpPacketVisitorTest, PassesOtherApplicationLayerFeedbackAsOtherBlock) {
+  rtcp::LossNotification loss_notification;
+  loss_notification.SetSenderSsrc(kSenderSsrc);
+  loss_notification.SetMediaSsrc(kMediaSsrc);
+  ASSERT_TRUE(loss_notification.Set(/*last_decoded=*/1, /*last_received=*/3,
+                                    /*decodability_flag=*/true));
+
+  MockPacketVisitor visitor;
+  EXPECT_CALL(visitor, OnRemb).Times(0);
+  EXPECT_CALL(visitor, OnOtherBlock);
+
+  EXPECT_TRUE(VisitSingleBlock(loss_notification.Build(), visitor));
+}
+
+TEST(RtcpPacketVisitorTest, VisitsTransportFeedbackHeader) {
+  rtcp::TransportFeedback feedback;
+  feedback.SetSenderSsrc(kSenderSsrc);
+  feedback.SetMediaSsrc(kMediaSsrc);
+  feedback.SetFeedbackSequenceNumber(7);
+  feedback.SetBase(/*base_sequence=*/1000, Timestamp::Millis(64 * 5));
+  feedback.AddReceivedPacket(1000, Timestamp::Millis(64 * 5));
+  feedback.AddReceivedPacket(1003, Timestamp::Millis(64 * 5 + 10));
+  rtc::Buffer packet = feedback.Build();
+
+  MockPacketVisitor visitor;
+  EXPECT_CALL(visitor, OnTransportFeedback)
+      .WillOnce(Invoke([](const rtcp::TransportFeedbackHeader& header,
+                          const rtcp::CommonHeader& block) {
+        EXPECT_EQ(header.sender_ssrc, kSenderSsrc);
+        EXPECT_EQ(header.media_ssrc, kMediaSsrc);
+        EXPECT_EQ(header.base_sequence_number, 1000);
+        EXPECT_EQ(header.packet_status_count, 4);
+        EXPECT_EQ(header.reference_time, 5u);
+        EXPECT_EQ(header.feedback_packet_count, 7);
+
+        rtcp::TransportFeedback parsed;
+        EXPECT_TRUE(parsed.Parse(block));
+        EXPECT_EQ(parsed.GetReceivedPackets().size(), 2u);
+      }));
+
+  EXPECT_TRUE(VisitSingleBlock(packet, visitor));
+}
+
+TEST(RtcpPacketVisitorTest, VisitsCompoundPacketInOrder) {
+  rtcp::CompoundPacket compound;
+  auto rr = std::make_unique<rtcp::ReceiverReport>();
+  rr->SetSenderSsrc(kSenderSsrc);
+  rr->AddReportBlock(CreateReportBlock(kMediaSsrc));
+  compound.Append(std::move(rr));
+  auto bye = std::make_unique<rtcp::Bye>();
+  bye->SetSenderSsrc(kSenderSsrc);
+  compound.Append(std::move(bye));
+  auto pli = std::make_unique<rtcp::Pli>();
+  pli->SetSenderSsrc(kSenderSsrc);
+  pli->SetMediaSsrc(kMediaSsrc);
+  compound.Append(std::move(pli));
+  rtc::Buffer packet = compound.Build();
+
+  MockPacketVisitor visitor;
+  InSequence s;
+  EXPECT_CALL(visitor, OnReceiverReport(kSenderSsrc));
+  EXPECT_CALL(visitor, OnReportBlock);
+  EXPECT_CALL(visitor,
+              OnOtherBlock(Property(&rtcp::CommonHeader::type,
+                                    rtcp::Bye::kPacketType)));
+  EXPECT_CALL(visitor, OnPli(kSenderSsrc, kMediaSsrc));
+
+  EXPECT_TRUE(rtcp::VisitCompoundPacket(packet, visitor));
+}
+
+TEST(RtcpPacketVisitorTest, StopsCompoundPacketAtMalformedBlock) {
+  // Receiver report claiming one report block without room for it, followed
+  // by a valid PLI.
+  const uint8_t kPacket[] = {0x81, 201,  0x00, 0x01, 0x12, 0x34, 0x56, 0x78,
+                             0x81, 206,  0x00, 0x02, 0x12, 0x34, 0x56, 0x78,
+                             0x23, 0x45, 0x67, 0x89};
+  MockPacketVisitor visitor;
+  EXPECT_CALL(visitor, OnReceiverReport).Times(0);
+  EXPECT_CALL(visitor, OnPli).Times(0);
+
+  EXPECT_FALSE(rtcp::VisitCompoundPacket(kPacket, visitor));
+}
+
+}  // namespace
+}  // namespace webrtc
@@ -10,6 +10,7 @@
 
 #include "modules/rtp_rtcp/source/rtcp_packet/receiver_report.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "modules/rtp_rtcp/source/byte_io.h"
@@ -89,6 +90,48 @@ bool ReceiverReport::Create(uint8_t* packet,
   return true;
 }
 
+bool ReceiverReport::CreateReceiverReports(
+    uint32_t sender_ssrc,
+    rtc::ArrayView<const ReportBlock> report_blocks,
+    uint8_t* packet,
+    size_t* index,
+    size_t max_length,
+    PacketReadyCallback callback) {
+  constexpr size_t kMinLength = kHeaderLength + kRrBaseLength;
+  while (true) {
+    size_t num_blocks = 0;
+    bool fits = *index + kMinLength <= max_length;
+    if (fits) {
+      num_blocks = std::min({report_blocks.size(), kMaxNumberOfReportBlocks,
+                             (max_length - *index - kMinLength) /
+                                 ReportBlock::kLength});
+      fits = num_blocks > 0 || report_blocks.empty();
+    }
+    if (!fits) {
+      // Not enough space left for the next report block.
+      if (*index == 0)
+        return false;
+      RTC_DCHECK(callback) << "Fragmentation not supported.";
+      callback(rtc::ArrayView<const uint8_t>(packet, *index));
+      *index = 0;
+      continue;
+    }
+    // Length in 32-bit words without common header.
+    const size_t length_in_words =
+        (kRrBaseLength + num_blocks * ReportBlock::kLength) / 4;
+    CreateHeader(num_blocks, kPacketType, length_in_words, packet, index);
+    ByteWriter<uint32_t>::WriteBigEndian(packet + *index, sender_ssrc);
+    *index += kRrBaseLength;
+    for (const ReportBlock& block : report_blocks.subview(0, num_blocks)) {
+      block.Create(packet + *index);
+      *index += ReportBlock::kLength;
+    }
+    report_blocks = report_blocks.subview(num_blocks);
+    if (report_blocks.empty())
+      return true;
+  }
+}
+
 bool ReceiverReport::AddReportBlock(const ReportBlock& block) {
   if (report_blocks_.size() >= kMaxNumberOfReportBlocks) {
     RTC_LOG(LS_WARNING) << "Max report blocks reached.";
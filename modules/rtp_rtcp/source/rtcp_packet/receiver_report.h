@@ -16,6 +16,7 @@
 
 #include <vector>
 
+#include "api/array_view.h"
 #include "modules/rtp_rtcp/source/rtcp_packet.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/report_block.h"
 
@@ -49,6 +50,22 @@ class ReceiverReport : public RtcpPacket {
               size_t max_length,
               PacketReadyCallback callback) const override;
 
+  // Writes `report_blocks` as a sequence of receiver reports from
+  // `sender_ssrc` directly into `packet`, without building intermediate
+  // ReceiverReport objects. Each receiver report carries as many report blocks
+  // as fit into the remaining `max_length` bytes, up to
+  // kMaxNumberOfReportBlocks. When not even one more report block fits, the
+  // pending packet is passed to `callback` and writing continues from the
+  // start of the buffer. Writes a single receiver report without report blocks
+  // when `report_blocks` is empty.
+  static bool CreateReceiverReports(
+      uint32_t sender_ssrc,
+      rtc::ArrayView<const ReportBlock> report_blocks,
+      uint8_t* packet,
+      size_t* index,
+      size_t max_length,
+      PacketReadyCallback callback);
+
  private:
   static const size_t kRrBaseLength = 4;
 
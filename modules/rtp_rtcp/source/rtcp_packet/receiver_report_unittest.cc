@@ -11,13 +11,18 @@
 #include "modules/rtp_rtcp/source/rtcp_packet/receiver_report.h"
 
 #include <utility>
+#include <vector>
 
+#include "modules/rtp_rtcp/source/rtcp_packet/common_header.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
 #include "test/rtcp_packet_parser.h"
 
+using ::testing::Each;
 using ::testing::ElementsAreArray;
 using ::testing::IsEmpty;
+using ::testing::Le;
+using ::testing::SizeIs;
 using ::testing::make_tuple;
 using webrtc::rtcp::ReceiverReport;
 using webrtc::rtcp::ReportBlock;
@@ -32,6 +37,7 @@ const uint32_t kExtHighestSeqNum = 0x22232425;
 const uint32_t kJitter = 0x33343536;
 const uint32_t kLastSr = 0x44454647;
 const uint32_t kDelayLastSr = 0x55565758;
+constexpr size_t kMaxPacketSize = 1500;
 // Manually created ReceiverReport with one ReportBlock matching constants
 // above.
 // Having this block allows to test Create and Parse separately.
@@ -39,6 +45,29 @@ const uint8_t kPacket[] = {0x81, 201,  0x00, 0x07, 0x12, 0x34, 0x56, 0x78,
                            0x23, 0x45, 0x67, 0x89, 55,   0x11, 0x12, 0x13,
                            0x22, 0x23, 0x24, 0x25, 0x33, 0x34, 0x35, 0x36,
                            0x44, 0x45, 0x46, 0x47, 0x55, 0x56, 0x57, 0x58};
+
+// Parses all receiver reports in the compound `packet`.
+std::vector<ReceiverReport> ParseReceiverReports(
+    rtc::ArrayView<const uint8_t> packet) {
+  std::vector<ReceiverReport> result;
+  rtcp::CommonHeader header;
+  for (const uint8_t* next = packet.data(); next != packet.data() + packet.size();
+       next = header.NextPacket()) {
+    EXPECT_TRUE(header.Parse(next, packet.data() + packet.size() - next));
+    EXPECT_EQ(header.type(), ReceiverReport::kPacketType);
+    EXPECT_TRUE(result.emplace_back().Parse(header));
+  }
+  return result;
+}
+
+std::vector<ReportBlock> CreateReportBlocks(size_t num_blocks) {
+  std::vector<ReportBlock> blocks(num_blocks);
+  for (size_t i = 0; i < num_blocks; ++i) {
+    blocks[i].SetMediaSsrc(kRemoteSsrc + i);
+    blocks[i].SetJitter(kJitter + i);
+  }
+  return blocks;
+}
 }  // namespace
 
 TEST(RtcpPacketReceiverReportTest, ParseWithOneReportBlock) {
@@ -158,4 +187,86 @@ TEST(RtcpPacketReceiverReportTest, SetReportBlocksMaxLimit) {
   EXPECT_FALSE(rr.SetReportBlocks(std::move(one_too_many_blocks)));
 }
 
+TEST(RtcpPacketReceiverReportTest, CreateReceiverReportsWithoutReportBlocks) {
+  uint8_t buffer[kMaxPacketSize];
+  size_t index = 0;
+  EXPECT_TRUE(ReceiverReport::CreateReceiverReports(
+      kSenderSsrc, {}, buffer, &index, kMaxPacketSize, nullptr));
+
+  std::vector<ReceiverReport> parsed =
+      ParseReceiverReports(rtc::MakeArrayView(buffer, index));
+  ASSERT_THAT(parsed, SizeIs(1));
+  EXPECT_EQ(parsed[0].sender_ssrc(), kSenderSsrc);
+  EXPECT_THAT(parsed[0].report_blocks(), IsEmpty());
+}
+
+TEST(RtcpPacketReceiverReportTest,
+     CreateReceiverReportsSplitsReportBlocksOverSeveralReports) {
+  // Large enough for all report blocks to fit into a single packet.
+  constexpr size_t kBufferSize = 2000;
+  const std::vector<ReportBlock> blocks = CreateReportBlocks(70);
+  uint8_t buffer[kBufferSize];
+  size_t index = 0;
+  EXPECT_TRUE(ReceiverReport::CreateReceiverReports(
+      kSenderSsrc, blocks, buffer, &index, kBufferSize, nullptr));
+
+  std::vector<ReceiverReport> parsed =
+      ParseReceiverReports(rtc::MakeArrayView(buffer, index));
+  ASSERT_THAT(parsed, SizeIs(3));
+  EXPECT_THAT(parsed[0].report_blocks(), SizeIs(31));
+  EXPECT_THAT(parsed[1].report_blocks(), SizeIs(31));
+  EXPECT_THAT(parsed[2].report_blocks(), SizeIs(8));
+  size_t i = 0;
+  for (const ReceiverReport& rr : parsed) {
+    EXPECT_EQ(rr.sender_ssrc(), kSenderSsrc);
+    for (const ReportBlock& block : rr.report_blocks()) {
+      EXPECT_EQ(block.source_ssrc(), blocks[i].source_ssrc());
+      EXPECT_EQ(block.jitter(), blocks[i].jitter());
+      ++i;
+    }
+  }
+  EXPECT_EQ(i, blocks.size());
+}
+
+TEST(RtcpPacketReceiverReportTest,
+     CreateReceiverReportsFragmentsReportBlocksOverSeveralPackets) {
+  constexpr size_t kMaxLength = 200;
+  const std::vector<ReportBlock> blocks = CreateReportBlocks(50);
+  std::vector<size_t> packet_sizes;
+  std::vector<ReportBlock> parsed_blocks;
+  auto on_packet = [&](rtc::ArrayView<const uint8_t> packet) {
+    packet_sizes.push_back(packet.size());
+    for (const ReceiverReport& rr : ParseReceiverReports(packet)) {
+      parsed_blocks.insert(parsed_blocks.end(), rr.report_blocks().begin(),
+                           rr.report_blocks().end());
+    }
+  };
+  uint8_t buffer[kMaxLength];
+  size_t index = 0;
+  // Start with a partially filled buffer.
+  ReceiverReport rr;
+  rr.SetSenderSsrc(kSenderSsrc);
+  ASSERT_TRUE(rr.Create(buffer, &index, kMaxLength, nullptr));
+  EXPECT_TRUE(ReceiverReport::CreateReceiverReports(
+      kSenderSsrc, blocks, buffer, &index, kMaxLength, on_packet));
+  on_packet(rtc::MakeArrayView(buffer, index));
+
+  EXPECT_THAT(packet_sizes, SizeIs(7));
+  EXPECT_THAT(packet_sizes, Each(Le(kMaxLength)));
+  ASSERT_THAT(parsed_blocks, SizeIs(blocks.size()));
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    EXPECT_EQ(parsed_blocks[i].source_ssrc(), blocks[i].source_ssrc());
+  }
+}
+
+TEST(RtcpPacketReceiverReportTest,
+     CreateReceiverReportsFailsWhenReportBlockNeverFits) {
+  constexpr size_t kMaxLength = 16;
+  const std::vector<ReportBlock> blocks = CreateReportBlocks(1);
+  uint8_t buffer[kMaxLength];
+  size_t index = 0;
+  EXPECT_FALSE(ReceiverReport::CreateReceiverReports(
+      kSenderSsrc, blocks, buffer, &index, kMaxLength, nullptr));
+}
+
 }  // namespace webrtc
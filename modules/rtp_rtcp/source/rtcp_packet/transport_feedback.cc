@@ -12,7 +12,6 @@
 
 #include <algorithm>
 #include <cstdint>
-#include <numeric>
 #include <utility>
 
 #include "absl/algorithm/container.h"
@@ -45,6 +44,12 @@ constexpr size_t kMinPayloadSizeBytes = 8 + 8 + 2;
 constexpr TimeDelta kBaseTimeTick = TransportFeedback::kDeltaTick * (1 << 8);
 constexpr TimeDelta kTimeWrapPeriod = kBaseTimeTick * (1 << 24);
 
+// Reads a receive delta, in ticks, encoded with `delta_size` bytes.
+int16_t ReadDelta(const uint8_t* data, uint8_t delta_size) {
+  RTC_DCHECK(delta_size == 1 || delta_size == 2);
+  return delta_size == 1 ? data[0] : ByteReader<int16_t>::ReadBigEndian(data);
+}
+
 //    Message format
 //
 //     0                   1                   2                   3
@@ -163,17 +168,42 @@ uint16_t TransportFeedback::LastChunk::EncodeLast() const {
   return EncodeOneBit();
 }
 
-// Appends content of the Lastchunk to `deltas`.
-void TransportFeedback::LastChunk::AppendTo(
-    std::vector<DeltaSize>* deltas) const {
+template <typename Handler>
+void TransportFeedback::LastChunk::ForEachDeltaSize(Handler handler) const {
   if (all_same_) {
-    deltas->insert(deltas->end(), size_, delta_sizes_[0]);
+    for (size_t i = 0; i < size_; ++i)
+      handler(delta_sizes_[0]);
   } else {
-    deltas->insert(deltas->end(), delta_sizes_.begin(),
-                   delta_sizes_.begin() + size_);
+    for (size_t i = 0; i < size_; ++i)
+      handler(delta_sizes_[i]);
   }
 }
 
+template <typename Handler>
+size_t TransportFeedback::LastChunk::ForEachDeltaSize(uint16_t chunk,
+                                                      size_t max_size,
+                                                      Handler handler) {
+  size_t size;
+  if ((chunk & 0x8000) == 0) {
+    // Run length, see DecodeRunLength().
+    size = std::min<size_t>(chunk & 0x1fff, max_size);
+    DeltaSize delta_size = (chunk >> 13) & 0x03;
+    for (size_t i = 0; i < size; ++i)
+      handler(delta_size);
+  } else if ((chunk & 0x4000) == 0) {
+    // One bit status vector, see DecodeOneBit().
+    size = std::min(kMaxOneBitCapacity, max_size);
+    for (size_t i = 0; i < size; ++i)
+      handler((chunk >> (kMaxOneBitCapacity - 1 - i)) & 0x01);
+  } else {
+    // Two bit status vector, see DecodeTwoBit().
+    size = std::min(kMaxTwoBitCapacity, max_size);
+    for (size_t i = 0; i < size; ++i)
+      handler((chunk >> 2 * (kMaxTwoBitCapacity - 1 - i)) & 0x03);
+  }
+  return size;
+}
+
 void TransportFeedback::LastChunk::Decode(uint16_t chunk, size_t max_size) {
   if ((chunk & 0x8000) == 0) {
     DecodeRunLength(chunk, max_size);
@@ -293,8 +323,7 @@ TransportFeedback::TransportFeedback(TransportFeedback&& other)
       feedback_seq_(other.feedback_seq_),
       include_timestamps_(other.include_timestamps_),
       last_timestamp_(other.last_timestamp_),
-      received_packets_(std::move(other.received_packets_)),
-      all_packets_(std::move(other.all_packets_)),
+      encoded_deltas_(std::move(other.encoded_deltas_)),
       encoded_chunks_(std::move(other.encoded_chunks_)),
       last_chunk_(other.last_chunk_),
       size_bytes_(other.size_bytes_) {
@@ -359,35 +388,70 @@ bool TransportFeedback::AddReceivedPacket(uint16_t sequence_number,
   if (!AddDeltaSize(delta_size))
     return false;
 
-  received_packets_.emplace_back(sequence_number, delta);
   last_timestamp_ += delta * kDeltaTick;
   if (include_timestamps_) {
+    if (delta_size == 1) {
+      encoded_deltas_.push_back(static_cast<uint8_t>(delta));
+    } else {
+      encoded_deltas_.push_back(static_cast<uint16_t>(delta) >> 8);
+      encoded_deltas_.push_back(static_cast<uint8_t>(delta));
+    }
     size_bytes_ += delta_size;
   }
   return true;
 }
 
-const std::vector<TransportFeedback::ReceivedPacket>&
+template <typename Handler>
+void TransportFeedback::ForAllDeltaSizes(Handler handler) const {
+  for (uint16_t chunk : encoded_chunks_) {
+    // All but the last chunk are complete, so there is no need to limit the
+    // number of decoded delta sizes.
+    LastChunk::ForEachDeltaSize(chunk, kMaxReportedPackets, handler);
+  }
+  last_chunk_.ForEachDeltaSize(handler);
+}
+
+template <typename Handler>
+void TransportFeedback::ForAllStatuses(Handler handler) const {
+  uint16_t seq_no = base_seq_no_;
+  const uint8_t* next_delta = encoded_deltas_.data();
+  ForAllDeltaSizes([&](DeltaSize delta_size) {
+    if (delta_size == 0) {
+      handler(seq_no++, /*received=*/false, int16_t{0});
+      return;
+    }
+    int16_t delta_ticks = 0;
+    if (include_timestamps_) {
+      delta_ticks = ReadDelta(next_delta, delta_size);
+      next_delta += delta_size;
+    }
+    handler(seq_no++, /*received=*/true, delta_ticks);
+  });
+  RTC_DCHECK(next_delta == encoded_deltas_.data() + encoded_deltas_.size());
+}
+
+std::vector<TransportFeedback::ReceivedPacket>
 TransportFeedback::GetReceivedPackets() const {
-  return received_packets_;
+  std::vector<ReceivedPacket> received_packets;
+  ForAllStatuses([&](uint16_t seq_no, bool received, int16_t delta_ticks) {
+    if (received) {
+      received_packets.emplace_back(seq_no, delta_ticks);
+    }
+  });
+  return received_packets;
 }
 
 void TransportFeedback::ForAllPackets(
     rtc::FunctionView<void(uint16_t, TimeDelta)> handler) const {
   TimeDelta delta_since_base = TimeDelta::Zero();
-  auto received_it = received_packets_.begin();
-  const uint16_t last_seq_num = base_seq_no_ + num_seq_no_;
-  for (uint16_t seq_num = base_seq_no_; seq_num != last_seq_num; ++seq_num) {
-    if (received_it != received_packets_.end() &&
-        received_it->sequence_number() == seq_num) {
-      delta_since_base += received_it->delta();
-      handler(seq_num, delta_since_base);
-      ++received_it;
+  ForAllStatuses([&](uint16_t seq_no, bool received, int16_t delta_ticks) {
+    if (received) {
+      delta_since_base += delta_ticks * kDeltaTick;
+      handler(seq_no, delta_since_base);
     } else {
-      handler(seq_num, TimeDelta::PlusInfinity());
+      handler(seq_no, TimeDelta::PlusInfinity());
     }
-  }
-  RTC_DCHECK(received_it == received_packets_.end());
+  });
 }
 
 uint16_t TransportFeedback::GetBaseSequence() const {
@@ -443,9 +507,12 @@ bool TransportFeedback::Parse(const CommonHeader& packet) {
     return false;
   }
 
-  std::vector<uint8_t> delta_sizes;
-  delta_sizes.reserve(status_count);
-  while (delta_sizes.size() < status_count) {
+  // Decode the packet chunks once to find out how many bytes of receive
+  // deltas they call for, without storing the individual delta sizes.
+  size_t num_decoded = 0;
+  size_t recv_delta_size = 0;
+  size_t first_invalid_delta = status_count;
+  while (num_decoded < status_count) {
     if (index + kChunkSizeBytes > end_index) {
       RTC_LOG(LS_WARNING) << "Buffer overflow while parsing packet.";
       Clear();
@@ -454,60 +521,41 @@ bool TransportFeedback::Parse(const CommonHeader& packet) {
 
     uint16_t chunk = ByteReader<uint16_t>::ReadBigEndian(&payload[index]);
     index += kChunkSizeBytes;
-    encoded_chunks_.push_back(chunk);
-    last_chunk_.Decode(chunk, status_count - delta_sizes.size());
-    last_chunk_.AppendTo(&delta_sizes);
+    size_t max_size = status_count - num_decoded;
+    LastChunk::ForEachDeltaSize(chunk, max_size, [&](DeltaSize delta_size) {
+      if (delta_size == 3 && first_invalid_delta == status_count) {
+        first_invalid_delta = num_decoded;
+      }
+      recv_delta_size += delta_size;
+      ++num_decoded;
+    });
+    if (num_decoded < status_count) {
+      encoded_chunks_.push_back(chunk);
+    } else {
+      // Last chunk is stored in the `last_chunk_`.
+      last_chunk_.Decode(chunk, max_size);
+    }
   }
-  // Last chunk is stored in the `last_chunk_`.
-  encoded_chunks_.pop_back();
-  RTC_DCHECK_EQ(delta_sizes.size(), status_count);
+  RTC_DCHECK_EQ(num_decoded, status_count);
   num_seq_no_ = status_count;
 
-  uint16_t seq_no = base_seq_no_;
-  size_t recv_delta_size = absl::c_accumulate(delta_sizes, 0);
-
   // Determine if timestamps, that is, recv_delta are included in the packet.
   if (end_index >= index + recv_delta_size) {
-    for (size_t delta_size : delta_sizes) {
-      RTC_DCHECK_LE(index + delta_size, end_index);
-      switch (delta_size) {
-        case 0:
-          break;
-        case 1: {
-          int16_t delta = payload[index];
-          received_packets_.emplace_back(seq_no, delta);
-          last_timestamp_ += delta * kDeltaTick;
-          index += delta_size;
-          break;
-        }
-        case 2: {
-          int16_t delta = ByteReader<int16_t>::ReadBigEndian(&payload[index]);
-          received_packets_.emplace_back(seq_no, delta);
-          last_timestamp_ += delta * kDeltaTick;
-          index += delta_size;
-          break;
-        }
-        case 3:
-          Clear();
-          RTC_LOG(LS_WARNING) << "Invalid delta_size for seq_no " << seq_no;
-
-          return false;
-        default:
-          RTC_DCHECK_NOTREACHED();
-          break;
-      }
-      ++seq_no;
+    if (first_invalid_delta != status_count) {
+      uint16_t seq_no = base_seq_no_ + first_invalid_delta;
+      Clear();
+      RTC_LOG(LS_WARNING) << "Invalid delta_size for seq_no " << seq_no;
+      return false;
     }
+    encoded_deltas_.assign(&payload[index], &payload[index + recv_delta_size]);
+    index += recv_delta_size;
+    ForAllStatuses([&](uint16_t, bool, int16_t delta_ticks) {
+      last_timestamp_ += delta_ticks * kDeltaTick;
+    });
   } else {
-    // The packet does not contain receive deltas.
+    // The packet does not contain receive deltas. Packet chunks alone tell
+    // which packets were received.
     include_timestamps_ = false;
-    for (size_t delta_size : delta_sizes) {
-      // Use delta sizes to detect if packet was received.
-      if (delta_size > 0) {
-        received_packets_.emplace_back(seq_no, 0);
-      }
-      ++seq_no;
-    }
   }
   size_bytes_ = RtcpPacket::kHeaderLength + index;
   RTC_DCHECK_LE(index, end_index);
@@ -530,57 +578,36 @@ std::unique_ptr<TransportFeedback> TransportFeedback::ParseFrom(
 
 bool TransportFeedback::IsConsistent() const {
   size_t packet_size = kTransportFeedbackHeaderSizeBytes;
-  std::vector<DeltaSize> delta_sizes;
-  LastChunk chunk_decoder;
-  for (uint16_t chunk : encoded_chunks_) {
-    chunk_decoder.Decode(chunk, kMaxReportedPackets);
-    chunk_decoder.AppendTo(&delta_sizes);
-    packet_size += kChunkSizeBytes;
-  }
+  packet_size += kChunkSizeBytes * encoded_chunks_.size();
   if (!last_chunk_.Empty()) {
-    last_chunk_.AppendTo(&delta_sizes);
     packet_size += kChunkSizeBytes;
   }
-  if (num_seq_no_ != delta_sizes.size()) {
-    RTC_LOG(LS_ERROR) << delta_sizes.size() << " packets encoded. Expected "
-                      << num_seq_no_;
-    return false;
-  }
+  size_t num_packets = 0;
+  size_t deltas_size = 0;
   Timestamp timestamp = BaseTime();
-  auto packet_it = received_packets_.begin();
-  uint16_t seq_no = base_seq_no_;
-  for (DeltaSize delta_size : delta_sizes) {
-    if (delta_size > 0) {
-      if (packet_it == received_packets_.end()) {
-        RTC_LOG(LS_ERROR) << "Failed to find delta for seq_no " << seq_no;
-        return false;
-      }
-      if (packet_it->sequence_number() != seq_no) {
-        RTC_LOG(LS_ERROR) << "Expected to find delta for seq_no " << seq_no
-                          << ". Next delta is for "
-                          << packet_it->sequence_number();
-        return false;
-      }
-      if (delta_size == 1 &&
-          (packet_it->delta_ticks() < 0 || packet_it->delta_ticks() > 0xff)) {
-        RTC_LOG(LS_ERROR) << "Delta " << packet_it->delta_ticks()
-                          << " for seq_no " << seq_no
-                          << " doesn't fit into one byte";
-        return false;
-      }
-      timestamp += packet_it->delta();
-      ++packet_it;
+  ForAllDeltaSizes([&](DeltaSize delta_size) {
+    ++num_packets;
+    if (!include_timestamps_ || delta_size == 0) {
+      return;
     }
-    if (include_timestamps_) {
-      packet_size += delta_size;
+    if (deltas_size + delta_size <= encoded_deltas_.size()) {
+      timestamp +=
+          ReadDelta(&encoded_deltas_[deltas_size], delta_size) * kDeltaTick;
     }
-    ++seq_no;
+    deltas_size += delta_size;
+  });
+  if (num_seq_no_ != num_packets) {
+    RTC_LOG(LS_ERROR) << num_packets << " packets encoded. Expected "
+                      << num_seq_no_;
+    return false;
   }
-  if (packet_it != received_packets_.end()) {
-    RTC_LOG(LS_ERROR) << "Unencoded delta for seq_no "
-                      << packet_it->sequence_number();
+  if (deltas_size != encoded_deltas_.size()) {
+    RTC_LOG(LS_ERROR) << "Packet chunks call for " << deltas_size
+                      << " bytes of receive deltas. Stored "
+                      << encoded_deltas_.size();
     return false;
   }
+  packet_size += deltas_size;
   if (timestamp != last_timestamp_) {
     RTC_LOG(LS_ERROR) << "Last timestamp mismatch. Calculated: "
                       << ToLogString(timestamp)
@@ -645,17 +672,9 @@ bool TransportFeedback::Create(uint8_t* packet,
     *position += 2;
   }
 
-  if (include_timestamps_) {
-    for (const auto& received_packet : received_packets_) {
-      int16_t delta = received_packet.delta_ticks();
-      if (delta >= 0 && delta <= 0xFF) {
-        packet[(*position)++] = delta;
-      } else {
-        ByteWriter<int16_t>::WriteBigEndian(&packet[*position], delta);
-        *position += 2;
-      }
-    }
-  }
+  // Receive deltas are kept in their serialized form.
+  std::copy(encoded_deltas_.begin(), encoded_deltas_.end(), &packet[*position]);
+  *position += encoded_deltas_.size();
 
   if (padding_length > 0) {
     for (size_t i = 0; i < padding_length - 1; ++i) {
@@ -670,8 +689,7 @@ bool TransportFeedback::Create(uint8_t* packet,
 void TransportFeedback::Clear() {
   num_seq_no_ = 0;
   last_timestamp_ = BaseTime();
-  received_packets_.clear();
-  all_packets_.clear();
+  encoded_deltas_.clear();
   encoded_chunks_.clear();
   last_chunk_.Clear();
   size_bytes_ = kTransportFeedbackHeaderSizeBytes;
@@ -65,7 +65,9 @@ class TransportFeedback : public Rtpfb {
   void SetFeedbackSequenceNumber(uint8_t feedback_sequence);
   // NOTE: This method requires increasing sequence numbers (excepting wraps).
   bool AddReceivedPacket(uint16_t sequence_number, Timestamp timestamp);
-  const std::vector<ReceivedPacket>& GetReceivedPackets() const;
+  // Builds the list of received packets. Prefer `ForAllPackets` which decodes
+  // the packet statuses in place.
+  std::vector<ReceivedPacket> GetReceivedPackets() const;
 
   // Calls `handler` for all packets this feedback describes.
   // For received packets pass receieve time as `delta_since_base` since the
@@ -134,8 +136,15 @@ class TransportFeedback : public Rtpfb {
 
     // Decode up to `max_size` delta sizes from `chunk`.
     void Decode(uint16_t chunk, size_t max_size);
-    // Appends content of the Lastchunk to `deltas`.
-    void AppendTo(std::vector<DeltaSize>* deltas) const;
+    // Calls `handler` for each of the stored delta sizes, in order.
+    template <typename Handler>
+    void ForEachDeltaSize(Handler handler) const;
+    // Calls `handler` for up to `max_size` delta sizes decoded from `chunk`,
+    // without storing them. Returns the number of decoded delta sizes.
+    template <typename Handler>
+    static size_t ForEachDeltaSize(uint16_t chunk,
+                                   size_t max_size,
+                                   Handler handler);
 
    private:
     static constexpr size_t kMaxOneBitCapacity = 14;
@@ -165,6 +174,16 @@ class TransportFeedback : public Rtpfb {
   // Adds `num_missing_packets` deltas of size 0.
   bool AddMissingPackets(size_t num_missing_packets);
 
+  // Calls `handler` with the delta size of every packet this feedback
+  // describes, decoding the packet chunks in order.
+  template <typename Handler>
+  void ForAllDeltaSizes(Handler handler) const;
+  // Calls `handler(sequence_number, received, delta_ticks)` for every packet
+  // this feedback describes. `delta_ticks` is 0 for missing packets and when
+  // timestamps are not included.
+  template <typename Handler>
+  void ForAllStatuses(Handler handler) const;
+
   uint16_t base_seq_no_;
   uint16_t num_seq_no_;
   uint32_t base_time_ticks_;
@@ -172,8 +191,12 @@ class TransportFeedback : public Rtpfb {
   bool include_timestamps_;
 
   Timestamp last_timestamp_;
-  std::vector<ReceivedPacket> received_packets_;
-  std::vector<ReceivedPacket> all_packets_;
+  // Receive deltas of the received packets, in the format they have in the
+  // packet: one byte for deltas in [0, 255] ticks, two bytes big endian
+  // otherwise. The delta size of each packet is given by the packet chunks,
+  // which also tell which packets were received. Empty if timestamps are not
+  // included.
+  std::vector<uint8_t> encoded_deltas_;
   // All but last encoded packet chunks.
   std::vector<uint16_t> encoded_chunks_;
   LastChunk last_chunk_;
@@ -0,0 +1,95 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+#include <vector>
+
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "benchmark/benchmark.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
+#include "rtc_base/buffer.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/system/unused.h"
+
+namespace webrtc {
+namespace {
+
+constexpr uint16_t kBaseSequenceNumber = 65'000;
+constexpr Timestamp kBaseTime = Timestamp::Seconds(10);
+
+struct ReceivedPacket {
+  uint16_t sequence_number;
+  Timestamp arrival_time;
+};
+
+// Packets received at a high packet rate, e.g. screenshare or simulcast, with
+// a lost packet every 50 and an occasional burst of delay.
+std::vector<ReceivedPacket> CreateReceivedPackets(int num_packets) {
+  std::vector<ReceivedPacket> packets;
+  Timestamp arrival_time = kBaseTime;
+  for (int i = 0; i < num_packets; ++i) {
+    if (i % 50 == 49) {
+      continue;
+    }
+    arrival_time +=
+        i % 200 == 0 ? TimeDelta::Millis(80) : TimeDelta::Micros(500);
+    packets.push_back({static_cast<uint16_t>(kBaseSequenceNumber + i),
+                       arrival_time});
+  }
+  return packets;
+}
+
+rtc::Buffer BuildFeedback(const std::vector<ReceivedPacket>& packets) {
+  rtcp::TransportFeedback feedback;
+  feedback.SetMediaSsrc(0x12345678);
+  feedback.SetBase(kBaseSequenceNumber, kBaseTime);
+  for (const ReceivedPacket& packet : packets) {
+    RTC_CHECK(feedback.AddReceivedPacket(packet.sequence_number,
+                                         packet.arrival_time));
+  }
+  return feedback.Build();
+}
+
+// Encoding, as done by the receiver of the media packets.
+void BM_TransportFeedbackBuild(benchmark::State& state) {
+  std::vector<ReceivedPacket> packets = CreateReceivedPackets(state.range(0));
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    rtc::Buffer packet = BuildFeedback(packets);
+    benchmark::DoNotOptimize(packet.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Decoding, as done by the sender of the media packets to update its estimate
+// of the network.
+void BM_TransportFeedbackParse(benchmark::State& state) {
+  rtc::Buffer packet = BuildFeedback(CreateReceivedPackets(state.range(0)));
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    std::unique_ptr<rtcp::TransportFeedback> feedback =
+        rtcp::TransportFeedback::ParseFrom(packet.data(), packet.size());
+    TimeDelta sum = TimeDelta::Zero();
+    feedback->ForAllPackets([&](uint16_t sequence_number, TimeDelta delta) {
+      if (delta.IsFinite()) {
+        sum += delta;
+      }
+    });
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_TransportFeedbackBuild)->Arg(100)->Arg(1000)->Arg(10000);
+BENCHMARK(BM_TransportFeedbackParse)->Arg(100)->Arg(1000)->Arg(10000);
+
+}  // namespace
+}  // namespace webrtc
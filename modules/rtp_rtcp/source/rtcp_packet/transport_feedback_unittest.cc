@@ -13,7 +13,9 @@
 #include <limits>
 #include <memory>
 #include <utility>
+#include <vector>
 
+#include "absl/types/optional.h"
 #include "api/array_view.h"
 #include "api/units/time_delta.h"
 #include "api/units/timestamp.h"
@@ -663,5 +665,78 @@ TEST(TransportFeedbackTest, ReportsMissingPacketsWithoutTimestamps) {
   EXPECT_CALL(handler, Call(kBaseSeqNo + 3, Ne(TimeDelta::PlusInfinity())));
   Parse(feedback_builder.Build()).ForAllPackets(handler.AsStdFunction());
 }
+
+TEST(TransportFeedbackTest, ReportsReceiveTimesAcrossAllChunkTypes) {
+  const uint16_t kBaseSeqNo = 65'500;
+  // Multiple of the base time tick, so that receive times are exact.
+  const Timestamp kBaseTimestamp = Timestamp::Millis(640);
+  TransportFeedback feedback_builder;
+  feedback_builder.SetBase(kBaseSeqNo, kBaseTimestamp);
+
+  std::vector<std::pair<uint16_t, TimeDelta>> expected;
+  auto add = [&](uint16_t seq_no, TimeDelta receive_time) {
+    ASSERT_TRUE(feedback_builder.AddReceivedPacket(
+        seq_no, kBaseTimestamp + receive_time));
+    expected.emplace_back(seq_no, receive_time);
+  };
+  // One bit vector with small deltas.
+  for (uint16_t i = 0; i < 10; ++i) {
+    add(kBaseSeqNo + i, TimeDelta::Millis(i));
+  }
+  // Large positive and negative deltas go into two bit vectors.
+  add(kBaseSeqNo + 10, TimeDelta::Millis(200));
+  add(kBaseSeqNo + 11, TimeDelta::Millis(50));
+  // Run length chunk of missing packets, wrapping the sequence number.
+  add(kBaseSeqNo + 100, TimeDelta::Millis(51));
+  // Run length chunk of small deltas.
+  for (uint16_t i = 101; i < 150; ++i) {
+    add(kBaseSeqNo + i, TimeDelta::Micros(51'000 + 250 * (i - 100)));
+  }
+
+  TransportFeedback parsed = Parse(feedback_builder.Build());
+  EXPECT_TRUE(parsed.IsConsistent());
+  for (const TransportFeedback* feedback : {&feedback_builder, &parsed}) {
+    std::vector<std::pair<uint16_t, TimeDelta>> received;
+    size_t num_missing = 0;
+    feedback->ForAllPackets([&](uint16_t seq_no, TimeDelta delta_since_base) {
+      if (delta_since_base.IsFinite()) {
+        received.emplace_back(seq_no, delta_since_base);
+      } else {
+        ++num_missing;
+      }
+    });
+    EXPECT_EQ(received, expected);
+    EXPECT_EQ(num_missing, 150u - expected.size());
+    EXPECT_THAT(feedback->GetReceivedPackets(), SizeIs(expected.size()));
+  }
+}
+
+TEST(TransportFeedbackTest, RejectsInvalidDeltaSizeWhenTimestampsAreIncluded) {
+  // Two packets reported by a run length chunk with the reserved symbol 3.
+  const uint8_t kPacketHeader[] = {0x8f, 205, 0x00, 0x06,  // Common header.
+                                   0x00, 0x00, 0x00, 0x01,  // Sender ssrc.
+                                   0x00, 0x00, 0x00, 0x02,  // Media ssrc.
+                                   0x00, 0x0a, 0x00, 0x02,  // Seq no, count.
+                                   0x00, 0x00, 0x01, 0x00,  // Time, fb count.
+                                   0x60, 0x02};             // Chunk.
+  std::vector<uint8_t> with_deltas(std::begin(kPacketHeader),
+                                   std::end(kPacketHeader));
+  with_deltas.resize(with_deltas.size() + 6);
+  EXPECT_EQ(TransportFeedback::ParseFrom(with_deltas.data(),
+                                         with_deltas.size()),
+            nullptr);
+
+  // Without room for receive deltas the packet is parsed as feedback without
+  // timestamps, where any non-zero symbol means that the packet was received.
+  std::vector<uint8_t> without_deltas(std::begin(kPacketHeader),
+                                      std::end(kPacketHeader));
+  without_deltas[3] = 0x05;
+  without_deltas.resize(without_deltas.size() + 2);
+  std::unique_ptr<TransportFeedback> parsed = TransportFeedback::ParseFrom(
+      without_deltas.data(), without_deltas.size());
+  ASSERT_NE(parsed, nullptr);
+  EXPECT_FALSE(parsed->IncludeTimestamps());
+  EXPECT_THAT(parsed->GetReceivedPackets(), SizeIs(2));
+}
 }  // namespace
 }  // namespace webrtc
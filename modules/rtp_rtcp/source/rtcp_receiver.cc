@@ -23,9 +23,11 @@
 #include "api/units/timestamp.h"
 #include "api/video/video_bitrate_allocation.h"
 #include "api/video/video_bitrate_allocator.h"
+#include "modules/rtp_rtcp/source/byte_io.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/bye.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/common_header.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/compound_packet.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/congestion_control_feedback.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/extended_reports.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/fir.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/loss_notification.h"
@@ -33,7 +35,6 @@
 #include "modules/rtp_rtcp/source/rtcp_packet/pli.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/rapid_resync_request.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/receiver_report.h"
-#include "modules/rtp_rtcp/source/rtcp_packet/remb.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/remote_estimate.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/sdes.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/sender_report.h"
@@ -132,11 +133,68 @@ struct RTCPReceiver::PacketInformation {
   absl::optional<TimeDelta> rtt;
   uint32_t receiver_estimated_max_bitrate_bps = 0;
   std::unique_ptr<rtcp::TransportFeedback> transport_feedback;
+  std::unique_ptr<rtcp::CongestionControlFeedback>
+      congestion_control_feedback;
   absl::optional<VideoBitrateAllocation> target_bitrate_allocation;
   absl::optional<NetworkStateEstimate> network_state_estimate;
   std::unique_ptr<rtcp::LossNotification> loss_notification;
 };
 
+class RTCPReceiver::BlockVisitor : public rtcp::PacketVisitor {
+ public:
+  BlockVisitor(RTCPReceiver& receiver, PacketInformation& packet_information)
+      : receiver_(receiver), packet_information_(packet_information) {}
+
+  void OnSenderReport(const rtcp::SenderInfo& sender_info) override
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(receiver_.rtcp_receiver_lock_) {
+    receiver_.HandleSenderReport(sender_info, &packet_information_);
+  }
+  void OnReceiverReport(uint32_t sender_ssrc) override
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(receiver_.rtcp_receiver_lock_) {
+    receiver_.HandleReceiverReport(sender_ssrc, &packet_information_);
+  }
+  void OnReportBlock(uint32_t sender_ssrc,
+                     const ReportBlock& report_block) override
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(receiver_.rtcp_receiver_lock_) {
+    receiver_.HandleReportBlock(report_block, &packet_information_,
+                                sender_ssrc);
+  }
+  void OnNack(uint32_t sender_ssrc,
+              uint32_t media_ssrc,
+              const rtcp::NackPacketIds& packet_ids) override
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(receiver_.rtcp_receiver_lock_) {
+    receiver_.HandleNack(media_ssrc, packet_ids, &packet_information_);
+  }
+  void OnPli(uint32_t sender_ssrc, uint32_t media_ssrc) override
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(receiver_.rtcp_receiver_lock_) {
+    receiver_.HandlePli(media_ssrc, &packet_information_);
+  }
+  void OnRemb(uint32_t sender_ssrc,
+              int64_t bitrate_bps,
+              const rtcp::SsrcList& ssrcs) override
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(receiver_.rtcp_receiver_lock_) {
+    receiver_.HandleRemb(bitrate_bps, &packet_information_);
+  }
+  void OnTransportFeedback(const rtcp::TransportFeedbackHeader& header,
+                           const CommonHeader& rtcp_block) override
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(receiver_.rtcp_receiver_lock_) {
+    receiver_.HandleTransportFeedback(header, rtcp_block,
+                                      &packet_information_);
+  }
+  void OnOtherBlock(const CommonHeader& rtcp_block) override
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(receiver_.rtcp_receiver_lock_) {
+    // Blocks of other types are handled by ParseCompoundPacket directly, so
+    // only application layer feedback that isn't REMB ends up here.
+    RTC_DCHECK_EQ(rtcp_block.type(), rtcp::Psfb::kPacketType);
+    RTC_DCHECK_EQ(rtcp_block.fmt(), rtcp::Psfb::kAfbMessageType);
+    receiver_.HandlePsfbApp(rtcp_block, &packet_information_);
+  }
+
+ private:
+  RTCPReceiver& receiver_;
+  PacketInformation& packet_information_;
+};
+
 RTCPReceiver::RTCPReceiver(const RtpRtcpInterface::Configuration& config,
                            ModuleRtpRtcpImpl2* owner)
     : clock_(config.clock),
@@ -385,6 +443,7 @@ bool RTCPReceiver::ParseCompoundPacket(rtc::ArrayView<const uint8_t> packet,
   // For each remote SSRC we store if we've received a sender report or a DLRR
   // block.
   flat_map<uint32_t, RtcpReceivedBlock> received_blocks;
+  BlockVisitor visitor(*this, *packet_information);
   bool valid = true;
   for (const uint8_t* next_block = packet.begin();
        valid && next_block != packet.end();
@@ -398,11 +457,11 @@ bool RTCPReceiver::ParseCompoundPacket(rtc::ArrayView<const uint8_t> packet,
 
     switch (rtcp_block.type()) {
       case rtcp::SenderReport::kPacketType:
-        valid = HandleSenderReport(rtcp_block, packet_information);
+        valid = rtcp::VisitBlock(rtcp_block, visitor);
         received_blocks[packet_information->remote_ssrc].sender_report = true;
         break;
       case rtcp::ReceiverReport::kPacketType:
-        valid = HandleReceiverReport(rtcp_block, packet_information);
+        valid = rtcp::VisitBlock(rtcp_block, visitor);
         break;
       case rtcp::Sdes::kPacketType:
         valid = HandleSdes(rtcp_block, packet_information);
@@ -425,7 +484,7 @@ bool RTCPReceiver::ParseCompoundPacket(rtc::ArrayView<const uint8_t> packet,
       case rtcp::Rtpfb::kPacketType:
         switch (rtcp_block.fmt()) {
           case rtcp::Nack::kFeedbackMessageType:
-            valid = HandleNack(rtcp_block, packet_information);
+            valid = rtcp::VisitBlock(rtcp_block, visitor);
             break;
           case rtcp::Tmmbr::kFeedbackMessageType:
             valid = HandleTmmbr(rtcp_block, packet_information);
@@ -437,7 +496,15 @@ bool RTCPReceiver::ParseCompoundPacket(rtc::ArrayView<const uint8_t> packet,
             valid = HandleSrReq(rtcp_block, packet_information);
             break;
           case rtcp::TransportFeedback::kFeedbackMessageType:
-            HandleTransportFeedback(rtcp_block, packet_information);
+            // Transport feedback messages are application layer feedback that
+            // doesn't have a standard format. Failing to parse one doesn't
+            // indicate an invalid RTCP.
+            if (!rtcp::VisitBlock(rtcp_block, visitor)) {
+              ++num_skipped_packets_;
+            }
+            break;
+          case rtcp::CongestionControlFeedback::kFeedbackMessageType:
+            HandleCongestionControlFeedback(rtcp_block, packet_information);
             break;
           default:
             ++num_skipped_packets_;
@@ -447,13 +514,13 @@ bool RTCPReceiver::ParseCompoundPacket(rtc::ArrayView<const uint8_t> packet,
       case rtcp::Psfb::kPacketType:
         switch (rtcp_block.fmt()) {
           case rtcp::Pli::kFeedbackMessageType:
-            valid = HandlePli(rtcp_block, packet_information);
+            valid = rtcp::VisitBlock(rtcp_block, visitor);
             break;
           case rtcp::Fir::kFeedbackMessageType:
             valid = HandleFir(rtcp_block, packet_information);
             break;
           case rtcp::Psfb::kAfbMessageType:
-            HandlePsfbApp(rtcp_block, packet_information);
+            rtcp::VisitBlock(rtcp_block, visitor);
             break;
           default:
             ++num_skipped_packets_;
@@ -500,14 +567,9 @@ bool RTCPReceiver::ParseCompoundPacket(rtc::ArrayView<const uint8_t> packet,
   return true;
 }
 
-bool RTCPReceiver::HandleSenderReport(const CommonHeader& rtcp_block,
+void RTCPReceiver::HandleSenderReport(const rtcp::SenderInfo& sender_info,
                                       PacketInformation* packet_information) {
-  rtcp::SenderReport sender_report;
-  if (!sender_report.Parse(rtcp_block)) {
-    return false;
-  }
-
-  const uint32_t remote_ssrc = sender_report.sender_ssrc();
+  const uint32_t remote_ssrc = sender_info.sender_ssrc;
 
   packet_information->remote_ssrc = remote_ssrc;
 
@@ -518,51 +580,33 @@ bool RTCPReceiver::HandleSenderReport(const CommonHeader& rtcp_block,
     // Only signal that we have received a SR when we accept one.
     packet_information->packet_type_flags |= kRtcpSr;
 
-    remote_sender_.last_remote_timestamp = sender_report.ntp();
-    remote_sender_.last_remote_rtp_timestamp = sender_report.rtp_timestamp();
+    remote_sender_.last_remote_timestamp = sender_info.ntp;
+    remote_sender_.last_remote_rtp_timestamp = sender_info.rtp_timestamp;
     remote_sender_.last_arrival_timestamp = clock_->CurrentNtpTime();
-    remote_sender_.packets_sent = sender_report.sender_packet_count();
-    remote_sender_.bytes_sent = sender_report.sender_octet_count();
+    remote_sender_.packets_sent = sender_info.sender_packet_count;
+    remote_sender_.bytes_sent = sender_info.sender_octet_count;
     remote_sender_.reports_count++;
   } else {
     // We will only store the send report from one source, but
     // we will store all the receive blocks.
     packet_information->packet_type_flags |= kRtcpRr;
   }
-
-  for (const rtcp::ReportBlock& report_block : sender_report.report_blocks()) {
-    HandleReportBlock(report_block, packet_information, remote_ssrc);
-  }
-
-  return true;
 }
 
-bool RTCPReceiver::HandleReceiverReport(const CommonHeader& rtcp_block,
+void RTCPReceiver::HandleReceiverReport(uint32_t sender_ssrc,
                                         PacketInformation* packet_information) {
-  rtcp::ReceiverReport receiver_report;
-  if (!receiver_report.Parse(rtcp_block)) {
-    return false;
-  }
-
-  const uint32_t remote_ssrc = receiver_report.sender_ssrc();
-
-  packet_information->remote_ssrc = remote_ssrc;
+  packet_information->remote_ssrc = sender_ssrc;
 
-  UpdateTmmbrRemoteIsAlive(remote_ssrc);
+  UpdateTmmbrRemoteIsAlive(sender_ssrc);
 
   packet_information->packet_type_flags |= kRtcpRr;
-
-  for (const ReportBlock& report_block : receiver_report.report_blocks()) {
-    HandleReportBlock(report_block, packet_information, remote_ssrc);
-  }
-
-  return true;
 }
 
 void RTCPReceiver::HandleReportBlock(const ReportBlock& report_block,
                                      PacketInformation* packet_information,
                                      uint32_t remote_ssrc) {
-  // This will be called once per report block in the RTCP packet.
+  // This will be called once per report block in the RTCP packet, after the
+  // sender or receiver report header was handled.
   // We filter out all report blocks that are not for us.
   // Each packet has max 31 RR blocks.
   //
@@ -717,30 +761,23 @@ bool RTCPReceiver::HandleSdes(const CommonHeader& rtcp_block,
   return true;
 }
 
-bool RTCPReceiver::HandleNack(const CommonHeader& rtcp_block,
+void RTCPReceiver::HandleNack(uint32_t media_ssrc,
+                              const rtcp::NackPacketIds& packet_ids,
                               PacketInformation* packet_information) {
-  rtcp::Nack nack;
-  if (!nack.Parse(rtcp_block)) {
-    return false;
-  }
-
-  if (receiver_only_ || local_media_ssrc() != nack.media_ssrc())  // Not to us.
-    return true;
+  if (receiver_only_ || local_media_ssrc() != media_ssrc)  // Not to us.
+    return;
 
-  packet_information->nack_sequence_numbers.insert(
-      packet_information->nack_sequence_numbers.end(),
-      nack.packet_ids().begin(), nack.packet_ids().end());
-  for (uint16_t packet_id : nack.packet_ids())
+  for (uint16_t packet_id : packet_ids) {
+    packet_information->nack_sequence_numbers.push_back(packet_id);
     nack_stats_.ReportRequest(packet_id);
+  }
 
-  if (!nack.packet_ids().empty()) {
+  if (!packet_ids.empty()) {
     packet_information->packet_type_flags |= kRtcpNack;
     ++packet_type_counter_.nack_packets;
     packet_type_counter_.nack_requests = nack_stats_.requests();
     packet_type_counter_.unique_nack_requests = nack_stats_.unique_requests();
   }
-
-  return true;
 }
 
 bool RTCPReceiver::HandleApp(const rtcp::CommonHeader& rtcp_block,
@@ -889,19 +926,13 @@ void RTCPReceiver::HandleXrTargetBitrate(
   packet_information->target_bitrate_allocation.emplace(bitrate_allocation);
 }
 
-bool RTCPReceiver::HandlePli(const CommonHeader& rtcp_block,
+void RTCPReceiver::HandlePli(uint32_t media_ssrc,
                              PacketInformation* packet_information) {
-  rtcp::Pli pli;
-  if (!pli.Parse(rtcp_block)) {
-    return false;
-  }
-
-  if (local_media_ssrc() == pli.media_ssrc()) {
+  if (local_media_ssrc() == media_ssrc) {
     ++packet_type_counter_.pli_packets;
     // Received a signal that we need to send a new key frame.
     packet_information->packet_type_flags |= kRtcpPli;
   }
-  return true;
 }
 
 bool RTCPReceiver::HandleTmmbr(const CommonHeader& rtcp_block,
@@ -962,25 +993,19 @@ bool RTCPReceiver::HandleSrReq(const CommonHeader& rtcp_block,
   return true;
 }
 
+void RTCPReceiver::HandleRemb(int64_t bitrate_bps,
+                              PacketInformation* packet_information) {
+  packet_information->packet_type_flags |= kRtcpRemb;
+  packet_information->receiver_estimated_max_bitrate_bps = bitrate_bps;
+}
+
 void RTCPReceiver::HandlePsfbApp(const CommonHeader& rtcp_block,
                                  PacketInformation* packet_information) {
-  {
-    rtcp::Remb remb;
-    if (remb.Parse(rtcp_block)) {
-      packet_information->packet_type_flags |= kRtcpRemb;
-      packet_information->receiver_estimated_max_bitrate_bps =
-          remb.bitrate_bps();
-      return;
-    }
-  }
-
-  {
-    auto loss_notification = std::make_unique<rtcp::LossNotification>();
-    if (loss_notification->Parse(rtcp_block)) {
-      packet_information->packet_type_flags |= kRtcpLossNotification;
-      packet_information->loss_notification = std::move(loss_notification);
-      return;
-    }
+  auto loss_notification = std::make_unique<rtcp::LossNotification>();
+  if (loss_notification->Parse(rtcp_block)) {
+    packet_information->packet_type_flags |= kRtcpLossNotification;
+    packet_information->loss_notification = std::move(loss_notification);
+    return;
   }
 
   RTC_LOG(LS_WARNING) << "Unknown PSFB-APP packet.";
@@ -1030,10 +1055,16 @@ bool RTCPReceiver::HandleFir(const CommonHeader& rtcp_block,
 }
 
 void RTCPReceiver::HandleTransportFeedback(
+    const rtcp::TransportFeedbackHeader& header,
     const CommonHeader& rtcp_block,
     PacketInformation* packet_information) {
-  std::unique_ptr<rtcp::TransportFeedback> transport_feedback(
-      new rtcp::TransportFeedback());
+  // Feedback about other media sources is dropped before the packet statuses
+  // are decoded.
+  if (header.media_ssrc != local_media_ssrc() &&
+      !registered_ssrcs_.contains(header.media_ssrc)) {
+    return;
+  }
+  auto transport_feedback = std::make_unique<rtcp::TransportFeedback>();
   if (!transport_feedback->Parse(rtcp_block)) {
     ++num_skipped_packets_;
     // Application layer feedback message doesn't have a standard format.
@@ -1041,12 +1072,32 @@ void RTCPReceiver::HandleTransportFeedback(
     // invalid RTCP.
     return;
   }
-  uint32_t media_source_ssrc = transport_feedback->media_ssrc();
-  if (media_source_ssrc == local_media_ssrc() ||
-      registered_ssrcs_.contains(media_source_ssrc)) {
-    packet_information->packet_type_flags |= kRtcpTransportFeedback;
-    packet_information->transport_feedback = std::move(transport_feedback);
+  packet_information->packet_type_flags |= kRtcpTransportFeedback;
+  packet_information->transport_feedback = std::move(transport_feedback);
+}
+
+void RTCPReceiver::HandleCongestionControlFeedback(
+    const CommonHeader& rtcp_block,
+    PacketInformation* packet_information) {
+  // The feedback may cover the media sources of several modules, and is
+  // handled by the module of the first one only. Its SSRC follows the SSRC of
+  // the packet sender.
+  if (rtcp_block.payload_size_bytes() < 8) {
+    ++num_skipped_packets_;
+    return;
+  }
+  const uint32_t first_media_ssrc =
+      ByteReader<uint32_t>::ReadBigEndian(rtcp_block.payload() + 4);
+  if (first_media_ssrc != local_media_ssrc() &&
+      !registered_ssrcs_.contains(first_media_ssrc)) {
+    return;
+  }
+  auto feedback = std::make_unique<rtcp::CongestionControlFeedback>();
+  if (!feedback->Parse(rtcp_block)) {
+    ++num_skipped_packets_;
+    return;
   }
+  packet_information->congestion_control_feedback = std::move(feedback);
 }
 
 void RTCPReceiver::NotifyTmmbrUpdated() {
@@ -1138,6 +1189,10 @@ void RTCPReceiver::TriggerCallbacksFromRtcpPacket(
       network_link_rtcp_observer_->OnTransportFeedback(
           now, *packet_information.transport_feedback);
     }
+    if (packet_information.congestion_control_feedback != nullptr) {
+      network_link_rtcp_observer_->OnCongestionControlFeedback(
+          now, *packet_information.congestion_control_feedback);
+    }
   }
 
   if ((packet_information.packet_type_flags & kRtcpSr) ||
@@ -26,6 +26,7 @@
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "modules/rtp_rtcp/source/rtcp_nack_stats.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/dlrr.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/packet_visitor.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/tmmb_item.h"
 #include "modules/rtp_rtcp/source/rtp_rtcp_interface.h"
 #include "rtc_base/containers/flat_map.h"
@@ -199,6 +200,9 @@ class RTCPReceiver final {
   };
 
   struct PacketInformation;
+  // Forwards the blocks decoded in place by `rtcp::VisitBlock` to the
+  // Handle* methods below.
+  class BlockVisitor;
 
   // Structure for handing TMMBR and TMMBN rtcp messages (RFC5104,
   // section 3.5.4).
@@ -270,11 +274,11 @@ class RTCPReceiver final {
   TmmbrInformation* GetTmmbrInformation(uint32_t remote_ssrc)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(rtcp_receiver_lock_);
 
-  bool HandleSenderReport(const rtcp::CommonHeader& rtcp_block,
+  void HandleSenderReport(const rtcp::SenderInfo& sender_info,
                           PacketInformation* packet_information)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(rtcp_receiver_lock_);
 
-  bool HandleReceiverReport(const rtcp::CommonHeader& rtcp_block,
+  void HandleReceiverReport(uint32_t sender_ssrc,
                             PacketInformation* packet_information)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(rtcp_receiver_lock_);
 
@@ -305,7 +309,8 @@ class RTCPReceiver final {
                              PacketInformation* packet_information)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(rtcp_receiver_lock_);
 
-  bool HandleNack(const rtcp::CommonHeader& rtcp_block,
+  void HandleNack(uint32_t media_ssrc,
+                  const rtcp::NackPacketIds& packet_ids,
                   PacketInformation* packet_information)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(rtcp_receiver_lock_);
 
@@ -316,10 +321,13 @@ class RTCPReceiver final {
   bool HandleBye(const rtcp::CommonHeader& rtcp_block)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(rtcp_receiver_lock_);
 
-  bool HandlePli(const rtcp::CommonHeader& rtcp_block,
-                 PacketInformation* packet_information)
+  void HandlePli(uint32_t media_ssrc, PacketInformation* packet_information)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(rtcp_receiver_lock_);
+
+  void HandleRemb(int64_t bitrate_bps, PacketInformation* packet_information)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(rtcp_receiver_lock_);
 
+  // Handles application layer feedback that isn't REMB.
   void HandlePsfbApp(const rtcp::CommonHeader& rtcp_block,
                      PacketInformation* packet_information)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(rtcp_receiver_lock_);
@@ -340,10 +348,15 @@ class RTCPReceiver final {
                  PacketInformation* packet_information)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(rtcp_receiver_lock_);
 
-  void HandleTransportFeedback(const rtcp::CommonHeader& rtcp_block,
+  void HandleTransportFeedback(const rtcp::TransportFeedbackHeader& header,
+                               const rtcp::CommonHeader& rtcp_block,
                                PacketInformation* packet_information)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(rtcp_receiver_lock_);
 
+  void HandleCongestionControlFeedback(const rtcp::CommonHeader& rtcp_block,
+                                       PacketInformation* packet_information)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(rtcp_receiver_lock_);
+
   bool RtcpRrTimeoutLocked(Timestamp now)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(rtcp_receiver_lock_);
 
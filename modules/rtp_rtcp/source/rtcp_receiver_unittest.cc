@@ -26,6 +26,7 @@
 #include "modules/rtp_rtcp/source/rtcp_packet/app.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/bye.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/compound_packet.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/congestion_control_feedback.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/extended_reports.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/fir.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/nack.h"
@@ -1773,6 +1774,56 @@ TEST(RtcpReceiverTest,
   receiver.IncomingPacket(packet.Build());
 }
 
+TEST(RtcpReceiverTest, NotifiesNetworkLinkObserverOnCongestionControlFeedback) {
+  ReceiverMocks mocks;
+  RtpRtcpInterface::Configuration config = DefaultConfiguration(&mocks);
+  RTCPReceiver receiver(config, &mocks.rtp_rtcp_impl);
+  receiver.SetRemoteSSRC(kSenderSsrc);
+
+  // The feedback also covers a media source of another module.
+  std::vector<rtcp::CongestionControlFeedback::PacketInfo> packets = {
+      {.ssrc = *config.rtx_send_ssrc,
+       .sequence_number = 1,
+       .arrival_time_offset = TimeDelta::Millis(10),
+       .ecn = EcnMarking::kCe},
+      {.ssrc = kNotToUsSsrc,
+       .sequence_number = 7,
+       .arrival_time_offset = TimeDelta::Millis(5)}};
+  rtcp::CongestionControlFeedback packet(std::move(packets),
+                                         /*report_timestamp_compact_ntp=*/0);
+  packet.SetSenderSsrc(kSenderSsrc);
+
+  EXPECT_CALL(mocks.network_link_rtcp_observer,
+              OnCongestionControlFeedback(
+                  mocks.clock.CurrentTime(),
+                  Property(&rtcp::CongestionControlFeedback::packets,
+                           SizeIs(2))));
+  receiver.IncomingPacket(packet.Build());
+}
+
+TEST(RtcpReceiverTest,
+     DoesNotNotifyNetworkLinkObserverOnCongestionControlFeedbackNotToUs) {
+  ReceiverMocks mocks;
+  RTCPReceiver receiver(DefaultConfiguration(&mocks), &mocks.rtp_rtcp_impl);
+  receiver.SetRemoteSSRC(kSenderSsrc);
+
+  // The feedback is handled by the module of the first media source.
+  std::vector<rtcp::CongestionControlFeedback::PacketInfo> packets = {
+      {.ssrc = kNotToUsSsrc,
+       .sequence_number = 7,
+       .arrival_time_offset = TimeDelta::Millis(5)},
+      {.ssrc = kReceiverMainSsrc,
+       .sequence_number = 1,
+       .arrival_time_offset = TimeDelta::Millis(10)}};
+  rtcp::CongestionControlFeedback packet(std::move(packets),
+                                         /*report_timestamp_compact_ntp=*/0);
+  packet.SetSenderSsrc(kSenderSsrc);
+
+  EXPECT_CALL(mocks.network_link_rtcp_observer, OnCongestionControlFeedback)
+      .Times(0);
+  receiver.IncomingPacket(packet.Build());
+}
+
 TEST(RtcpReceiverTest, NotifiesNetworkLinkObserverOnRemb) {
   ReceiverMocks mocks;
   RTCPReceiver receiver(DefaultConfiguration(&mocks), &mocks.rtp_rtcp_impl);
@@ -18,6 +18,7 @@
 
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
+#include "api/array_view.h"
 #include "api/rtc_event_log/rtc_event_log.h"
 #include "api/rtp_headers.h"
 #include "api/units/data_rate.h"
@@ -74,6 +75,16 @@ class RTCPSender::PacketSender {
     packet.Create(buffer_, &index_, max_packet_size_, callback_);
   }
 
+  // Appends receiver reports carrying `report_blocks`, serializing the report
+  // blocks straight into the pending compound packet.
+  void AppendReceiverReports(
+      uint32_t sender_ssrc,
+      rtc::ArrayView<const rtcp::ReportBlock> report_blocks) {
+    rtcp::ReceiverReport::CreateReceiverReports(
+        sender_ssrc, report_blocks, buffer_, &index_, max_packet_size_,
+        callback_);
+  }
+
   // Sends pending rtcp packet.
   void Send() {
     if (index_ > 0) {
@@ -405,11 +416,10 @@ void RTCPSender::BuildSDES(const RtcpContext& ctx, PacketSender& sender) {
 }
 
 void RTCPSender::BuildRR(const RtcpContext& ctx, PacketSender& sender) {
-  rtcp::ReceiverReport report;
-  report.SetSenderSsrc(ssrc_);
-  report.SetReportBlocks(CreateReportBlocks(ctx.feedback_state_));
-  if (method_ == RtcpMode::kCompound || !report.report_blocks().empty()) {
-    sender.AppendPacket(report);
+  std::vector<rtcp::ReportBlock> report_blocks =
+      CreateReportBlocks(ctx.feedback_state_);
+  if (method_ == RtcpMode::kCompound || !report_blocks.empty()) {
+    sender.AppendReceiverReports(ssrc_, report_blocks);
   }
 }
 
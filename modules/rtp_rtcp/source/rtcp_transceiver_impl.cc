@@ -16,6 +16,7 @@
 #include "absl/algorithm/container.h"
 #include "absl/memory/memory.h"
 #include "absl/types/optional.h"
+#include "api/array_view.h"
 #include "api/video/video_bitrate_allocation.h"
 #include "modules/rtp_rtcp/include/receive_statistics.h"
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
@@ -35,7 +36,6 @@
 #include "rtc_base/checks.h"
 #include "rtc_base/containers/flat_map.h"
 #include "rtc_base/logging.h"
-#include "rtc_base/numerics/divide_round.h"
 #include "rtc_base/task_utils/repeating_task.h"
 #include "rtc_base/time_utils.h"
 #include "system_wrappers/include/clock.h"
@@ -81,6 +81,53 @@ struct RtcpTransceiverImpl::LocalSenderState {
   RtpStreamRtcpHandler* handler = nullptr;
 };
 
+class RtcpTransceiverImpl::ReceivedBlockVisitor : public rtcp::PacketVisitor {
+ public:
+  ReceivedBlockVisitor(RtcpTransceiverImpl& impl,
+                       Timestamp now,
+                       std::vector<ReportBlockData>& report_blocks)
+      : impl_(impl), now_(now), report_blocks_(report_blocks) {}
+
+  void OnSenderReport(const rtcp::SenderInfo& sender_info) override {
+    impl_.HandleSenderReport(sender_info, now_);
+  }
+  void OnReportBlock(uint32_t sender_ssrc,
+                     const rtcp::ReportBlock& report_block) override {
+    if (!now_ntp_.has_value()) {
+      now_ntp_ = impl_.config_.clock->ConvertTimestampToNtpTime(now_);
+    }
+    impl_.HandleReportBlock(sender_ssrc, *now_ntp_, report_block,
+                            report_blocks_);
+  }
+  void OnNack(uint32_t sender_ssrc,
+              uint32_t media_ssrc,
+              const rtcp::NackPacketIds& packet_ids) override {
+    impl_.HandleNack(sender_ssrc, media_ssrc, packet_ids);
+  }
+  void OnPli(uint32_t sender_ssrc, uint32_t media_ssrc) override {
+    impl_.HandlePli(sender_ssrc, media_ssrc);
+  }
+  void OnRemb(uint32_t sender_ssrc,
+              int64_t bitrate_bps,
+              const rtcp::SsrcList& ssrcs) override {
+    impl_.HandleRemb(bitrate_bps, now_);
+  }
+  void OnTransportFeedback(const rtcp::TransportFeedbackHeader& header,
+                           const rtcp::CommonHeader& block) override {
+    impl_.HandleTransportFeedback(block, now_);
+  }
+  void OnOtherBlock(const rtcp::CommonHeader& block) override {
+    impl_.HandleOtherBlock(block, now_);
+  }
+
+ private:
+  RtcpTransceiverImpl& impl_;
+  const Timestamp now_;
+  std::vector<ReportBlockData>& report_blocks_;
+  // Converted on the first report block of the packet.
+  absl::optional<NtpTime> now_ntp_;
+};
+
 // Helper to put several RTCP packets into lower layer datagram composing
 // Compound or Reduced-Size RTCP packet, as defined by RFC 5506 section 2.
 // TODO(bugs.webrtc.org/8239): When in compound mode and packets are so many
@@ -101,6 +148,16 @@ class RtcpTransceiverImpl::PacketSender {
     packet.Create(buffer_, &index_, max_packet_size_, callback_);
   }
 
+  // Appends receiver reports from `sender_ssrc` carrying `report_blocks`,
+  // serializing the report blocks straight into the pending compound packet.
+  void AppendReceiverReports(
+      uint32_t sender_ssrc,
+      rtc::ArrayView<const rtcp::ReportBlock> report_blocks) {
+    rtcp::ReceiverReport::CreateReceiverReports(
+        sender_ssrc, report_blocks, buffer_, &index_, max_packet_size_,
+        callback_);
+  }
+
   // Sends pending rtcp compound packet.
   void Send() {
     if (index_ > 0) {
@@ -197,13 +254,15 @@ void RtcpTransceiverImpl::ReceivePacket(rtc::ArrayView<const uint8_t> packet,
                                         Timestamp now) {
   // Report blocks may be spread across multiple sender and receiver reports.
   std::vector<ReportBlockData> report_blocks;
+  ReceivedBlockVisitor visitor(*this, now, report_blocks);
 
   while (!packet.empty()) {
     rtcp::CommonHeader rtcp_block;
     if (!rtcp_block.Parse(packet.data(), packet.size()))
       break;
 
-    HandleReceivedPacket(rtcp_block, now, report_blocks);
+    // Malformed blocks are ignored, the rest of the packet is still handled.
+    rtcp::VisitBlock(rtcp_block, visitor);
 
     packet = packet.subview(rtcp_block.packet_size());
   }
@@ -283,28 +342,20 @@ void RtcpTransceiverImpl::SendFullIntraRequest(
   SendImmediateFeedback(fir);
 }
 
-void RtcpTransceiverImpl::HandleReceivedPacket(
+void RtcpTransceiverImpl::HandleOtherBlock(
     const rtcp::CommonHeader& rtcp_packet_header,
-    Timestamp now,
-    std::vector<ReportBlockData>& report_blocks) {
+    Timestamp now) {
   switch (rtcp_packet_header.type()) {
     case rtcp::Bye::kPacketType:
       HandleBye(rtcp_packet_header);
       break;
-    case rtcp::SenderReport::kPacketType:
-      HandleSenderReport(rtcp_packet_header, now, report_blocks);
-      break;
-    case rtcp::ReceiverReport::kPacketType:
-      HandleReceiverReport(rtcp_packet_header, now, report_blocks);
-      break;
     case rtcp::ExtendedReports::kPacketType:
       HandleExtendedReports(rtcp_packet_header, now);
       break;
     case rtcp::Psfb::kPacketType:
-      HandlePayloadSpecificFeedback(rtcp_packet_header, now);
-      break;
-    case rtcp::Rtpfb::kPacketType:
-      HandleRtpFeedback(rtcp_packet_header, now);
+      if (rtcp_packet_header.fmt() == rtcp::Fir::kFeedbackMessageType) {
+        HandleFir(rtcp_packet_header);
+      }
       break;
   }
 }
@@ -322,91 +373,49 @@ void RtcpTransceiverImpl::HandleBye(
 }
 
 void RtcpTransceiverImpl::HandleSenderReport(
-    const rtcp::CommonHeader& rtcp_packet_header,
-    Timestamp now,
-    std::vector<ReportBlockData>& report_blocks) {
-  rtcp::SenderReport sender_report;
-  if (!sender_report.Parse(rtcp_packet_header))
-    return;
-  RemoteSenderState& remote_sender =
-      remote_senders_[sender_report.sender_ssrc()];
-  remote_sender.last_received_sender_report = {{now, sender_report.ntp()}};
-  HandleReportBlocks(sender_report.sender_ssrc(), now,
-                     sender_report.report_blocks(), report_blocks);
+    const rtcp::SenderInfo& sender_info,
+    Timestamp now) {
+  RemoteSenderState& remote_sender = remote_senders_[sender_info.sender_ssrc];
+  remote_sender.last_received_sender_report = {{now, sender_info.ntp}};
 
   for (MediaReceiverRtcpObserver* observer : remote_sender.observers) {
-    observer->OnSenderReport(sender_report.sender_ssrc(), sender_report.ntp(),
-                             sender_report.rtp_timestamp());
+    observer->OnSenderReport(sender_info.sender_ssrc, sender_info.ntp,
+                             sender_info.rtp_timestamp);
   }
 }
 
-void RtcpTransceiverImpl::HandleReceiverReport(
-    const rtcp::CommonHeader& rtcp_packet_header,
-    Timestamp now,
-    std::vector<ReportBlockData>& report_blocks) {
-  rtcp::ReceiverReport receiver_report;
-  if (!receiver_report.Parse(rtcp_packet_header)) {
-    return;
-  }
-  HandleReportBlocks(receiver_report.sender_ssrc(), now,
-                     receiver_report.report_blocks(), report_blocks);
-}
-
-void RtcpTransceiverImpl::HandleReportBlocks(
+void RtcpTransceiverImpl::HandleReportBlock(
     uint32_t sender_ssrc,
-    Timestamp now,
-    rtc::ArrayView<const rtcp::ReportBlock> rtcp_report_blocks,
+    NtpTime now_ntp,
+    const rtcp::ReportBlock& block,
     std::vector<ReportBlockData>& report_blocks) {
-  if (rtcp_report_blocks.empty()) {
-    return;
-  }
-  NtpTime now_ntp = config_.clock->ConvertTimestampToNtpTime(now);
-  uint32_t receive_time_ntp = CompactNtp(now_ntp);
   Timestamp now_utc =
       Timestamp::Millis(now_ntp.ToMs() - rtc::kNtpJan1970Millisecs);
-
-  for (const rtcp::ReportBlock& block : rtcp_report_blocks) {
-    absl::optional<TimeDelta> rtt;
-    if (block.last_sr() != 0) {
-      rtt = CompactNtpRttToTimeDelta(
-          receive_time_ntp - block.delay_since_last_sr() - block.last_sr());
+  absl::optional<TimeDelta> rtt;
+  if (block.last_sr() != 0) {
+    rtt = CompactNtpRttToTimeDelta(CompactNtp(now_ntp) -
+                                   block.delay_since_last_sr() -
+                                   block.last_sr());
+  }
+
+  auto sender_it = local_senders_by_ssrc_.find(block.source_ssrc());
+  if (sender_it != local_senders_by_ssrc_.end()) {
+    LocalSenderState& state = *sender_it->second;
+    state.report_block.SetReportBlock(sender_ssrc, block, now_utc);
+    if (rtt.has_value()) {
+      state.report_block.AddRoundTripTimeSample(*rtt);
     }
-
-    auto sender_it = local_senders_by_ssrc_.find(block.source_ssrc());
-    if (sender_it != local_senders_by_ssrc_.end()) {
-      LocalSenderState& state = *sender_it->second;
-      state.report_block.SetReportBlock(sender_ssrc, block, now_utc);
-      if (rtt.has_value()) {
-        state.report_block.AddRoundTripTimeSample(*rtt);
-      }
-      state.handler->OnReport(state.report_block);
-      report_blocks.push_back(state.report_block);
-    } else {
-      // No registered sender for this report block, still report it to the
-      // network link.
-      ReportBlockData report_block;
-      report_block.SetReportBlock(sender_ssrc, block, now_utc);
-      if (rtt.has_value()) {
-        report_block.AddRoundTripTimeSample(*rtt);
-      }
-      report_blocks.push_back(report_block);
+    state.handler->OnReport(state.report_block);
+    report_blocks.push_back(state.report_block);
+  } else {
+    // No registered sender for this report block, still report it to the
+    // network link.
+    ReportBlockData report_block;
+    report_block.SetReportBlock(sender_ssrc, block, now_utc);
+    if (rtt.has_value()) {
+      report_block.AddRoundTripTimeSample(*rtt);
     }
-  }
-}
-
-void RtcpTransceiverImpl::HandlePayloadSpecificFeedback(
-    const rtcp::CommonHeader& rtcp_packet_header,
-    Timestamp now) {
-  switch (rtcp_packet_header.fmt()) {
-    case rtcp::Fir::kFeedbackMessageType:
-      HandleFir(rtcp_packet_header);
-      break;
-    case rtcp::Pli::kFeedbackMessageType:
-      HandlePli(rtcp_packet_header);
-      break;
-    case rtcp::Psfb::kAfbMessageType:
-      HandleRemb(rtcp_packet_header, now);
-      break;
+    report_blocks.push_back(report_block);
   }
 }
 
@@ -430,53 +439,33 @@ void RtcpTransceiverImpl::HandleFir(
   }
 }
 
-void RtcpTransceiverImpl::HandlePli(
-    const rtcp::CommonHeader& rtcp_packet_header) {
-  rtcp::Pli pli;
-  if (local_senders_.empty() || !pli.Parse(rtcp_packet_header)) {
-    return;
-  }
-  auto it = local_senders_by_ssrc_.find(pli.media_ssrc());
+void RtcpTransceiverImpl::HandlePli(uint32_t sender_ssrc,
+                                    uint32_t media_ssrc) {
+  auto it = local_senders_by_ssrc_.find(media_ssrc);
   if (it != local_senders_by_ssrc_.end()) {
-    it->second->handler->OnPli(pli.sender_ssrc());
+    it->second->handler->OnPli(sender_ssrc);
   }
 }
 
-void RtcpTransceiverImpl::HandleRemb(
-    const rtcp::CommonHeader& rtcp_packet_header,
-    Timestamp now) {
-  rtcp::Remb remb;
-  if (config_.network_link_observer == nullptr ||
-      !remb.Parse(rtcp_packet_header)) {
+void RtcpTransceiverImpl::HandleRemb(int64_t bitrate_bps, Timestamp now) {
+  if (config_.network_link_observer == nullptr) {
     return;
   }
   config_.network_link_observer->OnReceiverEstimatedMaxBitrate(
-      now, DataRate::BitsPerSec(remb.bitrate_bps()));
+      now, DataRate::BitsPerSec(bitrate_bps));
 }
 
-void RtcpTransceiverImpl::HandleRtpFeedback(
-    const rtcp::CommonHeader& rtcp_packet_header,
-    Timestamp now) {
-  switch (rtcp_packet_header.fmt()) {
-    case rtcp::Nack::kFeedbackMessageType:
-      HandleNack(rtcp_packet_header);
-      break;
-    case rtcp::TransportFeedback::kFeedbackMessageType:
-      HandleTransportFeedback(rtcp_packet_header, now);
-      break;
-  }
-}
-
-void RtcpTransceiverImpl::HandleNack(
-    const rtcp::CommonHeader& rtcp_packet_header) {
-  rtcp::Nack nack;
-  if (local_senders_.empty() || !nack.Parse(rtcp_packet_header)) {
+void RtcpTransceiverImpl::HandleNack(uint32_t sender_ssrc,
+                                     uint32_t media_ssrc,
+                                     const rtcp::NackPacketIds& packet_ids) {
+  auto it = local_senders_by_ssrc_.find(media_ssrc);
+  if (it == local_senders_by_ssrc_.end()) {
     return;
   }
-  auto it = local_senders_by_ssrc_.find(nack.media_ssrc());
-  if (it != local_senders_by_ssrc_.end()) {
-    it->second->handler->OnNack(nack.sender_ssrc(), nack.packet_ids());
-  }
+  // Sequence numbers are only unpacked for the nacks addressed to one of the
+  // local senders.
+  nack_sequence_numbers_.assign(packet_ids.begin(), packet_ids.end());
+  it->second->handler->OnNack(sender_ssrc, nack_sequence_numbers_);
 }
 
 void RtcpTransceiverImpl::HandleTransportFeedback(
@@ -700,34 +689,20 @@ std::vector<uint32_t> RtcpTransceiverImpl::FillReports(
                           std::next(last_handled_sender_it));
   }
 
-  // Calculcate number of receiver reports to attach remaining report blocks to.
-  size_t num_receiver_reports =
-      DivideRoundUp(report_blocks.end() - report_block_it,
-                    rtcp::ReceiverReport::kMaxNumberOfReportBlocks);
+  // Remaining report blocks are written directly into the outgoing buffer as
+  // a sequence of receiver reports.
+  rtc::ArrayView<const rtcp::ReportBlock> remaining_blocks =
+      rtc::ArrayView<const rtcp::ReportBlock>(report_blocks)
+          .subview(report_block_it - report_blocks.begin());
 
   // In compound mode each RTCP packet has to start with a sender or receiver
   // report.
-  if (config_.rtcp_mode == RtcpMode::kCompound && sender_ssrcs.empty() &&
-      num_receiver_reports == 0) {
-    num_receiver_reports = 1;
+  if (!remaining_blocks.empty() ||
+      (config_.rtcp_mode == RtcpMode::kCompound && sender_ssrcs.empty())) {
+    uint32_t sender_ssrc =
+        sender_ssrcs.empty() ? config_.feedback_ssrc : sender_ssrcs.front();
+    rtcp_sender.AppendReceiverReports(sender_ssrc, remaining_blocks);
   }
-
-  uint32_t sender_ssrc =
-      sender_ssrcs.empty() ? config_.feedback_ssrc : sender_ssrcs.front();
-  for (size_t i = 0; i < num_receiver_reports; ++i) {
-    rtcp::ReceiverReport receiver_report;
-    receiver_report.SetSenderSsrc(sender_ssrc);
-    size_t num_blocks =
-        std::min<size_t>(rtcp::ReceiverReport::kMaxNumberOfReportBlocks,
-                         report_blocks.end() - report_block_it);
-    std::vector<rtcp::ReportBlock> sub_blocks(report_block_it,
-                                              report_block_it + num_blocks);
-    receiver_report.SetReportBlocks(std::move(sub_blocks));
-    report_block_it += num_blocks;
-    rtcp_sender.AppendPacket(receiver_report);
-  }
-  // All report blocks should be attached at this point.
-  RTC_DCHECK_EQ(report_blocks.end() - report_block_it, 0);
   return sender_ssrcs;
 }
 
@@ -21,6 +21,7 @@
 #include "api/units/timestamp.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/common_header.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/dlrr.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/packet_visitor.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/remb.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/report_block.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/target_bitrate.h"
@@ -87,31 +88,25 @@ class RtcpTransceiverImpl {
     uint32_t local_receive_mid_ntp_time;
   };
 
-  void HandleReceivedPacket(const rtcp::CommonHeader& rtcp_packet_header,
-                            Timestamp now,
-                            std::vector<ReportBlockData>& report_blocks);
+  // Forwards the blocks decoded in place by `rtcp::VisitBlock` to the
+  // individual rtcp packet handlers.
+  class ReceivedBlockVisitor;
+
   // Individual rtcp packet handlers.
+  void HandleOtherBlock(const rtcp::CommonHeader& rtcp_packet_header,
+                        Timestamp now);
   void HandleBye(const rtcp::CommonHeader& rtcp_packet_header);
-  void HandleSenderReport(const rtcp::CommonHeader& rtcp_packet_header,
-                          Timestamp now,
-                          std::vector<ReportBlockData>& report_blocks);
-  void HandleReceiverReport(const rtcp::CommonHeader& rtcp_packet_header,
-                            Timestamp now,
-                            std::vector<ReportBlockData>& report_blocks);
-  void HandleReportBlocks(
-      uint32_t sender_ssrc,
-      Timestamp now,
-      rtc::ArrayView<const rtcp::ReportBlock> rtcp_report_blocks,
-      std::vector<ReportBlockData>& report_blocks);
-  void HandlePayloadSpecificFeedback(
-      const rtcp::CommonHeader& rtcp_packet_header,
-      Timestamp now);
-  void HandleRtpFeedback(const rtcp::CommonHeader& rtcp_packet_header,
-                         Timestamp now);
+  void HandleSenderReport(const rtcp::SenderInfo& sender_info, Timestamp now);
+  void HandleReportBlock(uint32_t sender_ssrc,
+                         NtpTime now_ntp,
+                         const rtcp::ReportBlock& rtcp_report_block,
+                         std::vector<ReportBlockData>& report_blocks);
   void HandleFir(const rtcp::CommonHeader& rtcp_packet_header);
-  void HandlePli(const rtcp::CommonHeader& rtcp_packet_header);
-  void HandleRemb(const rtcp::CommonHeader& rtcp_packet_header, Timestamp now);
-  void HandleNack(const rtcp::CommonHeader& rtcp_packet_header);
+  void HandlePli(uint32_t sender_ssrc, uint32_t media_ssrc);
+  void HandleRemb(int64_t bitrate_bps, Timestamp now);
+  void HandleNack(uint32_t sender_ssrc,
+                  uint32_t media_ssrc,
+                  const rtcp::NackPacketIds& packet_ids);
   void HandleTransportFeedback(const rtcp::CommonHeader& rtcp_packet_header,
                                Timestamp now);
   void HandleExtendedReports(const rtcp::CommonHeader& rtcp_packet_header,
@@ -162,6 +157,9 @@ class RtcpTransceiverImpl {
   flat_map<uint32_t, std::list<LocalSenderState>::iterator>
       local_senders_by_ssrc_;
   flat_map<uint32_t, RrtrTimes> received_rrtrs_;
+  // Reused to unpack the sequence numbers of received nacks without
+  // allocating for each nack.
+  std::vector<uint16_t> nack_sequence_numbers_;
   RepeatingTaskHandle periodic_task_handle_;
 };
 
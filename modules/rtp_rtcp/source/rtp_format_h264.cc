@@ -47,8 +47,10 @@ RtpPacketizerH264::RtpPacketizerH264(rtc::ArrayView<const uint8_t> payload,
   RTC_CHECK(packetization_mode == H264PacketizationMode::NonInterleaved ||
             packetization_mode == H264PacketizationMode::SingleNalUnit);
 
-  for (const auto& nalu :
-       H264::FindNaluIndices(payload.data(), payload.size())) {
+  std::vector<H264::NaluIndex> nalu_indices =
+      H264::FindNaluIndices(payload.data(), payload.size());
+  input_fragments_.reserve(nalu_indices.size());
+  for (const H264::NaluIndex& nalu : nalu_indices) {
     input_fragments_.push_back(
         payload.subview(nalu.payload_start_offset, nalu.payload_size));
   }
@@ -58,9 +60,7 @@ RtpPacketizerH264::RtpPacketizerH264(rtc::ArrayView<const uint8_t> payload,
     // packets in case the caller would ignore return value and still try to
     // call NextPacket().
     num_packets_left_ = 0;
-    while (!packets_.empty()) {
-      packets_.pop();
-    }
+    packets_.clear();
   }
 }
 
@@ -72,6 +72,9 @@ size_t RtpPacketizerH264::NumPackets() const {
 
 bool RtpPacketizerH264::GeneratePackets(
     H264PacketizationMode packetization_mode) {
+  // Most NAL units are either sent whole or aggregated, so this avoids
+  // reallocating in the common case.
+  packets_.reserve(input_fragments_.size());
   for (size_t i = 0; i < input_fragments_.size();) {
     switch (packetization_mode) {
       case H264PacketizationMode::SingleNalUnit:
@@ -138,10 +141,11 @@ bool RtpPacketizerH264::PacketizeFuA(size_t fragment_index) {
   for (size_t i = 0; i < payload_sizes.size(); ++i) {
     int packet_length = payload_sizes[i];
     RTC_CHECK_GT(packet_length, 0);
-    packets_.push(PacketUnit(fragment.subview(offset, packet_length),
-                             /*first_fragment=*/i == 0,
-                             /*last_fragment=*/i == payload_sizes.size() - 1,
-                             false, fragment[0]));
+    packets_.push_back(
+        PacketUnit(fragment.subview(offset, packet_length),
+                   /*first_fragment=*/i == 0,
+                   /*last_fragment=*/i == payload_sizes.size() - 1, false,
+                   fragment[0]));
     offset += packet_length;
     payload_left -= packet_length;
   }
@@ -176,8 +180,8 @@ size_t RtpPacketizerH264::PacketizeStapA(size_t fragment_index) {
 
   while (payload_size_left >= payload_size_needed()) {
     RTC_CHECK_GT(fragment.size(), 0);
-    packets_.push(PacketUnit(fragment, aggregated_fragments == 0, false, true,
-                             fragment[0]));
+    packets_.push_back(PacketUnit(fragment, aggregated_fragments == 0, false,
+                                  true, fragment[0]));
     payload_size_left -= fragment.size();
     payload_size_left -= fragment_headers_length;
 
@@ -219,92 +223,86 @@ bool RtpPacketizerH264::PacketizeSingleNalu(size_t fragment_index) {
     return false;
   }
   RTC_CHECK_GT(fragment.size(), 0u);
-  packets_.push(PacketUnit(fragment, true /* first */, true /* last */,
-                           false /* aggregated */, fragment[0]));
+  packets_.push_back(PacketUnit(fragment, true /* first */, true /* last */,
+                                false /* aggregated */, fragment[0]));
   ++num_packets_left_;
   return true;
 }
 
 bool RtpPacketizerH264::NextPacket(RtpPacketToSend* rtp_packet) {
   RTC_DCHECK(rtp_packet);
-  if (packets_.empty()) {
+  if (next_packet_unit_ == packets_.size()) {
     return false;
   }
 
-  PacketUnit packet = packets_.front();
+  const PacketUnit& packet = packets_[next_packet_unit_];
   if (packet.first_fragment && packet.last_fragment) {
     // Single NAL unit packet.
     size_t bytes_to_send = packet.source_fragment.size();
     uint8_t* buffer = rtp_packet->AllocatePayload(bytes_to_send);
     memcpy(buffer, packet.source_fragment.data(), bytes_to_send);
-    packets_.pop();
-    input_fragments_.pop_front();
+    ++next_packet_unit_;
   } else if (packet.aggregated) {
     NextAggregatePacket(rtp_packet);
   } else {
     NextFragmentPacket(rtp_packet);
   }
-  rtp_packet->SetMarker(packets_.empty());
+  rtp_packet->SetMarker(next_packet_unit_ == packets_.size());
   --num_packets_left_;
   return true;
 }
 
 void RtpPacketizerH264::NextAggregatePacket(RtpPacketToSend* rtp_packet) {
-  // Reserve maximum available payload, set actual payload size later.
-  size_t payload_capacity = rtp_packet->FreeCapacity();
-  RTC_CHECK_GE(payload_capacity, kNalHeaderSize);
-  uint8_t* buffer = rtp_packet->AllocatePayload(payload_capacity);
-  RTC_DCHECK(buffer);
-  PacketUnit* packet = &packets_.front();
-  RTC_CHECK(packet->first_fragment);
+  RTC_CHECK(packets_[next_packet_unit_].first_fragment);
+  // Find the units of this packet first, so that the payload can be allocated
+  // with its exact size and each NAL unit copied without further checks.
+  size_t end = next_packet_unit_;
+  size_t payload_size = kNalHeaderSize;
+  do {
+    RTC_CHECK(packets_[end].aggregated);
+    payload_size += kLengthFieldSize + packets_[end].source_fragment.size();
+  } while (!packets_[end++].last_fragment);
+
+  uint8_t* buffer = rtp_packet->AllocatePayload(payload_size);
+  RTC_CHECK(buffer);
   // STAP-A NALU header.
-  buffer[0] =
-      (packet->header & (kH264FBit | kH264NriMask)) | H264::NaluType::kStapA;
+  uint8_t header = packets_[next_packet_unit_].header;
+  buffer[0] = (header & (kH264FBit | kH264NriMask)) | H264::NaluType::kStapA;
   size_t index = kNalHeaderSize;
-  bool is_last_fragment = packet->last_fragment;
-  while (packet->aggregated) {
-    rtc::ArrayView<const uint8_t> fragment = packet->source_fragment;
-    RTC_CHECK_LE(index + kLengthFieldSize + fragment.size(), payload_capacity);
+  for (; next_packet_unit_ < end; ++next_packet_unit_) {
+    rtc::ArrayView<const uint8_t> fragment =
+        packets_[next_packet_unit_].source_fragment;
     // Add NAL unit length field.
     ByteWriter<uint16_t>::WriteBigEndian(&buffer[index], fragment.size());
     index += kLengthFieldSize;
     // Add NAL unit.
     memcpy(&buffer[index], fragment.data(), fragment.size());
     index += fragment.size();
-    packets_.pop();
-    input_fragments_.pop_front();
-    if (is_last_fragment)
-      break;
-    packet = &packets_.front();
-    is_last_fragment = packet->last_fragment;
   }
-  RTC_CHECK(is_last_fragment);
-  rtp_packet->SetPayloadSize(index);
+  RTC_DCHECK_EQ(index, payload_size);
 }
 
 void RtpPacketizerH264::NextFragmentPacket(RtpPacketToSend* rtp_packet) {
-  PacketUnit* packet = &packets_.front();
+  const PacketUnit& packet = packets_[next_packet_unit_];
   // NAL unit fragmented over multiple packets (FU-A).
   // We do not send original NALU header, so it will be replaced by the
   // FU indicator header of the first packet.
   uint8_t fu_indicator =
-      (packet->header & (kH264FBit | kH264NriMask)) | H264::NaluType::kFuA;
+      (packet.header & (kH264FBit | kH264NriMask)) | H264::NaluType::kFuA;
   uint8_t fu_header = 0;
 
   // S | E | R | 5 bit type.
-  fu_header |= (packet->first_fragment ? kH264SBit : 0);
-  fu_header |= (packet->last_fragment ? kH264EBit : 0);
-  uint8_t type = packet->header & kH264TypeMask;
+  fu_header |= (packet.first_fragment ? kH264SBit : 0);
+  fu_header |= (packet.last_fragment ? kH264EBit : 0);
+  uint8_t type = packet.header & kH264TypeMask;
   fu_header |= type;
-  rtc::ArrayView<const uint8_t> fragment = packet->source_fragment;
+  rtc::ArrayView<const uint8_t> fragment = packet.source_fragment;
   uint8_t* buffer =
       rtp_packet->AllocatePayload(kFuAHeaderSize + fragment.size());
   buffer[0] = fu_indicator;
   buffer[1] = fu_header;
   memcpy(buffer + kFuAHeaderSize, fragment.data(), fragment.size());
-  if (packet->last_fragment)
-    input_fragments_.pop_front();
-  packets_.pop();
+  ++next_packet_unit_;
 }
 
 }  // namespace webrtc
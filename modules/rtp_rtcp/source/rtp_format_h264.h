@@ -14,9 +14,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
-#include <deque>
 #include <memory>
-#include <queue>
+#include <vector>
 
 #include "api/array_view.h"
 #include "modules/rtp_rtcp/source/rtp_format.h"
@@ -92,8 +91,13 @@ class RtpPacketizerH264 : public RtpPacketizer {
 
   const PayloadSizeLimits limits_;
   size_t num_packets_left_;
-  std::deque<rtc::ArrayView<const uint8_t>> input_fragments_;
-  std::queue<PacketUnit> packets_;
+  // Views into the payload the packetizer was created with. Payload bytes are
+  // only copied once, when written into the packet by `NextPacket`.
+  std::vector<rtc::ArrayView<const uint8_t>> input_fragments_;
+  // All packet units of the frame, in the order they are sent, and the index
+  // of the first unit of the next packet.
+  std::vector<PacketUnit> packets_;
+  size_t next_packet_unit_ = 0;
 };
 }  // namespace webrtc
 #endif  // MODULES_RTP_RTCP_SOURCE_RTP_FORMAT_H264_H_
@@ -0,0 +1,93 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <iterator>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "common_video/h264/h264_common.h"
+#include "modules/rtp_rtcp/source/rtp_format_h264.h"
+#include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "rtc_base/random.h"
+#include "rtc_base/system/unused.h"
+
+namespace webrtc {
+namespace {
+
+// Appends a NAL unit of `size` bytes, including the header, with random
+// content that contains no start sequences, as produced by an encoder.
+void AppendNalu(Random& random,
+                H264::NaluType type,
+                size_t size,
+                std::vector<uint8_t>& frame) {
+  const uint8_t kStartSequence[] = {0, 0, 0, 1};
+  frame.insert(frame.end(), std::begin(kStartSequence),
+               std::end(kStartSequence));
+  frame.push_back(0x60 | type);
+  for (size_t i = 1; i < size; ++i) {
+    uint8_t byte = random.Rand<uint8_t>();
+    // Emulation prevention: never write two zeros in a row.
+    if (byte == 0 && frame.back() == 0) {
+      byte = 0x03;
+    }
+    frame.push_back(byte);
+  }
+}
+
+// Key frame of `state.range(0)` bytes in `state.range(1)` slices, preceded by
+// SPS and PPS.
+std::vector<uint8_t> CreateKeyFrame(benchmark::State& state) {
+  Random random(0x4264);
+  std::vector<uint8_t> frame;
+  AppendNalu(random, H264::NaluType::kSps, 12, frame);
+  AppendNalu(random, H264::NaluType::kPps, 4, frame);
+  const int num_slices = state.range(1);
+  for (int i = 0; i < num_slices; ++i) {
+    AppendNalu(random, H264::NaluType::kIdr, state.range(0) / num_slices,
+               frame);
+  }
+  return frame;
+}
+
+void BM_FindNaluIndices(benchmark::State& state) {
+  std::vector<uint8_t> frame = CreateKeyFrame(state);
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    std::vector<H264::NaluIndex> indices =
+        H264::FindNaluIndices(frame.data(), frame.size());
+    benchmark::DoNotOptimize(indices.data());
+  }
+  state.SetBytesProcessed(state.iterations() * frame.size());
+}
+
+void BM_PacketizeH264(benchmark::State& state) {
+  std::vector<uint8_t> frame = CreateKeyFrame(state);
+  RtpPacketizer::PayloadSizeLimits limits;
+  RtpPacketToSend packet(nullptr);
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    RtpPacketizerH264 packetizer(frame, limits,
+                                 H264PacketizationMode::NonInterleaved);
+    while (packetizer.NextPacket(&packet)) {
+      benchmark::DoNotOptimize(packet.data());
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * frame.size());
+}
+
+BENCHMARK(BM_FindNaluIndices)
+    ->ArgNames({"bytes", "slices"})
+    ->ArgsProduct({{10'000, 100'000, 1'000'000}, {1, 16, 64}});
+BENCHMARK(BM_PacketizeH264)
+    ->ArgNames({"bytes", "slices"})
+    ->ArgsProduct({{10'000, 100'000, 1'000'000}, {1, 16, 64}});
+
+}  // namespace
+}  // namespace webrtc
@@ -18,6 +18,7 @@
 #include "api/ref_counted_base.h"
 #include "api/rtp_headers.h"
 #include "api/scoped_refptr.h"
+#include "api/transport/ecn_marking.h"
 #include "api/units/timestamp.h"
 #include "modules/rtp_rtcp/source/rtp_packet.h"
 
@@ -48,6 +49,11 @@ class RtpPacketReceived : public RtpPacket {
   webrtc::Timestamp arrival_time() const { return arrival_time_; }
   void set_arrival_time(webrtc::Timestamp time) { arrival_time_ = time; }
 
+  // The ECN codepoint of the IP header the packet arrived in. kNotEct unless
+  // the transport reports it.
+  EcnMarking ecn() const { return ecn_; }
+  void set_ecn(EcnMarking ecn) { ecn_ = ecn; }
+
   // Flag if packet was recovered via RTX or FEC.
   bool recovered() const { return recovered_; }
   void set_recovered(bool value) { recovered_ = value; }
@@ -69,6 +75,7 @@ class RtpPacketReceived : public RtpPacket {
  private:
   webrtc::Timestamp arrival_time_ = Timestamp::MinusInfinity();
   int payload_type_frequency_ = 0;
+  EcnMarking ecn_ = EcnMarking::kNotEct;
   bool recovered_ = false;
   rtc::scoped_refptr<rtc::RefCountedBase> additional_data_;
 };
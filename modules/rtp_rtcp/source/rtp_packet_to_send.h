@@ -130,6 +130,13 @@ class RtpPacketToSend : public RtpPacket {
     return time_in_send_queue_;
   }
 
+  // Indicates if the pacer has scheduled the packet on the secondary route of
+  // the transport, see PacingController::SetSecondaryRoutePacingRate().
+  void set_send_on_secondary_route(bool send_on_secondary_route) {
+    send_on_secondary_route_ = send_on_secondary_route;
+  }
+  bool send_on_secondary_route() const { return send_on_secondary_route_; }
+
  private:
   webrtc::Timestamp capture_time_ = webrtc::Timestamp::Zero();
   absl::optional<RtpPacketMediaType> packet_type_;
@@ -141,6 +148,7 @@ class RtpPacketToSend : public RtpPacket {
   bool fec_protect_packet_ = false;
   bool is_red_ = false;
   absl::optional<TimeDelta> time_in_send_queue_;
+  bool send_on_secondary_route_ = false;
 };
 
 }  // namespace webrtc
@@ -93,6 +93,9 @@ RtpSenderEgress::RtpSenderEgress(const RtpRtcpInterface::Configuration& config,
       event_log_(config.event_log),
       is_audio_(config.audio),
       need_rtp_packet_infos_(config.need_rtp_packet_infos),
+      send_ecn_(config.field_trials &&
+                config.field_trials->IsEnabled(
+                    "WebRTC-Bwe-EcnScalableResponse")),
       fec_generator_(config.fec_generator),
       transport_feedback_observer_(config.transport_feedback_callback),
       send_packet_observer_(config.send_packet_observer),
@@ -267,6 +270,10 @@ void RtpSenderEgress::CompleteSendPacket(const Packet& compound_packet,
   }
   options.batchable = enable_send_packet_batching_ && !is_audio_;
   options.last_packet_in_batch = last_in_batch;
+  options.send_on_secondary_route = packet->send_on_secondary_route();
+  if (send_ecn_) {
+    options.ecn = EcnMarking::kEct1;
+  }
   const bool send_success = SendPacketToNetwork(*packet, options, pacing_info);
 
   // Put packet in retransmission history or update pending status even if
@@ -408,10 +415,13 @@ void RtpSenderEgress::AddPacketToTransportFeedback(
   if (transport_feedback_observer_) {
     RtpPacketSendInfo packet_info;
     packet_info.transport_sequence_number = packet_id;
+    packet_info.transport_ssrc = packet.Ssrc();
+    packet_info.transport_rtp_sequence_number = packet.SequenceNumber();
     packet_info.rtp_timestamp = packet.Timestamp();
     packet_info.length = packet.size();
     packet_info.pacing_info = pacing_info;
     packet_info.packet_type = packet.packet_type();
+    packet_info.on_secondary_route = packet.send_on_secondary_route();
 
     switch (*packet_info.packet_type) {
       case RtpPacketMediaType::kAudio:
@@ -142,6 +142,9 @@ class RtpSenderEgress {
   RtcEventLog* const event_log_;
   const bool is_audio_;
   const bool need_rtp_packet_infos_;
+  // Whether packets are sent as ECN capable with ECT(1), so that the network
+  // marks them CE when congested instead of dropping them.
+  const bool send_ecn_;
   VideoFecGenerator* const fec_generator_ RTC_GUARDED_BY(worker_queue_);
   absl::optional<uint16_t> last_sent_seq_ RTC_GUARDED_BY(worker_queue_);
   absl::optional<uint16_t> last_sent_rtx_seq_ RTC_GUARDED_BY(worker_queue_);
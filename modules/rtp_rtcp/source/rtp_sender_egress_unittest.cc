@@ -261,6 +261,22 @@ TEST_F(RtpSenderEgressTest, PacketOptionsIsRetransmitSetByPacketType) {
   EXPECT_TRUE(transport_.last_packet()->options.is_retransmit);
 }
 
+TEST_F(RtpSenderEgressTest, SendsPacketsAsNotEctByDefault) {
+  std::unique_ptr<RtpSenderEgress> sender = CreateRtpSenderEgress();
+  sender->SendPacket(BuildRtpPacket(), PacedPacketInfo());
+  EXPECT_EQ(transport_.last_packet()->options.ecn, EcnMarking::kNotEct);
+}
+
+TEST_F(RtpSenderEgressTest, SendsPacketsAsEct1WithEcnScalableResponse) {
+  test::ExplicitKeyValueConfig trials(
+      "WebRTC-Bwe-EcnScalableResponse/Enabled:true/");
+  RtpRtcpInterface::Configuration config = DefaultConfig();
+  config.field_trials = &trials;
+  auto sender = std::make_unique<RtpSenderEgress>(config, &packet_history_);
+  sender->SendPacket(BuildRtpPacket(), PacedPacketInfo());
+  EXPECT_EQ(transport_.last_packet()->options.ecn, EcnMarking::kEct1);
+}
+
 TEST_F(RtpSenderEgressTest, DoesnSetIncludedInAllocationByDefault) {
   std::unique_ptr<RtpSenderEgress> sender = CreateRtpSenderEgress();
 
@@ -893,13 +909,16 @@ TEST_F(RtpSenderEgressTest, TransportFeedbackObserverWithRtxRetransmission) {
   rtx_retransmission->SetExtension<TransportSequenceNumber>(
       kTransportSequenceNumber);
   rtx_retransmission->set_packet_type(RtpPacketMediaType::kRetransmission);
-  uint16_t rtx_retransmitted_seq = rtx_retransmission->SequenceNumber() - 2;
+  uint16_t rtx_seq = rtx_retransmission->SequenceNumber();
+  uint16_t rtx_retransmitted_seq = rtx_seq - 2;
   rtx_retransmission->set_retransmitted_sequence_number(rtx_retransmitted_seq);
 
   std::unique_ptr<RtpSenderEgress> sender = CreateRtpSenderEgress();
   EXPECT_CALL(
       feedback_observer_,
       OnAddPacket(AllOf(
+          Field(&RtpPacketSendInfo::transport_ssrc, kRtxSsrc),
+          Field(&RtpPacketSendInfo::transport_rtp_sequence_number, rtx_seq),
           Field(&RtpPacketSendInfo::media_ssrc, kSsrc),
           Field(&RtpPacketSendInfo::rtp_sequence_number, rtx_retransmitted_seq),
           Field(&RtpPacketSendInfo::transport_sequence_number,
@@ -31,6 +31,7 @@
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "modules/rtp_rtcp/source/absolute_capture_time_sender.h"
 #include "modules/rtp_rtcp/source/byte_io.h"
+#include "modules/rtp_rtcp/source/packetized_video_frame.h"
 #include "modules/rtp_rtcp/source/rtp_dependency_descriptor_extension.h"
 #include "modules/rtp_rtcp/source/rtp_descriptor_authentication.h"
 #include "modules/rtp_rtcp/source/rtp_format.h"
@@ -460,6 +461,24 @@ bool RTPSenderVideo::SendVideo(int payload_type,
                                RTPVideoHeader video_header,
                                TimeDelta expected_retransmission_time,
                                std::vector<uint32_t> csrcs) {
+  return SendVideoInternal(payload_type, codec_type, rtp_timestamp,
+                           capture_time, payload, encoder_output_size,
+                           std::move(video_header),
+                           expected_retransmission_time, std::move(csrcs),
+                           /*packetized_frame=*/nullptr);
+}
+
+bool RTPSenderVideo::SendVideoInternal(
+    int payload_type,
+    absl::optional<VideoCodecType> codec_type,
+    uint32_t rtp_timestamp,
+    Timestamp capture_time,
+    rtc::ArrayView<const uint8_t> payload,
+    size_t encoder_output_size,
+    RTPVideoHeader video_header,
+    TimeDelta expected_retransmission_time,
+    std::vector<uint32_t> csrcs,
+    PacketizedVideoFrame* packetized_frame) {
   TRACE_EVENT_ASYNC_STEP1(
       "webrtc", "Video", capture_time.ms_or(0), "Send", "type",
       std::string(VideoFrameTypeToString(video_header.frame_type)));
@@ -638,8 +657,23 @@ bool RTPSenderVideo::SendVideo(int payload_type,
            "one is required since require_frame_encryptor is set";
   }
 
-  std::unique_ptr<RtpPacketizer> packetizer =
-      RtpPacketizer::Create(codec_type, payload, limits, video_header);
+  // Encrypted payloads differ between senders, so they can't be shared.
+  if (frame_encryptor_ != nullptr) {
+    packetized_frame = nullptr;
+  }
+  std::unique_ptr<RtpPacketizer> packetizer;
+  if (packetized_frame != nullptr) {
+    packetizer = packetized_frame->Replay(limits, codec_type,
+                                          video_header.video_type_header);
+  }
+  if (packetizer == nullptr) {
+    packetizer =
+        RtpPacketizer::Create(codec_type, payload, limits, video_header);
+    if (packetized_frame != nullptr && packetized_frame->empty()) {
+      packetizer = packetized_frame->Record(std::move(packetizer), codec_type,
+                                            video_header.video_type_header);
+    }
+  }
 
   const size_t num_packets = packetizer->NumPackets();
 
@@ -762,6 +796,25 @@ bool RTPSenderVideo::SendEncodedImage(int payload_type,
                    expected_retransmission_time, /*csrcs=*/{});
 }
 
+bool RTPSenderVideo::SendEncodedImage(int payload_type,
+                                      absl::optional<VideoCodecType> codec_type,
+                                      uint32_t rtp_timestamp,
+                                      const EncodedImage& encoded_image,
+                                      RTPVideoHeader video_header,
+                                      TimeDelta expected_retransmission_time,
+                                      PacketizedVideoFrame& packetized_frame) {
+  if (frame_transformer_delegate_) {
+    return SendEncodedImage(payload_type, codec_type, rtp_timestamp,
+                            encoded_image, std::move(video_header),
+                            expected_retransmission_time);
+  }
+  return SendVideoInternal(payload_type, codec_type, rtp_timestamp,
+                           encoded_image.CaptureTime(), encoded_image,
+                           encoded_image.size(), std::move(video_header),
+                           expected_retransmission_time, /*csrcs=*/{},
+                           &packetized_frame);
+}
+
 DataRate RTPSenderVideo::PostEncodeOverhead() const {
   MutexLock lock(&stats_mutex_);
   return post_encode_overhead_bitrate_.Rate(clock_->CurrentTime())
@@ -47,6 +47,7 @@
 namespace webrtc {
 
 class FrameEncryptorInterface;
+class PacketizedVideoFrame;
 class RtpPacketizer;
 class RtpPacketToSend;
 
@@ -114,6 +115,20 @@ class RTPSenderVideo : public RTPVideoFrameSenderInterface {
                         RTPVideoHeader video_header,
                         TimeDelta expected_retransmission_time);
 
+  // Same as above, for a frame that is sent by many senders, e.g. when
+  // forwarding a stream to many receivers. The first sender packetizes the
+  // frame into `packetized_frame`, and the senders that follow write those
+  // payloads into their packets whenever they fit, so that only the RTP
+  // headers are built per sender. Frames that are encrypted or transformed
+  // are packetized by each sender.
+  bool SendEncodedImage(int payload_type,
+                        absl::optional<VideoCodecType> codec_type,
+                        uint32_t rtp_timestamp,
+                        const EncodedImage& encoded_image,
+                        RTPVideoHeader video_header,
+                        TimeDelta expected_retransmission_time,
+                        PacketizedVideoFrame& packetized_frame);
+
   // Configures video structures produced by encoder to send using the
   // dependency descriptor rtp header extension. Next call to SendVideo should
   // have video_header.frame_type == kVideoFrameKey.
@@ -166,6 +181,19 @@ class RTPSenderVideo : public RTPVideoFrameSenderInterface {
     kDontSend
   };
 
+  // Implements SendVideo. Shares the packetization of the frame through
+  // `packetized_frame` when it is not null.
+  bool SendVideoInternal(int payload_type,
+                         absl::optional<VideoCodecType> codec_type,
+                         uint32_t rtp_timestamp,
+                         Timestamp capture_time,
+                         rtc::ArrayView<const uint8_t> payload,
+                         size_t encoder_output_size,
+                         RTPVideoHeader video_header,
+                         TimeDelta expected_retransmission_time,
+                         std::vector<uint32_t> csrcs,
+                         PacketizedVideoFrame* packetized_frame);
+
   void SetVideoStructureInternal(
       const FrameDependencyStructure* video_structure);
   void SetVideoLayersAllocationInternal(VideoLayersAllocation allocation);
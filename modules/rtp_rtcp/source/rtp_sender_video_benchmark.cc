@@ -0,0 +1,146 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "api/units/time_delta.h"
+#include "api/video/encoded_image.h"
+#include "benchmark/benchmark.h"
+#include "modules/rtp_rtcp/include/rtp_packet_sender.h"
+#include "modules/rtp_rtcp/source/packetized_video_frame.h"
+#include "modules/rtp_rtcp/source/rtp_packet_history.h"
+#include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "modules/rtp_rtcp/source/rtp_rtcp_interface.h"
+#include "modules/rtp_rtcp/source/rtp_sender.h"
+#include "modules/rtp_rtcp/source/rtp_sender_video.h"
+#include "modules/video_coding/codecs/h264/include/h264_globals.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/random.h"
+#include "rtc_base/system/unused.h"
+#include "system_wrappers/include/clock.h"
+#include "test/explicit_key_value_config.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kPayloadType = 96;
+constexpr size_t kFrameSize = 50'000;
+constexpr int kNumSlices = 4;
+
+class DiscardingPacketSender : public RtpPacketSender {
+ public:
+  void EnqueuePackets(
+      std::vector<std::unique_ptr<RtpPacketToSend>> packets) override {
+    benchmark::DoNotOptimize(packets.data());
+  }
+};
+
+// The send side of one subscriber of a forwarded stream.
+class Subscriber {
+ public:
+  Subscriber(Clock* clock, uint32_t ssrc, const FieldTrialsView& field_trials)
+      : packet_history_(clock, RtpPacketHistory::PaddingMode::kDefault),
+        rtp_sender_(
+            [&] {
+              RtpRtcpInterface::Configuration config;
+              config.clock = clock;
+              config.local_media_ssrc = ssrc;
+              config.field_trials = &field_trials;
+              return config;
+            }(),
+            &packet_history_,
+            &packet_sender_),
+        sender_video_([&] {
+          RTPSenderVideo::Config config;
+          config.clock = clock;
+          config.rtp_sender = &rtp_sender_;
+          config.field_trials = &field_trials;
+          return config;
+        }()) {}
+
+  RTPSenderVideo& sender_video() { return sender_video_; }
+
+ private:
+  DiscardingPacketSender packet_sender_;
+  RtpPacketHistory packet_history_;
+  RTPSender rtp_sender_;
+  RTPSenderVideo sender_video_;
+};
+
+// H.264 delta frame of `kNumSlices` slices with random content.
+EncodedImage CreateDeltaFrame() {
+  Random random(0x5e9d);
+  std::vector<uint8_t> frame;
+  for (int i = 0; i < kNumSlices; ++i) {
+    frame.insert(frame.end(), {0, 0, 0, 1, 0x41});
+    for (size_t j = 1; j < kFrameSize / kNumSlices; ++j) {
+      // Never two zeros in a row, like after emulation prevention.
+      frame.push_back(frame.back() == 0 ? 0x03 : random.Rand<uint8_t>());
+    }
+  }
+  EncodedImage encoded_image;
+  encoded_image.SetEncodedData(
+      EncodedImageBuffer::Create(frame.data(), frame.size()));
+  encoded_image._frameType = VideoFrameType::kVideoFrameDelta;
+  return encoded_image;
+}
+
+// Sends a frame to `state.range(0)` subscribers, packetizing it once for all
+// of them when `state.range(1)` is set, and once per subscriber otherwise.
+// Like RtpVideoSenderFanOut, a single subscriber packetizes the frame itself.
+void BM_SendVideoToSubscribers(benchmark::State& state) {
+  const int num_subscribers = state.range(0);
+  const bool share_packetization = state.range(1) != 0 && num_subscribers > 1;
+  Clock* clock = Clock::GetRealTimeClock();
+  test::ExplicitKeyValueConfig field_trials("");
+  std::vector<std::unique_ptr<Subscriber>> subscribers;
+  for (int i = 0; i < num_subscribers; ++i) {
+    subscribers.push_back(
+        std::make_unique<Subscriber>(clock, 1000 + i, field_trials));
+  }
+  EncodedImage encoded_image = CreateDeltaFrame();
+  RTPVideoHeader video_header;
+  video_header.frame_type = VideoFrameType::kVideoFrameDelta;
+  video_header.codec = VideoCodecType::kVideoCodecH264;
+  video_header.video_type_header.emplace<RTPVideoHeaderH264>()
+      .packetization_mode = H264PacketizationMode::NonInterleaved;
+
+  uint32_t rtp_timestamp = 0;
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    rtp_timestamp += 3000;
+    PacketizedVideoFrame packetized_frame;
+    for (std::unique_ptr<Subscriber>& subscriber : subscribers) {
+      bool sent =
+          share_packetization
+              ? subscriber->sender_video().SendEncodedImage(
+                    kPayloadType, VideoCodecType::kVideoCodecH264,
+                    rtp_timestamp, encoded_image, video_header,
+                    TimeDelta::PlusInfinity(), packetized_frame)
+              : subscriber->sender_video().SendEncodedImage(
+                    kPayloadType, VideoCodecType::kVideoCodecH264,
+                    rtp_timestamp, encoded_image, video_header,
+                    TimeDelta::PlusInfinity());
+      RTC_CHECK(sent);
+    }
+  }
+  state.counters["per_subscriber"] = benchmark::Counter(
+      state.iterations() * num_subscribers,
+      benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+BENCHMARK(BM_SendVideoToSubscribers)
+    ->ArgNames({"subscribers", "shared"})
+    ->ArgsProduct({{1, 4, 16, 64, 256}, {0, 1}});
+
+}  // namespace
+}  // namespace webrtc
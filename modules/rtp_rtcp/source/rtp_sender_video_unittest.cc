@@ -23,10 +23,12 @@
 #include "api/test/mock_frame_encryptor.h"
 #include "api/transport/rtp/dependency_descriptor.h"
 #include "api/units/timestamp.h"
+#include "api/video/encoded_image.h"
 #include "api/video/video_codec_constants.h"
 #include "api/video/video_timing.h"
 #include "modules/rtp_rtcp/include/rtp_cvo.h"
 #include "modules/rtp_rtcp/include/rtp_header_extension_map.h"
+#include "modules/rtp_rtcp/source/packetized_video_frame.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/nack.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/receiver_report.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/report_block.h"
@@ -1439,6 +1441,124 @@ TEST_F(RtpSenderVideoTest, SendRawVideo) {
   EXPECT_THAT(sent_payload, ElementsAreArray(kPayload));
 }
 
+TEST_F(RtpSenderVideoTest, SendersSharePacketizedFrame) {
+  LoopbackTransportTest other_transport;
+  RtpRtcpInterface::Configuration config;
+  config.clock = &fake_clock_;
+  config.outgoing_transport = &other_transport;
+  config.retransmission_rate_limiter = &retransmission_rate_limiter_;
+  config.field_trials = &field_trials_;
+  config.local_media_ssrc = kSsrc + 1;
+  std::unique_ptr<ModuleRtpRtcpImpl2> other_module =
+      ModuleRtpRtcpImpl2::Create(config);
+  TestRtpSenderVideo other_sender(&fake_clock_, other_module->RtpSender(),
+                                  field_trials_);
+
+  std::vector<uint8_t> frame(3000);
+  for (size_t i = 0; i < frame.size(); ++i) {
+    frame[i] = i;
+  }
+  EncodedImage encoded_image;
+  encoded_image.SetEncodedData(
+      EncodedImageBuffer::Create(frame.data(), frame.size()));
+  RTPVideoHeader video_header;
+  video_header.frame_type = VideoFrameType::kVideoFrameKey;
+
+  PacketizedVideoFrame packetized_frame;
+  ASSERT_TRUE(rtp_sender_video_->SendEncodedImage(
+      kPayload, kType, kTimestamp, encoded_image, video_header,
+      TimeDelta::PlusInfinity(), packetized_frame));
+  EXPECT_EQ(packetized_frame.num_packets(), 3u);
+  ASSERT_TRUE(other_sender.SendEncodedImage(kPayload, kType, kTimestamp,
+                                            encoded_image, video_header,
+                                            TimeDelta::PlusInfinity(),
+                                            packetized_frame));
+
+  // Same payloads, each sent with the headers of its sender.
+  ASSERT_EQ(transport_.packets_sent(), 3);
+  ASSERT_EQ(other_transport.packets_sent(), 3);
+  for (int i = 0; i < 3; ++i) {
+    const RtpPacketReceived& packet = transport_.sent_packets()[i];
+    const RtpPacketReceived& other_packet = other_transport.sent_packets()[i];
+    EXPECT_EQ(packet.Ssrc(), kSsrc);
+    EXPECT_EQ(other_packet.Ssrc(), kSsrc + 1);
+    EXPECT_EQ(other_packet.Marker(), i == 2);
+    EXPECT_THAT(other_packet.payload(), ElementsAreArray(packet.payload()));
+  }
+}
+
+TEST_F(RtpSenderVideoTest, PacketizesFrameAgainWhenSharedPayloadsDoNotFit) {
+  LoopbackTransportTest other_transport;
+  RtpRtcpInterface::Configuration config;
+  config.clock = &fake_clock_;
+  config.outgoing_transport = &other_transport;
+  config.retransmission_rate_limiter = &retransmission_rate_limiter_;
+  config.field_trials = &field_trials_;
+  config.local_media_ssrc = kSsrc + 1;
+  std::unique_ptr<ModuleRtpRtcpImpl2> other_module =
+      ModuleRtpRtcpImpl2::Create(config);
+  other_module->SetMaxRtpPacketSize(500);
+  TestRtpSenderVideo other_sender(&fake_clock_, other_module->RtpSender(),
+                                  field_trials_);
+
+  std::vector<uint8_t> frame(3000, 0x55);
+  EncodedImage encoded_image;
+  encoded_image.SetEncodedData(
+      EncodedImageBuffer::Create(frame.data(), frame.size()));
+  RTPVideoHeader video_header;
+  video_header.frame_type = VideoFrameType::kVideoFrameKey;
+
+  PacketizedVideoFrame packetized_frame;
+  ASSERT_TRUE(rtp_sender_video_->SendEncodedImage(
+      kPayload, kType, kTimestamp, encoded_image, video_header,
+      TimeDelta::PlusInfinity(), packetized_frame));
+  ASSERT_TRUE(other_sender.SendEncodedImage(kPayload, kType, kTimestamp,
+                                            encoded_image, video_header,
+                                            TimeDelta::PlusInfinity(),
+                                            packetized_frame));
+
+  EXPECT_EQ(packetized_frame.num_packets(), 3u);
+  EXPECT_GT(other_transport.packets_sent(), 6);
+  for (const RtpPacketReceived& packet : other_transport.sent_packets()) {
+    EXPECT_LE(packet.size(), 500u);
+  }
+}
+
+TEST_F(RtpSenderVideoTest, PacketizesFrameAgainForOtherPacketizationFormat) {
+  LoopbackTransportTest other_transport;
+  RtpRtcpInterface::Configuration config;
+  config.clock = &fake_clock_;
+  config.outgoing_transport = &other_transport;
+  config.retransmission_rate_limiter = &retransmission_rate_limiter_;
+  config.field_trials = &field_trials_;
+  config.local_media_ssrc = kSsrc + 1;
+  std::unique_ptr<ModuleRtpRtcpImpl2> other_module =
+      ModuleRtpRtcpImpl2::Create(config);
+  TestRtpSenderVideo other_sender(&fake_clock_, other_module->RtpSender(),
+                                  field_trials_);
+
+  const uint8_t kFrame[] = {1, 2, 3, 4};
+  EncodedImage encoded_image;
+  encoded_image.SetEncodedData(
+      EncodedImageBuffer::Create(kFrame, sizeof(kFrame)));
+  RTPVideoHeader video_header;
+  video_header.frame_type = VideoFrameType::kVideoFrameKey;
+
+  // The generic packetization adds a payload header, raw packetization
+  // doesn't.
+  PacketizedVideoFrame packetized_frame;
+  ASSERT_TRUE(rtp_sender_video_->SendEncodedImage(
+      kPayload, kType, kTimestamp, encoded_image, video_header,
+      TimeDelta::PlusInfinity(), packetized_frame));
+  ASSERT_TRUE(other_sender.SendEncodedImage(
+      kPayload, /*codec_type=*/absl::nullopt, kTimestamp, encoded_image,
+      video_header, TimeDelta::PlusInfinity(), packetized_frame));
+
+  ASSERT_EQ(other_transport.packets_sent(), 1);
+  EXPECT_THAT(other_transport.last_sent_packet().payload(),
+              ElementsAreArray(kFrame));
+}
+
 class RtpSenderVideoWithFrameTransformerTest : public ::testing::Test {
  public:
   RtpSenderVideoWithFrameTransformerTest()
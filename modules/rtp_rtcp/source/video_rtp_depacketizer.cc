@@ -13,10 +13,13 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <vector>
+
 #include "api/array_view.h"
 #include "api/scoped_refptr.h"
 #include "api/video/encoded_image.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/copy_on_write_buffer.h"
 
 namespace webrtc {
 
@@ -39,4 +42,12 @@ rtc::scoped_refptr<EncodedImageBuffer> VideoRtpDepacketizer::AssembleFrame(
   return bitstream;
 }
 
+rtc::scoped_refptr<EncodedImageBufferInterface>
+VideoRtpDepacketizer::AssembleFrameFragments(
+    rtc::ArrayView<const rtc::CopyOnWriteBuffer> rtp_payloads) {
+  return FragmentedEncodedImageBuffer::Create(
+      std::vector<rtc::CopyOnWriteBuffer>(rtp_payloads.begin(),
+                                          rtp_payloads.end()));
+}
+
 }  // namespace webrtc
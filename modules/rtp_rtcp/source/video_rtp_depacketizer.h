@@ -34,6 +34,11 @@ class VideoRtpDepacketizer {
       rtc::CopyOnWriteBuffer rtp_payload) = 0;
   virtual rtc::scoped_refptr<EncodedImageBuffer> AssembleFrame(
       rtc::ArrayView<const rtc::ArrayView<const uint8_t>> rtp_payloads);
+  // Like `AssembleFrame`, but the default implementation references the
+  // payloads from the returned buffer instead of copying them.
+  virtual rtc::scoped_refptr<EncodedImageBufferInterface>
+  AssembleFrameFragments(
+      rtc::ArrayView<const rtc::CopyOnWriteBuffer> rtp_payloads);
 };
 
 }  // namespace webrtc
@@ -15,6 +15,7 @@
 
 #include <utility>
 
+#include "absl/container/inlined_vector.h"
 #include "modules/rtp_rtcp/source/leb128.h"
 #include "modules/rtp_rtcp/source/rtp_video_header.h"
 #include "rtc_base/byte_buffer.h"
@@ -356,6 +357,17 @@ rtc::scoped_refptr<EncodedImageBuffer> VideoRtpDepacketizerAv1::AssembleFrame(
   return bitstream;
 }
 
+rtc::scoped_refptr<EncodedImageBufferInterface>
+VideoRtpDepacketizerAv1::AssembleFrameFragments(
+    rtc::ArrayView<const rtc::CopyOnWriteBuffer> rtp_payloads) {
+  absl::InlinedVector<rtc::ArrayView<const uint8_t>, 16> payloads;
+  payloads.reserve(rtp_payloads.size());
+  for (const rtc::CopyOnWriteBuffer& payload : rtp_payloads) {
+    payloads.push_back(payload);
+  }
+  return AssembleFrame(payloads);
+}
+
 absl::optional<VideoRtpDepacketizer::ParsedRtpPayload>
 VideoRtpDepacketizerAv1::Parse(rtc::CopyOnWriteBuffer rtp_payload) {
   if (rtp_payload.size() == 0) {
@@ -33,6 +33,9 @@ class VideoRtpDepacketizerAv1 : public VideoRtpDepacketizer {
   rtc::scoped_refptr<EncodedImageBuffer> AssembleFrame(
       rtc::ArrayView<const rtc::ArrayView<const uint8_t>> rtp_payloads)
       override;
+  // The OBU headers are rewritten, so the payloads are always copied.
+  rtc::scoped_refptr<EncodedImageBufferInterface> AssembleFrameFragments(
+      rtc::ArrayView<const rtc::CopyOnWriteBuffer> rtp_payloads) override;
 
   absl::optional<ParsedRtpPayload> Parse(
       rtc::CopyOnWriteBuffer rtp_payload) override;
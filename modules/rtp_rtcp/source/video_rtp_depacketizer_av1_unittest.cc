@@ -209,6 +209,20 @@ TEST(VideoRtpDepacketizerAv1Test, AssembleFrameFromTwoPacketsWithOneObu) {
               ElementsAre(0b0'0110'010, 3, 20, 30, 40));
 }
 
+TEST(VideoRtpDepacketizerAv1Test,
+     AssembleFrameFragmentsRewritesObusIntoOneFragment) {
+  const uint8_t payload1[] = {0b01'01'0000,  // aggregation header
+                              0b0'0110'000, 20, 30};
+  const uint8_t payload2[] = {0b10'01'0000,  // aggregation header
+                              40};
+  rtc::CopyOnWriteBuffer payloads[] = {rtc::CopyOnWriteBuffer(payload1),
+                                       rtc::CopyOnWriteBuffer(payload2)};
+  auto frame = VideoRtpDepacketizerAv1().AssembleFrameFragments(payloads);
+  ASSERT_TRUE(frame);
+  ASSERT_EQ(frame->num_fragments(), 1u);
+  EXPECT_THAT(frame->fragment(0), ElementsAre(0b0'0110'010, 3, 20, 30, 40));
+}
+
 TEST(VideoRtpDepacketizerAv1Test, AssembleFrameFromTwoPacketsWithTwoObu) {
   const uint8_t payload1[] = {0b01'10'0000,  // aggregation header
                               2,             // /  Sequence
@@ -12,11 +12,15 @@
 
 #include <algorithm>
 
+#include "absl/types/optional.h"
 #include "api/scoped_refptr.h"
+#include "api/video/color_space.h"
 #include "api/video/encoded_image.h"
 #include "api/video/video_frame_buffer.h"
+#include "api/video_codecs/decoder_core_budget.h"
 #include "common_video/include/video_frame_buffer.h"
 #include "modules/video_coding/include/video_error_codes.h"
+#include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
 #include "third_party/dav1d/libdav1d/include/dav1d/dav1d.h"
 #include "third_party/libyuv/include/libyuv/convert.h"
@@ -25,6 +29,8 @@
 namespace webrtc {
 namespace {
 
+class ScopedDav1dPicture;
+
 class Dav1dDecoder : public VideoDecoder {
  public:
   Dav1dDecoder();
@@ -43,8 +49,16 @@ class Dav1dDecoder : public VideoDecoder {
   const char* ImplementationName() const override;
 
  private:
+  int32_t DeliverPicture(rtc::scoped_refptr<ScopedDav1dPicture> picture);
+
   Dav1dContext* context_ = nullptr;
   DecodedImageCallback* decode_complete_callback_ = nullptr;
+  // With frame threading a picture may be output after later encoded images
+  // have been sent to the decoder.
+  bool frame_threading_ = false;
+  // Budget that `num_reserved_threads_` are reserved from while configured.
+  rtc::scoped_refptr<DecoderCoreBudget> core_budget_;
+  int num_reserved_threads_ = 0;
 };
 
 class ScopedDav1dData {
@@ -71,8 +85,23 @@ class ScopedDav1dPicture
 
 constexpr char kDav1dName[] = "dav1d";
 
-// Calling `dav1d_data_wrap` requires a `free_callback` to be registered.
-void NullFreeCallback(const uint8_t* buffer, void* opaque) {}
+// Metadata of an encoded image that is attached to its data, and that dav1d
+// hands back with the decoded picture.
+struct FrameMetadata {
+  uint32_t rtp_timestamp;
+  int64_t ntp_time_ms;
+  absl::optional<ColorSpace> color_space;
+};
+
+// Releases the encoded image buffer that `dav1d_data_wrap` was given, once
+// dav1d is done with the data.
+void ReleaseEncodedData(const uint8_t* buffer, void* encoded_data) {
+  static_cast<EncodedImageBufferInterface*>(encoded_data)->Release();
+}
+
+void FreeFrameMetadata(const uint8_t* user_data, void* opaque) {
+  delete reinterpret_cast<const FrameMetadata*>(user_data);
+}
 
 Dav1dDecoder::Dav1dDecoder() = default;
 
@@ -81,11 +110,26 @@ Dav1dDecoder::~Dav1dDecoder() {
 }
 
 bool Dav1dDecoder::Configure(const Settings& settings) {
+  Release();
+
   Dav1dSettings s;
   dav1d_default_settings(&s);
 
-  s.n_threads = std::max(2, settings.number_of_cores());
-  s.max_frame_delay = 1;   // For low latency decoding.
+  int num_threads = settings.threading_mode() == ThreadingMode::kDefault
+                        ? std::max(2, settings.number_of_cores())
+                        : settings.number_of_cores();
+  if (settings.core_budget() != nullptr) {
+    num_threads = settings.core_budget()->ReserveThreads(num_threads);
+    core_budget_ = settings.core_budget();
+    num_reserved_threads_ = num_threads;
+  }
+  frame_threading_ =
+      settings.threading_mode() == ThreadingMode::kFrameParallel;
+
+  s.n_threads = num_threads;
+  // Decode one frame at a time for low latency, unless frame threading is
+  // asked for, in which case dav1d derives the delay from `n_threads`.
+  s.max_frame_delay = frame_threading_ ? 0 : 1;
   s.all_layers = 0;        // Don't output a frame for every spatial layer.
   s.operating_point = 31;  // Decode all operating points.
 
@@ -100,6 +144,10 @@ int32_t Dav1dDecoder::RegisterDecodeCompleteCallback(
 
 int32_t Dav1dDecoder::Release() {
   dav1d_close(&context_);
+  if (core_budget_ != nullptr) {
+    core_budget_->ReturnThreads(num_reserved_threads_);
+    core_budget_ = nullptr;
+  }
   if (context_ != nullptr) {
     return WEBRTC_VIDEO_CODEC_MEMORY;
   }
@@ -125,27 +173,77 @@ int32_t Dav1dDecoder::Decode(const EncodedImage& encoded_image,
 
   ScopedDav1dData scoped_dav1d_data;
   Dav1dData& dav1d_data = scoped_dav1d_data.Data();
-  dav1d_data_wrap(&dav1d_data, encoded_image.data(), encoded_image.size(),
-                  /*free_callback=*/&NullFreeCallback,
-                  /*user_data=*/nullptr);
-
-  if (int decode_res = dav1d_send_data(context_, &dav1d_data)) {
-    RTC_LOG(LS_WARNING)
-        << "Dav1dDecoder::Decode decoding failed with error code "
-        << decode_res;
-    return WEBRTC_VIDEO_CODEC_ERROR;
+  // With frame threading dav1d may still read the data after `Decode()`
+  // returns, so the data holds a reference to the encoded image buffer.
+  EncodedImageBufferInterface* encoded_data =
+      encoded_image.GetEncodedData().release();
+  if (dav1d_data_wrap(&dav1d_data, encoded_image.data(), encoded_image.size(),
+                      /*free_callback=*/&ReleaseEncodedData,
+                      /*user_data=*/encoded_data)) {
+    if (encoded_data != nullptr) {
+      encoded_data->Release();
+    }
+    return WEBRTC_VIDEO_CODEC_ERR_PARAMETER;
+  }
+  FrameMetadata* metadata =
+      new FrameMetadata{.rtp_timestamp = encoded_image.Timestamp(),
+                        .ntp_time_ms = encoded_image.ntp_time_ms_};
+  if (encoded_image.ColorSpace()) {
+    metadata->color_space = *encoded_image.ColorSpace();
+  }
+  if (dav1d_data_wrap_user_data(
+          &dav1d_data, reinterpret_cast<const uint8_t*>(metadata),
+          /*free_callback=*/&FreeFrameMetadata, /*cookie=*/nullptr)) {
+    delete metadata;
+    return WEBRTC_VIDEO_CODEC_MEMORY;
   }
 
-  rtc::scoped_refptr<ScopedDav1dPicture> scoped_dav1d_picture(
-      new ScopedDav1dPicture{});
-  Dav1dPicture& dav1d_picture = scoped_dav1d_picture->Picture();
-  if (int get_picture_res = dav1d_get_picture(context_, &dav1d_picture)) {
-    RTC_LOG(LS_WARNING)
-        << "Dav1dDecoder::Decode getting picture failed with error code "
-        << get_picture_res;
+  // dav1d doesn't take more data while its pictures wait to be output.
+  bool picture_delivered = false;
+  int send_data_res;
+  do {
+    send_data_res = dav1d_send_data(context_, &dav1d_data);
+    if (send_data_res != 0 && send_data_res != DAV1D_ERR(EAGAIN)) {
+      RTC_LOG(LS_WARNING)
+          << "Dav1dDecoder::Decode decoding failed with error code "
+          << send_data_res;
+      return WEBRTC_VIDEO_CODEC_ERROR;
+    }
+
+    while (true) {
+      rtc::scoped_refptr<ScopedDav1dPicture> scoped_dav1d_picture(
+          new ScopedDav1dPicture{});
+      int get_picture_res =
+          dav1d_get_picture(context_, &scoped_dav1d_picture->Picture());
+      if (get_picture_res == DAV1D_ERR(EAGAIN)) {
+        break;
+      }
+      if (get_picture_res != 0) {
+        RTC_LOG(LS_WARNING)
+            << "Dav1dDecoder::Decode getting picture failed with error code "
+            << get_picture_res;
+        return WEBRTC_VIDEO_CODEC_ERROR;
+      }
+      if (int32_t deliver_res = DeliverPicture(std::move(scoped_dav1d_picture));
+          deliver_res != WEBRTC_VIDEO_CODEC_OK) {
+        return deliver_res;
+      }
+      picture_delivered = true;
+    }
+  } while (send_data_res == DAV1D_ERR(EAGAIN));
+
+  // Without frame threading every encoded image is output right away.
+  if (!picture_delivered && !frame_threading_) {
+    RTC_LOG(LS_WARNING) << "Dav1dDecoder::Decode got no picture.";
     return WEBRTC_VIDEO_CODEC_ERROR;
   }
 
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
+int32_t Dav1dDecoder::DeliverPicture(
+    rtc::scoped_refptr<ScopedDav1dPicture> scoped_dav1d_picture) {
+  Dav1dPicture& dav1d_picture = scoped_dav1d_picture->Picture();
   if (dav1d_picture.p.bpc != 8) {
     // Only accept 8 bit depth.
     RTC_LOG(LS_ERROR) << "Dav1dDecoder::Decode unhandled bit depth: "
@@ -181,12 +279,18 @@ int32_t Dav1dDecoder::Decode(const EncodedImage& encoded_image,
     return WEBRTC_VIDEO_CODEC_ERROR;
   }
 
-  VideoFrame decoded_frame = VideoFrame::Builder()
-                                 .set_video_frame_buffer(wrapped_buffer)
-                                 .set_timestamp_rtp(encoded_image.Timestamp())
-                                 .set_ntp_time_ms(encoded_image.ntp_time_ms_)
-                                 .set_color_space(encoded_image.ColorSpace())
-                                 .build();
+  // The picture may belong to an earlier encoded image than the one being
+  // decoded, so its metadata is taken from the data it was decoded from.
+  const FrameMetadata* metadata = reinterpret_cast<const FrameMetadata*>(
+      dav1d_picture.m.user_data.data);
+  RTC_DCHECK(metadata);
+  VideoFrame decoded_frame =
+      VideoFrame::Builder()
+          .set_video_frame_buffer(wrapped_buffer)
+          .set_timestamp_rtp(metadata->rtp_timestamp)
+          .set_ntp_time_ms(metadata->ntp_time_ms)
+          .set_color_space(metadata->color_space)
+          .build();
 
   decode_complete_callback_->Decoded(decoded_frame, absl::nullopt,
                                      absl::nullopt);
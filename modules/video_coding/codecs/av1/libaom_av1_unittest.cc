@@ -18,9 +18,15 @@
 #include <vector>
 
 #include "absl/types/optional.h"
+#include "api/make_ref_counted.h"
+#include "api/scoped_refptr.h"
 #include "api/units/data_size.h"
 #include "api/units/time_delta.h"
+#include "api/video/encoded_image.h"
+#include "api/video/video_frame.h"
+#include "api/video_codecs/decoder_core_budget.h"
 #include "api/video_codecs/video_codec.h"
+#include "api/video_codecs/video_decoder.h"
 #include "api/video_codecs/video_encoder.h"
 #include "modules/video_coding/codecs/av1/dav1d_decoder.h"
 #include "modules/video_coding/codecs/av1/libaom_av1_encoder.h"
@@ -159,6 +165,74 @@ TEST(LibaomAv1Test, EncodeDecode) {
   EXPECT_EQ(decoder.num_output_frames(), decoder.decoded_frame_ids().size());
 }
 
+// Decoder callback that records the RTP timestamps of the decoded frames.
+class TimestampCallback : public DecodedImageCallback {
+ public:
+  const std::vector<uint32_t>& timestamps() const { return timestamps_; }
+
+ private:
+  int32_t Decoded(VideoFrame& decoded_image) override {
+    timestamps_.push_back(decoded_image.timestamp());
+    return 0;
+  }
+  void Decoded(VideoFrame& decoded_image,
+               absl::optional<int32_t> /*decode_time_ms*/,
+               absl::optional<uint8_t> /*qp*/) override {
+    timestamps_.push_back(decoded_image.timestamp());
+  }
+
+  std::vector<uint32_t> timestamps_;
+};
+
+TEST(LibaomAv1Test, DecodesWithFrameThreading) {
+  std::unique_ptr<VideoEncoder> encoder = CreateLibaomAv1Encoder();
+  VideoCodec codec_settings = DefaultCodecSettings();
+  ASSERT_EQ(encoder->InitEncode(&codec_settings, DefaultEncoderSettings()),
+            WEBRTC_VIDEO_CODEC_OK);
+
+  VideoBitrateAllocation allocation;
+  allocation.SetBitrate(0, 0, 300000);
+  encoder->SetRates(VideoEncoder::RateControlParameters(
+      allocation, codec_settings.maxFramerate));
+
+  std::vector<EncodedVideoFrameProducer::EncodedFrame> encoded_frames =
+      EncodedVideoFrameProducer(*encoder).SetNumInputFrames(20).Encode();
+  ASSERT_THAT(encoded_frames, SizeIs(20));
+
+  TimestampCallback callback;
+  auto core_budget = rtc::make_ref_counted<DecoderCoreBudget>(4);
+  std::unique_ptr<VideoDecoder> decoder = CreateDav1dDecoder();
+  VideoDecoder::Settings settings;
+  settings.set_number_of_cores(4);
+  settings.set_threading_mode(VideoDecoder::ThreadingMode::kFrameParallel);
+  settings.set_core_budget(core_budget);
+  ASSERT_TRUE(decoder->Configure(settings));
+  EXPECT_EQ(core_budget->available_threads(), 0);
+  decoder->RegisterDecodeCompleteCallback(&callback);
+
+  std::vector<uint32_t> encoded_timestamps;
+  for (const auto& encoded_frame : encoded_frames) {
+    // Only the decoder keeps a reference to the copy of the encoded data, so
+    // it must stay valid while dav1d decodes it on other threads.
+    EncodedImage image = encoded_frame.encoded_image;
+    image.SetEncodedData(EncodedImageBuffer::Create(
+        encoded_frame.encoded_image.data(),
+        encoded_frame.encoded_image.size()));
+    encoded_timestamps.push_back(image.Timestamp());
+    EXPECT_EQ(decoder->Decode(image, /*render_time_ms=*/0),
+              WEBRTC_VIDEO_CODEC_OK);
+  }
+
+  // Frames that are still being decoded when the last frame is sent aren't
+  // output, the others are output in order with their own timestamps.
+  ASSERT_THAT(callback.timestamps(), SizeIs(Ge(encoded_frames.size() - 4)));
+  encoded_timestamps.resize(callback.timestamps().size());
+  EXPECT_THAT(callback.timestamps(), ElementsAreArray(encoded_timestamps));
+
+  decoder = nullptr;
+  EXPECT_EQ(core_budget->available_threads(), 3);
+}
+
 struct LayerId {
   friend bool operator==(const LayerId& lhs, const LayerId& rhs) {
     return std::tie(lhs.spatial_id, lhs.temporal_id) ==
@@ -10,18 +10,23 @@
 
 #include "api/video_codecs/video_codec.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/functional/any_invocable.h"
+#include "absl/types/optional.h"
 #include "api/test/create_video_codec_tester.h"
 #include "api/test/metrics/global_metrics_logger_and_exporter.h"
+#include "api/test/metrics/metric.h"
 #include "api/test/video_codec_tester.h"
 #include "api/test/videocodec_test_stats.h"
 #include "api/units/data_rate.h"
 #include "api/units/frequency.h"
+#include "api/units/timestamp.h"
 #include "api/video/encoded_image.h"
 #include "api/video/i420_buffer.h"
 #include "api/video/resolution.h"
@@ -38,6 +43,7 @@
 #include "modules/video_coding/codecs/test/android_codec_factory_helper.h"
 #endif
 #include "rtc_base/logging.h"
+#include "rtc_base/synchronization/mutex.h"
 #include "system_wrappers/include/field_trial.h"
 #include "test/gtest.h"
 #include "test/testsupport/file_utils.h"
@@ -74,6 +80,12 @@ struct LayerId {
   }
 };
 
+// Threads that software decoders use in the tests.
+struct DecoderThreading {
+  VideoDecoder::ThreadingMode mode = VideoDecoder::ThreadingMode::kDefault;
+  int num_threads = 1;
+};
+
 struct EncodingSettings {
   ScalabilityMode scalability_mode;
   struct LayerSettings {
@@ -200,6 +212,24 @@ class TestRawVideoSource : public VideoCodecTester::RawVideoSource {
   std::map<uint32_t, int> pulled_frames_;
 };
 
+// Source of frames that were encoded before.
+class TestCodedVideoSource : public VideoCodecTester::CodedVideoSource {
+ public:
+  explicit TestCodedVideoSource(std::vector<EncodedImage> frames)
+      : frames_(std::move(frames)) {}
+
+  absl::optional<EncodedImage> PullFrame() override {
+    if (frame_num_ >= frames_.size()) {
+      return absl::nullopt;  // End of stream.
+    }
+    return frames_[frame_num_++];
+  }
+
+ private:
+  const std::vector<EncodedImage> frames_;
+  size_t frame_num_ = 0;
+};
+
 class TestEncoder : public VideoCodecTester::Encoder,
                     public EncodedImageCallback {
  public:
@@ -330,19 +360,59 @@ class TestEncoder : public VideoCodecTester::Encoder,
   Mutex mutex_;
 };
 
+// Keeps a copy of the frames that `encoder` encodes, e.g. to decode them
+// several times with different decoder settings.
+class RecordingEncoder : public VideoCodecTester::Encoder {
+ public:
+  explicit RecordingEncoder(VideoCodecTester::Encoder* encoder)
+      : encoder_(encoder) {}
+
+  void Initialize() override { encoder_->Initialize(); }
+
+  void Encode(const VideoFrame& frame, EncodeCallback callback) override {
+    encoder_->Encode(frame, [this, callback = std::move(callback)](
+                                const EncodedImage& encoded_frame) mutable {
+      EncodedImage copy = encoded_frame;
+      copy.SetEncodedData(EncodedImageBuffer::Create(encoded_frame.data(),
+                                                     encoded_frame.size()));
+      {
+        MutexLock lock(&mutex_);
+        encoded_frames_.push_back(std::move(copy));
+      }
+      callback(encoded_frame);
+    });
+  }
+
+  void Flush() override { encoder_->Flush(); }
+
+  std::vector<EncodedImage> encoded_frames() {
+    MutexLock lock(&mutex_);
+    return encoded_frames_;
+  }
+
+ private:
+  VideoCodecTester::Encoder* const encoder_;
+  std::vector<EncodedImage> encoded_frames_ RTC_GUARDED_BY(mutex_);
+  Mutex mutex_;
+};
+
 class TestDecoder : public VideoCodecTester::Decoder,
                     public DecodedImageCallback {
  public:
   TestDecoder(std::unique_ptr<VideoDecoder> decoder,
-              const std::string codec_type)
-      : decoder_(std::move(decoder)), codec_type_(codec_type) {
+              const std::string codec_type,
+              DecoderThreading threading)
+      : decoder_(std::move(decoder)),
+        codec_type_(codec_type),
+        threading_(threading) {
     decoder_->RegisterDecodeCompleteCallback(this);
   }
 
   void Initialize() override {
     VideoDecoder::Settings ds;
     ds.set_codec_type(PayloadStringToCodecType(codec_type_));
-    ds.set_number_of_cores(1);
+    ds.set_number_of_cores(threading_.num_threads);
+    ds.set_threading_mode(threading_.mode);
     ds.set_max_render_resolution({1280, 720});
 
     bool result = decoder_->Configure(ds);
@@ -380,6 +450,7 @@ class TestDecoder : public VideoCodecTester::Decoder,
 
   std::unique_ptr<VideoDecoder> decoder_;
   const std::string codec_type_;
+  const DecoderThreading threading_;
   std::map<uint32_t, DecodeCallback> callbacks_ RTC_GUARDED_BY(mutex_);
   Mutex mutex_;
 };
@@ -414,7 +485,10 @@ std::unique_ptr<TestEncoder> CreateEncoder(
                                        frame_settings);
 }
 
-std::unique_ptr<TestDecoder> CreateDecoder(std::string type, std::string impl) {
+std::unique_ptr<TestDecoder> CreateDecoder(
+    std::string type,
+    std::string impl,
+    DecoderThreading threading = DecoderThreading()) {
   std::unique_ptr<VideoDecoderFactory> factory;
   if (impl == "builtin") {
     factory = std::make_unique<InternalDecoderFactory>();
@@ -429,7 +503,7 @@ std::unique_ptr<TestDecoder> CreateDecoder(std::string type, std::string impl) {
   if (decoder == nullptr) {
     return nullptr;
   }
-  return std::make_unique<TestDecoder>(std::move(decoder), type);
+  return std::make_unique<TestDecoder>(std::move(decoder), type, threading);
 }
 
 void SetTargetRates(const std::map<int, EncodingSettings>& frame_settings,
@@ -805,6 +879,104 @@ INSTANTIATE_TEST_SUITE_P(All,
                                  Values(std::pair(30, 15), std::pair(15, 30))),
                          FramerateAdaptationTest::TestParamsToString);
 
+class DecoderThreadingTest
+    : public ::testing::TestWithParam<
+          std::tuple</*codec_type=*/std::string,
+                     VideoDecoder::ThreadingMode,
+                     /*num_threads=*/int>> {
+ public:
+  static std::string TestParamsToString(
+      const ::testing::TestParamInfo<DecoderThreadingTest::ParamType>& info) {
+    auto [codec_type, threading_mode, num_threads] = info.param;
+    return codec_type +
+           (threading_mode == VideoDecoder::ThreadingMode::kFrameParallel
+                ? "FrameParallel"
+                : "TileParallel") +
+           std::to_string(num_threads) + "threads";
+  }
+};
+
+// Decodes the same encoded video with a different number of decoder threads
+// per test, and reports how many frames per second the decoder can decode
+// and how long it takes to output a frame.
+TEST_P(DecoderThreadingTest, DecodeFramerateAndLatency) {
+  auto [codec_type, threading_mode, num_threads] = GetParam();
+  const VideoInfo& video_info = kFourPeople_1280x720_30;
+
+  std::map<int, EncodingSettings> frame_settings = {
+      {0,
+       {.scalability_mode = ScalabilityMode::kL1T1,
+        .layer_settings = {
+            {LayerId{.spatial_idx = 0, .temporal_idx = 0},
+             {.resolution = video_info.resolution,
+              .framerate = video_info.framerate,
+              .bitrate = DataRate::KilobitsPerSec(2048)}}}}}};
+
+  int duration_s = 10;
+  int num_frames = duration_s * video_info.framerate.millihertz() / 1000;
+
+  std::unique_ptr<TestRawVideoSource> video_source =
+      CreateVideoSource(video_info, frame_settings, num_frames);
+  std::unique_ptr<TestEncoder> encoder =
+      CreateEncoder(codec_type, "builtin", frame_settings);
+  std::unique_ptr<TestDecoder> decoder = CreateDecoder(
+      codec_type, "builtin",
+      DecoderThreading{.mode = threading_mode, .num_threads = num_threads});
+  if (encoder == nullptr || decoder == nullptr) {
+    return;
+  }
+
+  std::unique_ptr<VideoCodecTester> tester = CreateVideoCodecTester();
+  RecordingEncoder recording_encoder(encoder.get());
+  tester->RunEncodeTest(video_source.get(), &recording_encoder,
+                        VideoCodecTester::EncoderSettings());
+
+  // Frames are decoded back-to-back, so the decode framerate is the number of
+  // frames decoded over the time from the first decode call to the last
+  // output.
+  TestCodedVideoSource coded_source(recording_encoder.encoded_frames());
+  std::unique_ptr<VideoCodecStats> stats = tester->RunDecodeTest(
+      &coded_source, decoder.get(), VideoCodecTester::DecoderSettings());
+  std::vector<VideoCodecStats::Frame> frames = stats->Slice();
+  int num_decoded_frames = 0;
+  Timestamp first_decode_start = Timestamp::PlusInfinity();
+  Timestamp last_decode_end = Timestamp::MinusInfinity();
+  for (const VideoCodecStats::Frame& f : frames) {
+    if (!f.decoded) {
+      continue;
+    }
+    ++num_decoded_frames;
+    first_decode_start = std::min(first_decode_start, f.decode_start);
+    last_decode_end = std::max(last_decode_end, f.decode_start + f.decode_time);
+  }
+  ASSERT_GT(num_decoded_frames, 0);
+  double decode_fps = num_decoded_frames /
+                      (last_decode_end - first_decode_start).seconds<double>();
+
+  std::string test_case_name =
+      ::testing::UnitTest::GetInstance()->current_test_info()->name();
+  std::map<std::string, std::string> metadata = {
+      {"codec_type", codec_type},
+      {"video_name", video_info.name},
+      {"num_threads", std::to_string(num_threads)}};
+  GetGlobalMetricsLogger()->LogSingleValueMetric(
+      "decode_fps", test_case_name, decode_fps, Unit::kHertz,
+      ImprovementDirection::kBiggerIsBetter, metadata);
+  GetGlobalMetricsLogger()->LogMetric(
+      "decode_latency_ms", test_case_name,
+      stats->Aggregate(frames).decode_time_ms, Unit::kMilliseconds,
+      ImprovementDirection::kSmallerIsBetter, metadata);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    All,
+    DecoderThreadingTest,
+    Combine(Values("AV1", "VP9", "VP8"),
+            Values(VideoDecoder::ThreadingMode::kTileParallel,
+                   VideoDecoder::ThreadingMode::kFrameParallel),
+            Values(1, 2, 4, 8)),
+    DecoderThreadingTest::TestParamsToString);
+
 }  // namespace test
 
 }  // namespace webrtc
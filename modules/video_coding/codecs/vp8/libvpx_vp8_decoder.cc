@@ -142,8 +142,17 @@ bool LibvpxVp8Decoder::Configure(const Settings& settings) {
     memset(decoder_, 0, sizeof(*decoder_));
   }
   vpx_codec_dec_cfg_t cfg;
-  // Setting number of threads to a constant value (1)
-  cfg.threads = 1;
+  // Decode on one thread unless asked otherwise. libvpx can't decode VP8
+  // frames in parallel, so `kFrameParallel` decodes rows in parallel too.
+  int num_threads = settings.threading_mode() == ThreadingMode::kDefault
+                        ? 1
+                        : settings.number_of_cores();
+  if (settings.core_budget() != nullptr) {
+    num_threads = settings.core_budget()->ReserveThreads(num_threads);
+    core_budget_ = settings.core_budget();
+    num_reserved_threads_ = num_threads;
+  }
+  cfg.threads = num_threads;
   cfg.h = cfg.w = 0;  // set after decode
 
   vpx_codec_flags_t flags = use_postproc_ ? VPX_CODEC_USE_POSTPROC : 0;
@@ -327,6 +336,10 @@ int LibvpxVp8Decoder::Release() {
     decoder_ = NULL;
   }
   buffer_pool_.Release();
+  if (core_budget_ != nullptr) {
+    core_budget_->ReturnThreads(num_reserved_threads_);
+    core_budget_ = nullptr;
+  }
   inited_ = false;
   return ret_val;
 }
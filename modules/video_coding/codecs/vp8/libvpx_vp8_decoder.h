@@ -14,7 +14,9 @@
 #include <memory>
 
 #include "absl/types/optional.h"
+#include "api/scoped_refptr.h"
 #include "api/video/encoded_image.h"
+#include "api/video_codecs/decoder_core_budget.h"
 #include "api/video_codecs/video_decoder.h"
 #include "common_video/include/video_frame_buffer_pool.h"
 #include "modules/video_coding/codecs/vp8/include/vp8.h"
@@ -71,6 +73,9 @@ class LibvpxVp8Decoder : public VideoDecoder {
   bool key_frame_required_;
   const absl::optional<DeblockParams> deblock_params_;
   const std::unique_ptr<QpSmoother> qp_smoother_;
+  // Budget that `num_reserved_threads_` are reserved from while configured.
+  rtc::scoped_refptr<DecoderCoreBudget> core_budget_;
+  int num_reserved_threads_ = 0;
 };
 
 }  // namespace webrtc
@@ -135,9 +135,14 @@ bool LibvpxVp9Decoder::Configure(const Settings& settings) {
   cfg.threads = 1;
 #else
   const RenderResolution& resolution = settings.max_render_resolution();
-  if (!resolution.Valid()) {
+  int num_threads;
+  if (settings.threading_mode() != ThreadingMode::kDefault) {
+    // libvpx can't decode VP9 frames in parallel, so `kFrameParallel` uses
+    // the threads for tiles and rows too.
+    num_threads = settings.number_of_cores();
+  } else if (!resolution.Valid()) {
     // Postpone configuring number of threads until resolution is known.
-    cfg.threads = 1;
+    num_threads = 1;
   } else {
     // We want to use multithreading when decoding high resolution videos. But
     // not too many in order to avoid overhead when many stream are decoded
@@ -150,10 +155,16 @@ bool LibvpxVp9Decoder::Configure(const Settings& settings) {
     // 4 for 1080p
     // 8 for 1440p
     // 18 for 4K
-    int num_threads = std::max(
+    num_threads = std::max(
         1, 2 * resolution.Width() * resolution.Height() / (1280 * 720));
-    cfg.threads = std::min(settings.number_of_cores(), num_threads);
+    num_threads = std::min(settings.number_of_cores(), num_threads);
   }
+  if (settings.core_budget() != nullptr) {
+    num_threads = settings.core_budget()->ReserveThreads(num_threads);
+    core_budget_ = settings.core_budget();
+    num_reserved_threads_ = num_threads;
+  }
+  cfg.threads = num_threads;
 #endif
 
   current_settings_ = settings;
@@ -184,6 +195,17 @@ bool LibvpxVp9Decoder::Configure(const Settings& settings) {
     return false;
   }
 
+  if (settings.threading_mode() != ThreadingMode::kDefault &&
+      cfg.threads > 1) {
+    // Row based multithreading lets the threads share the work of frames
+    // that have fewer tile columns than threads.
+    status = vpx_codec_control(decoder_, VP9D_SET_ROW_MT, 1);
+    if (status != VPX_CODEC_OK) {
+      RTC_LOG(LS_WARNING) << "Failed to enable VP9D_SET_ROW_MT. "
+                          << vpx_codec_error(decoder_);
+    }
+  }
+
   return true;
 }
 
@@ -382,6 +404,10 @@ int LibvpxVp9Decoder::Release() {
   // still referenced externally are deleted once fully released, not returning
   // to the pool.
   libvpx_buffer_pool_.ClearPool();
+  if (core_budget_ != nullptr) {
+    core_budget_->ReturnThreads(num_reserved_threads_);
+    core_budget_ = nullptr;
+  }
   inited_ = false;
   return ret_val;
 }
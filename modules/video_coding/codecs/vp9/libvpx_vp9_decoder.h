@@ -14,6 +14,8 @@
 
 #ifdef RTC_ENABLE_VP9
 
+#include "api/scoped_refptr.h"
+#include "api/video_codecs/decoder_core_budget.h"
 #include "api/video_codecs/video_decoder.h"
 #include "modules/video_coding/codecs/vp9/include/vp9.h"
 #include "modules/video_coding/codecs/vp9/vp9_frame_buffer_pool.h"
@@ -51,6 +53,9 @@ class LibvpxVp9Decoder : public VP9Decoder {
   vpx_codec_ctx_t* decoder_;
   bool key_frame_required_;
   Settings current_settings_;
+  // Budget that `num_reserved_threads_` are reserved from while configured.
+  rtc::scoped_refptr<DecoderCoreBudget> core_budget_;
+  int num_reserved_threads_ = 0;
 };
 }  // namespace webrtc
 
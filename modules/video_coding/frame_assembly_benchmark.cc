@@ -0,0 +1,217 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/types/variant.h"
+#include "api/array_view.h"
+#include "api/scoped_refptr.h"
+#include "api/video/encoded_image.h"
+#include "api/video/video_codec_type.h"
+#include "api/video/video_frame_type.h"
+#include "benchmark/benchmark.h"
+#include "common_video/h264/h264_common.h"
+#include "modules/rtp_rtcp/source/create_video_rtp_depacketizer.h"
+#include "modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "modules/rtp_rtcp/source/rtp_video_header.h"
+#include "modules/rtp_rtcp/source/video_rtp_depacketizer.h"
+#include "modules/video_coding/codecs/h264/include/h264_globals.h"
+#include "modules/video_coding/codecs/vp8/include/vp8_globals.h"
+#include "modules/video_coding/h264_sps_pps_tracker.h"
+#include "modules/video_coding/packet_buffer.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/copy_on_write_buffer.h"
+#include "rtc_base/system/unused.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kPayloadSize = 1200;
+
+// Whether frames are assembled like RtpVideoStreamReceiver2 does with the
+// field trial WebRTC-Video-ZeroCopyFrameAssembly disabled or enabled.
+enum class Assembly { kCopy, kFragments };
+
+RTPVideoHeader CreateVideoHeader(VideoCodecType codec, int packets_per_frame) {
+  RTPVideoHeader video_header;
+  video_header.codec = codec;
+  video_header.width = 1280;
+  video_header.height = 720;
+  video_header.frame_type = VideoFrameType::kVideoFrameDelta;
+  if (codec == kVideoCodecH264) {
+    RTPVideoHeaderH264& h264_header =
+        video_header.video_type_header.emplace<RTPVideoHeaderH264>();
+    h264_header.packetization_type =
+        packets_per_frame == 1 ? kH264SingleNalu : kH264FuA;
+  } else {
+    video_header.video_type_header.emplace<RTPVideoHeaderVP8>()
+        .InitRTPVideoHeaderVP8();
+  }
+  return video_header;
+}
+
+// Receives delta frames of `state.range(0)` packets each, one packet at a
+// time, and assembles them into the bitstream that a decoder reads. Reports
+// how many bytes of the received payloads are copied on the way, which
+// includes the copy made when a decoder needs a fragmented frame to be
+// contiguous.
+void ReceiveFrames(benchmark::State& state,
+                   VideoCodecType codec,
+                   Assembly assembly) {
+  const int packets_per_frame = state.range(0);
+  video_coding::PacketBuffer packet_buffer(/*start_buffer_size=*/512,
+                                           /*max_buffer_size=*/2048);
+  video_coding::H264SpsPpsTracker tracker;
+  std::unique_ptr<VideoRtpDepacketizer> depacketizer =
+      CreateVideoRtpDepacketizer(codec);
+  // The payloads of the received packets, which are shared with the packets
+  // of every frame.
+  std::vector<rtc::CopyOnWriteBuffer> received_payloads;
+  for (int i = 0; i < packets_per_frame; ++i) {
+    received_payloads.emplace_back(kPayloadSize, kPayloadSize);
+  }
+  RtpPacketReceived rtp_packet;
+  rtp_packet.SetPayloadType(96);
+  RTPVideoHeader video_header = CreateVideoHeader(codec, packets_per_frame);
+  std::vector<rtc::ArrayView<const uint8_t>> payloads;
+  std::vector<rtc::CopyOnWriteBuffer> fragments;
+
+  uint16_t seq_num = 0;
+  uint32_t rtp_timestamp = 0;
+  int64_t num_frames = 0;
+  int64_t bytes_copied = 0;
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    rtp_packet.SetTimestamp(rtp_timestamp);
+    for (int i = 0; i < packets_per_frame; ++i) {
+      const bool first = i == 0;
+      const bool last = i == packets_per_frame - 1;
+      rtp_packet.SetSequenceNumber(seq_num++);
+      rtp_packet.SetMarker(last);
+      video_header.is_first_packet_in_frame = first;
+      video_header.is_last_packet_in_frame = last;
+      if (codec == kVideoCodecH264) {
+        // Only the first packet starts a NAL unit.
+        RTPVideoHeaderH264& h264_header =
+            absl::get<RTPVideoHeaderH264>(video_header.video_type_header);
+        h264_header.nalus_length = first ? 1 : 0;
+        h264_header.nalus[0].type = H264::NaluType::kSlice;
+      } else {
+        absl::get<RTPVideoHeaderVP8>(video_header.video_type_header)
+            .beginningOfPartition = first;
+      }
+
+      std::unique_ptr<video_coding::PacketBuffer::Packet> packet =
+          packet_buffer.CreatePacket(rtp_packet, video_header);
+      const rtc::CopyOnWriteBuffer& payload = received_payloads[i];
+      if (codec == kVideoCodecH264) {
+        video_coding::H264SpsPpsTracker::FixedBitstream fixed =
+            assembly == Assembly::kFragments
+                ? tracker.FixBitstream(payload, &packet->video_header)
+                : tracker.CopyAndFixBitstream(payload, &packet->video_header);
+        RTC_CHECK_EQ(fixed.action, video_coding::H264SpsPpsTracker::kInsert);
+        if (fixed.bitstream.cdata() != payload.cdata()) {
+          bytes_copied += fixed.bitstream.size();
+        }
+        packet->video_payload_prefix = std::move(fixed.prefix);
+        packet->video_payload = std::move(fixed.bitstream);
+      } else {
+        packet->video_payload = payload;
+      }
+
+      video_coding::PacketBuffer::InsertResult result =
+          packet_buffer.InsertPacket(std::move(packet));
+      if (result.packets.empty()) {
+        continue;
+      }
+      RTC_CHECK_EQ(result.packets.size(), packets_per_frame);
+      rtc::scoped_refptr<EncodedImageBufferInterface> bitstream;
+      if (assembly == Assembly::kFragments) {
+        fragments.clear();
+        for (const auto& frame_packet : result.packets) {
+          if (frame_packet->video_payload_prefix.size() > 0) {
+            fragments.push_back(frame_packet->video_payload_prefix);
+          }
+          fragments.push_back(frame_packet->video_payload);
+        }
+        bitstream = depacketizer->AssembleFrameFragments(fragments);
+        // RtpVideoStreamReceiver2 copies frames of several fragments into
+        // one contiguous buffer before handing them on.
+        if (bitstream->num_fragments() > 1) {
+          bitstream = EncodedImageBuffer::Create(*bitstream);
+        }
+      } else {
+        payloads.clear();
+        for (const auto& frame_packet : result.packets) {
+          payloads.emplace_back(frame_packet->video_payload);
+        }
+        bitstream = depacketizer->AssembleFrame(payloads);
+      }
+      // Read the frame like a decoder that needs contiguous data does. Unless
+      // that is the payload of a received packet, the frame was copied.
+      EncodedImage encoded_image;
+      encoded_image.SetEncodedData(std::move(bitstream));
+      const uint8_t* data = encoded_image.data();
+      benchmark::DoNotOptimize(data);
+      if (std::none_of(received_payloads.begin(), received_payloads.end(),
+                       [&](const rtc::CopyOnWriteBuffer& received_payload) {
+                         return received_payload.cdata() == data;
+                       })) {
+        bytes_copied += encoded_image.size();
+      }
+      packet_buffer.RecyclePackets(std::move(result.packets));
+    }
+    rtp_timestamp += 3000;
+    ++num_frames;
+  }
+
+  state.SetItemsProcessed(num_frames);
+  state.counters["time_per_frame"] = benchmark::Counter(
+      num_frames, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+  state.counters["bytes_copied_per_frame"] =
+      num_frames > 0 ? static_cast<double>(bytes_copied) / num_frames : 0;
+}
+
+void BM_AssembleH264Frames(benchmark::State& state) {
+  ReceiveFrames(state, kVideoCodecH264, Assembly::kCopy);
+}
+
+void BM_AssembleH264FramesFromFragments(benchmark::State& state) {
+  ReceiveFrames(state, kVideoCodecH264, Assembly::kFragments);
+}
+
+void BM_AssembleVp8Frames(benchmark::State& state) {
+  ReceiveFrames(state, kVideoCodecVP8, Assembly::kCopy);
+}
+
+void BM_AssembleVp8FramesFromFragments(benchmark::State& state) {
+  ReceiveFrames(state, kVideoCodecVP8, Assembly::kFragments);
+}
+
+BENCHMARK(BM_AssembleH264Frames)->ArgName("packets")->Arg(1)->Arg(8)->Arg(35);
+BENCHMARK(BM_AssembleH264FramesFromFragments)
+    ->ArgName("packets")
+    ->Arg(1)
+    ->Arg(8)
+    ->Arg(35);
+BENCHMARK(BM_AssembleVp8Frames)->ArgName("packets")->Arg(1)->Arg(8)->Arg(35);
+BENCHMARK(BM_AssembleVp8FramesFromFragments)
+    ->ArgName("packets")
+    ->Arg(1)
+    ->Arg(8)
+    ->Arg(35);
+
+}  // namespace
+}  // namespace webrtc
@@ -29,7 +29,7 @@ namespace {
 const uint8_t start_code_h264[] = {0, 0, 0, 1};
 }  // namespace
 
-H264SpsPpsTracker::H264SpsPpsTracker() = default;
+H264SpsPpsTracker::H264SpsPpsTracker() : start_code_(start_code_h264) {}
 H264SpsPpsTracker::~H264SpsPpsTracker() = default;
 
 H264SpsPpsTracker::PpsInfo::PpsInfo() = default;
@@ -47,6 +47,27 @@ H264SpsPpsTracker::SpsInfo::~SpsInfo() = default;
 H264SpsPpsTracker::FixedBitstream H264SpsPpsTracker::CopyAndFixBitstream(
     rtc::ArrayView<const uint8_t> bitstream,
     RTPVideoHeader* video_header) {
+  return FixBitstreamInternal(bitstream, video_header,
+                              /*share_payload=*/false);
+}
+
+H264SpsPpsTracker::FixedBitstream H264SpsPpsTracker::FixBitstream(
+    rtc::CopyOnWriteBuffer bitstream,
+    RTPVideoHeader* video_header) {
+  FixedBitstream fixed =
+      FixBitstreamInternal(bitstream, video_header, /*share_payload=*/true);
+  if (fixed.action == kInsert &&
+      absl::get<RTPVideoHeaderH264>(video_header->video_type_header)
+              .packetization_type != kH264StapA) {
+    fixed.bitstream = std::move(bitstream);
+  }
+  return fixed;
+}
+
+H264SpsPpsTracker::FixedBitstream H264SpsPpsTracker::FixBitstreamInternal(
+    rtc::ArrayView<const uint8_t> bitstream,
+    RTPVideoHeader* video_header,
+    bool share_payload) {
   RTC_DCHECK(video_header);
   RTC_DCHECK(video_header->codec == kVideoCodecH264);
   RTC_DCHECK_GT(bitstream.size(), 0);
@@ -119,6 +140,17 @@ H264SpsPpsTracker::FixedBitstream H264SpsPpsTracker::CopyAndFixBitstream(
   RTC_CHECK(!append_sps_pps ||
             (sps != sps_data_.end() && pps != pps_data_.end()));
 
+  share_payload =
+      share_payload && h264_header.packetization_type != kH264StapA;
+  H264SpsPpsTracker::FixedBitstream fixed;
+  if (share_payload && !append_sps_pps) {
+    if (h264_header.nalus_length > 0) {
+      fixed.prefix = start_code_;
+    }
+    fixed.action = kInsert;
+    return fixed;
+  }
+
   // Calculate how much space we need for the rest of the bitstream.
   size_t required_size = 0;
 
@@ -143,21 +175,24 @@ H264SpsPpsTracker::FixedBitstream H264SpsPpsTracker::CopyAndFixBitstream(
     if (h264_header.nalus_length > 0) {
       required_size += sizeof(start_code_h264);
     }
-    required_size += bitstream.size();
+    if (!share_payload) {
+      required_size += bitstream.size();
+    }
   }
 
   // Then we copy to the new buffer.
-  H264SpsPpsTracker::FixedBitstream fixed;
-  fixed.bitstream.EnsureCapacity(required_size);
+  rtc::CopyOnWriteBuffer& output =
+      share_payload ? fixed.prefix : fixed.bitstream;
+  output.EnsureCapacity(required_size);
 
   if (append_sps_pps) {
     // Insert SPS.
-    fixed.bitstream.AppendData(start_code_h264);
-    fixed.bitstream.AppendData(sps->second.data.get(), sps->second.size);
+    output.AppendData(start_code_h264);
+    output.AppendData(sps->second.data.get(), sps->second.size);
 
     // Insert PPS.
-    fixed.bitstream.AppendData(start_code_h264);
-    fixed.bitstream.AppendData(pps->second.data.get(), pps->second.size);
+    output.AppendData(start_code_h264);
+    output.AppendData(pps->second.data.get(), pps->second.size);
 
     // Update codec header to reflect the newly added SPS and PPS.
     NaluInfo sps_info;
@@ -181,7 +216,7 @@ H264SpsPpsTracker::FixedBitstream H264SpsPpsTracker::CopyAndFixBitstream(
   if (h264_header.packetization_type == kH264StapA) {
     const uint8_t* nalu_ptr = bitstream.data() + 1;
     while (nalu_ptr < bitstream.data() + bitstream.size() - 1) {
-      fixed.bitstream.AppendData(start_code_h264);
+      output.AppendData(start_code_h264);
 
       // The first two bytes describe the length of a segment.
       uint16_t segment_length = nalu_ptr[0] << 8 | nalu_ptr[1];
@@ -192,14 +227,16 @@ H264SpsPpsTracker::FixedBitstream H264SpsPpsTracker::CopyAndFixBitstream(
         return {kDrop};
       }
 
-      fixed.bitstream.AppendData(nalu_ptr, segment_length);
+      output.AppendData(nalu_ptr, segment_length);
       nalu_ptr += segment_length;
     }
   } else {
     if (h264_header.nalus_length > 0) {
-      fixed.bitstream.AppendData(start_code_h264);
+      output.AppendData(start_code_h264);
+    }
+    if (!share_payload) {
+      output.AppendData(bitstream.data(), bitstream.size());
     }
-    fixed.bitstream.AppendData(bitstream.data(), bitstream.size());
   }
 
   fixed.action = kInsert;
@@ -30,6 +30,9 @@ class H264SpsPpsTracker {
   struct FixedBitstream {
     PacketAction action;
     rtc::CopyOnWriteBuffer bitstream;
+    // Set by `FixBitstream`: data that precedes `bitstream` in the assembled
+    // frame, i.e. start codes and SPS/PPS provided out of band.
+    rtc::CopyOnWriteBuffer prefix;
   };
 
   H264SpsPpsTracker();
@@ -39,6 +42,12 @@ class H264SpsPpsTracker {
   FixedBitstream CopyAndFixBitstream(rtc::ArrayView<const uint8_t> bitstream,
                                      RTPVideoHeader* video_header);
 
+  // Like `CopyAndFixBitstream`, but returns `bitstream` itself, without a
+  // copy, together with a `prefix` to insert before it. STAP-A packets are
+  // still rewritten into a new `bitstream` with an empty `prefix`.
+  FixedBitstream FixBitstream(rtc::CopyOnWriteBuffer bitstream,
+                              RTPVideoHeader* video_header);
+
   void InsertSpsPpsNalus(const std::vector<uint8_t>& sps,
                          const std::vector<uint8_t>& pps);
 
@@ -66,6 +75,15 @@ class H264SpsPpsTracker {
     std::unique_ptr<uint8_t[]> data;
   };
 
+  // When `share_payload` is set, the start codes and SPS/PPS to insert before
+  // a packet that isn't STAP-A are returned in `prefix`, and `bitstream` is
+  // left empty for the caller to fill.
+  FixedBitstream FixBitstreamInternal(rtc::ArrayView<const uint8_t> bitstream,
+                                      RTPVideoHeader* video_header,
+                                      bool share_payload);
+
+  // Shared by the prefixes of all the packets that only need a start code.
+  const rtc::CopyOnWriteBuffer start_code_;
   std::map<uint32_t, PpsInfo> pps_data_;
   std::map<uint32_t, SpsInfo> sps_data_;
 };
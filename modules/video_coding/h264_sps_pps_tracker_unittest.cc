@@ -18,6 +18,7 @@
 #include "common_video/h264/h264_common.h"
 #include "modules/rtp_rtcp/source/rtp_video_header.h"
 #include "modules/video_coding/codecs/h264/include/h264_globals.h"
+#include "rtc_base/copy_on_write_buffer.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
 
@@ -34,6 +35,15 @@ rtc::ArrayView<const uint8_t> Bitstream(
   return fixed.bitstream;
 }
 
+std::vector<uint8_t> PrefixedBitstream(
+    const H264SpsPpsTracker::FixedBitstream& fixed) {
+  std::vector<uint8_t> bitstream(fixed.prefix.cdata(),
+                                 fixed.prefix.cdata() + fixed.prefix.size());
+  bitstream.insert(bitstream.end(), fixed.bitstream.cdata(),
+                   fixed.bitstream.cdata() + fixed.bitstream.size());
+  return bitstream;
+}
+
 void ExpectSpsPpsIdr(const RTPVideoHeaderH264& codec_header,
                      uint8_t sps_id,
                      uint8_t pps_id) {
@@ -146,6 +156,72 @@ TEST_F(TestH264SpsPpsTracker, FuAFirstPacket) {
   EXPECT_THAT(Bitstream(fixed), ElementsAreArray(expected));
 }
 
+TEST_F(TestH264SpsPpsTracker, FixBitstreamSharesPayload) {
+  const uint8_t kData[] = {1, 2, 3};
+  rtc::CopyOnWriteBuffer payload(kData);
+  H264VideoHeader header;
+  header.h264().packetization_type = kH264FuA;
+  header.h264().nalus_length = 1;
+  header.is_first_packet_in_frame = true;
+
+  H264SpsPpsTracker::FixedBitstream fixed =
+      tracker_.FixBitstream(payload, &header);
+
+  EXPECT_EQ(fixed.action, H264SpsPpsTracker::kInsert);
+  EXPECT_EQ(fixed.bitstream.cdata(), payload.cdata());
+  EXPECT_THAT(rtc::ArrayView<const uint8_t>(fixed.prefix),
+              ElementsAreArray(start_code));
+}
+
+TEST_F(TestH264SpsPpsTracker, FixBitstreamPrefixesSpsPpsOutOfBand) {
+  const uint8_t kData[] = {1, 2, 3};
+  rtc::CopyOnWriteBuffer payload(kData);
+  // Generated by "ffmpeg -r 30 -f avfoundation -i "default" out.h264" on macos.
+  const std::vector<uint8_t> sps(
+      {0x67, 0x7a, 0x00, 0x0d, 0xbc, 0xd9, 0x41, 0x41, 0xfa, 0x10, 0x00, 0x00,
+       0x03, 0x00, 0x10, 0x00, 0x00, 0x03, 0x03, 0xc0, 0xf1, 0x42, 0x99, 0x60});
+  const std::vector<uint8_t> pps({0x68, 0xeb, 0xe3, 0xcb, 0x22, 0xc0});
+  tracker_.InsertSpsPpsNalus(sps, pps);
+  H264VideoHeader idr_header;
+  idr_header.is_first_packet_in_frame = true;
+  AddIdr(&idr_header, 0);
+
+  H264SpsPpsTracker::FixedBitstream fixed =
+      tracker_.FixBitstream(payload, &idr_header);
+
+  EXPECT_EQ(fixed.action, H264SpsPpsTracker::kInsert);
+  EXPECT_EQ(fixed.bitstream.cdata(), payload.cdata());
+  std::vector<uint8_t> expected;
+  expected.insert(expected.end(), start_code, start_code + sizeof(start_code));
+  expected.insert(expected.end(), sps.begin(), sps.end());
+  expected.insert(expected.end(), start_code, start_code + sizeof(start_code));
+  expected.insert(expected.end(), pps.begin(), pps.end());
+  expected.insert(expected.end(), start_code, start_code + sizeof(start_code));
+  expected.insert(expected.end(), {1, 2, 3});
+  EXPECT_THAT(PrefixedBitstream(fixed), ElementsAreArray(expected));
+  ExpectSpsPpsIdr(idr_header.h264(), 0, 0);
+}
+
+TEST_F(TestH264SpsPpsTracker, FixBitstreamRewritesStapA) {
+  std::vector<uint8_t> data;
+  H264VideoHeader header;
+  header.h264().packetization_type = kH264StapA;
+  header.is_first_packet_in_frame = true;
+  data.insert(data.end(), {0});     // First byte is ignored
+  data.insert(data.end(), {0, 2});  // Length of segment
+  AddSps(&header, 13, &data);
+
+  H264SpsPpsTracker::FixedBitstream fixed =
+      tracker_.FixBitstream(rtc::CopyOnWriteBuffer(data), &header);
+
+  EXPECT_EQ(fixed.action, H264SpsPpsTracker::kInsert);
+  EXPECT_EQ(fixed.prefix.size(), 0u);
+  std::vector<uint8_t> expected;
+  expected.insert(expected.end(), start_code, start_code + sizeof(start_code));
+  expected.insert(expected.end(), {H264::NaluType::kSps, 13});
+  EXPECT_THAT(Bitstream(fixed), ElementsAreArray(expected));
+}
+
 TEST_F(TestH264SpsPpsTracker, StapAIncorrectSegmentLength) {
   uint8_t data[] = {0, 0, 2, 0};
   H264VideoHeader header;
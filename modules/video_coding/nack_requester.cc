@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <limits>
+#include <utility>
 
 #include "api/sequence_checker.h"
 #include "api/units/timestamp.h"
@@ -29,6 +30,7 @@ constexpr int kMaxNackRetries = 10;
 constexpr int kMaxReorderedPackets = 128;
 constexpr int kNumReorderingBuckets = 10;
 constexpr TimeDelta kDefaultSendNackDelay = TimeDelta::Zero();
+constexpr int kMinNackRingSize = 64;
 
 TimeDelta GetSendNackDelay(const FieldTrialsView& field_trials) {
   int64_t delay_ms = strtol(
@@ -171,11 +173,11 @@ int NackRequester::OnReceivedPacket(uint16_t seq_num,
 
   if (AheadOf(newest_seq_num_, seq_num)) {
     // An out of order packet has been received.
-    auto nack_list_it = nack_list_.find(seq_num);
+    const int slot = FindNack(seq_num);
     int nacks_sent_for_packet = 0;
-    if (nack_list_it != nack_list_.end()) {
-      nacks_sent_for_packet = nack_list_it->second.retries;
-      nack_list_.erase(nack_list_it);
+    if (slot != kNoSlot) {
+      nacks_sent_for_packet = nack_slots_[slot].retries;
+      EraseNack(slot);
     }
     if (!is_retransmitted)
       UpdateReorderingStatistics(seq_num);
@@ -224,7 +226,7 @@ void NackRequester::ClearUpTo(uint16_t seq_num) {
   // needs to be posted to the worker thread if callers migrate to the network
   // thread.
   RTC_DCHECK_RUN_ON(worker_thread_);
-  nack_list_.erase(nack_list_.begin(), nack_list_.lower_bound(seq_num));
+  EraseNacksOlderThan(seq_num);
   keyframe_list_.erase(keyframe_list_.begin(),
                        keyframe_list_.lower_bound(seq_num));
   recovered_list_.erase(recovered_list_.begin(),
@@ -239,12 +241,12 @@ void NackRequester::UpdateRtt(int64_t rtt_ms) {
 bool NackRequester::RemovePacketsUntilKeyFrame() {
   // Called on worker_thread_.
   while (!keyframe_list_.empty()) {
-    auto it = nack_list_.lower_bound(*keyframe_list_.begin());
+    const uint16_t keyframe_seq_num = *keyframe_list_.begin();
 
-    if (it != nack_list_.begin()) {
+    if (nack_list_size_ > 0 && AheadOf(keyframe_seq_num, nack_ring_begin_)) {
       // We have found a keyframe that actually is newer than at least one
       // packet in the nack list.
-      nack_list_.erase(nack_list_.begin(), it);
+      EraseNacksOlderThan(keyframe_seq_num);
       return true;
     }
 
@@ -259,20 +261,19 @@ void NackRequester::AddPacketsToNack(uint16_t seq_num_start,
                                      uint16_t seq_num_end) {
   // Called on worker_thread_.
   // Remove old packets.
-  auto it = nack_list_.lower_bound(seq_num_end - kMaxPacketAge);
-  nack_list_.erase(nack_list_.begin(), it);
+  EraseNacksOlderThan(seq_num_end - kMaxPacketAge);
 
   // If the nack list is too large, remove packets from the nack list until
   // the latest first packet of a keyframe. If the list is still too large,
   // clear it and request a keyframe.
   uint16_t num_new_nacks = ForwardDiff(seq_num_start, seq_num_end);
-  if (nack_list_.size() + num_new_nacks > kMaxNackPackets) {
+  if (nack_list_size_ + num_new_nacks > kMaxNackPackets) {
     while (RemovePacketsUntilKeyFrame() &&
-           nack_list_.size() + num_new_nacks > kMaxNackPackets) {
+           nack_list_size_ + num_new_nacks > kMaxNackPackets) {
     }
 
-    if (nack_list_.size() + num_new_nacks > kMaxNackPackets) {
-      nack_list_.clear();
+    if (nack_list_size_ + num_new_nacks > kMaxNackPackets) {
+      ClearNacks();
       RTC_LOG(LS_WARNING) << "NACK list full, clearing NACK"
                              " list and requesting keyframe.";
       keyframe_request_sender_->RequestKeyFrame();
@@ -286,8 +287,8 @@ void NackRequester::AddPacketsToNack(uint16_t seq_num_start,
       continue;
     NackInfo nack_info(seq_num, seq_num + WaitNumberOfPackets(0.5),
                        clock_->CurrentTime());
-    RTC_DCHECK(nack_list_.find(seq_num) == nack_list_.end());
-    nack_list_[seq_num] = nack_info;
+    RTC_DCHECK_EQ(FindNack(seq_num), kNoSlot);
+    InsertNack(nack_info);
   }
 }
 
@@ -297,33 +298,165 @@ std::vector<uint16_t> NackRequester::GetNackBatch(NackFilterOptions options) {
   bool consider_seq_num = options != kTimeOnly;
   bool consider_timestamp = options != kSeqNumOnly;
   Timestamp now = clock_->CurrentTime();
-  std::vector<uint16_t> nack_batch;
-  auto it = nack_list_.begin();
-  while (it != nack_list_.end()) {
-    bool delay_timed_out = now - it->second.created_at_time >= send_nack_delay_;
-    bool nack_on_rtt_passed = now - it->second.sent_at_time >= rtt_;
+  nack_batch_slots_.clear();
+  // The packets that have not been nacked yet were added in order, so the
+  // send delay times out in list order. Their rtt has always passed.
+  for (int slot = pending_nacks_.first; slot != kNoSlot;
+       slot = nack_slots_[slot].next) {
+    const NackInfo& nack_info = nack_slots_[slot];
+    if (now - nack_info.created_at_time < send_nack_delay_)
+      break;
     bool nack_on_seq_num_passed =
-        it->second.sent_at_time.IsInfinite() &&
-        AheadOrAt(newest_seq_num_, it->second.send_at_seq_num);
-    if (delay_timed_out && ((consider_seq_num && nack_on_seq_num_passed) ||
-                            (consider_timestamp && nack_on_rtt_passed))) {
-      nack_batch.emplace_back(it->second.seq_num);
-      ++it->second.retries;
-      it->second.sent_at_time = now;
-      if (it->second.retries >= kMaxNackRetries) {
-        RTC_LOG(LS_WARNING) << "Sequence number " << it->second.seq_num
-                            << " removed from NACK list due to max retries.";
-        it = nack_list_.erase(it);
-      } else {
-        ++it;
-      }
-      continue;
+        AheadOrAt(newest_seq_num_, nack_info.send_at_seq_num);
+    if (consider_timestamp || (consider_seq_num && nack_on_seq_num_passed))
+      nack_batch_slots_.push_back(slot);
+  }
+  if (consider_timestamp) {
+    for (int slot = sent_nacks_.first; slot != kNoSlot;
+         slot = nack_slots_[slot].next) {
+      if (now - nack_slots_[slot].sent_at_time < rtt_)
+        break;
+      nack_batch_slots_.push_back(slot);
+    }
+  }
+
+  // Nack the packets in sequence number order.
+  const uint16_t oldest_seq_num = nack_ring_begin_;
+  const std::vector<NackInfo>& nack_slots = nack_slots_;
+  std::sort(nack_batch_slots_.begin(), nack_batch_slots_.end(),
+            [&](int a, int b) {
+              return ForwardDiff(oldest_seq_num, nack_slots[a].seq_num) <
+                     ForwardDiff(oldest_seq_num, nack_slots[b].seq_num);
+            });
+
+  std::vector<uint16_t> nack_batch;
+  nack_batch.reserve(nack_batch_slots_.size());
+  for (int slot : nack_batch_slots_) {
+    NackInfo& nack_info = nack_slots_[slot];
+    nack_batch.emplace_back(nack_info.seq_num);
+    UnlinkNack(slot);
+    ++nack_info.retries;
+    nack_info.sent_at_time = now;
+    LinkNack(sent_nacks_, slot);
+    if (nack_info.retries >= kMaxNackRetries) {
+      RTC_LOG(LS_WARNING) << "Sequence number " << nack_info.seq_num
+                          << " removed from NACK list due to max retries.";
+      EraseNack(slot);
     }
-    ++it;
   }
   return nack_batch;
 }
 
+int NackRequester::FindNack(uint16_t seq_num) const {
+  // Called on worker_thread_.
+  if (ForwardDiff(nack_ring_begin_, seq_num) >= nack_ring_size_)
+    return kNoSlot;
+  return nack_ring_[seq_num & (nack_ring_.size() - 1)];
+}
+
+void NackRequester::InsertNack(const NackInfo& nack_info) {
+  // Called on worker_thread_.
+  if (nack_list_size_ == 0) {
+    nack_ring_begin_ = nack_info.seq_num;
+    nack_ring_size_ = 0;
+  }
+  const int ring_size = ForwardDiff(nack_ring_begin_, nack_info.seq_num) + 1;
+  RTC_DCHECK_GT(ring_size, nack_ring_size_);
+  if (ring_size > static_cast<int>(nack_ring_.size()))
+    GrowNackRing(ring_size);
+  nack_ring_size_ = ring_size;
+
+  int slot;
+  if (free_nack_slots_.empty()) {
+    slot = nack_slots_.size();
+    nack_slots_.push_back(nack_info);
+  } else {
+    slot = free_nack_slots_.back();
+    free_nack_slots_.pop_back();
+    nack_slots_[slot] = nack_info;
+  }
+  nack_ring_[nack_info.seq_num & (nack_ring_.size() - 1)] = slot;
+  LinkNack(pending_nacks_, slot);
+  ++nack_list_size_;
+}
+
+void NackRequester::EraseNack(int slot) {
+  // Called on worker_thread_.
+  UnlinkNack(slot);
+  const size_t mask = nack_ring_.size() - 1;
+  nack_ring_[nack_slots_[slot].seq_num & mask] = kNoSlot;
+  free_nack_slots_.push_back(slot);
+  --nack_list_size_;
+  // Keep the oldest packet in the list at the beginning of the ring.
+  while (nack_ring_size_ > 0 &&
+         nack_ring_[nack_ring_begin_ & mask] == kNoSlot) {
+    ++nack_ring_begin_;
+    --nack_ring_size_;
+  }
+}
+
+void NackRequester::EraseNacksOlderThan(uint16_t seq_num) {
+  // Called on worker_thread_.
+  while (nack_ring_size_ > 0 && AheadOf(seq_num, nack_ring_begin_)) {
+    EraseNack(nack_ring_[nack_ring_begin_ & (nack_ring_.size() - 1)]);
+  }
+}
+
+void NackRequester::ClearNacks() {
+  // Called on worker_thread_.
+  std::fill(nack_ring_.begin(), nack_ring_.end(), kNoSlot);
+  nack_ring_size_ = 0;
+  nack_slots_.clear();
+  free_nack_slots_.clear();
+  nack_list_size_ = 0;
+  pending_nacks_ = NackSlotList();
+  sent_nacks_ = NackSlotList();
+}
+
+void NackRequester::GrowNackRing(int min_size) {
+  // Called on worker_thread_.
+  size_t size = std::max<size_t>(nack_ring_.size(), kMinNackRingSize);
+  while (size < static_cast<size_t>(min_size))
+    size *= 2;
+  RTC_DCHECK_LE(size, 1 << 16);
+  std::vector<int> ring(size, kNoSlot);
+  for (int i = 0; i < nack_ring_size_; ++i) {
+    const uint16_t seq_num = nack_ring_begin_ + i;
+    ring[seq_num & (size - 1)] = nack_ring_[seq_num & (nack_ring_.size() - 1)];
+  }
+  nack_ring_ = std::move(ring);
+}
+
+void NackRequester::LinkNack(NackSlotList& list, int slot) {
+  // Called on worker_thread_.
+  NackInfo& nack_info = nack_slots_[slot];
+  nack_info.prev = list.last;
+  nack_info.next = kNoSlot;
+  if (list.last == kNoSlot) {
+    list.first = slot;
+  } else {
+    nack_slots_[list.last].next = slot;
+  }
+  list.last = slot;
+}
+
+void NackRequester::UnlinkNack(int slot) {
+  // Called on worker_thread_.
+  NackInfo& nack_info = nack_slots_[slot];
+  NackSlotList& list =
+      nack_info.sent_at_time.IsInfinite() ? pending_nacks_ : sent_nacks_;
+  if (nack_info.prev == kNoSlot) {
+    list.first = nack_info.next;
+  } else {
+    nack_slots_[nack_info.prev].next = nack_info.next;
+  }
+  if (nack_info.next == kNoSlot) {
+    list.last = nack_info.prev;
+  } else {
+    nack_slots_[nack_info.next].prev = nack_info.prev;
+  }
+}
+
 void NackRequester::UpdateReorderingStatistics(uint16_t seq_num) {
   // Running on worker_thread_.
   RTC_DCHECK(AheadOf(newest_seq_num_, seq_num));
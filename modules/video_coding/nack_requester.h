@@ -13,7 +13,6 @@
 
 #include <stdint.h>
 
-#include <map>
 #include <set>
 #include <vector>
 
@@ -89,6 +88,8 @@ class NackRequester final : public NackRequesterBase {
   // GetNackBatch.
   enum NackFilterOptions { kSeqNumOnly, kTimeOnly, kSeqNumAndTime };
 
+  static constexpr int kNoSlot = -1;
+
   // This class holds the sequence number of the packet that is in the nack list
   // as well as the meta data about when it should be nacked and how many times
   // we have tried to nack this packet.
@@ -103,6 +104,15 @@ class NackRequester final : public NackRequesterBase {
     Timestamp created_at_time;
     Timestamp sent_at_time;
     int retries;
+    // Links to the neighbours in `pending_nacks_` or `sent_nacks_`.
+    int prev = kNoSlot;
+    int next = kNoSlot;
+  };
+
+  // A doubly linked list of slots of `nack_slots_`.
+  struct NackSlotList {
+    int first = kNoSlot;
+    int last = kNoSlot;
   };
 
   void AddPacketsToNack(uint16_t seq_num_start, uint16_t seq_num_end)
@@ -115,6 +125,22 @@ class NackRequester final : public NackRequesterBase {
   std::vector<uint16_t> GetNackBatch(NackFilterOptions options)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(worker_thread_);
 
+  // Returns the slot of the packet in the nack list, or kNoSlot.
+  int FindNack(uint16_t seq_num) const
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(worker_thread_);
+  // Adds a packet that is newer than all packets in the nack list.
+  void InsertNack(const NackInfo& nack_info)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(worker_thread_);
+  void EraseNack(int slot) RTC_EXCLUSIVE_LOCKS_REQUIRED(worker_thread_);
+  // Removes the packets that are older than `seq_num` from the nack list.
+  void EraseNacksOlderThan(uint16_t seq_num)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(worker_thread_);
+  void ClearNacks() RTC_EXCLUSIVE_LOCKS_REQUIRED(worker_thread_);
+  void GrowNackRing(int min_size) RTC_EXCLUSIVE_LOCKS_REQUIRED(worker_thread_);
+  void LinkNack(NackSlotList& list, int slot)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(worker_thread_);
+  void UnlinkNack(int slot) RTC_EXCLUSIVE_LOCKS_REQUIRED(worker_thread_);
+
   // Update the reordering distribution.
   void UpdateReorderingStatistics(uint16_t seq_num)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(worker_thread_);
@@ -132,8 +158,23 @@ class NackRequester final : public NackRequesterBase {
   // TODO(philipel): Some of the variables below are consistently used on a
   // known thread (e.g. see `initialized_`). Those probably do not need
   // synchronized access.
-  std::map<uint16_t, NackInfo, DescendingSeqNumComp<uint16_t>> nack_list_
-      RTC_GUARDED_BY(worker_thread_);
+  // The nack list. `nack_ring_` maps the sequence numbers from the oldest
+  // packet in the list, `nack_ring_begin_`, to the `nack_ring_size_` - 1 newer
+  // ones to their slots in `nack_slots_`, or to kNoSlot for the packets that
+  // are not in the list. The ring size is a power of two.
+  std::vector<int> nack_ring_ RTC_GUARDED_BY(worker_thread_);
+  uint16_t nack_ring_begin_ RTC_GUARDED_BY(worker_thread_) = 0;
+  int nack_ring_size_ RTC_GUARDED_BY(worker_thread_) = 0;
+  std::vector<NackInfo> nack_slots_ RTC_GUARDED_BY(worker_thread_);
+  std::vector<int> free_nack_slots_ RTC_GUARDED_BY(worker_thread_);
+  size_t nack_list_size_ RTC_GUARDED_BY(worker_thread_) = 0;
+  // The packets that have not been nacked yet, in the order they were added,
+  // and the packets that have, in the order they were last nacked. Since the
+  // send delay and the rtt are the same for all packets, both lists are
+  // ordered by deadline and collecting the due nacks only visits those.
+  NackSlotList pending_nacks_ RTC_GUARDED_BY(worker_thread_);
+  NackSlotList sent_nacks_ RTC_GUARDED_BY(worker_thread_);
+  std::vector<int> nack_batch_slots_ RTC_GUARDED_BY(worker_thread_);
   std::set<uint16_t, DescendingSeqNumComp<uint16_t>> keyframe_list_
       RTC_GUARDED_BY(worker_thread_);
   std::set<uint16_t, DescendingSeqNumComp<uint16_t>> recovered_list_
@@ -0,0 +1,115 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdint.h>
+
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include "api/task_queue/task_queue_base.h"
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "benchmark/benchmark.h"
+#include "modules/include/module_common_types.h"
+#include "modules/video_coding/nack_requester.h"
+#include "rtc_base/random.h"
+#include "rtc_base/system/unused.h"
+#include "rtc_base/thread.h"
+#include "system_wrappers/include/clock.h"
+#include "test/explicit_key_value_config.h"
+
+namespace webrtc {
+namespace {
+
+constexpr TimeDelta kPacketInterval = TimeDelta::Micros(200);  // 5000 pps.
+constexpr TimeDelta kRtt = TimeDelta::Millis(100);
+constexpr double kLossRate = 0.3;
+// Gilbert-Elliott loss with bursts of 5 packets on average.
+constexpr double kBurstEndProbability = 0.2;
+constexpr double kBurstStartProbability =
+    kLossRate * kBurstEndProbability / (1 - kLossRate);
+
+class NackRecorder : public NackSender, public KeyFrameRequestSender {
+ public:
+  void SendNack(const std::vector<uint16_t>& sequence_numbers,
+                bool /*buffering_allowed*/) override {
+    nacks.insert(nacks.end(), sequence_numbers.begin(),
+                 sequence_numbers.end());
+  }
+  void RequestKeyFrame() override { ++keyframes_requested; }
+
+  std::vector<uint16_t> nacks;
+  int keyframes_requested = 0;
+};
+
+// Receives a stream of 5000 packets per second with 30% bursty loss. The
+// lost packets are nacked and their retransmissions, which are lost at the
+// same rate, arrive one rtt later.
+void BM_NackRequester5kPpsBurstyLoss(benchmark::State& state) {
+  rtc::AutoThread main_thread;
+  SimulatedClock clock(Timestamp::Seconds(1));
+  NackPeriodicProcessor periodic_processor;
+  NackRecorder recorder;
+  test::ExplicitKeyValueConfig field_trials("");
+  NackRequester nack_requester(TaskQueueBase::Current(), &periodic_processor,
+                               &clock, &recorder, &recorder, field_trials);
+  nack_requester.UpdateRtt(kRtt.ms());
+  Random random(0x5eed);
+  std::deque<std::pair<Timestamp, uint16_t>> retransmissions;
+  bool in_burst = false;
+  uint16_t seq_num = 0;
+  Timestamp next_process_time =
+      clock.CurrentTime() + NackPeriodicProcessor::kUpdateInterval;
+  int64_t num_packets = 0;
+  int64_t num_nacks = 0;
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    clock.AdvanceTime(kPacketInterval);
+    const Timestamp now = clock.CurrentTime();
+    in_burst = random.Rand<double>() <
+               (in_burst ? 1 - kBurstEndProbability : kBurstStartProbability);
+    if (!in_burst) {
+      nack_requester.OnReceivedPacket(seq_num, /*is_keyframe=*/false);
+    }
+    ++seq_num;
+    ++num_packets;
+
+    while (!retransmissions.empty() && retransmissions.front().first <= now) {
+      nack_requester.OnReceivedPacket(retransmissions.front().second,
+                                      /*is_keyframe=*/false);
+      retransmissions.pop_front();
+    }
+    if (now >= next_process_time) {
+      nack_requester.ProcessNacks();
+      next_process_time += NackPeriodicProcessor::kUpdateInterval;
+    }
+
+    for (uint16_t nacked_seq_num : recorder.nacks) {
+      if (random.Rand<double>() >= kLossRate) {
+        retransmissions.emplace_back(now + kRtt, nacked_seq_num);
+      }
+    }
+    num_nacks += recorder.nacks.size();
+    recorder.nacks.clear();
+  }
+
+  state.SetItemsProcessed(num_packets);
+  state.counters["time_per_packet"] = benchmark::Counter(
+      num_packets, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+  state.counters["nacks_per_packet"] =
+      num_packets > 0 ? static_cast<double>(num_nacks) / num_packets : 0;
+  state.counters["keyframes_requested"] = recorder.keyframes_requested;
+}
+
+BENCHMARK(BM_NackRequester5kPpsBurstyLoss);
+
+}  // namespace
+}  // namespace webrtc
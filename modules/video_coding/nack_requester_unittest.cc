@@ -16,11 +16,15 @@
 #include <memory>
 
 #include "system_wrappers/include/clock.h"
+#include "test/gmock.h"
 #include "test/gtest.h"
 #include "test/run_loop.h"
 #include "test/scoped_key_value_config.h"
 
 namespace webrtc {
+
+using ::testing::ElementsAre;
+
 // TODO(bugs.webrtc.org/11594): Use the use the GlobalSimulatedTimeController
 // instead of RunLoop. At the moment we mix use of the Clock and the underlying
 // implementation of RunLoop, which is realtime.
@@ -223,6 +227,24 @@ TEST_F(TestNackRequester, ResendNack) {
   EXPECT_EQ(expected_nacks_sent, sent_nacks_.size());
 }
 
+TEST_F(TestNackRequester, ResendsNacksInSequenceNumberOrder) {
+  NackRequester& nack_module = CreateNackModule(TimeDelta::Millis(1));
+  nack_module.OnReceivedPacket(1, false, false);
+  nack_module.OnReceivedPacket(3, false, false);
+  clock_->AdvanceTimeMilliseconds(kDefaultRttMs / 2);
+  nack_module.OnReceivedPacket(5, false, false);
+  ASSERT_THAT(sent_nacks_, ElementsAre(2, 4));
+
+  // Only 2 is resent, which makes it the packet that was nacked last.
+  clock_->AdvanceTimeMilliseconds(kDefaultRttMs / 2);
+  WaitForSendNack();
+  ASSERT_THAT(sent_nacks_, ElementsAre(2, 4, 2));
+
+  clock_->AdvanceTimeMilliseconds(2 * kDefaultRttMs);
+  WaitForSendNack();
+  EXPECT_THAT(sent_nacks_, ElementsAre(2, 4, 2, 2, 4));
+}
+
 TEST_F(TestNackRequester, ResendPacketMaxRetries) {
   NackRequester& nack_module = CreateNackModule(TimeDelta::Millis(1));
   nack_module.OnReceivedPacket(1, false, false);
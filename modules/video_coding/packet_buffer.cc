@@ -60,6 +60,44 @@ PacketBuffer::~PacketBuffer() {
   Clear();
 }
 
+std::unique_ptr<PacketBuffer::Packet> PacketBuffer::CreatePacket(
+    const RtpPacketReceived& rtp_packet,
+    const RTPVideoHeader& video_header) {
+  if (free_packets_.empty()) {
+    return std::make_unique<Packet>(rtp_packet, video_header);
+  }
+  std::unique_ptr<Packet> packet = std::move(free_packets_.back());
+  free_packets_.pop_back();
+  RTC_DCHECK_EQ(packet->video_payload.size(), 0u);
+  RTC_DCHECK_EQ(packet->video_payload_prefix.size(), 0u);
+  packet->continuous = false;
+  packet->marker_bit = rtp_packet.Marker();
+  packet->payload_type = rtp_packet.PayloadType();
+  packet->seq_num = rtp_packet.SequenceNumber();
+  packet->timestamp = rtp_packet.Timestamp();
+  packet->times_nacked = -1;
+  // Reuses the capacity of the containers of the video header.
+  packet->video_header = video_header;
+  return packet;
+}
+
+void PacketBuffer::RecyclePackets(
+    std::vector<std::unique_ptr<Packet>> packets) {
+  for (std::unique_ptr<Packet>& packet : packets) {
+    RecyclePacket(std::move(packet));
+  }
+}
+
+void PacketBuffer::RecyclePacket(std::unique_ptr<Packet> packet) {
+  if (packet == nullptr || free_packets_.size() >= buffer_.size()) {
+    return;
+  }
+  // Don't hold on to the received RTP packet.
+  packet->video_payload_prefix = rtc::CopyOnWriteBuffer();
+  packet->video_payload = rtc::CopyOnWriteBuffer();
+  free_packets_.push_back(std::move(packet));
+}
+
 PacketBuffer::InsertResult PacketBuffer::InsertPacket(
     std::unique_ptr<PacketBuffer::Packet> packet) {
   PacketBuffer::InsertResult result;
@@ -74,6 +112,7 @@ PacketBuffer::InsertResult PacketBuffer::InsertPacket(
     // If we have explicitly cleared past this packet then it's old,
     // don't insert it, just silently ignore it.
     if (is_cleared_to_first_seq_num_) {
+      RecyclePacket(std::move(packet));
       return result;
     }
 
@@ -83,6 +122,7 @@ PacketBuffer::InsertResult PacketBuffer::InsertPacket(
   if (buffer_[index] != nullptr) {
     // Duplicate packet, just delete the payload.
     if (buffer_[index]->seq_num == packet->seq_num) {
+      RecyclePacket(std::move(packet));
       return result;
     }
 
@@ -134,7 +174,7 @@ void PacketBuffer::ClearTo(uint16_t seq_num) {
   for (size_t i = 0; i < iterations; ++i) {
     auto& stored = buffer_[first_seq_num_ % buffer_.size()];
     if (stored != nullptr && AheadOf<uint16_t>(seq_num, stored->seq_num)) {
-      stored = nullptr;
+      RecyclePacket(std::move(stored));
     }
     ++first_seq_num_;
   }
@@ -173,7 +213,7 @@ void PacketBuffer::ResetSpsPpsIdrIsH264Keyframe() {
 
 void PacketBuffer::ClearInternal() {
   for (auto& entry : buffer_) {
-    entry = nullptr;
+    RecyclePacket(std::move(entry));
   }
 
   first_packet_received_ = false;
@@ -61,6 +61,9 @@ class PacketBuffer {
     uint32_t timestamp = 0;
     int times_nacked = -1;
 
+    // Data that precedes `video_payload` in the assembled frame, e.g. the
+    // H.264 start code, when the payload is kept as it was received.
+    rtc::CopyOnWriteBuffer video_payload_prefix;
     rtc::CopyOnWriteBuffer video_payload;
     RTPVideoHeader video_header;
   };
@@ -75,6 +78,15 @@ class PacketBuffer {
   PacketBuffer(size_t start_buffer_size, size_t max_buffer_size);
   ~PacketBuffer();
 
+  // Returns a packet for `rtp_packet`. The storage of a packet handed back
+  // through RecyclePackets() is reused if there is one, which saves the heap
+  // allocations of the packet and its video header for each received packet.
+  std::unique_ptr<Packet> CreatePacket(const RtpPacketReceived& rtp_packet,
+                                       const RTPVideoHeader& video_header);
+  // Hands back the packets of an InsertResult once their frames have been
+  // assembled.
+  void RecyclePackets(std::vector<std::unique_ptr<Packet>> packets);
+
   ABSL_MUST_USE_RESULT InsertResult
   InsertPacket(std::unique_ptr<Packet> packet);
   ABSL_MUST_USE_RESULT InsertResult InsertPadding(uint16_t seq_num);
@@ -86,6 +98,7 @@ class PacketBuffer {
 
  private:
   void ClearInternal();
+  void RecyclePacket(std::unique_ptr<Packet> packet);
 
   // Tries to expand the buffer.
   bool ExpandBufferSize();
@@ -115,6 +128,10 @@ class PacketBuffer {
   // determine continuity between them.
   std::vector<std::unique_ptr<Packet>> buffer_;
 
+  // Packets that are no longer used, with their payload released. At most
+  // buffer_.size() packets are kept.
+  std::vector<std::unique_ptr<Packet>> free_packets_;
+
   absl::optional<uint16_t> newest_inserted_seq_num_;
   std::set<uint16_t, DescendingSeqNumComp<uint16_t>> missing_packets_;
 
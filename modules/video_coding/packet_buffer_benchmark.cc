@@ -0,0 +1,159 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "api/array_view.h"
+#include "api/scoped_refptr.h"
+#include "api/video/encoded_image.h"
+#include "api/video/video_codec_type.h"
+#include "api/video/video_frame_type.h"
+#include "benchmark/benchmark.h"
+#include "modules/rtp_rtcp/source/create_video_rtp_depacketizer.h"
+#include "modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "modules/rtp_rtcp/source/rtp_video_header.h"
+#include "modules/rtp_rtcp/source/video_rtp_depacketizer.h"
+#include "modules/video_coding/codecs/vp9/include/vp9_globals.h"
+#include "modules/video_coding/packet_buffer.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/copy_on_write_buffer.h"
+#include "rtc_base/system/unused.h"
+
+namespace {
+std::atomic<int64_t> g_num_allocations{0};
+}  // namespace
+
+// Counts the heap allocations of the benchmarks. This replaces the allocator
+// of the whole executable, which is why these benchmarks are not linked into
+// the shared benchmarks target.
+void* operator new(size_t size) {
+  g_num_allocations.fetch_add(1, std::memory_order_relaxed);
+  void* p = malloc(size > 0 ? size : 1);
+  RTC_CHECK(p);
+  return p;
+}
+
+void operator delete(void* p) noexcept {
+  free(p);
+}
+
+void operator delete(void* p, size_t /*size*/) noexcept {
+  free(p);
+}
+
+namespace webrtc {
+namespace {
+
+// 4K VP9 at 60 fps and 20 Mbit/s, about 35 packets with 1200 bytes of payload
+// per frame.
+constexpr int kFrameRate = 60;
+constexpr int kBitrateBps = 20'000'000;
+constexpr int kPayloadSize = 1200;
+constexpr int kPacketsPerFrame =
+    (kBitrateBps / kFrameRate / 8 + kPayloadSize - 1) / kPayloadSize;
+constexpr int kKeyFrameInterval = 300;
+
+// Receives frames one packet at a time, like RtpVideoStreamReceiver2, and
+// assembles each complete frame into one bitstream buffer.
+void ReceiveVp9Frames(benchmark::State& state, bool recycle_packets) {
+  video_coding::PacketBuffer packet_buffer(/*start_buffer_size=*/512,
+                                           /*max_buffer_size=*/2048);
+  std::unique_ptr<VideoRtpDepacketizer> depacketizer =
+      CreateVideoRtpDepacketizer(kVideoCodecVP9);
+  // The payload shares the buffer of the received packet.
+  const rtc::CopyOnWriteBuffer payload(kPayloadSize, kPayloadSize);
+  RtpPacketReceived rtp_packet;
+  rtp_packet.SetPayloadType(98);
+  RTPVideoHeader video_header;
+  video_header.codec = kVideoCodecVP9;
+  video_header.width = 3840;
+  video_header.height = 2160;
+  RTPVideoHeaderVP9& vp9_header =
+      video_header.video_type_header.emplace<RTPVideoHeaderVP9>();
+  vp9_header.InitRTPVideoHeaderVP9();
+  std::vector<rtc::ArrayView<const uint8_t>> payloads;
+  payloads.reserve(kPacketsPerFrame);
+
+  uint16_t seq_num = 0;
+  uint32_t rtp_timestamp = 0;
+  int64_t num_frames = 0;
+  int64_t num_packets = 0;
+  const int64_t num_allocations_before = g_num_allocations.load();
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    video_header.frame_type = num_frames % kKeyFrameInterval == 0
+                                  ? VideoFrameType::kVideoFrameKey
+                                  : VideoFrameType::kVideoFrameDelta;
+    rtp_packet.SetTimestamp(rtp_timestamp);
+    for (int i = 0; i < kPacketsPerFrame; ++i) {
+      const bool first = i == 0;
+      const bool last = i == kPacketsPerFrame - 1;
+      rtp_packet.SetSequenceNumber(seq_num++);
+      rtp_packet.SetMarker(last);
+      video_header.is_first_packet_in_frame = first;
+      video_header.is_last_packet_in_frame = last;
+      vp9_header.beginning_of_frame = first;
+      vp9_header.end_of_frame = last;
+
+      std::unique_ptr<video_coding::PacketBuffer::Packet> packet =
+          recycle_packets
+              ? packet_buffer.CreatePacket(rtp_packet, video_header)
+              : std::make_unique<video_coding::PacketBuffer::Packet>(
+                    rtp_packet, video_header);
+      packet->video_payload = payload;
+      video_coding::PacketBuffer::InsertResult result =
+          packet_buffer.InsertPacket(std::move(packet));
+      if (result.packets.empty()) {
+        continue;
+      }
+      payloads.clear();
+      for (const auto& frame_packet : result.packets) {
+        payloads.emplace_back(frame_packet->video_payload);
+      }
+      rtc::scoped_refptr<EncodedImageBuffer> bitstream =
+          depacketizer->AssembleFrame(payloads);
+      benchmark::DoNotOptimize(bitstream->data());
+      if (recycle_packets) {
+        packet_buffer.RecyclePackets(std::move(result.packets));
+      }
+    }
+    num_packets += kPacketsPerFrame;
+    rtp_timestamp += 90'000 / kFrameRate;
+    ++num_frames;
+  }
+  const int64_t num_allocations =
+      g_num_allocations.load() - num_allocations_before;
+
+  state.SetItemsProcessed(num_packets);
+  state.counters["time_per_packet"] = benchmark::Counter(
+      num_packets, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+  state.counters["allocations_per_packet"] =
+      num_packets > 0 ? static_cast<double>(num_allocations) / num_packets : 0;
+}
+
+void BM_Receive4k60Vp9(benchmark::State& state) {
+  ReceiveVp9Frames(state, /*recycle_packets=*/false);
+}
+
+void BM_Receive4k60Vp9RecycledPackets(benchmark::State& state) {
+  ReceiveVp9Frames(state, /*recycle_packets=*/true);
+}
+
+BENCHMARK(BM_Receive4k60Vp9);
+BENCHMARK(BM_Receive4k60Vp9RecycledPackets);
+
+}  // namespace
+}  // namespace webrtc
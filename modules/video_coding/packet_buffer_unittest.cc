@@ -18,6 +18,8 @@
 #include "api/array_view.h"
 #include "common_video/h264/h264_common.h"
 #include "modules/rtp_rtcp/source/frame_object.h"
+#include "modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "modules/rtp_rtcp/source/rtp_video_header.h"
 #include "rtc_base/numerics/sequence_number_unwrapper.h"
 #include "rtc_base/random.h"
 #include "test/field_trial.h"
@@ -133,6 +135,59 @@ class PacketBufferTest : public ::testing::Test {
   PacketBuffer packet_buffer_;
 };
 
+TEST_F(PacketBufferTest, ReusesRecycledPackets) {
+  RtpPacketReceived rtp_packet;
+  rtp_packet.SetSequenceNumber(Rand());
+  rtp_packet.SetTimestamp(123);
+  rtp_packet.SetMarker(true);
+  RTPVideoHeader video_header;
+  video_header.codec = kVideoCodecGeneric;
+  video_header.is_first_packet_in_frame = true;
+  video_header.is_last_packet_in_frame = true;
+  const uint8_t kPayload[] = {1, 2, 3};
+
+  std::unique_ptr<PacketBuffer::Packet> packet =
+      packet_buffer_.CreatePacket(rtp_packet, video_header);
+  packet->video_payload.SetData(kPayload);
+  const PacketBuffer::Packet* storage = packet.get();
+  PacketBuffer::InsertResult result =
+      packet_buffer_.InsertPacket(std::move(packet));
+  ASSERT_THAT(result.packets, SizeIs(1));
+  packet_buffer_.RecyclePackets(std::move(result.packets));
+
+  rtp_packet.SetSequenceNumber(rtp_packet.SequenceNumber() + 1);
+  rtp_packet.SetTimestamp(456);
+  rtp_packet.SetMarker(false);
+  video_header.is_last_packet_in_frame = false;
+  packet = packet_buffer_.CreatePacket(rtp_packet, video_header);
+  EXPECT_EQ(packet.get(), storage);
+  EXPECT_EQ(packet->seq_num, rtp_packet.SequenceNumber());
+  EXPECT_EQ(packet->timestamp, 456u);
+  EXPECT_FALSE(packet->marker_bit);
+  EXPECT_FALSE(packet->continuous);
+  EXPECT_EQ(packet->times_nacked, -1);
+  EXPECT_FALSE(packet->is_last_packet_in_frame());
+  EXPECT_EQ(packet->video_payload.size(), 0u);
+}
+
+TEST_F(PacketBufferTest, ReusesPacketsRemovedByClearTo) {
+  RtpPacketReceived rtp_packet;
+  rtp_packet.SetSequenceNumber(Rand());
+  RTPVideoHeader video_header;
+  video_header.codec = kVideoCodecGeneric;
+  video_header.is_first_packet_in_frame = true;
+
+  std::unique_ptr<PacketBuffer::Packet> packet =
+      packet_buffer_.CreatePacket(rtp_packet, video_header);
+  const PacketBuffer::Packet* storage = packet.get();
+  EXPECT_THAT(packet_buffer_.InsertPacket(std::move(packet)).packets,
+              IsEmpty());
+  packet_buffer_.ClearTo(rtp_packet.SequenceNumber());
+
+  EXPECT_EQ(packet_buffer_.CreatePacket(rtp_packet, video_header).get(),
+            storage);
+}
+
 TEST_F(PacketBufferTest, InsertOnePacket) {
   const uint16_t seq_num = Rand();
   EXPECT_THAT(Insert(seq_num, kKeyFrame, kFirst, kLast).packets, SizeIs(1));
@@ -0,0 +1,213 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "api/rtp_packet_infos.h"
+#include "api/video/encoded_image.h"
+#include "api/video/video_codec_type.h"
+#include "api/video/video_content_type.h"
+#include "api/video/video_frame_type.h"
+#include "api/video/video_rotation.h"
+#include "api/video/video_timing.h"
+#include "benchmark/benchmark.h"
+#include "modules/rtp_rtcp/source/frame_object.h"
+#include "modules/rtp_rtcp/source/rtp_video_header.h"
+#include "modules/video_coding/codecs/vp8/include/vp8_globals.h"
+#include "modules/video_coding/codecs/vp9/include/vp9_globals.h"
+#include "modules/video_coding/rtp_frame_reference_finder.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/system/unused.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kFramesPerBlock = 256;
+constexpr int kPacketsPerFrame = 3;
+// The temporal layers of L1T3, which repeat every four frames.
+constexpr int kL1T3TemporalIdx[] = {0, 2, 1, 2};
+
+// A frame, or a padding packet if `frame` is null.
+struct ReceivedItem {
+  std::unique_ptr<RtpFrameObject> frame;
+  uint16_t padding_seq_num = 0;
+};
+
+std::unique_ptr<RtpFrameObject> CreateFrame(
+    uint16_t seq_num_start,
+    bool keyframe,
+    VideoCodecType codec,
+    const RTPVideoTypeHeader& video_type_header) {
+  RTPVideoHeader video_header;
+  video_header.frame_type = keyframe ? VideoFrameType::kVideoFrameKey
+                                     : VideoFrameType::kVideoFrameDelta;
+  video_header.video_type_header = video_type_header;
+
+  // clang-format off
+  return std::make_unique<RtpFrameObject>(
+      seq_num_start,
+      seq_num_start + kPacketsPerFrame - 1,
+      /*markerBit=*/true,
+      /*times_nacked=*/0,
+      /*first_packet_received_time=*/0,
+      /*last_packet_received_time=*/0,
+      /*rtp_timestamp=*/0,
+      /*ntp_time_ms=*/0,
+      VideoSendTiming(),
+      /*payload_type=*/0,
+      codec,
+      kVideoRotation_0,
+      VideoContentType::UNSPECIFIED,
+      video_header,
+      /*color_space=*/absl::nullopt,
+      RtpPacketInfos(),
+      EncodedImageBuffer::Create(/*size=*/0));
+  // clang-format on
+}
+
+// Inserts the items made by `create_item` into an RtpFrameReferenceFinder,
+// `kFramesPerBlock` frames per iteration. The items are created, and the
+// completed frames are destroyed, with the timer paused. Groups of
+// `state.range(0)` items arrive in reverse order, which makes the reference
+// finder stash the frames that arrive before their references.
+void InsertFrames(benchmark::State& state,
+                  std::function<ReceivedItem(int64_t frame_num)> create_item) {
+  const int reorder = state.range(0);
+  RtpFrameReferenceFinder reference_finder;
+  std::vector<ReceivedItem> items;
+  std::vector<std::unique_ptr<RtpFrameObject>> completed_frames;
+  int64_t num_frames = 0;
+  int64_t num_completed_frames = 0;
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    state.PauseTiming();
+    num_completed_frames += completed_frames.size();
+    completed_frames.clear();
+    items.clear();
+    for (int i = 0; i < kFramesPerBlock;) {
+      items.push_back(create_item(num_frames));
+      if (items.back().frame != nullptr) {
+        ++num_frames;
+        ++i;
+      }
+    }
+    for (size_t i = 0; i + reorder <= items.size(); i += reorder) {
+      std::reverse(items.begin() + i, items.begin() + i + reorder);
+    }
+    state.ResumeTiming();
+
+    for (ReceivedItem& item : items) {
+      RtpFrameReferenceFinder::ReturnVector frames =
+          item.frame != nullptr
+              ? reference_finder.ManageFrame(std::move(item.frame))
+              : reference_finder.PaddingReceived(item.padding_seq_num);
+      for (std::unique_ptr<RtpFrameObject>& frame : frames) {
+        completed_frames.push_back(std::move(frame));
+      }
+    }
+  }
+  num_completed_frames += completed_frames.size();
+  // All frames but the ones of the last reordered group are completed.
+  RTC_CHECK_GE(num_completed_frames, num_frames - reorder);
+
+  state.SetItemsProcessed(num_frames);
+  state.counters["time_per_frame"] = benchmark::Counter(
+      num_frames, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+void BM_RtpFrameReferenceFinderVp8L1T3(benchmark::State& state) {
+  int tl0_pic_idx = 0;
+  InsertFrames(state, [&](int64_t frame_num) {
+    RTPVideoHeaderVP8 vp8_header;
+    vp8_header.InitRTPVideoHeaderVP8();
+    vp8_header.pictureId = frame_num % (1 << 15);
+    vp8_header.temporalIdx = kL1T3TemporalIdx[frame_num % 4];
+    // The first frames of the upper temporal layers only reference the base
+    // layer.
+    vp8_header.layerSync = frame_num < 4 && vp8_header.temporalIdx > 0;
+    if (frame_num > 0 && vp8_header.temporalIdx == 0) {
+      ++tl0_pic_idx;
+    }
+    vp8_header.tl0PicIdx = tl0_pic_idx % 256;
+    return ReceivedItem{.frame = CreateFrame(frame_num * kPacketsPerFrame,
+                                             /*keyframe=*/frame_num == 0,
+                                             kVideoCodecVP8, vp8_header)};
+  });
+}
+
+void BM_RtpFrameReferenceFinderVp9L1T3(benchmark::State& state) {
+  GofInfoVP9 gof;
+  gof.SetGofInfoVP9(kTemporalStructureMode3);
+  int tl0_pic_idx = 0;
+  InsertFrames(state, [&](int64_t frame_num) {
+    const size_t gof_idx = frame_num % gof.num_frames_in_gof;
+    RTPVideoHeaderVP9 vp9_header;
+    vp9_header.InitRTPVideoHeaderVP9();
+    vp9_header.picture_id = frame_num % (1 << 15);
+    vp9_header.temporal_idx = gof.temporal_idx[gof_idx];
+    vp9_header.spatial_idx = 0;
+    vp9_header.temporal_up_switch = gof.temporal_up_switch[gof_idx];
+    vp9_header.inter_pic_predicted = frame_num > 0;
+    if (frame_num > 0 && vp9_header.temporal_idx == 0) {
+      ++tl0_pic_idx;
+    }
+    vp9_header.tl0_pic_idx = tl0_pic_idx % 256;
+    if (frame_num == 0) {
+      vp9_header.ss_data_available = true;
+      vp9_header.gof = gof;
+    }
+    return ReceivedItem{.frame = CreateFrame(frame_num * kPacketsPerFrame,
+                                             /*keyframe=*/frame_num == 0,
+                                             kVideoCodecVP9, vp9_header)};
+  });
+}
+
+// A generic stream without picture ids, with a padding packet after every
+// second frame. Reordered padding around the periodic Gop cleanup makes the
+// reference finder drop frames, so the items arrive in order.
+void BM_RtpFrameReferenceFinderGenericWithPadding(benchmark::State& state) {
+  uint16_t seq_num = 0;
+  bool padding_due = false;
+  InsertFrames(state, [&](int64_t frame_num) {
+    if (padding_due) {
+      padding_due = false;
+      return ReceivedItem{.padding_seq_num = seq_num++};
+    }
+    padding_due = frame_num % 2 == 1;
+    ReceivedItem item{.frame = CreateFrame(seq_num,
+                                           /*keyframe=*/frame_num == 0,
+                                           kVideoCodecGeneric,
+                                           RTPVideoTypeHeader())};
+    seq_num += kPacketsPerFrame;
+    return item;
+  });
+}
+
+BENCHMARK(BM_RtpFrameReferenceFinderVp8L1T3)
+    ->ArgName("reorder")
+    ->Arg(1)
+    ->Arg(4);
+BENCHMARK(BM_RtpFrameReferenceFinderVp9L1T3)
+    ->ArgName("reorder")
+    ->Arg(1)
+    ->Arg(4);
+BENCHMARK(BM_RtpFrameReferenceFinderGenericWithPadding)
+    ->ArgName("reorder")
+    ->Arg(1);
+
+}  // namespace
+}  // namespace webrtc
@@ -10,6 +10,7 @@
 
 #include "modules/video_coding/rtp_seq_num_only_ref_finder.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "rtc_base/logging.h"
@@ -41,9 +42,18 @@ RtpFrameReferenceFinder::ReturnVector RtpSeqNumOnlyRefFinder::ManageFrame(
 RtpSeqNumOnlyRefFinder::FrameDecision
 RtpSeqNumOnlyRefFinder::ManageFrameInternal(RtpFrameObject* frame) {
   if (frame->frame_type() == VideoFrameType::kVideoFrameKey) {
-    last_seq_num_gop_.insert(std::make_pair(
-        frame->last_seq_num(),
-        std::make_pair(frame->last_seq_num(), frame->last_seq_num())));
+    auto gop_it = std::lower_bound(
+        last_seq_num_gop_.begin(), last_seq_num_gop_.end(),
+        frame->last_seq_num(), [](const Gop& gop, uint16_t seq_num) {
+          return AheadOf<uint16_t>(seq_num, gop.keyframe_seq_num);
+        });
+    if (gop_it == last_seq_num_gop_.end() ||
+        gop_it->keyframe_seq_num != frame->last_seq_num()) {
+      last_seq_num_gop_.insert(
+          gop_it, {.keyframe_seq_num = frame->last_seq_num(),
+                   .last_picture_id = frame->last_seq_num(),
+                   .last_picture_id_with_padding = frame->last_seq_num()});
+    }
   }
 
   // We have received a frame but not yet a keyframe, stash this frame.
@@ -52,28 +62,32 @@ RtpSeqNumOnlyRefFinder::ManageFrameInternal(RtpFrameObject* frame) {
 
   // Clean up info for old keyframes but make sure to keep info
   // for the last keyframe.
-  auto clean_to = last_seq_num_gop_.lower_bound(frame->last_seq_num() - 100);
-  for (auto it = last_seq_num_gop_.begin();
-       it != clean_to && last_seq_num_gop_.size() > 1;) {
-    it = last_seq_num_gop_.erase(it);
-  }
+  uint16_t old_seq_num = frame->last_seq_num() - 100;
+  auto clean_to = std::lower_bound(
+      last_seq_num_gop_.begin(), last_seq_num_gop_.end(), old_seq_num,
+      [](const Gop& gop, uint16_t seq_num) {
+        return AheadOf<uint16_t>(seq_num, gop.keyframe_seq_num);
+      });
+  last_seq_num_gop_.erase(
+      last_seq_num_gop_.begin(),
+      std::min(clean_to, last_seq_num_gop_.end() - 1));
 
   // Find the last sequence number of the last frame for the keyframe
   // that this frame indirectly references.
-  auto seq_num_it = last_seq_num_gop_.upper_bound(frame->last_seq_num());
-  if (seq_num_it == last_seq_num_gop_.begin()) {
+  auto gop_it = FindGop(frame->last_seq_num());
+  if (gop_it == last_seq_num_gop_.end()) {
     RTC_LOG(LS_WARNING) << "Generic frame with packet range ["
                         << frame->first_seq_num() << ", "
                         << frame->last_seq_num()
                         << "] has no GoP, dropping frame.";
     return kDrop;
   }
-  seq_num_it--;
 
   // Make sure the packet sequence numbers are continuous, otherwise stash
   // this frame.
-  uint16_t last_picture_id_gop = seq_num_it->second.first;
-  uint16_t last_picture_id_with_padding_gop = seq_num_it->second.second;
+  uint16_t last_picture_id_gop = gop_it->last_picture_id;
+  uint16_t last_picture_id_with_padding_gop =
+      gop_it->last_picture_id_with_padding;
   if (frame->frame_type() == VideoFrameType::kVideoFrameDelta) {
     uint16_t prev_seq_num = frame->first_seq_num() - 1;
 
@@ -81,7 +95,7 @@ RtpSeqNumOnlyRefFinder::ManageFrameInternal(RtpFrameObject* frame) {
       return kStash;
   }
 
-  RTC_DCHECK(AheadOrAt(frame->last_seq_num(), seq_num_it->first));
+  RTC_DCHECK(AheadOrAt(frame->last_seq_num(), gop_it->keyframe_seq_num));
 
   // Since keyframes can cause reordering we can't simply assign the
   // picture id according to some incrementing counter.
@@ -90,8 +104,8 @@ RtpSeqNumOnlyRefFinder::ManageFrameInternal(RtpFrameObject* frame) {
       frame->frame_type() == VideoFrameType::kVideoFrameDelta;
   frame->references[0] = rtp_seq_num_unwrapper_.Unwrap(last_picture_id_gop);
   if (AheadOf<uint16_t>(frame->Id(), last_picture_id_gop)) {
-    seq_num_it->second.first = frame->Id();
-    seq_num_it->second.second = frame->Id();
+    gop_it->last_picture_id = frame->Id();
+    gop_it->last_picture_id_with_padding = frame->Id();
   }
 
   UpdateLastPictureIdWithPadding(frame->Id());
@@ -105,67 +119,125 @@ void RtpSeqNumOnlyRefFinder::RetryStashedFrames(
   bool complete_frame = false;
   do {
     complete_frame = false;
-    for (auto frame_it = stashed_frames_.begin();
-         frame_it != stashed_frames_.end();) {
-      FrameDecision decision = ManageFrameInternal(frame_it->get());
+    // Frames that remain stashed are moved towards the front, keeping their
+    // order, so that every retry is a single pass over the stash.
+    auto stash_it = stashed_frames_.begin();
+    for (std::unique_ptr<RtpFrameObject>& frame : stashed_frames_) {
+      FrameDecision decision = ManageFrameInternal(frame.get());
 
       switch (decision) {
         case kStash:
-          ++frame_it;
+          *stash_it++ = std::move(frame);
           break;
         case kHandOff:
           complete_frame = true;
-          res.push_back(std::move(*frame_it));
-          [[fallthrough]];
+          res.push_back(std::move(frame));
+          break;
         case kDrop:
-          frame_it = stashed_frames_.erase(frame_it);
+          break;
       }
     }
+    stashed_frames_.erase(stash_it, stashed_frames_.end());
   } while (complete_frame);
 }
 
 void RtpSeqNumOnlyRefFinder::UpdateLastPictureIdWithPadding(uint16_t seq_num) {
-  auto gop_seq_num_it = last_seq_num_gop_.upper_bound(seq_num);
+  auto gop_it = FindGop(seq_num);
 
   // If this padding packet "belongs" to a group of pictures that we don't track
   // anymore, do nothing.
-  if (gop_seq_num_it == last_seq_num_gop_.begin())
+  if (gop_it == last_seq_num_gop_.end())
     return;
-  --gop_seq_num_it;
 
   // Calculate the next contiuous sequence number and search for it in
   // the padding packets we have stashed.
-  uint16_t next_seq_num_with_padding = gop_seq_num_it->second.second + 1;
-  auto padding_seq_num_it =
-      stashed_padding_.lower_bound(next_seq_num_with_padding);
+  uint16_t next_seq_num_with_padding = gop_it->last_picture_id_with_padding + 1;
 
   // While there still are padding packets and those padding packets are
   // continuous, then advance the "last-picture-id-with-padding" and remove
   // the stashed padding packet.
-  while (padding_seq_num_it != stashed_padding_.end() &&
-         *padding_seq_num_it == next_seq_num_with_padding) {
-    gop_seq_num_it->second.second = next_seq_num_with_padding;
+  while (IsPaddingStashed(next_seq_num_with_padding)) {
+    gop_it->last_picture_id_with_padding = next_seq_num_with_padding;
+    ClearStashedPadding(next_seq_num_with_padding, 1);
     ++next_seq_num_with_padding;
-    padding_seq_num_it = stashed_padding_.erase(padding_seq_num_it);
   }
 
   // In the case where the stream has been continuous without any new keyframes
   // for a while there is a risk that new frames will appear to be older than
   // the keyframe they belong to due to wrapping sequence number. In order
   // to prevent this we advance the picture id of the keyframe every so often.
-  if (ForwardDiff(gop_seq_num_it->first, seq_num) > 10000) {
-    auto save = gop_seq_num_it->second;
-    last_seq_num_gop_.clear();
-    last_seq_num_gop_[seq_num] = save;
+  if (ForwardDiff(gop_it->keyframe_seq_num, seq_num) > 10000) {
+    Gop save = *gop_it;
+    save.keyframe_seq_num = seq_num;
+    last_seq_num_gop_.assign(1, save);
+  }
+}
+
+RtpSeqNumOnlyRefFinder::GopVector::iterator RtpSeqNumOnlyRefFinder::FindGop(
+    uint16_t seq_num) {
+  auto gop_it = std::upper_bound(
+      last_seq_num_gop_.begin(), last_seq_num_gop_.end(), seq_num,
+      [](uint16_t seq_num, const Gop& gop) {
+        return AheadOf<uint16_t>(gop.keyframe_seq_num, seq_num);
+      });
+  return gop_it == last_seq_num_gop_.begin() ? last_seq_num_gop_.end()
+                                             : gop_it - 1;
+}
+
+bool RtpSeqNumOnlyRefFinder::IsPaddingStashed(uint16_t seq_num) const {
+  if (last_padding_seq_num_ == -1 ||
+      ForwardDiff<uint16_t>(seq_num, last_padding_seq_num_) >=
+          kPaddingRingSize) {
+    return false;
+  }
+  const int bit = seq_num % kPaddingRingSize;
+  return (stashed_padding_[bit / 64] >> (bit % 64)) & 1;
+}
+
+void RtpSeqNumOnlyRefFinder::StashPadding(uint16_t seq_num) {
+  const int bit = seq_num % kPaddingRingSize;
+  stashed_padding_[bit / 64] |= uint64_t{1} << (bit % 64);
+}
+
+void RtpSeqNumOnlyRefFinder::ClearStashedPadding(uint16_t seq_num, int count) {
+  RTC_DCHECK_LE(count, kPaddingRingSize);
+  // Clear the bits one word at a time.
+  while (count > 0) {
+    const int bit = seq_num % kPaddingRingSize;
+    const int num_bits = std::min(count, 64 - bit % 64);
+    const uint64_t mask =
+        num_bits == 64 ? ~uint64_t{0} : (uint64_t{1} << num_bits) - 1;
+    stashed_padding_[bit / 64] &= ~(mask << (bit % 64));
+    seq_num += num_bits;
+    count -= num_bits;
   }
 }
 
 RtpFrameReferenceFinder::ReturnVector RtpSeqNumOnlyRefFinder::PaddingReceived(
     uint16_t seq_num) {
-  auto clean_padding_to =
-      stashed_padding_.lower_bound(seq_num - kMaxPaddingAge);
-  stashed_padding_.erase(stashed_padding_.begin(), clean_padding_to);
-  stashed_padding_.insert(seq_num);
+  if (last_padding_seq_num_ == -1 ||
+      AheadOf<uint16_t>(seq_num, last_padding_seq_num_)) {
+    // Clear the slots of the sequence numbers that enter the ring.
+    if (last_padding_seq_num_ == -1 ||
+        ForwardDiff<uint16_t>(last_padding_seq_num_, seq_num) >=
+            kPaddingRingSize) {
+      stashed_padding_.fill(0);
+    } else {
+      ClearStashedPadding(last_padding_seq_num_ + 1,
+                          ForwardDiff<uint16_t>(last_padding_seq_num_,
+                                                seq_num));
+    }
+    last_padding_seq_num_ = seq_num;
+  }
+  // Clean up padding packets that are too old.
+  uint16_t oldest_seq_num = last_padding_seq_num_ - (kPaddingRingSize - 1);
+  uint16_t old_seq_num = seq_num - kMaxPaddingAge;
+  if (AheadOf<uint16_t>(old_seq_num, oldest_seq_num)) {
+    ClearStashedPadding(oldest_seq_num,
+                        ForwardDiff<uint16_t>(oldest_seq_num, old_seq_num));
+  }
+  if (ForwardDiff<uint16_t>(seq_num, last_padding_seq_num_) < kPaddingRingSize)
+    StashPadding(seq_num);
   UpdateLastPictureIdWithPadding(seq_num);
   RtpFrameReferenceFinder::ReturnVector res;
   RetryStashedFrames(res);
@@ -173,14 +245,13 @@ RtpFrameReferenceFinder::ReturnVector RtpSeqNumOnlyRefFinder::PaddingReceived(
 }
 
 void RtpSeqNumOnlyRefFinder::ClearTo(uint16_t seq_num) {
-  auto it = stashed_frames_.begin();
-  while (it != stashed_frames_.end()) {
-    if (AheadOf<uint16_t>(seq_num, (*it)->first_seq_num())) {
-      it = stashed_frames_.erase(it);
-    } else {
-      ++it;
-    }
-  }
+  stashed_frames_.erase(
+      std::remove_if(stashed_frames_.begin(), stashed_frames_.end(),
+                     [seq_num](const std::unique_ptr<RtpFrameObject>& frame) {
+                       return AheadOf<uint16_t>(seq_num,
+                                                frame->first_seq_num());
+                     }),
+      stashed_frames_.end());
 }
 
 }  // namespace webrtc
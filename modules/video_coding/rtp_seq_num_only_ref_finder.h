@@ -11,11 +11,11 @@
 #ifndef MODULES_VIDEO_CODING_RTP_SEQ_NUM_ONLY_REF_FINDER_H_
 #define MODULES_VIDEO_CODING_RTP_SEQ_NUM_ONLY_REF_FINDER_H_
 
+#include <stdint.h>
+
+#include <array>
 #include <deque>
-#include <map>
 #include <memory>
-#include <set>
-#include <utility>
 
 #include "absl/container/inlined_vector.h"
 #include "modules/rtp_rtcp/source/frame_object.h"
@@ -36,25 +36,45 @@ class RtpSeqNumOnlyRefFinder {
  private:
   static constexpr int kMaxStashedFrames = 100;
   static constexpr int kMaxPaddingAge = 100;
+  // A power of two larger than `kMaxPaddingAge`, so that padding packets that
+  // arrive late can still be stashed.
+  static constexpr int kPaddingRingSize = 128;
 
   enum FrameDecision { kStash, kHandOff, kDrop };
 
   FrameDecision ManageFrameInternal(RtpFrameObject* frame);
   void RetryStashedFrames(RtpFrameReferenceFinder::ReturnVector& res);
-  void UpdateLastPictureIdWithPadding(uint16_t seq_num);
-
   // For every group of pictures, hold two sequence numbers. The first being
   // the sequence number of the last packet of the last completed frame, and
   // the second being the sequence number of the last packet of the last
   // completed frame advanced by any potential continuous packets of padding.
-  std::map<uint16_t,
-           std::pair<uint16_t, uint16_t>,
-           DescendingSeqNumComp<uint16_t>>
-      last_seq_num_gop_;
+  struct Gop {
+    uint16_t keyframe_seq_num;
+    uint16_t last_picture_id;
+    uint16_t last_picture_id_with_padding;
+  };
+  using GopVector = absl::InlinedVector<Gop, 4>;
+
+  void UpdateLastPictureIdWithPadding(uint16_t seq_num);
+
+  // Returns the last group of pictures that starts at or before `seq_num`, or
+  // `last_seq_num_gop_.end()` if there is none.
+  GopVector::iterator FindGop(uint16_t seq_num);
+  bool IsPaddingStashed(uint16_t seq_num) const;
+  void StashPadding(uint16_t seq_num);
+  // Clears the `count` slots of `stashed_padding_` from `seq_num` on.
+  void ClearStashedPadding(uint16_t seq_num, int count);
+
+  // The groups of pictures, sorted by the sequence number of their keyframe.
+  GopVector last_seq_num_gop_;
 
   // Padding packets that have been received but that are not yet continuous
-  // with any group of pictures.
-  std::set<uint16_t, DescendingSeqNumComp<uint16_t>> stashed_padding_;
+  // with any group of pictures, one bit per sequence number. Only the bits of
+  // the `kPaddingRingSize` sequence numbers up to `last_padding_seq_num_` are
+  // valid.
+  std::array<uint64_t, kPaddingRingSize / 64> stashed_padding_ = {};
+  // The newest padding packet received, or -1 if there is none.
+  int last_padding_seq_num_ = -1;
 
   // Frames that have been fully received but didn't have all the information
   // needed to determine their references.
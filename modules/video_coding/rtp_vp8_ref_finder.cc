@@ -10,6 +10,7 @@
 
 #include "modules/video_coding/rtp_vp8_ref_finder.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "rtc_base/logging.h"
@@ -62,55 +63,56 @@ RtpVp8RefFinder::FrameDecision RtpVp8RefFinder::ManageFrameInternal(
   if (last_picture_id_ == -1)
     last_picture_id_ = frame->Id();
 
-  // Clean up info about not yet received frames that are too old.
-  uint16_t old_picture_id =
-      Subtract<kFrameIdLength>(frame->Id(), kMaxNotYetReceivedFrames);
-  auto clean_frames_to = not_yet_received_frames_.lower_bound(old_picture_id);
-  not_yet_received_frames_.erase(not_yet_received_frames_.begin(),
-                                 clean_frames_to);
-  // Avoid re-adding picture ids that were just erased.
-  if (AheadOf<uint16_t, kFrameIdLength>(old_picture_id, last_picture_id_)) {
-    last_picture_id_ = old_picture_id;
-  }
   // Find if there has been a gap in fully received frames and save the picture
-  // id of those frames in `not_yet_received_frames_`.
+  // id of those frames in `not_yet_received_frames_`. Picture ids that are
+  // more than `kMaxNotYetReceivedFrames` older than this frame are forgotten.
   if (AheadOf<uint16_t, kFrameIdLength>(frame->Id(), last_picture_id_)) {
+    uint16_t old_picture_id =
+        Subtract<kFrameIdLength>(frame->Id(), kMaxNotYetReceivedFrames);
+    if (AheadOf<uint16_t, kFrameIdLength>(old_picture_id, last_picture_id_)) {
+      last_picture_id_ = old_picture_id;
+      not_yet_received_frames_[old_picture_id % kNotYetReceivedRingSize] =
+          false;
+    }
     do {
       last_picture_id_ = Add<kFrameIdLength>(last_picture_id_, 1);
-      not_yet_received_frames_.insert(last_picture_id_);
+      not_yet_received_frames_[last_picture_id_ % kNotYetReceivedRingSize] =
+          true;
     } while (last_picture_id_ != frame->Id());
   }
 
   // Clean up info for base layers that are too old.
-  int64_t old_tl0_pic_idx = unwrapped_tl0 - kMaxLayerInfo;
-  auto clean_layer_info_to = layer_info_.lower_bound(old_tl0_pic_idx);
-  layer_info_.erase(layer_info_.begin(), clean_layer_info_to);
+  RemoveLayerInfoOlderThan(unwrapped_tl0 - kMaxLayerInfo);
 
   if (frame->frame_type() == VideoFrameType::kVideoFrameKey) {
     if (codec_header.temporalIdx != 0) {
       return kDrop;
     }
     frame->num_references = 0;
-    layer_info_[unwrapped_tl0].fill(-1);
+    InsertLayerInfo(unwrapped_tl0).fill(-1);
     UpdateLayerInfoVp8(frame, unwrapped_tl0, codec_header.temporalIdx);
     return kHandOff;
   }
 
-  auto layer_info_it = layer_info_.find(
+  LayerInfo* layer_info = FindLayerInfo(
       codec_header.temporalIdx == 0 ? unwrapped_tl0 - 1 : unwrapped_tl0);
 
   // If we don't have the base layer frame yet, stash this frame.
-  if (layer_info_it == layer_info_.end())
+  if (layer_info == nullptr)
     return kStash;
 
   // A non keyframe base layer frame has been received, copy the layer info
   // from the previous base layer frame and set a reference to the previous
   // base layer frame.
   if (codec_header.temporalIdx == 0) {
-    layer_info_it =
-        layer_info_.emplace(unwrapped_tl0, layer_info_it->second).first;
+    LayerInfo* base_layer_info = FindLayerInfo(unwrapped_tl0);
+    if (base_layer_info == nullptr) {
+      base_layer_info = &InsertLayerInfo(unwrapped_tl0);
+      *base_layer_info = *layer_info;
+    }
+    layer_info = base_layer_info;
     frame->num_references = 1;
-    int64_t last_pid_on_layer = layer_info_it->second[0];
+    int64_t last_pid_on_layer = (*layer_info)[0];
 
     // Is this an old frame that has already been used to update the state? If
     // so, drop it.
@@ -126,7 +128,7 @@ RtpVp8RefFinder::FrameDecision RtpVp8RefFinder::ManageFrameInternal(
   // Layer sync frame, this frame only references its base layer frame.
   if (codec_header.layerSync) {
     frame->num_references = 1;
-    int64_t last_pid_on_layer = layer_info_it->second[codec_header.temporalIdx];
+    int64_t last_pid_on_layer = (*layer_info)[codec_header.temporalIdx];
 
     // Is this an old frame that has already been used to update the state? If
     // so, drop it.
@@ -135,7 +137,7 @@ RtpVp8RefFinder::FrameDecision RtpVp8RefFinder::ManageFrameInternal(
       return kDrop;
     }
 
-    frame->references[0] = layer_info_it->second[0];
+    frame->references[0] = (*layer_info)[0];
     UpdateLayerInfoVp8(frame, unwrapped_tl0, codec_header.temporalIdx);
     return kHandOff;
   }
@@ -145,29 +147,24 @@ RtpVp8RefFinder::FrameDecision RtpVp8RefFinder::ManageFrameInternal(
   for (uint8_t layer = 0; layer <= codec_header.temporalIdx; ++layer) {
     // If we have not yet received a previous frame on this temporal layer,
     // stash this frame.
-    if (layer_info_it->second[layer] == -1)
+    if ((*layer_info)[layer] == -1)
       return kStash;
 
     // If the last frame on this layer is ahead of this frame it means that
     // a layer sync frame has been received after this frame for the same
     // base layer frame, drop this frame.
-    if (AheadOf<uint16_t, kFrameIdLength>(layer_info_it->second[layer],
-                                          frame->Id())) {
+    if (AheadOf<uint16_t, kFrameIdLength>((*layer_info)[layer], frame->Id())) {
       return kDrop;
     }
 
     // If we have not yet received a frame between this frame and the referenced
     // frame then we have to wait for that frame to be completed first.
-    auto not_received_frame_it =
-        not_yet_received_frames_.upper_bound(layer_info_it->second[layer]);
-    if (not_received_frame_it != not_yet_received_frames_.end() &&
-        AheadOf<uint16_t, kFrameIdLength>(frame->Id(),
-                                          *not_received_frame_it)) {
+    if (NotYetReceivedFrameBetween((*layer_info)[layer], frame->Id())) {
       return kStash;
     }
 
     if (!(AheadOf<uint16_t, kFrameIdLength>(frame->Id(),
-                                            layer_info_it->second[layer]))) {
+                                            (*layer_info)[layer]))) {
       RTC_LOG(LS_WARNING) << "Frame with picture id " << frame->Id()
                           << " and packet range [" << frame->first_seq_num()
                           << ", " << frame->last_seq_num()
@@ -177,7 +174,7 @@ RtpVp8RefFinder::FrameDecision RtpVp8RefFinder::ManageFrameInternal(
     }
 
     ++frame->num_references;
-    frame->references[layer] = layer_info_it->second[layer];
+    frame->references[layer] = (*layer_info)[layer];
   }
 
   UpdateLayerInfoVp8(frame, unwrapped_tl0, codec_header.temporalIdx);
@@ -187,23 +184,23 @@ RtpVp8RefFinder::FrameDecision RtpVp8RefFinder::ManageFrameInternal(
 void RtpVp8RefFinder::UpdateLayerInfoVp8(RtpFrameObject* frame,
                                          int64_t unwrapped_tl0,
                                          uint8_t temporal_idx) {
-  auto layer_info_it = layer_info_.find(unwrapped_tl0);
-
   // Update this layer info and newer.
-  while (layer_info_it != layer_info_.end()) {
-    if (layer_info_it->second[temporal_idx] != -1 &&
-        AheadOf<uint16_t, kFrameIdLength>(layer_info_it->second[temporal_idx],
+  for (LayerInfo* layer_info = FindLayerInfo(unwrapped_tl0);
+       layer_info != nullptr; layer_info = FindLayerInfo(++unwrapped_tl0)) {
+    if ((*layer_info)[temporal_idx] != -1 &&
+        AheadOf<uint16_t, kFrameIdLength>((*layer_info)[temporal_idx],
                                           frame->Id())) {
       // The frame was not newer, then no subsequent layer info have to be
       // update.
       break;
     }
 
-    layer_info_it->second[temporal_idx] = frame->Id();
-    ++unwrapped_tl0;
-    layer_info_it = layer_info_.find(unwrapped_tl0);
+    (*layer_info)[temporal_idx] = frame->Id();
+  }
+  if (ForwardDiff<uint16_t, kFrameIdLength>(frame->Id(), last_picture_id_) <=
+      kMaxNotYetReceivedFrames) {
+    not_yet_received_frames_[frame->Id() % kNotYetReceivedRingSize] = false;
   }
-  not_yet_received_frames_.erase(frame->Id());
 
   UnwrapPictureIds(frame);
 }
@@ -213,24 +210,28 @@ void RtpVp8RefFinder::RetryStashedFrames(
   bool complete_frame = false;
   do {
     complete_frame = false;
-    for (auto it = stashed_frames_.begin(); it != stashed_frames_.end();) {
+    // Frames that remain stashed are moved towards the front, keeping their
+    // order, so that every retry is a single pass over the stash.
+    auto stash_it = stashed_frames_.begin();
+    for (UnwrappedTl0Frame& stashed_frame : stashed_frames_) {
       const RTPVideoHeaderVP8& codec_header = absl::get<RTPVideoHeaderVP8>(
-          it->frame->GetRtpVideoHeader().video_type_header);
-      FrameDecision decision =
-          ManageFrameInternal(it->frame.get(), codec_header, it->unwrapped_tl0);
+          stashed_frame.frame->GetRtpVideoHeader().video_type_header);
+      FrameDecision decision = ManageFrameInternal(
+          stashed_frame.frame.get(), codec_header, stashed_frame.unwrapped_tl0);
 
       switch (decision) {
         case kStash:
-          ++it;
+          *stash_it++ = std::move(stashed_frame);
           break;
         case kHandOff:
           complete_frame = true;
-          res.push_back(std::move(it->frame));
-          [[fallthrough]];
+          res.push_back(std::move(stashed_frame.frame));
+          break;
         case kDrop:
-          it = stashed_frames_.erase(it);
+          break;
       }
     }
+    stashed_frames_.erase(stash_it, stashed_frames_.end());
   } while (complete_frame);
 }
 
@@ -240,15 +241,59 @@ void RtpVp8RefFinder::UnwrapPictureIds(RtpFrameObject* frame) {
   frame->SetId(unwrapper_.Unwrap(frame->Id()));
 }
 
-void RtpVp8RefFinder::ClearTo(uint16_t seq_num) {
-  auto it = stashed_frames_.begin();
-  while (it != stashed_frames_.end()) {
-    if (AheadOf<uint16_t>(seq_num, it->frame->first_seq_num())) {
-      it = stashed_frames_.erase(it);
-    } else {
-      ++it;
-    }
+RtpVp8RefFinder::LayerInfo* RtpVp8RefFinder::FindLayerInfo(
+    int64_t unwrapped_tl0) {
+  LayerInfoSlot& slot = layer_info_[unwrapped_tl0 & (kLayerInfoRingSize - 1)];
+  return slot.unwrapped_tl0 == unwrapped_tl0 ? &slot.layer_info : nullptr;
+}
+
+RtpVp8RefFinder::LayerInfo& RtpVp8RefFinder::InsertLayerInfo(
+    int64_t unwrapped_tl0) {
+  LayerInfoSlot& slot = layer_info_[unwrapped_tl0 & (kLayerInfoRingSize - 1)];
+  slot.unwrapped_tl0 = unwrapped_tl0;
+  oldest_layer_info_tl0_ = std::min(oldest_layer_info_tl0_, unwrapped_tl0);
+  return slot.layer_info;
+}
+
+void RtpVp8RefFinder::RemoveLayerInfoOlderThan(int64_t unwrapped_tl0) {
+  if (unwrapped_tl0 <= oldest_layer_info_tl0_)
+    return;
+  // Only the slots from `oldest_layer_info_tl0_` up to `unwrapped_tl0` can
+  // hold layer info that is older than `unwrapped_tl0`.
+  const int64_t num_slots = std::min<int64_t>(
+      unwrapped_tl0 - oldest_layer_info_tl0_, kLayerInfoRingSize);
+  for (int64_t i = 0; i < num_slots; ++i) {
+    LayerInfoSlot& slot = layer_info_[(oldest_layer_info_tl0_ + i) &
+                                      (kLayerInfoRingSize - 1)];
+    if (slot.unwrapped_tl0 < unwrapped_tl0)
+      slot.unwrapped_tl0 = kNoLayerInfo;
   }
+  oldest_layer_info_tl0_ = unwrapped_tl0;
+}
+
+bool RtpVp8RefFinder::NotYetReceivedFrameBetween(uint16_t picture_id_from,
+                                                 uint16_t picture_id_to) const {
+  uint16_t picture_id = Add<kFrameIdLength>(picture_id_from, 1);
+  uint16_t oldest_picture_id =
+      Subtract<kFrameIdLength>(last_picture_id_, kMaxNotYetReceivedFrames);
+  if (AheadOf<uint16_t, kFrameIdLength>(oldest_picture_id, picture_id))
+    picture_id = oldest_picture_id;
+  for (; AheadOf<uint16_t, kFrameIdLength>(picture_id_to, picture_id);
+       picture_id = Add<kFrameIdLength>(picture_id, 1)) {
+    if (not_yet_received_frames_[picture_id % kNotYetReceivedRingSize])
+      return true;
+  }
+  return false;
+}
+
+void RtpVp8RefFinder::ClearTo(uint16_t seq_num) {
+  stashed_frames_.erase(
+      std::remove_if(stashed_frames_.begin(), stashed_frames_.end(),
+                     [seq_num](const UnwrappedTl0Frame& stashed_frame) {
+                       return AheadOf<uint16_t>(
+                           seq_num, stashed_frame.frame->first_seq_num());
+                     }),
+      stashed_frames_.end());
 }
 
 }  // namespace webrtc
@@ -11,10 +11,13 @@
 #ifndef MODULES_VIDEO_CODING_RTP_VP8_REF_FINDER_H_
 #define MODULES_VIDEO_CODING_RTP_VP8_REF_FINDER_H_
 
+#include <stdint.h>
+
+#include <array>
+#include <bitset>
 #include <deque>
-#include <map>
+#include <limits>
 #include <memory>
-#include <set>
 
 #include "absl/container/inlined_vector.h"
 #include "modules/rtp_rtcp/source/frame_object.h"
@@ -37,6 +40,18 @@ class RtpVp8RefFinder {
   static constexpr int kMaxNotYetReceivedFrames = 100;
   static constexpr int kMaxStashedFrames = 100;
   static constexpr int kMaxTemporalLayers = 5;
+  // Ring sizes, powers of two larger than the number of entries they hold.
+  static constexpr int kLayerInfoRingSize = 64;
+  static constexpr int kNotYetReceivedRingSize = 128;
+  static constexpr int64_t kNoLayerInfo = std::numeric_limits<int64_t>::min();
+
+  // The last picture id of every temporal layer.
+  using LayerInfo = std::array<int64_t, kMaxTemporalLayers>;
+
+  struct LayerInfoSlot {
+    int64_t unwrapped_tl0 = kNoLayerInfo;
+    LayerInfo layer_info;
+  };
 
   struct UnwrappedTl0Frame {
     int64_t unwrapped_tl0;
@@ -54,22 +69,36 @@ class RtpVp8RefFinder {
                           uint8_t temporal_idx);
   void UnwrapPictureIds(RtpFrameObject* frame);
 
+  // Returns the layer info of `unwrapped_tl0`, or nullptr if there is none.
+  LayerInfo* FindLayerInfo(int64_t unwrapped_tl0);
+  // Returns the layer info of `unwrapped_tl0`, replacing the layer info of
+  // any other TL0 picture index in its slot.
+  LayerInfo& InsertLayerInfo(int64_t unwrapped_tl0);
+  void RemoveLayerInfoOlderThan(int64_t unwrapped_tl0);
+  // Returns true if a frame in the open interval (`picture_id_from`,
+  // `picture_id_to`) has not yet been received.
+  bool NotYetReceivedFrameBetween(uint16_t picture_id_from,
+                                  uint16_t picture_id_to) const;
+
   // Save the last picture id in order to detect when there is a gap in frames
   // that have not yet been fully received.
   int last_picture_id_ = -1;
 
   // Frames earlier than the last received frame that have not yet been
-  // fully received.
-  std::set<uint16_t, DescendingSeqNumComp<uint16_t, kFrameIdLength>>
-      not_yet_received_frames_;
+  // fully received, indexed by picture id. Only the picture ids at most
+  // `kMaxNotYetReceivedFrames` older than `last_picture_id_` are valid.
+  std::bitset<kNotYetReceivedRingSize> not_yet_received_frames_;
 
   // Frames that have been fully received but didn't have all the information
   // needed to determine their references.
   std::deque<UnwrappedTl0Frame> stashed_frames_;
 
   // Holds the information about the last completed frame for a given temporal
-  // layer given an unwrapped Tl0 picture index.
-  std::map<int64_t, std::array<int64_t, kMaxTemporalLayers>> layer_info_;
+  // layer given an unwrapped Tl0 picture index, indexed by the unwrapped Tl0
+  // picture index.
+  std::array<LayerInfoSlot, kLayerInfoRingSize> layer_info_;
+  // A lower bound of the unwrapped Tl0 picture indices in `layer_info_`.
+  int64_t oldest_layer_info_tl0_ = std::numeric_limits<int64_t>::max();
 
   // Unwrapper used to unwrap VP8/VP9 streams which have their picture id
   // specified.
@@ -115,17 +115,15 @@ RtpVp9RefFinder::FrameDecision RtpVp9RefFinder::ManageFrameGof(
       current_ss_idx_ = Add<kMaxGofSaved>(current_ss_idx_, 1);
       scalability_structures_[current_ss_idx_] = gof;
       scalability_structures_[current_ss_idx_].pid_start = frame->Id();
-      gof_info_.emplace(
+      EmplaceGofInfo(
           unwrapped_tl0,
           GofInfo(&scalability_structures_[current_ss_idx_], frame->Id()));
     }
 
-    const auto gof_info_it = gof_info_.find(unwrapped_tl0);
-    if (gof_info_it == gof_info_.end())
+    info = FindGofInfo(unwrapped_tl0);
+    if (info == nullptr)
       return kStash;
 
-    info = &gof_info_it->second;
-
     if (frame->frame_type() == VideoFrameType::kVideoFrameKey) {
       frame->num_references = 0;
       FrameReceivedVp9(frame->Id(), info);
@@ -137,38 +135,29 @@ RtpVp9RefFinder::FrameDecision RtpVp9RefFinder::ManageFrameGof(
       RTC_LOG(LS_WARNING) << "Received keyframe without scalability structure";
       return kDrop;
     }
-    const auto gof_info_it = gof_info_.find(unwrapped_tl0);
-    if (gof_info_it == gof_info_.end())
+    info = FindGofInfo(unwrapped_tl0);
+    if (info == nullptr)
       return kStash;
 
-    info = &gof_info_it->second;
-
     frame->num_references = 0;
     FrameReceivedVp9(frame->Id(), info);
     FlattenFrameIdAndRefs(frame, codec_header.inter_layer_predicted);
     return kHandOff;
   } else {
-    auto gof_info_it = gof_info_.find(
-        (codec_header.temporal_idx == 0) ? unwrapped_tl0 - 1 : unwrapped_tl0);
+    info = FindGofInfo((codec_header.temporal_idx == 0) ? unwrapped_tl0 - 1
+                                                        : unwrapped_tl0);
 
     // Gof info for this frame is not available yet, stash this frame.
-    if (gof_info_it == gof_info_.end())
+    if (info == nullptr)
       return kStash;
 
     if (codec_header.temporal_idx == 0) {
-      gof_info_it = gof_info_
-                        .emplace(unwrapped_tl0,
-                                 GofInfo(gof_info_it->second.gof, frame->Id()))
-                        .first;
+      info = EmplaceGofInfo(unwrapped_tl0, GofInfo(info->gof, frame->Id()));
     }
-
-    info = &gof_info_it->second;
   }
 
   // Clean up info for base layers that are too old.
-  int64_t old_tl0_pic_idx = unwrapped_tl0 - kMaxGofSaved;
-  auto clean_gof_info_to = gof_info_.lower_bound(old_tl0_pic_idx);
-  gof_info_.erase(gof_info_.begin(), clean_gof_info_to);
+  RemoveGofInfoOlderThan(unwrapped_tl0 - kMaxGofSaved);
 
   FrameReceivedVp9(frame->Id(), info);
 
@@ -177,13 +166,22 @@ RtpVp9RefFinder::FrameDecision RtpVp9RefFinder::ManageFrameGof(
   if (MissingRequiredFrameVp9(frame->Id(), *info))
     return kStash;
 
-  if (codec_header.temporal_up_switch)
-    up_switch_.emplace(frame->Id(), codec_header.temporal_idx);
+  if (codec_header.temporal_up_switch) {
+    UpSwitchSlot& slot = up_switch_[frame->Id() % kUpSwitchRingSize];
+    if (slot.picture_id != frame->Id()) {
+      slot.picture_id = frame->Id();
+      slot.temporal_idx = codec_header.temporal_idx;
+    }
+    if (oldest_up_switch_picture_id_ == -1 ||
+        AheadOf<uint16_t, kFrameIdLength>(oldest_up_switch_picture_id_,
+                                          frame->Id())) {
+      oldest_up_switch_picture_id_ = frame->Id();
+    }
+  }
 
   // Clean out old info about up switch frames.
-  uint16_t old_picture_id = Subtract<kFrameIdLength>(frame->Id(), 50);
-  auto up_switch_erase_to = up_switch_.lower_bound(old_picture_id);
-  up_switch_.erase(up_switch_.begin(), up_switch_erase_to);
+  RemoveUpSwitchesOlderThan(
+      Subtract<kFrameIdLength>(frame->Id(), kMaxUpSwitchAge));
 
   size_t diff =
       ForwardDiff<uint16_t, kFrameIdLength>(info->gof->pid_start, frame->Id());
@@ -230,16 +228,19 @@ bool RtpVp9RefFinder::MissingRequiredFrameVp9(uint16_t picture_id,
   }
 
   // For every reference this frame has, check if there is a frame missing in
-  // the interval (`ref_pid`, `picture_id`) in any of the lower temporal
+  // the interval [`ref_pid`, `picture_id`) in any of the lower temporal
   // layers. If so, we are missing a required frame.
+  const uint8_t lower_temporal_layers = (1 << temporal_idx) - 1;
   uint8_t num_references = info.gof->num_ref_pics[gof_idx];
   for (size_t i = 0; i < num_references; ++i) {
-    uint16_t ref_pid =
-        Subtract<kFrameIdLength>(picture_id, info.gof->pid_diff[gof_idx][i]);
-    for (size_t l = 0; l < temporal_idx; ++l) {
-      auto missing_frame_it = missing_frames_for_layer_[l].lower_bound(ref_pid);
-      if (missing_frame_it != missing_frames_for_layer_[l].end() &&
-          AheadOf<uint16_t, kFrameIdLength>(picture_id, *missing_frame_it)) {
+    for (uint16_t missing_pid = Subtract<kFrameIdLength>(
+             picture_id, info.gof->pid_diff[gof_idx][i]);
+         AheadOf<uint16_t, kFrameIdLength>(picture_id, missing_pid);
+         missing_pid = Add<kFrameIdLength>(missing_pid, 1)) {
+      const MissingFrameSlot& slot =
+          missing_frames_[missing_pid % kMissingFramesRingSize];
+      if (slot.picture_id == missing_pid &&
+          (slot.temporal_layers & lower_temporal_layers) != 0) {
         return true;
       }
     }
@@ -272,7 +273,13 @@ void RtpVp9RefFinder::FrameReceivedVp9(uint16_t picture_id, GofInfo* info) {
         return;
       }
 
-      missing_frames_for_layer_[temporal_idx].insert(last_picture_id);
+      MissingFrameSlot& slot =
+          missing_frames_[last_picture_id % kMissingFramesRingSize];
+      if (slot.picture_id != last_picture_id) {
+        slot.picture_id = last_picture_id;
+        slot.temporal_layers = 0;
+      }
+      slot.temporal_layers |= 1 << temporal_idx;
       last_picture_id = Add<kFrameIdLength>(last_picture_id, 1);
     }
 
@@ -291,18 +298,21 @@ void RtpVp9RefFinder::FrameReceivedVp9(uint16_t picture_id, GofInfo* info) {
       return;
     }
 
-    missing_frames_for_layer_[temporal_idx].erase(picture_id);
+    MissingFrameSlot& slot =
+        missing_frames_[picture_id % kMissingFramesRingSize];
+    if (slot.picture_id == picture_id)
+      slot.temporal_layers &= ~(1 << temporal_idx);
   }
 }
 
 bool RtpVp9RefFinder::UpSwitchInIntervalVp9(uint16_t picture_id,
                                             uint8_t temporal_idx,
                                             uint16_t pid_ref) {
-  for (auto up_switch_it = up_switch_.upper_bound(pid_ref);
-       up_switch_it != up_switch_.end() &&
-       AheadOf<uint16_t, kFrameIdLength>(picture_id, up_switch_it->first);
-       ++up_switch_it) {
-    if (up_switch_it->second < temporal_idx)
+  for (uint16_t up_switch_pid = Add<kFrameIdLength>(pid_ref, 1);
+       AheadOf<uint16_t, kFrameIdLength>(picture_id, up_switch_pid);
+       up_switch_pid = Add<kFrameIdLength>(up_switch_pid, 1)) {
+    const UpSwitchSlot& slot = up_switch_[up_switch_pid % kUpSwitchRingSize];
+    if (slot.picture_id == up_switch_pid && slot.temporal_idx < temporal_idx)
       return true;
   }
 
@@ -314,25 +324,29 @@ void RtpVp9RefFinder::RetryStashedFrames(
   bool complete_frame = false;
   do {
     complete_frame = false;
-    for (auto it = stashed_frames_.begin(); it != stashed_frames_.end();) {
+    // Frames that remain stashed are moved towards the front, keeping their
+    // order, so that every retry is a single pass over the stash.
+    auto stash_it = stashed_frames_.begin();
+    for (UnwrappedTl0Frame& stashed_frame : stashed_frames_) {
       const RTPVideoHeaderVP9& codec_header = absl::get<RTPVideoHeaderVP9>(
-          it->frame->GetRtpVideoHeader().video_type_header);
+          stashed_frame.frame->GetRtpVideoHeader().video_type_header);
       RTC_DCHECK(!codec_header.flexible_mode);
-      FrameDecision decision =
-          ManageFrameGof(it->frame.get(), codec_header, it->unwrapped_tl0);
+      FrameDecision decision = ManageFrameGof(
+          stashed_frame.frame.get(), codec_header, stashed_frame.unwrapped_tl0);
 
       switch (decision) {
         case kStash:
-          ++it;
+          *stash_it++ = std::move(stashed_frame);
           break;
         case kHandOff:
           complete_frame = true;
-          res.push_back(std::move(it->frame));
-          [[fallthrough]];
+          res.push_back(std::move(stashed_frame.frame));
+          break;
         case kDrop:
-          it = stashed_frames_.erase(it);
+          break;
       }
     }
+    stashed_frames_.erase(stash_it, stashed_frames_.end());
   } while (complete_frame);
 }
 
@@ -353,15 +367,77 @@ void RtpVp9RefFinder::FlattenFrameIdAndRefs(RtpFrameObject* frame,
   }
 }
 
-void RtpVp9RefFinder::ClearTo(uint16_t seq_num) {
-  auto it = stashed_frames_.begin();
-  while (it != stashed_frames_.end()) {
-    if (AheadOf<uint16_t>(seq_num, it->frame->first_seq_num())) {
-      it = stashed_frames_.erase(it);
-    } else {
-      ++it;
+RtpVp9RefFinder::GofInfo* RtpVp9RefFinder::FindGofInfo(
+    int64_t unwrapped_tl0) {
+  GofInfoSlot& slot = gof_info_[unwrapped_tl0 & (kGofInfoRingSize - 1)];
+  return slot.unwrapped_tl0 == unwrapped_tl0 ? &slot.info : nullptr;
+}
+
+RtpVp9RefFinder::GofInfo* RtpVp9RefFinder::EmplaceGofInfo(
+    int64_t unwrapped_tl0,
+    const GofInfo& info) {
+  GofInfoSlot& slot = gof_info_[unwrapped_tl0 & (kGofInfoRingSize - 1)];
+  if (slot.unwrapped_tl0 != unwrapped_tl0) {
+    slot.unwrapped_tl0 = unwrapped_tl0;
+    slot.info = info;
+    oldest_gof_info_tl0_ = std::min(oldest_gof_info_tl0_, unwrapped_tl0);
+  }
+  return &slot.info;
+}
+
+void RtpVp9RefFinder::RemoveGofInfoOlderThan(int64_t unwrapped_tl0) {
+  if (unwrapped_tl0 <= oldest_gof_info_tl0_)
+    return;
+  // Only the slots from `oldest_gof_info_tl0_` up to `unwrapped_tl0` can hold
+  // Gof info that is older than `unwrapped_tl0`.
+  const int64_t num_slots = std::min<int64_t>(
+      unwrapped_tl0 - oldest_gof_info_tl0_, kGofInfoRingSize);
+  for (int64_t i = 0; i < num_slots; ++i) {
+    GofInfoSlot& slot =
+        gof_info_[(oldest_gof_info_tl0_ + i) & (kGofInfoRingSize - 1)];
+    if (slot.unwrapped_tl0 < unwrapped_tl0)
+      slot.unwrapped_tl0 = kNoGofInfo;
+  }
+  oldest_gof_info_tl0_ = unwrapped_tl0;
+}
+
+void RtpVp9RefFinder::RemoveUpSwitchesOlderThan(uint16_t picture_id) {
+  if (oldest_up_switch_picture_id_ == -1)
+    return;
+  int num_slots = kUpSwitchRingSize;
+  if (AheadOf<uint16_t, kFrameIdLength>(picture_id,
+                                        oldest_up_switch_picture_id_)) {
+    // Only the slots from `oldest_up_switch_picture_id_` up to `picture_id`
+    // can hold up switches that are older than `picture_id`.
+    num_slots = std::min<int>(
+        ForwardDiff<uint16_t, kFrameIdLength>(oldest_up_switch_picture_id_,
+                                              picture_id),
+        kUpSwitchRingSize);
+  } else if (ForwardDiff<uint16_t, kFrameIdLength>(
+                 picture_id, oldest_up_switch_picture_id_) <=
+             kUpSwitchRingSize) {
+    // A reordered frame, there is nothing older than `picture_id`.
+    return;
+  }
+  for (int i = 0; i < num_slots; ++i) {
+    UpSwitchSlot& slot =
+        up_switch_[(oldest_up_switch_picture_id_ + i) % kUpSwitchRingSize];
+    if (slot.picture_id != -1 &&
+        AheadOf<uint16_t, kFrameIdLength>(picture_id, slot.picture_id)) {
+      slot.picture_id = -1;
     }
   }
+  oldest_up_switch_picture_id_ = picture_id;
+}
+
+void RtpVp9RefFinder::ClearTo(uint16_t seq_num) {
+  stashed_frames_.erase(
+      std::remove_if(stashed_frames_.begin(), stashed_frames_.end(),
+                     [seq_num](const UnwrappedTl0Frame& stashed_frame) {
+                       return AheadOf<uint16_t>(
+                           seq_num, stashed_frame.frame->first_seq_num());
+                     }),
+      stashed_frames_.end());
 }
 
 }  // namespace webrtc
@@ -11,10 +11,12 @@
 #ifndef MODULES_VIDEO_CODING_RTP_VP9_REF_FINDER_H_
 #define MODULES_VIDEO_CODING_RTP_VP9_REF_FINDER_H_
 
+#include <stdint.h>
+
+#include <array>
 #include <deque>
-#include <map>
+#include <limits>
 #include <memory>
-#include <set>
 
 #include "absl/container/inlined_vector.h"
 #include "modules/rtp_rtcp/source/frame_object.h"
@@ -38,6 +40,13 @@ class RtpVp9RefFinder {
   static constexpr int kMaxNotYetReceivedFrames = 100;
   static constexpr int kMaxStashedFrames = 100;
   static constexpr int kMaxTemporalLayers = 5;
+  static constexpr int kMaxUpSwitchAge = 50;
+  // Ring sizes, powers of two larger than the number of entries they hold.
+  static constexpr int kGofInfoRingSize = 64;
+  static constexpr int kUpSwitchRingSize = 64;
+  // Covers the largest picture id difference of a scalability structure.
+  static constexpr int kMissingFramesRingSize = 256;
+  static constexpr int64_t kNoGofInfo = std::numeric_limits<int64_t>::min();
 
   enum FrameDecision { kStash, kHandOff, kDrop };
 
@@ -48,6 +57,22 @@ class RtpVp9RefFinder {
     uint16_t last_picture_id;
   };
 
+  struct GofInfoSlot {
+    int64_t unwrapped_tl0 = kNoGofInfo;
+    GofInfo info{nullptr, 0};
+  };
+
+  struct UpSwitchSlot {
+    int picture_id = -1;
+    uint8_t temporal_idx = 0;
+  };
+
+  struct MissingFrameSlot {
+    int picture_id = -1;
+    // Bit `i` is set if the frame is missing for temporal layer `i`.
+    uint8_t temporal_layers = 0;
+  };
+
   struct UnwrappedTl0Frame {
     int64_t unwrapped_tl0;
     std::unique_ptr<RtpFrameObject> frame;
@@ -69,6 +94,15 @@ class RtpVp9RefFinder {
 
   void FlattenFrameIdAndRefs(RtpFrameObject* frame, bool inter_layer_predicted);
 
+  // Returns the Gof info of `unwrapped_tl0`, or nullptr if there is none.
+  GofInfo* FindGofInfo(int64_t unwrapped_tl0);
+  // Like std::map::emplace, returns the existing Gof info of `unwrapped_tl0`
+  // if there is one. Replaces the Gof info of any other TL0 picture index in
+  // its slot.
+  GofInfo* EmplaceGofInfo(int64_t unwrapped_tl0, const GofInfo& info);
+  void RemoveGofInfoOlderThan(int64_t unwrapped_tl0);
+  void RemoveUpSwitchesOlderThan(uint16_t picture_id);
+
   // Frames that have been fully received but didn't have all the information
   // needed to determine their references.
   std::deque<UnwrappedTl0Frame> stashed_frames_;
@@ -80,18 +114,21 @@ class RtpVp9RefFinder {
   // Holds received scalability structures.
   std::array<GofInfoVP9, kMaxGofSaved> scalability_structures_;
 
-  // Holds the the Gof information for a given unwrapped TL0 picture index.
-  std::map<int64_t, GofInfo> gof_info_;
+  // Holds the the Gof information for a given unwrapped TL0 picture index,
+  // indexed by the unwrapped TL0 picture index.
+  std::array<GofInfoSlot, kGofInfoRingSize> gof_info_;
+  // A lower bound of the unwrapped TL0 picture indices in `gof_info_`.
+  int64_t oldest_gof_info_tl0_ = std::numeric_limits<int64_t>::max();
 
   // Keep track of which picture id and which temporal layer that had the
-  // up switch flag set.
-  std::map<uint16_t, uint8_t, DescendingSeqNumComp<uint16_t, kFrameIdLength>>
-      up_switch_;
-
-  // For every temporal layer, keep a set of which frames that are missing.
-  std::array<std::set<uint16_t, DescendingSeqNumComp<uint16_t, kFrameIdLength>>,
-             kMaxTemporalLayers>
-      missing_frames_for_layer_;
+  // up switch flag set, indexed by picture id.
+  std::array<UpSwitchSlot, kUpSwitchRingSize> up_switch_;
+  // A lower bound of the picture ids in `up_switch_`, or -1 if there are none.
+  int oldest_up_switch_picture_id_ = -1;
+
+  // Keep track of which frames that are missing and for which temporal
+  // layers, indexed by picture id.
+  std::array<MissingFrameSlot, kMissingFramesRingSize> missing_frames_;
 
   // Unwrapper used to unwrap VP8/VP9 streams which have their picture id
   // specified.
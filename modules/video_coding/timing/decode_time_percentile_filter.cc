@@ -22,11 +22,13 @@ const int kIgnoredSampleCount = 5;
 const float kPercentile = 0.95f;
 // The window size in ms.
 const int64_t kTimeLimitMs = 10000;
+// Decode times from 0 up to this many ms are counted in a bucket each.
+const int kNumDecodeTimeBuckets = 1000;
 
 }  // anonymous namespace
 
 DecodeTimePercentileFilter::DecodeTimePercentileFilter()
-    : ignored_sample_count_(0), filter_(kPercentile) {}
+    : ignored_sample_count_(0), filter_(kPercentile, kNumDecodeTimeBuckets) {}
 DecodeTimePercentileFilter::~DecodeTimePercentileFilter() = default;
 
 void DecodeTimePercentileFilter::AddTiming(int64_t decode_time_ms,
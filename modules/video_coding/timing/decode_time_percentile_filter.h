@@ -13,7 +13,7 @@
 
 #include <queue>
 
-#include "rtc_base/numerics/percentile_filter.h"
+#include "rtc_base/numerics/histogram_percentile_filter.h"
 
 namespace webrtc {
 
@@ -45,8 +45,9 @@ class DecodeTimePercentileFilter {
   // Queue with history of latest decode time values.
   std::queue<Sample> history_;
   // `filter_` contains the same values as `history_`, but in a data structure
-  // that allows efficient retrieval of the percentile value.
-  PercentileFilter<int64_t> filter_;
+  // that allows efficient retrieval of the percentile value. Decode times are
+  // short enough to be counted in a histogram with 1 ms buckets.
+  HistogramPercentileFilter filter_;
 };
 
 }  // namespace webrtc
@@ -91,9 +91,9 @@ JitterEstimator::Config JitterEstimator::Config::ParseAndValidate(
   Config config;
   config.Parser()->Parse(field_trial);
 
-  // The `MovingPercentileFilter` RTC_CHECKs on the validity of the
-  // percentile and window length, so we'd better validate the field trial
-  // provided values here.
+  // The `PercentileFilter` RTC_CHECKs on the validity of the percentile, and
+  // the frame size window must not be empty, so we'd better validate the field
+  // trial provided values here.
   if (config.max_frame_size_percentile) {
     double original = *config.max_frame_size_percentile;
     config.max_frame_size_percentile = std::min(std::max(0.0, original), 1.0);
@@ -133,16 +133,16 @@ JitterEstimator::JitterEstimator(Clock* clock,
                                  const FieldTrialsView& field_trials)
     : config_(Config::ParseAndValidate(
           field_trials.Lookup(Config::kFieldTrialsKey))),
-      avg_frame_size_median_bytes_(static_cast<size_t>(
-          config_.frame_size_window.value_or(kDefaultFrameSizeWindow))),
+      avg_frame_size_median_bytes_(0.5f),
       max_frame_size_bytes_percentile_(
           config_.max_frame_size_percentile.value_or(
-              kDefaultMaxFrameSizePercentile),
-          static_cast<size_t>(
-              config_.frame_size_window.value_or(kDefaultFrameSizeWindow))),
-      fps_counter_(30),  // TODO(sprang): Use an estimator with limit based
-                         // on time, rather than number of samples.
+              kDefaultMaxFrameSizePercentile)),
       clock_(clock) {
+  if (config_.avg_frame_size_median ||
+      config_.MaxFrameSizePercentileEnabled()) {
+    frame_sizes_bytes_.resize(
+        config_.frame_size_window.value_or(kDefaultFrameSizeWindow));
+  }
   Reset();
 }
 
@@ -168,7 +168,11 @@ void JitterEstimator::Reset() {
   startup_frame_size_count_ = 0;
   startup_count_ = 0;
   rtt_filter_.Reset();
-  fps_counter_.Reset();
+  num_frame_sizes_ = 0;
+  next_frame_size_ = 0;
+  num_frame_periods_ = 0;
+  next_frame_period_ = 0;
+  frame_periods_sum_us_ = 0;
 
   kalman_filter_ = FrameDelayVariationKalmanFilter();
 }
@@ -210,11 +214,8 @@ void JitterEstimator::UpdateEstimate(TimeDelta frame_delay,
       std::max<double>(kPsi * max_frame_size_bytes_, frame_size.bytes());
 
   // Maybe update percentile estimates of frame sizes.
-  if (config_.avg_frame_size_median) {
-    avg_frame_size_median_bytes_.Insert(frame_size.bytes());
-  }
-  if (config_.MaxFrameSizePercentileEnabled()) {
-    max_frame_size_bytes_percentile_.Insert(frame_size.bytes());
+  if (!frame_sizes_bytes_.empty()) {
+    AddFrameSize(frame_size.bytes());
   }
 
   if (!prev_frame_size_) {
@@ -277,7 +278,7 @@ void JitterEstimator::UpdateEstimate(TimeDelta frame_delay,
             kCongestionRejectionFactor);
     double filtered_max_frame_size_bytes =
         config_.MaxFrameSizePercentileEnabled()
-            ? max_frame_size_bytes_percentile_.GetFilteredValue()
+            ? max_frame_size_bytes_percentile_.GetPercentileValue()
             : max_frame_size_bytes_;
     bool is_not_congested =
         delta_frame_bytes >
@@ -326,12 +327,46 @@ JitterEstimator::Config JitterEstimator::GetConfigForTest() const {
   return config_;
 }
 
+void JitterEstimator::AddFrameSize(int64_t frame_size_bytes) {
+  if (num_frame_sizes_ == frame_sizes_bytes_.size()) {
+    // The window is full, so `next_frame_size_` is the oldest frame size.
+    int64_t oldest_frame_size_bytes = frame_sizes_bytes_[next_frame_size_];
+    if (config_.avg_frame_size_median) {
+      avg_frame_size_median_bytes_.Erase(oldest_frame_size_bytes);
+    }
+    if (config_.MaxFrameSizePercentileEnabled()) {
+      max_frame_size_bytes_percentile_.Erase(oldest_frame_size_bytes);
+    }
+  } else {
+    ++num_frame_sizes_;
+  }
+  frame_sizes_bytes_[next_frame_size_] = frame_size_bytes;
+  next_frame_size_ = (next_frame_size_ + 1) % frame_sizes_bytes_.size();
+  if (config_.avg_frame_size_median) {
+    avg_frame_size_median_bytes_.Insert(frame_size_bytes);
+  }
+  if (config_.MaxFrameSizePercentileEnabled()) {
+    max_frame_size_bytes_percentile_.Insert(frame_size_bytes);
+  }
+}
+
+void JitterEstimator::AddFramePeriod(TimeDelta frame_period) {
+  if (num_frame_periods_ == kFrameRateWindow) {
+    frame_periods_sum_us_ -= frame_periods_us_[next_frame_period_];
+  } else {
+    ++num_frame_periods_;
+  }
+  frame_periods_us_[next_frame_period_] = frame_period.us();
+  frame_periods_sum_us_ += frame_period.us();
+  next_frame_period_ = (next_frame_period_ + 1) % kFrameRateWindow;
+}
+
 // Estimates the random jitter by calculating the variance of the sample
 // distance from the line given by the Kalman filter.
 void JitterEstimator::EstimateRandomJitter(double d_dT) {
   Timestamp now = clock_->CurrentTime();
   if (last_update_time_.has_value()) {
-    fps_counter_.AddSample((now - *last_update_time_).us());
+    AddFramePeriod(now - *last_update_time_);
   }
   last_update_time_ = now;
 
@@ -390,11 +425,11 @@ TimeDelta JitterEstimator::CalculateEstimate() {
   // more robust than using sample mean-style estimates.
   double filtered_avg_frame_size_bytes =
       config_.avg_frame_size_median
-          ? avg_frame_size_median_bytes_.GetFilteredValue()
+          ? avg_frame_size_median_bytes_.GetPercentileValue()
           : avg_frame_size_bytes_;
   double filtered_max_frame_size_bytes =
       config_.MaxFrameSizePercentileEnabled()
-          ? max_frame_size_bytes_percentile_.GetFilteredValue()
+          ? max_frame_size_bytes_percentile_.GetPercentileValue()
           : max_frame_size_bytes_;
   double worst_case_frame_size_deviation_bytes =
       filtered_max_frame_size_bytes - filtered_avg_frame_size_bytes;
@@ -464,7 +499,11 @@ TimeDelta JitterEstimator::GetJitterEstimate(
 }
 
 Frequency JitterEstimator::GetFrameRate() const {
-  TimeDelta mean_frame_period = TimeDelta::Micros(fps_counter_.ComputeMean());
+  if (num_frame_periods_ == 0)
+    return Frequency::Zero();
+  TimeDelta mean_frame_period =
+      TimeDelta::Micros(static_cast<double>(frame_periods_sum_us_) /
+                        num_frame_periods_);
   if (mean_frame_period <= TimeDelta::Zero())
     return Frequency::Zero();
 
@@ -11,9 +11,12 @@
 #ifndef MODULES_VIDEO_CODING_TIMING_JITTER_ESTIMATOR_H_
 #define MODULES_VIDEO_CODING_TIMING_JITTER_ESTIMATOR_H_
 
-#include <algorithm>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
 #include <memory>
-#include <queue>
+#include <vector>
 
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
@@ -25,8 +28,7 @@
 #include "modules/video_coding/timing/frame_delay_variation_kalman_filter.h"
 #include "modules/video_coding/timing/rtt_filter.h"
 #include "rtc_base/experiments/struct_parameters_parser.h"
-#include "rtc_base/numerics/moving_percentile_filter.h"
-#include "rtc_base/rolling_accumulator.h"
+#include "rtc_base/numerics/percentile_filter.h"
 
 namespace webrtc {
 
@@ -143,6 +145,17 @@ class JitterEstimator {
   Config GetConfigForTest() const;
 
  private:
+  // Number of frame periods that the frame rate is estimated over.
+  // TODO(sprang): Use an estimator with limit based on time, rather than number
+  // of samples.
+  static constexpr size_t kFrameRateWindow = 30;
+
+  // Adds a frame size to the window of the percentile frame size filters.
+  void AddFrameSize(int64_t frame_size_bytes);
+
+  // Adds the time since the previous update to the frame rate window.
+  void AddFramePeriod(TimeDelta frame_period);
+
   // Updates the random jitter estimate, i.e. the variance of the time
   // deviations from the line given by the Kalman filter.
   //
@@ -180,8 +193,8 @@ class JitterEstimator {
   // when api/units have sufficient precision.
   double max_frame_size_bytes_;
   // Percentile frame sized received (over a window). Only used if configured.
-  MovingMedianFilter<int64_t> avg_frame_size_median_bytes_;
-  MovingPercentileFilter<int64_t> max_frame_size_bytes_percentile_;
+  PercentileFilter<int64_t> avg_frame_size_median_bytes_;
+  PercentileFilter<int64_t> max_frame_size_bytes_percentile_;
   // TODO(bugs.webrtc.org/14381): Update `startup_frame_size_sum_bytes_` to
   // DataSize when api/units have sufficient precision.
   double startup_frame_size_sum_bytes_;
@@ -208,8 +221,19 @@ class JitterEstimator {
   size_t nack_count_;
   RttFilter rtt_filter_;
 
-  // Tracks frame rates in microseconds.
-  rtc::RollingAccumulator<uint64_t> fps_counter_;
+  // The frame size and frame period histories are ring buffers, one array per
+  // kind of sample, that are allocated once and overwritten in place.
+  //
+  // Sizes of the latest frames in the window of the percentile frame size
+  // filters. Only allocated if any of the filters is configured.
+  std::vector<int64_t> frame_sizes_bytes_;
+  size_t num_frame_sizes_;
+  size_t next_frame_size_;
+  // Latest periods between updates of the random jitter, and their sum.
+  std::array<int64_t, kFrameRateWindow> frame_periods_us_;
+  size_t num_frame_periods_;
+  size_t next_frame_period_;
+  int64_t frame_periods_sum_us_;
   Clock* clock_;
 };
 
@@ -0,0 +1,206 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "api/field_trials_view.h"
+#include "api/rtc_event_log/rtc_event.h"
+#include "api/units/data_size.h"
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "benchmark/benchmark.h"
+#include "logging/rtc_event_log/encoder/rtc_event_log_encoder_new_format.h"
+#include "logging/rtc_event_log/events/rtc_event_rtp_packet_incoming.h"
+#include "logging/rtc_event_log/rtc_event_log_parser.h"
+#include "modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "modules/video_coding/timing/inter_frame_delay_variation_calculator.h"
+#include "modules/video_coding/timing/jitter_estimator.h"
+#include "modules/video_coding/timing/timing.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/fake_clock.h"
+#include "rtc_base/random.h"
+#include "rtc_base/system/unused.h"
+#include "rtc_base/time_utils.h"
+#include "system_wrappers/include/clock.h"
+#include "test/explicit_key_value_config.h"
+
+namespace webrtc {
+namespace {
+
+constexpr uint32_t kSsrc = 1234;
+constexpr int kFramerate = 30;
+constexpr uint32_t kRtpTicksPerFrame = 90'000 / kFramerate;
+constexpr int kNumFrames = 30 * kFramerate;
+constexpr int kKeyFrameInterval = 3 * kFramerate;
+constexpr size_t kMaxPayloadSize = 1200;
+
+// Writes an RTC event log of a received 30 fps video stream, whose packets
+// arrive with a Gaussian network delay and are spaced by 1 ms per packet.
+std::string CreateEventLog() {
+  rtc::FakeClock fake_clock;
+  fake_clock.SetTime(Timestamp::Seconds(1));
+  rtc::ClockInterface* original_clock = rtc::SetClockForTesting(&fake_clock);
+
+  Random random(/*seed=*/0x7e57);
+  std::deque<std::unique_ptr<RtcEvent>> events;
+  uint16_t sequence_number = 0;
+  Timestamp last_arrival_time = Timestamp::Seconds(1);
+  for (int i = 0; i < kNumFrames; ++i) {
+    Timestamp capture_time =
+        Timestamp::Seconds(1) + TimeDelta::Seconds(i) / kFramerate;
+    size_t frame_size = i % kKeyFrameInterval == 0
+                            ? random.Rand(30'000, 50'000)
+                            : random.Rand(2'000, 8'000);
+    TimeDelta network_delay = TimeDelta::Millis(
+        std::max(20.0, random.Gaussian(/*mean=*/50, /*standard_deviation=*/8)));
+    for (size_t offset = 0; offset < frame_size; offset += kMaxPayloadSize) {
+      RtpPacketReceived packet;
+      packet.SetSsrc(kSsrc);
+      packet.SetSequenceNumber(sequence_number++);
+      packet.SetTimestamp(i * kRtpTicksPerFrame);
+      packet.SetMarker(offset + kMaxPayloadSize >= frame_size);
+      packet.SetPayloadSize(std::min(kMaxPayloadSize, frame_size - offset));
+      // Packets of a frame arrive in order, after the previous frame.
+      last_arrival_time = std::max(
+          last_arrival_time,
+          capture_time + network_delay +
+              TimeDelta::Millis(offset / kMaxPayloadSize));
+      fake_clock.SetTime(last_arrival_time);
+      events.push_back(std::make_unique<RtcEventRtpPacketIncoming>(packet));
+    }
+  }
+
+  RtcEventLogEncoderNewFormat encoder;
+  std::string log = encoder.EncodeLogStart(/*timestamp_us=*/0,
+                                           /*utc_time_us=*/0) +
+                    encoder.EncodeBatch(events.begin(), events.end()) +
+                    encoder.EncodeLogEnd(last_arrival_time.us());
+  rtc::SetClockForTesting(original_clock);
+  return log;
+}
+
+struct ReceivedFrame {
+  uint32_t rtp_timestamp;
+  // Arrival time of the last packet of the frame.
+  Timestamp receive_time;
+  DataSize size;
+};
+
+// Groups the incoming RTP packets of `ssrc` in `log` into frames by their RTP
+// timestamp.
+std::vector<ReceivedFrame> ReceivedFramesFromLog(const ParsedRtcEventLog& log,
+                                                 uint32_t ssrc) {
+  std::vector<ReceivedFrame> frames;
+  for (const ParsedRtcEventLog::LoggedRtpStreamIncoming& stream :
+       log.incoming_rtp_packets_by_ssrc()) {
+    if (stream.ssrc != ssrc) {
+      continue;
+    }
+    for (const LoggedRtpPacketIncoming& packet : stream.incoming_packets) {
+      DataSize payload_size =
+          DataSize::Bytes(packet.rtp.total_length - packet.rtp.header_length);
+      if (frames.empty() ||
+          frames.back().rtp_timestamp != packet.rtp.header.timestamp) {
+        frames.push_back({packet.rtp.header.timestamp, packet.log_time(),
+                          DataSize::Zero()});
+      }
+      frames.back().receive_time = packet.log_time();
+      frames.back().size += payload_size;
+    }
+  }
+  return frames;
+}
+
+// The timing state that a video receive stream keeps per stream.
+struct ReplayedStream {
+  explicit ReplayedStream(const FieldTrialsView& field_trials)
+      : clock(Timestamp::Seconds(1)),
+        timing(&clock, field_trials),
+        jitter_estimator(&clock, field_trials) {}
+
+  SimulatedClock clock;
+  VCMTiming timing;
+  JitterEstimator jitter_estimator;
+  InterFrameDelayVariationCalculator delay_variation_calculator;
+};
+
+// Replays the frames of an event log through the timing of
+// `state.range(0)` streams at once. Every iteration receives, schedules and
+// decodes one frame of every stream, the way the frame buffer and decoder of
+// a video receive stream do.
+void BM_ReplayTiming(benchmark::State& state) {
+  const int num_streams = state.range(0);
+  ParsedRtcEventLog parsed_log;
+  RTC_CHECK(parsed_log.ParseString(CreateEventLog()).ok());
+  const std::vector<ReceivedFrame> frames =
+      ReceivedFramesFromLog(parsed_log, kSsrc);
+  RTC_CHECK_EQ(frames.size(), kNumFrames);
+  // The log is replayed in a loop, so the replay continues one frame
+  // interval after the last frame.
+  const TimeDelta log_duration = frames.back().receive_time -
+                                 frames.front().receive_time +
+                                 TimeDelta::Seconds(1) / kFramerate;
+
+  test::ExplicitKeyValueConfig field_trials("");
+  std::vector<std::unique_ptr<ReplayedStream>> streams;
+  for (int i = 0; i < num_streams; ++i) {
+    streams.push_back(std::make_unique<ReplayedStream>(field_trials));
+  }
+
+  int64_t num_frames = 0;
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    const int64_t loop = num_frames / num_streams / kNumFrames;
+    const ReceivedFrame& frame =
+        frames[num_frames / num_streams % kNumFrames];
+    const uint32_t rtp_timestamp = static_cast<uint32_t>(
+        frame.rtp_timestamp + loop * kNumFrames * kRtpTicksPerFrame);
+    const Timestamp now = frame.receive_time + loop * log_duration;
+    for (std::unique_ptr<ReplayedStream>& stream : streams) {
+      stream->clock.AdvanceTime(now - stream->clock.CurrentTime());
+      if (absl::optional<TimeDelta> frame_delay =
+              stream->delay_variation_calculator.Calculate(rtp_timestamp,
+                                                           now)) {
+        stream->jitter_estimator.UpdateEstimate(*frame_delay, frame.size);
+      }
+      stream->timing.IncomingTimestamp(rtp_timestamp, now);
+      stream->timing.SetJitterDelay(stream->jitter_estimator.GetJitterEstimate(
+          /*rtt_multiplier=*/1.0, /*rtt_mult_add_cap=*/absl::nullopt));
+      Timestamp render_time = stream->timing.RenderTime(rtp_timestamp, now);
+      TimeDelta max_wait = stream->timing.MaxWaitingTime(
+          render_time, now, /*too_many_frames_queued=*/false);
+      Timestamp decode_start = now + std::max(max_wait, TimeDelta::Zero());
+      stream->timing.UpdateCurrentDelay(render_time, decode_start);
+      // Decode time grows with the frame size.
+      TimeDelta decode_time = TimeDelta::Micros(2'000 + frame.size.bytes() / 4);
+      stream->timing.StopDecodeTimer(decode_time, decode_start + decode_time);
+    }
+    num_frames += num_streams;
+  }
+
+  state.SetItemsProcessed(num_frames);
+  state.counters["frames_per_second"] =
+      benchmark::Counter(num_frames, benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_ReplayTiming)
+    ->ArgName("streams")
+    ->RangeMultiplier(4)
+    ->Range(1, 256);
+
+}  // namespace
+}  // namespace webrtc
@@ -444,7 +444,8 @@ void Connection::OnSendStunPacket(const void* data,
 
 void Connection::OnReadPacket(const char* data,
                               size_t size,
-                              int64_t packet_time_us) {
+                              int64_t packet_time_us,
+                              webrtc::EcnMarking ecn) {
   RTC_DCHECK_RUN_ON(network_thread_);
   std::unique_ptr<IceMessage> msg;
   std::string remote_ufrag;
@@ -456,7 +457,7 @@ void Connection::OnReadPacket(const char* data,
     UpdateReceiving(last_data_received_);
     recv_rate_tracker_.AddSamples(size);
     stats_.packets_received++;
-    SignalReadPacket(this, data, size, packet_time_us);
+    SignalReadPacket(this, data, size, packet_time_us, ecn);
 
     // If timed out sending writability checks, start up again
     if (!pruned_ && (write_state_ == STATE_WRITE_TIMEOUT)) {
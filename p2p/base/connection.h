@@ -19,6 +19,7 @@
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 #include "api/candidate.h"
+#include "api/transport/ecn_marking.h"
 #include "api/transport/stun.h"
 #include "logging/rtc_event_log/ice_logger.h"
 #include "p2p/base/candidate_pair_interface.h"
@@ -145,12 +146,21 @@ class RTC_EXPORT Connection : public CandidatePairInterface {
   // Error if Send() returns < 0
   virtual int GetError() = 0;
 
-  sigslot::signal4<Connection*, const char*, size_t, int64_t> SignalReadPacket;
+  sigslot::signal5<Connection*,
+                   const char*,
+                   size_t,
+                   int64_t,
+                   webrtc::EcnMarking>
+      SignalReadPacket;
 
   sigslot::signal1<Connection*> SignalReadyToSend;
 
-  // Called when a packet is received on this connection.
-  void OnReadPacket(const char* data, size_t size, int64_t packet_time_us);
+  // Called when a packet is received on this connection. `ecn` is the ECN
+  // codepoint of the IP header, if the socket reports it.
+  void OnReadPacket(const char* data,
+                    size_t size,
+                    int64_t packet_time_us,
+                    webrtc::EcnMarking ecn = webrtc::EcnMarking::kNotEct);
 
   // Called when the socket is currently able to send.
   void OnReadyToSend();
@@ -589,11 +589,13 @@ void DtlsTransport::OnReadPacket(rtc::PacketTransportInternal* transport,
                                  int flags) {
   RTC_DCHECK_RUN_ON(&thread_checker_);
   RTC_DCHECK(transport == ice_transport_);
-  RTC_DCHECK(flags == 0);
+  // The ICE transport only passes up the ECN codepoint of the packet, which
+  // is passed on with the decrypted packets.
+  RTC_DCHECK_EQ(flags & ~rtc::kPacketFlagsEcnMask, 0);
 
   if (!dtls_active_) {
     // Not doing DTLS.
-    SignalReadPacket(this, data, size, packet_time_us, 0);
+    SignalReadPacket(this, data, size, packet_time_us, flags);
     return;
   }
 
@@ -656,7 +658,8 @@ void DtlsTransport::OnReadPacket(rtc::PacketTransportInternal* transport,
         RTC_DCHECK(!srtp_ciphers_.empty());
 
         // Signal this upwards as a bypass packet.
-        SignalReadPacket(this, data, size, packet_time_us, PF_SRTP_BYPASS);
+        SignalReadPacket(this, data, size, packet_time_us,
+                         flags | PF_SRTP_BYPASS);
       }
       break;
     case webrtc::DtlsTransportState::kFailed:
@@ -741,7 +741,9 @@ void P2PTransportChannel::ParseFieldTrials(
       &ice_field_trials_.stop_gather_on_strongly_connected,
       // GOOG_DELTA
       "enable_goog_delta", &ice_field_trials_.enable_goog_delta,
-      "answer_goog_delta", &ice_field_trials_.answer_goog_delta)
+      "answer_goog_delta", &ice_field_trials_.answer_goog_delta,
+      // Report and use a second route over another network.
+      "secondary_route", &ice_field_trials_.secondary_route)
       ->Parse(field_trials->Lookup("WebRTC-IceFieldTrials"));
 
   if (ice_field_trials_.dead_connection_timeout_ms < 30000) {
@@ -1596,7 +1598,8 @@ int P2PTransportChannel::GetError() {
   return error_;
 }
 
-// Send data to the other side, using our selected connection.
+// Send data to the other side, using our selected connection, or the secondary
+// connection if the packet asks for it.
 int P2PTransportChannel::SendPacket(const char* data,
                                     size_t len,
                                     const rtc::PacketOptions& options,
@@ -1613,15 +1616,20 @@ int P2PTransportChannel::SendPacket(const char* data,
     return -1;
   }
 
+  Connection* connection = selected_connection_;
+  if (options.send_on_secondary_route && ReadyToSend(secondary_connection_)) {
+    connection = secondary_connection_;
+  }
+
   packets_sent_++;
   last_sent_packet_id_ = options.packet_id;
   rtc::PacketOptions modified_options(options);
   modified_options.info_signaled_after_sent.packet_type =
       rtc::PacketType::kData;
-  int sent = selected_connection_->Send(data, len, modified_options);
+  int sent = connection->Send(data, len, modified_options);
   if (sent <= 0) {
     RTC_DCHECK(sent < 0);
-    error_ = selected_connection_->GetError();
+    error_ = connection->GetError();
     return sent;
   }
 
@@ -1797,6 +1805,69 @@ rtc::NetworkRoute P2PTransportChannel::ConfigureNetworkRoute(
           GetProtocolOverhead(conn->local_candidate().protocol())};
 }
 
+Connection* P2PTransportChannel::FindSecondaryConnection() const {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  if (!ice_field_trials_.secondary_route || !selected_connection_) {
+    return nullptr;
+  }
+  // A connection over the same local network shares the bottleneck of the
+  // selected connection, and is no use as a second route.
+  const uint16_t selected_network_id =
+      selected_connection_->local_candidate().network_id();
+  Connection* secondary_connection = nullptr;
+  for (Connection* connection : connections_) {
+    if (connection == selected_connection_ || !connection->writable() ||
+        connection->local_candidate().network_id() == selected_network_id) {
+      continue;
+    }
+    if (!secondary_connection ||
+        connection->rtt() < secondary_connection->rtt()) {
+      secondary_connection = connection;
+    }
+  }
+  return secondary_connection;
+}
+
+void P2PTransportChannel::ConfigureSecondaryRoute(
+    rtc::NetworkRoute* network_route) const {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  const Connection* conn = secondary_connection_;
+  if (!conn) {
+    network_route->secondary_connected = false;
+    network_route->secondary_local = rtc::RouteEndpoint();
+    network_route->secondary_remote = rtc::RouteEndpoint();
+    return;
+  }
+  network_route->secondary_connected = true;
+  network_route->secondary_local = CreateRouteEndpointFromCandidate(
+      /* local= */ true, conn->local_candidate(),
+      /* uses_turn= */ conn->port()->Type() == RELAY_PORT_TYPE);
+  network_route->secondary_remote = CreateRouteEndpointFromCandidate(
+      /* local= */ false, conn->remote_candidate(),
+      /* uses_turn= */ conn->remote_candidate().type() == RELAY_PORT_TYPE);
+}
+
+void P2PTransportChannel::UpdateSecondaryConnection() {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  secondary_connection_ = FindSecondaryConnection();
+  if (!network_route_) {
+    return;
+  }
+  rtc::NetworkRoute network_route = *network_route_;
+  ConfigureSecondaryRoute(&network_route);
+  if (network_route == *network_route_) {
+    return;
+  }
+  if (secondary_connection_) {
+    RTC_LOG(LS_INFO) << ToString() << ": New secondary connection: "
+                     << secondary_connection_->ToString();
+  } else {
+    RTC_LOG(LS_INFO) << ToString() << ": No secondary connection";
+  }
+  network_route_ = network_route;
+  SignalNetworkRouteChanged(network_route_);
+}
+
 void P2PTransportChannel::SwitchSelectedConnection(
     const Connection* new_connection,
     IceSwitchReason reason) {
@@ -1839,7 +1910,10 @@ void P2PTransportChannel::SwitchSelectedConnectionInternal(
     }
 
     network_route_.emplace(ConfigureNetworkRoute(selected_connection_));
+    secondary_connection_ = FindSecondaryConnection();
+    ConfigureSecondaryRoute(&*network_route_);
   } else {
+    secondary_connection_ = nullptr;
     RTC_LOG(LS_INFO) << ToString() << ": No selected connection";
   }
 
@@ -1961,6 +2035,8 @@ void P2PTransportChannel::UpdateTransportState() {
     standardized_state_ = current_standardized_state;
     SignalIceTransportStateChanged(this);
   }
+
+  UpdateSecondaryConnection();
 }
 
 void P2PTransportChannel::MaybeStopPortAllocatorSessions() {
@@ -2152,6 +2228,9 @@ void P2PTransportChannel::RemoveConnection(Connection* connection) {
   auto it = absl::c_find(connections_, connection);
   RTC_DCHECK(it != connections_.end());
   connections_.erase(it);
+  if (secondary_connection_ == connection) {
+    secondary_connection_ = nullptr;
+  }
   connection->ClearStunDictConsumer();
   ice_controller_->OnConnectionDestroyed(connection);
 }
@@ -2223,7 +2302,8 @@ bool P2PTransportChannel::PrunePort(PortInterface* port) {
 void P2PTransportChannel::OnReadPacket(Connection* connection,
                                        const char* data,
                                        size_t len,
-                                       int64_t packet_time_us) {
+                                       int64_t packet_time_us,
+                                       webrtc::EcnMarking ecn) {
   RTC_DCHECK_RUN_ON(network_thread_);
 
   if (connection == selected_connection_) {
@@ -2233,7 +2313,8 @@ void P2PTransportChannel::OnReadPacket(Connection* connection,
     RTC_DCHECK(connection->last_data_received() >= last_data_received_ms_);
     last_data_received_ms_ =
         std::max(last_data_received_ms_, connection->last_data_received());
-    SignalReadPacket(this, data, len, packet_time_us, 0);
+    SignalReadPacket(this, data, len, packet_time_us,
+                     rtc::EcnToPacketFlags(ecn));
     return;
   }
 
@@ -2249,11 +2330,15 @@ void P2PTransportChannel::OnReadPacket(Connection* connection,
       std::max(last_data_received_ms_, connection->last_data_received());
 
   // Let the client know of an incoming packet
-  SignalReadPacket(this, data, len, packet_time_us, 0);
+  SignalReadPacket(this, data, len, packet_time_us, rtc::EcnToPacketFlags(ecn));
 
   // May need to switch the sending connection based on the receiving media
-  // path if this is the controlled side.
-  if (ice_role_ == ICEROLE_CONTROLLED) {
+  // path if this is the controlled side. With secondary routes, the remote
+  // side may send some of its packets on a connection other than the selected
+  // one, so only follow it once the selected connection stops receiving.
+  if (ice_role_ == ICEROLE_CONTROLLED &&
+      !(ice_field_trials_.secondary_route && selected_connection_ &&
+        selected_connection_->receiving())) {
     ice_controller_->OnImmediateSwitchRequest(IceSwitchReason::DATA_RECEIVED,
                                               connection);
   }
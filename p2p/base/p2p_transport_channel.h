@@ -286,6 +286,15 @@ class RTC_EXPORT P2PTransportChannel : public IceTransportInternal,
   void SendPingRequestInternal(Connection* connection);
 
   rtc::NetworkRoute ConfigureNetworkRoute(const Connection* conn);
+  // Returns the writable connection with the lowest RTT on another local
+  // network than the selected connection, or null if there is none or the
+  // `secondary_route` ICE field trial is off.
+  Connection* FindSecondaryConnection() const;
+  // Sets the secondary route of `network_route` to `secondary_connection_`.
+  void ConfigureSecondaryRoute(rtc::NetworkRoute* network_route) const;
+  // Updates `secondary_connection_`, and signals the network route if that
+  // changes it.
+  void UpdateSecondaryConnection();
   void SwitchSelectedConnectionInternal(Connection* conn,
                                         IceSwitchReason reason);
   void UpdateTransportState();
@@ -345,7 +354,8 @@ class RTC_EXPORT P2PTransportChannel : public IceTransportInternal,
   void OnReadPacket(Connection* connection,
                     const char* data,
                     size_t len,
-                    int64_t packet_time_us);
+                    int64_t packet_time_us,
+                    webrtc::EcnMarking ecn);
   void OnSentPacket(const rtc::SentPacket& sent_packet);
   void OnReadyToSend(Connection* connection);
   void OnConnectionDestroyed(Connection* connection);
@@ -437,6 +447,9 @@ class RTC_EXPORT P2PTransportChannel : public IceTransportInternal,
   std::vector<PortInterface*> pruned_ports_ RTC_GUARDED_BY(network_thread_);
 
   Connection* selected_connection_ RTC_GUARDED_BY(network_thread_) = nullptr;
+  // Connection that packets sent with PacketOptions::send_on_secondary_route
+  // use, see FindSecondaryConnection().
+  Connection* secondary_connection_ RTC_GUARDED_BY(network_thread_) = nullptr;
   std::vector<Connection*> connections_ RTC_GUARDED_BY(network_thread_);
 
   std::vector<RemoteCandidate> remote_candidates_
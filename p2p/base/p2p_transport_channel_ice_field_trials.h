@@ -74,6 +74,13 @@ struct IceFieldTrials {
   // Announce/enable GOOG_DELTA
   bool enable_goog_delta = true;  // send GOOG DELTA
   bool answer_goog_delta = true;  // answer GOOG DELTA
+
+  // Report a writable connection over another local network than the
+  // selected one as the secondary route of the network route, and send the
+  // packets with PacketOptions::send_on_secondary_route on it. On the
+  // controlled side, data received on another connection only switches the
+  // selected connection once that one stops receiving.
+  bool secondary_route = false;
 };
 
 }  // namespace cricket
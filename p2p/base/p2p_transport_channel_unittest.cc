@@ -3071,6 +3071,111 @@ TEST_F(P2PTransportChannelMultihomedTest, TestPingBackupConnectionRate) {
   DestroyChannels();
 }
 
+// Test that with the `secondary_route` ICE field trial, the backup connection
+// over another network is reported as the secondary route, and that packets
+// asking for the secondary route are sent on it.
+TEST_F(P2PTransportChannelMultihomedTest, TestSendOnSecondaryRoute) {
+  webrtc::test::ScopedKeyValueConfig field_trials(
+      field_trials_, "WebRTC-IceFieldTrials/secondary_route:true/");
+  AddAddress(0, kPublicAddrs[0]);
+  AddAddress(1, kAlternateAddrs[1]);
+  AddAddress(1, kPublicAddrs[1]);
+
+  // Use only local ports for simplicity.
+  SetAllocatorFlags(0, kOnlyLocalPorts);
+  SetAllocatorFlags(1, kOnlyLocalPorts);
+
+  CreateChannels();
+  EXPECT_TRUE_WAIT_MARGIN(CheckConnected(ep1_ch1(), ep2_ch1()), 1000, 1000);
+  ASSERT_EQ(2U, ep2_ch1()->connections().size());
+  Connection* selected_conn = GetBestConnection(ep2_ch1());
+  Connection* backup_conn = GetBackupConnection(ep2_ch1());
+  ASSERT_TRUE(selected_conn != nullptr);
+  ASSERT_TRUE(backup_conn != nullptr);
+  EXPECT_TRUE_WAIT(ep2_ch1()->network_route().has_value() &&
+                       ep2_ch1()->network_route()->secondary_connected,
+                   kMediumTimeout);
+  EXPECT_EQ(ep2_ch1()->network_route()->secondary_local.network_id(),
+            backup_conn->local_candidate().network_id());
+  // The other endpoint only has one network.
+  ASSERT_TRUE(ep1_ch1()->network_route().has_value());
+  EXPECT_FALSE(ep1_ch1()->network_route()->secondary_connected);
+
+  const char kData[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+  const int kLength = sizeof(kData);
+  const size_t selected_bytes = selected_conn->stats().sent_total_bytes;
+  const size_t backup_bytes = backup_conn->stats().sent_total_bytes;
+  rtc::PacketOptions options;
+  options.send_on_secondary_route = true;
+  EXPECT_EQ(kLength, ep2_ch1()->SendPacket(kData, kLength, options, 0));
+  EXPECT_EQ(selected_bytes, selected_conn->stats().sent_total_bytes);
+  EXPECT_EQ(backup_bytes + kLength, backup_conn->stats().sent_total_bytes);
+  EXPECT_TRUE_WAIT(CheckDataOnChannel(ep1_ch1(), kData, kLength),
+                   kMediumTimeout);
+
+  DestroyChannels();
+}
+
+// Test that packets the controlling side sends on its secondary route do not
+// make the controlled side switch its selected connection to that route.
+TEST_F(P2PTransportChannelMultihomedTest,
+       TestReceiveOnSecondaryRouteKeepsSelectedConnection) {
+  webrtc::test::ScopedKeyValueConfig field_trials(
+      field_trials_, "WebRTC-IceFieldTrials/secondary_route:true/");
+  AddAddress(0, kPublicAddrs[0]);
+  AddAddress(0, kAlternateAddrs[0]);
+  AddAddress(1, kPublicAddrs[1]);
+  AddAddress(1, kAlternateAddrs[1]);
+  // Only connect the public addresses with each other, and the alternate
+  // addresses with each other, so that each side has one writable connection
+  // on each of its networks.
+  fw()->AddRule(false, rtc::FP_ANY, kPublicAddrs[0], kAlternateAddrs[1]);
+  fw()->AddRule(false, rtc::FP_ANY, kAlternateAddrs[1], kPublicAddrs[0]);
+  fw()->AddRule(false, rtc::FP_ANY, kAlternateAddrs[0], kPublicAddrs[1]);
+  fw()->AddRule(false, rtc::FP_ANY, kPublicAddrs[1], kAlternateAddrs[0]);
+
+  // Use only local ports for simplicity.
+  SetAllocatorFlags(0, kOnlyLocalPorts);
+  SetAllocatorFlags(1, kOnlyLocalPorts);
+
+  CreateChannels();
+  EXPECT_TRUE_WAIT_MARGIN(
+      CheckCandidatePairAndConnected(ep1_ch1(), ep2_ch1(), kPublicAddrs[0],
+                                     kPublicAddrs[1]),
+      1000, 1000);
+  ASSERT_EQ(ICEROLE_CONTROLLING, ep1_ch1()->GetIceRole());
+  ASSERT_EQ(ICEROLE_CONTROLLED, ep2_ch1()->GetIceRole());
+  EXPECT_TRUE_WAIT(ep1_ch1()->network_route().has_value() &&
+                       ep1_ch1()->network_route()->secondary_connected,
+                   kMediumTimeout);
+  Connection* selected_conn = GetBestConnection(ep2_ch1());
+  ASSERT_TRUE(selected_conn != nullptr);
+  Connection* backup_conn = nullptr;
+  for (Connection* conn : ep2_ch1()->connections()) {
+    if (conn->local_candidate().address().EqualIPs(kAlternateAddrs[1]) &&
+        conn->remote_candidate().address().EqualIPs(kAlternateAddrs[0])) {
+      backup_conn = conn;
+    }
+  }
+  ASSERT_TRUE(backup_conn != nullptr);
+  EXPECT_TRUE_WAIT(backup_conn->writable(), kMediumTimeout);
+  // As if the controlling side had selected the backup connection before, so
+  // that only the data received tells the two connections apart.
+  backup_conn->set_remote_nomination(selected_conn->remote_nomination());
+
+  const char kData[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+  const int kLength = sizeof(kData);
+  rtc::PacketOptions options;
+  options.send_on_secondary_route = true;
+  EXPECT_EQ(kLength, ep1_ch1()->SendPacket(kData, kLength, options, 0));
+  EXPECT_TRUE_WAIT(CheckDataOnChannel(ep2_ch1(), kData, kLength),
+                   kMediumTimeout);
+  EXPECT_GT(backup_conn->last_data_received(), 0);
+  EXPECT_EQ(selected_conn, ep2_ch1()->selected_connection());
+
+  DestroyChannels();
+}
+
 // Test that the connection is pinged at a rate no faster than
 // what was configured when stable and writable.
 TEST_F(P2PTransportChannelMultihomedTest, TestStableWritableRate) {
@@ -3481,6 +3586,8 @@ class P2PTransportChannelPingTest : public ::testing::Test,
         this, &P2PTransportChannelPingTest::OnChannelStateChanged);
     ch->SignalCandidatePairChanged.connect(
         this, &P2PTransportChannelPingTest::OnCandidatePairChanged);
+    ch->SignalReadPacket.connect(this,
+                                 &P2PTransportChannelPingTest::OnReadPacket);
   }
 
   Connection* WaitForConnectionTo(
@@ -3615,8 +3722,16 @@ class P2PTransportChannelPingTest : public ::testing::Test,
   void OnCandidatePairChanged(const CandidatePairChangeEvent& event) {
     last_candidate_change_event_ = event;
   }
+  void OnReadPacket(rtc::PacketTransportInternal* transport,
+                    const char* data,
+                    size_t len,
+                    const int64_t& packet_time_us,
+                    int flags) {
+    last_read_packet_flags_ = flags;
+  }
 
   int last_sent_packet_id() { return last_sent_packet_id_; }
+  int last_read_packet_flags() { return last_read_packet_flags_; }
   bool channel_ready_to_send() { return channel_ready_to_send_; }
   void reset_channel_ready_to_send() { channel_ready_to_send_ = false; }
   IceTransportState channel_state() { return channel_state_; }
@@ -3677,6 +3792,7 @@ class P2PTransportChannelPingTest : public ::testing::Test,
   rtc::AutoSocketServerThread thread_;
   int selected_candidate_pair_switches_ = 0;
   int last_sent_packet_id_ = -1;
+  int last_read_packet_flags_ = -1;
   bool channel_ready_to_send_ = false;
   absl::optional<CandidatePairChangeEvent> last_candidate_change_event_;
   IceTransportState channel_state_ = IceTransportState::STATE_INIT;
@@ -4065,6 +4181,25 @@ TEST_F(P2PTransportChannelPingTest, TestReceivingStateChange) {
   EXPECT_TRUE_SIMULATED_WAIT(!ch.receiving(), kShortTimeout, clock);
 }
 
+// The ECN codepoint that a connection reads a packet with is passed up in the
+// flags of SignalReadPacket.
+TEST_F(P2PTransportChannelPingTest, TestReadPacketPassesEcnInFlags) {
+  FakePortAllocator pa(rtc::Thread::Current(), packet_socket_factory(),
+                       &field_trials_);
+  P2PTransportChannel ch("read packet ecn", 1, &pa, &field_trials_);
+  PrepareChannel(&ch);
+  ch.MaybeStartGathering();
+  ch.AddRemoteCandidate(CreateUdpCandidate(LOCAL_PORT_TYPE, "1.1.1.1", 1, 1));
+  Connection* conn1 = WaitForConnectionTo(&ch, "1.1.1.1", 1);
+  ASSERT_TRUE(conn1 != nullptr);
+
+  conn1->OnReadPacket("ABC", 3, rtc::TimeMicros(), webrtc::EcnMarking::kCe);
+  EXPECT_EQ(rtc::EcnFromPacketFlags(last_read_packet_flags()),
+            webrtc::EcnMarking::kCe);
+  conn1->OnReadPacket("ABC", 3, rtc::TimeMicros());
+  EXPECT_EQ(last_read_packet_flags(), 0);
+}
+
 // The controlled side will select a connection as the "selected connection"
 // based on priority until the controlling side nominates a connection, at which
 // point the controlled side will select that connection as the
@@ -15,6 +15,7 @@
 #include <vector>
 
 #include "absl/types/optional.h"
+#include "api/transport/ecn_marking.h"
 #include "p2p/base/port.h"
 #include "rtc_base/async_packet_socket.h"
 #include "rtc_base/network_route.h"
@@ -26,6 +27,21 @@ namespace rtc {
 struct PacketOptions;
 struct SentPacket;
 
+// The ECN codepoint of a received packet is passed up in bits 1-2 of the
+// `flags` of PacketTransportInternal::SignalReadPacket, next to
+// cricket::PF_SRTP_BYPASS.
+constexpr int kPacketFlagsEcnShift = 1;
+constexpr int kPacketFlagsEcnMask = 0x03 << kPacketFlagsEcnShift;
+
+inline int EcnToPacketFlags(webrtc::EcnMarking ecn) {
+  return static_cast<int>(ecn) << kPacketFlagsEcnShift;
+}
+
+inline webrtc::EcnMarking EcnFromPacketFlags(int flags) {
+  return static_cast<webrtc::EcnMarking>((flags & kPacketFlagsEcnMask) >>
+                                         kPacketFlagsEcnShift);
+}
+
 class RTC_EXPORT PacketTransportInternal : public sigslot::has_slots<> {
  public:
   virtual const std::string& transport_name() const = 0;
@@ -408,7 +408,7 @@ void UDPPort::OnReadPacket(rtc::AsyncPacketSocket* socket,
   }
 
   if (Connection* conn = GetConnection(remote_addr)) {
-    conn->OnReadPacket(data, size, packet_time_us);
+    conn->OnReadPacket(data, size, packet_time_us, socket->GetReadPacketEcn());
   } else {
     Port::OnReadPacket(data, size, remote_addr, PROTO_UDP);
   }
@@ -219,14 +219,16 @@ class TurnPortTest : public ::testing::Test,
   void OnTurnReadPacket(Connection* conn,
                         const char* data,
                         size_t size,
-                        int64_t packet_time_us) {
+                        int64_t packet_time_us,
+                        webrtc::EcnMarking ecn) {
     turn_packets_.push_back(rtc::Buffer(data, size));
   }
   void OnUdpPortComplete(Port* port) { udp_ready_ = true; }
   void OnUdpReadPacket(Connection* conn,
                        const char* data,
                        size_t size,
-                       int64_t packet_time_us) {
+                       int64_t packet_time_us,
+                       webrtc::EcnMarking ecn) {
     udp_packets_.push_back(rtc::Buffer(data, size));
   }
   void OnSocketReadPacket(rtc::AsyncPacketSocket* socket,
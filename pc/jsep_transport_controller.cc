@@ -30,6 +30,7 @@
 #include "p2p/base/port.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/socket.h"
 #include "rtc_base/thread.h"
 #include "rtc_base/trace_event.h"
 
@@ -405,6 +406,12 @@ JsepTransportController::CreateIceTransport(const std::string& transport_name,
   transport->internal()->SetIceRole(ice_role_);
   transport->internal()->SetIceTiebreaker(ice_tiebreaker_);
   transport->internal()->SetIceConfig(ice_config_);
+  if (config_.field_trials->IsEnabled(
+          "WebRTC-RFC8888CongestionControlFeedback")) {
+    // The congestion control feedback reports the ECN codepoint of the
+    // received RTP packets.
+    transport->internal()->SetOption(rtc::Socket::OPT_RECV_ECN, 1);
+  }
   return transport;
 }
 
@@ -18,12 +18,14 @@
 #include "api/call/call_factory_interface.h"
 #include "api/fec_controller.h"
 #include "api/ice_transport_interface.h"
+#include "api/make_ref_counted.h"
 #include "api/network_state_predictor.h"
 #include "api/packet_socket_factory.h"
 #include "api/rtc_event_log/rtc_event_log.h"
 #include "api/sequence_checker.h"
 #include "api/transport/bitrate_settings.h"
 #include "api/units/data_rate.h"
+#include "api/video_codecs/decoder_core_budget.h"
 #include "call/audio_state.h"
 #include "call/rtp_transport_controller_send_factory.h"
 #include "media/base/media_engine.h"
@@ -50,8 +52,21 @@
 #include "rtc_base/numerics/safe_conversions.h"
 #include "rtc_base/rtc_certificate_generator.h"
 #include "rtc_base/system/file_wrapper.h"
+#include "system_wrappers/include/cpu_info.h"
 
 namespace webrtc {
+namespace {
+
+rtc::scoped_refptr<DecoderCoreBudget> CreateDecoderCoreBudget(
+    const FieldTrialsView& field_trials) {
+  if (!field_trials.IsEnabled("WebRTC-DecoderCoreBudget")) {
+    return nullptr;
+  }
+  return rtc::make_ref_counted<DecoderCoreBudget>(
+      CpuInfo::DetectNumberOfCores());
+}
+
+}  // namespace
 
 rtc::scoped_refptr<PeerConnectionFactoryInterface>
 CreateModularPeerConnectionFactory(
@@ -101,7 +116,8 @@ PeerConnectionFactory::PeerConnectionFactory(
           (dependencies->transport_controller_send_factory)
               ? std::move(dependencies->transport_controller_send_factory)
               : std::make_unique<RtpTransportControllerSendFactory>()),
-      metronome_(std::move(dependencies->metronome)) {}
+      metronome_(std::move(dependencies->metronome)),
+      decoder_core_budget_(CreateDecoderCoreBudget(context->field_trials())) {}
 
 PeerConnectionFactory::PeerConnectionFactory(
     PeerConnectionFactoryDependencies dependencies)
@@ -341,6 +357,7 @@ std::unique_ptr<Call> PeerConnectionFactory::CreateCall_w(
   call_config.rtp_transport_controller_send_factory =
       transport_controller_send_factory_.get();
   call_config.metronome = metronome_.get();
+  call_config.decoder_core_budget = decoder_core_budget_;
   call_config.pacer_burst_interval = configuration.pacer_burst_interval;
   return std::unique_ptr<Call>(
       context_->call_factory()->CreateCall(call_config));
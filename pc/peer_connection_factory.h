@@ -37,6 +37,7 @@
 #include "api/task_queue/task_queue_factory.h"
 #include "api/transport/network_control.h"
 #include "api/transport/sctp_transport_factory_interface.h"
+#include "api/video_codecs/decoder_core_budget.h"
 #include "call/call.h"
 #include "call/rtp_transport_controller_send_factory_interface.h"
 #include "p2p/base/port_allocator.h"
@@ -155,6 +156,10 @@ class PeerConnectionFactory : public PeerConnectionFactoryInterface {
   const std::unique_ptr<RtpTransportControllerSendFactoryInterface>
       transport_controller_send_factory_;
   std::unique_ptr<Metronome> metronome_ RTC_GUARDED_BY(worker_thread());
+  // Shared by the calls of all peer connections of the factory, so that their
+  // video decoders together use at most one thread per core. Null unless the
+  // "WebRTC-DecoderCoreBudget" field trial is enabled.
+  const rtc::scoped_refptr<DecoderCoreBudget> decoder_core_budget_;
 };
 
 }  // namespace webrtc
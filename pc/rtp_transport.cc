@@ -181,7 +181,8 @@ bool RtpTransport::UnregisterRtpDemuxerSink(RtpPacketSinkInterface* sink) {
 }
 
 void RtpTransport::DemuxPacket(rtc::CopyOnWriteBuffer packet,
-                               int64_t packet_time_us) {
+                               int64_t packet_time_us,
+                               EcnMarking ecn) {
   webrtc::RtpPacketReceived parsed_packet(
       &header_extension_map_, packet_time_us == -1
                                   ? Timestamp::MinusInfinity()
@@ -191,6 +192,7 @@ void RtpTransport::DemuxPacket(rtc::CopyOnWriteBuffer packet,
         << "Failed to parse the incoming RTP packet before demuxing. Drop it.";
     return;
   }
+  parsed_packet.set_ecn(ecn);
 
   if (!rtp_demuxer_.OnRtpPacket(parsed_packet)) {
     RTC_LOG(LS_VERBOSE) << "Failed to demux RTP packet: "
@@ -230,8 +232,9 @@ void RtpTransport::OnSentPacket(rtc::PacketTransportInternal* packet_transport,
 }
 
 void RtpTransport::OnRtpPacketReceived(rtc::CopyOnWriteBuffer packet,
-                                       int64_t packet_time_us) {
-  DemuxPacket(packet, packet_time_us);
+                                       int64_t packet_time_us,
+                                       EcnMarking ecn) {
+  DemuxPacket(packet, packet_time_us, ecn);
 }
 
 void RtpTransport::OnRtcpPacketReceived(rtc::CopyOnWriteBuffer packet,
@@ -267,7 +270,8 @@ void RtpTransport::OnReadPacket(rtc::PacketTransportInternal* transport,
   if (packet_type == cricket::RtpPacketType::kRtcp) {
     OnRtcpPacketReceived(std::move(packet), packet_time_us);
   } else {
-    OnRtpPacketReceived(std::move(packet), packet_time_us);
+    OnRtpPacketReceived(std::move(packet), packet_time_us,
+                        rtc::EcnFromPacketFlags(flags));
   }
 }
 
@@ -321,4 +321,25 @@ TEST(RtpTransportTest, DontSignalUnhandledRtpPayloadType) {
   transport.UnregisterRtpDemuxerSink(&observer);
 }
 
+// Test that the ECN codepoint in the flags of a received packet is set on the
+// demuxed RTP packet.
+TEST(RtpTransportTest, SetsEcnOfReceivedRtpPacket) {
+  RtpTransport transport(kMuxDisabled);
+  rtc::FakePacketTransport fake_rtp("fake_rtp");
+  transport.SetRtpPacketTransport(&fake_rtp);
+  TransportObserver observer(&transport);
+  RtpDemuxerCriteria demuxer_criteria;
+  demuxer_criteria.payload_types().insert(0x11);
+  transport.RegisterRtpDemuxerSink(demuxer_criteria, &observer);
+
+  rtc::Buffer rtp_data(kRtpData, kRtpLen);
+  fake_rtp.SignalReadPacket(&fake_rtp, rtp_data.data<char>(), kRtpLen,
+                            /*packet_time_us=*/-1,
+                            rtc::EcnToPacketFlags(EcnMarking::kCe));
+  EXPECT_EQ(1, observer.rtp_count());
+  EXPECT_EQ(observer.last_recv_rtp_packet_ecn(), EcnMarking::kCe);
+  // Remove the sink before destroying the transport.
+  transport.UnregisterRtpDemuxerSink(&observer);
+}
+
 }  // namespace webrtc
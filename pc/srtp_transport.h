@@ -19,6 +19,7 @@
 #include <vector>
 
 #include "absl/types/optional.h"
+#include "api/transport/ecn_marking.h"
 #include "api/crypto_params.h"
 #include "api/field_trials_view.h"
 #include "api/rtc_error.h"
@@ -118,7 +119,8 @@ class SrtpTransport : public RtpTransport {
   void CreateSrtpSessions();
 
   void OnRtpPacketReceived(rtc::CopyOnWriteBuffer packet,
-                           int64_t packet_time_us) override;
+                           int64_t packet_time_us,
+                           EcnMarking ecn) override;
   void OnRtcpPacketReceived(rtc::CopyOnWriteBuffer packet,
                             int64_t packet_time_us) override;
   void OnNetworkRouteChanged(
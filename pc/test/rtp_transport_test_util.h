@@ -11,6 +11,7 @@
 #ifndef PC_TEST_RTP_TRANSPORT_TEST_UTIL_H_
 #define PC_TEST_RTP_TRANSPORT_TEST_UTIL_H_
 
+#include "api/transport/ecn_marking.h"
 #include "call/rtp_packet_sink_interface.h"
 #include "modules/rtp_rtcp/source/rtp_packet_received.h"
 #include "pc/rtp_transport_internal.h"
@@ -40,6 +41,7 @@ class TransportObserver : public RtpPacketSinkInterface {
   void OnRtpPacket(const RtpPacketReceived& packet) override {
     rtp_count_++;
     last_recv_rtp_packet_ = packet.Buffer();
+    last_recv_rtp_packet_ecn_ = packet.ecn();
   }
 
   void OnUndemuxableRtpPacket(const RtpPacketReceived& packet) {
@@ -60,6 +62,10 @@ class TransportObserver : public RtpPacketSinkInterface {
     return last_recv_rtp_packet_;
   }
 
+  EcnMarking last_recv_rtp_packet_ecn() const {
+    return last_recv_rtp_packet_ecn_;
+  }
+
   rtc::CopyOnWriteBuffer last_recv_rtcp_packet() {
     return last_recv_rtcp_packet_;
   }
@@ -80,6 +86,7 @@ class TransportObserver : public RtpPacketSinkInterface {
   int rtcp_count_ = 0;
   int ready_to_send_signal_count_ = 0;
   rtc::CopyOnWriteBuffer last_recv_rtp_packet_;
+  EcnMarking last_recv_rtp_packet_ecn_ = EcnMarking::kNotEct;
   rtc::CopyOnWriteBuffer last_recv_rtcp_packet_;
 };
 
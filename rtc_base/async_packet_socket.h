@@ -14,6 +14,7 @@
 #include <vector>
 
 #include "api/sequence_checker.h"
+#include "api/transport/ecn_marking.h"
 #include "rtc_base/callback_list.h"
 #include "rtc_base/dscp.h"
 #include "rtc_base/network/sent_packet.h"
@@ -60,6 +61,13 @@ struct RTC_EXPORT PacketOptions {
   bool batchable = false;
   // True if this is the last packet of a batch.
   bool last_packet_in_batch = false;
+  // True if the packet should be sent on the secondary route of the transport,
+  // see NetworkRoute::secondary_connected. Ignored if there is none.
+  bool send_on_secondary_route = false;
+  // The ECN codepoint to send the packet with. Ignored by sockets that can't
+  // set it. A UDP socket sends packets with kNotEct using the last codepoint a
+  // packet asked for, so that RTCP and STUN don't toggle the socket option.
+  webrtc::EcnMarking ecn = webrtc::EcnMarking::kNotEct;
 };
 
 // Provides the ability to receive packets asynchronously. Sends are not
@@ -126,6 +134,13 @@ class RTC_EXPORT AsyncPacketSocket : public sigslot::has_slots<> {
                    const int64_t&>
       SignalReadPacket;
 
+  // Returns the ECN codepoint of the packet that SignalReadPacket is emitted
+  // for, and may only be called by its handlers. EcnMarking::kNotEct unless
+  // Socket::OPT_RECV_ECN is set and the socket reports it.
+  virtual webrtc::EcnMarking GetReadPacketEcn() const {
+    return webrtc::EcnMarking::kNotEct;
+  }
+
   // Emitted each time a packet is sent.
   sigslot::signal2<AsyncPacketSocket*, const SentPacket&> SignalSentPacket;
 
@@ -64,6 +64,7 @@ int AsyncUDPSocket::Send(const void* pv,
   rtc::SentPacket sent_packet(options.packet_id, rtc::TimeMillis(),
                               options.info_signaled_after_sent);
   CopySocketInformationToPacketInfo(cb, *this, false, &sent_packet.info);
+  UpdateSendEcn(options);
   int ret = socket_->Send(pv, cb);
   SignalSentPacket(this, sent_packet);
   return ret;
@@ -76,6 +77,7 @@ int AsyncUDPSocket::SendTo(const void* pv,
   rtc::SentPacket sent_packet(options.packet_id, rtc::TimeMillis(),
                               options.info_signaled_after_sent);
   CopySocketInformationToPacketInfo(cb, *this, true, &sent_packet.info);
+  UpdateSendEcn(options);
   int ret = socket_->SendTo(pv, cb, addr);
   SignalSentPacket(this, sent_packet);
   return ret;
@@ -94,7 +96,11 @@ int AsyncUDPSocket::GetOption(Socket::Option opt, int* value) {
 }
 
 int AsyncUDPSocket::SetOption(Socket::Option opt, int value) {
-  return socket_->SetOption(opt, value);
+  int result = socket_->SetOption(opt, value);
+  if (opt == Socket::OPT_SEND_ECN && result == 0) {
+    send_ecn_ = static_cast<webrtc::EcnMarking>(value);
+  }
+  return result;
 }
 
 int AsyncUDPSocket::GetError() const {
@@ -105,13 +111,32 @@ void AsyncUDPSocket::SetError(int error) {
   return socket_->SetError(error);
 }
 
+webrtc::EcnMarking AsyncUDPSocket::GetReadPacketEcn() const {
+  RTC_DCHECK_RUN_ON(&sequence_checker_);
+  return read_packet_ecn_;
+}
+
+void AsyncUDPSocket::UpdateSendEcn(const rtc::PacketOptions& options) {
+  // RTP packets that ask for an ECN codepoint share the socket with RTCP and
+  // STUN packets that don't. Those are sent with the codepoint of the RTP
+  // packets, rather than setting the option back and forth on every packet.
+  if (options.ecn == webrtc::EcnMarking::kNotEct || options.ecn == send_ecn_ ||
+      !send_ecn_supported_) {
+    return;
+  }
+  if (SetOption(Socket::OPT_SEND_ECN, static_cast<int>(options.ecn)) != 0) {
+    send_ecn_supported_ = false;
+  }
+}
+
 void AsyncUDPSocket::OnReadEvent(Socket* socket) {
   RTC_DCHECK(socket_.get() == socket);
   RTC_DCHECK_RUN_ON(&sequence_checker_);
 
   SocketAddress remote_addr;
   int64_t timestamp = -1;
-  int len = socket_->RecvFrom(buf_, BUF_SIZE, &remote_addr, &timestamp);
+  int len = socket_->RecvFromWithEcn(buf_, BUF_SIZE, &remote_addr, &timestamp,
+                                     &read_packet_ecn_);
 
   if (len < 0) {
     // An error here typically means we got an ICMP error in response to our
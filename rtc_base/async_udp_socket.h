@@ -59,8 +59,13 @@ class AsyncUDPSocket : public AsyncPacketSocket {
   int SetOption(Socket::Option opt, int value) override;
   int GetError() const override;
   void SetError(int error) override;
+  webrtc::EcnMarking GetReadPacketEcn() const override;
 
  private:
+  // Sets Socket::OPT_SEND_ECN if `options` asks for an ECN codepoint other
+  // than the one the socket sends with. Packets that don't ask for one keep
+  // the codepoint of the socket.
+  void UpdateSendEcn(const rtc::PacketOptions& options);
   // Called when the underlying socket is ready to be read from.
   void OnReadEvent(Socket* socket);
   // Called when the underlying socket is ready to send.
@@ -71,6 +76,10 @@ class AsyncUDPSocket : public AsyncPacketSocket {
   static constexpr int BUF_SIZE = 64 * 1024;
   char buf_[BUF_SIZE] RTC_GUARDED_BY(sequence_checker_);
   absl::optional<int64_t> socket_time_offset_ RTC_GUARDED_BY(sequence_checker_);
+  webrtc::EcnMarking read_packet_ecn_ RTC_GUARDED_BY(sequence_checker_) =
+      webrtc::EcnMarking::kNotEct;
+  webrtc::EcnMarking send_ecn_ = webrtc::EcnMarking::kNotEct;
+  bool send_ecn_supported_ = true;
 };
 
 }  // namespace rtc
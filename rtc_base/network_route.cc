@@ -21,7 +21,10 @@ bool RouteEndpoint::operator==(const RouteEndpoint& other) const {
 bool NetworkRoute::operator==(const NetworkRoute& other) const {
   return connected == other.connected && local == other.local &&
          remote == other.remote && packet_overhead == other.packet_overhead &&
-         last_sent_packet_id == other.last_sent_packet_id;
+         last_sent_packet_id == other.last_sent_packet_id &&
+         secondary_connected == other.secondary_connected &&
+         secondary_local == other.secondary_local &&
+         secondary_remote == other.secondary_remote;
 }
 
 }  // namespace rtc
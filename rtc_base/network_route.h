@@ -73,6 +73,12 @@ struct NetworkRoute {
   // The overhead in bytes from IP layer and above.
   // This is the maximum of any part of the route.
   int packet_overhead = 0;
+  // Whether the transport has a second route, over other networks than
+  // `local`, that packets can be sent on with
+  // PacketOptions::send_on_secondary_route, and the endpoints of that route.
+  bool secondary_connected = false;
+  RouteEndpoint secondary_local;
+  RouteEndpoint secondary_remote;
 
   RTC_NO_INLINE inline std::string DebugString() const {
     rtc::StringBuilder oss;
@@ -83,7 +89,16 @@ struct NetworkRoute {
         << remote.adapter_id() << "/" << remote.network_id() << " "
         << AdapterTypeToString(remote.adapter_type())
         << " turn: " << remote.uses_turn()
-        << " ] packet_overhead_bytes: " << packet_overhead << " ]";
+        << " ] packet_overhead_bytes: " << packet_overhead;
+    if (secondary_connected) {
+      oss << " secondary: [ " << secondary_local.adapter_id() << "/"
+          << secondary_local.network_id() << " "
+          << AdapterTypeToString(secondary_local.adapter_type()) << " -> "
+          << secondary_remote.adapter_id() << "/"
+          << secondary_remote.network_id() << " "
+          << AdapterTypeToString(secondary_remote.adapter_type()) << " ]";
+    }
+    oss << " ]";
     return oss.Release();
   }
 
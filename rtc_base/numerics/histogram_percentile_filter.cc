@@ -0,0 +1,122 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/numerics/histogram_percentile_filter.h"
+
+#include <algorithm>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+HistogramPercentileFilter::HistogramPercentileFilter(float percentile,
+                                                     int num_buckets)
+    : percentile_(percentile), buckets_(num_buckets, 0) {
+  RTC_CHECK_GE(percentile, 0.0f);
+  RTC_CHECK_LE(percentile, 1.0f);
+  RTC_CHECK_GT(num_buckets, 0);
+}
+
+HistogramPercentileFilter::~HistogramPercentileFilter() = default;
+
+void HistogramPercentileFilter::Insert(int64_t value) {
+  if (value >= 0 && value < static_cast<int64_t>(buckets_.size())) {
+    ++buckets_[value];
+    ++num_values_in_range_;
+    if (value < cursor_) {
+      ++num_values_before_cursor_;
+    }
+  } else {
+    ++long_tail_[value];
+    if (value < 0) {
+      ++num_values_below_range_;
+    }
+  }
+  ++num_values_;
+  UpdatePercentile();
+}
+
+bool HistogramPercentileFilter::Erase(int64_t value) {
+  if (value >= 0 && value < static_cast<int64_t>(buckets_.size())) {
+    if (buckets_[value] == 0) {
+      return false;
+    }
+    --buckets_[value];
+    --num_values_in_range_;
+    if (value < cursor_) {
+      --num_values_before_cursor_;
+    }
+  } else {
+    auto it = long_tail_.find(value);
+    if (it == long_tail_.end()) {
+      return false;
+    }
+    if (--it->second == 0) {
+      long_tail_.erase(it);
+    }
+    if (value < 0) {
+      --num_values_below_range_;
+    }
+  }
+  --num_values_;
+  UpdatePercentile();
+  return true;
+}
+
+void HistogramPercentileFilter::Reset() {
+  std::fill(buckets_.begin(), buckets_.end(), 0);
+  long_tail_.clear();
+  num_values_ = 0;
+  num_values_in_range_ = 0;
+  num_values_below_range_ = 0;
+  cursor_ = 0;
+  num_values_before_cursor_ = 0;
+  percentile_value_ = 0;
+}
+
+void HistogramPercentileFilter::UpdatePercentile() {
+  if (num_values_ == 0) {
+    percentile_value_ = 0;
+    return;
+  }
+  const int64_t index = static_cast<int64_t>(percentile_ * (num_values_ - 1));
+  if (index < num_values_below_range_) {
+    percentile_value_ = LongTailValue(index);
+    return;
+  }
+  const int64_t index_in_range = index - num_values_below_range_;
+  if (index_in_range >= num_values_in_range_) {
+    percentile_value_ = LongTailValue(index - num_values_in_range_);
+    return;
+  }
+  // Move the cursor to the bucket that holds the `index_in_range`th value.
+  while (num_values_before_cursor_ > index_in_range) {
+    --cursor_;
+    num_values_before_cursor_ -= buckets_[cursor_];
+  }
+  while (num_values_before_cursor_ + buckets_[cursor_] <= index_in_range) {
+    num_values_before_cursor_ += buckets_[cursor_];
+    ++cursor_;
+  }
+  percentile_value_ = cursor_;
+}
+
+int64_t HistogramPercentileFilter::LongTailValue(int64_t index) const {
+  for (const auto& [value, count] : long_tail_) {
+    if (index < count) {
+      return value;
+    }
+    index -= count;
+  }
+  RTC_DCHECK_NOTREACHED();
+  return 0;
+}
+
+}  // namespace webrtc
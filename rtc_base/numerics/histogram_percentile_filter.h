@@ -0,0 +1,77 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_NUMERICS_HISTOGRAM_PERCENTILE_FILTER_H_
+#define RTC_BASE_NUMERICS_HISTOGRAM_PERCENTILE_FILTER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <vector>
+
+namespace webrtc {
+
+// Percentile filter over integer observations that are mostly in a known,
+// small range, e.g. durations in milliseconds. It returns the same values as
+// `PercentileFilter<int64_t>`.
+//
+// Values in [0, `num_buckets`) are counted in a histogram with one bucket per
+// value, so inserting and erasing them takes constant time. The percentile
+// value is tracked by a cursor over the buckets, which only moves as far as
+// the percentile does. Values outside of the range are kept in a map and are
+// slower to insert and erase, in particular when the percentile value is one
+// of them.
+class HistogramPercentileFilter {
+ public:
+  // `percentile` should be between 0 and 1, and `num_buckets` positive.
+  HistogramPercentileFilter(float percentile, int num_buckets);
+  HistogramPercentileFilter(const HistogramPercentileFilter&) = delete;
+  HistogramPercentileFilter& operator=(const HistogramPercentileFilter&) =
+      delete;
+  ~HistogramPercentileFilter();
+
+  // Insert one observation.
+  void Insert(int64_t value);
+
+  // Remove one observation or return false if `value` doesn't exist in the
+  // filter.
+  bool Erase(int64_t value);
+
+  // Get the percentile value, or 0 if the filter is empty. The complexity of
+  // this operation is constant.
+  int64_t GetPercentileValue() const { return percentile_value_; }
+
+  // Removes all the stored observations.
+  void Reset();
+
+ private:
+  // Moves the cursor to the target percentile and updates
+  // `percentile_value_`.
+  void UpdatePercentile();
+  // Returns the `index`th smallest of the values outside of the bucket range.
+  int64_t LongTailValue(int64_t index) const;
+
+  const float percentile_;
+  std::vector<int> buckets_;
+  // Counts of the values outside of [0, `buckets_.size()`).
+  std::map<int64_t, int> long_tail_;
+  int64_t num_values_ = 0;
+  int64_t num_values_in_range_ = 0;
+  int64_t num_values_below_range_ = 0;
+  // The cursor bucket, and the number of values in the buckets before it.
+  int64_t cursor_ = 0;
+  int64_t num_values_before_cursor_ = 0;
+  int64_t percentile_value_ = 0;
+};
+
+}  // namespace webrtc
+
+#endif  // RTC_BASE_NUMERICS_HISTOGRAM_PERCENTILE_FILTER_H_
@@ -0,0 +1,102 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/numerics/histogram_percentile_filter.h"
+
+#include <cstdint>
+#include <deque>
+#include <random>
+
+#include "rtc_base/numerics/percentile_filter.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kNumBuckets = 100;
+
+class HistogramPercentileFilterTest : public ::testing::TestWithParam<float> {
+ public:
+  HistogramPercentileFilterTest() : filter_(GetParam(), kNumBuckets) {}
+
+ protected:
+  HistogramPercentileFilter filter_;
+};
+
+INSTANTIATE_TEST_SUITE_P(HistogramPercentileFilterTests,
+                         HistogramPercentileFilterTest,
+                         ::testing::Values(0.0f, 0.1f, 0.5f, 0.95f, 1.0f));
+
+TEST(HistogramPercentileFilterTest, MinAndMaxFilter) {
+  HistogramPercentileFilter min_filter(0.0f, kNumBuckets);
+  HistogramPercentileFilter max_filter(1.0f, kNumBuckets);
+  for (int64_t value : {4, 3, 50, 7}) {
+    min_filter.Insert(value);
+    max_filter.Insert(value);
+  }
+  EXPECT_EQ(3, min_filter.GetPercentileValue());
+  EXPECT_EQ(50, max_filter.GetPercentileValue());
+}
+
+TEST(HistogramPercentileFilterTest, MedianOfValuesOutsideOfBucketRange) {
+  HistogramPercentileFilter filter(0.5f, kNumBuckets);
+  filter.Insert(-5);
+  filter.Insert(1000);
+  filter.Insert(2000);
+  EXPECT_EQ(1000, filter.GetPercentileValue());
+  filter.Insert(-10);
+  filter.Insert(-20);
+  EXPECT_EQ(-5, filter.GetPercentileValue());
+  filter.Insert(10);
+  filter.Erase(-20);
+  EXPECT_EQ(10, filter.GetPercentileValue());
+}
+
+TEST_P(HistogramPercentileFilterTest, EmptyFilter) {
+  EXPECT_EQ(0, filter_.GetPercentileValue());
+  filter_.Insert(3);
+  EXPECT_TRUE(filter_.Erase(3));
+  EXPECT_EQ(0, filter_.GetPercentileValue());
+  filter_.Insert(300);
+  filter_.Reset();
+  EXPECT_EQ(0, filter_.GetPercentileValue());
+}
+
+TEST_P(HistogramPercentileFilterTest, EraseNonExistingElement) {
+  EXPECT_FALSE(filter_.Erase(3));
+  EXPECT_FALSE(filter_.Erase(300));
+  filter_.Insert(4);
+  EXPECT_FALSE(filter_.Erase(3));
+  EXPECT_EQ(4, filter_.GetPercentileValue());
+}
+
+TEST_P(HistogramPercentileFilterTest, MatchesPercentileFilterInSlidingWindow) {
+  PercentileFilter<int64_t> reference(GetParam());
+  std::deque<int64_t> window;
+  std::mt19937 generator(42);
+  // Values both in and on either side of the bucket range.
+  std::uniform_int_distribution<int64_t> value_distribution(-20,
+                                                            2 * kNumBuckets);
+  for (int i = 0; i < 5000; ++i) {
+    int64_t value = value_distribution(generator);
+    filter_.Insert(value);
+    reference.Insert(value);
+    window.push_back(value);
+    if (window.size() > 50) {
+      EXPECT_TRUE(filter_.Erase(window.front()));
+      reference.Erase(window.front());
+      window.pop_front();
+    }
+    ASSERT_EQ(reference.GetPercentileValue(), filter_.GetPercentileValue());
+  }
+}
+
+}  // namespace
+}  // namespace webrtc
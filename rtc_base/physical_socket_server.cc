@@ -127,6 +127,28 @@ class ScopedSetTrue {
 bool IsScmTimeStampExperimentDisabled() {
   return webrtc::field_trial::IsDisabled("WebRTC-SCM-Timestamp");
 }
+
+#if defined(WEBRTC_POSIX)
+// Reads the ECN codepoint from the TOS or traffic class in `cmsg`, which is
+// there if IP_RECVTOS or IPV6_RECVTCLASS is set. Returns false if `cmsg` holds
+// something else.
+bool ReadEcnFromCmsg(const cmsghdr& cmsg, webrtc::EcnMarking* ecn) {
+  int tos;
+  if (cmsg.cmsg_level == IPPROTO_IP &&
+      (cmsg.cmsg_type == IP_TOS || cmsg.cmsg_type == IP_RECVTOS)) {
+    // The TOS is a single byte.
+    tos = *CMSG_DATA(&cmsg);
+  } else if (cmsg.cmsg_level == IPPROTO_IPV6 &&
+             cmsg.cmsg_type == IPV6_TCLASS) {
+    memcpy(&tos, CMSG_DATA(&cmsg), sizeof(tos));
+  } else {
+    return false;
+  }
+  // The ECN codepoint is the two least significant bits.
+  *ecn = static_cast<webrtc::EcnMarking>(tos & 0x03);
+  return true;
+}
+#endif
 }  // namespace
 
 namespace rtc {
@@ -318,6 +340,10 @@ int PhysicalSocket::GetOption(Option opt, int* value) {
     // unshift DSCP value to get six most significant bits of IP DiffServ field
     *value >>= 2;
 #endif
+  } else if (opt == OPT_SEND_ECN) {
+    // The ECN codepoint is in the two least significant bits of the same
+    // field.
+    *value &= 0x03;
   }
   return ret;
 }
@@ -333,9 +359,16 @@ int PhysicalSocket::SetOption(Option opt, int value) {
 #endif
   } else if (opt == OPT_DSCP) {
 #if defined(WEBRTC_POSIX)
-    // shift DSCP value to fit six most significant bits of IP DiffServ field
-    value <<= 2;
+    // shift DSCP value to fit six most significant bits of IP DiffServ field,
+    // and keep the ECN codepoint in the two least significant bits.
+    dscp_ = value;
+    value = (value << 2) | send_ecn_;
 #endif
+  } else if (opt == OPT_SEND_ECN) {
+    send_ecn_ = value & 0x03;
+    value = (dscp_ << 2) | send_ecn_;
+  } else if (opt == OPT_RECV_ECN) {
+    recv_ecn_ = value != 0;
   }
 #if defined(WEBRTC_POSIX)
   if (sopt == IPV6_TCLASS) {
@@ -343,6 +376,10 @@ int PhysicalSocket::SetOption(Option opt, int value) {
     // Don't bother checking the return code, as this is expected to fail if
     // it's not actually dual-stack.
     ::setsockopt(s_, IPPROTO_IP, IP_TOS, (SockOptArg)&value, sizeof(value));
+  } else if (sopt == IPV6_RECVTCLASS) {
+    // Same as above, for the packets that arrive over IPv4.
+    ::setsockopt(s_, IPPROTO_IP, IP_RECVTOS, (SockOptArg)&value,
+                 sizeof(value));
   }
 #endif
   int result =
@@ -404,8 +441,8 @@ int PhysicalSocket::SendTo(const void* buffer,
 }
 
 int PhysicalSocket::Recv(void* buffer, size_t length, int64_t* timestamp) {
-  int received =
-      DoReadFromSocket(buffer, length, /*out_addr*/ nullptr, timestamp);
+  int received = DoReadFromSocket(buffer, length, /*out_addr*/ nullptr,
+                                  timestamp, /*ecn=*/nullptr);
   if ((received == 0) && (length != 0)) {
     // Note: on graceful shutdown, recv can return 0.  In this case, we
     // pretend it is blocking, and then signal close, so that simplifying
@@ -434,7 +471,16 @@ int PhysicalSocket::RecvFrom(void* buffer,
                              size_t length,
                              SocketAddress* out_addr,
                              int64_t* timestamp) {
-  int received = DoReadFromSocket(buffer, length, out_addr, timestamp);
+  webrtc::EcnMarking ecn;
+  return RecvFromWithEcn(buffer, length, out_addr, timestamp, &ecn);
+}
+
+int PhysicalSocket::RecvFromWithEcn(void* buffer,
+                                    size_t length,
+                                    SocketAddress* out_addr,
+                                    int64_t* timestamp,
+                                    webrtc::EcnMarking* ecn) {
+  int received = DoReadFromSocket(buffer, length, out_addr, timestamp, ecn);
   UpdateLastError();
   int error = GetError();
   bool success = (received >= 0) || IsBlockingError(error);
@@ -450,14 +496,20 @@ int PhysicalSocket::RecvFrom(void* buffer,
 int PhysicalSocket::DoReadFromSocket(void* buffer,
                                      size_t length,
                                      SocketAddress* out_addr,
-                                     int64_t* timestamp) {
+                                     int64_t* timestamp,
+                                     webrtc::EcnMarking* ecn) {
   sockaddr_storage addr_storage;
   socklen_t addr_len = sizeof(addr_storage);
   sockaddr* addr = reinterpret_cast<sockaddr*>(&addr_storage);
+  if (ecn) {
+    *ecn = webrtc::EcnMarking::kNotEct;
+  }
 
 #if defined(WEBRTC_POSIX)
   int received = 0;
-  if (read_scm_timestamp_experiment_) {
+  const bool read_scm_timestamp = timestamp && read_scm_timestamp_experiment_;
+  const bool read_ecn = ecn && recv_ecn_;
+  if (read_scm_timestamp_experiment_ || read_ecn) {
     iovec iov = {.iov_base = buffer, .iov_len = length};
     msghdr msg = {.msg_iov = &iov, .msg_iovlen = 1};
     if (out_addr) {
@@ -465,9 +517,13 @@ int PhysicalSocket::DoReadFromSocket(void* buffer,
       msg.msg_name = addr;
       msg.msg_namelen = addr_len;
     }
-    char control[CMSG_SPACE(sizeof(struct timeval))] = {};
+    // Room for the timestamp and the TOS or traffic class.
+    char control[CMSG_SPACE(sizeof(struct timeval)) +
+                 CMSG_SPACE(sizeof(int))] = {};
     if (timestamp) {
       *timestamp = -1;
+    }
+    if (read_scm_timestamp || read_ecn) {
       msg.msg_control = &control;
       msg.msg_controllen = sizeof(control);
     }
@@ -476,24 +532,28 @@ int PhysicalSocket::DoReadFromSocket(void* buffer,
       // An error occured or shut down.
       return received;
     }
-    if (timestamp) {
+    if (read_scm_timestamp || read_ecn) {
       struct cmsghdr* cmsg;
       for (cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
-        if (cmsg->cmsg_level != SOL_SOCKET)
+        if (read_ecn && ReadEcnFromCmsg(*cmsg, ecn))
+          continue;
+        if (!read_scm_timestamp || cmsg->cmsg_level != SOL_SOCKET)
           continue;
         if (cmsg->cmsg_type == SCM_TIMESTAMP) {
           timeval* ts = reinterpret_cast<timeval*>(CMSG_DATA(cmsg));
           *timestamp =
               rtc::kNumMicrosecsPerSec * static_cast<int64_t>(ts->tv_sec) +
               static_cast<int64_t>(ts->tv_usec);
-          break;
         }
       }
     }
+    if (timestamp && !read_scm_timestamp_experiment_) {
+      *timestamp = GetSocketRecvTimestamp(s_);
+    }
     if (out_addr) {
       SocketAddressFromSockAddrStorage(addr_storage, out_addr);
     }
-  } else {  // !read_scm_timestamp_experiment_
+  } else {  // !read_scm_timestamp_experiment_ && !read_ecn
     if (out_addr) {
       received = ::recvfrom(s_, static_cast<char*>(buffer),
                             static_cast<int>(length), 0, addr, &addr_len);
@@ -676,6 +736,35 @@ int PhysicalSocket::TranslateOption(Option opt, int* slevel, int* sopt) {
 #else
       RTC_LOG(LS_WARNING) << "Socket::OPT_DSCP not supported.";
       return -1;
+#endif
+    case OPT_SEND_ECN:
+#if defined(WEBRTC_POSIX)
+      // The ECN codepoint shares the field with the DSCP.
+      if (family_ == AF_INET6) {
+        *slevel = IPPROTO_IPV6;
+        *sopt = IPV6_TCLASS;
+      } else {
+        *slevel = IPPROTO_IP;
+        *sopt = IP_TOS;
+      }
+      break;
+#else
+      RTC_LOG(LS_WARNING) << "Socket::OPT_SEND_ECN not supported.";
+      return -1;
+#endif
+    case OPT_RECV_ECN:
+#if defined(WEBRTC_POSIX)
+      if (family_ == AF_INET6) {
+        *slevel = IPPROTO_IPV6;
+        *sopt = IPV6_RECVTCLASS;
+      } else {
+        *slevel = IPPROTO_IP;
+        *sopt = IP_RECVTOS;
+      }
+      break;
+#else
+      RTC_LOG(LS_WARNING) << "Socket::OPT_RECV_ECN not supported.";
+      return -1;
 #endif
     case OPT_RTP_SENDTIME_EXTN_ID:
       return -1;  // No logging is necessary as this not a OS socket option.
@@ -186,6 +186,11 @@ class PhysicalSocket : public Socket, public sigslot::has_slots<> {
                size_t length,
                SocketAddress* out_addr,
                int64_t* timestamp) override;
+  int RecvFromWithEcn(void* buffer,
+                      size_t length,
+                      SocketAddress* out_addr,
+                      int64_t* timestamp,
+                      webrtc::EcnMarking* ecn) override;
 
   int Listen(int backlog) override;
   Socket* Accept(SocketAddress* out_addr) override;
@@ -213,10 +218,12 @@ class PhysicalSocket : public Socket, public sigslot::has_slots<> {
                        const struct sockaddr* dest_addr,
                        socklen_t addrlen);
 
+  // `ecn` may be null.
   int DoReadFromSocket(void* buffer,
                        size_t length,
                        SocketAddress* out_addr,
-                       int64_t* timestamp);
+                       int64_t* timestamp,
+                       webrtc::EcnMarking* ecn);
 
   void OnResolveResult(AsyncResolverInterface* resolver);
 
@@ -246,6 +253,10 @@ class PhysicalSocket : public Socket, public sigslot::has_slots<> {
  private:
   const bool read_scm_timestamp_experiment_;
   uint8_t enabled_events_ = 0;
+  // The DSCP and ECN codepoint are set in the same field of the IP header.
+  int dscp_ = 0;
+  int send_ecn_ = 0;
+  bool recv_ecn_ = false;
 };
 
 class SocketDispatcher : public Dispatcher, public PhysicalSocket {
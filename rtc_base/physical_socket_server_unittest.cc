@@ -471,6 +471,15 @@ TEST_F(PhysicalSocketTest, TestSocketRecvTimestampIPv6) {
   SocketTest::TestSocketRecvTimestampIPv6();
 }
 
+TEST_F(PhysicalSocketTest, TestSocketRecvEcnIPv4) {
+  MAYBE_SKIP_IPV4;
+  SocketTest::TestSocketRecvEcnIPv4();
+}
+
+TEST_F(PhysicalSocketTest, TestSocketRecvEcnIPv6) {
+  SocketTest::TestSocketRecvEcnIPv6();
+}
+
 #if !defined(WEBRTC_MAC)
 TEST_F(PhysicalSocketTest, TestSocketRecvTimestampIPv4ScmExperimentDisabled) {
   MAYBE_SKIP_IPV4;
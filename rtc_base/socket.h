@@ -25,6 +25,7 @@
 #include "rtc_base/win32.h"
 #endif
 
+#include "api/transport/ecn_marking.h"
 #include "rtc_base/socket_address.h"
 #include "rtc_base/third_party/sigslot/sigslot.h"
 
@@ -103,6 +104,17 @@ class Socket {
                        size_t cb,
                        SocketAddress* paddr,
                        int64_t* timestamp) = 0;
+  // Like RecvFrom(), and also returns the ECN codepoint of the IP header the
+  // packet arrived in. That is EcnMarking::kNotEct unless OPT_RECV_ECN is set
+  // and the socket supports it.
+  virtual int RecvFromWithEcn(void* pv,
+                              size_t cb,
+                              SocketAddress* paddr,
+                              int64_t* timestamp,
+                              webrtc::EcnMarking* ecn) {
+    *ecn = webrtc::EcnMarking::kNotEct;
+    return RecvFrom(pv, cb, paddr, timestamp);
+  }
   virtual int Listen(int backlog) = 0;
   virtual Socket* Accept(SocketAddress* paddr) = 0;
   virtual int Close() = 0;
@@ -120,6 +132,9 @@ class Socket {
     OPT_NODELAY,               // whether Nagle algorithm is enabled
     OPT_IPV6_V6ONLY,           // Whether the socket is IPv6 only.
     OPT_DSCP,                  // DSCP code
+    OPT_SEND_ECN,              // ECN codepoint of sent packets, an EcnMarking
+    OPT_RECV_ECN,              // Whether RecvFromWithEcn() reports the ECN
+                               // codepoint of received packets.
     OPT_RTP_SENDTIME_EXTN_ID,  // This is a non-traditional socket option param.
                                // This is specific to libjingle and will be used
                                // if SendTime option is needed at socket level.
@@ -20,6 +20,7 @@
 
 #include "absl/memory/memory.h"
 #include "absl/strings/string_view.h"
+#include "api/transport/ecn_marking.h"
 #include "rtc_base/arraysize.h"
 #include "rtc_base/async_packet_socket.h"
 #include "rtc_base/async_udp_socket.h"
@@ -224,6 +225,15 @@ void SocketTest::TestSocketRecvTimestampIPv6() {
   SocketRecvTimestamp(kIPv6Loopback);
 }
 
+void SocketTest::TestSocketRecvEcnIPv4() {
+  SocketRecvEcn(kIPv4Loopback);
+}
+
+void SocketTest::TestSocketRecvEcnIPv6() {
+  MAYBE_SKIP_IPV6;
+  SocketRecvEcn(kIPv6Loopback);
+}
+
 void SocketTest::TestUdpSocketRecvTimestampUseRtcEpochIPv4() {
   UdpSocketRecvTimestampUseRtcEpoch(kIPv4Loopback);
 }
@@ -1115,6 +1125,55 @@ void SocketTest::SocketRecvTimestamp(const IPAddress& loopback) {
   EXPECT_NEAR(system_time_diff, recv_timestamp_diff, 10000);
 }
 
+void SocketTest::SocketRecvEcn(const IPAddress& loopback) {
+  StreamSink sink;
+  std::unique_ptr<Socket> socket(
+      socket_factory_->CreateSocket(loopback.family(), SOCK_DGRAM));
+  EXPECT_EQ(0, socket->Bind(SocketAddress(loopback, 0)));
+  SocketAddress address = socket->GetLocalAddress();
+  sink.Monitor(socket.get());
+  ASSERT_EQ(0, socket->SetOption(Socket::OPT_RECV_ECN, 1));
+  ASSERT_EQ(0, socket->SetOption(Socket::OPT_DSCP, 46));
+  ASSERT_EQ(0, socket->SetOption(
+                   Socket::OPT_SEND_ECN,
+                   static_cast<int>(webrtc::EcnMarking::kEct1)));
+
+  // Setting the ECN codepoint keeps the DSCP, and the other way around.
+  int dscp = 0;
+  ASSERT_EQ(0, socket->GetOption(Socket::OPT_DSCP, &dscp));
+  EXPECT_EQ(46, dscp);
+  int send_ecn = 0;
+  ASSERT_EQ(0, socket->GetOption(Socket::OPT_SEND_ECN, &send_ecn));
+  EXPECT_EQ(static_cast<int>(webrtc::EcnMarking::kEct1), send_ecn);
+
+  socket->SendTo("foo", 3, address);
+  EXPECT_TRUE_WAIT(sink.Check(socket.get(), SSE_READ), kTimeout);
+  char buffer[3];
+  int64_t timestamp;
+  webrtc::EcnMarking ecn = webrtc::EcnMarking::kNotEct;
+  ASSERT_GT(socket->RecvFromWithEcn(buffer, 3, nullptr, &timestamp, &ecn), 0);
+  EXPECT_EQ(ecn, webrtc::EcnMarking::kEct1);
+
+  ASSERT_EQ(0, socket->SetOption(
+                   Socket::OPT_SEND_ECN,
+                   static_cast<int>(webrtc::EcnMarking::kNotEct)));
+  socket->SendTo("bar", 3, address);
+  EXPECT_TRUE_WAIT(sink.Check(socket.get(), SSE_READ), kTimeout);
+  ASSERT_GT(socket->RecvFromWithEcn(buffer, 3, nullptr, &timestamp, &ecn), 0);
+  EXPECT_EQ(ecn, webrtc::EcnMarking::kNotEct);
+
+  // AsyncUDPSocket sends packets that don't ask for a codepoint, like RTCP and
+  // STUN between ECT(1) RTP packets, with the codepoint of the socket.
+  Socket* raw_socket = socket.get();
+  AsyncUDPSocket udp_socket(socket.release());
+  rtc::PacketOptions ect1_options;
+  ect1_options.ecn = webrtc::EcnMarking::kEct1;
+  udp_socket.SendTo("foo", 3, address, ect1_options);
+  udp_socket.SendTo("bar", 3, address, rtc::PacketOptions());
+  ASSERT_EQ(0, raw_socket->GetOption(Socket::OPT_SEND_ECN, &send_ecn));
+  EXPECT_EQ(static_cast<int>(webrtc::EcnMarking::kEct1), send_ecn);
+}
+
 void SocketTest::UdpSocketRecvTimestampUseRtcEpoch(const IPAddress& loopback) {
   SocketAddress empty = EmptySocketAddressWithFamily(loopback.family());
   std::unique_ptr<Socket> socket(
@@ -62,6 +62,8 @@ class SocketTest : public ::testing::Test {
   void TestGetSetOptionsIPv6();
   void TestSocketRecvTimestampIPv4();
   void TestSocketRecvTimestampIPv6();
+  void TestSocketRecvEcnIPv4();
+  void TestSocketRecvEcnIPv6();
   void TestUdpSocketRecvTimestampUseRtcEpochIPv4();
   void TestUdpSocketRecvTimestampUseRtcEpochIPv6();
 
@@ -94,6 +96,7 @@ class SocketTest : public ::testing::Test {
   void UdpReadyToSend(const IPAddress& loopback);
   void GetSetOptionsInternal(const IPAddress& loopback);
   void SocketRecvTimestamp(const IPAddress& loopback);
+  void SocketRecvEcn(const IPAddress& loopback);
   void UdpSocketRecvTimestampUseRtcEpoch(const IPAddress& loopback);
 
   SocketFactory* socket_factory_;
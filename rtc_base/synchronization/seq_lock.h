@@ -0,0 +1,87 @@
+/*
+ *  Copyright 2023 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#ifndef RTC_BASE_SYNCHRONIZATION_SEQ_LOCK_H_
+#define RTC_BASE_SYNCHRONIZATION_SEQ_LOCK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <array>
+#include <atomic>
+#include <type_traits>
+
+#include "rtc_base/synchronization/yield.h"
+
+namespace webrtc {
+
+// Publishes a value written by a single thread to any number of readers,
+// without ever blocking the writer. Readers retry while a write is in
+// progress, so this suits small values that are written often and read
+// comparatively rarely, e.g. counters updated for every received packet and
+// polled for stats.
+//
+// `Store` must not be called concurrently with itself. `Load` is thread-safe.
+template <typename T>
+class SeqLock {
+ public:
+  static_assert(std::is_trivially_copyable<T>::value,
+                "SeqLock copies values byte by byte.");
+
+  SeqLock() : SeqLock(T()) {}
+  explicit SeqLock(const T& value) { Store(value); }
+  SeqLock(const SeqLock&) = delete;
+  SeqLock& operator=(const SeqLock&) = delete;
+
+  void Store(const T& value) {
+    Word words[kNumWords] = {};
+    memcpy(words, &value, sizeof(T));
+    uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+    // An odd sequence number tells readers that a write is in progress.
+    sequence_.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < kNumWords; ++i) {
+      words_[i].store(words[i], std::memory_order_relaxed);
+    }
+    sequence_.store(sequence + 2, std::memory_order_release);
+  }
+
+  T Load() const {
+    Word words[kNumWords];
+    while (true) {
+      uint32_t sequence = sequence_.load(std::memory_order_acquire);
+      if ((sequence & 1) == 0) {
+        for (size_t i = 0; i < kNumWords; ++i) {
+          words[i] = words_[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence_.load(std::memory_order_relaxed) == sequence) {
+          break;
+        }
+      }
+      YieldCurrentThread();
+    }
+    T value;
+    memcpy(&value, words, sizeof(T));
+    return value;
+  }
+
+ private:
+  using Word = uintptr_t;
+  static constexpr size_t kNumWords =
+      (sizeof(T) + sizeof(Word) - 1) / sizeof(Word);
+
+  std::atomic<uint32_t> sequence_{0};
+  std::array<std::atomic<Word>, kNumWords> words_;
+};
+
+}  // namespace webrtc
+
+#endif  // RTC_BASE_SYNCHRONIZATION_SEQ_LOCK_H_
@@ -0,0 +1,87 @@
+/*
+ *  Copyright 2023 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/synchronization/seq_lock.h"
+
+#include <stdint.h>
+
+#include <atomic>
+
+#include "rtc_base/platform_thread.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+// Odd size, to check that values that aren't a multiple of the word size are
+// copied correctly.
+struct Values {
+  int64_t first = 0;
+  int32_t second = 0;
+  uint8_t third = 0;
+};
+
+Values MakeValues(int64_t value) {
+  Values values;
+  values.first = value;
+  values.second = static_cast<int32_t>(value);
+  values.third = static_cast<uint8_t>(value);
+  return values;
+}
+
+TEST(SeqLockTest, LoadsStoredValue) {
+  SeqLock<Values> lock;
+  EXPECT_EQ(lock.Load().first, 0);
+
+  lock.Store(MakeValues(0x1234'5678'9abc));
+  Values values = lock.Load();
+  EXPECT_EQ(values.first, 0x1234'5678'9abc);
+  EXPECT_EQ(values.second, 0x5678'9abc);
+  EXPECT_EQ(values.third, 0xbc);
+}
+
+TEST(SeqLockTest, LoadsInitialValue) {
+  SeqLock<int> lock(42);
+  EXPECT_EQ(lock.Load(), 42);
+}
+
+TEST(SeqLockTest, ReadersNeverSeePartialWrites) {
+  constexpr int64_t kNumWrites = 100'000;
+  SeqLock<Values> lock;
+  std::atomic<bool> done(false);
+  std::atomic<int> torn_reads(0);
+
+  auto reader = [&] {
+    while (!done.load()) {
+      Values values = lock.Load();
+      if (values.second != static_cast<int32_t>(values.first) ||
+          values.third != static_cast<uint8_t>(values.first)) {
+        ++torn_reads;
+      }
+    }
+  };
+  rtc::PlatformThread reader1 =
+      rtc::PlatformThread::SpawnJoinable(reader, "reader1");
+  rtc::PlatformThread reader2 =
+      rtc::PlatformThread::SpawnJoinable(reader, "reader2");
+
+  for (int64_t i = 1; i <= kNumWrites; ++i) {
+    lock.Store(MakeValues(i));
+  }
+  done = true;
+  reader1.Finalize();
+  reader2.Finalize();
+
+  EXPECT_EQ(torn_reads.load(), 0);
+  EXPECT_EQ(lock.Load().first, kNumWrites);
+}
+
+}  // namespace
+}  // namespace webrtc
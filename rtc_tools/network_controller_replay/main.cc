@@ -0,0 +1,236 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/flags/usage.h"
+#include "absl/strings/string_view.h"
+#include "api/transport/goog_cc_factory.h"
+#include "api/transport/network_control.h"
+#include "logging/rtc_event_log/rtc_event_log_parser.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/strings/string_builder.h"
+#include "rtc_tools/network_controller_replay/network_controller_replay.h"
+#include "system_wrappers/include/cpu_info.h"
+#include "system_wrappers/include/field_trial.h"
+
+ABSL_FLAG(std::string,
+          controller,
+          "goog_cc",
+          "The network controller to replay the logs with, one of goog_cc and "
+          "goog_cc_feedback_only.");
+ABSL_FLAG(
+    std::string,
+    force_fieldtrials,
+    "",
+    "Field trials control experimental feature code which can be forced. "
+    "E.g. running with --force_fieldtrials=WebRTC-FooFeature/Enabled/"
+    " will assign the group Enabled to field trial WebRTC-FooFeature. Multiple "
+    "trials are separated by \"/\"");
+ABSL_FLAG(int,
+          threads,
+          0,
+          "Number of logs to replay in parallel. Defaults to the number of "
+          "cores.");
+ABSL_FLAG(std::string,
+          trace_dir,
+          "",
+          "If set, the target rate trace of each log is written to "
+          "<trace_dir>/<log file name>.csv.");
+ABSL_FLAG(bool,
+          parse_unconfigured_header_extensions,
+          true,
+          "Attempt to parse unconfigured header extensions using the default "
+          "WebRTC mapping. This can give very misleading results if the "
+          "application negotiates a different mapping.");
+
+namespace webrtc {
+namespace {
+
+std::unique_ptr<NetworkControllerFactoryInterface> CreateFactory(
+    absl::string_view controller) {
+  if (controller == "goog_cc") {
+    return std::make_unique<GoogCcNetworkControllerFactory>();
+  }
+  if (controller == "goog_cc_feedback_only") {
+    GoogCcFactoryConfig config;
+    config.feedback_only = true;
+    return std::make_unique<GoogCcNetworkControllerFactory>(std::move(config));
+  }
+  return nullptr;
+}
+
+std::string TracePath(absl::string_view trace_dir, absl::string_view log) {
+  const size_t name_start = log.find_last_of("/\\");
+  return std::string(trace_dir) + "/" +
+         std::string(name_start == absl::string_view::npos
+                         ? log
+                         : log.substr(name_start + 1)) +
+         ".csv";
+}
+
+bool WriteTrace(const NetworkControllerReplayResult& result,
+                const std::string& path) {
+  FILE* file = fopen(path.c_str(), "w");
+  if (!file) {
+    return false;
+  }
+  fprintf(file, "time_ms,target_kbps,logged_kbps\n");
+  for (const NetworkControllerReplayResult::Estimate& estimate :
+       result.estimates) {
+    fprintf(file, "%lld,%lld,", static_cast<long long>(estimate.at_time.ms()),
+            static_cast<long long>(estimate.target_rate.kbps()));
+    if (estimate.logged_rate) {
+      fprintf(file, "%lld",
+              static_cast<long long>(estimate.logged_rate->kbps()));
+    }
+    fprintf(file, "\n");
+  }
+  fclose(file);
+  return true;
+}
+
+// Parses and replays one log, returning its line of the summary, or an empty
+// string if the log could not be replayed.
+std::string ReplayLog(const std::string& log,
+                      ParsedRtcEventLog::UnconfiguredHeaderExtensions
+                          header_extensions) {
+  ParsedRtcEventLog parsed_log(header_extensions,
+                               /*allow_incomplete_logs=*/true);
+  ParsedRtcEventLog::ParseStatus status = parsed_log.ParseFile(log);
+  if (!status.ok()) {
+    RTC_LOG(LS_ERROR) << "Failed to parse " << log << ": " << status.message();
+    return "";
+  }
+  NetworkControllerReplayResult result = ReplayNetworkController(
+      parsed_log, CreateFactory(absl::GetFlag(FLAGS_controller)));
+
+  const std::string trace_dir = absl::GetFlag(FLAGS_trace_dir);
+  if (!trace_dir.empty() && !WriteTrace(result, TracePath(trace_dir, log))) {
+    RTC_LOG(LS_ERROR) << "Failed to write trace of " << log;
+  }
+
+  const double cpu_per_update_us =
+      result.num_updates > 0
+          ? result.controller_cpu_time.us<double>() / result.num_updates
+          : 0.0;
+  const double speedup =
+      result.replay_duration > TimeDelta::Zero()
+          ? result.log_duration / result.replay_duration
+          : 0.0;
+  char buffer[1024];
+  rtc::SimpleStringBuilder line(buffer);
+  line << log << "," << result.log_duration.seconds<double>() << ","
+       << result.replay_duration.ms<double>() << "," << speedup << ","
+       << result.num_updates << "," << cpu_per_update_us << ","
+       << result.max_update_cpu_time.us() << ","
+       << static_cast<int64_t>(result.estimates.size()) << ","
+       << result.num_compared_estimates << ","
+       << result.mean_absolute_difference.kbps<double>() << ","
+       << result.mean_relative_difference;
+  return line.str();
+}
+
+}  // namespace
+}  // namespace webrtc
+
+// Replays the sent packets and the feedback in RTC event logs into a network
+// controller, and prints a summary line per log. Each log is replayed on a
+// single thread, several logs at once.
+int main(int argc, char* argv[]) {
+  absl::SetProgramUsageMessage(
+      "A tool for replaying WebRTC event logs into a network controller.\n"
+      "Prints one CSV line per log, with the columns\n"
+      "log,log_duration_s,replay_ms,speedup,updates,cpu_per_update_us,\n"
+      "max_update_cpu_us,estimates,compared_estimates,mean_abs_diff_kbps,\n"
+      "mean_rel_diff\n"
+      "where the differences are between the simulated target rate and the\n"
+      "logged loss based estimate.\n"
+      "\n"
+      "Example usage:\n"
+      "./network_controller_replay --trace_dir=/tmp <log1> <log2> ...\n");
+  std::vector<char*> args = absl::ParseCommandLine(argc, argv);
+  if (args.size() < 2) {
+    std::cerr << absl::ProgramUsageMessage();
+    return 1;
+  }
+  if (!webrtc::CreateFactory(absl::GetFlag(FLAGS_controller))) {
+    std::cerr << "Unknown controller " << absl::GetFlag(FLAGS_controller)
+              << std::endl;
+    return 1;
+  }
+
+  // Print RTC_LOG warnings and errors even in release builds.
+  if (rtc::LogMessage::GetLogToDebug() > rtc::LS_WARNING) {
+    rtc::LogMessage::LogToDebug(rtc::LS_WARNING);
+  }
+  rtc::LogMessage::SetLogToStderr(true);
+
+  // InitFieldTrialsFromString stores the char*, so the char array must outlive
+  // the application.
+  const std::string field_trials = absl::GetFlag(FLAGS_force_fieldtrials);
+  webrtc::field_trial::InitFieldTrialsFromString(field_trials.c_str());
+
+  webrtc::ParsedRtcEventLog::UnconfiguredHeaderExtensions header_extensions =
+      webrtc::ParsedRtcEventLog::UnconfiguredHeaderExtensions::kDontParse;
+  if (absl::GetFlag(FLAGS_parse_unconfigured_header_extensions)) {
+    header_extensions = webrtc::ParsedRtcEventLog::
+        UnconfiguredHeaderExtensions::kAttemptWebrtcDefaultConfig;
+  }
+
+  const std::vector<std::string> logs(args.begin() + 1, args.end());
+  int num_threads = absl::GetFlag(FLAGS_threads);
+  if (num_threads <= 0) {
+    num_threads = webrtc::CpuInfo::DetectNumberOfCores();
+  }
+  num_threads = std::min<int>(num_threads, logs.size());
+
+  // The workers take the next log to replay until all are done.
+  std::vector<std::string> summary(logs.size());
+  std::atomic<size_t> next_log(0);
+  std::vector<rtc::PlatformThread> workers;
+  for (int i = 0; i < num_threads; ++i) {
+    workers.push_back(rtc::PlatformThread::SpawnJoinable(
+        [&] {
+          for (size_t log = next_log++; log < logs.size(); log = next_log++) {
+            summary[log] = webrtc::ReplayLog(logs[log], header_extensions);
+          }
+        },
+        "replay_worker"));
+  }
+  for (rtc::PlatformThread& worker : workers) {
+    worker.Finalize();
+  }
+
+  bool success = true;
+  printf(
+      "log,log_duration_s,replay_ms,speedup,updates,cpu_per_update_us,"
+      "max_update_cpu_us,estimates,compared_estimates,mean_abs_diff_kbps,"
+      "mean_rel_diff\n");
+  for (const std::string& line : summary) {
+    if (line.empty()) {
+      success = false;
+      continue;
+    }
+    printf("%s\n", line.c_str());
+  }
+  return success ? 0 : 1;
+}
@@ -0,0 +1,206 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_tools/network_controller_replay/network_controller_replay.h"
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/cpu_time.h"
+#include "rtc_base/time_utils.h"
+#include "rtc_tools/rtc_event_log_visualizer/log_simulation.h"
+
+namespace webrtc {
+namespace {
+
+struct UpdateCpuTime {
+  int64_t num_updates = 0;
+  int64_t total_ns = 0;
+  int64_t max_ns = 0;
+};
+
+// Forwards all calls to `controller`, measuring the thread CPU time they take.
+class TimedNetworkController : public NetworkControllerInterface {
+ public:
+  TimedNetworkController(std::unique_ptr<NetworkControllerInterface> controller,
+                         UpdateCpuTime& cpu_time)
+      : controller_(std::move(controller)), cpu_time_(cpu_time) {}
+
+  NetworkControlUpdate OnNetworkAvailability(NetworkAvailability msg) override {
+    return Call(&NetworkControllerInterface::OnNetworkAvailability, msg);
+  }
+  NetworkControlUpdate OnNetworkRouteChange(NetworkRouteChange msg) override {
+    return Call(&NetworkControllerInterface::OnNetworkRouteChange, msg);
+  }
+  NetworkControlUpdate OnProcessInterval(ProcessInterval msg) override {
+    return Call(&NetworkControllerInterface::OnProcessInterval, msg);
+  }
+  NetworkControlUpdate OnRemoteBitrateReport(RemoteBitrateReport msg) override {
+    return Call(&NetworkControllerInterface::OnRemoteBitrateReport, msg);
+  }
+  NetworkControlUpdate OnRoundTripTimeUpdate(RoundTripTimeUpdate msg) override {
+    return Call(&NetworkControllerInterface::OnRoundTripTimeUpdate, msg);
+  }
+  NetworkControlUpdate OnSentPacket(SentPacket msg) override {
+    return Call(&NetworkControllerInterface::OnSentPacket, msg);
+  }
+  NetworkControlUpdate OnReceivedPacket(ReceivedPacket msg) override {
+    return Call(&NetworkControllerInterface::OnReceivedPacket, msg);
+  }
+  NetworkControlUpdate OnStreamsConfig(StreamsConfig msg) override {
+    return Call(&NetworkControllerInterface::OnStreamsConfig, msg);
+  }
+  NetworkControlUpdate OnTargetRateConstraints(
+      TargetRateConstraints msg) override {
+    return Call(&NetworkControllerInterface::OnTargetRateConstraints, msg);
+  }
+  NetworkControlUpdate OnTransportLossReport(TransportLossReport msg) override {
+    return Call(&NetworkControllerInterface::OnTransportLossReport, msg);
+  }
+  NetworkControlUpdate OnTransportPacketsFeedback(
+      TransportPacketsFeedback msg) override {
+    return Call(&NetworkControllerInterface::OnTransportPacketsFeedback,
+                std::move(msg));
+  }
+  NetworkControlUpdate OnNetworkStateEstimate(
+      NetworkStateEstimate msg) override {
+    return Call(&NetworkControllerInterface::OnNetworkStateEstimate, msg);
+  }
+
+ private:
+  template <typename Message>
+  NetworkControlUpdate Call(
+      NetworkControlUpdate (NetworkControllerInterface::*method)(Message),
+      Message msg) {
+    const int64_t start_ns = rtc::GetThreadCpuTimeNanos();
+    NetworkControlUpdate update = (*controller_.*method)(std::move(msg));
+    const int64_t elapsed_ns = rtc::GetThreadCpuTimeNanos() - start_ns;
+    ++cpu_time_.num_updates;
+    cpu_time_.total_ns += elapsed_ns;
+    cpu_time_.max_ns = std::max(cpu_time_.max_ns, elapsed_ns);
+    return update;
+  }
+
+  const std::unique_ptr<NetworkControllerInterface> controller_;
+  UpdateCpuTime& cpu_time_;
+};
+
+class TimedNetworkControllerFactory : public NetworkControllerFactoryInterface {
+ public:
+  TimedNetworkControllerFactory(
+      std::unique_ptr<NetworkControllerFactoryInterface> factory,
+      UpdateCpuTime& cpu_time)
+      : factory_(std::move(factory)), cpu_time_(cpu_time) {}
+
+  std::unique_ptr<NetworkControllerInterface> Create(
+      NetworkControllerConfig config) override {
+    return std::make_unique<TimedNetworkController>(factory_->Create(config),
+                                                    cpu_time_);
+  }
+  TimeDelta GetProcessInterval() const override {
+    return factory_->GetProcessInterval();
+  }
+
+ private:
+  const std::unique_ptr<NetworkControllerFactoryInterface> factory_;
+  UpdateCpuTime& cpu_time_;
+};
+
+TimeDelta NanosToTimeDelta(int64_t ns) {
+  return TimeDelta::Micros(ns / rtc::kNumNanosecsPerMicrosec);
+}
+
+// Annotates `result.estimates` with the logged loss based estimates, which are
+// capped by the delay based ones, and compares the two.
+void CompareWithLoggedEstimates(const ParsedRtcEventLog& parsed_log,
+                                NetworkControllerReplayResult& result) {
+  const std::vector<LoggedBweLossBasedUpdate>& logged =
+      parsed_log.bwe_loss_updates();
+  auto logged_it = logged.begin();
+  for (NetworkControllerReplayResult::Estimate& estimate : result.estimates) {
+    while (logged_it != logged.end() &&
+           logged_it->log_time() <= estimate.at_time) {
+      ++logged_it;
+    }
+    if (logged_it != logged.begin()) {
+      estimate.logged_rate =
+          DataRate::BitsPerSec(std::prev(logged_it)->bitrate_bps);
+    }
+  }
+
+  auto simulated_it = result.estimates.begin();
+  int64_t sum_absolute_difference_bps = 0;
+  double sum_relative_difference = 0.0;
+  for (const LoggedBweLossBasedUpdate& update : logged) {
+    while (simulated_it != result.estimates.end() &&
+           simulated_it->at_time <= update.log_time()) {
+      ++simulated_it;
+    }
+    if (simulated_it == result.estimates.begin() || update.bitrate_bps <= 0) {
+      continue;
+    }
+    const int64_t difference_bps =
+        std::prev(simulated_it)->target_rate.bps() - update.bitrate_bps;
+    sum_absolute_difference_bps += std::abs(difference_bps);
+    sum_relative_difference +=
+        static_cast<double>(std::abs(difference_bps)) / update.bitrate_bps;
+    ++result.num_compared_estimates;
+  }
+  if (result.num_compared_estimates > 0) {
+    result.mean_absolute_difference = DataRate::BitsPerSec(
+        sum_absolute_difference_bps / result.num_compared_estimates);
+    result.mean_relative_difference =
+        sum_relative_difference / result.num_compared_estimates;
+  }
+}
+
+}  // namespace
+
+NetworkControllerReplayResult ReplayNetworkController(
+    const ParsedRtcEventLog& parsed_log,
+    std::unique_ptr<NetworkControllerFactoryInterface> factory) {
+  RTC_DCHECK(factory);
+  NetworkControllerReplayResult result;
+  UpdateCpuTime cpu_time;
+  LogBasedNetworkControllerSimulation simulation(
+      std::make_unique<TimedNetworkControllerFactory>(std::move(factory),
+                                                      cpu_time),
+      [&](const NetworkControlUpdate& update, Timestamp at_time) {
+        if (!update.target_rate) {
+          return;
+        }
+        const DataRate target_rate = update.target_rate->target_rate;
+        if (result.estimates.empty() ||
+            result.estimates.back().target_rate != target_rate) {
+          result.estimates.push_back(
+              {.at_time = at_time, .target_rate = target_rate});
+        }
+      });
+
+  const int64_t start_us = rtc::TimeMicros();
+  simulation.ProcessEventsInLog(parsed_log);
+  result.replay_duration = TimeDelta::Micros(rtc::TimeMicros() - start_us);
+  if (parsed_log.last_timestamp() > parsed_log.first_timestamp()) {
+    result.log_duration =
+        parsed_log.last_timestamp() - parsed_log.first_timestamp();
+  }
+
+  result.num_updates = cpu_time.num_updates;
+  result.controller_cpu_time = NanosToTimeDelta(cpu_time.total_ns);
+  result.max_update_cpu_time = NanosToTimeDelta(cpu_time.max_ns);
+  CompareWithLoggedEstimates(parsed_log, result);
+  return result;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,68 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_TOOLS_NETWORK_CONTROLLER_REPLAY_NETWORK_CONTROLLER_REPLAY_H_
+#define RTC_TOOLS_NETWORK_CONTROLLER_REPLAY_NETWORK_CONTROLLER_REPLAY_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "api/transport/network_control.h"
+#include "api/units/data_rate.h"
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "logging/rtc_event_log/rtc_event_log_parser.h"
+
+namespace webrtc {
+
+struct NetworkControllerReplayResult {
+  struct Estimate {
+    // Log time at which the simulated controller changed its target rate.
+    Timestamp at_time = Timestamp::MinusInfinity();
+    DataRate target_rate = DataRate::Zero();
+    // The latest estimate logged by the recorded call at `at_time`, if any.
+    absl::optional<DataRate> logged_rate;
+  };
+
+  // Target rate trace of the simulated controller.
+  std::vector<Estimate> estimates;
+
+  // Span of the log that was replayed, and the wall time the replay took.
+  TimeDelta log_duration = TimeDelta::Zero();
+  TimeDelta replay_duration = TimeDelta::Zero();
+
+  // Number of calls into the network controller, and the thread CPU time
+  // spent in them.
+  int64_t num_updates = 0;
+  TimeDelta controller_cpu_time = TimeDelta::Zero();
+  TimeDelta max_update_cpu_time = TimeDelta::Zero();
+
+  // Difference between the simulated target rate and the logged loss based
+  // estimate, sampled at every logged estimate after the first simulated
+  // one. The relative difference is relative to the logged estimate.
+  int num_compared_estimates = 0;
+  DataRate mean_absolute_difference = DataRate::Zero();
+  double mean_relative_difference = 0.0;
+};
+
+// Replays the outgoing packets, transport feedback and receiver reports in
+// `parsed_log` into a network controller created by `factory`, as fast as
+// possible, with the log time as the clock of the controller. Safe to call
+// from several threads at once with separate factories.
+NetworkControllerReplayResult ReplayNetworkController(
+    const ParsedRtcEventLog& parsed_log,
+    std::unique_ptr<NetworkControllerFactoryInterface> factory);
+
+}  // namespace webrtc
+
+#endif  // RTC_TOOLS_NETWORK_CONTROLLER_REPLAY_NETWORK_CONTROLLER_REPLAY_H_
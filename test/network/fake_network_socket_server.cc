@@ -18,6 +18,7 @@
 #include "absl/algorithm/container.h"
 #include "api/scoped_refptr.h"
 #include "api/task_queue/pending_task_safety_flag.h"
+#include "api/transport/ecn_marking.h"
 #include "rtc_base/event.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/thread.h"
@@ -57,6 +58,11 @@ class FakeNetworkSocket : public rtc::Socket,
                size_t cb,
                rtc::SocketAddress* paddr,
                int64_t* timestamp) override;
+  int RecvFromWithEcn(void* pv,
+                      size_t cb,
+                      rtc::SocketAddress* paddr,
+                      int64_t* timestamp,
+                      EcnMarking* ecn) override;
   int Listen(int backlog) override;
   rtc::Socket* Accept(rtc::SocketAddress* paddr) override;
   int GetError() const override;
@@ -175,7 +181,13 @@ int FakeNetworkSocket::SendTo(const void* pv,
     return -1;
   }
   rtc::CopyOnWriteBuffer packet(static_cast<const uint8_t*>(pv), cb);
-  endpoint_->SendPacket(local_addr_, addr, packet);
+  EcnMarking ecn = EcnMarking::kNotEct;
+  auto it = options_map_.find(OPT_SEND_ECN);
+  if (it != options_map_.end()) {
+    ecn = static_cast<EcnMarking>(it->second);
+  }
+  endpoint_->SendPacket(local_addr_, addr, packet,
+                        /*application_overhead=*/0, ecn);
   return cb;
 }
 
@@ -184,12 +196,21 @@ int FakeNetworkSocket::Recv(void* pv, size_t cb, int64_t* timestamp) {
   return RecvFrom(pv, cb, &paddr, timestamp);
 }
 
-// Reads 1 packet from internal queue. Reads up to `cb` bytes into `pv`
-// and returns the length of received packet.
 int FakeNetworkSocket::RecvFrom(void* pv,
                                 size_t cb,
                                 rtc::SocketAddress* paddr,
                                 int64_t* timestamp) {
+  EcnMarking ecn;
+  return RecvFromWithEcn(pv, cb, paddr, timestamp, &ecn);
+}
+
+// Reads 1 packet from internal queue. Reads up to `cb` bytes into `pv`
+// and returns the length of received packet.
+int FakeNetworkSocket::RecvFromWithEcn(void* pv,
+                                       size_t cb,
+                                       rtc::SocketAddress* paddr,
+                                       int64_t* timestamp,
+                                       EcnMarking* ecn) {
   RTC_DCHECK_RUN_ON(thread_);
 
   if (timestamp) {
@@ -201,6 +222,10 @@ int FakeNetworkSocket::RecvFrom(void* pv,
   size_t data_read = std::min(cb, pending_->size());
   memcpy(pv, pending_->cdata(), data_read);
   *timestamp = pending_->arrival_time.us();
+  // Like a real socket, only reports the ECN codepoint if asked to.
+  auto it = options_map_.find(OPT_RECV_ECN);
+  *ecn = it != options_map_.end() && it->second ? pending_->ecn
+                                                 : EcnMarking::kNotEct;
 
   // According to RECV(2) Linux Man page
   // real socket will discard data, that won't fit into provided buffer,
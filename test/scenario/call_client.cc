@@ -318,6 +318,7 @@ void CallClient::OnPacketReceived(EmulatedIpPacket packet) {
                                                  : video_extensions_;
       RtpPacketReceived received_packet(&extension_map, packet.arrival_time);
       RTC_CHECK(received_packet.Parse(packet.data));
+      received_packet.set_ecn(packet.ecn);
       call_->Receiver()->DeliverRtpPacket(media_type, received_packet,
                                           /*undemuxable_packet_handler=*/
                                           [](const RtpPacketReceived& packet) {
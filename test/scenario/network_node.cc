@@ -31,6 +31,9 @@ SimulatedNetwork::Config CreateSimulationConfig(
   sim_config.packet_overhead = config.packet_overhead.bytes<int>();
   sim_config.queue_length_packets =
       config.packet_queue_length_limit.value_or(0);
+  if (config.ecn_marking_threshold) {
+    sim_config.ecn_marking_threshold_ms = config.ecn_marking_threshold->ms();
+  }
   return sim_config;
 }
 }  // namespace
@@ -88,8 +91,14 @@ bool NetworkNodeTransport::SendRtp(rtc::ArrayView<const uint8_t> packet,
   if (!endpoint_)
     return false;
   rtc::CopyOnWriteBuffer buffer(packet);
+  if (options.send_on_secondary_route && secondary_endpoint_) {
+    secondary_endpoint_->SendPacket(secondary_local_address_,
+                                    secondary_remote_address_, buffer,
+                                    packet_overhead_.bytes(), options.ecn);
+    return true;
+  }
   endpoint_->SendPacket(local_address_, remote_address_, buffer,
-                        packet_overhead_.bytes());
+                        packet_overhead_.bytes(), options.ecn);
   return true;
 }
 
@@ -124,9 +133,40 @@ void NetworkNodeTransport::Connect(EmulatedEndpoint* endpoint,
     local_address_ = rtc::SocketAddress(endpoint_->GetPeerLocalAddress(), 0);
     remote_address_ = receiver_address;
     packet_overhead_ = packet_overhead;
+    // Changing the primary route keeps the secondary one.
+    route.secondary_connected = current_network_route_.secondary_connected;
+    route.secondary_local = current_network_route_.secondary_local;
+    route.secondary_remote = current_network_route_.secondary_remote;
     current_network_route_ = route;
   }
+  OnNetworkRouteChanged(route);
+}
+
+void NetworkNodeTransport::ConnectSecondaryRoute(
+    EmulatedEndpoint* endpoint,
+    const rtc::SocketAddress& receiver_address) {
+  // Only IPv4 address is supported.
+  RTC_CHECK_EQ(receiver_address.family(), AF_INET);
+  rtc::NetworkRoute route;
+  {
+    MutexLock lock(&mutex_);
+    secondary_endpoint_ = endpoint;
+    secondary_local_address_ =
+        rtc::SocketAddress(secondary_endpoint_->GetPeerLocalAddress(), 0);
+    secondary_remote_address_ = receiver_address;
+    current_network_route_.secondary_connected = true;
+    current_network_route_.secondary_local =
+        rtc::RouteEndpoint::CreateWithNetworkId(static_cast<uint16_t>(
+            receiver_address.ipaddr().v4AddressAsHostOrderInteger()));
+    current_network_route_.secondary_remote =
+        current_network_route_.secondary_local;
+    route = current_network_route_;
+  }
+  OnNetworkRouteChanged(route);
+}
 
+void NetworkNodeTransport::OnNetworkRouteChanged(
+    const rtc::NetworkRoute& route) {
   // Must be called from the worker thread.
   rtc::Event event;
   auto cleanup = absl::MakeCleanup([&event] { event.Set(); });
@@ -150,6 +190,7 @@ void NetworkNodeTransport::Disconnect() {
       kDummyTransportName, current_network_route_);
   current_network_route_ = {};
   endpoint_ = nullptr;
+  secondary_endpoint_ = nullptr;
 }
 
 }  // namespace test
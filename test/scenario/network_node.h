@@ -60,6 +60,11 @@ class NetworkNodeTransport : public Transport {
   void Connect(EmulatedEndpoint* endpoint,
                const rtc::SocketAddress& receiver_address,
                DataSize packet_overhead);
+  // Reports a secondary route to the send side of the call, and sends the RTP
+  // packets with PacketOptions::send_on_secondary_route set via `endpoint`
+  // rather than the endpoint given to Connect().
+  void ConnectSecondaryRoute(EmulatedEndpoint* endpoint,
+                             const rtc::SocketAddress& receiver_address);
   void Disconnect();
 
   DataSize packet_overhead() {
@@ -68,6 +73,9 @@ class NetworkNodeTransport : public Transport {
   }
 
  private:
+  // Reports `route` to the send side of the call, on its worker thread.
+  void OnNetworkRouteChanged(const rtc::NetworkRoute& route);
+
   Mutex mutex_;
   Clock* const sender_clock_;
   Call* const sender_call_;
@@ -76,6 +84,9 @@ class NetworkNodeTransport : public Transport {
   rtc::SocketAddress remote_address_ RTC_GUARDED_BY(mutex_);
   DataSize packet_overhead_ RTC_GUARDED_BY(mutex_) = DataSize::Zero();
   rtc::NetworkRoute current_network_route_ RTC_GUARDED_BY(mutex_);
+  EmulatedEndpoint* secondary_endpoint_ RTC_GUARDED_BY(mutex_) = nullptr;
+  rtc::SocketAddress secondary_local_address_ RTC_GUARDED_BY(mutex_);
+  rtc::SocketAddress secondary_remote_address_ RTC_GUARDED_BY(mutex_);
 };
 }  // namespace test
 }  // namespace webrtc
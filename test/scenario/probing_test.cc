@@ -7,11 +7,129 @@
  *  in the file PATENTS.  All contributing project authors may
  *  be found in the AUTHORS file in the root of the source tree.
  */
+#include <stdint.h>
+
+#include <cmath>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "api/test/metrics/global_metrics_logger_and_exporter.h"
+#include "api/test/metrics/metric.h"
+#include "api/transport/goog_cc_factory.h"
+#include "api/transport/network_control.h"
+#include "api/transport/network_types.h"
+#include "rtc_base/cpu_time.h"
+#include "test/field_trial.h"
 #include "test/gtest.h"
 #include "test/scenario/scenario.h"
 
 namespace webrtc {
 namespace test {
+namespace {
+
+// Records the probe packets that are reported to GoogCC, by cluster id.
+class ProbeRecordingController : public NetworkControleUpdateCache {
+ public:
+  ProbeRecordingController(
+      std::unique_ptr<NetworkControllerInterface> controller,
+      std::map<int, std::vector<SentPacket>>* probes)
+      : NetworkControleUpdateCache(std::move(controller)), probes_(probes) {}
+
+  NetworkControlUpdate OnSentPacket(SentPacket msg) override {
+    if (msg.pacing_info.probe_cluster_id != PacedPacketInfo::kNotAProbe) {
+      (*probes_)[msg.pacing_info.probe_cluster_id].push_back(msg);
+    }
+    return NetworkControleUpdateCache::OnSentPacket(msg);
+  }
+
+ private:
+  std::map<int, std::vector<SentPacket>>* const probes_;
+};
+
+class ProbeRecordingControllerFactory
+    : public NetworkControllerFactoryInterface {
+ public:
+  std::unique_ptr<NetworkControllerInterface> Create(
+      NetworkControllerConfig config) override {
+    return std::make_unique<ProbeRecordingController>(
+        goog_cc_factory_.Create(config), &probes_);
+  }
+  TimeDelta GetProcessInterval() const override {
+    return goog_cc_factory_.GetProcessInterval();
+  }
+
+  const std::map<int, std::vector<SentPacket>>& probes() const {
+    return probes_;
+  }
+
+ private:
+  GoogCcNetworkControllerFactory goog_cc_factory_;
+  std::map<int, std::vector<SentPacket>> probes_;
+};
+
+// Returns the mean relative error of the send rate of the probe clusters,
+// measured like the receiving side does, from the first to the last packet.
+double MeanProbeRateError(
+    const std::map<int, std::vector<SentPacket>>& probes) {
+  double error_sum = 0;
+  int clusters = 0;
+  for (const auto& [id, packets] : probes) {
+    if (packets.size() < 2) {
+      continue;
+    }
+    DataSize size = DataSize::Zero();
+    for (size_t i = 0; i + 1 < packets.size(); ++i) {
+      size += packets[i].size;
+    }
+    const TimeDelta duration =
+        packets.back().send_time - packets.front().send_time;
+    if (duration <= TimeDelta::Zero()) {
+      continue;
+    }
+    const DataRate target =
+        DataRate::BitsPerSec(packets.front().pacing_info.send_bitrate_bps);
+    error_sum += std::abs(size / duration / target - 1.0);
+    ++clusters;
+  }
+  return clusters > 0 ? error_sum / clusters : 1.0;
+}
+
+struct ProbingResult {
+  double mean_rate_error;
+  int64_t cpu_time_us;
+};
+
+// Runs initial probing and mid call probing triggered by a raised max bitrate.
+ProbingResult RunProbingScenario() {
+  ProbeRecordingControllerFactory cc_factory;
+  Scenario s;
+  CallClientConfig send_config;
+  send_config.transport.cc_factory = &cc_factory;
+  send_config.transport.rates.max_rate = DataRate::KilobitsPerSec(300);
+  auto* caller = s.CreateClient("caller", send_config);
+  auto* callee = s.CreateClient("callee", CallClientConfig());
+  NetworkSimulationConfig good_network;
+  good_network.bandwidth = DataRate::KilobitsPerSec(5000);
+  auto route =
+      s.CreateRoutes(caller, {s.CreateSimulationNode(good_network)}, callee,
+                     {s.CreateSimulationNode(NetworkSimulationConfig())});
+  s.CreateVideoStream(route->forward(), VideoStreamConfig());
+
+  const int64_t cpu_time_start = rtc::GetProcessCpuTimeNanos();
+  s.RunFor(TimeDelta::Seconds(2));
+  BitrateConstraints bitrate_config;
+  bitrate_config.max_bitrate_bps = DataRate::KilobitsPerSec(3000).bps();
+  caller->UpdateBitrateConstraints(bitrate_config);
+  s.RunFor(TimeDelta::Seconds(2));
+  const int64_t cpu_time_end = rtc::GetProcessCpuTimeNanos();
+
+  return {.mean_rate_error = MeanProbeRateError(cc_factory.probes()),
+          .cpu_time_us = (cpu_time_end - cpu_time_start) / 1000};
+}
+
+}  // namespace
 
 TEST(ProbingTest, InitialProbingRampsUpTargetRateWhenNetworkIsGood) {
   Scenario s;
@@ -131,5 +249,28 @@ TEST(ProbingTest, ProbesRampsUpWhenVideoEncoderConfigChanges) {
             kHdRate);
 }
 
+TEST(ProbingTest, PrecomputedProbeScheduleKeepsProbeRate) {
+  const ProbingResult default_probing = RunProbingScenario();
+  ScopedFieldTrials trial(
+      "WebRTC-Bwe-ProbingBehavior/precomputed_schedule:true/");
+  const ProbingResult scheduled_probing = RunProbingScenario();
+
+  EXPECT_LT(scheduled_probing.mean_rate_error, 0.2);
+  GetGlobalMetricsLogger()->LogSingleValueMetric(
+      "probe_rate_error", "default", 100 * default_probing.mean_rate_error,
+      Unit::kPercent, ImprovementDirection::kSmallerIsBetter);
+  GetGlobalMetricsLogger()->LogSingleValueMetric(
+      "probe_rate_error", "precomputed_schedule",
+      100 * scheduled_probing.mean_rate_error, Unit::kPercent,
+      ImprovementDirection::kSmallerIsBetter);
+  GetGlobalMetricsLogger()->LogSingleValueMetric(
+      "probing_cpu_time", "default", default_probing.cpu_time_us / 1000.0,
+      Unit::kMilliseconds, ImprovementDirection::kSmallerIsBetter);
+  GetGlobalMetricsLogger()->LogSingleValueMetric(
+      "probing_cpu_time", "precomputed_schedule",
+      scheduled_probing.cpu_time_us / 1000.0, Unit::kMilliseconds,
+      ImprovementDirection::kSmallerIsBetter);
+}
+
 }  // namespace test
 }  // namespace webrtc
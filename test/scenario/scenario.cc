@@ -167,6 +167,14 @@ void Scenario::ChangeRoute(std::pair<CallClient*, CallClient*> clients,
   clients.first->transport_->Connect(route->from, addr, overhead);
 }
 
+void Scenario::AddSecondaryRoute(std::pair<CallClient*, CallClient*> clients,
+                                 std::vector<EmulatedNetworkNode*> over_nodes) {
+  EmulatedRoute* route = network_manager_.CreateRoute(over_nodes);
+  uint16_t port = clients.second->Bind(route->to);
+  auto addr = rtc::SocketAddress(route->to->GetPeerLocalAddress(), port);
+  clients.first->transport_->ConnectSecondaryRoute(route->from, addr);
+}
+
 EmulatedNetworkNode* Scenario::CreateSimulationNode(
     std::function<void(NetworkSimulationConfig*)> config_modifier) {
   NetworkSimulationConfig config;
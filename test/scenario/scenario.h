@@ -88,6 +88,12 @@ class Scenario {
                    std::vector<EmulatedNetworkNode*> over_nodes,
                    DataSize overhead);
 
+  // Adds a second route from `clients.first` to `clients.second`, and reports
+  // it as the secondary route of the transport. It carries the packets that
+  // the pacer schedules on the secondary route.
+  void AddSecondaryRoute(std::pair<CallClient*, CallClient*> clients,
+                         std::vector<EmulatedNetworkNode*> over_nodes);
+
   VideoStreamPair* CreateVideoStream(
       std::pair<CallClient*, CallClient*> clients,
       std::function<void(VideoStreamConfig*)> config_modifier);
@@ -224,6 +224,8 @@ struct NetworkSimulationConfig {
   double loss_rate = 0;
   absl::optional<int> packet_queue_length_limit;
   DataSize packet_overhead = DataSize::Zero();
+  // ECN capable packets that queue for longer than this are marked CE.
+  absl::optional<TimeDelta> ecn_marking_threshold;
 };
 }  // namespace test
 }  // namespace webrtc
@@ -0,0 +1,100 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#include <stdint.h>
+
+#include "absl/types/optional.h"
+#include "modules/rtp_rtcp/include/rtcp_statistics.h"
+#include "test/gtest.h"
+#include "test/scenario/scenario.h"
+
+namespace webrtc {
+namespace test {
+namespace {
+
+NetworkSimulationConfig LossyNetwork() {
+  NetworkSimulationConfig config;
+  config.bandwidth = DataRate::KilobitsPerSec(1000);
+  config.delay = TimeDelta::Millis(50);
+  config.loss_rate = 0.2;
+  return config;
+}
+
+NetworkSimulationConfig GoodNetwork() {
+  NetworkSimulationConfig config;
+  config.bandwidth = DataRate::KilobitsPerSec(1000);
+  config.delay = TimeDelta::Millis(50);
+  return config;
+}
+
+// Sends video over a lossy primary route, with a secondary route over
+// `secondary_network` if set. Returns the NACK statistics of the sender.
+RtcpPacketTypeCounter RunVideoOverLossyRoute(
+    absl::optional<NetworkSimulationConfig> secondary_network) {
+  Scenario s;
+  auto* caller = s.CreateClient("caller", CallClientConfig());
+  auto* callee = s.CreateClient("callee", CallClientConfig());
+  auto route = s.CreateRoutes(caller, {s.CreateSimulationNode(LossyNetwork())},
+                              callee, {s.CreateSimulationNode(GoodNetwork())});
+  if (secondary_network) {
+    s.AddSecondaryRoute(route->forward(),
+                        {s.CreateSimulationNode(*secondary_network)});
+  }
+  // NACK retransmissions are enabled by default.
+  auto video = s.CreateVideoStream(route->forward(), VideoStreamConfig());
+  s.RunFor(TimeDelta::Seconds(10));
+
+  RtcpPacketTypeCounter nacks;
+  VideoSendStream::Stats stats;
+  caller->SendTask([&]() { stats = video->send()->GetStats(); });
+  for (const auto& substream : stats.substreams) {
+    nacks.Add(substream.second.rtcp_packet_type_counts);
+  }
+  return nacks;
+}
+
+}  // namespace
+
+TEST(SecondaryRouteTest, RetransmissionsOnGoodSecondaryRouteAreNotLost) {
+  // Without a secondary route, the retransmissions are lost as often as the
+  // media packets and the receiver has to request them again.
+  const RtcpPacketTypeCounter single_route =
+      RunVideoOverLossyRoute(absl::nullopt);
+  const RtcpPacketTypeCounter dual_route =
+      RunVideoOverLossyRoute(GoodNetwork());
+
+  ASSERT_GT(single_route.unique_nack_requests, 0u);
+  ASSERT_GT(dual_route.unique_nack_requests, 0u);
+  EXPECT_LT(dual_route.nack_requests - dual_route.unique_nack_requests,
+            single_route.nack_requests - single_route.unique_nack_requests);
+}
+
+TEST(SecondaryRouteTest, MediaStaysOnPrimaryRoute) {
+  Scenario s;
+  auto* caller = s.CreateClient("caller", CallClientConfig());
+  auto* callee = s.CreateClient("callee", CallClientConfig());
+  auto route = s.CreateRoutes(caller, {s.CreateSimulationNode(GoodNetwork())},
+                              callee, {s.CreateSimulationNode(GoodNetwork())});
+  // Nothing gets through the secondary route, which only carries
+  // retransmissions and FEC.
+  s.AddSecondaryRoute(route->forward(),
+                      {s.CreateSimulationNode([](NetworkSimulationConfig* c) {
+                        c->loss_rate = 1.0;
+                      })});
+  auto video = s.CreateVideoStream(route->forward(), VideoStreamConfig());
+  s.RunFor(TimeDelta::Seconds(5));
+
+  VideoReceiveStreamInterface::Stats stats;
+  callee->SendTask([&]() { stats = video->receive()->GetStats(); });
+  // The default stream sends 30 frames per second.
+  EXPECT_GT(stats.frames_decoded, 100u);
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -103,10 +103,15 @@ void DecodeSynchronizer::SynchronizedFrameDecodeScheduler::Stop() {
   sync_->RemoveFrameScheduler(this);
 }
 
-DecodeSynchronizer::DecodeSynchronizer(Clock* clock,
-                                       Metronome* metronome,
-                                       TaskQueueBase* worker_queue)
-    : clock_(clock), worker_queue_(worker_queue), metronome_(metronome) {
+DecodeSynchronizer::DecodeSynchronizer(
+    Clock* clock,
+    Metronome* metronome,
+    TaskQueueBase* worker_queue,
+    std::unique_ptr<DecodeWorkerPool> decode_worker_pool)
+    : clock_(clock),
+      worker_queue_(worker_queue),
+      metronome_(metronome),
+      decode_worker_pool_(std::move(decode_worker_pool)) {
   RTC_DCHECK(metronome_);
   RTC_DCHECK(worker_queue_);
 }
@@ -189,6 +194,12 @@ void DecodeSynchronizer::OnTick() {
   tick_scheduled_ = false;
   expected_next_tick_ = clock_->CurrentTime() + metronome_->TickPeriod();
 
+  // The released frames are posted to the decode queues of their streams. With
+  // a decode worker pool, they are handed to the workers together once all
+  // the frames of the tick are released.
+  if (decode_worker_pool_) {
+    decode_worker_pool_->BeginDispatch();
+  }
   for (auto* scheduler : schedulers_) {
     if (scheduler->ScheduledRtpTimestamp() &&
         scheduler->LatestDecodeTime() < expected_next_tick_) {
@@ -196,6 +207,9 @@ void DecodeSynchronizer::OnTick() {
       std::move(scheduled_frame).RunFrameReleaseCallback();
     }
   }
+  if (decode_worker_pool_) {
+    decode_worker_pool_->EndDispatch();
+  }
 
   if (!schedulers_.empty())
     ScheduleNextTick();
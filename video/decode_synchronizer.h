@@ -25,6 +25,7 @@
 #include "api/units/timestamp.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/thread_annotations.h"
+#include "video/decode_worker_pool.h"
 #include "video/frame_decode_scheduler.h"
 #include "video/frame_decode_timing.h"
 
@@ -51,19 +52,30 @@ namespace webrtc {
 // next metronome tick then the frame will be released right away, allowing a
 // delayed stream to catch up quickly.
 //
+// If the DecodeSynchronizer has a DecodeWorkerPool, the receive streams decode
+// on stream queues of the pool. The frames released on a tick are dispatched
+// to the free workers of the pool together, and are decoded in parallel on a
+// bounded number of task queues, rather than on one task queue per stream.
+//
 // DecodeSynchronizer is single threaded - all method calls must run on the
 // `worker_queue_`.
 class DecodeSynchronizer {
  public:
-  DecodeSynchronizer(Clock* clock,
-                     Metronome* metronome,
-                     TaskQueueBase* worker_queue);
+  DecodeSynchronizer(
+      Clock* clock,
+      Metronome* metronome,
+      TaskQueueBase* worker_queue,
+      std::unique_ptr<DecodeWorkerPool> decode_worker_pool = nullptr);
   ~DecodeSynchronizer();
   DecodeSynchronizer(const DecodeSynchronizer&) = delete;
   DecodeSynchronizer& operator=(const DecodeSynchronizer&) = delete;
 
   std::unique_ptr<FrameDecodeScheduler> CreateSynchronizedFrameScheduler();
 
+  // Returns the pool that the synchronized streams create their decode queues
+  // on, or nullptr if every stream decodes on a task queue of its own.
+  DecodeWorkerPool* decode_worker_pool() { return decode_worker_pool_.get(); }
+
  private:
   class ScheduledFrame {
    public:
@@ -125,6 +137,7 @@ class DecodeSynchronizer {
   Clock* const clock_;
   TaskQueueBase* const worker_queue_;
   Metronome* const metronome_;
+  const std::unique_ptr<DecodeWorkerPool> decode_worker_pool_;
 
   Timestamp expected_next_tick_ = Timestamp::PlusInfinity();
   std::set<SynchronizedFrameDecodeScheduler*> schedulers_
@@ -0,0 +1,254 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "video/decode_worker_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "absl/algorithm/container.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/event.h"
+#include "rtc_base/logging.h"
+
+namespace webrtc {
+
+class DecodeWorkerPool::StreamQueue : public TaskQueueBase {
+ public:
+  StreamQueue(DecodeWorkerPool* pool, int64_t id) : pool_(pool), id_(id) {}
+
+  void Delete() override {
+    std::deque<absl::AnyInvocable<void() &&>> pending_tasks;
+    bool running = pool_->RemoveStream(this, pending_tasks);
+    {
+      // Pending tasks are destroyed on the queue they were posted to.
+      CurrentTaskQueueSetter set_current(this);
+      pending_tasks.clear();
+    }
+    if (running && IsCurrent()) {
+      // The worker deletes the stream when the running task returns.
+      return;
+    }
+    if (running) {
+      task_done.Wait(rtc::Event::kForever);
+    }
+    delete this;
+  }
+
+  void RunTask(absl::AnyInvocable<void() &&> task) {
+    CurrentTaskQueueSetter set_current(this);
+    std::move(task)();
+    // Destroy the task while the stream is current.
+    task = nullptr;
+  }
+
+  int64_t id() const { return id_; }
+
+  // Tells the thread safety analysis that `pool_->mutex_` is held, which it
+  // can't tell from the pool's `mutex_`.
+  void AssertPoolLockHeld() const RTC_ASSERT_EXCLUSIVE_LOCK(pool_->mutex_) {
+    pool_->mutex_.AssertHeld();
+  }
+
+  std::deque<absl::AnyInvocable<void() &&>> tasks
+      RTC_GUARDED_BY(pool_->mutex_);
+  // True while the stream is in `ready_streams_` or a worker runs its task.
+  bool scheduled RTC_GUARDED_BY(pool_->mutex_) = false;
+  bool running RTC_GUARDED_BY(pool_->mutex_) = false;
+  bool deleted RTC_GUARDED_BY(pool_->mutex_) = false;
+  bool deleted_by_own_task RTC_GUARDED_BY(pool_->mutex_) = false;
+  // Set when the running task of a stream that is deleted on another thread
+  // returns.
+  rtc::Event task_done;
+
+ private:
+  void PostTaskImpl(absl::AnyInvocable<void() &&> task,
+                    const PostTaskTraits& /*traits*/,
+                    const Location& /*location*/) override {
+    pool_->PostTask(this, std::move(task));
+  }
+
+  void PostDelayedTaskImpl(absl::AnyInvocable<void() &&> task,
+                           TimeDelta delay,
+                           const PostDelayedTaskTraits& traits,
+                           const Location& /*location*/) override {
+    pool_->PostDelayedTask(id_, std::move(task), delay, traits.high_precision);
+  }
+
+  DecodeWorkerPool* const pool_;
+  const int64_t id_;
+};
+
+DecodeWorkerPool::DecodeWorkerPool(TaskQueueFactory* task_queue_factory,
+                                   int num_workers) {
+  RTC_DCHECK(task_queue_factory);
+  RTC_DCHECK_GT(num_workers, 0);
+  RTC_LOG(LS_INFO) << "Creating decode worker pool with " << num_workers
+                   << " workers.";
+  for (int i = 0; i < num_workers; ++i) {
+    workers_.push_back(task_queue_factory->CreateTaskQueue(
+        "DecodeWorker", TaskQueueFactory::Priority::HIGH));
+    idle_workers_.push_back(i);
+  }
+  timer_queue_ = task_queue_factory->CreateTaskQueue(
+      "DecodeWorkerTimer", TaskQueueFactory::Priority::HIGH);
+}
+
+DecodeWorkerPool::~DecodeWorkerPool() {
+  {
+    MutexLock lock(&mutex_);
+    RTC_CHECK(streams_.empty());
+  }
+  // Deleting the timer queue drops the pending delayed tasks. Deleting the
+  // workers after that waits for any running `RunReadyStreams()`, which finds
+  // no streams left.
+  timer_queue_ = nullptr;
+  workers_.clear();
+}
+
+std::unique_ptr<TaskQueueBase, TaskQueueDeleter>
+DecodeWorkerPool::CreateStreamQueue() {
+  MutexLock lock(&mutex_);
+  auto stream = std::make_unique<StreamQueue>(this, next_stream_id_++);
+  streams_.emplace(stream->id(), stream.get());
+  return std::unique_ptr<TaskQueueBase, TaskQueueDeleter>(stream.release());
+}
+
+void DecodeWorkerPool::BeginDispatch() {
+  MutexLock lock(&mutex_);
+  RTC_DCHECK(!dispatching_);
+  dispatching_ = true;
+}
+
+void DecodeWorkerPool::EndDispatch() {
+  MutexLock lock(&mutex_);
+  RTC_DCHECK(dispatching_);
+  dispatching_ = false;
+  WakeUpWorkers();
+}
+
+void DecodeWorkerPool::PostTask(StreamQueue* stream,
+                                absl::AnyInvocable<void() &&> task) {
+  MutexLock lock(&mutex_);
+  EnqueueTask(stream, std::move(task));
+}
+
+void DecodeWorkerPool::PostDelayedTask(int64_t stream_id,
+                                       absl::AnyInvocable<void() &&> task,
+                                       TimeDelta delay,
+                                       bool high_precision) {
+  // The stream may be deleted before the delay has passed, so it is looked up
+  // by id when the task is due.
+  auto enqueue_task = [this, stream_id, task = std::move(task)]() mutable {
+    MutexLock lock(&mutex_);
+    auto it = streams_.find(stream_id);
+    if (it != streams_.end()) {
+      EnqueueTask(it->second, std::move(task));
+    }
+  };
+  if (high_precision) {
+    timer_queue_->PostDelayedHighPrecisionTask(std::move(enqueue_task), delay);
+  } else {
+    timer_queue_->PostDelayedTask(std::move(enqueue_task), delay);
+  }
+}
+
+bool DecodeWorkerPool::RemoveStream(
+    StreamQueue* stream,
+    std::deque<absl::AnyInvocable<void() &&>>& pending_tasks) {
+  MutexLock lock(&mutex_);
+  stream->AssertPoolLockHeld();
+  RTC_DCHECK(!stream->deleted);
+  stream->deleted = true;
+  stream->deleted_by_own_task = stream->running && stream->IsCurrent();
+  streams_.erase(stream->id());
+  pending_tasks = std::move(stream->tasks);
+  stream->tasks.clear();
+  if (stream->scheduled && !stream->running) {
+    ready_streams_.erase(absl::c_find(ready_streams_, stream));
+  }
+  return stream->running;
+}
+
+void DecodeWorkerPool::EnqueueTask(StreamQueue* stream,
+                                   absl::AnyInvocable<void() &&> task) {
+  stream->AssertPoolLockHeld();
+  if (stream->deleted) {
+    return;
+  }
+  stream->tasks.push_back(std::move(task));
+  if (stream->scheduled) {
+    return;
+  }
+  stream->scheduled = true;
+  ready_streams_.push_back(stream);
+  if (!dispatching_) {
+    WakeUpWorkers();
+  }
+}
+
+void DecodeWorkerPool::WakeUpWorkers() {
+  size_t num_workers_to_wake =
+      std::min(ready_streams_.size(), idle_workers_.size());
+  for (size_t i = 0; i < num_workers_to_wake; ++i) {
+    int worker_index = idle_workers_.back();
+    idle_workers_.pop_back();
+    workers_[worker_index]->PostTask(
+        [this, worker_index] { RunReadyStreams(worker_index); });
+  }
+}
+
+void DecodeWorkerPool::RunReadyStreams(int worker_index) {
+  while (true) {
+    StreamQueue* stream;
+    absl::AnyInvocable<void() &&> task;
+    {
+      MutexLock lock(&mutex_);
+      if (ready_streams_.empty()) {
+        idle_workers_.push_back(worker_index);
+        return;
+      }
+      stream = ready_streams_.front();
+      ready_streams_.pop_front();
+      stream->AssertPoolLockHeld();
+      RTC_DCHECK(!stream->tasks.empty());
+      task = std::move(stream->tasks.front());
+      stream->tasks.pop_front();
+      stream->running = true;
+    }
+
+    stream->RunTask(std::move(task));
+
+    bool delete_stream = false;
+    {
+      MutexLock lock(&mutex_);
+      stream->AssertPoolLockHeld();
+      stream->running = false;
+      if (stream->deleted) {
+        // Unless the task deleted its own stream, `Delete()` is waiting on
+        // another thread, and deletes the stream after this.
+        delete_stream = stream->deleted_by_own_task;
+        if (!delete_stream) {
+          stream->task_done.Set();
+        }
+      } else if (stream->tasks.empty()) {
+        stream->scheduled = false;
+      } else {
+        // Let the other ready streams run before the next task of `stream`.
+        ready_streams_.push_back(stream);
+      }
+    }
+    if (delete_stream) {
+      delete stream;
+    }
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,104 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VIDEO_DECODE_WORKER_POOL_H_
+#define VIDEO_DECODE_WORKER_POOL_H_
+
+#include <stdint.h>
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "absl/functional/any_invocable.h"
+#include "api/task_queue/task_queue_base.h"
+#include "api/task_queue/task_queue_factory.h"
+#include "api/units/time_delta.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// DecodeWorkerPool shares a fixed number of decode task queues, the workers,
+// between video receive streams, instead of every stream decoding on a task
+// queue of its own.
+//
+// Every stream decodes on a stream queue from `CreateStreamQueue()`. The tasks
+// of a stream queue run in order and one at a time, like on any task queue,
+// but each task runs on whichever worker is free. The frames of one stream are
+// therefore decoded in order, while the frames of different streams are
+// decoded in parallel on up to `num_workers()` cores, no matter which streams
+// have frames to decode.
+//
+// A DecodeSynchronizer wraps each metronome tick in `BeginDispatch()` and
+// `EndDispatch()`, so that the frames that it releases on the tick are handed
+// to the free workers together.
+//
+// The stream queues must be deleted before the pool. All other methods may be
+// called on any thread.
+class DecodeWorkerPool {
+ public:
+  DecodeWorkerPool(TaskQueueFactory* task_queue_factory, int num_workers);
+  ~DecodeWorkerPool();
+  DecodeWorkerPool(const DecodeWorkerPool&) = delete;
+  DecodeWorkerPool& operator=(const DecodeWorkerPool&) = delete;
+
+  int num_workers() const { return workers_.size(); }
+
+  // Returns a task queue for the decodes of one stream.
+  std::unique_ptr<TaskQueueBase, TaskQueueDeleter> CreateStreamQueue();
+
+  // Tasks posted to the stream queues between these calls do not wake up any
+  // workers until `EndDispatch()`. Workers that are already running may still
+  // start them.
+  void BeginDispatch();
+  void EndDispatch();
+
+ private:
+  class StreamQueue;
+
+  void PostTask(StreamQueue* stream, absl::AnyInvocable<void() &&> task);
+  void PostDelayedTask(int64_t stream_id,
+                       absl::AnyInvocable<void() &&> task,
+                       TimeDelta delay,
+                       bool high_precision);
+  // Removes `stream` from the pool. Returns true if a worker is running a task
+  // of `stream`, and then takes care of deleting it.
+  bool RemoveStream(StreamQueue* stream,
+                    std::deque<absl::AnyInvocable<void() &&>>& pending_tasks);
+
+  void EnqueueTask(StreamQueue* stream, absl::AnyInvocable<void() &&> task)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Wakes up as many idle workers as there are streams waiting for one.
+  void WakeUpWorkers() RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Runs tasks of the ready streams, one task per stream in turn, until no
+  // stream has tasks left.
+  void RunReadyStreams(int worker_index);
+
+  // Created in the constructor and not modified after that.
+  std::vector<std::unique_ptr<TaskQueueBase, TaskQueueDeleter>> workers_;
+  // Times the delayed tasks of all streams, and only moves them to their
+  // stream when they are due, so that they aren't late when all workers are
+  // busy decoding.
+  std::unique_ptr<TaskQueueBase, TaskQueueDeleter> timer_queue_;
+
+  Mutex mutex_;
+  std::vector<int> idle_workers_ RTC_GUARDED_BY(mutex_);
+  // Streams that have tasks, but that no worker is running.
+  std::deque<StreamQueue*> ready_streams_ RTC_GUARDED_BY(mutex_);
+  std::map<int64_t, StreamQueue*> streams_ RTC_GUARDED_BY(mutex_);
+  int64_t next_stream_id_ RTC_GUARDED_BY(mutex_) = 0;
+  bool dispatching_ RTC_GUARDED_BY(mutex_) = false;
+};
+
+}  // namespace webrtc
+
+#endif  // VIDEO_DECODE_WORKER_POOL_H_
@@ -0,0 +1,197 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "api/task_queue/default_task_queue_factory.h"
+#include "api/task_queue/task_queue_base.h"
+#include "api/task_queue/task_queue_factory.h"
+#include "api/video/encoded_image.h"
+#include "api/video/render_resolution.h"
+#include "api/video/video_bitrate_allocation.h"
+#include "api/video/video_codec_type.h"
+#include "api/video/video_frame.h"
+#include "api/video_codecs/video_codec.h"
+#include "api/video_codecs/video_decoder.h"
+#include "api/video_codecs/video_encoder.h"
+#include "benchmark/benchmark.h"
+#include "modules/video_coding/codecs/test/encoded_video_frame_producer.h"
+#include "modules/video_coding/codecs/vp8/include/vp8.h"
+#include "modules/video_coding/codecs/vp9/include/vp9.h"
+#include "modules/video_coding/include/video_error_codes.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/event.h"
+#include "rtc_base/system/unused.h"
+#include "test/video_codec_settings.h"
+#include "video/decode_worker_pool.h"
+
+namespace webrtc {
+namespace {
+
+// A gallery of 4x4 tiles.
+constexpr int kNumStreams = 16;
+constexpr RenderResolution kResolution(640, 360);
+constexpr int kFramerate = 30;
+constexpr int kBitrateBps = 800'000;
+// The streams repeat a group of pictures that starts with a keyframe.
+constexpr int kGopLength = 30;
+
+std::vector<EncodedImage> EncodeGop(VideoCodecType codec_type) {
+  std::unique_ptr<VideoEncoder> encoder = codec_type == kVideoCodecVP8
+                                              ? VP8Encoder::Create()
+                                              : VP9Encoder::Create();
+  VideoCodec codec_settings;
+  test::CodecSettings(codec_type, &codec_settings);
+  codec_settings.width = kResolution.Width();
+  codec_settings.height = kResolution.Height();
+  codec_settings.maxFramerate = kFramerate;
+  codec_settings.startBitrate = kBitrateBps / 1000;
+  codec_settings.maxBitrate = kBitrateBps / 1000;
+  codec_settings.SetFrameDropEnabled(false);
+  if (codec_type == kVideoCodecVP9) {
+    codec_settings.VP9()->numberOfSpatialLayers = 1;
+    codec_settings.VP9()->numberOfTemporalLayers = 1;
+  }
+  RTC_CHECK_EQ(
+      encoder->InitEncode(
+          &codec_settings,
+          VideoEncoder::Settings(
+              VideoEncoder::Capabilities(/*loss_notification=*/false),
+              /*number_of_cores=*/1, /*max_payload_size=*/1200)),
+      WEBRTC_VIDEO_CODEC_OK);
+  VideoBitrateAllocation allocation;
+  allocation.SetBitrate(0, 0, kBitrateBps);
+  encoder->SetRates(
+      VideoEncoder::RateControlParameters(allocation, kFramerate));
+
+  std::vector<EncodedImage> gop;
+  for (const EncodedVideoFrameProducer::EncodedFrame& frame :
+       EncodedVideoFrameProducer(*encoder)
+           .SetNumInputFrames(kGopLength)
+           .SetResolution(kResolution)
+           .SetFramerateFps(kFramerate)
+           .Encode()) {
+    gop.push_back(frame.encoded_image);
+  }
+  encoder->Release();
+  return gop;
+}
+
+class DecodedFrameCounter : public DecodedImageCallback {
+ public:
+  int32_t Decoded(VideoFrame& /*decoded_image*/) override {
+    ++num_frames_;
+    return 0;
+  }
+  void Decoded(VideoFrame& /*decoded_image*/,
+               absl::optional<int32_t> /*decode_time_ms*/,
+               absl::optional<uint8_t> /*qp*/) override {
+    ++num_frames_;
+  }
+
+  int num_frames() const { return num_frames_; }
+
+ private:
+  int num_frames_ = 0;
+};
+
+struct Stream {
+  std::unique_ptr<VideoDecoder> decoder;
+  DecodedFrameCounter decoded_frames;
+  std::unique_ptr<TaskQueueBase, TaskQueueDeleter> decode_queue;
+};
+
+// Decodes `kNumStreams` streams with software decoders on a DecodeWorkerPool
+// of `state.range(0)` workers. Every iteration is a metronome tick that
+// dispatches one frame of every stream, like DecodeSynchronizer does.
+void DecodeStreams(benchmark::State& state, VideoCodecType codec_type) {
+  const int num_workers = state.range(0);
+  const std::vector<EncodedImage> gop = EncodeGop(codec_type);
+  RTC_CHECK_EQ(gop.size(), kGopLength);
+  std::unique_ptr<TaskQueueFactory> task_queue_factory =
+      CreateDefaultTaskQueueFactory();
+  DecodeWorkerPool decode_worker_pool(task_queue_factory.get(), num_workers);
+
+  VideoDecoder::Settings decoder_settings;
+  decoder_settings.set_codec_type(codec_type);
+  decoder_settings.set_number_of_cores(1);
+  decoder_settings.set_max_render_resolution(kResolution);
+  std::vector<Stream> streams(kNumStreams);
+  for (Stream& stream : streams) {
+    stream.decoder = codec_type == kVideoCodecVP8 ? VP8Decoder::Create()
+                                                  : VP9Decoder::Create();
+    RTC_CHECK(stream.decoder->Configure(decoder_settings));
+    stream.decoder->RegisterDecodeCompleteCallback(&stream.decoded_frames);
+    stream.decode_queue = decode_worker_pool.CreateStreamQueue();
+  }
+
+  int64_t num_frames = 0;
+  rtc::Event tick_decoded;
+  std::atomic<int> streams_pending(0);
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    const EncodedImage& frame = gop[num_frames / kNumStreams % kGopLength];
+    streams_pending.store(kNumStreams);
+    decode_worker_pool.BeginDispatch();
+    for (Stream& stream : streams) {
+      stream.decode_queue->PostTask([&stream, &frame, &streams_pending,
+                                     &tick_decoded] {
+        RTC_CHECK_EQ(stream.decoder->Decode(frame, /*render_time_ms=*/0),
+                     WEBRTC_VIDEO_CODEC_OK);
+        if (streams_pending.fetch_sub(1) == 1) {
+          tick_decoded.Set();
+        }
+      });
+    }
+    decode_worker_pool.EndDispatch();
+    tick_decoded.Wait(rtc::Event::kForever);
+    num_frames += kNumStreams;
+  }
+
+  for (Stream& stream : streams) {
+    RTC_CHECK_EQ(stream.decoded_frames.num_frames(), num_frames / kNumStreams);
+    stream.decoder->Release();
+    stream.decode_queue = nullptr;
+  }
+
+  state.SetItemsProcessed(num_frames);
+  state.counters["frames_per_second"] =
+      benchmark::Counter(num_frames, benchmark::Counter::kIsRate);
+}
+
+void BM_DecodeWorkerPoolVp8(benchmark::State& state) {
+  DecodeStreams(state, kVideoCodecVP8);
+}
+
+BENCHMARK(BM_DecodeWorkerPoolVp8)
+    ->ArgName("workers")
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->UseRealTime();
+
+#if defined(RTC_ENABLE_VP9)
+void BM_DecodeWorkerPoolVp9(benchmark::State& state) {
+  DecodeStreams(state, kVideoCodecVP9);
+}
+
+BENCHMARK(BM_DecodeWorkerPoolVp9)
+    ->ArgName("workers")
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->UseRealTime();
+#endif  // defined(RTC_ENABLE_VP9)
+
+}  // namespace
+}  // namespace webrtc
@@ -0,0 +1,225 @@
+/*
+ *  Copyright (c) 2023 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "video/decode_worker_pool.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "api/task_queue/default_task_queue_factory.h"
+#include "api/task_queue/task_queue_base.h"
+#include "api/task_queue/task_queue_factory.h"
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "rtc_base/event.h"
+#include "system_wrappers/include/sleep.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+#include "test/time_controller/simulated_time_controller.h"
+
+using ::testing::ElementsAre;
+
+namespace webrtc {
+
+TEST(DecodeWorkerPoolTest, RunsTasksOfStreamInOrder) {
+  GlobalSimulatedTimeController time_controller(Timestamp::Seconds(1000));
+  DecodeWorkerPool pool(time_controller.GetTaskQueueFactory(),
+                        /*num_workers=*/2);
+  EXPECT_EQ(pool.num_workers(), 2);
+  auto stream1 = pool.CreateStreamQueue();
+  auto stream2 = pool.CreateStreamQueue();
+
+  std::vector<int> stream1_tasks;
+  std::vector<int> stream2_tasks;
+  for (int i = 0; i < 5; ++i) {
+    stream1->PostTask([&stream1_tasks, &stream1, i] {
+      EXPECT_TRUE(stream1->IsCurrent());
+      stream1_tasks.push_back(i);
+    });
+    stream2->PostTask([&stream2_tasks, &stream2, i] {
+      EXPECT_TRUE(stream2->IsCurrent());
+      stream2_tasks.push_back(i);
+    });
+  }
+  time_controller.AdvanceTime(TimeDelta::Zero());
+  EXPECT_THAT(stream1_tasks, ElementsAre(0, 1, 2, 3, 4));
+  EXPECT_THAT(stream2_tasks, ElementsAre(0, 1, 2, 3, 4));
+}
+
+TEST(DecodeWorkerPoolTest, RunsDelayedTasksOfStream) {
+  GlobalSimulatedTimeController time_controller(Timestamp::Seconds(1000));
+  DecodeWorkerPool pool(time_controller.GetTaskQueueFactory(),
+                        /*num_workers=*/1);
+  auto stream = pool.CreateStreamQueue();
+  auto deleted_stream = pool.CreateStreamQueue();
+
+  bool ran = false;
+  bool deleted_stream_ran = false;
+  stream->PostDelayedTask(
+      [&] {
+        EXPECT_TRUE(stream->IsCurrent());
+        ran = true;
+      },
+      TimeDelta::Millis(10));
+  deleted_stream->PostDelayedTask([&] { deleted_stream_ran = true; },
+                                  TimeDelta::Millis(10));
+  deleted_stream = nullptr;
+
+  time_controller.AdvanceTime(TimeDelta::Millis(9));
+  EXPECT_FALSE(ran);
+  time_controller.AdvanceTime(TimeDelta::Millis(1));
+  EXPECT_TRUE(ran);
+  EXPECT_FALSE(deleted_stream_ran);
+}
+
+TEST(DecodeWorkerPoolTest, HoldsBackTasksUntilDispatchEnds) {
+  GlobalSimulatedTimeController time_controller(Timestamp::Seconds(1000));
+  DecodeWorkerPool pool(time_controller.GetTaskQueueFactory(),
+                        /*num_workers=*/2);
+  auto stream1 = pool.CreateStreamQueue();
+  auto stream2 = pool.CreateStreamQueue();
+
+  int num_tasks_run = 0;
+  pool.BeginDispatch();
+  stream1->PostTask([&num_tasks_run] { ++num_tasks_run; });
+  stream2->PostTask([&num_tasks_run] { ++num_tasks_run; });
+  time_controller.AdvanceTime(TimeDelta::Zero());
+  EXPECT_EQ(num_tasks_run, 0);
+
+  pool.EndDispatch();
+  time_controller.AdvanceTime(TimeDelta::Zero());
+  EXPECT_EQ(num_tasks_run, 2);
+}
+
+TEST(DecodeWorkerPoolTest, DropsPendingTasksOfDeletedStream) {
+  GlobalSimulatedTimeController time_controller(Timestamp::Seconds(1000));
+  DecodeWorkerPool pool(time_controller.GetTaskQueueFactory(),
+                        /*num_workers=*/1);
+  auto stream = pool.CreateStreamQueue();
+
+  std::vector<int> tasks_run;
+  stream->PostTask([&] {
+    tasks_run.push_back(0);
+    // A stream may be deleted by its own task.
+    stream = nullptr;
+  });
+  TaskQueueBase* stream_ptr = stream.get();
+  stream_ptr->PostTask([&] { tasks_run.push_back(1); });
+  time_controller.AdvanceTime(TimeDelta::Zero());
+  EXPECT_THAT(tasks_run, ElementsAre(0));
+}
+
+TEST(DecodeWorkerPoolTest, RunsTasksOfDifferentStreamsInParallel) {
+  std::unique_ptr<TaskQueueFactory> task_queue_factory =
+      CreateDefaultTaskQueueFactory();
+  DecodeWorkerPool pool(task_queue_factory.get(), /*num_workers=*/2);
+  auto stream1 = pool.CreateStreamQueue();
+  auto stream2 = pool.CreateStreamQueue();
+
+  // The task of the first stream can only finish early if the task of the
+  // second stream runs at the same time.
+  rtc::Event stream2_task_ran;
+  rtc::Event stream1_task_done;
+  bool stream1_task_finished_early = false;
+  stream1->PostTask([&] {
+    stream1_task_finished_early = stream2_task_ran.Wait(TimeDelta::Seconds(5));
+    stream1_task_done.Set();
+  });
+  stream2->PostTask([&] { stream2_task_ran.Set(); });
+  ASSERT_TRUE(stream1_task_done.Wait(TimeDelta::Seconds(10)));
+  EXPECT_TRUE(stream1_task_finished_early);
+}
+
+TEST(DecodeWorkerPoolTest, RunsTasksOfAnyStreamOnFreeWorker) {
+  std::unique_ptr<TaskQueueFactory> task_queue_factory =
+      CreateDefaultTaskQueueFactory();
+  DecodeWorkerPool pool(task_queue_factory.get(), /*num_workers=*/2);
+  auto stream1 = pool.CreateStreamQueue();
+  auto stream2 = pool.CreateStreamQueue();
+  auto stream3 = pool.CreateStreamQueue();
+
+  // While the task of the first stream blocks one worker, the tasks of both
+  // other streams run on the other worker.
+  rtc::Event stream2_task_ran;
+  rtc::Event stream3_task_ran;
+  rtc::Event stream1_task_done;
+  bool stream1_task_finished_early = false;
+  stream1->PostTask([&] {
+    stream1_task_finished_early =
+        stream2_task_ran.Wait(TimeDelta::Seconds(5)) &&
+        stream3_task_ran.Wait(TimeDelta::Seconds(5));
+    stream1_task_done.Set();
+  });
+  stream2->PostTask([&] { stream2_task_ran.Set(); });
+  stream3->PostTask([&] { stream3_task_ran.Set(); });
+  ASSERT_TRUE(stream1_task_done.Wait(TimeDelta::Seconds(20)));
+  EXPECT_TRUE(stream1_task_finished_early);
+}
+
+TEST(DecodeWorkerPoolTest, TimesDelayedTasksWhileWorkersAreBusy) {
+  std::unique_ptr<TaskQueueFactory> task_queue_factory =
+      CreateDefaultTaskQueueFactory();
+  DecodeWorkerPool pool(task_queue_factory.get(), /*num_workers=*/2);
+  auto stream1 = pool.CreateStreamQueue();
+  auto stream2 = pool.CreateStreamQueue();
+  auto stream3 = pool.CreateStreamQueue();
+
+  // Both workers are busy when the delayed task is posted. The delayed task
+  // must still become due, and run once the task of the first stream frees
+  // its worker, while the task of the second stream keeps the other worker
+  // busy until then.
+  rtc::Event stream1_release;
+  rtc::Event stream3_task_ran;
+  rtc::Event stream2_task_done;
+  rtc::Event both_running;
+  std::atomic<int> num_running(0);
+  bool stream2_task_finished_early = false;
+  auto mark_running = [&] {
+    if (++num_running == 2) {
+      both_running.Set();
+    }
+  };
+  stream1->PostTask([&] {
+    mark_running();
+    stream1_release.Wait(TimeDelta::Seconds(10));
+  });
+  stream2->PostTask([&] {
+    mark_running();
+    stream2_task_finished_early = stream3_task_ran.Wait(TimeDelta::Seconds(5));
+    stream2_task_done.Set();
+  });
+  ASSERT_TRUE(both_running.Wait(TimeDelta::Seconds(10)));
+  stream3->PostDelayedTask([&] { stream3_task_ran.Set(); },
+                           TimeDelta::Millis(10));
+  stream1_release.Set();
+  ASSERT_TRUE(stream2_task_done.Wait(TimeDelta::Seconds(10)));
+  EXPECT_TRUE(stream2_task_finished_early);
+}
+
+TEST(DecodeWorkerPoolTest, DeletingStreamWaitsForRunningTask) {
+  std::unique_ptr<TaskQueueFactory> task_queue_factory =
+      CreateDefaultTaskQueueFactory();
+  DecodeWorkerPool pool(task_queue_factory.get(), /*num_workers=*/1);
+  auto stream = pool.CreateStreamQueue();
+
+  rtc::Event task_started;
+  std::atomic<bool> task_done(false);
+  stream->PostTask([&] {
+    task_started.Set();
+    SleepMs(100);
+    task_done = true;
+  });
+  ASSERT_TRUE(task_started.Wait(TimeDelta::Seconds(10)));
+  stream = nullptr;
+  EXPECT_TRUE(task_done);
+}
+
+}  // namespace webrtc
@@ -42,6 +42,7 @@
 #include "modules/video_coding/nack_requester.h"
 #include "modules/video_coding/packet_buffer.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/copy_on_write_buffer.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/strings/string_builder.h"
 #include "system_wrappers/include/metrics.h"
@@ -289,6 +290,8 @@ RtpVideoStreamReceiver2::RtpVideoStreamReceiver2(
                                             &rtcp_feedback_buffer_,
                                             &rtcp_feedback_buffer_,
                                             field_trials_)),
+      zero_copy_frame_assembly_(
+          field_trials_.IsEnabled("WebRTC-Video-ZeroCopyFrameAssembly")),
       packet_buffer_(kPacketBufferStartSize,
                      PacketBufferMaxSize(field_trials_)),
       reference_finder_(std::make_unique<RtpFrameReferenceFinder>()),
@@ -539,8 +542,8 @@ void RtpVideoStreamReceiver2::OnReceivedPayloadData(
     const RTPVideoHeader& video) {
   RTC_DCHECK_RUN_ON(&packet_sequence_checker_);
 
-  auto packet =
-      std::make_unique<video_coding::PacketBuffer::Packet>(rtp_packet, video);
+  std::unique_ptr<video_coding::PacketBuffer::Packet> packet =
+      packet_buffer_.CreatePacket(rtp_packet, video);
 
   int64_t unwrapped_rtp_seq_num =
       rtp_seq_num_unwrapper_.Unwrap(rtp_packet.SequenceNumber());
@@ -674,9 +677,13 @@ void RtpVideoStreamReceiver2::OnReceivedPayloadData(
     }
 
     video_coding::H264SpsPpsTracker::FixedBitstream fixed =
-        tracker_.CopyAndFixBitstream(
-            rtc::MakeArrayView(codec_payload.cdata(), codec_payload.size()),
-            &packet->video_header);
+        zero_copy_frame_assembly_
+            ? tracker_.FixBitstream(std::move(codec_payload),
+                                    &packet->video_header)
+            : tracker_.CopyAndFixBitstream(
+                  rtc::MakeArrayView(codec_payload.cdata(),
+                                     codec_payload.size()),
+                  &packet->video_header);
 
     switch (fixed.action) {
       case video_coding::H264SpsPpsTracker::kRequestKeyframe:
@@ -686,6 +693,7 @@ void RtpVideoStreamReceiver2::OnReceivedPayloadData(
       case video_coding::H264SpsPpsTracker::kDrop:
         return;
       case video_coding::H264SpsPpsTracker::kInsert:
+        packet->video_payload_prefix = std::move(fixed.prefix);
         packet->video_payload = std::move(fixed.bitstream);
         break;
     }
@@ -773,6 +781,8 @@ void RtpVideoStreamReceiver2::OnInsertedPacket(
   int64_t min_recv_time;
   int64_t max_recv_time;
   std::vector<rtc::ArrayView<const uint8_t>> payloads;
+  // Used instead of `payloads` when `zero_copy_frame_assembly_` is set.
+  std::vector<rtc::CopyOnWriteBuffer> fragments;
   RtpPacketInfos::vector_type packet_infos;
 
   bool frame_boundary = true;
@@ -794,7 +804,14 @@ void RtpVideoStreamReceiver2::OnInsertedPacket(
       min_recv_time = std::min(min_recv_time, packet_info.receive_time().ms());
       max_recv_time = std::max(max_recv_time, packet_info.receive_time().ms());
     }
-    payloads.emplace_back(packet->video_payload);
+    if (zero_copy_frame_assembly_) {
+      if (packet->video_payload_prefix.size() > 0) {
+        fragments.push_back(packet->video_payload_prefix);
+      }
+      fragments.push_back(packet->video_payload);
+    } else {
+      payloads.emplace_back(packet->video_payload);
+    }
     packet_infos.push_back(packet_info);
 
     frame_boundary = packet->is_last_packet_in_frame();
@@ -802,8 +819,17 @@ void RtpVideoStreamReceiver2::OnInsertedPacket(
       auto depacketizer_it = payload_type_map_.find(first_packet->payload_type);
       RTC_CHECK(depacketizer_it != payload_type_map_.end());
 
-      rtc::scoped_refptr<EncodedImageBuffer> bitstream =
-          depacketizer_it->second->AssembleFrame(payloads);
+      rtc::scoped_refptr<EncodedImageBufferInterface> bitstream;
+      if (zero_copy_frame_assembly_) {
+        bitstream = depacketizer_it->second->AssembleFrameFragments(fragments);
+        // Everything downstream, e.g. the frame decryptor, the frame
+        // transformer and the decoders, reads the frame as contiguous data.
+        if (bitstream && bitstream->num_fragments() > 1) {
+          bitstream = EncodedImageBuffer::Create(*bitstream);
+        }
+      } else {
+        bitstream = depacketizer_it->second->AssembleFrame(payloads);
+      }
       if (!bitstream) {
         // Failed to assemble a frame. Discard and continue.
         continue;
@@ -829,10 +855,12 @@ void RtpVideoStreamReceiver2::OnInsertedPacket(
           RtpPacketInfos(std::move(packet_infos)),           //
           std::move(bitstream)));
       payloads.clear();
+      fragments.clear();
       packet_infos.clear();
     }
   }
   RTC_DCHECK(frame_boundary);
+  packet_buffer_.RecyclePackets(std::move(result.packets));
   if (result.buffer_cleared) {
     last_received_rtp_system_time_.reset();
     last_received_keyframe_rtp_system_time_.reset();
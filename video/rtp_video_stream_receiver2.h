@@ -355,6 +355,9 @@ class RtpVideoStreamReceiver2 : public LossNotificationSender,
   std::unique_ptr<LossNotificationController> loss_notification_controller_
       RTC_GUARDED_BY(packet_sequence_checker_);
 
+  // Set by the field trial WebRTC-Video-ZeroCopyFrameAssembly to assemble
+  // frames that reference the received payloads instead of copying them.
+  const bool zero_copy_frame_assembly_;
   video_coding::PacketBuffer packet_buffer_
       RTC_GUARDED_BY(packet_sequence_checker_);
   UniqueTimestampCounter frame_counter_
@@ -522,6 +522,13 @@ INSTANTIATE_TEST_SUITE_P(SpsPpsIdrIsKeyframe,
                          RtpVideoStreamReceiver2TestH264,
                          Values("", "WebRTC-SpsPpsIdrIsH264Keyframe/Enabled/"));
 
+INSTANTIATE_TEST_SUITE_P(
+    ZeroCopyFrameAssembly,
+    RtpVideoStreamReceiver2TestH264,
+    Values("WebRTC-Video-ZeroCopyFrameAssembly/Enabled/",
+           "WebRTC-SpsPpsIdrIsH264Keyframe/Enabled/"
+           "WebRTC-Video-ZeroCopyFrameAssembly/Enabled/"));
+
 TEST_P(RtpVideoStreamReceiver2TestH264, InBandSpsPps) {
   rtc::CopyOnWriteBuffer sps_data;
   RtpPacketReceived rtp_packet;
@@ -613,8 +620,8 @@ TEST_P(RtpVideoStreamReceiver2TestH264, OutOfBandFmtpSpsPps) {
 TEST_P(RtpVideoStreamReceiver2TestH264, ForceSpsPpsIdrIsKeyframe) {
   constexpr int kPayloadType = 99;
   std::map<std::string, std::string> codec_params;
-  if (GetParam() ==
-      "") {  // Forcing can be done either with field trial or codec_params.
+  // Forcing can be done either with field trial or codec_params.
+  if (GetParam().find("WebRTC-SpsPpsIdrIsH264Keyframe") == std::string::npos) {
     codec_params.insert({cricket::kH264FmtpSpsPpsIdrInKeyframe, ""});
   }
   rtp_video_stream_receiver_->AddReceiveCodec(kPayloadType, kVideoCodecH264,
@@ -43,6 +43,7 @@
 #include "modules/video_coding/utility/vp8_header_parser.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/event.h"
+#include "rtc_base/experiments/field_trial_parser.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/strings/string_builder.h"
 #include "rtc_base/synchronization/mutex.h"
@@ -51,6 +52,8 @@
 #include "rtc_base/trace_event.h"
 #include "system_wrappers/include/clock.h"
 #include "video/call_stats2.h"
+#include "video/decode_synchronizer.h"
+#include "video/decode_worker_pool.h"
 #include "video/frame_dumping_decoder.h"
 #include "video/receive_statistics_proxy.h"
 #include "video/render/incoming_video_stream.h"
@@ -124,6 +127,20 @@ RenderResolution InitialDecoderResolution(const FieldTrialsView& field_trials) {
   return RenderResolution(320, 180);
 }
 
+VideoDecoder::ThreadingMode DecoderThreadingMode(
+    VideoDecoder::ThreadingMode configured_mode,
+    const FieldTrialsView& field_trials) {
+  if (configured_mode != VideoDecoder::ThreadingMode::kDefault) {
+    return configured_mode;
+  }
+  FieldTrialEnum<VideoDecoder::ThreadingMode> mode(
+      "mode", VideoDecoder::ThreadingMode::kDefault,
+      {{"tile", VideoDecoder::ThreadingMode::kTileParallel},
+       {"frame", VideoDecoder::ThreadingMode::kFrameParallel}});
+  ParseFieldTrial({&mode}, field_trials.Lookup("WebRTC-DecoderThreading"));
+  return mode;
+}
+
 // Video decoder class to be used for unknown codecs. Doesn't support decoding
 // but logs messages to LS_ERROR.
 class NullVideoDecoder : public webrtc::VideoDecoder {
@@ -180,6 +197,7 @@ VideoReceiveStream2::VideoReceiveStream2(
     TaskQueueFactory* task_queue_factory,
     Call* call,
     int num_cpu_cores,
+    rtc::scoped_refptr<DecoderCoreBudget> decoder_core_budget,
     PacketRouter* packet_router,
     VideoReceiveStreamInterface::Config config,
     CallStats* call_stats,
@@ -192,6 +210,9 @@ VideoReceiveStream2::VideoReceiveStream2(
       transport_adapter_(config.rtcp_send_transport),
       config_(std::move(config)),
       num_cpu_cores_(num_cpu_cores),
+      decoder_threading_mode_(
+          DecoderThreadingMode(config_.decoder_threading_mode, call->trials())),
+      decoder_core_budget_(std::move(decoder_core_budget)),
       call_(call),
       clock_(clock),
       call_stats_(call_stats),
@@ -222,9 +243,13 @@ VideoReceiveStream2::VideoReceiveStream2(
       max_wait_for_frame_(DetermineMaxWaitForFrame(
           TimeDelta::Millis(config_.rtp.nack.rtp_history_ms),
           false)),
-      decode_queue_(task_queue_factory_->CreateTaskQueue(
-          "DecodingQueue",
-          TaskQueueFactory::Priority::HIGH)) {
+      owned_decode_queue_(
+          decode_sync && decode_sync->decode_worker_pool()
+              ? decode_sync->decode_worker_pool()->CreateStreamQueue()
+              : task_queue_factory_->CreateTaskQueue(
+                    "DecodingQueue",
+                    TaskQueueFactory::Priority::HIGH)),
+      decode_queue_(owned_decode_queue_.get()) {
   RTC_LOG(LS_INFO) << "VideoReceiveStream2: " << config_.ToString();
 
   RTC_DCHECK(call_->worker_thread());
@@ -358,6 +383,8 @@ void VideoReceiveStream2::Start() {
     settings.set_max_render_resolution(
         InitialDecoderResolution(call_->trials()));
     settings.set_number_of_cores(num_cpu_cores_);
+    settings.set_threading_mode(decoder_threading_mode_);
+    settings.set_core_budget(decoder_core_budget_);
 
     const bool raw_payload =
         config_.rtp.raw_payload_types.count(decoder.payload_type) > 0;
@@ -381,8 +408,8 @@ void VideoReceiveStream2::Start() {
 
   // Start decoding on task queue.
   stats_proxy_.DecoderThreadStarting();
-  decode_queue_.PostTask([this] {
-    RTC_DCHECK_RUN_ON(&decode_queue_);
+  decode_queue_->PostTask([this] {
+    RTC_DCHECK_RUN_ON(decode_queue_);
     decoder_stopped_ = false;
   });
   buffer_->StartNextDecode(true);
@@ -412,8 +439,8 @@ void VideoReceiveStream2::Stop() {
 
   if (decoder_running_) {
     rtc::Event done;
-    decode_queue_.PostTask([this, &done] {
-      RTC_DCHECK_RUN_ON(&decode_queue_);
+    decode_queue_->PostTask([this, &done] {
+      RTC_DCHECK_RUN_ON(decode_queue_);
       // Set `decoder_stopped_` before deregistering all decoders. This means
       // that any pending encoded frame will return early without trying to
       // access the decoder database.
@@ -769,10 +796,10 @@ void VideoReceiveStream2::OnEncodedFrame(std::unique_ptr<EncodedFrame> frame) {
   }
   stats_proxy_.OnPreDecode(frame->CodecSpecific()->codecType, qp);
 
-  decode_queue_.PostTask([this, now, keyframe_request_is_due,
+  decode_queue_->PostTask([this, now, keyframe_request_is_due,
                           received_frame_is_keyframe, frame = std::move(frame),
                           keyframe_required = keyframe_required_]() mutable {
-    RTC_DCHECK_RUN_ON(&decode_queue_);
+    RTC_DCHECK_RUN_ON(decode_queue_);
     if (decoder_stopped_)
       return;
     DecodeFrameResult result = HandleEncodedFrameOnDecodeQueue(
@@ -836,7 +863,7 @@ VideoReceiveStream2::HandleEncodedFrameOnDecodeQueue(
     std::unique_ptr<EncodedFrame> frame,
     bool keyframe_request_is_due,
     bool keyframe_required) {
-  RTC_DCHECK_RUN_ON(&decode_queue_);
+  RTC_DCHECK_RUN_ON(decode_queue_);
 
   bool force_request_key_frame = false;
   absl::optional<int64_t> decoded_frame_picture_id;
@@ -878,7 +905,7 @@ VideoReceiveStream2::HandleEncodedFrameOnDecodeQueue(
 
 int VideoReceiveStream2::DecodeAndMaybeDispatchEncodedFrame(
     std::unique_ptr<EncodedFrame> frame) {
-  RTC_DCHECK_RUN_ON(&decode_queue_);
+  RTC_DCHECK_RUN_ON(decode_queue_);
 
   // If `buffered_encoded_frames_` grows out of control (=60 queued frames),
   // maybe due to a stuck decoder, we just halt the process here and log the
@@ -1045,10 +1072,10 @@ VideoReceiveStream2::SetAndGetRecordingState(RecordingState state,
             : Timestamp::Millis(state.last_keyframe_request_ms.value_or(0));
   }
 
-  decode_queue_.PostTask(
+  decode_queue_->PostTask(
       [this, &event, &old_state, callback = std::move(state.callback),
        last_keyframe_request = std::move(last_keyframe_request)] {
-        RTC_DCHECK_RUN_ON(&decode_queue_);
+        RTC_DCHECK_RUN_ON(decode_queue_);
         old_state.callback = std::move(encoded_frame_buffer_function_);
         encoded_frame_buffer_function_ = std::move(callback);
 
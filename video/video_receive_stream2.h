@@ -17,12 +17,16 @@
 #include <vector>
 
 #include "absl/types/optional.h"
+#include "api/scoped_refptr.h"
 #include "api/sequence_checker.h"
 #include "api/task_queue/pending_task_safety_flag.h"
+#include "api/task_queue/task_queue_base.h"
 #include "api/task_queue/task_queue_factory.h"
 #include "api/units/time_delta.h"
 #include "api/units/timestamp.h"
 #include "api/video/recordable_encoded_frame.h"
+#include "api/video_codecs/decoder_core_budget.h"
+#include "api/video_codecs/video_decoder.h"
 #include "call/call.h"
 #include "call/rtp_packet_sink_interface.h"
 #include "call/syncable.h"
@@ -31,7 +35,6 @@
 #include "modules/video_coding/nack_requester.h"
 #include "modules/video_coding/video_receiver2.h"
 #include "rtc_base/system/no_unique_address.h"
-#include "rtc_base/task_queue.h"
 #include "rtc_base/thread_annotations.h"
 #include "system_wrappers/include/clock.h"
 #include "video/receive_statistics_proxy.h"
@@ -97,6 +100,7 @@ class VideoReceiveStream2
   VideoReceiveStream2(TaskQueueFactory* task_queue_factory,
                       Call* call,
                       int num_cpu_cores,
+                      rtc::scoped_refptr<DecoderCoreBudget> decoder_core_budget,
                       PacketRouter* packet_router,
                       VideoReceiveStreamInterface::Config config,
                       CallStats* call_stats,
@@ -258,6 +262,8 @@ class VideoReceiveStream2
   TransportAdapter transport_adapter_;
   const VideoReceiveStreamInterface::Config config_;
   const int num_cpu_cores_;
+  const VideoDecoder::ThreadingMode decoder_threading_mode_;
+  const rtc::scoped_refptr<DecoderCoreBudget> decoder_core_budget_;
   Call* const call_;
   Clock* const clock_;
 
@@ -344,8 +350,11 @@ class VideoReceiveStream2
   std::vector<std::unique_ptr<EncodedFrame>> buffered_encoded_frames_
       RTC_GUARDED_BY(decode_queue_);
 
-  // Defined last so they are destroyed before all other members.
-  rtc::TaskQueue decode_queue_;
+  // Defined last so they are destroyed before all other members. A stream
+  // queue of the decode worker pool when the stream is synchronized by a
+  // DecodeSynchronizer with a pool, and a task queue of its own otherwise.
+  const std::unique_ptr<TaskQueueBase, TaskQueueDeleter> owned_decode_queue_;
+  TaskQueueBase* const decode_queue_;
 
   // Used to signal destruction to potentially pending tasks.
   ScopedTaskSafety task_safety_;
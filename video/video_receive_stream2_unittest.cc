@@ -23,9 +23,11 @@
 
 #include "absl/memory/memory.h"
 #include "absl/types/optional.h"
+#include "api/make_ref_counted.h"
 #include "api/metronome/test/fake_metronome.h"
 #include "api/test/mock_video_decoder.h"
 #include "api/test/mock_video_decoder_factory.h"
+#include "api/scoped_refptr.h"
 #include "api/test/time_controller.h"
 #include "api/units/frequency.h"
 #include "api/units/time_delta.h"
@@ -33,6 +35,7 @@
 #include "api/video/recordable_encoded_frame.h"
 #include "api/video/test/video_frame_matchers.h"
 #include "api/video/video_frame.h"
+#include "api/video_codecs/decoder_core_budget.h"
 #include "api/video_codecs/sdp_video_format.h"
 #include "api/video_codecs/video_decoder.h"
 #include "call/rtp_stream_receiver_controller.h"
@@ -42,6 +45,7 @@
 #include "modules/pacing/packet_router.h"
 #include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
 #include "modules/video_coding/encoded_frame.h"
+#include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
 #include "system_wrappers/include/clock.h"
 #include "test/fake_decoder.h"
@@ -53,6 +57,8 @@
 #include "test/time_controller/simulated_time_controller.h"
 #include "test/video_decoder_proxy_factory.h"
 #include "video/call_stats2.h"
+#include "video/decode_synchronizer.h"
+#include "video/decode_worker_pool.h"
 
 namespace webrtc {
 
@@ -182,13 +188,26 @@ Timestamp ReceiveTimeForFrame(int id) {
 
 }  // namespace
 
-class VideoReceiveStream2Test : public ::testing::TestWithParam<bool> {
+enum class DecodeScheduling { kPostTask, kMetronome, kMetronomeWorkerPool };
+
+class VideoReceiveStream2Test
+    : public ::testing::TestWithParam<DecodeScheduling> {
  public:
   auto DefaultDecodeAction() {
     return Invoke(&fake_decoder_, &test::FakeDecoder::Decode);
   }
 
-  bool UseMetronome() const { return GetParam(); }
+  DecodeSynchronizer* decode_sync() {
+    switch (GetParam()) {
+      case DecodeScheduling::kPostTask:
+        return nullptr;
+      case DecodeScheduling::kMetronome:
+        return &decode_sync_;
+      case DecodeScheduling::kMetronomeWorkerPool:
+        return &pooled_decode_sync_;
+    }
+    RTC_CHECK_NOTREACHED();
+  }
 
   VideoReceiveStream2Test()
       : time_controller_(kStartTime),
@@ -200,6 +219,12 @@ class VideoReceiveStream2Test : public ::testing::TestWithParam<bool> {
         decode_sync_(clock_,
                      &fake_metronome_,
                      time_controller_.GetMainThread()),
+        pooled_decode_sync_(clock_,
+                            &fake_metronome_,
+                            time_controller_.GetMainThread(),
+                            std::make_unique<DecodeWorkerPool>(
+                                time_controller_.GetTaskQueueFactory(),
+                                /*num_workers=*/2)),
         h264_decoder_factory_(&mock_decoder_) {
     // By default, mock decoder factory is backed by VideoDecoderProxyFactory.
     ON_CALL(mock_h264_decoder_factory_, CreateVideoDecoder)
@@ -226,6 +251,8 @@ class VideoReceiveStream2Test : public ::testing::TestWithParam<bool> {
     if (video_receive_stream_) {
       video_receive_stream_->Stop();
       video_receive_stream_->UnregisterFromTransport();
+      // The stream returns its decode worker to the pool.
+      video_receive_stream_ = nullptr;
     }
     time_controller_.AdvanceTime(TimeDelta::Zero());
   }
@@ -259,9 +286,9 @@ class VideoReceiveStream2Test : public ::testing::TestWithParam<bool> {
     video_receive_stream_ =
         std::make_unique<webrtc::internal::VideoReceiveStream2>(
             time_controller_.GetTaskQueueFactory(), &fake_call_,
-            kDefaultNumCpuCores, &packet_router_, config_.Copy(), &call_stats_,
-            clock_, absl::WrapUnique(timing_), &nack_periodic_processor_,
-            UseMetronome() ? &decode_sync_ : nullptr, nullptr);
+            kDefaultNumCpuCores, decoder_core_budget_, &packet_router_,
+            config_.Copy(), &call_stats_, clock_, absl::WrapUnique(timing_),
+            &nack_periodic_processor_, decode_sync(), nullptr);
     video_receive_stream_->RegisterWithTransport(
         &rtp_stream_receiver_controller_);
     if (state)
@@ -284,8 +311,10 @@ class VideoReceiveStream2Test : public ::testing::TestWithParam<bool> {
   RtpStreamReceiverController rtp_stream_receiver_controller_;
   std::unique_ptr<webrtc::internal::VideoReceiveStream2> video_receive_stream_;
   VCMTiming* timing_;
+  rtc::scoped_refptr<DecoderCoreBudget> decoder_core_budget_;
   test::FakeMetronome fake_metronome_;
   DecodeSynchronizer decode_sync_;
+  DecodeSynchronizer pooled_decode_sync_;
 
  private:
   test::VideoDecoderProxyFactory h264_decoder_factory_;
@@ -479,6 +508,37 @@ TEST_P(VideoReceiveStream2Test, LazyDecoderCreation) {
   time_controller_.AdvanceTime(TimeDelta::Zero());
 }
 
+TEST_P(VideoReceiveStream2Test, ConfiguresDecoderThreading) {
+  config_.decoder_threading_mode = VideoDecoder::ThreadingMode::kFrameParallel;
+  decoder_core_budget_ = rtc::make_ref_counted<DecoderCoreBudget>(4);
+  RecreateReceiveStream();
+
+  constexpr uint8_t idr_nalu[] = {0x05, 0xFF, 0xFF, 0xFF};
+  RtpPacketToSend rtppacket(nullptr);
+  uint8_t* payload = rtppacket.AllocatePayload(sizeof(idr_nalu));
+  memcpy(payload, idr_nalu, sizeof(idr_nalu));
+  rtppacket.SetMarker(true);
+  rtppacket.SetSsrc(1111);
+  rtppacket.SetPayloadType(99);
+  rtppacket.SetSequenceNumber(1);
+  rtppacket.SetTimestamp(0);
+  video_receive_stream_->Start();
+
+  EXPECT_CALL(
+      mock_decoder_,
+      Configure(AllOf(
+          Property(&VideoDecoder::Settings::threading_mode,
+                   VideoDecoder::ThreadingMode::kFrameParallel),
+          Property(&VideoDecoder::Settings::core_budget,
+                   Eq(decoder_core_budget_)),
+          Property(&VideoDecoder::Settings::number_of_cores,
+                   kDefaultNumCpuCores))));
+  RtpPacketReceived parsed_packet;
+  ASSERT_TRUE(parsed_packet.Parse(rtppacket.data(), rtppacket.size()));
+  rtp_stream_receiver_controller_.OnRtpPacket(parsed_packet);
+  time_controller_.AdvanceTime(TimeDelta::Zero());
+}
+
 TEST_P(VideoReceiveStream2Test, PassesNtpTime) {
   const Timestamp kNtpTimestamp = Timestamp::Millis(12345);
   std::unique_ptr<test::FakeEncodedFrame> test_frame =
@@ -1176,13 +1236,22 @@ TEST_P(VideoReceiveStream2Test, StreamShouldNotTimeoutWhileWaitingForFrame) {
   video_receive_stream_->Stop();
 }
 
-INSTANTIATE_TEST_SUITE_P(VideoReceiveStream2Test,
-                         VideoReceiveStream2Test,
-                         testing::Bool(),
-                         [](const auto& test_param_info) {
-                           return (test_param_info.param
-                                       ? "ScheduleDecodesWithMetronome"
-                                       : "ScheduleDecodesWithPostTask");
-                         });
+INSTANTIATE_TEST_SUITE_P(
+    VideoReceiveStream2Test,
+    VideoReceiveStream2Test,
+    testing::Values(DecodeScheduling::kPostTask,
+                    DecodeScheduling::kMetronome,
+                    DecodeScheduling::kMetronomeWorkerPool),
+    [](const auto& test_param_info) {
+      switch (test_param_info.param) {
+        case DecodeScheduling::kPostTask:
+          return "ScheduleDecodesWithPostTask";
+        case DecodeScheduling::kMetronome:
+          return "ScheduleDecodesWithMetronome";
+        case DecodeScheduling::kMetronomeWorkerPool:
+          return "ScheduleDecodesWithMetronomeOnWorkerPool";
+      }
+      RTC_CHECK_NOTREACHED();
+    });
 
 }  // namespace webrtc